@@ -10,8 +10,9 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
+#include <zmk/display/glyph_label.h>
 #include "layer_status.h"
-#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/highest_layer_changed.h>
 #include <zmk/event_manager.h>
 #include <zmk/endpoints.h>
 #include <zmk/keymap.h>
@@ -32,9 +33,9 @@ static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state) {
 
         sprintf(text, " %i", active_layer_index);
 
-        lv_label_set_text(label, text);
+        zmk_glyph_label_set_text(label, text);
     } else {
-        lv_label_set_text(label, layer_label);
+        zmk_glyph_label_set_text(label, layer_label);
     }
 }
 
@@ -52,10 +53,11 @@ static struct layer_status_state layer_status_get_state(const zmk_event_t *eh) {
 ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, layer_status_update_cb,
                             layer_status_get_state)
 
-ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
+ZMK_SUBSCRIPTION_COALESCED(widget_layer_status, zmk_highest_layer_changed,
+                           CONFIG_ZMK_DISPLAY_WIDGET_EVENT_COALESCE_MS);
 
 int zmk_widget_layer_status_init(struct zmk_widget_layer_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+    widget->obj = zmk_glyph_label_create(parent);
 
     sys_slist_append(&widgets, &widget->node);
 
@@ -20,7 +20,11 @@ lv_obj_t *zmk_display_status_screen() {
     screen = lv_obj_create(NULL);
 
 #if IS_ENABLED(CONFIG_NICE_VIEW_WIDGET_STATUS)
-    zmk_widget_status_init(&status_widget, screen);
+    if (zmk_widget_status_init(&status_widget, screen) < 0) {
+        LOG_ERR("Failed to create the status widget");
+        return screen;
+    }
+
     lv_obj_align(zmk_widget_status_obj(&status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
 #endif
 
@@ -32,8 +32,9 @@ struct peripheral_status_state {
     bool connected;
 };
 
-static void draw_top(lv_obj_t *widget, lv_color_t cbuf[], const struct status_state *state) {
-    lv_obj_t *canvas = lv_obj_get_child(widget, 0);
+static void draw_top(struct zmk_widget_status *widget) {
+    lv_obj_t *canvas = lv_obj_get_child(widget->obj, 0);
+    const struct status_state *state = &widget->state;
 
     lv_draw_label_dsc_t label_dsc;
     init_label_dsc(&label_dsc, LVGL_FOREGROUND, &lv_font_montserrat_16, LV_TEXT_ALIGN_RIGHT);
@@ -51,7 +52,7 @@ static void draw_top(lv_obj_t *widget, lv_color_t cbuf[], const struct status_st
                         state->connected ? LV_SYMBOL_WIFI : LV_SYMBOL_CLOSE);
 
     // Rotate canvas
-    rotate_canvas(canvas, cbuf);
+    rotate_canvas(canvas, widget->cbuf, widget->rotate_cbuf);
 }
 
 static void set_battery_status(struct zmk_widget_status *widget,
@@ -62,7 +63,7 @@ static void set_battery_status(struct zmk_widget_status *widget,
 
     widget->state.battery = state.level;
 
-    draw_top(widget->obj, widget->cbuf, &widget->state);
+    draw_top(widget);
 }
 
 static void battery_status_update_cb(struct battery_status_state state) {
@@ -82,9 +83,10 @@ static struct battery_status_state battery_status_get_state(const zmk_event_t *e
 ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_status, struct battery_status_state,
                             battery_status_update_cb, battery_status_get_state)
 
-ZMK_SUBSCRIPTION(widget_battery_status, zmk_battery_state_changed);
+ZMK_SUBSCRIPTION_COALESCED(widget_battery_status, zmk_battery_state_changed,
+                           CONFIG_ZMK_DISPLAY_WIDGET_EVENT_COALESCE_MS);
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
-ZMK_SUBSCRIPTION(widget_battery_status, zmk_usb_conn_state_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_battery_status, zmk_usb_conn_state_changed, OBSERVER);
 #endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
 
 static struct peripheral_status_state get_state(const zmk_event_t *_eh) {
@@ -95,7 +97,7 @@ static void set_connection_status(struct zmk_widget_status *widget,
                                   struct peripheral_status_state state) {
     widget->state.connected = state.connected;
 
-    draw_top(widget->obj, widget->cbuf, &widget->state);
+    draw_top(widget);
 }
 
 static void output_status_update_cb(struct peripheral_status_state state) {
@@ -105,9 +107,15 @@ static void output_status_update_cb(struct peripheral_status_state state) {
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_peripheral_status, struct peripheral_status_state,
                             output_status_update_cb, get_state)
-ZMK_SUBSCRIPTION(widget_peripheral_status, zmk_split_peripheral_status_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_peripheral_status, zmk_split_peripheral_status_changed, OBSERVER);
 
 int zmk_widget_status_init(struct zmk_widget_status *widget, lv_obj_t *parent) {
+    widget->cbuf = lease_draw_tile();
+    widget->rotate_cbuf = lease_draw_tile();
+    if (widget->cbuf == NULL || widget->rotate_cbuf == NULL) {
+        return -ENOMEM;
+    }
+
     widget->obj = lv_obj_create(parent);
     lv_obj_set_size(widget->obj, 160, 68);
     lv_obj_t *top = lv_canvas_create(widget->obj);
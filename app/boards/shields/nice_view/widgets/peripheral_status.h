@@ -14,7 +14,9 @@
 struct zmk_widget_status {
     sys_snode_t node;
     lv_obj_t *obj;
-    lv_color_t cbuf[CANVAS_SIZE * CANVAS_SIZE];
+    // Leased from the shared draw buffer
+    lv_color_t *cbuf;
+    lv_color_t *rotate_cbuf;
     struct status_state state;
 };
 
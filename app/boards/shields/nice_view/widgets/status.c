@@ -19,7 +19,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/ble_active_profile_changed.h>
 #include <zmk/events/endpoint_changed.h>
 #include <zmk/events/wpm_state_changed.h>
-#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/highest_layer_changed.h>
 #include <zmk/usb.h>
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
@@ -44,27 +44,36 @@ struct wpm_status_state {
     uint8_t wpm;
 };
 
-static void draw_top(lv_obj_t *widget, lv_color_t cbuf[], const struct status_state *state) {
-    lv_obj_t *canvas = lv_obj_get_child(widget, 0);
+// Each canvas is split into regions that are redrawn on their own, so a change only rasterizes,
+// rotates and flushes the part of the panel it affects. Regions are drawn unrotated on a shared
+// scratch canvas and then rotated into the canvas they are shown on.
+enum status_region {
+    STATUS_REGION_BATTERY,
+    STATUS_REGION_OUTPUT,
+    STATUS_REGION_WPM,
+    STATUS_REGION_PROFILES,
+    STATUS_REGION_LAYER,
+};
 
-    lv_draw_label_dsc_t label_dsc;
-    init_label_dsc(&label_dsc, LVGL_FOREGROUND, &lv_font_montserrat_16, LV_TEXT_ALIGN_RIGHT);
-    lv_draw_label_dsc_t label_dsc_wpm;
-    init_label_dsc(&label_dsc_wpm, LVGL_FOREGROUND, &lv_font_unscii_8, LV_TEXT_ALIGN_RIGHT);
-    lv_draw_rect_dsc_t rect_black_dsc;
-    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
-    lv_draw_rect_dsc_t rect_white_dsc;
-    init_rect_dsc(&rect_white_dsc, LVGL_FOREGROUND);
-    lv_draw_line_dsc_t line_dsc;
-    init_line_dsc(&line_dsc, LVGL_FOREGROUND, 1);
+#define STATUS_REGIONS_ALL (BIT(STATUS_REGION_LAYER + 1) - 1)
 
-    // Fill background
-    lv_canvas_draw_rect(canvas, 0, 0, CANVAS_SIZE, CANVAS_SIZE, &rect_black_dsc);
+struct status_region_def {
+    uint8_t canvas;
+    lv_area_t area;
+    void (*draw)(lv_obj_t *canvas, const struct status_state *state);
+};
 
-    // Draw battery
+static lv_obj_t *scratch_canvas;
+static lv_color_t *scratch_cbuf;
+
+static void draw_battery_region(lv_obj_t *canvas, const struct status_state *state) {
     draw_battery(canvas, state);
+}
+
+static void draw_output(lv_obj_t *canvas, const struct status_state *state) {
+    lv_draw_label_dsc_t label_dsc;
+    init_label_dsc(&label_dsc, LVGL_FOREGROUND, &lv_font_montserrat_16, LV_TEXT_ALIGN_RIGHT);
 
-    // Draw output status
     char output_text[10] = {};
 
     switch (state->selected_endpoint.transport) {
@@ -85,8 +94,18 @@ static void draw_top(lv_obj_t *widget, lv_color_t cbuf[], const struct status_st
     }
 
     lv_canvas_draw_text(canvas, 0, 0, CANVAS_SIZE, &label_dsc, output_text);
+}
+
+static void draw_wpm(lv_obj_t *canvas, const struct status_state *state) {
+    lv_draw_label_dsc_t label_dsc_wpm;
+    init_label_dsc(&label_dsc_wpm, LVGL_FOREGROUND, &lv_font_unscii_8, LV_TEXT_ALIGN_RIGHT);
+    lv_draw_rect_dsc_t rect_black_dsc;
+    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
+    lv_draw_rect_dsc_t rect_white_dsc;
+    init_rect_dsc(&rect_white_dsc, LVGL_FOREGROUND);
+    lv_draw_line_dsc_t line_dsc;
+    init_line_dsc(&line_dsc, LVGL_FOREGROUND, 1);
 
-    // Draw WPM
     lv_canvas_draw_rect(canvas, 0, 21, 68, 42, &rect_white_dsc);
     lv_canvas_draw_rect(canvas, 1, 22, 66, 40, &rect_black_dsc);
 
@@ -117,18 +136,9 @@ static void draw_top(lv_obj_t *widget, lv_color_t cbuf[], const struct status_st
         points[i].y = 60 - (state->wpm[i] - min) * 36 / range;
     }
     lv_canvas_draw_line(canvas, points, 10, &line_dsc);
-
-    // Rotate canvas
-    rotate_canvas(canvas, cbuf);
 }
 
-static void draw_middle(lv_obj_t *widget, lv_color_t cbuf[], const struct status_state *state) {
-    lv_obj_t *canvas = lv_obj_get_child(widget, 1);
-
-    lv_draw_rect_dsc_t rect_black_dsc;
-    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
-    lv_draw_rect_dsc_t rect_white_dsc;
-    init_rect_dsc(&rect_white_dsc, LVGL_FOREGROUND);
+static void draw_profiles(lv_obj_t *canvas, const struct status_state *state) {
     lv_draw_arc_dsc_t arc_dsc;
     init_arc_dsc(&arc_dsc, LVGL_FOREGROUND, 2);
     lv_draw_arc_dsc_t arc_dsc_filled;
@@ -138,9 +148,6 @@ static void draw_middle(lv_obj_t *widget, lv_color_t cbuf[], const struct status
     lv_draw_label_dsc_t label_dsc_black;
     init_label_dsc(&label_dsc_black, LVGL_BACKGROUND, &lv_font_montserrat_18, LV_TEXT_ALIGN_CENTER);
 
-    // Fill background
-    lv_canvas_draw_rect(canvas, 0, 0, CANVAS_SIZE, CANVAS_SIZE, &rect_black_dsc);
-
     // Draw circles
     int circle_offsets[5][2] = {
         {13, 13}, {55, 13}, {34, 34}, {13, 55}, {55, 55},
@@ -162,23 +169,12 @@ static void draw_middle(lv_obj_t *widget, lv_color_t cbuf[], const struct status
         lv_canvas_draw_text(canvas, circle_offsets[i][0] - 8, circle_offsets[i][1] - 10, 16,
                             (selected ? &label_dsc_black : &label_dsc), label);
     }
-
-    // Rotate canvas
-    rotate_canvas(canvas, cbuf);
 }
 
-static void draw_bottom(lv_obj_t *widget, lv_color_t cbuf[], const struct status_state *state) {
-    lv_obj_t *canvas = lv_obj_get_child(widget, 2);
-
-    lv_draw_rect_dsc_t rect_black_dsc;
-    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
+static void draw_layer(lv_obj_t *canvas, const struct status_state *state) {
     lv_draw_label_dsc_t label_dsc;
     init_label_dsc(&label_dsc, LVGL_FOREGROUND, &lv_font_montserrat_14, LV_TEXT_ALIGN_CENTER);
 
-    // Fill background
-    lv_canvas_draw_rect(canvas, 0, 0, CANVAS_SIZE, CANVAS_SIZE, &rect_black_dsc);
-
-    // Draw layer
     if (state->layer_label == NULL || strlen(state->layer_label) == 0) {
         char text[10] = {};
 
@@ -188,20 +184,56 @@ static void draw_bottom(lv_obj_t *widget, lv_color_t cbuf[], const struct status
     } else {
         lv_canvas_draw_text(canvas, 0, 5, 68, &label_dsc, state->layer_label);
     }
+}
+
+// Areas are in unrotated canvas coordinates. The battery and output share the top rows of the top
+// canvas, the battery on the left and the right aligned output symbol on the right.
+static const struct status_region_def status_regions[] = {
+    [STATUS_REGION_BATTERY] = {.canvas = 0, .area = {0, 0, 33, 20}, .draw = draw_battery_region},
+    [STATUS_REGION_OUTPUT] = {.canvas = 0, .area = {34, 0, 67, 20}, .draw = draw_output},
+    [STATUS_REGION_WPM] = {.canvas = 0, .area = {0, 21, 67, 67}, .draw = draw_wpm},
+    [STATUS_REGION_PROFILES] = {.canvas = 1, .area = {0, 0, 67, 67}, .draw = draw_profiles},
+    [STATUS_REGION_LAYER] = {.canvas = 2, .area = {0, 0, 67, 67}, .draw = draw_layer},
+};
+
+static void redraw_regions(struct zmk_widget_status *widget, uint32_t dirty) {
+    lv_draw_rect_dsc_t rect_black_dsc;
+    init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
+
+    for (int i = 0; i < ARRAY_SIZE(status_regions); i++) {
+        const struct status_region_def *region = &status_regions[i];
+
+        if (!(dirty & BIT(i))) {
+            continue;
+        }
+
+        // Fill background
+        lv_canvas_draw_rect(scratch_canvas, region->area.x1, region->area.y1,
+                            lv_area_get_width(&region->area), lv_area_get_height(&region->area),
+                            &rect_black_dsc);
+        region->draw(scratch_canvas, &widget->state);
 
-    // Rotate canvas
-    rotate_canvas(canvas, cbuf);
+        rotate_canvas_area(lv_obj_get_child(widget->obj, region->canvas),
+                           widget->cbufs[region->canvas], scratch_cbuf, &region->area);
+    }
 }
 
 static void set_battery_status(struct zmk_widget_status *widget,
                                struct battery_status_state state) {
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
-    widget->state.charging = state.usb_present;
+    bool charging = state.usb_present;
+#else
+    bool charging = widget->state.charging;
 #endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
 
+    if (widget->state.battery == state.level && widget->state.charging == charging) {
+        return;
+    }
+
+    widget->state.charging = charging;
     widget->state.battery = state.level;
 
-    draw_top(widget->obj, widget->cbuf, &widget->state);
+    redraw_regions(widget, BIT(STATUS_REGION_BATTERY));
 }
 
 static void battery_status_update_cb(struct battery_status_state state) {
@@ -223,20 +255,32 @@ static struct battery_status_state battery_status_get_state(const zmk_event_t *e
 ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_status, struct battery_status_state,
                             battery_status_update_cb, battery_status_get_state)
 
-ZMK_SUBSCRIPTION(widget_battery_status, zmk_battery_state_changed);
+ZMK_SUBSCRIPTION_COALESCED(widget_battery_status, zmk_battery_state_changed,
+                           CONFIG_ZMK_DISPLAY_WIDGET_EVENT_COALESCE_MS);
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
-ZMK_SUBSCRIPTION(widget_battery_status, zmk_usb_conn_state_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_battery_status, zmk_usb_conn_state_changed, OBSERVER);
 #endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
 
 static void set_output_status(struct zmk_widget_status *widget,
                               const struct output_status_state *state) {
+    uint32_t dirty = 0;
+
+    if (!zmk_endpoint_instance_eq(widget->state.selected_endpoint, state->selected_endpoint) ||
+        widget->state.active_profile_connected != state->active_profile_connected ||
+        widget->state.active_profile_bonded != state->active_profile_bonded) {
+        dirty |= BIT(STATUS_REGION_OUTPUT);
+    }
+
+    if (widget->state.active_profile_index != state->active_profile_index) {
+        dirty |= BIT(STATUS_REGION_PROFILES);
+    }
+
     widget->state.selected_endpoint = state->selected_endpoint;
     widget->state.active_profile_index = state->active_profile_index;
     widget->state.active_profile_connected = state->active_profile_connected;
     widget->state.active_profile_bonded = state->active_profile_bonded;
 
-    draw_top(widget->obj, widget->cbuf, &widget->state);
-    draw_middle(widget->obj, widget->cbuf2, &widget->state);
+    redraw_regions(widget, dirty);
 }
 
 static void output_status_update_cb(struct output_status_state state) {
@@ -255,20 +299,24 @@ static struct output_status_state output_status_get_state(const zmk_event_t *_eh
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_output_status, struct output_status_state,
                             output_status_update_cb, output_status_get_state)
-ZMK_SUBSCRIPTION(widget_output_status, zmk_endpoint_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_output_status, zmk_endpoint_changed, OBSERVER);
 
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
-ZMK_SUBSCRIPTION(widget_output_status, zmk_usb_conn_state_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_output_status, zmk_usb_conn_state_changed, OBSERVER);
 #endif
 #if defined(CONFIG_ZMK_BLE)
-ZMK_SUBSCRIPTION(widget_output_status, zmk_ble_active_profile_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_output_status, zmk_ble_active_profile_changed, OBSERVER);
 #endif
 
 static void set_layer_status(struct zmk_widget_status *widget, struct layer_status_state state) {
+    if (widget->state.layer_index == state.index && widget->state.layer_label == state.label) {
+        return;
+    }
+
     widget->state.layer_index = state.index;
     widget->state.layer_label = state.label;
 
-    draw_bottom(widget->obj, widget->cbuf3, &widget->state);
+    redraw_regions(widget, BIT(STATUS_REGION_LAYER));
 }
 
 static void layer_status_update_cb(struct layer_status_state state) {
@@ -285,15 +333,23 @@ static struct layer_status_state layer_status_get_state(const zmk_event_t *eh) {
 ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, layer_status_update_cb,
                             layer_status_get_state)
 
-ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
+ZMK_SUBSCRIPTION_COALESCED(widget_layer_status, zmk_highest_layer_changed,
+                           CONFIG_ZMK_DISPLAY_WIDGET_EVENT_COALESCE_MS);
 
 static void set_wpm_status(struct zmk_widget_status *widget, struct wpm_status_state state) {
+    bool changed = false;
+
     for (int i = 0; i < 9; i++) {
+        changed |= widget->state.wpm[i] != widget->state.wpm[i + 1];
         widget->state.wpm[i] = widget->state.wpm[i + 1];
     }
+    changed |= widget->state.wpm[9] != state.wpm;
     widget->state.wpm[9] = state.wpm;
 
-    draw_top(widget->obj, widget->cbuf, &widget->state);
+    // A steady WPM shifts the history without changing how it looks.
+    if (changed) {
+        redraw_regions(widget, BIT(STATUS_REGION_WPM));
+    }
 }
 
 static void wpm_status_update_cb(struct wpm_status_state state) {
@@ -307,20 +363,46 @@ struct wpm_status_state wpm_status_get_state(const zmk_event_t *eh) {
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_wpm_status, struct wpm_status_state, wpm_status_update_cb,
                             wpm_status_get_state)
-ZMK_SUBSCRIPTION(widget_wpm_status, zmk_wpm_state_changed);
+ZMK_SUBSCRIPTION_COALESCED(widget_wpm_status, zmk_wpm_state_changed,
+                           CONFIG_ZMK_DISPLAY_WIDGET_EVENT_COALESCE_MS);
 
 int zmk_widget_status_init(struct zmk_widget_status *widget, lv_obj_t *parent) {
+    if (scratch_cbuf == NULL) {
+        scratch_cbuf = lease_draw_tile();
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(widget->cbufs); i++) {
+        widget->cbufs[i] = lease_draw_tile();
+    }
+
+    if (scratch_cbuf == NULL || widget->cbufs[ARRAY_SIZE(widget->cbufs) - 1] == NULL) {
+        return -ENOMEM;
+    }
+
     widget->obj = lv_obj_create(parent);
     lv_obj_set_size(widget->obj, 160, 68);
     lv_obj_t *top = lv_canvas_create(widget->obj);
     lv_obj_align(top, LV_ALIGN_TOP_RIGHT, 0, 0);
-    lv_canvas_set_buffer(top, widget->cbuf, CANVAS_SIZE, CANVAS_SIZE, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_set_buffer(top, widget->cbufs[0], CANVAS_SIZE, CANVAS_SIZE, LV_IMG_CF_TRUE_COLOR);
     lv_obj_t *middle = lv_canvas_create(widget->obj);
     lv_obj_align(middle, LV_ALIGN_TOP_LEFT, 24, 0);
-    lv_canvas_set_buffer(middle, widget->cbuf2, CANVAS_SIZE, CANVAS_SIZE, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_set_buffer(middle, widget->cbufs[1], CANVAS_SIZE, CANVAS_SIZE, LV_IMG_CF_TRUE_COLOR);
     lv_obj_t *bottom = lv_canvas_create(widget->obj);
     lv_obj_align(bottom, LV_ALIGN_TOP_LEFT, -44, 0);
-    lv_canvas_set_buffer(bottom, widget->cbuf3, CANVAS_SIZE, CANVAS_SIZE, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_set_buffer(bottom, widget->cbufs[2], CANVAS_SIZE, CANVAS_SIZE, LV_IMG_CF_TRUE_COLOR);
+
+    if (scratch_canvas == NULL) {
+        scratch_canvas = lv_canvas_create(widget->obj);
+        lv_obj_add_flag(scratch_canvas, LV_OBJ_FLAG_HIDDEN);
+        lv_canvas_set_buffer(scratch_canvas, scratch_cbuf, CANVAS_SIZE, CANVAS_SIZE,
+                             LV_IMG_CF_TRUE_COLOR);
+    }
+
+    // Rotation never writes the first column, so it has to start out as background.
+    lv_canvas_fill_bg(top, LVGL_BACKGROUND, LV_OPA_COVER);
+    lv_canvas_fill_bg(middle, LVGL_BACKGROUND, LV_OPA_COVER);
+    lv_canvas_fill_bg(bottom, LVGL_BACKGROUND, LV_OPA_COVER);
+    redraw_regions(widget, STATUS_REGIONS_ALL);
 
     sys_slist_append(&widgets, &widget->node);
     widget_battery_status_init();
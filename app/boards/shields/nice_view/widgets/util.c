@@ -6,15 +6,30 @@
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
 #include "util.h"
 
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
 LV_IMG_DECLARE(bolt);
 
-void rotate_canvas(lv_obj_t *canvas, lv_color_t cbuf[]) {
-    static lv_color_t cbuf_tmp[CANVAS_SIZE * CANVAS_SIZE];
-    memcpy(cbuf_tmp, cbuf, sizeof(cbuf_tmp));
+static lv_color_t draw_buf[DRAW_TILES][CANVAS_SIZE * CANVAS_SIZE];
+static uint8_t draw_tiles_leased;
+
+// Tiles are leased for good at init, so there's nothing to return them.
+lv_color_t *lease_draw_tile(void) {
+    if (draw_tiles_leased == DRAW_TILES) {
+        LOG_ERR("No draw buffer tile left, only %d are reserved", DRAW_TILES);
+        return NULL;
+    }
+
+    return draw_buf[draw_tiles_leased++];
+}
+
+void rotate_canvas(lv_obj_t *canvas, lv_color_t cbuf[], lv_color_t scratch[]) {
+    memcpy(scratch, cbuf, sizeof(draw_buf[0]));
     lv_img_dsc_t img;
-    img.data = (void *)cbuf_tmp;
+    img.data = (void *)scratch;
     img.header.cf = LV_IMG_CF_TRUE_COLOR;
     img.header.w = CANVAS_SIZE;
     img.header.h = CANVAS_SIZE;
@@ -24,6 +39,29 @@ void rotate_canvas(lv_obj_t *canvas, lv_color_t cbuf[]) {
                         CANVAS_SIZE / 2, true);
 }
 
+// Same mapping as rotate_canvas(), but only for one area of src, which is left unrotated. Only the
+// rotated area is invalidated, so only that part of the display is flushed.
+void rotate_canvas_area(lv_obj_t *canvas, lv_color_t cbuf[], const lv_color_t src[],
+                        const lv_area_t *area) {
+    lv_area_t dest = {
+        .x1 = CANVAS_SIZE - area->y2,
+        .y1 = area->x1,
+        .x2 = MIN(CANVAS_SIZE - area->y1, CANVAS_SIZE - 1),
+        .y2 = area->x2,
+    };
+
+    for (lv_coord_t y = dest.y1; y <= dest.y2; y++) {
+        for (lv_coord_t x = dest.x1; x <= dest.x2; x++) {
+            cbuf[y * CANVAS_SIZE + x] = src[(CANVAS_SIZE - x) * CANVAS_SIZE + y];
+        }
+    }
+
+    lv_area_t coords;
+    lv_obj_get_coords(canvas, &coords);
+    lv_area_move(&dest, coords.x1, coords.y1);
+    lv_obj_invalidate_area(canvas, &dest);
+}
+
 void draw_battery(lv_obj_t *canvas, const struct status_state *state) {
     lv_draw_rect_dsc_t rect_black_dsc;
     init_rect_dsc(&rect_black_dsc, LVGL_BACKGROUND);
@@ -10,6 +10,15 @@
 
 #define CANVAS_SIZE 68
 
+// Canvas buffers are leased as tiles of one static draw buffer: the three canvases of the status
+// widget and the scratch canvas regions are drawn on, or the peripheral's canvas and the copy it is
+// rotated from.
+#if !IS_ENABLED(CONFIG_ZMK_SPLIT) || IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#define DRAW_TILES 4
+#else
+#define DRAW_TILES 2
+#endif
+
 #define LVGL_BACKGROUND                                                                            \
     IS_ENABLED(CONFIG_NICE_VIEW_WIDGET_INVERTED) ? lv_color_black() : lv_color_white()
 #define LVGL_FOREGROUND                                                                            \
@@ -38,7 +47,10 @@ struct battery_status_state {
 #endif
 };
 
-void rotate_canvas(lv_obj_t *canvas, lv_color_t cbuf[]);
+lv_color_t *lease_draw_tile(void);
+void rotate_canvas(lv_obj_t *canvas, lv_color_t cbuf[], lv_color_t scratch[]);
+void rotate_canvas_area(lv_obj_t *canvas, lv_color_t cbuf[], const lv_color_t src[],
+                        const lv_area_t *area);
 void draw_battery(lv_obj_t *canvas, const struct status_state *state);
 void init_label_dsc(lv_draw_label_dsc_t *label_dsc, lv_color_t color, const lv_font_t *font,
                     lv_text_align_t align);
@@ -198,6 +198,16 @@ int zmk_behavior_validate_binding(const struct zmk_behavior_binding *binding);
 int zmk_behavior_get_empty_param_metadata(const struct device *dev,
                                           struct behavior_parameter_metadata *metadata);
 
+/**
+ * @brief Get the parameter metadata of a behavior, like behavior_get_parameter_metadata(), but
+ * only asking the behavior the first time.
+ *
+ * Metadata doesn't change once the behavior is ready, so it's cached by device in a table of
+ * CONFIG_ZMK_BEHAVIOR_METADATA_CACHE_SIZE entries.
+ */
+int zmk_behavior_get_parameter_metadata(const struct device *dev,
+                                        struct behavior_parameter_metadata *metadata);
+
 /**
  * @brief Validate a given behavior parameters match the behavior metadata.
  *
@@ -46,8 +46,32 @@ typedef int (*zmk_input_processor_handle_event_callback_t)(const struct device *
                                                            uint32_t param1, uint32_t param2,
                                                            struct zmk_input_processor_state *state);
 
+/**
+ * @brief What a processor does to events of one code, for processors which only remap codes and
+ *        scale or invert values without any other state.
+ *
+ * The value of an event with code code is multiplied by mul and then divided by div.
+ */
+struct zmk_input_processor_mapping {
+    uint16_t code;
+    int16_t mul;
+    int16_t div;
+};
+
+/**
+ * @brief Update a mapping, which starts as the identity for an event of the given type and
+ *        mapping->code, to describe what the processor would do to that event.
+ *
+ * @retval 0 if the mapping was updated.
+ * @retval -ENOTSUP if the processor's effect cannot be described by a mapping.
+ */
+typedef int (*zmk_input_processor_get_mapping_callback_t)(
+    const struct device *dev, uint8_t type, uint32_t param1, uint32_t param2,
+    struct zmk_input_processor_mapping *mapping);
+
 __subsystem struct zmk_input_processor_driver_api {
     zmk_input_processor_handle_event_callback_t handle_event;
+    zmk_input_processor_get_mapping_callback_t get_mapping;
 };
 
 __syscall int zmk_input_processor_handle_event(const struct device *dev, struct input_event *event,
@@ -68,4 +92,23 @@ static inline int z_impl_zmk_input_processor_handle_event(const struct device *d
     return api->handle_event(dev, event, param1, param2, state);
 }
 
+/**
+ * @brief Get the mapping for a processor, for a caller which applies it directly instead of calling
+ *        zmk_input_processor_handle_event() for every event.
+ *
+ * @see zmk_input_processor_get_mapping_callback_t
+ */
+static inline int zmk_input_processor_get_mapping(const struct device *dev, uint8_t type,
+                                                  uint32_t param1, uint32_t param2,
+                                                  struct zmk_input_processor_mapping *mapping) {
+    const struct zmk_input_processor_driver_api *api =
+        (const struct zmk_input_processor_driver_api *)dev->api;
+
+    if (api->get_mapping == NULL) {
+        return -ENOTSUP;
+    }
+
+    return api->get_mapping(dev, type, param1, param2, mapping);
+}
+
 #include <syscalls/input_processor.h>
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+#include <zmk/virtual_key_position.h>
+
+/**
+ * @file
+ * @brief Pools of the instances of behaviors that stay active after their key is pressed.
+ *
+ * A pool only keeps track of which of a behavior's instance slots are in use and at which
+ * position, while the behavior keeps the state of each instance in an array of its own. The
+ * instance at a position is found without scanning the pool for the positions of keys, sensors
+ * and combos, and by scanning it for other virtual key positions.
+ */
+
+/** Positions that are looked up in a table rather than by scanning the pool. */
+#define ZMK_BEHAVIOR_INSTANCE_POSITIONS ZMK_VIRTUAL_KEY_POSITION_COMBO(ZMK_COMBOS_LEN)
+
+#define ZMK_BEHAVIOR_INSTANCE_NONE UINT8_MAX
+
+struct zmk_behavior_instance_pool {
+    uint8_t size;
+    uint32_t *used;
+    uint32_t *positions;
+    uint8_t *by_position;
+};
+
+/**
+ * @brief Define a pool of instance slots.
+ *
+ * @param name Name of the pool variable.
+ * @param _size Number of instances, which must be less than ZMK_BEHAVIOR_INSTANCE_NONE.
+ */
+#define ZMK_BEHAVIOR_INSTANCE_POOL_DEFINE(name, _size)                                             \
+    BUILD_ASSERT((_size) < ZMK_BEHAVIOR_INSTANCE_NONE, "Too many behavior instances");             \
+    static uint32_t _CONCAT(name, _used)[DIV_ROUND_UP(_size, 32)];                                 \
+    static uint32_t _CONCAT(name, _positions)[_size];                                              \
+    static uint8_t _CONCAT(name, _by_position)[ZMK_BEHAVIOR_INSTANCE_POSITIONS] = {                \
+        [0 ... ZMK_BEHAVIOR_INSTANCE_POSITIONS - 1] = ZMK_BEHAVIOR_INSTANCE_NONE};                 \
+    static struct zmk_behavior_instance_pool name = {                                              \
+        .size = (_size),                                                                           \
+        .used = _CONCAT(name, _used),                                                              \
+        .positions = _CONCAT(name, _positions),                                                    \
+        .by_position = _CONCAT(name, _by_position),                                                \
+    }
+
+/**
+ * @brief Take a free instance slot for a position.
+ *
+ * @return The index of the slot, or -ENOMEM if all of them are in use.
+ */
+int zmk_behavior_instance_alloc(struct zmk_behavior_instance_pool *pool, uint32_t position);
+
+/**
+ * @brief Give back an instance slot.
+ */
+void zmk_behavior_instance_free(struct zmk_behavior_instance_pool *pool, int index);
+
+/**
+ * @brief Find the instance at a position.
+ *
+ * Should more than one instance be at the position, the one that was taken first is found.
+ *
+ * @return The index of the slot, or -ENOENT if no instance is at the position.
+ */
+int zmk_behavior_instance_find(const struct zmk_behavior_instance_pool *pool, uint32_t position);
+
+/**
+ * @brief Get the first instance slot in use from an index on.
+ *
+ * @return The index of the slot, or -ENOENT if no later slot is in use.
+ */
+int zmk_behavior_instance_next(const struct zmk_behavior_instance_pool *pool, int from);
+
+/**
+ * @brief Iterate over the indices of the instance slots in use.
+ */
+#define ZMK_BEHAVIOR_INSTANCE_FOREACH(pool, index)                                                 \
+    for (int index = zmk_behavior_instance_next(pool, 0); index >= 0;                              \
+         index = zmk_behavior_instance_next(pool, index + 1))
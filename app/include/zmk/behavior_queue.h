@@ -10,5 +10,49 @@
 #include <stdint.h>
 #include <zmk/behavior.h>
 
+enum zmk_behavior_queue_step_op {
+    ZMK_BEHAVIOR_QUEUE_STEP_TAP,
+    ZMK_BEHAVIOR_QUEUE_STEP_PRESS,
+    ZMK_BEHAVIOR_QUEUE_STEP_RELEASE,
+};
+
+enum zmk_behavior_queue_param_source {
+    ZMK_BEHAVIOR_QUEUE_PARAM_BINDING,
+    ZMK_BEHAVIOR_QUEUE_PARAM_SEQUENCE_1ST,
+    ZMK_BEHAVIOR_QUEUE_PARAM_SEQUENCE_2ND,
+};
+
+/**
+ * @brief One precompiled step of a behavior sequence, such as a macro.
+ *
+ * Each parameter of the binding is either used as is, or replaced by one of the parameters the
+ * sequence is queued with.
+ */
+struct zmk_behavior_queue_step {
+    struct zmk_behavior_binding binding;
+    uint32_t tap_ms;
+    uint32_t wait_ms;
+    uint8_t op;
+    uint8_t param1_source;
+    uint8_t param2_source;
+};
+
 int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
                            const struct zmk_behavior_binding behavior, bool press, uint32_t wait);
+
+/**
+ * @brief Queue a whole sequence of precompiled steps as a single queue item.
+ *
+ * The steps are referenced, not copied, so they must stay valid until the sequence has run.
+ *
+ * @param param1 The value for steps taking their first parameter from the sequence.
+ * @param param2 The value for steps taking their second parameter from the sequence.
+ */
+int zmk_behavior_queue_add_steps(const struct zmk_behavior_binding_event *event,
+                                 const struct zmk_behavior_queue_step *steps, uint16_t count,
+                                 uint32_t param1, uint32_t param2);
+
+/**
+ * @brief Get the number of items dropped since boot because their queue lane was full.
+ */
+uint32_t zmk_behavior_queue_overflow_count(void);
@@ -34,12 +34,42 @@ struct bt_conn *zmk_ble_active_profile_conn(void);
 
 bool zmk_ble_active_profile_is_open(void);
 bool zmk_ble_active_profile_is_connected(void);
+bool zmk_ble_conn_is_active_profile(const struct bt_conn *conn);
 char *zmk_ble_active_profile_name(void);
 
 int zmk_ble_unpair_all(void);
 
 int zmk_ble_set_device_name(char *name);
 
+#if IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+/**
+ * @brief Disconnect from hosts and stop advertising until zmk_ble_resume() is called.
+ */
+int zmk_ble_suspend(void);
+
+/**
+ * @brief Reconnect after zmk_ble_suspend(), with directed advertising to a bonded active profile.
+ */
+int zmk_ble_resume(void);
+#endif // IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_ADAPTIVE_CONN_PARAMS)
+/**
+ * @brief Note activity that should have low latency connection parameters.
+ *
+ * Switches all connections to the active parameters if they aren't already, and restarts the
+ * quiet period after which they are relaxed again. Safe to call from any thread.
+ */
+void zmk_ble_conn_params_note_activity(void);
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_ADAPTIVE_CONN_PARAMS)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
 int zmk_ble_put_peripheral_addr(const bt_addr_le_t *addr);
+
+/**
+ * @brief Get the address stored for a split peripheral slot.
+ *
+ * @retval NULL if the index is out of range or no peripheral has been stored in the slot yet.
+ */
+const bt_addr_le_t *zmk_ble_get_peripheral_addr(int index);
 #endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) */
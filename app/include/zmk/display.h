@@ -15,6 +15,12 @@ struct k_work_q *zmk_display_work_q(void);
 bool zmk_display_is_initialized(void);
 int zmk_display_init(void);
 
+/**
+ * @brief Run LVGL as soon as the display's CPU budget allows, e.g. after a widget changed while
+ * the UI was static. Must be called from the display work queue.
+ */
+void zmk_display_request_tick(void);
+
 /**
  * @brief Macro to define a ZMK event listener that handles the thread safety of fetching
  * the necessary state from the system work queue context, invoking a work callback
@@ -39,7 +45,10 @@ int zmk_display_init(void);
         k_mutex_unlock(&listener##_mutex);                                                         \
         return copy;                                                                               \
     };                                                                                             \
-    static void listener##_work_cb(struct k_work *work) { cb(listener##_get_local_state()); };     \
+    static void listener##_work_cb(struct k_work *work) {                                          \
+        cb(listener##_get_local_state());                                                          \
+        zmk_display_request_tick();                                                                \
+    };                                                                                             \
     K_WORK_DEFINE(listener##_work, listener##_work_cb);                                            \
     static void listener##_refresh_state(const zmk_event_t *eh) {                                  \
         k_mutex_lock(&listener##_mutex, K_FOREVER);                                                \
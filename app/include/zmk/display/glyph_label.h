@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/** @file glyph_label.h
+ *  @brief Text labels drawn from a cache of pre-rendered 1 bpp glyphs.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY_GLYPH_LABEL)
+
+/**
+ * @brief Create a label whose text is blitted from cached 1 bpp glyphs instead of being drawn
+ * through LVGL's font rendering. It takes its font and color from the text styles, like a label.
+ */
+lv_obj_t *zmk_glyph_label_create(lv_obj_t *parent);
+
+/**
+ * @brief Set the text of a label created by zmk_glyph_label_create().
+ */
+void zmk_glyph_label_set_text(lv_obj_t *obj, const char *text);
+
+#else
+
+static inline lv_obj_t *zmk_glyph_label_create(lv_obj_t *parent) {
+    return lv_label_create(parent);
+}
+
+static inline void zmk_glyph_label_set_text(lv_obj_t *obj, const char *text) {
+    lv_label_set_text(obj, text);
+}
+
+#endif
@@ -72,6 +72,9 @@ int zmk_endpoints_send_report(uint16_t usage_page);
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_endpoints_send_mouse_report();
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+int zmk_endpoints_send_abs_pointer_report(void);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 void zmk_endpoints_clear_current(void);
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Estimate of where battery charge goes.
+ *
+ * Time spent running on the CPU, connection events on the radio, LED duty and display refreshes
+ * are accounted as they happen, and turned into charge using the currents configured with the
+ * CONFIG_ZMK_ENERGY_* options, so the estimate is only as good as those currents.
+ */
+
+enum zmk_energy_load {
+    ZMK_ENERGY_UNDERGLOW,
+    ZMK_ENERGY_BACKLIGHT,
+    ZMK_ENERGY_LOADS,
+};
+
+enum zmk_energy_consumer {
+    /** Current drawn all the time, whatever else is running. */
+    ZMK_ENERGY_CONSUMER_BASE,
+    ZMK_ENERGY_CONSUMER_CPU,
+    /** Connections to hosts. */
+    ZMK_ENERGY_CONSUMER_RADIO_HOST,
+    /** Connections between split halves. */
+    ZMK_ENERGY_CONSUMER_RADIO_SPLIT,
+    ZMK_ENERGY_CONSUMER_UNDERGLOW,
+    ZMK_ENERGY_CONSUMER_BACKLIGHT,
+    ZMK_ENERGY_CONSUMER_DISPLAY,
+    ZMK_ENERGY_CONSUMERS,
+};
+
+struct zmk_energy_report {
+    /** Time accounted since the last clear. */
+    uint32_t elapsed_ms;
+    uint32_t active_ms;
+    uint32_t idle_ms;
+    uint32_t cpu_ms;
+    /** Connection events of each radio consumer. */
+    uint32_t host_conn_events;
+    uint32_t split_conn_events;
+    /** Time each load would have taken at full duty to use what it did, in ms. */
+    uint32_t load_full_duty_ms[ZMK_ENERGY_LOADS];
+    uint32_t display_refreshes;
+    /** Estimated charge used by each consumer, in µAh. */
+    uint32_t charge_uah[ZMK_ENERGY_CONSUMERS];
+    /** Battery state of charge when last cleared and now, in percent. */
+    uint8_t battery_start;
+    uint8_t battery_now;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_ENERGY)
+
+/**
+ * @brief Set the duty of a load, in permille of its full current.
+ */
+void zmk_energy_set_duty(enum zmk_energy_load load, uint16_t permille);
+
+/**
+ * @brief Count a display refresh.
+ */
+void zmk_energy_display_refreshed(void);
+
+/**
+ * @brief Get what has been accounted since the last clear.
+ */
+void zmk_energy_get_report(struct zmk_energy_report *report);
+
+/**
+ * @brief Restart accounting from now.
+ */
+void zmk_energy_clear(void);
+
+#else
+
+static inline void zmk_energy_set_duty(enum zmk_energy_load load, uint16_t permille) {}
+static inline void zmk_energy_display_refreshed(void) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENERGY)
@@ -10,8 +10,33 @@
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
 
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+
+#define ZMK_EVENT_TIMING_BUCKETS 16
+
+struct zmk_event_timing_stats {
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    // Bucket 0 counts durations under 1us, bucket N those in [2^(N-1), 2^N) us. The last bucket
+    // also counts anything longer.
+    uint32_t buckets[ZMK_EVENT_TIMING_BUCKETS];
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+
 struct zmk_event_type {
     const char *name;
+    // Size of the full event struct, header included
+    uint16_t size;
+    // Contiguous range of this type's entries in the subscription table, filled in at init
+    uint8_t subscriptions_start;
+    uint8_t subscriptions_len;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+    // Time spent dispatching events of this type, nested raises included
+    struct zmk_event_timing_stats timing;
+#endif
 };
 
 typedef struct {
@@ -26,11 +51,55 @@ typedef struct {
 typedef int (*zmk_listener_callback_t)(const zmk_event_t *eh);
 struct zmk_listener {
     zmk_listener_callback_t callback;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+    const char *name;
+#endif
+};
+
+/*
+ * Listener priority classes. Within an event type, listeners are dispatched in priority order, and
+ * in link order for listeners of the same priority. Observer listeners only watch state and must
+ * not alter or consume the event, so they can safely run last or be deferred.
+ */
+enum zmk_subscription_priority {
+    ZMK_SUBSCRIPTION_PRIORITY_CRITICAL,
+    ZMK_SUBSCRIPTION_PRIORITY_NORMAL,
+    ZMK_SUBSCRIPTION_PRIORITY_OBSERVER,
+};
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+
+/*
+ * State for a coalesced subscription. The first event opens a window and is delivered right away;
+ * further events within the window only replace the stored latest copy, which is delivered once
+ * the window closes.
+ */
+struct zmk_event_coalescing {
+    const struct zmk_listener *listener;
+    zmk_event_t *latest;
+    zmk_event_t *delivered;
+    uint16_t window_ms;
+    bool window_open;
+    bool pending;
+    struct k_spinlock lock;
+    struct k_work_delayable work;
 };
 
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+
 struct zmk_event_subscription {
     const struct zmk_event_type *event_type;
     const struct zmk_listener *listener;
+    // Copied from the listener when the subscriptions are sorted, so dispatching doesn't have to
+    // load the listener before each call.
+    zmk_listener_callback_t callback;
+    uint8_t priority;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+    struct zmk_event_coalescing *coalescing;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+    struct zmk_event_timing_stats timing;
+#endif
 };
 
 #define ZMK_EVENT_DECLARE(event_type)                                                              \
@@ -41,10 +110,11 @@ struct zmk_event_subscription {
     struct event_type##_event copy_raised_##event_type(const struct event_type *ev);               \
     int raise_##event_type(struct event_type);                                                     \
     struct event_type *as_##event_type(const zmk_event_t *eh);                                     \
-    extern const struct zmk_event_type zmk_event_##event_type;
+    extern struct zmk_event_type zmk_event_##event_type;
 
 #define ZMK_EVENT_IMPL(event_type)                                                                 \
-    const struct zmk_event_type zmk_event_##event_type = {.name = STRINGIFY(event_type)};          \
+    struct zmk_event_type zmk_event_##event_type = {                                               \
+        .name = STRINGIFY(event_type), .size = sizeof(struct event_type##_event)};                 \
     const struct zmk_event_type *zmk_event_ref_##event_type __used                                 \
         __attribute__((__section__(".event_type"))) = &zmk_event_##event_type;                     \
     struct event_type##_event copy_raised_##event_type(const struct event_type *ev) {              \
@@ -61,16 +131,45 @@ struct zmk_event_subscription {
                                                       : NULL;                                      \
     };
 
-#define ZMK_LISTENER(mod, cb) const struct zmk_listener zmk_listener_##mod = {.callback = cb};
+#define ZMK_LISTENER(mod, cb)                                                                      \
+    const struct zmk_listener zmk_listener_##mod = {                                               \
+        .callback = cb,                                                                            \
+        IF_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING, (.name = STRINGIFY(mod), ))};
 
-#define ZMK_SUBSCRIPTION(mod, ev_type)                                                             \
+#define Z_ZMK_SUBSCRIPTION(mod, ev_type, prio, coalescing_state)                                   \
     extern const struct zmk_listener zmk_listener_##mod;                                           \
-    const Z_DECL_ALIGN(struct zmk_event_subscription)                                              \
+    Z_DECL_ALIGN(struct zmk_event_subscription)                                                    \
         _CONCAT(_CONCAT(zmk_event_sub_, mod), ev_type) __used                                      \
         __attribute__((__section__(".event_subscription"))) = {                                    \
             .event_type = &zmk_event_##ev_type,                                                    \
             .listener = &zmk_listener_##mod,                                                       \
-    };
+            .priority = ZMK_SUBSCRIPTION_PRIORITY_##prio,                                          \
+            IF_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING, (.coalescing = coalescing_state, ))};
+
+#define ZMK_SUBSCRIPTION_PRIORITY(mod, ev_type, prio) Z_ZMK_SUBSCRIPTION(mod, ev_type, prio, NULL)
+
+#define ZMK_SUBSCRIPTION(mod, ev_type) ZMK_SUBSCRIPTION_PRIORITY(mod, ev_type, NORMAL)
+
+/*
+ * Subscribe an observer that only cares about the latest event of a type, delivering at most one
+ * event per window_ms after the first. Falls back to a plain observer subscription when
+ * CONFIG_ZMK_EVENT_MANAGER_COALESCING is disabled.
+ */
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+#define ZMK_SUBSCRIPTION_COALESCED(mod, ev_type, window)                                           \
+    extern const struct zmk_listener zmk_listener_##mod;                                           \
+    static struct ev_type##_event zmk_coalesced_events_##mod##_##ev_type[2];                       \
+    static struct zmk_event_coalescing zmk_coalescing_##mod##_##ev_type = {                        \
+        .listener = &zmk_listener_##mod,                                                           \
+        .latest = &zmk_coalesced_events_##mod##_##ev_type[0].header,                               \
+        .delivered = &zmk_coalesced_events_##mod##_##ev_type[1].header,                            \
+        .window_ms = window,                                                                       \
+    };                                                                                             \
+    Z_ZMK_SUBSCRIPTION(mod, ev_type, OBSERVER, &zmk_coalescing_##mod##_##ev_type)
+#else
+#define ZMK_SUBSCRIPTION_COALESCED(mod, ev_type, window)                                           \
+    ZMK_SUBSCRIPTION_PRIORITY(mod, ev_type, OBSERVER)
+#endif
 
 #define ZMK_EVENT_RAISE(ev) zmk_event_manager_raise(&(ev).header)
 
@@ -84,4 +183,41 @@ struct zmk_event_subscription {
 int zmk_event_manager_raise(zmk_event_t *event);
 int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener);
 int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener);
-int zmk_event_manager_release(zmk_event_t *event);
\ No newline at end of file
+int zmk_event_manager_release(zmk_event_t *event);
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+
+/**
+ * @brief Callback for iterating timing statistics.
+ *
+ * @param type The event type the statistics are for.
+ * @param listener The listener the statistics are for, or NULL for the event type's totals.
+ * @param stats The collected statistics.
+ * @param user_data The user data passed to zmk_event_manager_timing_foreach.
+ */
+typedef void (*zmk_event_manager_timing_cb)(const struct zmk_event_type *type,
+                                            const struct zmk_listener *listener,
+                                            const struct zmk_event_timing_stats *stats,
+                                            void *user_data);
+
+/**
+ * @brief Invoke the callback for each event type, followed by each listener subscribed to it, in
+ *        dispatch order.
+ */
+void zmk_event_manager_timing_foreach(zmk_event_manager_timing_cb cb, void *user_data);
+
+/**
+ * @brief Clear all collected timing statistics.
+ */
+void zmk_event_manager_timing_reset(void);
+
+/**
+ * @brief Estimate a percentile from the histogram of the given statistics.
+ *
+ * @return The upper bound in microseconds of the bucket containing the percentile, capped at the
+ *         maximum duration seen.
+ */
+uint32_t zmk_event_timing_stats_percentile_us(const struct zmk_event_timing_stats *stats,
+                                              uint8_t percentile);
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zmk/event_manager.h>
+
+/**
+ * @file
+ * @brief Shared storage for raised events that are captured and re-raised later.
+ *
+ * Hold-taps and combos both hold on to the events they capture until they are decided. Rather
+ * than each reserving arrays of full events sized for the worst case, they keep small references
+ * into one pool of CONFIG_ZMK_EVENT_POOL_SIZE slots.
+ *
+ * Slots are reference counted. Capturing an event which is itself being re-raised from the pool
+ * takes another reference to its slot instead of copying it, so an event handed from one holder to
+ * the next, or captured again by the holder re-raising it, is only ever copied once.
+ */
+
+typedef uint8_t zmk_event_pool_ref_t;
+
+#define ZMK_EVENT_POOL_REF_NONE UINT8_MAX
+
+/**
+ * @brief Keep a raised event, copying it into a free slot unless it already lives in the pool.
+ *
+ * @param event The header of the raised event.
+ * @return A reference to the pooled event, or ZMK_EVENT_POOL_REF_NONE if the event is too large
+ * for a slot or no slot is free.
+ */
+zmk_event_pool_ref_t zmk_event_pool_capture(const zmk_event_t *event);
+
+/**
+ * @brief Whether an event can be captured without running out of slots.
+ */
+bool zmk_event_pool_can_capture(const zmk_event_t *event);
+
+/**
+ * @brief Get the pooled event a reference points to.
+ */
+zmk_event_t *zmk_event_pool_get(zmk_event_pool_ref_t ref);
+
+/**
+ * @brief Drop a reference, freeing the slot once no holder refers to it.
+ */
+void zmk_event_pool_unref(zmk_event_pool_ref_t ref);
+
+/**
+ * @brief Get the data of a pooled event, or NULL if it's of another type.
+ */
+#define ZMK_EVENT_POOL_AS(ref, event_type) as_##event_type(zmk_event_pool_get(ref))
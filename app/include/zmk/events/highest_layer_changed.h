@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_highest_layer_changed {
+    // Index, in the current layer order, of the highest active layer
+    uint8_t layer_index;
+    int64_t timestamp;
+};
+
+ZMK_EVENT_DECLARE(zmk_highest_layer_changed);
+
+static inline int raise_highest_layer_changed(uint8_t layer_index) {
+    return raise_zmk_highest_layer_changed((struct zmk_highest_layer_changed){
+        .layer_index = layer_index, .timestamp = k_uptime_get()});
+}
@@ -76,6 +76,10 @@
 #define ZMK_HID_REPORT_ID_LEDS 0x01
 #define ZMK_HID_REPORT_ID_CONSUMER 0x02
 #define ZMK_HID_REPORT_ID_MOUSE 0x03
+#define ZMK_HID_REPORT_ID_ABS_POINTER 0x04
+
+// Largest coordinate of the absolute pointer report, which covers the whole screen.
+#define ZMK_HID_ABS_POINTER_MAX 0x7FFF
 
 #ifndef HID_ITEM_TAG_PUSH
 #define HID_ITEM_TAG_PUSH 0xA
@@ -101,6 +105,105 @@
 
 #define HID_USAGE16_SINGLE(a) HID_USAGE16((a & 0xFF), ((a >> 8) & 0xFF))
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+#include <zmk/hid_gaming.h>
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+// One bitmap keyboard collection per gaming device, covering only that device's usage range.
+#define ZMK_HID_GAMING_KEYS_ITEMS(idx)                                                             \
+    HID_USAGE_PAGE(HID_USAGE_KEY), HID_LOGICAL_MIN8(0x00), HID_LOGICAL_MAX8(0x01),                 \
+        HID_USAGE_MIN8(ZMK_GAMING_NKRO_USAGE_MIN(idx)),                                            \
+        HID_USAGE_MAX8(ZMK_GAMING_NKRO_USAGE_MIN(idx) + ZMK_GAMING_NKRO_BITMAP_SIZE(idx) * 8 - 1), \
+        HID_REPORT_SIZE(0x01), HID_REPORT_COUNT(ZMK_GAMING_NKRO_BITMAP_SIZE(idx) * 8),             \
+        HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS)
+#else
+// One boot style keyboard collection per gaming device, matching struct zmk_gaming_keyboard_report.
+#define ZMK_HID_GAMING_KEYS_ITEMS(idx)                                                             \
+    HID_USAGE_PAGE(HID_USAGE_KEY), HID_REPORT_SIZE(0x08), HID_REPORT_COUNT(0x01),                  \
+        HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),           \
+        HID_USAGE_PAGE(HID_USAGE_KEY), HID_LOGICAL_MIN8(0x00), HID_LOGICAL_MAX8(0xFF),             \
+        HID_USAGE_MIN8(0x00), HID_USAGE_MAX8(0xFF), HID_REPORT_SIZE(0x08),                         \
+        HID_REPORT_COUNT(ZMK_GAMING_MAX_KEYS_PER_DEVICE),                                          \
+        HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS)
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+
+#define ZMK_HID_GAMING_KEYBOARD_COLLECTION(idx, _)                                                 \
+    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP), HID_USAGE(HID_USAGE_GD_KEYBOARD),                       \
+        HID_COLLECTION(HID_COLLECTION_APPLICATION),                                                \
+        HID_REPORT_ID(ZMK_HID_GAMING_REPORT_ID_MAIN + (idx)), HID_USAGE_PAGE(HID_USAGE_KEY),       \
+        HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),                                        \
+        HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI), HID_LOGICAL_MIN8(0x00),                  \
+        HID_LOGICAL_MAX8(0x01), HID_REPORT_SIZE(0x01), HID_REPORT_COUNT(0x08),                     \
+        HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),            \
+        ZMK_HID_GAMING_KEYS_ITEMS(idx), HID_END_COLLECTION
+
+#define ZMK_HID_GAMING_REPORT_DESC                                                                 \
+    LISTIFY(CONFIG_ZMK_HID_GAMING_DEVICE_COUNT, ZMK_HID_GAMING_KEYBOARD_COLLECTION, (, ))
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+// The pointing collections come after the keyboard and consumer ones in the report descriptor, and
+// make up the descriptor of their own interface with ZMK_USB_HID_SPLIT_INTERFACES.
+#define ZMK_HID_POINTING_REPORT_DESC                                                               \
+    HID_USAGE_PAGE(HID_USAGE_GD), HID_USAGE(HID_USAGE_GD_MOUSE),                                   \
+        HID_COLLECTION(HID_COLLECTION_APPLICATION), HID_REPORT_ID(ZMK_HID_REPORT_ID_MOUSE),        \
+        HID_USAGE(HID_USAGE_GD_POINTER), HID_COLLECTION(HID_COLLECTION_PHYSICAL),                  \
+        HID_USAGE_PAGE(HID_USAGE_BUTTON), HID_USAGE_MIN8(0x1),                                     \
+        HID_USAGE_MAX8(ZMK_HID_MOUSE_NUM_BUTTONS), HID_LOGICAL_MIN8(0x00), HID_LOGICAL_MAX8(0x01), \
+        HID_REPORT_SIZE(0x01), HID_REPORT_COUNT(0x5),                                              \
+        HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),            \
+        /* Constant padding for the last 3 bits. */                                                \
+        HID_REPORT_SIZE(0x03), HID_REPORT_COUNT(0x01),                                             \
+        HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),           \
+        /* Some OSes ignore pointer devices without X/Y data. */                                   \
+        HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP), HID_USAGE(HID_USAGE_GD_X),                          \
+        HID_USAGE(HID_USAGE_GD_Y), HID_LOGICAL_MIN16(0xFF, -0x7F), HID_LOGICAL_MAX16(0xFF, 0x7F),  \
+        HID_REPORT_SIZE(0x10), HID_REPORT_COUNT(0x02),                                             \
+        HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_REL),            \
+        HID_COLLECTION(HID_COLLECTION_LOGICAL),                                                    \
+        IF_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING, (                                         \
+            HID_USAGE(HID_USAGE_GD_RESOLUTION_MULTIPLIER), HID_LOGICAL_MIN8(0x00),                 \
+            HID_LOGICAL_MAX8(0x0F), HID_PHYSICAL_MIN8(0x01), HID_PHYSICAL_MAX8(0x10),              \
+            HID_REPORT_SIZE(0x04), HID_REPORT_COUNT(0x01), HID_PUSH,                               \
+            HID_FEATURE(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),      \
+        ))                                                                                         \
+        HID_USAGE(HID_USAGE_GD_WHEEL), HID_LOGICAL_MIN16(0xFF, -0x7F),                             \
+        HID_LOGICAL_MAX16(0xFF, 0x7F), HID_PHYSICAL_MIN8(0x00), HID_PHYSICAL_MAX8(0x00),           \
+        HID_REPORT_SIZE(0x10), HID_REPORT_COUNT(0x01),                                             \
+        HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_REL),            \
+        HID_END_COLLECTION, HID_COLLECTION(HID_COLLECTION_LOGICAL),                                \
+        IF_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING, (                                         \
+            HID_USAGE(HID_USAGE_GD_RESOLUTION_MULTIPLIER), HID_POP,                                \
+            HID_FEATURE(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),      \
+        ))                                                                                         \
+        HID_USAGE_PAGE(HID_USAGE_CONSUMER), HID_USAGE16_SINGLE(HID_USAGE_CONSUMER_AC_PAN),         \
+        HID_LOGICAL_MIN16(0xFF, -0x7F), HID_LOGICAL_MAX16(0xFF, 0x7F), HID_PHYSICAL_MIN8(0x00),    \
+        HID_PHYSICAL_MAX8(0x00), HID_REPORT_SIZE(0x10), HID_REPORT_COUNT(0x01),                    \
+        HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_REL),            \
+        HID_END_COLLECTION, HID_END_COLLECTION, HID_END_COLLECTION                                 \
+        IF_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE, (,                                                \
+            /* A separate absolute pointer, for touchpads and digitizers that report positions, */ \
+            /* described as a mouse with absolute X/Y, which every major OS handles without a */   \
+            /* driver. */                                                                          \
+            HID_USAGE_PAGE(HID_USAGE_GD), HID_USAGE(HID_USAGE_GD_MOUSE),                           \
+            HID_COLLECTION(HID_COLLECTION_APPLICATION),                                            \
+            HID_REPORT_ID(ZMK_HID_REPORT_ID_ABS_POINTER), HID_USAGE(HID_USAGE_GD_POINTER),         \
+            HID_COLLECTION(HID_COLLECTION_PHYSICAL), HID_USAGE_PAGE(HID_USAGE_BUTTON),             \
+            HID_USAGE_MIN8(0x1), HID_USAGE_MAX8(ZMK_HID_MOUSE_NUM_BUTTONS),                        \
+            HID_LOGICAL_MIN8(0x00), HID_LOGICAL_MAX8(0x01), HID_REPORT_SIZE(0x01),                 \
+            HID_REPORT_COUNT(0x5),                                                                 \
+            HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),        \
+            /* Constant padding for the last 3 bits. */                                            \
+            HID_REPORT_SIZE(0x03), HID_REPORT_COUNT(0x01),                                         \
+            HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),       \
+            HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP), HID_USAGE(HID_USAGE_GD_X),                      \
+            HID_USAGE(HID_USAGE_GD_Y), HID_LOGICAL_MIN8(0x00), HID_LOGICAL_MAX16(0xFF, 0x7F),      \
+            HID_REPORT_SIZE(0x10), HID_REPORT_COUNT(0x02),                                         \
+            HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),        \
+            HID_END_COLLECTION, HID_END_COLLECTION                                                 \
+        ))
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
 static const uint8_t zmk_hid_report_desc[] = {
     HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
     HID_USAGE(HID_USAGE_GD_KEYBOARD),
@@ -159,11 +262,13 @@ static const uint8_t zmk_hid_report_desc[] = {
 #error "A proper HID report type must be selected"
 #endif
 
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
     HID_END_COLLECTION,
     HID_USAGE_PAGE(HID_USAGE_CONSUMER),
     HID_USAGE(HID_USAGE_CONSUMER_CONSUMER_CONTROL),
     HID_COLLECTION(HID_COLLECTION_APPLICATION),
     HID_REPORT_ID(ZMK_HID_REPORT_ID_CONSUMER),
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
     HID_USAGE_PAGE(HID_USAGE_CONSUMER),
 
 #if IS_ENABLED(CONFIG_ZMK_HID_CONSUMER_REPORT_USAGES_BASIC)
@@ -186,292 +291,11 @@ static const uint8_t zmk_hid_report_desc[] = {
     HID_END_COLLECTION,
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
-    HID_USAGE_PAGE(HID_USAGE_GD),
-    HID_USAGE(HID_USAGE_GD_MOUSE),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(ZMK_HID_REPORT_ID_MOUSE),
-    HID_USAGE(HID_USAGE_GD_POINTER),
-    HID_COLLECTION(HID_COLLECTION_PHYSICAL),
-    HID_USAGE_PAGE(HID_USAGE_BUTTON),
-    HID_USAGE_MIN8(0x1),
-    HID_USAGE_MAX8(ZMK_HID_MOUSE_NUM_BUTTONS),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x5),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    // Constant padding for the last 3 bits.
-    HID_REPORT_SIZE(0x03),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    // Some OSes ignore pointer devices without X/Y data.
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_X),
-    HID_USAGE(HID_USAGE_GD_Y),
-    HID_LOGICAL_MIN16(0xFF, -0x7F),
-    HID_LOGICAL_MAX16(0xFF, 0x7F),
-    HID_REPORT_SIZE(0x10),
-    HID_REPORT_COUNT(0x02),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_REL),
-    HID_COLLECTION(HID_COLLECTION_LOGICAL),
-#if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
-    HID_USAGE(HID_USAGE_GD_RESOLUTION_MULTIPLIER),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x0F),
-    HID_PHYSICAL_MIN8(0x01),
-    HID_PHYSICAL_MAX8(0x10),
-    HID_REPORT_SIZE(0x04),
-    HID_REPORT_COUNT(0x01),
-    HID_PUSH,
-    HID_FEATURE(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-#endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
-    HID_USAGE(HID_USAGE_GD_WHEEL),
-    HID_LOGICAL_MIN16(0xFF, -0x7F),
-    HID_LOGICAL_MAX16(0xFF, 0x7F),
-    HID_PHYSICAL_MIN8(0x00),
-    HID_PHYSICAL_MAX8(0x00),
-    HID_REPORT_SIZE(0x10),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_REL),
-    HID_END_COLLECTION,
-    HID_COLLECTION(HID_COLLECTION_LOGICAL),
-#if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
-    HID_USAGE(HID_USAGE_GD_RESOLUTION_MULTIPLIER),
-    HID_POP,
-    HID_FEATURE(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-#endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
-    HID_USAGE_PAGE(HID_USAGE_CONSUMER),
-    HID_USAGE16_SINGLE(HID_USAGE_CONSUMER_AC_PAN),
-    HID_LOGICAL_MIN16(0xFF, -0x7F),
-    HID_LOGICAL_MAX16(0xFF, 0x7F),
-    HID_PHYSICAL_MIN8(0x00),
-    HID_PHYSICAL_MAX8(0x00),
-    HID_REPORT_SIZE(0x10),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_REL),
-    HID_END_COLLECTION,
-    HID_END_COLLECTION,
-    HID_END_COLLECTION,
+    ZMK_HID_POINTING_REPORT_DESC,
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 #if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
-    // Gaming HID Collections - 5 separate virtual keyboards
-    
-    // Gaming Device 1: Left Half
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x10),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x06),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
-
-    // Gaming Device 2: Y,U Group  
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x11),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x02),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
-
-    // Gaming Device 3: H,J Group
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x12),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x02),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
-
-    // Gaming Device 4: N,M Group
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x13),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x02),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
-
-    // Gaming Device 5: Rest of right side
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x14),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x06),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
-
-    // Gaming Device 6: Both thumb clusters
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x15),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x06),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
-
-    // Gaming Device 7: Left hand [e,d] Group
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x16),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x02),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
-
-    // Gaming Device 8: Left hand [r,f,v] Group
-    HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
-    HID_USAGE(HID_USAGE_GD_KEYBOARD),
-    HID_COLLECTION(HID_COLLECTION_APPLICATION),
-    HID_REPORT_ID(0x17),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_USAGE_MIN8(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL),
-    HID_USAGE_MAX8(HID_USAGE_KEY_KEYBOARD_RIGHT_GUI),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0x01),
-    HID_REPORT_SIZE(0x01),
-    HID_REPORT_COUNT(0x08),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x01),
-    HID_INPUT(ZMK_HID_MAIN_VAL_CONST | ZMK_HID_MAIN_VAL_VAR | ZMK_HID_MAIN_VAL_ABS),
-    HID_USAGE_PAGE(HID_USAGE_KEY),
-    HID_LOGICAL_MIN8(0x00),
-    HID_LOGICAL_MAX8(0xFF),
-    HID_USAGE_MIN8(0x00),
-    HID_USAGE_MAX8(0xFF),
-    HID_REPORT_SIZE(0x08),
-    HID_REPORT_COUNT(0x03),
-    HID_INPUT(ZMK_HID_MAIN_VAL_DATA | ZMK_HID_MAIN_VAL_ARRAY | ZMK_HID_MAIN_VAL_ABS),
-    HID_END_COLLECTION,
+    ZMK_HID_GAMING_REPORT_DESC,
 #endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
 };
 
@@ -531,6 +355,18 @@ struct zmk_hid_consumer_report {
     struct zmk_hid_consumer_report_body body;
 } __packed;
 
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+struct zmk_hid_composite_report_body {
+    struct zmk_hid_keyboard_report_body keyboard;
+    struct zmk_hid_consumer_report_body consumer;
+} __packed;
+
+struct zmk_hid_composite_report {
+    uint8_t report_id;
+    struct zmk_hid_composite_report_body body;
+} __packed;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 struct zmk_hid_mouse_report_body {
     zmk_mouse_button_flags_t buttons;
@@ -559,6 +395,21 @@ struct zmk_hid_mouse_resolution_feature_report {
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+struct zmk_hid_abs_pointer_report_body {
+    zmk_mouse_button_flags_t buttons;
+    uint16_t x;
+    uint16_t y;
+} __packed;
+
+struct zmk_hid_abs_pointer_report {
+    uint8_t report_id;
+    struct zmk_hid_abs_pointer_report_body body;
+} __packed;
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 zmk_mod_flags_t zmk_hid_get_explicit_mods(void);
@@ -598,15 +449,36 @@ void zmk_hid_mouse_movement_update(int16_t x, int16_t y);
 void zmk_hid_mouse_scroll_update(int16_t x, int16_t y);
 void zmk_hid_mouse_clear(void);
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+/**
+ * @brief Set the position of the absolute pointer, from 0 to ZMK_HID_ABS_POINTER_MAX.
+ */
+void zmk_hid_abs_pointer_set(uint16_t x, uint16_t y);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 struct zmk_hid_keyboard_report *zmk_hid_get_keyboard_report(void);
 struct zmk_hid_consumer_report *zmk_hid_get_consumer_report(void);
 
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+/**
+ * @brief Get the keyboard and consumer state as one report, with the keyboard report ID.
+ */
+struct zmk_hid_composite_report *zmk_hid_get_composite_report(void);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 zmk_hid_boot_report_t *zmk_hid_get_boot_report();
 #endif
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 struct zmk_hid_mouse_report *zmk_hid_get_mouse_report();
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+/**
+ * @brief Get the absolute pointer report, with the buttons currently pressed on the mouse.
+ */
+struct zmk_hid_abs_pointer_report *zmk_hid_get_abs_pointer_report(void);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
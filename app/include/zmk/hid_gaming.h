@@ -6,40 +6,66 @@
 
 #pragma once
 
+#include <zephyr/devicetree.h>
 #include <zephyr/usb/usb_ch9.h>
 #include <zephyr/usb/class/usb_hid.h>
 #include <zmk/keys.h>
 #include <dt-bindings/zmk/hid_usage.h>
 #include <dt-bindings/zmk/hid_usage_pages.h>
 
-// Gaming HID Report IDs (non-conflicting with standard HID)
+// Gaming HID Report IDs (non-conflicting with standard HID). Device N uses the main ID + N.
 #define ZMK_HID_GAMING_REPORT_ID_MAIN         0x10
-#define ZMK_HID_GAMING_REPORT_ID_GROUP_YU     0x11
-#define ZMK_HID_GAMING_REPORT_ID_GROUP_HJ     0x12
-#define ZMK_HID_GAMING_REPORT_ID_GROUP_NM     0x13
-
-// Gaming device indices - consolidated grouping:
-// Device 0: Main group (all keys except YU, HJ, NM)
-// Device 1: YU group [y,u]
-// Device 2: HJ group [h,j]
-// Device 3: NM group [n,m]
-#define ZMK_GAMING_DEVICE_MAIN         0  // Main group (all other keys)
-#define ZMK_GAMING_DEVICE_GROUP_YU     1  // YU group [y,u]
-#define ZMK_GAMING_DEVICE_GROUP_HJ     2  // HJ group [h,j]
-#define ZMK_GAMING_DEVICE_GROUP_NM     3  // NM group [n,m]
-#define ZMK_GAMING_DEVICE_COUNT        4
+
+// Gaming device indices. Device 0 gets every key position not assigned to another device by a
+// zmk,gaming-hid-groups devicetree node.
+#define ZMK_GAMING_DEVICE_MAIN         0
+#define ZMK_GAMING_DEVICE_COUNT        CONFIG_ZMK_HID_GAMING_DEVICE_COUNT
+
+#define ZMK_GAMING_GROUPS_NODE DT_INST(0, zmk_gaming_hid_groups)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+
+// Keyboard usages each device's bitmap covers, from the zmk,gaming-hid-groups node. The range is
+// rounded up to whole bytes, so a device can send a few usages past its configured maximum.
+#if DT_NODE_HAS_PROP(ZMK_GAMING_GROUPS_NODE, nkro_usage_min)
+#define ZMK_GAMING_NKRO_USAGE_MIN(idx) DT_PROP_BY_IDX(ZMK_GAMING_GROUPS_NODE, nkro_usage_min, idx)
+#else
+#define ZMK_GAMING_NKRO_USAGE_MIN(idx) HID_USAGE_KEY_KEYBOARD_A
+#endif
+
+#if DT_NODE_HAS_PROP(ZMK_GAMING_GROUPS_NODE, nkro_usage_max)
+#define ZMK_GAMING_NKRO_USAGE_MAX(idx) DT_PROP_BY_IDX(ZMK_GAMING_GROUPS_NODE, nkro_usage_max, idx)
+#else
+#define ZMK_GAMING_NKRO_USAGE_MAX(idx) HID_USAGE_KEY_KEYPAD_EQUAL
+#endif
+
+#define ZMK_GAMING_NKRO_BITMAP_SIZE(idx)                                                           \
+    DIV_ROUND_UP(ZMK_GAMING_NKRO_USAGE_MAX(idx) - ZMK_GAMING_NKRO_USAGE_MIN(idx) + 1, 8)
+
+// Largest bitmap any device can have, since the modifiers are always sent separately
+#define ZMK_GAMING_NKRO_MAX_BITMAP_SIZE DIV_ROUND_UP(HID_USAGE_KEY_KEYBOARD_LEFTCONTROL, 8)
+
+#else
 
 // Maximum keys per gaming device
 #define ZMK_GAMING_MAX_KEYS_PER_DEVICE 18
 
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+
 // Gaming HID reports will be sent using existing USB HID with different report IDs
 // This approach integrates with ZMK's existing HID infrastructure
 
 // Gaming keyboard report structures
 struct zmk_gaming_keyboard_report_body {
     uint8_t modifiers;
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+    // Only the first ZMK_GAMING_NKRO_BITMAP_SIZE(device) bytes are sent. Bit 0 is the device's
+    // minimum usage.
+    uint8_t keys[ZMK_GAMING_NKRO_MAX_BITMAP_SIZE];
+#else
     uint8_t _reserved;
     uint8_t keys[ZMK_GAMING_MAX_KEYS_PER_DEVICE];
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
 } __packed;
 
 struct zmk_gaming_keyboard_report {
@@ -62,11 +88,17 @@ int zmk_hid_gaming_unregister_mod(uint8_t device_id, zmk_mod_t modifier);
 
 struct zmk_gaming_keyboard_report *zmk_hid_gaming_get_keyboard_report(uint8_t device_id);
 
+// Length of a device's report as sent, including the report ID
+size_t zmk_hid_gaming_get_keyboard_report_size(uint8_t device_id);
+
+// Send every device's current report, e.g. once the host has configured the keyboard
+void zmk_hid_gaming_announce(void);
+
 // Gaming layer detection
 bool zmk_hid_gaming_is_active(void);
 void zmk_hid_gaming_set_active(bool active);
 
-// Position to device mapping for Corne 42-key layout
+// Position to device mapping, from the zmk,gaming-hid-groups devicetree node
 uint8_t zmk_hid_gaming_get_device_for_position(uint32_t position);
 
 // Gaming position state handling
@@ -9,9 +9,54 @@
 #include <zmk/keys.h>
 #include <zmk/hid.h>
 
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+int zmk_hog_send_composite_report(struct zmk_hid_composite_report_body *body);
+#else
 int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *body);
 int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *body);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *body);
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+int zmk_hog_send_abs_pointer_report(struct zmk_hid_abs_pointer_report_body *body);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+int zmk_hog_send_gaming_report(uint8_t device_id,
+                               const struct zmk_gaming_keyboard_report_body *body);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+enum zmk_hog_report_type {
+    ZMK_HOG_REPORT_KEYBOARD,
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+    ZMK_HOG_REPORT_GAMING,
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    ZMK_HOG_REPORT_CONSUMER,
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    ZMK_HOG_REPORT_MOUSE,
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    ZMK_HOG_REPORT_ABS_POINTER,
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+};
+
+struct zmk_hog_queue_stats {
+    /** Reports added to the queue. */
+    uint32_t queued;
+    /** Reports folded into an already queued report instead of being added. */
+    uint32_t merged;
+    /** Queued reports discarded because the queue was full. */
+    uint32_t dropped;
+};
+
+/**
+ * @brief Get the queueing counters for one HID over GATT report type.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the report type is unknown.
+ */
+int zmk_hog_get_queue_stats(enum zmk_hog_report_type type, struct zmk_hog_queue_stats *stats);
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <zephyr/sys/util.h>
+
 #include <zmk/events/position_state_changed.h>
 
 #define ZMK_LAYER_CHILD_LEN_PLUS_ONE(node) 1 +
@@ -30,18 +32,150 @@ typedef uint8_t zmk_keymap_layer_id_t;
  */
 typedef uint8_t zmk_keymap_layer_index_t;
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_STATE_WIDE)
+
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS DIV_ROUND_UP(ZMK_KEYMAP_LAYERS_LEN, 32)
+
+/**
+ * @brief A bitmap of layer IDs, one bit per layer, spread over as many 32-bit words as needed.
+ */
+typedef struct {
+    uint32_t words[ZMK_KEYMAP_LAYERS_STATE_WORDS];
+} zmk_keymap_layers_state_t;
+
+#else
+
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 1
+
 typedef uint32_t zmk_keymap_layers_state_t;
 
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_STATE_WIDE)
+
+// The narrow state is a single word and the wide one starts with its array of words, so both can
+// be accessed through the same word pointer.
+#define Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(_state) ((uint32_t *)(_state))
+
+/**
+ * @brief Test whether the bit for the given layer ID is set in a layer state.
+ */
+static inline bool zmk_keymap_layers_state_test(const zmk_keymap_layers_state_t *state,
+                                                zmk_keymap_layer_id_t layer_id) {
+    return (Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(state)[layer_id / 32] & BIT(layer_id % 32)) != 0;
+}
+
+/**
+ * @brief Set or clear the bit for the given layer ID in a layer state.
+ */
+static inline void zmk_keymap_layers_state_write(zmk_keymap_layers_state_t *state,
+                                                 zmk_keymap_layer_id_t layer_id, bool value) {
+    WRITE_BIT(Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(state)[layer_id / 32], layer_id % 32, value);
+}
+
+/**
+ * @brief Clear all layers in a layer state.
+ */
+static inline void zmk_keymap_layers_state_clear(zmk_keymap_layers_state_t *state) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(state)[i] = 0;
+    }
+}
+
+/**
+ * @brief Check whether two layer states have exactly the same layers set.
+ */
+static inline bool zmk_keymap_layers_state_equal(const zmk_keymap_layers_state_t *a,
+                                                 const zmk_keymap_layers_state_t *b) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        if (Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(a)[i] != Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(b)[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check whether every layer set in the mask is also set in the layer state.
+ */
+static inline bool zmk_keymap_layers_state_contains(const zmk_keymap_layers_state_t *state,
+                                                    const zmk_keymap_layers_state_t *mask) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        uint32_t mask_word = Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(mask)[i];
+
+        if ((Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(state)[i] & mask_word) != mask_word) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compute the set of layers that differ between two layer states.
+ */
+static inline void zmk_keymap_layers_state_diff(zmk_keymap_layers_state_t *out,
+                                                const zmk_keymap_layers_state_t *a,
+                                                const zmk_keymap_layers_state_t *b) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(out)[i] =
+            Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(a)[i] ^ Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(b)[i];
+    }
+}
+
+/**
+ * @brief Find the highest layer ID set in a layer state.
+ *
+ * @retval The highest set layer ID, or ZMK_KEYMAP_LAYER_ID_INVAL if no layer is set.
+ */
+static inline zmk_keymap_layer_id_t
+zmk_keymap_layers_state_highest(const zmk_keymap_layers_state_t *state) {
+    for (int i = ZMK_KEYMAP_LAYERS_STATE_WORDS - 1; i >= 0; i--) {
+        uint32_t word = Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(state)[i];
+
+        if (word) {
+            return (i * 32) + 31 - __builtin_clz(word);
+        }
+    }
+
+    return ZMK_KEYMAP_LAYER_ID_INVAL;
+}
+
 zmk_keymap_layer_id_t zmk_keymap_layer_index_to_id(zmk_keymap_layer_index_t layer_index);
 
 zmk_keymap_layer_id_t zmk_keymap_layer_default(void);
 zmk_keymap_layers_state_t zmk_keymap_layer_state(void);
 bool zmk_keymap_layer_active(zmk_keymap_layer_id_t layer);
+/**
+ * @brief Get the index of the highest active layer.
+ *
+ * The value is cached and updated on every layer state or order change, with a
+ * zmk_highest_layer_changed event raised whenever it changes.
+ */
 zmk_keymap_layer_index_t zmk_keymap_highest_layer_active(void);
 int zmk_keymap_layer_activate(zmk_keymap_layer_id_t layer);
 int zmk_keymap_layer_deactivate(zmk_keymap_layer_id_t layer);
 int zmk_keymap_layer_toggle(zmk_keymap_layer_id_t layer);
 int zmk_keymap_layer_to(zmk_keymap_layer_id_t layer);
+
+/**
+ * @brief Start a layer state transaction.
+ *
+ * Layer activations and deactivations made until the matching commit take effect immediately,
+ * but no events are raised for them. Transactions may be nested, only the outermost commit
+ * raises events.
+ */
+void zmk_keymap_layer_state_begin(void);
+
+/**
+ * @brief Commit a layer state transaction started with zmk_keymap_layer_state_begin().
+ *
+ * A zmk_layer_state_changed event is raised for each layer whose state differs from when the
+ * transaction began: deactivated layers first, from the highest one down, then activated layers.
+ *
+ * @retval 0 or the first error from raising the events.
+ * @retval -EINVAL if no transaction is in progress.
+ */
+int zmk_keymap_layer_state_commit(void);
 const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer);
 
 const struct zmk_behavior_binding *zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer,
@@ -49,6 +183,24 @@ const struct zmk_behavior_binding *zmk_keymap_get_layer_binding_at_idx(zmk_keyma
 int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer, uint8_t binding_idx,
                                         const struct zmk_behavior_binding binding);
 
+/**
+ * @brief Set a run of consecutive bindings of a layer at once.
+ *
+ * The bindings are either all set or, if any of them can't be, none are. Cached lookups of the
+ * keymap are only invalidated once for the whole run.
+ *
+ * @param layer The layer to change.
+ * @param start_idx The binding index of the first binding to set.
+ * @param bindings The bindings to set from start_idx on.
+ * @param count The number of bindings.
+ *
+ * @retval The number of bindings that changed.
+ * @retval -EINVAL if the layer is invalid or the run goes past the last mapped binding index.
+ * @retval -ENOMEM if there isn't room to keep that many changed bindings.
+ */
+int zmk_keymap_set_layer_bindings_at_idx(zmk_keymap_layer_id_t layer, uint8_t start_idx,
+                                         const struct zmk_behavior_binding *bindings, size_t count);
+
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
 int zmk_keymap_add_layer(void);
@@ -73,6 +225,21 @@ int zmk_keymap_save_changes(void);
 int zmk_keymap_discard_changes(void);
 int zmk_keymap_reset_settings(void);
 
+/**
+ * @brief Switch to another keymap bank, loading its bindings, layer order and layer names.
+ *
+ * Each bank keeps its own changes to the keymap in settings. Unsaved changes to the current bank
+ * are discarded.
+ *
+ * @retval -EINVAL if the bank is not below CONFIG_ZMK_KEYMAP_BANKS.
+ */
+int zmk_keymap_select_bank(uint8_t bank);
+
+/**
+ * @brief Get the keymap bank in use.
+ */
+uint8_t zmk_keymap_active_bank(void);
+
 int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pressed,
                                       int64_t timestamp);
 
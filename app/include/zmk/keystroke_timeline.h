@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+/**
+ * @file
+ * @brief Timeline of recent keystrokes, for behaviors that depend on the time since the last tap.
+ *
+ * Presses and releases of keycodes are recorded as their events are raised, and combos and
+ * hold-taps note their own presses and taps, so that the prior idle and quick tap checks all look
+ * at the same history. Only the latest CONFIG_ZMK_KEYSTROKE_TIMELINE_SIZE entries are kept, but
+ * the latest tap is always found, however many entries were recorded after it.
+ */
+
+/** Position of entries recorded for keycodes rather than for a behavior's key. */
+#define ZMK_KEYSTROKE_NO_POSITION INT32_MIN
+
+enum zmk_keystroke_flags {
+    /** A press, rather than a release. */
+    ZMK_KEYSTROKE_PRESSED = BIT(0),
+    ZMK_KEYSTROKE_MODIFIER = BIT(1),
+    /** A keycode timestamped no later than the last combo press, such as the combo's own. */
+    ZMK_KEYSTROKE_COMBO = BIT(2),
+    /** A tap decided by a hold-tap, rather than a keycode. */
+    ZMK_KEYSTROKE_HOLD_TAP = BIT(3),
+};
+
+struct zmk_keystroke {
+    int64_t timestamp;
+    int32_t position;
+    uint8_t flags;
+};
+
+/**
+ * @brief Note that a combo was pressed.
+ */
+void zmk_keystroke_timeline_note_combo(int64_t timestamp);
+
+/**
+ * @brief Note that a hold-tap at a position was decided to be a tap.
+ */
+void zmk_keystroke_timeline_note_hold_tap(int32_t position, int64_t timestamp);
+
+/**
+ * @brief Get the latest tap: a press of a keycode other than a modifier, or a hold-tap's tap.
+ *
+ * Taps are ordered by their timestamps. A hold-tap's tap wins over the keycode press it makes at
+ * the same time, so the tap is found with the hold-tap's position.
+ *
+ * @param skip Flags of entries not to count as taps.
+ * @param tap Set to the tap.
+ *
+ * @return 0, or -ENOENT if there hasn't been a tap yet.
+ */
+int zmk_keystroke_timeline_last_tap(uint8_t skip, struct zmk_keystroke *tap);
+
+/**
+ * @brief Get an entry of the timeline.
+ *
+ * @param age 0 for the latest entry, 1 for the one before it, and so on.
+ * @param entry Set to the entry.
+ *
+ * @return 0, or -ENOENT if the timeline doesn't reach that far back.
+ */
+int zmk_keystroke_timeline_get(int age, struct zmk_keystroke *entry);
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+#include <zmk/endpoints_types.h>
+
+/**
+ * @file
+ * @brief Latency from kscan edges to HID reports.
+ *
+ * The local key event being raised is marked with the cycle count of its kscan edge. Any report
+ * sent while it is raised is measured against that edge, both when it is handed to the USB or BLE
+ * stack and, on USB, when the host has taken it from the IN endpoint. Reports sent later, such as
+ * those of a hold-tap decided by its timer, are measured against the key event that sends them.
+ */
+
+enum zmk_latency_probe_stage {
+    /** A report was handed to the USB stack. */
+    ZMK_LATENCY_PROBE_USB_SENT,
+    /** A report was handed to the BLE stack. */
+    ZMK_LATENCY_PROBE_BLE_SENT,
+    /** The host took a report from the USB IN endpoint. */
+    ZMK_LATENCY_PROBE_USB_DELIVERED,
+    ZMK_LATENCY_PROBE_STAGES,
+};
+
+/** Bucket i counts latencies from 2^i to 2^(i+1) µs, bucket 0 those below 2 µs. */
+#define ZMK_LATENCY_PROBE_BUCKETS 16
+
+struct zmk_latency_probe_histogram {
+    uint16_t buckets[ZMK_LATENCY_PROBE_BUCKETS];
+    /** Latencies counted since the probe was last cleared, including those aged out. */
+    uint32_t count;
+    /** Longest latency since the probe was last cleared, in µs. */
+    uint32_t max_us;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+
+/**
+ * @brief Convert a kscan event time to the cycle count at which it happened.
+ *
+ * @param ticks Uptime in ticks, as returned by zmk_kscan_event_time().
+ */
+uint32_t zmk_latency_probe_edge_cycles(int64_t ticks);
+
+/**
+ * @brief Measure reports sent from now on against a kscan edge.
+ */
+void zmk_latency_probe_edge_begin(uint32_t edge_cycles);
+
+/**
+ * @brief Stop measuring reports against the edge set by zmk_latency_probe_edge_begin().
+ */
+void zmk_latency_probe_edge_end(void);
+
+/**
+ * @brief Record that a report was handed to a transport.
+ */
+void zmk_latency_probe_report_sent(enum zmk_transport transport);
+
+/**
+ * @brief Record that the host took the last report from the USB IN endpoint.
+ *
+ * Safe to call from ISRs.
+ */
+void zmk_latency_probe_usb_report_delivered(void);
+
+/**
+ * @brief Copy the histogram of a stage.
+ *
+ * The buckets are halved whenever CONFIG_ZMK_LATENCY_PROBE_WINDOW latencies have been counted,
+ * so they show recent latencies more than old ones.
+ */
+void zmk_latency_probe_get_histogram(enum zmk_latency_probe_stage stage,
+                                     struct zmk_latency_probe_histogram *histogram);
+
+/**
+ * @brief Reset the histograms of all stages.
+ */
+void zmk_latency_probe_clear(void);
+
+#else
+
+static inline uint32_t zmk_latency_probe_edge_cycles(int64_t ticks) { return 0; }
+static inline void zmk_latency_probe_edge_begin(uint32_t edge_cycles) {}
+static inline void zmk_latency_probe_edge_end(void) {}
+static inline void zmk_latency_probe_report_sent(enum zmk_transport transport) {}
+static inline void zmk_latency_probe_usb_report_delivered(void) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
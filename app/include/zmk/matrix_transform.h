@@ -6,10 +6,21 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <zephyr/sys/util.h>
 
 typedef const struct zmk_matrix_transform *zmk_matrix_transform_t;
 
+/**
+ * @brief A row and column as reported by the kscan driver of a transform.
+ */
+struct zmk_matrix_transform_row_column {
+    uint16_t row;
+    uint16_t column;
+};
+
 #define ZMK_MATRIX_TRANSFORM_DEFAULT_EXTERN()                                                      \
     extern const struct zmk_matrix_transform zmk_matrix_transform_default
 #define ZMK_MATRIX_TRANSFORM_EXTERN(node_id)                                                       \
@@ -19,3 +30,26 @@ typedef const struct zmk_matrix_transform *zmk_matrix_transform_t;
 
 int32_t zmk_matrix_transform_row_column_to_position(zmk_matrix_transform_t mt, uint32_t row,
                                                     uint32_t column);
+
+/**
+ * @brief Transform the row and column of each event of a scan to keymap positions.
+ *
+ * @param mt The matrix transform.
+ * @param row_columns The rows and columns to transform.
+ * @param len The number of rows and columns.
+ * @param positions Filled in with the position of each row and column, or -EINVAL if the
+ * transform doesn't map it.
+ */
+void zmk_matrix_transform_row_columns_to_positions(
+    zmk_matrix_transform_t mt, const struct zmk_matrix_transform_row_column *row_columns,
+    size_t len, int32_t *positions);
+
+/**
+ * @brief Find the row and column a keymap position is scanned at.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the position isn't in the transform, or is only reachable through another
+ * part of a composite kscan.
+ */
+int zmk_matrix_transform_position_to_row_column(zmk_matrix_transform_t mt, uint32_t position,
+                                                struct zmk_matrix_transform_row_column *rc);
@@ -59,4 +59,17 @@ int zmk_physical_layouts_get_position_map(uint8_t source, uint8_t dest, size_t m
  * @retval a negative errno value in the case of errors
  * @retval a positive length of the position map array that map is updated to point to.
  */
-int zmk_physical_layouts_get_selected_to_stock_position_map(uint32_t const **map);
\ No newline at end of file
+int zmk_physical_layouts_get_selected_to_stock_position_map(uint32_t const **map);
+
+struct zmk_position_state_changed;
+
+/**
+ * @brief Raise a run of position events, sorted by timestamp, merged in timestamp order with the
+ *        local kscan events waiting to be raised.
+ *
+ * For split centrals, so a batch of peripheral events and the local keys pressed around them are
+ * raised as one ordered run instead of whole batches in the order their work items ran. Must be
+ * called from the input work queue.
+ */
+int zmk_physical_layouts_raise_merged(const struct zmk_position_state_changed *events,
+                                      size_t len);
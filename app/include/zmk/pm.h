@@ -9,4 +9,14 @@
 int zmk_pm_suspend_devices(void);
 void zmk_pm_resume_devices(void);
 
-int zmk_pm_soft_off(void);
\ No newline at end of file
+int zmk_pm_soft_off(void);
+
+#if IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+/**
+ * @brief Suspend the keyboard with RAM retained until the next key press.
+ *
+ * The key press which wakes the keyboard resumes the suspended devices and host connection and is
+ * otherwise discarded, like the key press that wakes the keyboard from soft-off.
+ */
+int zmk_pm_soft_suspend(void);
+#endif // IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
\ No newline at end of file
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+
+/**
+ * @file
+ * @brief Overflow and high watermark counters of bounded queues.
+ *
+ * Queues sized by the same Kconfig option, such as the event queues of each BLE peripheral, share
+ * one set of counters, so its high watermark can be compared with that option directly.
+ */
+
+struct zmk_queue_stats {
+    const char *name;
+    /** Capacity of each queue counted, in items, or in bytes for byte ring buffers. */
+    uint32_t capacity;
+    /** Items put on the queue. */
+    uint32_t queued;
+    /** Items lost because the queue was full, whether the new item or an old one making room. */
+    uint32_t overflows;
+    /** Most items ever held at once. */
+    uint32_t high_watermark;
+};
+
+#define ZMK_QUEUE_STATS(var) _CONCAT(zmk_queue_stats_, var)
+
+#if IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
+
+/**
+ * @brief Define the counters of a queue.
+ *
+ * @param var Name to refer to the counters with in the other macros.
+ * @param _name Name shown by the shell.
+ * @param _capacity Capacity of the queue.
+ */
+#define ZMK_QUEUE_STATS_DEFINE(var, _name, _capacity)                                              \
+    static STRUCT_SECTION_ITERABLE(zmk_queue_stats, ZMK_QUEUE_STATS(var)) = {                      \
+        .name = _name, .capacity = _capacity}
+
+void zmk_queue_stats_record_put(struct zmk_queue_stats *stats, uint32_t used);
+void zmk_queue_stats_record_overflow(struct zmk_queue_stats *stats);
+int zmk_queue_stats_msgq_put(struct zmk_queue_stats *stats, struct k_msgq *msgq, const void *data,
+                             k_timeout_t timeout);
+
+/**
+ * @brief Record that an item was put on a queue, which now holds `used` items.
+ */
+#define ZMK_QUEUE_STATS_PUT(var, used) zmk_queue_stats_record_put(&ZMK_QUEUE_STATS(var), used)
+
+/**
+ * @brief Record that an item was lost because a queue was full.
+ */
+#define ZMK_QUEUE_STATS_OVERFLOW(var) zmk_queue_stats_record_overflow(&ZMK_QUEUE_STATS(var))
+
+/**
+ * @brief k_msgq_put(), counting a failure to put as an overflow.
+ */
+#define ZMK_QUEUE_STATS_MSGQ_PUT(var, msgq, data, timeout)                                         \
+    zmk_queue_stats_msgq_put(&ZMK_QUEUE_STATS(var), msgq, data, timeout)
+
+/**
+ * @brief Copy the counters of the queue at an index.
+ *
+ * @retval -ENOENT There are fewer queues than that.
+ */
+int zmk_queue_stats_get(size_t index, struct zmk_queue_stats *stats);
+
+/**
+ * @brief Reset the counters of all queues, keeping their names and capacities.
+ */
+void zmk_queue_stats_clear(void);
+
+#else
+
+#define ZMK_QUEUE_STATS_DEFINE(var, _name, _capacity)                                              \
+    extern struct zmk_queue_stats ZMK_QUEUE_STATS(var)
+#define ZMK_QUEUE_STATS_PUT(var, used)
+#define ZMK_QUEUE_STATS_OVERFLOW(var)
+#define ZMK_QUEUE_STATS_MSGQ_PUT(var, msgq, data, timeout) k_msgq_put(msgq, data, timeout)
+
+#endif // IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
@@ -27,3 +27,14 @@ int zmk_rgb_underglow_change_sat(int direction);
 int zmk_rgb_underglow_change_brt(int direction);
 int zmk_rgb_underglow_change_spd(int direction);
 int zmk_rgb_underglow_set_hsb(struct zmk_led_hsb color);
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+#include <zmk/split/transport/types.h>
+
+/**
+ * @brief Take over the underglow state and animation time base sent by the split central.
+ */
+int zmk_rgb_underglow_apply_sync(const struct zmk_split_transport_rgb_sync *sync);
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+
 /**
  * Erases all saved settings.
  *
@@ -13,3 +16,31 @@
  * subsystem. This should typically be followed by a call to sys_reboot().
  */
 int zmk_settings_erase(void);
+
+struct zmk_settings_save {
+    /** Writes the settings. Called from the system work queue. */
+    void (*save)(void);
+    sys_snode_t node;
+    bool pending;
+};
+
+/**
+ * @brief Define a set of settings whose writes are batched with the other pending saves.
+ *
+ * @param _name Name of the zmk_settings_save to define.
+ * @param _save Function that writes the settings.
+ */
+#define ZMK_SETTINGS_SAVE_DEFINE(_name, _save) static struct zmk_settings_save _name = {.save = _save}
+
+/**
+ * @brief Mark settings as changed, so they are written in the next batch of saves.
+ *
+ * The batch is written once nothing has changed for CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE, or
+ * earlier if the keyboard goes idle.
+ */
+int zmk_settings_save_schedule(struct zmk_settings_save *save);
+
+/**
+ * @brief Write all pending settings now.
+ */
+void zmk_settings_save_flush(void);
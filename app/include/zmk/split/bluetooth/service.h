@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <zephyr/sys/util.h>
+
 #include <zmk/events/sensor_event.h>
 #include <zmk/sensors.h>
 
@@ -31,9 +33,61 @@ struct zmk_split_run_behavior_payload {
     char behavior_dev[ZMK_SPLIT_RUN_BEHAVIOR_DEV_LEN];
 } __packed;
 
+struct zmk_split_run_behaviors_entry {
+    uint8_t state;
+    // Little endian milliseconds to wait after this invocation before running the next one.
+    uint16_t wait_ms;
+    uint32_t param1;
+    uint32_t param2;
+    // Behavior label, padded with NUL characters.
+    char behavior_dev[ZMK_SPLIT_RUN_BEHAVIOR_DEV_LEN];
+} __packed;
+
+struct zmk_split_run_behaviors_payload {
+    uint8_t position;
+    uint8_t source;
+    struct zmk_split_run_behaviors_entry entries[];
+} __packed;
+
 struct zmk_split_input_event_payload {
     uint8_t type;
     uint16_t code;
     uint32_t value;
     uint8_t sync;
 } __packed;
+
+#define ZMK_SPLIT_POSITION_EVENT_PRESSED BIT(7)
+
+struct zmk_split_position_event {
+    // Key position in the low seven bits, with ZMK_SPLIT_POSITION_EVENT_PRESSED set for presses.
+    uint8_t position;
+    // Little endian milliseconds since the previous event in the notification, 0 for the first.
+    uint16_t delta;
+} __packed;
+
+// The events can be followed by one byte with the peripheral's battery level, when it changed
+// since the previous notification. A notification can then carry no events at all.
+struct zmk_split_position_events_payload {
+    // Little endian milliseconds between the last event happening and the notification being sent.
+    uint16_t age;
+    struct zmk_split_position_event events[];
+} __packed;
+
+struct zmk_split_bt_latency_stats {
+    /** Key events whose notification has been transmitted. */
+    uint32_t events;
+    /** Sum of the times from each key event being recorded to it being transmitted, in ms. */
+    uint32_t total_ms;
+    /** Longest time from a key event being recorded to it being transmitted, in ms. */
+    uint32_t max_ms;
+    /** Time from the most recent key event being recorded to it being transmitted, in ms. */
+    uint32_t last_ms;
+};
+
+/**
+ * @brief Get the key event latency measured on a split peripheral.
+ *
+ * @param stats Filled with the statistics so far.
+ * @retval 0 on success.
+ */
+int zmk_split_bt_peripheral_get_latency_stats(struct zmk_split_bt_latency_stats *stats);
@@ -20,7 +20,9 @@
 
 #endif
 
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_DROP)
+#define WIRED_PERIPHERAL_COUNT CONFIG_ZMK_SPLIT_WIRED_MULTI_DROP_PERIPHERALS
+#elif IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED)
 #define WIRED_PERIPHERAL_COUNT 1
 #else
 #define WIRED_PERIPHERAL_COUNT 0
@@ -32,15 +34,45 @@
 #include <zmk/hid_indicators_types.h>
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC) || IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+#include <zmk/split/transport/types.h>
+#endif
+
 int zmk_split_central_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
                                       struct zmk_behavior_binding_event event, bool state);
 
+/**
+ * @brief Invoke a behavior with global locality on all connected peripherals, without waiting for
+ * it to be sent.
+ */
+int zmk_split_central_invoke_global_behavior(struct zmk_behavior_binding *binding,
+                                             struct zmk_behavior_binding_event event, bool state);
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
 int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators);
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+/**
+ * @brief Send the underglow state and animation time base to all connected peripherals.
+ */
+int zmk_split_central_update_rgb_sync(const struct zmk_split_transport_rgb_sync *sync);
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+/**
+ * @brief Send a link benchmark ping to a peripheral over the active transport.
+ */
+int zmk_split_central_send_link_ping(uint8_t source,
+                                     const struct zmk_split_transport_link_ping *ping);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 int zmk_split_central_get_peripheral_battery_level(uint8_t source, uint8_t *level);
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <zmk/split/transport/types.h>
+
+/**
+ * @file
+ * @brief Split link latency and throughput benchmarks, run by the central.
+ *
+ * The central sends ping commands through the active split transport, and the peripheral answers
+ * each of them with one or more pong events. Pongs are timed when they reach the central's event
+ * handler, so the results include the time they spend in the transport's queues.
+ */
+
+/** Bucket i counts round trips from 2^i to 2^(i+1) µs, bucket 0 those below 2 µs. */
+#define ZMK_SPLIT_LINK_BENCHMARK_BUCKETS 16
+
+struct zmk_split_link_benchmark_rtt {
+    uint16_t sent;
+    uint16_t received;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t avg_us;
+    /** Interarrival jitter of the pongs as in RFC 3550, which needs no clock sync. */
+    uint32_t jitter_us;
+    uint16_t buckets[ZMK_SPLIT_LINK_BENCHMARK_BUCKETS];
+};
+
+struct zmk_split_link_benchmark_rate {
+    /** Highest rate tried at which no event was lost, in events per second. */
+    uint16_t max_rate;
+    /** Rate at which the events of that run actually arrived, in events per second. */
+    uint32_t achieved_rate;
+    /** First rate tried at which events were lost, or zero if there was none. */
+    uint16_t lossy_rate;
+    /** Events lost at that rate, out of CONFIG_ZMK_SPLIT_LINK_BENCHMARK_BURST. */
+    uint16_t lost;
+};
+
+/**
+ * @brief Measure round trips to a peripheral.
+ *
+ * Blocks until all pongs have arrived or timed out.
+ *
+ * @param source The peripheral to ping.
+ * @param count Number of pings to send.
+ * @param interval_ms Time between pings.
+ * @param result Filled in with the results.
+ *
+ * @retval -EBUSY Another benchmark is running.
+ */
+int zmk_split_link_benchmark_run_rtt(uint8_t source, uint16_t count, uint16_t interval_ms,
+                                     struct zmk_split_link_benchmark_rtt *result);
+
+/**
+ * @brief Find the highest event rate a peripheral's link sustains without losing events.
+ *
+ * The peripheral sends bursts of CONFIG_ZMK_SPLIT_LINK_BENCHMARK_BURST pongs at increasing rates
+ * until some of them are lost, whether by the peripheral's transport or in the central's queues.
+ *
+ * @retval -EBUSY Another benchmark is running.
+ */
+int zmk_split_link_benchmark_run_rate(uint8_t source, struct zmk_split_link_benchmark_rate *result);
+
+/**
+ * @brief Record a pong received from a peripheral.
+ */
+void zmk_split_link_benchmark_handle_pong(uint8_t source,
+                                          const struct zmk_split_transport_link_pong *pong);
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <zephyr/types.h>
 
 #include <zmk/split/transport/types.h>
@@ -37,6 +38,20 @@ int zmk_split_transport_central_peripheral_event_handler(
     const struct zmk_split_transport_central *transport, uint8_t source,
     struct zmk_split_transport_peripheral_event ev);
 
+// Like zmk_split_transport_central_peripheral_event_handler, for transports that know when the
+// event happened, in central uptime milliseconds.
+int zmk_split_transport_central_timed_peripheral_event_handler(
+    const struct zmk_split_transport_central *transport, uint8_t source,
+    struct zmk_split_transport_peripheral_event ev, int64_t timestamp);
+
+struct zmk_position_state_changed;
+
+// Raise a run of key position events from peripherals, sorted by timestamp, merged with the local
+// kscan events waiting to be raised. Must be called from the input work queue.
+int zmk_split_transport_central_position_event_run_handler(
+    const struct zmk_split_transport_central *transport,
+    const struct zmk_position_state_changed *events, size_t len);
+
 #define ZMK_SPLIT_TRANSPORT_CENTRAL_REGISTER(name, _api, priority)                                 \
     STRUCT_SECTION_ITERABLE_NAMED(zmk_split_transport_central, _CONCAT(priority, _##name),         \
                                   name) = {                                                        \
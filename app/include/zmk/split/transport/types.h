@@ -16,10 +16,21 @@ enum zmk_split_transport_connections_status {
     ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
 };
 
+// Link quality counters since boot, left at zero by transports that don't track them.
+struct zmk_split_transport_link_stats {
+    uint32_t frames;
+    uint32_t crc_errors;
+    uint32_t resyncs;
+    // Round trip time of the most recent link check, in ms.
+    uint32_t latency_ms;
+    uint32_t baud_rate;
+};
+
 struct zmk_split_transport_status {
     bool available;
     bool enabled;
     enum zmk_split_transport_connections_status connections;
+    struct zmk_split_transport_link_stats link_stats;
 };
 
 typedef struct zmk_split_transport_status (*zmk_split_transport_get_status_t)(void);
@@ -30,8 +41,35 @@ enum zmk_split_transport_peripheral_event_type {
     ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT,
     ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,
     ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
+    // Used by transports for their own link management, never passed to the event handler.
+    ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_ACK,
+    ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SLOT_END,
+    ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_PONG,
 };
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+// Sent by the central to measure the split link. Times are each side's own uptime in µs, so they
+// can only be compared with other times from the same side.
+struct zmk_split_transport_link_ping {
+    uint32_t seq;
+    // Central time the ping was sent, echoed back in every pong.
+    uint32_t sent_us;
+    // Number of pongs to send back, spread evenly at `rate` pongs per second.
+    uint16_t count;
+    uint16_t rate;
+} __packed;
+
+struct zmk_split_transport_link_pong {
+    uint32_t seq;
+    uint32_t sent_us;
+    // Peripheral time the pong was sent.
+    uint32_t peripheral_us;
+    uint16_t index;
+} __packed;
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 struct zmk_split_transport_peripheral_event {
     enum zmk_split_transport_peripheral_event_type type;
 
@@ -58,6 +96,14 @@ struct zmk_split_transport_peripheral_event {
         struct {
             uint8_t level;
         } battery_event;
+
+        struct {
+            uint32_t baud_rate;
+        } link_ack;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+        struct zmk_split_transport_link_pong link_pong;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
     } data;
 } __packed;
 
@@ -66,8 +112,41 @@ enum zmk_split_transport_central_command_type {
     ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR,
     ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT,
     ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS,
+    ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR_BATCH,
+    // Used by transports for their own link management, never passed to the command handler.
+    ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_BAUD_RATE,
+    // Kept after the link management command so the existing values stay the same on the wire.
+    ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_RGB_SYNC,
+    ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_LINK_PING,
+} __packed;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+struct zmk_split_transport_behavior_invocation {
+    char behavior_dev[16];
+    uint32_t param1, param2;
+    uint8_t state;
+    // Time to wait after this invocation before running the next one in the batch.
+    uint16_t wait_ms;
+} __packed;
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+struct zmk_split_transport_rgb_sync {
+    // Time since the central's current animation started, so peripherals can line up their own.
+    uint32_t elapsed_ms;
+    uint16_t hue;
+    uint8_t saturation;
+    uint8_t brightness;
+    uint8_t speed;
+    uint8_t effect;
+    uint8_t on;
 } __packed;
 
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
 struct zmk_split_transport_central_command {
     enum zmk_split_transport_central_command_type type;
 
@@ -87,5 +166,26 @@ struct zmk_split_transport_central_command {
         struct {
             zmk_hid_indicators_t indicators;
         } set_hid_indicators;
+
+        struct {
+            uint32_t baud_rate;
+        } set_baud_rate;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+        // Only the first `count` invocations are sent over the transport.
+        struct {
+            uint32_t position;
+            uint8_t event_source;
+            uint8_t count;
+            struct zmk_split_transport_behavior_invocation
+                invocations[CONFIG_ZMK_SPLIT_BEHAVIOR_BATCH_SIZE];
+        } invoke_behavior_batch;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+        struct zmk_split_transport_rgb_sync set_rgb_sync;
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+        struct zmk_split_transport_link_ping link_ping;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
     } data;
 } __packed;
\ No newline at end of file
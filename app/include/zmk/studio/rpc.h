@@ -20,6 +20,18 @@ enum zmk_studio_rpc_handler_security {
     ZMK_STUDIO_RPC_HANDLER_UNSECURED,
 };
 
+/**
+ * @brief Where a handler runs relative to the other requests.
+ */
+enum zmk_studio_rpc_handler_dispatch {
+    /** Runs on the RPC thread, once any deferred request still in progress has completed. */
+    ZMK_STUDIO_RPC_HANDLER_INLINE,
+    /** Runs on the RPC thread, even while a deferred request is in progress. */
+    ZMK_STUDIO_RPC_HANDLER_READ,
+    /** Runs on the RPC worker thread, so that reads are answered while it is in progress. */
+    ZMK_STUDIO_RPC_HANDLER_DEFERRED,
+};
+
 struct zmk_studio_rpc_notification {
     zmk_studio_Notification notification;
 };
@@ -54,6 +66,7 @@ struct zmk_rpc_subsystem_handler {
     uint8_t subsystem_choice;
     uint8_t request_choice;
     enum zmk_studio_rpc_handler_security security;
+    enum zmk_studio_rpc_handler_dispatch dispatch;
 };
 
 typedef int (*zmk_rpc_subsystem_settings_reset_func)(void);
@@ -94,21 +107,31 @@ struct zmk_rpc_subsystem_settings_reset {
  * @brief Register an RPC subsystem handler handler a specific request within the subsystem.
  * @param prefix The identifier for the subsystem, e.g. `core`, `keymap`, etc.
  * @param request_id The identifier for the request ID, e.g. `save_changes`.
- * @param _secured Whether the handler requires the device be unlocked to allow invocation.
+ * @param _security Whether the handler requires the device be unlocked to allow invocation.
+ * @param _dispatch Where the handler runs, see `zmk_studio_rpc_handler_dispatch`.
  *
  * @note  A function with a name matching the request_id must be in-scope and will be used as the
  *        the callback handler. The function must have a signature of
  *        zmk_studio_Response (*func)(const zmk_studio_Request*)
  */
-#define ZMK_RPC_SUBSYSTEM_HANDLER(prefix, request_id, _security)                                   \
+#define ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(prefix, request_id, _security, _dispatch)               \
     STRUCT_SECTION_ITERABLE(zmk_rpc_subsystem_handler,                                             \
                             prefix##_subsystem_handler_##request_id) = {                           \
         .func = request_id,                                                                        \
         .subsystem_choice = zmk_studio_Request_##prefix##_tag,                                     \
         .request_choice = zmk_##prefix##_Request_##request_id##_tag,                               \
         .security = _security,                                                                     \
+        .dispatch = _dispatch,                                                                     \
     };
 
+/**
+ * @brief Register an RPC subsystem handler that runs on the RPC thread, in order with the other
+ *        requests.
+ * @see   ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH
+ */
+#define ZMK_RPC_SUBSYSTEM_HANDLER(prefix, request_id, _security)                                   \
+    ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(prefix, request_id, _security, ZMK_STUDIO_RPC_HANDLER_INLINE)
+
 #define ZMK_RPC_SUBSYSTEM_SETTINGS_RESET(prefix, _callback)                                        \
     STRUCT_SECTION_ITERABLE(zmk_rpc_subsystem_settings_reset, _##prefix##_settings_reset) = {      \
         .callback = _callback,                                                                     \
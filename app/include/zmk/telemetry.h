@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/toolchain.h>
+
+enum zmk_telemetry_record_type {
+    /** A key position was pressed. arg is the source, value the position. */
+    ZMK_TELEMETRY_POSITION_PRESSED,
+    /** A key position was released. arg is the source, value the position. */
+    ZMK_TELEMETRY_POSITION_RELEASED,
+    /** A hold-tap decided to hold. arg is the decision moment, value the ms since the press. */
+    ZMK_TELEMETRY_HOLD_TAP_HOLD,
+    /** A hold-tap decided to tap. arg is the decision moment, value the ms since the press. */
+    ZMK_TELEMETRY_HOLD_TAP_TAP,
+    /** A HID report was sent. arg is the transport, value the µs the send took. */
+    ZMK_TELEMETRY_HID_REPORT_SENT,
+    /** A split key event arrived. arg is the source, value its ms on the peripheral. */
+    ZMK_TELEMETRY_SPLIT_EVENT_RECEIVED,
+    /** A profiled work handler ran. arg is its index, value its longest run in µs since the last. */
+    ZMK_TELEMETRY_WORK_HANDLER_RUN,
+    /** A keyboard report was sent. arg is the transport, value the CRC-16/ANSI of its body. */
+    ZMK_TELEMETRY_KEYBOARD_REPORT,
+};
+
+struct zmk_telemetry_record {
+    /** Uptime when the record was made, in µs. Wraps after about 71 minutes. */
+    uint32_t timestamp_us;
+    /** Value of enum zmk_telemetry_record_type. */
+    uint8_t type;
+    uint8_t arg;
+    uint16_t value;
+} __packed;
+
+#if IS_ENABLED(CONFIG_ZMK_TELEMETRY)
+
+/**
+ * @brief Add a record to the telemetry ring buffer, overwriting the oldest one if it is full.
+ *
+ * Safe to call from any context, including ISRs.
+ */
+void zmk_telemetry_record(enum zmk_telemetry_record_type type, uint8_t arg, uint16_t value);
+
+/**
+ * @brief Take the oldest records out of the telemetry ring buffer.
+ *
+ * @param records Filled with up to count records, oldest first.
+ * @param count Size of the records array.
+ * @retval the number of records taken.
+ */
+size_t zmk_telemetry_read(struct zmk_telemetry_record *records, size_t count);
+
+/**
+ * @brief Get the number of records that were overwritten before being read.
+ */
+uint32_t zmk_telemetry_get_dropped(void);
+
+/**
+ * @brief Discard all buffered records and reset the dropped count.
+ */
+void zmk_telemetry_clear(void);
+
+#else
+
+static inline void zmk_telemetry_record(enum zmk_telemetry_record_type type, uint8_t arg,
+                                        uint16_t value) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_TELEMETRY)
@@ -12,9 +12,24 @@ int zmk_usb_hid_send_keyboard_report(void);
 int zmk_usb_hid_send_consumer_report(void);
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_usb_hid_send_mouse_report(void);
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+int zmk_usb_hid_send_abs_pointer_report(void);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 void zmk_usb_hid_set_protocol(uint8_t protocol);
 
+/**
+ * @brief Forget reports in flight or queued, once the bus is reset, disconnected or configured.
+ */
+void zmk_usb_hid_reset_endpoints(void);
+
+/**
+ * @brief Send the latest state of the reports that changed while the bus was suspended.
+ *
+ * Called once the bus is no longer suspended, so that the next suspend requests a wakeup again.
+ */
+void zmk_usb_hid_bus_resumed(void);
+
 #if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
 int zmk_usb_hid_send_report(const uint8_t *report, size_t len);
 #endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
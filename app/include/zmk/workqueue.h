@@ -1 +1,160 @@
+/*
+ * Copyright (c) 2023 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#if IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
+
 struct k_work_q *zmk_workqueue_lowprio_work_q(void);
+
+#endif // IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
+
+/**
+ * @brief The kinds of work, each of which is submitted to its own work queue.
+ */
+enum zmk_workqueue_class {
+    /** Work on the key event path, from processing key events through sending HID reports. */
+    ZMK_WORKQUEUE_INPUT,
+    /** Work which only follows the input, such as battery sampling, lighting and settings saves. */
+    ZMK_WORKQUEUE_OBSERVER,
+};
+
+/**
+ * @brief Get the work queue for a class of work.
+ *
+ * Input work goes to the dedicated input work queue when it is enabled, and observer work to the
+ * low priority work queue when it is enabled, so housekeeping never delays the key event path.
+ * Any class without its own queue uses the system work queue.
+ */
+struct k_work_q *zmk_workqueue_for_class(enum zmk_workqueue_class work_class);
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE) && CONFIG_ZMK_INPUT_WORK_QUEUE_EVENT_BUDGET_US > 0
+
+/**
+ * @brief Warn if handling one event on the input work queue took longer than its budget.
+ *
+ * @param start_cycles The k_cycle_get_32() value from before the event was handled.
+ * @param position The key position of the event, for the warning.
+ */
+void zmk_workqueue_input_budget_check(uint32_t start_cycles, int32_t position);
+
+#else
+
+static inline void zmk_workqueue_input_budget_check(uint32_t start_cycles, int32_t position) {}
+
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_WORKQUEUE_PROFILER)
+
+/**
+ * @brief Run statistics of one work handler, kept by ZMK_WORKQUEUE_PROFILE_HANDLER().
+ */
+struct zmk_workqueue_profile {
+    const char *name;
+    /** The work queue thread the handler last ran on. */
+    k_tid_t thread;
+    /** Set from submission until the handler starts, while submitted_cycles is valid. */
+    atomic_t queued;
+    uint32_t submitted_cycles;
+    uint32_t runs;
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+    /** Longest run since the last telemetry sample. */
+    uint32_t sample_max_cycles;
+    /** Runs which were stamped with ZMK_WORKQUEUE_PROFILE_SUBMITTED() before they started. */
+    uint32_t delayed_runs;
+    uint64_t total_delay_cycles;
+    uint32_t max_delay_cycles;
+};
+
+uint32_t zmk_workqueue_profile_begin(struct zmk_workqueue_profile *profile);
+void zmk_workqueue_profile_end(struct zmk_workqueue_profile *profile, uint32_t start_cycles);
+void zmk_workqueue_profile_submitted(struct zmk_workqueue_profile *profile);
+
+#define ZMK_WORKQUEUE_PROFILE(handler) _CONCAT(zmk_workqueue_profile_, handler)
+
+/**
+ * @brief Declare a work handler and a profiled wrapper for it, to be passed to K_WORK_DEFINE()
+ * and friends with ZMK_WORKQUEUE_PROFILED().
+ *
+ * Use it in place of the handler's forward declaration, or of the start of its definition, as it
+ * ends with the handler's signature. Either way it must come before the work is defined.
+ */
+#define ZMK_WORKQUEUE_PROFILE_HANDLER(handler)                                                     \
+    static void handler(struct k_work *work);                                                      \
+    static STRUCT_SECTION_ITERABLE(zmk_workqueue_profile, ZMK_WORKQUEUE_PROFILE(handler)) = {     \
+        .name = STRINGIFY(handler)};                                                               \
+    static void _CONCAT(handler, _profiled)(struct k_work *work) {                                 \
+        const uint32_t start = zmk_workqueue_profile_begin(&ZMK_WORKQUEUE_PROFILE(handler));       \
+        handler(work);                                                                             \
+        zmk_workqueue_profile_end(&ZMK_WORKQUEUE_PROFILE(handler), start);                         \
+    }                                                                                              \
+    static void handler(struct k_work *work)
+
+#define ZMK_WORKQUEUE_PROFILED(handler) _CONCAT(handler, _profiled)
+
+/**
+ * @brief Note that work with a profiled handler was submitted, to measure its queueing delay.
+ */
+#define ZMK_WORKQUEUE_PROFILE_SUBMITTED(handler)                                                   \
+    zmk_workqueue_profile_submitted(&ZMK_WORKQUEUE_PROFILE(handler))
+
+#else
+
+#define ZMK_WORKQUEUE_PROFILE_HANDLER(handler) static void handler(struct k_work *work)
+#define ZMK_WORKQUEUE_PROFILED(handler) handler
+#define ZMK_WORKQUEUE_PROFILE_SUBMITTED(handler)
+
+#endif // IS_ENABLED(CONFIG_ZMK_WORKQUEUE_PROFILER)
+
+struct zmk_workqueue_deadline;
+
+typedef void (*zmk_workqueue_deadline_handler_t)(struct zmk_workqueue_deadline *deadline);
+
+/**
+ * @brief A lightweight timeout sharing a single kernel timeout with all other deadlines.
+ *
+ * Pending deadlines are kept in a list sorted by expiry, and only the earliest of them has a
+ * kernel timeout armed. Handlers are called from the ZMK_WORKQUEUE_INPUT work queue, in expiry
+ * order. Embed one in a struct and use CONTAINER_OF() in the handler to get back to it.
+ */
+struct zmk_workqueue_deadline {
+    sys_dnode_t node;
+    int64_t expires_at;
+    zmk_workqueue_deadline_handler_t handler;
+};
+
+/**
+ * @brief Initialize a deadline before its first use.
+ */
+void zmk_workqueue_deadline_init(struct zmk_workqueue_deadline *deadline,
+                                 zmk_workqueue_deadline_handler_t handler);
+
+/**
+ * @brief Schedule a deadline, or move it if it is already pending.
+ *
+ * @param expires_at The uptime in milliseconds at which the handler should be called. Times in
+ * the past make the handler run as soon as possible.
+ */
+void zmk_workqueue_deadline_schedule(struct zmk_workqueue_deadline *deadline, int64_t expires_at);
+
+/**
+ * @brief Cancel a pending deadline.
+ *
+ * @retval 0 if the deadline was pending and has been cancelled.
+ * @retval -EINPROGRESS if the handler for the deadline is currently running.
+ * @retval -EALREADY if the deadline was not pending.
+ */
+int zmk_workqueue_deadline_cancel(struct zmk_workqueue_deadline *deadline);
+
+/**
+ * @brief Check whether a deadline is waiting to expire.
+ */
+bool zmk_workqueue_deadline_is_pending(const struct zmk_workqueue_deadline *deadline);
@@ -45,9 +45,15 @@ struct il0323_cfg {
 
 static uint8_t il0323_pwr[] = DT_INST_PROP(0, pwr);
 
+/* Copy of the whole panel contents, which the controller needs as the old data of a window */
 static uint8_t last_buffer[IL0323_BUFFER_SIZE];
 static bool blanking_on = true;
 static bool init_clear_done = false;
+static uint32_t partial_refreshes;
+
+static K_SEM_DEFINE(busy_sem, 0, 1);
+static struct gpio_callback busy_cb;
+static bool busy_irq;
 
 static inline int il0323_write_cmd(const struct il0323_cfg *cfg, uint8_t cmd, uint8_t *data,
                                    size_t len) {
@@ -71,13 +77,37 @@ static inline int il0323_write_cmd(const struct il0323_cfg *cfg, uint8_t cmd, ui
     return 0;
 }
 
+static inline int il0323_write_data(const struct il0323_cfg *cfg, const uint8_t *data,
+                                    size_t len) {
+    struct spi_buf buf = {.buf = (uint8_t *)data, .len = len};
+    struct spi_buf_set buf_set = {.buffers = &buf, .count = 1};
+
+    gpio_pin_set_dt(&cfg->dc, 0);
+    if (spi_write_dt(&cfg->spi, &buf_set)) {
+        return -EIO;
+    }
+
+    return 0;
+}
+
+static void il0323_busy_cb(const struct device *port, struct gpio_callback *cb,
+                           gpio_port_pins_t pins) {
+    k_sem_give(&busy_sem);
+}
+
 static inline void il0323_busy_wait(const struct il0323_cfg *cfg) {
+    /* Reset before reading the pin, so an edge right after the read still wakes us up */
+    k_sem_reset(&busy_sem);
     int pin = gpio_pin_get_dt(&cfg->busy);
 
     while (pin > 0) {
         __ASSERT(pin >= 0, "Failed to get pin level");
-        // LOG_DBG("wait %u", pin);
-        k_msleep(IL0323_BUSY_DELAY);
+        if (busy_irq) {
+            /* The timeout only guards against a missed edge */
+            k_sem_take(&busy_sem, K_MSEC(IL0323_BUSY_TIMEOUT));
+        } else {
+            k_msleep(IL0323_BUSY_DELAY);
+        }
         pin = gpio_pin_get_dt(&cfg->busy);
     }
 }
@@ -95,6 +125,60 @@ static int il0323_update_display(const struct device *dev) {
     return 0;
 }
 
+/* Send the part of last_buffer covered by a window, one row at a time unless it is contiguous */
+static int il0323_write_window_data(const struct il0323_cfg *cfg, uint16_t x, uint16_t y,
+                                    uint16_t width, uint16_t height) {
+    const size_t row_len = width / IL0323_PIXELS_PER_BYTE;
+    const uint8_t *start = &last_buffer[y * IL0323_NUMOF_PAGES + x / IL0323_PIXELS_PER_BYTE];
+
+    if (row_len == IL0323_NUMOF_PAGES) {
+        return il0323_write_data(cfg, start, row_len * height);
+    }
+
+    for (uint16_t row = 0; row < height; row++) {
+        if (il0323_write_data(cfg, start + row * IL0323_NUMOF_PAGES, row_len)) {
+            return -EIO;
+        }
+    }
+
+    return 0;
+}
+
+static void il0323_store_window(uint16_t x, uint16_t y,
+                                const struct display_buffer_descriptor *desc, const uint8_t *buf) {
+    const size_t row_len = desc->width / IL0323_PIXELS_PER_BYTE;
+    const size_t pitch = desc->pitch / IL0323_PIXELS_PER_BYTE;
+
+    for (uint16_t row = 0; row < desc->height; row++) {
+        memcpy(&last_buffer[(y + row) * IL0323_NUMOF_PAGES + x / IL0323_PIXELS_PER_BYTE],
+               &buf[row * pitch], row_len);
+    }
+}
+
+/*
+ * Partial refreshes leave a little ghosting behind, so every so often the whole panel is
+ * refreshed from last_buffer outside of partial mode instead.
+ */
+static int il0323_full_refresh(const struct device *dev, const uint16_t x, const uint16_t y,
+                               const struct display_buffer_descriptor *desc, const void *buf) {
+    const struct il0323_cfg *cfg = dev->config;
+
+    LOG_DBG("Full refresh after %u partial refreshes", partial_refreshes);
+    partial_refreshes = 0;
+
+    if (il0323_write_cmd(cfg, IL0323_CMD_DTM1, last_buffer, IL0323_BUFFER_SIZE)) {
+        return -EIO;
+    }
+
+    il0323_store_window(x, y, desc, buf);
+
+    if (il0323_write_cmd(cfg, IL0323_CMD_DTM2, last_buffer, IL0323_BUFFER_SIZE)) {
+        return -EIO;
+    }
+
+    return il0323_update_display(dev);
+}
+
 static int il0323_write(const struct device *dev, const uint16_t x, const uint16_t y,
                         const struct display_buffer_descriptor *desc, const void *buf) {
     const struct il0323_cfg *cfg = dev->config;
@@ -102,6 +186,7 @@ static int il0323_write(const struct device *dev, const uint16_t x, const uint16
     uint16_t y_end_idx = y + desc->height - 1;
     uint8_t ptl[IL0323_PTL_REG_LENGTH] = {0};
     size_t buf_len;
+    bool full_refresh;
 
     LOG_DBG("x %u, y %u, height %u, width %u, pitch %u", x, y, desc->height, desc->width,
             desc->pitch);
@@ -112,6 +197,8 @@ static int il0323_write(const struct device *dev, const uint16_t x, const uint16
     __ASSERT(buf_len != 0U, "Buffer of length zero");
     __ASSERT(!(desc->width % IL0323_PIXELS_PER_BYTE), "Buffer width not multiple of %d",
              IL0323_PIXELS_PER_BYTE);
+    __ASSERT(!(x % IL0323_PIXELS_PER_BYTE), "X coordinate not multiple of %d",
+             IL0323_PIXELS_PER_BYTE);
 
     LOG_DBG("buf_len %d", buf_len);
     if ((y_end_idx > (EPD_PANEL_HEIGHT - 1)) || (x_end_idx > (EPD_PANEL_WIDTH - 1))) {
@@ -128,6 +215,13 @@ static int il0323_write(const struct device *dev, const uint16_t x, const uint16
     LOG_HEXDUMP_DBG(ptl, sizeof(ptl), "ptl");
 
     il0323_busy_wait(cfg);
+
+    full_refresh = !blanking_on && CONFIG_IL0323_FULL_REFRESH_INTERVAL > 0 &&
+                   partial_refreshes + 1 >= CONFIG_IL0323_FULL_REFRESH_INTERVAL;
+    if (full_refresh) {
+        return il0323_full_refresh(dev, x, y, desc, buf);
+    }
+
     if (il0323_write_cmd(cfg, IL0323_CMD_PIN, NULL, 0)) {
         return -EIO;
     }
@@ -136,21 +230,25 @@ static int il0323_write(const struct device *dev, const uint16_t x, const uint16
         return -EIO;
     }
 
-    if (il0323_write_cmd(cfg, IL0323_CMD_DTM1, last_buffer, IL0323_BUFFER_SIZE)) {
+    /* Old data is just the window being written, taken from the copy of the panel contents */
+    if (il0323_write_cmd(cfg, IL0323_CMD_DTM1, NULL, 0) ||
+        il0323_write_window_data(cfg, x, y, desc->width, desc->height)) {
         return -EIO;
     }
 
-    if (il0323_write_cmd(cfg, IL0323_CMD_DTM2, (uint8_t *)buf, buf_len)) {
+    il0323_store_window(x, y, desc, buf);
+
+    if (il0323_write_cmd(cfg, IL0323_CMD_DTM2, NULL, 0) ||
+        il0323_write_window_data(cfg, x, y, desc->width, desc->height)) {
         return -EIO;
     }
 
-    memcpy(last_buffer, (uint8_t *)buf, IL0323_BUFFER_SIZE);
-
     /* Update partial window and disable Partial Mode */
     if (blanking_on == false) {
         if (il0323_update_display(dev)) {
             return -EIO;
         }
+        partial_refreshes++;
     }
 
     if (il0323_write_cmd(cfg, IL0323_CMD_POUT, NULL, 0)) {
@@ -215,6 +313,9 @@ static int il0323_blanking_off(const struct device *dev) {
         return -EIO;
     }
 
+    /* That was a full refresh, the panel is clean again */
+    partial_refreshes = 0;
+
     return 0;
 }
 
@@ -368,6 +469,14 @@ static int il0323_init(const struct device *dev) {
 
     gpio_pin_configure_dt(&cfg->busy, GPIO_INPUT);
 
+    /* Fall back to polling BUSY if its pin can't raise interrupts */
+    gpio_init_callback(&busy_cb, il0323_busy_cb, BIT(cfg->busy.pin));
+    busy_irq = gpio_add_callback(cfg->busy.port, &busy_cb) == 0 &&
+               gpio_pin_interrupt_configure_dt(&cfg->busy, GPIO_INT_EDGE_TO_INACTIVE) == 0;
+    if (!busy_irq) {
+        LOG_WRN("Polling the IL0323 busy signal, it can't raise interrupts");
+    }
+
     return il0323_controller_init(dev);
 }
 
@@ -41,6 +41,8 @@ struct reg_595_drv_data {
     struct k_sem lock;
 
     uint32_t gpio_cache;
+    /** Whether gpio_cache matches what was last written to the registers. */
+    bool gpio_cache_valid;
 };
 
 static int reg_595_write_registers(const struct device *dev, uint32_t value) {
@@ -48,6 +50,11 @@ static int reg_595_write_registers(const struct device *dev, uint32_t value) {
     struct reg_595_drv_data *const drv_data = (struct reg_595_drv_data *const)dev->data;
     int ret = 0;
 
+    /* Nothing to do if the registers already hold this value, e.g. a pin set to its own level */
+    if (drv_data->gpio_cache_valid && drv_data->gpio_cache == value) {
+        return 0;
+    }
+
     uint8_t nwrite = config->ngpios / 8;
     uint32_t reg_data = sys_cpu_to_be32(value);
 
@@ -65,10 +72,12 @@ static int reg_595_write_registers(const struct device *dev, uint32_t value) {
     ret = spi_write_dt(&config->bus, &tx);
     if (ret < 0) {
         LOG_ERR("spi_write FAIL %d\n", ret);
+        drv_data->gpio_cache_valid = false;
         return ret;
     }
 
     drv_data->gpio_cache = value;
+    drv_data->gpio_cache_valid = true;
     return 0;
 }
 
@@ -40,6 +40,9 @@ struct max7318_config {
 
     struct i2c_dt_spec i2c_bus;
     uint8_t ngpios;
+
+    // Optional INT output of the expander, which is asserted when an input changes.
+    struct gpio_dt_spec int_gpio;
 };
 
 // Runtime driver data
@@ -53,7 +56,12 @@ struct max7318_drv_data {
         uint16_t ipol;
         uint16_t config;
         uint16_t output;
+        uint16_t input;
     } reg_cache;
+
+    // Whether reg_cache.input can be returned without reading the input registers again.
+    bool input_cache_valid;
+    int64_t input_cache_ticks;
 };
 
 /**
@@ -182,6 +190,9 @@ static int max7318_config(const struct device *dev, gpio_pin_t pin, gpio_flags_t
 
     k_sem_take(&drv_data->lock, K_FOREVER);
 
+    // Inputs may read differently once the direction has changed.
+    drv_data->input_cache_valid = false;
+
     int ret = 0;
     if ((flags & GPIO_OPEN_DRAIN) != 0U) {
         ret = -ENOTSUP;
@@ -205,6 +216,37 @@ done:
     return ret;
 }
 
+/**
+ * @brief Check whether the last read of the input registers can still be used.
+ *
+ * With an INT pin, the inputs are unchanged for as long as the expander has not asserted it, since
+ * reading the input registers clears it. Without one, reads within
+ * CONFIG_GPIO_MAX7318_INPUT_CACHE_US of each other are assumed to be part of the same scan.
+ *
+ * @param dev The max7318 device.
+ *
+ * @return true if reg_cache.input is current.
+ */
+static bool input_cache_is_current(const struct device *dev) {
+    const struct max7318_config *config = dev->config;
+    struct max7318_drv_data *const drv_data = (struct max7318_drv_data *const)dev->data;
+
+    if (!drv_data->input_cache_valid) {
+        return false;
+    }
+
+    if (config->int_gpio.port) {
+        return gpio_pin_get_dt(&config->int_gpio) == 0;
+    }
+
+#if CONFIG_GPIO_MAX7318_INPUT_CACHE_US > 0
+    return k_uptime_ticks() - drv_data->input_cache_ticks <
+           k_us_to_ticks_ceil64(CONFIG_GPIO_MAX7318_INPUT_CACHE_US);
+#else
+    return false;
+#endif
+}
+
 static int max7318_port_get_raw(const struct device *dev, uint32_t *value) {
     struct max7318_drv_data *const drv_data = (struct max7318_drv_data *const)dev->data;
 
@@ -215,12 +257,23 @@ static int max7318_port_get_raw(const struct device *dev, uint32_t *value) {
 
     k_sem_take(&drv_data->lock, K_FOREVER);
 
+    int ret = 0;
+    if (input_cache_is_current(dev)) {
+        *value = drv_data->reg_cache.input;
+        goto done;
+    }
+
     uint16_t buf = 0;
-    int ret = read_registers(dev, REG_INPUT_PORTA, &buf);
+    ret = read_registers(dev, REG_INPUT_PORTA, &buf);
     if (ret != 0) {
+        drv_data->input_cache_valid = false;
         goto done;
     }
 
+    drv_data->reg_cache.input = buf;
+    drv_data->input_cache_valid = true;
+    drv_data->input_cache_ticks = k_uptime_ticks();
+
     *value = buf;
 
 done:
@@ -246,6 +299,9 @@ static int max7318_port_set_masked_raw(const struct device *dev, uint32_t mask,
         drv_data->reg_cache.output = buf;
     }
 
+    // Outputs such as matrix columns change what the inputs read.
+    drv_data->input_cache_valid = false;
+
     k_sem_give(&drv_data->lock);
     return ret;
 }
@@ -276,6 +332,9 @@ static int max7318_port_toggle_bits(const struct device *dev, uint32_t mask) {
         drv_data->reg_cache.output = buf;
     }
 
+    // Outputs such as matrix columns change what the inputs read.
+    drv_data->input_cache_valid = false;
+
     k_sem_give(&drv_data->lock);
     return ret;
 }
@@ -310,6 +369,19 @@ static int max7318_init(const struct device *dev) {
         return -EINVAL;
     }
 
+    if (config->int_gpio.port) {
+        if (!device_is_ready(config->int_gpio.port)) {
+            LOG_WRN("INT GPIO not ready!");
+            return -EINVAL;
+        }
+
+        int ret = gpio_pin_configure_dt(&config->int_gpio, GPIO_INPUT);
+        if (ret != 0) {
+            LOG_WRN("Unable to configure INT GPIO (%d)", ret);
+            return ret;
+        }
+    }
+
     LOG_INF("device initialised at 0x%x", config->i2c_bus.addr);
 
     k_sem_init(&drv_data->lock, 1, 1);
@@ -324,7 +396,8 @@ static int max7318_init(const struct device *dev) {
 #define MAX7318_INIT(inst)                                                                         \
     static const struct max7318_config max7318_##inst##_config = {                                 \
         .common = {.port_pin_mask = GPIO_PORT_PIN_MASK_FROM_DT_INST(inst)},                        \
-        .i2c_bus = I2C_DT_SPEC_INST_GET(inst)};                                                    \
+        .i2c_bus = I2C_DT_SPEC_INST_GET(inst),                                                     \
+        .int_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, int_gpios, {0})};                               \
                                                                                                    \
     static struct max7318_drv_data max7318_##inst##_drvdata = {                                    \
         /* Default for registers according to datasheet */                                         \
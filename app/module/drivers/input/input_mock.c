@@ -20,12 +20,33 @@ struct input_mock_config {
     bool exit_after;
     const uint32_t *events;
     size_t events_len;
+    uint32_t generator_rate_hz;
+    uint16_t generator_burst_length;
+    uint16_t generator_burst_gap_ms;
+    uint32_t generator_duration_ms;
+};
+
+struct input_mock_generator_stats {
+    // Ticks that came while the previous one was still waiting to be generated.
+    uint32_t missed_ticks;
+    uint32_t generated;
+    // Events input_report() couldn't queue.
+    uint32_t dropped;
+    // Events that reached the input thread's callbacks.
+    uint32_t delivered;
+    int64_t start_ms;
+    k_tid_t input_thread;
+    uint64_t input_thread_start_cycles;
 };
 
 struct input_mock_data {
     size_t event_index;
     struct k_work_delayable work;
     const struct device *dev;
+    struct k_timer generator_timer;
+    struct k_work generator_work;
+    uint16_t burst_ticks;
+    struct input_mock_generator_stats stats;
 };
 
 static void input_mock_work_cb(struct k_work *work) {
@@ -54,6 +75,104 @@ static void input_mock_work_cb(struct k_work *work) {
     k_work_schedule(&data->work, K_MSEC(cfg->event_period));
 }
 
+// In generator mode the events are replayed over and over, one group of events up to and including
+// the next synced one on each tick of a timer running at the generator rate, to benchmark the input
+// pipeline at rates the static replay can't reach.
+
+static k_timeout_t generator_period(const struct input_mock_config *cfg) {
+    return K_USEC(MAX(USEC_PER_SEC / cfg->generator_rate_hz, 1));
+}
+
+static uint64_t input_thread_cycles(k_tid_t thread) {
+#if IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+    k_thread_runtime_stats_t stats;
+
+    if (thread != NULL && k_thread_runtime_stats_get(thread, &stats) == 0) {
+        return stats.execution_cycles;
+    }
+#endif // IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+
+    return 0;
+}
+
+static void input_mock_generator_summary(const struct device *dev) {
+    struct input_mock_data *data = dev->data;
+    const struct input_mock_generator_stats *stats = &data->stats;
+    const uint32_t elapsed_ms = MAX(k_uptime_get() - stats->start_ms, 1);
+
+    LOG_INF("%s generated %u events in %u ms (%u/s), %u dropped, %u ticks missed", dev->name,
+            stats->generated, elapsed_ms,
+            (uint32_t)((uint64_t)stats->generated * 1000 / elapsed_ms), stats->dropped,
+            stats->missed_ticks);
+    LOG_INF("%s delivered %u events (%u/s)", dev->name, stats->delivered,
+            (uint32_t)((uint64_t)stats->delivered * 1000 / elapsed_ms));
+
+#if IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+    if (stats->delivered > 0) {
+        const uint64_t cycles =
+            input_thread_cycles(stats->input_thread) - stats->input_thread_start_cycles;
+
+        LOG_INF("%s input thread spent %u ns per delivered event", dev->name,
+                (uint32_t)(k_cyc_to_ns_floor64(cycles) / stats->delivered));
+    }
+#endif // IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+}
+
+static void input_mock_generator_work_cb(struct k_work *work) {
+    struct input_mock_data *data = CONTAINER_OF(work, struct input_mock_data, generator_work);
+    const struct device *dev = data->dev;
+    const struct input_mock_config *cfg = dev->config;
+
+    if (cfg->generator_duration_ms > 0 &&
+        k_uptime_get() - data->stats.start_ms >= cfg->generator_duration_ms) {
+        k_timer_stop(&data->generator_timer);
+        input_mock_generator_summary(dev);
+
+        if (cfg->exit_after) {
+            exit(0);
+        }
+        return;
+    }
+
+    bool sync = false;
+    while (!sync) {
+        const uint32_t *event = &cfg->events[data->event_index * 4];
+
+        sync = event[3];
+        if (input_report(dev, event[0], event[1], event[2], sync, K_NO_WAIT) < 0) {
+            data->stats.dropped++;
+        } else {
+            data->stats.generated++;
+        }
+
+        data->event_index = (data->event_index + 1) % (cfg->events_len / 4);
+    }
+}
+
+static void input_mock_generator_tick(struct k_timer *timer) {
+    struct input_mock_data *data = CONTAINER_OF(timer, struct input_mock_data, generator_timer);
+    const struct input_mock_config *cfg = data->dev->config;
+
+    if (k_work_submit(&data->generator_work) == 0) {
+        data->stats.missed_ticks++;
+    }
+
+    if (cfg->generator_burst_length > 0 && ++data->burst_ticks == cfg->generator_burst_length) {
+        data->burst_ticks = 0;
+        k_timer_start(timer, K_MSEC(cfg->generator_burst_gap_ms), generator_period(cfg));
+    }
+}
+
+static void __maybe_unused input_mock_generator_delivered(const struct device *dev,
+                                                         struct input_event *evt) {
+    struct input_mock_data *data = dev->data;
+
+    if (data->stats.delivered++ == 0) {
+        data->stats.input_thread = k_current_get();
+        data->stats.input_thread_start_cycles = input_thread_cycles(data->stats.input_thread);
+    }
+}
+
 int input_mock_init(const struct device *dev) {
     struct input_mock_data *drv_data = dev->data;
     const struct input_mock_config *drv_cfg = dev->config;
@@ -61,6 +180,22 @@ int input_mock_init(const struct device *dev) {
     drv_data->dev = dev;
     drv_data->event_index = -1;
 
+    if (drv_cfg->generator_rate_hz > 0) {
+        // Each tick generates events up to the next synced one, so the last one must be synced.
+        if (drv_cfg->events_len < 4 || !drv_cfg->events[drv_cfg->events_len - 1]) {
+            LOG_ERR("%s needs events ending with a synced one to generate", dev->name);
+            return -EINVAL;
+        }
+
+        drv_data->event_index = 0;
+        drv_data->stats.start_ms = k_uptime_get() + drv_cfg->startup_delay;
+        k_work_init(&drv_data->generator_work, input_mock_generator_work_cb);
+        k_timer_init(&drv_data->generator_timer, input_mock_generator_tick, NULL);
+        k_timer_start(&drv_data->generator_timer, K_MSEC(drv_cfg->startup_delay),
+                      generator_period(drv_cfg));
+        return 0;
+    }
+
     k_work_init_delayable(&drv_data->work, input_mock_work_cb);
 
     k_work_schedule(&drv_data->work, K_MSEC(drv_cfg->startup_delay));
@@ -75,10 +210,18 @@ int input_mock_init(const struct device *dev) {
         .events = mock_data_##n,                                                                   \
         .events_len = DT_INST_PROP_LEN(n, events),                                                 \
         .startup_delay = DT_INST_PROP(n, event_startup_delay),                                     \
-        .event_period = DT_INST_PROP(n, event_period),                                             \
+        .event_period = DT_INST_PROP_OR(n, event_period, 0),                                       \
         .exit_after = DT_INST_PROP(n, exit_after),                                                 \
+        .generator_rate_hz = DT_INST_PROP_OR(n, generator_rate_hz, 0),                             \
+        .generator_burst_length = DT_INST_PROP(n, generator_burst_length),                         \
+        .generator_burst_gap_ms = DT_INST_PROP(n, generator_burst_gap_ms),                         \
+        .generator_duration_ms = DT_INST_PROP(n, generator_duration_ms),                           \
     };                                                                                             \
     DEVICE_DT_INST_DEFINE(n, input_mock_init, NULL, &input_mock_data_##n, &input_mock_cfg_##n,     \
-                          POST_KERNEL, CONFIG_INPUT_INIT_PRIORITY, NULL);
+                          POST_KERNEL, CONFIG_INPUT_INIT_PRIORITY, NULL);                          \
+    IF_ENABLED(DT_INST_NODE_HAS_PROP(n, generator_rate_hz),                                        \
+               (static void input_mock_delivered_##n(struct input_event *evt) {                    \
+                   input_mock_generator_delivered(DEVICE_DT_INST_GET(n), evt);                     \
+               } INPUT_CALLBACK_DEFINE(DEVICE_DT_INST_GET(n), input_mock_delivered_##n);))
 
 DT_INST_FOREACH_STATUS_OKAY(INPUT_MOCK_INST)
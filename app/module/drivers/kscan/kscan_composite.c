@@ -6,10 +6,16 @@
 
 #define DT_DRV_COMPAT zmk_kscan_composite
 
+#include <string.h>
+
 #include <zephyr/device.h>
+#include <zephyr/kernel.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/drivers/kscan.h>
 #include <zephyr/logging/log.h>
+
+#include <zmk/kscan_time.h>
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define MATRIX_NODE_ID DT_DRV_INST(0)
@@ -32,10 +38,34 @@ struct kscan_composite_config {
     size_t children_len;
 };
 
+#define USE_ORDERED_EVENTS IS_ENABLED(CONFIG_ZMK_KSCAN_COMPOSITE_ORDERED_EVENTS)
+
+#if USE_ORDERED_EVENTS
+#define ORDERED_EVENTS_QUEUE_SIZE CONFIG_ZMK_KSCAN_COMPOSITE_ORDERED_EVENTS_QUEUE_SIZE
+#define ORDERED_EVENTS_WINDOW_TICKS                                                                \
+    k_ms_to_ticks_ceil64(CONFIG_ZMK_KSCAN_COMPOSITE_ORDERED_EVENTS_WINDOW_MS)
+
+struct kscan_composite_event {
+    /** Uptime in ticks when the child reported the event. */
+    int64_t timestamp;
+    uint32_t row;
+    uint32_t column;
+    bool pressed;
+};
+#endif
+
 struct kscan_composite_data {
     kscan_callback_t callback;
 
     const struct device *dev;
+
+#if USE_ORDERED_EVENTS
+    struct k_spinlock lock;
+    struct k_work_delayable flush_work;
+    /** Pending events, sorted by timestamp. */
+    struct kscan_composite_event events[ORDERED_EVENTS_QUEUE_SIZE];
+    size_t events_len;
+#endif
 };
 
 static int kscan_composite_enable_callback(const struct device *dev) {
@@ -94,6 +124,105 @@ static int kscan_composite_disable_callback(const struct device *dev) {
 
 static const struct device *all_instances[] = {DT_INST_FOREACH_STATUS_OKAY(KSCAN_COMP_INST_DEV)};
 
+#if USE_ORDERED_EVENTS
+
+// Children report from their own work queues, timers or interrupts, so events which happened close
+// together can arrive in any order. Each event is timestamped as it arrives and held for a short
+// window, during which an event from another child with an earlier timestamp still sorts before
+// it. Events are then forwarded oldest first.
+
+static void kscan_composite_forward(const struct device *dev,
+                                    const struct kscan_composite_event *event) {
+    struct kscan_composite_data *data = dev->data;
+
+    const int64_t previous = zmk_kscan_time_begin(event->timestamp);
+    data->callback(dev, event->row, event->column, event->pressed);
+    zmk_kscan_time_end(previous);
+}
+
+static void kscan_composite_flush_work(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct kscan_composite_data *data =
+        CONTAINER_OF(dwork, struct kscan_composite_data, flush_work);
+    const int64_t ready_time = k_uptime_ticks() - ORDERED_EVENTS_WINDOW_TICKS;
+
+    while (true) {
+        struct kscan_composite_event event = {0};
+        int64_t next_time = 0;
+        bool ready = false;
+
+        K_SPINLOCK(&data->lock) {
+            if (data->events_len == 0) {
+                K_SPINLOCK_BREAK;
+            }
+
+            if (data->events[0].timestamp > ready_time) {
+                next_time = data->events[0].timestamp;
+                K_SPINLOCK_BREAK;
+            }
+
+            event = data->events[0];
+            data->events_len--;
+            memmove(&data->events[0], &data->events[1],
+                    data->events_len * sizeof(data->events[0]));
+            ready = true;
+        }
+
+        if (!ready) {
+            if (next_time) {
+                k_work_reschedule(&data->flush_work,
+                                  K_TIMEOUT_ABS_TICKS(next_time + ORDERED_EVENTS_WINDOW_TICKS));
+            }
+            return;
+        }
+
+        kscan_composite_forward(data->dev, &event);
+    }
+}
+
+static void kscan_composite_queue_event(const struct device *dev, uint32_t row, uint32_t column,
+                                        bool pressed) {
+    struct kscan_composite_data *data = dev->data;
+    struct kscan_composite_event event = {
+        .timestamp = zmk_kscan_event_time(),
+        .row = row,
+        .column = column,
+        .pressed = pressed,
+    };
+    struct kscan_composite_event overflow = {0};
+    bool overflowed = false;
+
+    K_SPINLOCK(&data->lock) {
+        if (data->events_len == ORDERED_EVENTS_QUEUE_SIZE) {
+            // Make room by sending the oldest event now.
+            overflow = data->events[0];
+            data->events_len--;
+            memmove(&data->events[0], &data->events[1],
+                    data->events_len * sizeof(data->events[0]));
+            overflowed = true;
+        }
+
+        // Insert after any event with the same timestamp, so each child's own order is kept.
+        size_t i = data->events_len;
+        while (i > 0 && data->events[i - 1].timestamp > event.timestamp) {
+            data->events[i] = data->events[i - 1];
+            i--;
+        }
+
+        data->events[i] = event;
+        data->events_len++;
+    }
+
+    if (overflowed) {
+        LOG_WRN("Composite kscan event queue is full");
+        kscan_composite_forward(dev, &overflow);
+    }
+
+    k_work_schedule(&data->flush_work, K_TICKS(ORDERED_EVENTS_WINDOW_TICKS));
+}
+
+#endif // USE_ORDERED_EVENTS
+
 static void kscan_composite_child_callback(const struct device *child_dev, uint32_t row,
                                            uint32_t column, bool pressed) {
     // TODO: Ideally we can get this passed into our callback!
@@ -101,7 +230,6 @@ static void kscan_composite_child_callback(const struct device *child_dev, uint3
 
         const struct device *dev = all_instances[i];
         const struct kscan_composite_config *cfg = dev->config;
-        struct kscan_composite_data *data = dev->data;
 
         for (int c = 0; c < cfg->children_len; c++) {
             const struct kscan_composite_child_config *child_cfg = &cfg->children[c];
@@ -110,8 +238,15 @@ static void kscan_composite_child_callback(const struct device *child_dev, uint3
                 continue;
             }
 
+#if USE_ORDERED_EVENTS
+            kscan_composite_queue_event(dev, row + child_cfg->row_offset,
+                                        column + child_cfg->column_offset, pressed);
+#else
+            struct kscan_composite_data *data = dev->data;
+
             data->callback(dev, row + child_cfg->row_offset, column + child_cfg->column_offset,
                            pressed);
+#endif
         }
     }
 }
@@ -140,6 +275,10 @@ static int kscan_composite_init(const struct device *dev) {
 
     data->dev = dev;
 
+#if USE_ORDERED_EVENTS
+    k_work_init_delayable(&data->flush_work, kscan_composite_flush_work);
+#endif
+
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     pm_device_init_suspended(dev);
 #endif
@@ -37,6 +37,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     DT_INST_PROP_OR(n, debounce_period, DT_INST_PROP(n, debounce_release_ms))
 #endif
 
+#define INST_DEBOUNCE_ALGORITHM(n) DT_INST_ENUM_IDX(n, debounce_algorithm)
+
 #define KSCAN_GPIO_CFG_INIT(idx, inst_idx)                                                         \
     GPIO_DT_SPEC_GET_BY_IDX(DT_DRV_INST(inst_idx), gpios, idx)
 
@@ -53,6 +55,22 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define KSCAN_INTR_CFG_INIT(inst_idx) GPIO_DT_SPEC_GET(DT_DRV_INST(inst_idx), interrupt_gpios)
 
+/** A GPIO port and the cells on it, which are read together with one port read. */
+struct kscan_charlieplex_port_group {
+    const struct device *port;
+    gpio_port_pins_t pins;
+};
+
+/** Precomputed drive and read parameters for one cell. */
+struct kscan_charlieplex_cell {
+    /** Flags to configure the pin as an input with the pull matching its active level. */
+    gpio_flags_t input_flags;
+    /** Bit of the pin in its port group. */
+    gpio_port_pins_t bit;
+    /** Index of the port group the pin is read from. */
+    uint8_t group;
+};
+
 struct kscan_charlieplex_data {
     const struct device *dev;
     kscan_callback_t callback;
@@ -64,6 +82,18 @@ struct kscan_charlieplex_data {
      * (config->cells.length ^2)
      */
     struct zmk_debounce_state *charlieplex_state;
+    /** Drive schedule, as an array of length config->cells.len. */
+    struct kscan_charlieplex_cell *schedule;
+    /** Array of length config->cells.len, of which port_groups_len are used. */
+    struct kscan_charlieplex_port_group *port_groups;
+    size_t port_groups_len;
+    /** Last value read from each port group, as an array of length config->cells.len. */
+    gpio_port_value_t *port_values;
+    /**
+     * Whether every cell is known to be configured as an input, so a scan does not need to
+     * reconfigure them all first.
+     */
+    bool pins_idle;
 };
 
 struct kscan_gpio_list {
@@ -98,44 +128,30 @@ static int state_index(const struct kscan_charlieplex_config *config, const int
     return (col * config->cells.len) + row;
 }
 
-static int kscan_charlieplex_set_as_input(const struct gpio_dt_spec *gpio) {
-    if (!device_is_ready(gpio->port)) {
-        LOG_ERR("GPIO is not ready: %s", gpio->port->name);
-        return -ENODEV;
-    }
-
+static gpio_flags_t kscan_charlieplex_input_flags(const struct gpio_dt_spec *gpio) {
     gpio_flags_t pull_flag =
         ((gpio->dt_flags & GPIO_ACTIVE_LOW) == GPIO_ACTIVE_LOW) ? GPIO_PULL_UP : GPIO_PULL_DOWN;
 
-    int err = gpio_pin_configure_dt(gpio, GPIO_INPUT | pull_flag);
-    if (err) {
-        LOG_ERR("Unable to configure pin %u on %s for input", gpio->pin, gpio->port->name);
-        return err;
-    }
-    return 0;
+    return GPIO_INPUT | pull_flag;
 }
 
-static int kscan_charlieplex_set_as_output(const struct gpio_dt_spec *gpio) {
+static int kscan_charlieplex_set_as_input(const struct gpio_dt_spec *gpio) {
     if (!device_is_ready(gpio->port)) {
         LOG_ERR("GPIO is not ready: %s", gpio->port->name);
         return -ENODEV;
     }
 
-    int err = gpio_pin_configure_dt(gpio, GPIO_OUTPUT);
+    int err = gpio_pin_configure_dt(gpio, kscan_charlieplex_input_flags(gpio));
     if (err) {
-        LOG_ERR("Unable to configure pin %u on %s for output", gpio->pin, gpio->port->name);
+        LOG_ERR("Unable to configure pin %u on %s for input", gpio->pin, gpio->port->name);
         return err;
     }
-
-    err = gpio_pin_set_dt(gpio, 1);
-    if (err) {
-        LOG_ERR("Failed to set output pin %u active: %i", gpio->pin, err);
-    }
-    return err;
+    return 0;
 }
 
 static int kscan_charlieplex_set_all_as_input(const struct device *dev) {
     const struct kscan_charlieplex_config *config = dev->config;
+    struct kscan_charlieplex_data *data = dev->data;
     int err = 0;
     for (int i = 0; i < config->cells.len; i++) {
         err = kscan_charlieplex_set_as_input(&config->cells.gpios[i]);
@@ -144,11 +160,15 @@ static int kscan_charlieplex_set_all_as_input(const struct device *dev) {
         }
     }
 
+    data->pins_idle = true;
     return 0;
 }
 
 static int kscan_charlieplex_set_all_outputs(const struct device *dev, const int value) {
     const struct kscan_charlieplex_config *config = dev->config;
+    struct kscan_charlieplex_data *data = dev->data;
+
+    data->pins_idle = false;
 
     for (int i = 0; i < config->cells.len; i++) {
         const struct gpio_dt_spec *gpio = &config->cells.gpios[i];
@@ -172,6 +192,9 @@ static int kscan_charlieplex_set_all_outputs(const struct device *dev, const int
 
 static int kscan_charlieplex_disconnect_all(const struct device *dev) {
     const struct kscan_charlieplex_config *config = dev->config;
+    struct kscan_charlieplex_data *data = dev->data;
+
+    data->pins_idle = false;
 
     for (int i = 0; i < config->cells.len; i++) {
         const struct gpio_dt_spec *gpio = &config->cells.gpios[i];
@@ -246,23 +269,55 @@ static void kscan_charlieplex_read_end(const struct device *dev) {
     }
 }
 
+/**
+ * Read every port group which has a cell other than the driven one on it.
+ */
+static int kscan_charlieplex_read_ports(const struct device *dev, const int row) {
+    struct kscan_charlieplex_data *data = dev->data;
+    const struct kscan_charlieplex_cell *driven = &data->schedule[row];
+
+    for (int g = 0; g < data->port_groups_len; g++) {
+        const struct kscan_charlieplex_port_group *group = &data->port_groups[g];
+
+        if (g == driven->group && group->pins == driven->bit) {
+            continue;
+        }
+
+        int err = gpio_port_get(group->port, &data->port_values[g]);
+        if (err) {
+            LOG_ERR("Failed to read port %s: %i", group->port->name, err);
+            return err;
+        }
+    }
+
+    return 0;
+}
+
 static int kscan_charlieplex_read(const struct device *dev) {
     struct kscan_charlieplex_data *data = dev->data;
     const struct kscan_charlieplex_config *config = dev->config;
     bool continue_scan = false;
+    int err;
 
     // NOTE: RR vs MATRIX: set all pins as input, in case there was a failure on a
-    // previous scan, and one of the pins is still set as output
-    int err = kscan_charlieplex_set_all_as_input(dev);
-    if (err) {
-        return err;
+    // previous scan, or interrupts left them all driven.
+    if (!data->pins_idle) {
+        err = kscan_charlieplex_set_all_as_input(dev);
+        if (err) {
+            return err;
+        }
     }
 
+    // Any failure from here on may leave a pin driven.
+    data->pins_idle = false;
+
     // Scan the matrix.
     for (int row = 0; row < config->cells.len; row++) {
         const struct gpio_dt_spec *out_gpio = &config->cells.gpios[row];
-        err = kscan_charlieplex_set_as_output(out_gpio);
+        err = gpio_pin_configure_dt(out_gpio, GPIO_OUTPUT_ACTIVE);
         if (err) {
+            LOG_ERR("Unable to configure pin %u on %s for output", out_gpio->pin,
+                    out_gpio->port->name);
             return err;
         }
 
@@ -270,16 +325,21 @@ static int kscan_charlieplex_read(const struct device *dev) {
         k_busy_wait(CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BEFORE_INPUTS);
 #endif
 
+        err = kscan_charlieplex_read_ports(dev, row);
+        if (err) {
+            return err;
+        }
+
         for (int col = 0; col < config->cells.len; col++) {
             if (col == row) {
                 continue; // pin can't drive itself
             }
-            const struct gpio_dt_spec *in_gpio = &config->cells.gpios[col];
+            const struct kscan_charlieplex_cell *cell = &data->schedule[col];
             const int index = state_index(config, row, col);
 
             struct zmk_debounce_state *state = &data->charlieplex_state[index];
-            zmk_debounce_update(state, gpio_pin_get_dt(in_gpio), config->debounce_scan_period_ms,
-                                &config->debounce_config);
+            zmk_debounce_update(state, (data->port_values[cell->group] & cell->bit) != 0,
+                                config->debounce_scan_period_ms, &config->debounce_config);
 
             // NOTE: RR vs MATRIX: because we don't need an input/output => row/column
             // setup, we can update in the same loop.
@@ -292,8 +352,10 @@ static int kscan_charlieplex_read(const struct device *dev) {
             continue_scan = continue_scan || zmk_debounce_is_active(state);
         }
 
-        err = kscan_charlieplex_set_as_input(out_gpio);
+        err = gpio_pin_configure_dt(out_gpio, data->schedule[row].input_flags);
         if (err) {
+            LOG_ERR("Unable to configure pin %u on %s for input", out_gpio->pin,
+                    out_gpio->port->name);
             return err;
         }
 #if CONFIG_ZMK_KSCAN_CHARLIEPLEX_WAIT_BETWEEN_OUTPUTS > 0
@@ -301,6 +363,8 @@ static int kscan_charlieplex_read(const struct device *dev) {
 #endif
     }
 
+    data->pins_idle = true;
+
     if (continue_scan) {
         // At least one key is pressed or the debouncer has not yet decided if
         // it is pressed. Poll quickly until everything is released.
@@ -409,11 +473,47 @@ static int kscan_charlieplex_pm_action(const struct device *dev, enum pm_device_
 
 #endif // IS_ENABLED(CONFIG_PM_DEVICE)
 
+/**
+ * Precompute the per-cell pin configuration and group the cells by port, so each scan phase
+ * reads each port once instead of reading every pin separately.
+ */
+static void kscan_charlieplex_init_schedule(const struct device *dev) {
+    struct kscan_charlieplex_data *data = dev->data;
+    const struct kscan_charlieplex_config *config = dev->config;
+
+    data->port_groups_len = 0;
+
+    for (int i = 0; i < config->cells.len; i++) {
+        const struct gpio_dt_spec *gpio = &config->cells.gpios[i];
+        struct kscan_charlieplex_cell *cell = &data->schedule[i];
+        int g;
+
+        for (g = 0; g < data->port_groups_len; g++) {
+            if (data->port_groups[g].port == gpio->port) {
+                break;
+            }
+        }
+
+        if (g == data->port_groups_len) {
+            data->port_groups[data->port_groups_len++] =
+                (struct kscan_charlieplex_port_group){.port = gpio->port};
+        }
+
+        data->port_groups[g].pins |= BIT(gpio->pin);
+
+        cell->input_flags = kscan_charlieplex_input_flags(gpio);
+        cell->bit = BIT(gpio->pin);
+        cell->group = g;
+    }
+}
+
 static int kscan_charlieplex_init(const struct device *dev) {
     struct kscan_charlieplex_data *data = dev->data;
 
     data->dev = dev;
 
+    kscan_charlieplex_init_schedule(dev);
+
     k_work_init_delayable(&data->work, kscan_charlieplex_work_handler);
 
 #if IS_ENABLED(CONFIG_PM_DEVICE)
@@ -441,12 +541,22 @@ static const struct kscan_driver_api kscan_charlieplex_api = {
                  "ZMK_KSCAN_DEBOUNCE_PRESS_MS or debounce-press-ms is too large");                 \
     BUILD_ASSERT(INST_DEBOUNCE_RELEASE_MS(n) <= DEBOUNCE_COUNTER_MAX,                              \
                  "ZMK_KSCAN_DEBOUNCE_RELEASE_MS or debounce-release-ms is too large");             \
+    BUILD_ASSERT(INST_DEBOUNCE_ALGORITHM(n) != ZMK_DEBOUNCE_ALGORITHM_EAGER_PRESS ||               \
+                     INST_DEBOUNCE_PRESS_MS(n) + INST_DEBOUNCE_RELEASE_MS(n) <=                    \
+                         DEBOUNCE_COUNTER_MAX,                                                     \
+                 "Eager press debounce-press-ms and debounce-release-ms are too large together");  \
                                                                                                    \
     static struct zmk_debounce_state kscan_charlieplex_state_##n[INST_CHARLIEPLEX_LEN(n)];         \
     static const struct gpio_dt_spec kscan_charlieplex_cells_##n[] = {                             \
         LISTIFY(INST_LEN(n), KSCAN_GPIO_CFG_INIT, (, ), n)};                                       \
+    static struct kscan_charlieplex_cell kscan_charlieplex_schedule_##n[INST_LEN(n)];              \
+    static struct kscan_charlieplex_port_group kscan_charlieplex_port_groups_##n[INST_LEN(n)];     \
+    static gpio_port_value_t kscan_charlieplex_port_values_##n[INST_LEN(n)];                       \
     static struct kscan_charlieplex_data kscan_charlieplex_data_##n = {                            \
         .charlieplex_state = kscan_charlieplex_state_##n,                                          \
+        .schedule = kscan_charlieplex_schedule_##n,                                                \
+        .port_groups = kscan_charlieplex_port_groups_##n,                                          \
+        .port_values = kscan_charlieplex_port_values_##n,                                          \
     };                                                                                             \
                                                                                                    \
     static const struct kscan_charlieplex_config kscan_charlieplex_config_##n = {                  \
@@ -455,6 +565,7 @@ static const struct kscan_driver_api kscan_charlieplex_api = {
             {                                                                                      \
                 .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
                 .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
+                .algorithm = INST_DEBOUNCE_ALGORITHM(n),                                           \
             },                                                                                     \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
         COND_ANY_POLLING((.poll_period_ms = DT_INST_PROP(n, poll_period_ms), ))                    \
@@ -12,6 +12,8 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
+#include "kscan_gpio.h"
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 // Helper macro
@@ -19,6 +21,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 // Define row and col cfg
 #define _KSCAN_GPIO_CFG_INIT(n, prop, idx) GPIO_DT_SPEC_GET_BY_IDX(n, prop, idx),
+#define _KSCAN_GPIO_INPUT_INIT(n, prop, idx) KSCAN_GPIO_GET_BY_IDX(n, prop, idx),
 
 // Check debounce config
 #define CHECK_DEBOUNCE_CFG(n, a, b) COND_CODE_0(DT_INST_PROP(n, debounce_period), a, b)
@@ -29,6 +32,11 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define INST_MATRIX_OUTPUTS(n) PWR_TWO(INST_DEMUX_GPIOS(n))
 #define POLL_INTERVAL(n) DT_INST_PROP(n, polling_interval_msec)
 
+#define CHECK_INPUTS_LEN(n)                                                                        \
+    BUILD_ASSERT(INST_MATRIX_INPUTS(n) <= 32, "Demux kscan supports at most 32 input GPIOs");
+
+DT_INST_FOREACH_STATUS_OKAY(CHECK_INPUTS_LEN)
+
 #define GPIO_INST_INIT(n)                                                                          \
     struct kscan_gpio_irq_callback_##n {                                                           \
         struct CHECK_DEBOUNCE_CFG(n, (k_work), (k_work_delayable)) * work;                         \
@@ -37,19 +45,23 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     };                                                                                             \
                                                                                                    \
     struct kscan_gpio_config_##n {                                                                 \
-        const struct gpio_dt_spec rows[INST_MATRIX_INPUTS(n)];                                     \
+        const struct kscan_gpio rows[INST_MATRIX_INPUTS(n)];                                       \
         const struct gpio_dt_spec cols[INST_DEMUX_GPIOS(n)];                                       \
     };                                                                                             \
                                                                                                    \
     struct kscan_gpio_data_##n {                                                                   \
         kscan_callback_t callback;                                                                 \
         struct k_timer poll_timer;                                                                 \
+        uint32_t poll_period_ms;                                                                   \
         struct CHECK_DEBOUNCE_CFG(n, (k_work), (k_work_delayable)) work;                           \
-        bool matrix_state[INST_MATRIX_INPUTS(n)][INST_MATRIX_OUTPUTS(n)];                          \
+        /* For each output, a bitmap of the inputs it was last read active on */                   \
+        uint32_t matrix_state[INST_MATRIX_OUTPUTS(n)];                                             \
+        /* The output the select lines currently drive */                                          \
+        uint32_t select;                                                                           \
         const struct device *dev;                                                                  \
     };                                                                                             \
     /* IO/GPIO SETUP */                                                                            \
-    static const struct gpio_dt_spec *kscan_gpio_input_specs_##n(const struct device *dev) {       \
+    static const struct kscan_gpio *kscan_gpio_inputs_##n(const struct device *dev) {              \
         const struct kscan_gpio_config_##n *cfg = dev->config;                                     \
         return cfg->rows;                                                                          \
     }                                                                                              \
@@ -65,43 +77,59 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
         k_work_submit(&data->work.work);                                                           \
     }                                                                                              \
                                                                                                    \
+    /* Back the poll timer off while idle, returning to the base interval on activity */           \
+    static void kscan_gpio_poll_backoff_##n(struct kscan_gpio_data_##n *data, bool active) {       \
+        uint32_t period =                                                                          \
+            active ? POLL_INTERVAL(n)                                                              \
+                   : MIN(data->poll_period_ms * 2, CONFIG_ZMK_KSCAN_DEMUX_POLLING_MAX_PERIOD_MS);  \
+        period = MAX(period, POLL_INTERVAL(n));                                                    \
+        if (period != data->poll_period_ms) {                                                      \
+            data->poll_period_ms = period;                                                         \
+            k_timer_start(&data->poll_timer, K_MSEC(period), K_MSEC(period));                      \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
     /* Read the state of the input GPIOs */                                                        \
     /* This is the core matrix_scan func */                                                        \
     static int kscan_gpio_read_##n(const struct device *dev) {                                     \
         bool submit_follow_up_read = false;                                                        \
         struct kscan_gpio_data_##n *data = dev->data;                                              \
-        static bool read_state[INST_MATRIX_INPUTS(n)][INST_MATRIX_OUTPUTS(n)];                     \
-        for (int o = 0; o < INST_MATRIX_OUTPUTS(n); o++) {                                         \
-            /* Iterate over bits and set GPIOs accordingly */                                      \
-            for (uint8_t bit = 0; bit < INST_DEMUX_GPIOS(n); bit++) {                              \
-                uint8_t state = (o & (0b1 << bit)) >> bit;                                         \
+        /* Outputs are driven in Gray code order, so only one select line changes per step. */     \
+        /* The sequence wraps around the same way, so it also continues from the last scan. */     \
+        for (int g = 0; g < INST_MATRIX_OUTPUTS(n); g++) {                                         \
+            const uint32_t o = g ^ (g >> 1);                                                       \
+            for (uint32_t diff = o ^ data->select; diff; diff &= diff - 1) {                       \
+                const uint8_t bit = __builtin_ctz(diff);                                           \
                 const struct gpio_dt_spec *out_spec = &kscan_gpio_output_specs_##n(dev)[bit];      \
-                gpio_pin_set_dt(out_spec, state);                                                  \
+                gpio_pin_set_dt(out_spec, (o >> bit) & 1);                                         \
             }                                                                                      \
+            data->select = o;                                                                      \
             /* Let the col settle before reading the rows */                                       \
             k_usleep(1);                                                                           \
                                                                                                    \
+            /* Inputs sharing a port are read with a single port read */                           \
+            struct kscan_gpio_port_state port_state = {0};                                         \
+            uint32_t inputs = 0;                                                                   \
             for (int i = 0; i < INST_MATRIX_INPUTS(n); i++) {                                      \
-                /* Get the input spec */                                                           \
-                const struct gpio_dt_spec *in_spec = &kscan_gpio_input_specs_##n(dev)[i];          \
-                read_state[i][o] = gpio_pin_get_dt(in_spec) > 0;                                   \
+                const struct kscan_gpio *in_gpio = &kscan_gpio_inputs_##n(dev)[i];                 \
+                WRITE_BIT(inputs, i, kscan_gpio_pin_get(in_gpio, &port_state) > 0);                \
             }                                                                                      \
-        }                                                                                          \
-        for (int r = 0; r < INST_MATRIX_INPUTS(n); r++) {                                          \
-            for (int c = 0; c < INST_MATRIX_OUTPUTS(n); c++) {                                     \
-                bool pressed = read_state[r][c];                                                   \
-                submit_follow_up_read = (submit_follow_up_read || pressed);                        \
-                if (pressed != data->matrix_state[r][c]) {                                         \
-                    LOG_DBG("Sending event at %d,%d state %s", r, c, (pressed ? "on" : "off"));    \
-                    data->matrix_state[r][c] = pressed;                                            \
-                    data->callback(dev, r, c, pressed);                                            \
-                }                                                                                  \
+                                                                                                   \
+            submit_follow_up_read = (submit_follow_up_read || inputs);                             \
+            for (uint32_t changed = inputs ^ data->matrix_state[o]; changed;                       \
+                 changed &= changed - 1) {                                                         \
+                const int r = __builtin_ctz(changed);                                              \
+                const bool pressed = (inputs & BIT(r)) != 0;                                       \
+                LOG_DBG("Sending event at %d,%d state %s", r, o, (pressed ? "on" : "off"));        \
+                data->callback(dev, r, o, pressed);                                                \
             }                                                                                      \
+            data->matrix_state[o] = inputs;                                                        \
         }                                                                                          \
         if (submit_follow_up_read) {                                                               \
             CHECK_DEBOUNCE_CFG(n, ({ k_work_submit(&data->work); }),                               \
                                ({ k_work_reschedule(&data->work, K_MSEC(5)); }))                   \
         }                                                                                          \
+        kscan_gpio_poll_backoff_##n(data, submit_follow_up_read);                                  \
         return 0;                                                                                  \
     }                                                                                              \
                                                                                                    \
@@ -131,6 +159,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
         struct kscan_gpio_data_##n *data = dev->data;                                              \
         /* TODO: we might want a follow up to hook into the sleep state hooks in Zephyr, */        \
         /* and disable this timer when we enter a sleep state */                                   \
+        data->poll_period_ms = POLL_INTERVAL(n);                                                   \
         k_timer_start(&data->poll_timer, K_MSEC(POLL_INTERVAL(n)), K_MSEC(POLL_INTERVAL(n)));      \
         return 0;                                                                                  \
     };                                                                                             \
@@ -150,7 +179,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
         int err;                                                                                   \
         /* configure input devices*/                                                               \
         for (int i = 0; i < INST_MATRIX_INPUTS(n); i++) {                                          \
-            const struct gpio_dt_spec *in_spec = &kscan_gpio_input_specs_##n(dev)[i];              \
+            const struct gpio_dt_spec *in_spec = &kscan_gpio_inputs_##n(dev)[i].spec;              \
             if (!device_is_ready(in_spec->port)) {                                                 \
                 LOG_ERR("Unable to find input GPIO device");                                       \
                 return -EINVAL;                                                                    \
@@ -174,7 +203,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
                 LOG_ERR("Unable to find output GPIO device");                                      \
                 return -EINVAL;                                                                    \
             }                                                                                      \
-            err = gpio_pin_configure_dt(out_spec, GPIO_OUTPUT_ACTIVE);                             \
+            err = gpio_pin_configure_dt(out_spec, GPIO_OUTPUT_INACTIVE);                           \
             if (err) {                                                                             \
                 LOG_ERR("Unable to configure pin %d for output", out_spec->pin);                   \
                 return err;                                                                        \
@@ -198,7 +227,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     };                                                                                             \
                                                                                                    \
     static const struct kscan_gpio_config_##n kscan_gpio_config_##n = {                            \
-        .rows = {DT_FOREACH_PROP_ELEM(DT_DRV_INST(n), input_gpios, _KSCAN_GPIO_CFG_INIT)},         \
+        .rows = {DT_FOREACH_PROP_ELEM(DT_DRV_INST(n), input_gpios, _KSCAN_GPIO_INPUT_INIT)},       \
         .cols = {DT_FOREACH_PROP_ELEM(DT_DRV_INST(n), output_gpios, _KSCAN_GPIO_CFG_INIT)},        \
     };                                                                                             \
                                                                                                    \
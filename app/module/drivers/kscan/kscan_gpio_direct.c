@@ -35,12 +35,20 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     DT_INST_PROP_OR(n, debounce_period, DT_INST_PROP(n, debounce_release_ms))
 #endif
 
-#define USE_POLLING IS_ENABLED(CONFIG_ZMK_KSCAN_DIRECT_POLLING)
-#define USE_INTERRUPTS (!USE_POLLING)
+#define INST_DEBOUNCE_ALGORITHM(n) DT_INST_ENUM_IDX(n, debounce_algorithm)
 
-#define COND_INTERRUPTS(code) COND_CODE_1(CONFIG_ZMK_KSCAN_DIRECT_POLLING, (), code)
+#define USE_POLLING IS_ENABLED(CONFIG_ZMK_KSCAN_DIRECT_POLLING)
+#define USE_IDLE_INTERRUPTS                                                                        \
+    (USE_POLLING && IS_ENABLED(CONFIG_ZMK_KSCAN_DIRECT_POLLING_IDLE_INTERRUPTS))
+#define USE_INTERRUPTS (!USE_POLLING || USE_IDLE_INTERRUPTS)
+#define USE_PORT_PARALLEL IS_ENABLED(CONFIG_ZMK_KSCAN_DIRECT_PORT_PARALLEL)
+
+#define COND_INTERRUPTS(code)                                                                      \
+    COND_CODE_1(CONFIG_ZMK_KSCAN_DIRECT_POLLING,                                                   \
+                (COND_CODE_1(CONFIG_ZMK_KSCAN_DIRECT_POLLING_IDLE_INTERRUPTS, code, ())), code)
 #define COND_POLL_OR_INTERRUPTS(pollcode, intcode)                                                 \
     COND_CODE_1(CONFIG_ZMK_KSCAN_DIRECT_POLLING, pollcode, intcode)
+#define COND_PORT_PARALLEL(code) COND_CODE_1(CONFIG_ZMK_KSCAN_DIRECT_PORT_PARALLEL, code, ())
 
 #define INST_INPUTS_LEN(n)                                                                         \
     COND_CODE_1(DT_INST_NODE_HAS_PROP(n, input_gpios), (DT_INST_PROP_LEN(n, input_gpios)),         \
@@ -56,19 +64,47 @@ struct kscan_direct_irq_callback {
     struct gpio_callback callback;
 };
 
+#if USE_PORT_PARALLEL
+/** A run of inputs, sorted by port, which are all read with one port read. */
+struct kscan_direct_port_group {
+    const struct device *port;
+    gpio_port_pins_t pins;
+    size_t first;
+    size_t len;
+    /** Pins latched as pressed. */
+    gpio_port_pins_t pressed_pins;
+    /** Pins still being debounced. */
+    gpio_port_pins_t settling_pins;
+};
+#endif
+
 struct kscan_direct_data {
     const struct device *dev;
     struct kscan_gpio_list inputs;
     kscan_callback_t callback;
     struct k_work_delayable work;
 #if USE_INTERRUPTS
-    /** Array of length config->inputs.len */
+    /**
+     * Array of length config->inputs.len. With port parallel reads, there is one callback per port
+     * group instead of one per input.
+     */
     struct kscan_direct_irq_callback *irqs;
+#endif
+#if USE_PORT_PARALLEL
+    /** Array of length config->inputs.len, of which port_groups_len are used. */
+    struct kscan_direct_port_group *port_groups;
+    size_t port_groups_len;
 #endif
     /** Timestamp of the current or scheduled scan. */
     int64_t scan_time;
     /** Current state of the inputs as an array of length config->inputs.len */
     struct zmk_debounce_state *pin_state;
+#if USE_IDLE_INTERRUPTS
+    /** Timestamp of the last scan which found a key active. */
+    int64_t last_active_time;
+    /** Set once the inputs have refused to be configured for interrupts. */
+    bool idle_interrupts_failed;
+#endif
 };
 
 struct kscan_direct_config {
@@ -153,19 +189,52 @@ static void kscan_direct_read_continue(const struct device *dev) {
     const struct kscan_direct_config *config = dev->config;
     struct kscan_direct_data *data = dev->data;
 
+#if USE_IDLE_INTERRUPTS
+    data->last_active_time = data->scan_time;
+#endif
+
     data->scan_time += config->debounce_scan_period_ms;
 
     k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
 }
 
+#if USE_IDLE_INTERRUPTS
+static bool kscan_direct_wait_for_interrupt(const struct device *dev) {
+    struct kscan_direct_data *data = dev->data;
+
+    if (data->idle_interrupts_failed ||
+        data->scan_time - data->last_active_time <
+            CONFIG_ZMK_KSCAN_DIRECT_POLLING_IDLE_INTERRUPTS_QUIET_MS) {
+        return false;
+    }
+
+    int err = kscan_direct_interrupt_enable(dev);
+    if (err) {
+        LOG_WRN("Unable to wait for direct interrupts, continuing to poll: %i", err);
+        data->idle_interrupts_failed = true;
+        kscan_direct_interrupt_disable(dev);
+        return false;
+    }
+
+    return true;
+}
+#endif
+
 static void kscan_direct_read_end(const struct device *dev) {
-#if USE_INTERRUPTS
+#if !USE_POLLING
     // Return to waiting for an interrupt.
     kscan_direct_interrupt_enable(dev);
 #else
     struct kscan_direct_data *data = dev->data;
     const struct kscan_direct_config *config = dev->config;
 
+#if USE_IDLE_INTERRUPTS
+    // Once the inputs have been quiet for long enough, stop polling entirely.
+    if (kscan_direct_wait_for_interrupt(dev)) {
+        return;
+    }
+#endif
+
     data->scan_time += config->poll_period_ms;
 
     // Return to polling slowly.
@@ -173,7 +242,103 @@ static void kscan_direct_read_end(const struct device *dev) {
 #endif
 }
 
+static void kscan_direct_report(const struct device *dev, const struct kscan_gpio *gpio,
+                                const bool pressed) {
+    struct kscan_direct_data *data = dev->data;
+    const struct kscan_direct_config *config = dev->config;
+
+    LOG_DBG("Sending event at 0,%i state %s", gpio->index, pressed ? "on" : "off");
+    data->callback(dev, 0, gpio->index, pressed);
+    if (config->toggle_mode && pressed) {
+        kscan_inputs_set_flags(&data->inputs, &gpio->spec);
+    }
+}
+
+#if USE_PORT_PARALLEL
+
+/**
+ * Read the inputs with one read per port. Only inputs which differ from their latched state, or
+ * which are still being debounced, need a debounce update, so the rest of the port is skipped.
+ * Changes are reported as they are found.
+ */
+static int kscan_direct_read_ports(const struct device *dev, bool *continue_scan) {
+    struct kscan_direct_data *data = dev->data;
+    const struct kscan_direct_config *config = dev->config;
+
+    for (int g = 0; g < data->port_groups_len; g++) {
+        struct kscan_direct_port_group *group = &data->port_groups[g];
+
+        gpio_port_value_t value;
+        int err = gpio_port_get(group->port, &value);
+        if (err) {
+            LOG_ERR("Failed to read port %s: %i", group->port->name, err);
+            return err;
+        }
+
+        gpio_port_pins_t pending =
+            ((value ^ group->pressed_pins) & group->pins) | group->settling_pins;
+
+        for (int i = group->first; pending && i < group->first + group->len; i++) {
+            const struct kscan_gpio *gpio = &data->inputs.gpios[i];
+            const gpio_port_pins_t pin = BIT(gpio->spec.pin);
+
+            if (!(pending & pin)) {
+                continue;
+            }
+            pending &= ~pin;
+
+            struct zmk_debounce_state *deb_state = &data->pin_state[gpio->index];
+
+            zmk_debounce_update(deb_state, (value & pin) != 0, config->debounce_scan_period_ms,
+                                &config->debounce_config);
+
+            const bool pressed = zmk_debounce_is_pressed(deb_state);
+            WRITE_BIT(group->pressed_pins, gpio->spec.pin, pressed);
+            WRITE_BIT(group->settling_pins, gpio->spec.pin, deb_state->counter > 0);
+
+            if (zmk_debounce_get_changed(deb_state)) {
+                kscan_direct_report(dev, gpio, pressed);
+            }
+        }
+
+        *continue_scan = *continue_scan || group->pressed_pins != 0 || group->settling_pins != 0;
+    }
+
+    return 0;
+}
+
+static void kscan_direct_init_port_groups(const struct device *dev) {
+    struct kscan_direct_data *data = dev->data;
+
+    data->port_groups_len = 0;
+
+    for (int i = 0; i < data->inputs.len; i++) {
+        const struct gpio_dt_spec *spec = &data->inputs.gpios[i].spec;
+
+        if (data->port_groups_len == 0 ||
+            data->port_groups[data->port_groups_len - 1].port != spec->port) {
+            data->port_groups[data->port_groups_len++] =
+                (struct kscan_direct_port_group){.port = spec->port, .first = i};
+        }
+
+        struct kscan_direct_port_group *group = &data->port_groups[data->port_groups_len - 1];
+
+        group->pins |= BIT(spec->pin);
+        group->len++;
+    }
+}
+
+#endif // USE_PORT_PARALLEL
+
 static int kscan_direct_read(const struct device *dev) {
+    bool continue_scan = false;
+
+#if USE_PORT_PARALLEL
+    int err = kscan_direct_read_ports(dev, &continue_scan);
+    if (err) {
+        return err;
+    }
+#else
     struct kscan_direct_data *data = dev->data;
     const struct kscan_direct_config *config = dev->config;
 
@@ -194,24 +359,17 @@ static int kscan_direct_read(const struct device *dev) {
     }
 
     // Process the new state.
-    bool continue_scan = false;
-
     for (int i = 0; i < data->inputs.len; i++) {
         const struct kscan_gpio *gpio = &data->inputs.gpios[i];
         struct zmk_debounce_state *deb_state = &data->pin_state[gpio->index];
 
         if (zmk_debounce_get_changed(deb_state)) {
-            const bool pressed = zmk_debounce_is_pressed(deb_state);
-
-            LOG_DBG("Sending event at 0,%i state %s", gpio->index, pressed ? "on" : "off");
-            data->callback(dev, 0, gpio->index, pressed);
-            if (config->toggle_mode && pressed) {
-                kscan_inputs_set_flags(&data->inputs, &gpio->spec);
-            }
+            kscan_direct_report(dev, gpio, zmk_debounce_is_pressed(deb_state));
         }
 
         continue_scan = continue_scan || zmk_debounce_is_active(deb_state);
     }
+#endif // USE_PORT_PARALLEL
 
     if (continue_scan) {
         // At least one key is pressed or the debouncer has not yet decided if
@@ -246,6 +404,9 @@ static int kscan_direct_enable(const struct device *dev) {
     struct kscan_direct_data *data = dev->data;
 
     data->scan_time = k_uptime_get();
+#if USE_IDLE_INTERRUPTS
+    data->last_active_time = data->scan_time;
+#endif
 
     // Read will automatically start interrupts/polling once done.
     return kscan_direct_read(dev);
@@ -278,7 +439,7 @@ static int kscan_direct_init_input_inst(const struct device *dev, const struct g
 
     LOG_DBG("Configured pin %u on %s for input", gpio->pin, gpio->port->name);
 
-#if USE_INTERRUPTS
+#if USE_INTERRUPTS && !USE_PORT_PARALLEL
     struct kscan_direct_data *data = dev->data;
     struct kscan_direct_irq_callback *irq = &data->irqs[index];
 
@@ -324,6 +485,22 @@ static int kscan_direct_init_inputs(const struct device *dev) {
         }
     }
 
+#if USE_INTERRUPTS && USE_PORT_PARALLEL
+    // Each port gets a single callback for all of its inputs.
+    for (int g = 0; g < data->port_groups_len; g++) {
+        const struct kscan_direct_port_group *group = &data->port_groups[g];
+        struct kscan_direct_irq_callback *irq = &data->irqs[g];
+
+        irq->dev = dev;
+        gpio_init_callback(&irq->callback, kscan_direct_irq_callback_handler, group->pins);
+        int err = gpio_add_callback(group->port, &irq->callback);
+        if (err) {
+            LOG_ERR("Error adding the callback to the input device: %i", err);
+            return err;
+        }
+    }
+#endif
+
     return 0;
 }
 
@@ -334,6 +511,9 @@ static int kscan_direct_init(const struct device *dev) {
 
     // Sort inputs by port so we can read each port just once per scan.
     kscan_gpio_list_sort_by_port(&data->inputs);
+#if USE_PORT_PARALLEL
+    kscan_direct_init_port_groups(dev);
+#endif
 
     k_work_init_delayable(&data->work, kscan_direct_work_handler);
 
@@ -381,6 +561,10 @@ static const struct kscan_driver_api kscan_direct_api = {
                  "ZMK_KSCAN_DEBOUNCE_PRESS_MS or debounce-press-ms is too large");                 \
     BUILD_ASSERT(INST_DEBOUNCE_RELEASE_MS(n) <= DEBOUNCE_COUNTER_MAX,                              \
                  "ZMK_KSCAN_DEBOUNCE_RELEASE_MS or debounce-release-ms is too large");             \
+    BUILD_ASSERT(INST_DEBOUNCE_ALGORITHM(n) != ZMK_DEBOUNCE_ALGORITHM_EAGER_PRESS ||               \
+                     INST_DEBOUNCE_PRESS_MS(n) + INST_DEBOUNCE_RELEASE_MS(n) <=                    \
+                         DEBOUNCE_COUNTER_MAX,                                                     \
+                 "Eager press debounce-press-ms and debounce-release-ms are too large together");  \
                                                                                                    \
     static struct kscan_gpio kscan_direct_inputs_##n[] = {                                         \
         COND_CODE_1(DT_INST_NODE_HAS_PROP(n, input_gpios),                                         \
@@ -391,17 +575,21 @@ static const struct kscan_driver_api kscan_direct_api = {
                                                                                                    \
     COND_INTERRUPTS(                                                                               \
         (static struct kscan_direct_irq_callback kscan_direct_irqs_##n[INST_INPUTS_LEN(n)];))      \
+    COND_PORT_PARALLEL(                                                                            \
+        (static struct kscan_direct_port_group kscan_direct_port_groups_##n[INST_INPUTS_LEN(n)];)) \
                                                                                                    \
     static struct kscan_direct_data kscan_direct_data_##n = {                                      \
         .inputs = KSCAN_GPIO_LIST(kscan_direct_inputs_##n),                                        \
         .pin_state = kscan_direct_state_##n,                                                       \
-        COND_INTERRUPTS((.irqs = kscan_direct_irqs_##n, ))};                                       \
+        COND_PORT_PARALLEL((.port_groups = kscan_direct_port_groups_##n, ))                        \
+            COND_INTERRUPTS((.irqs = kscan_direct_irqs_##n, ))};                                   \
                                                                                                    \
     static const struct kscan_direct_config kscan_direct_config_##n = {                            \
         .debounce_config =                                                                         \
             {                                                                                      \
                 .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
                 .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
+                .algorithm = INST_DEBOUNCE_ALGORITHM(n),                                           \
             },                                                                                     \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
         .poll_period_ms = DT_INST_PROP(n, poll_period_ms),                                         \
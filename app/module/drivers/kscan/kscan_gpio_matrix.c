@@ -10,6 +10,7 @@
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/kscan.h>
+#include <zephyr/init.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
@@ -17,6 +18,7 @@
 #include <zephyr/sys/util.h>
 
 #include <zmk/debounce.h>
+#include <zmk/kscan_time.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -30,6 +32,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define INST_COLS_LEN(n) DT_INST_PROP_LEN(n, col_gpios)
 #define INST_MATRIX_LEN(n) (INST_ROWS_LEN(n) * INST_COLS_LEN(n))
 #define INST_INPUTS_LEN(n) COND_DIODE_DIR(n, (INST_COLS_LEN(n)), (INST_ROWS_LEN(n)))
+#define INST_OUTPUTS_LEN(n) COND_DIODE_DIR(n, (INST_ROWS_LEN(n)), (INST_COLS_LEN(n)))
 
 #if CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS >= 0
 #define INST_DEBOUNCE_PRESS_MS(n) CONFIG_ZMK_KSCAN_DEBOUNCE_PRESS_MS
@@ -45,13 +48,36 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     DT_INST_PROP_OR(n, debounce_period, DT_INST_PROP(n, debounce_release_ms))
 #endif
 
+#define INST_DEBOUNCE_ALGORITHM(n) DT_INST_ENUM_IDX(n, debounce_algorithm)
+
 #define USE_POLLING IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_POLLING)
-#define USE_INTERRUPTS (!USE_POLLING)
+#define USE_IDLE_INTERRUPTS                                                                        \
+    (USE_POLLING && IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_POLLING_IDLE_INTERRUPTS))
+#define USE_INTERRUPTS (!USE_POLLING || USE_IDLE_INTERRUPTS)
 
-#define COND_INTERRUPTS(code) COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_POLLING, (), code)
+#define COND_INTERRUPTS(code)                                                                      \
+    COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_POLLING,                                                   \
+                (COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_POLLING_IDLE_INTERRUPTS, code, ())), code)
 #define COND_POLL_OR_INTERRUPTS(pollcode, intcode)                                                 \
     COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_POLLING, pollcode, intcode)
 
+#define USE_PORT_PARALLEL IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_PORT_PARALLEL)
+
+#define USE_TIMER_SCAN IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_TIMER)
+#define USE_DEDICATED_THREAD IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_SCAN_DEDICATED_THREAD)
+#define USE_SETTLE_YIELD IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_YIELD_WHILE_SETTLING)
+#define USE_CHAINED_OUTPUTS IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_CHAINED_OUTPUT_WRITES)
+
+#define COND_PORT_PARALLEL(code) COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_PORT_PARALLEL, code, ())
+
+#define USE_BITSLICED_DEBOUNCE IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_BITSLICED_DEBOUNCE)
+
+#define COND_BITSLICED_DEBOUNCE(bitslicedcode, code)                                               \
+    COND_CODE_1(CONFIG_ZMK_KSCAN_MATRIX_BITSLICED_DEBOUNCE, bitslicedcode, code)
+
+/** Number of bitsliced debounce states needed for each output. */
+#define INST_BITSLICED_WORDS(n) DIV_ROUND_UP(INST_INPUTS_LEN(n), ZMK_DEBOUNCE_BITSLICED_LANES)
+
 #define KSCAN_GPIO_ROW_CFG_INIT(idx, inst_idx)                                                     \
     KSCAN_GPIO_GET_BY_IDX(DT_DRV_INST(inst_idx), row_gpios, idx)
 #define KSCAN_GPIO_COL_CFG_INIT(idx, inst_idx)                                                     \
@@ -67,22 +93,74 @@ struct kscan_matrix_irq_callback {
     struct gpio_callback callback;
 };
 
+#if USE_PORT_PARALLEL
+/** A run of inputs, sorted by port, which are all read with one port read. */
+struct kscan_matrix_port_group {
+    const struct device *port;
+    gpio_port_pins_t pins;
+    size_t first;
+    size_t len;
+};
+#endif
+
 struct kscan_matrix_data {
     const struct device *dev;
     struct kscan_gpio_list inputs;
     kscan_callback_t callback;
+#if USE_TIMER_SCAN
+    struct k_timer timer;
+#else
     struct k_work_delayable work;
+#endif
 #if USE_INTERRUPTS
     /** Array of length config->inputs.len */
     struct kscan_matrix_irq_callback *irqs;
 #endif
     /** Timestamp of the current or scheduled scan. */
     int64_t scan_time;
+#if USE_SETTLE_YIELD
+    /** Index of the output being scanned, while a scan is waiting for an output to settle. */
+    size_t scan_output;
+    bool scan_output_active;
+    /** Whether any key read so far in the current scan is active. */
+    bool scan_continue;
+    /** Uptime in ticks when the current scan started. */
+    int64_t scan_start_ticks;
+#endif
+#if USE_POLLING
+    /** Time between polls, which grows while the matrix stays idle. */
+    int32_t poll_period_ms;
+    /** Timestamp of the last scan which found any key active. */
+    int64_t last_active_time;
+#endif
+#if USE_IDLE_INTERRUPTS
+    /** Set if the inputs can't wait for interrupts, so polling should continue. */
+    bool idle_interrupts_failed;
+#endif
+#if USE_BITSLICED_DEBOUNCE
+    /**
+     * Current state of the matrix, with the inputs for each output split into groups of
+     * ZMK_DEBOUNCE_BITSLICED_LANES in sorted input order.
+     */
+    struct zmk_debounce_bitsliced_state *bitsliced_state;
+#else
     /**
      * Current state of the matrix as a flattened 2D array of length
      * (config->rows * config->cols)
      */
     struct zmk_debounce_state *matrix_state;
+#endif
+#if USE_PORT_PARALLEL
+    /** Array of length config->inputs.len, of which port_groups_len are used. */
+    struct kscan_matrix_port_group *port_groups;
+    size_t port_groups_len;
+    /**
+     * Pins latched as pressed and pins still being debounced, with one word per output per port
+     * group. Arrays of length (config->rows * config->cols).
+     */
+    gpio_port_pins_t *pressed_pins;
+    gpio_port_pins_t *settling_pins;
+#endif
 };
 
 struct kscan_matrix_config {
@@ -95,6 +173,8 @@ struct kscan_matrix_config {
     enum kscan_diode_direction diode_direction;
 };
 
+#if !USE_BITSLICED_DEBOUNCE
+
 /**
  * Get the index into a matrix state array from a row and column.
  */
@@ -115,6 +195,47 @@ static int state_index_io(const struct kscan_matrix_config *config, const int in
                : state_index_rc(config, input_idx, output_idx);
 }
 
+#endif // !USE_BITSLICED_DEBOUNCE
+
+#if USE_DEDICATED_THREAD
+
+K_THREAD_STACK_DEFINE(kscan_matrix_work_q_stack, CONFIG_ZMK_KSCAN_MATRIX_SCAN_THREAD_STACK_SIZE);
+
+static struct k_work_q kscan_matrix_work_q;
+
+static int kscan_matrix_work_q_init(void) {
+    static const struct k_work_queue_config queue_config = {.name = "Matrix Scan Work Queue"};
+    k_work_queue_start(&kscan_matrix_work_q, kscan_matrix_work_q_stack,
+                       K_THREAD_STACK_SIZEOF(kscan_matrix_work_q_stack),
+                       CONFIG_ZMK_KSCAN_MATRIX_SCAN_THREAD_PRIORITY, &queue_config);
+    return 0;
+}
+
+SYS_INIT(kscan_matrix_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif // USE_DEDICATED_THREAD
+
+/**
+ * Schedule the next scan, replacing any scan which is already scheduled.
+ */
+static void kscan_matrix_schedule(struct kscan_matrix_data *data, const k_timeout_t timeout) {
+#if USE_TIMER_SCAN
+    k_timer_start(&data->timer, timeout, K_NO_WAIT);
+#elif USE_DEDICATED_THREAD
+    k_work_reschedule_for_queue(&kscan_matrix_work_q, &data->work, timeout);
+#else
+    k_work_reschedule(&data->work, timeout);
+#endif
+}
+
+static void kscan_matrix_cancel(struct kscan_matrix_data *data) {
+#if USE_TIMER_SCAN
+    k_timer_stop(&data->timer);
+#else
+    k_work_cancel_delayable(&data->work);
+#endif
+}
+
 static int kscan_matrix_set_all_outputs(const struct device *dev, const int value) {
     const struct kscan_matrix_config *config = dev->config;
 
@@ -187,7 +308,7 @@ static void kscan_matrix_irq_callback_handler(const struct device *port, struct
 
     data->scan_time = k_uptime_get();
 
-    k_work_reschedule(&data->work, K_NO_WAIT);
+    kscan_matrix_schedule(data, K_NO_WAIT);
 }
 #endif
 
@@ -197,71 +318,263 @@ static void kscan_matrix_read_continue(const struct device *dev) {
 
     data->scan_time += config->debounce_scan_period_ms;
 
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_matrix_schedule(data, K_TIMEOUT_ABS_MS(data->scan_time));
+}
+
+#if USE_POLLING
+static void kscan_matrix_poll_reset(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+
+    data->poll_period_ms = config->poll_period_ms;
+    data->last_active_time = data->scan_time;
 }
+#endif
+
+#if USE_IDLE_INTERRUPTS
+static bool kscan_matrix_wait_for_interrupt(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+
+    if (data->idle_interrupts_failed ||
+        data->scan_time - data->last_active_time <
+            CONFIG_ZMK_KSCAN_MATRIX_POLLING_IDLE_INTERRUPTS_QUIET_MS) {
+        return false;
+    }
+
+    int err = kscan_matrix_interrupt_enable(dev);
+    if (err) {
+        LOG_WRN("Unable to wait for matrix interrupts, continuing to poll: %i", err);
+        data->idle_interrupts_failed = true;
+        kscan_matrix_interrupt_disable(dev);
+        return false;
+    }
+
+    return true;
+}
+#endif
 
 static void kscan_matrix_read_end(const struct device *dev) {
-#if USE_INTERRUPTS
+#if !USE_POLLING
     // Return to waiting for an interrupt.
     kscan_matrix_interrupt_enable(dev);
 #else
     struct kscan_matrix_data *data = dev->data;
-    const struct kscan_matrix_config *config = dev->config;
 
-    data->scan_time += config->poll_period_ms;
+#if USE_IDLE_INTERRUPTS
+    // Once the matrix has been quiet for long enough, stop polling entirely.
+    if (kscan_matrix_wait_for_interrupt(dev)) {
+        return;
+    }
+#endif
+
+    data->scan_time += data->poll_period_ms;
+
+#if CONFIG_ZMK_KSCAN_MATRIX_POLLING_MAX_PERIOD_MS > 0
+    // Back off while nothing is happening.
+    data->poll_period_ms =
+        MAX(MIN(data->poll_period_ms * 2, CONFIG_ZMK_KSCAN_MATRIX_POLLING_MAX_PERIOD_MS),
+            data->poll_period_ms);
+#endif
 
     // Return to polling slowly.
-    k_work_reschedule(&data->work, K_TIMEOUT_ABS_MS(data->scan_time));
+    kscan_matrix_schedule(data, K_TIMEOUT_ABS_MS(data->scan_time));
 #endif
 }
 
-static int kscan_matrix_read(const struct device *dev) {
+#if USE_PORT_PARALLEL || USE_BITSLICED_DEBOUNCE
+
+static void kscan_matrix_report(const struct device *dev, const struct kscan_gpio *in_gpio,
+                                const struct kscan_gpio *out_gpio, const bool pressed) {
+    const struct kscan_matrix_config *config = dev->config;
+    struct kscan_matrix_data *data = dev->data;
+
+    const int row = (config->diode_direction == KSCAN_ROW2COL) ? out_gpio->index : in_gpio->index;
+    const int col = (config->diode_direction == KSCAN_ROW2COL) ? in_gpio->index : out_gpio->index;
+
+    LOG_DBG("Sending event at %i,%i state %s", row, col, pressed ? "on" : "off");
+    data->callback(dev, row, col, pressed);
+}
+
+#endif // USE_PORT_PARALLEL || USE_BITSLICED_DEBOUNCE
+
+#if USE_BITSLICED_DEBOUNCE
+
+/**
+ * Read the inputs for one active output and debounce them up to ZMK_DEBOUNCE_BITSLICED_LANES at a
+ * time. Changes are reported as they are found.
+ */
+static int kscan_matrix_read_bitsliced(const struct device *dev, const int output_idx,
+                                       bool *continue_scan) {
     struct kscan_matrix_data *data = dev->data;
     const struct kscan_matrix_config *config = dev->config;
+    const struct kscan_gpio *out_gpio = &config->outputs.gpios[output_idx];
+    const size_t words = DIV_ROUND_UP(data->inputs.len, ZMK_DEBOUNCE_BITSLICED_LANES);
+    struct kscan_gpio_port_state port_state = {0};
+
+    for (int w = 0; w < words; w++) {
+        const size_t first = w * ZMK_DEBOUNCE_BITSLICED_LANES;
+        const size_t len = MIN(ZMK_DEBOUNCE_BITSLICED_LANES, data->inputs.len - first);
+        uint32_t active = 0;
+
+        for (int lane = 0; lane < len; lane++) {
+            const struct kscan_gpio *in_gpio = &data->inputs.gpios[first + lane];
+
+            const int value = kscan_gpio_pin_get(in_gpio, &port_state);
+            if (value < 0) {
+                LOG_ERR("Failed to read port %s: %i", in_gpio->spec.port->name, value);
+                return value;
+            }
 
-    // Scan the matrix.
-    for (int i = 0; i < config->outputs.len; i++) {
-        const struct kscan_gpio *out_gpio = &config->outputs.gpios[i];
+            WRITE_BIT(active, lane, value);
+        }
+
+        // Unused lanes are never active, so they can safely be updated along with the rest.
+        struct zmk_debounce_bitsliced_state *state = &data->bitsliced_state[output_idx * words + w];
+        zmk_debounce_bitsliced_update(state, active, UINT32_MAX, config->debounce_scan_period_ms,
+                                      &config->debounce_config);
+
+        const uint32_t pressed = zmk_debounce_bitsliced_get_pressed(state);
+        uint32_t changed = zmk_debounce_bitsliced_get_changed(state);
+
+        while (changed) {
+            const int lane = __builtin_ctz(changed);
+            changed &= changed - 1;
+
+            kscan_matrix_report(dev, &data->inputs.gpios[first + lane], out_gpio,
+                                (pressed & BIT(lane)) != 0);
+        }
+
+        *continue_scan = *continue_scan || zmk_debounce_bitsliced_get_active(state) != 0;
+    }
+
+    return 0;
+}
 
-        int err = gpio_pin_set_dt(&out_gpio->spec, 1);
+#endif // USE_BITSLICED_DEBOUNCE
+
+#if USE_PORT_PARALLEL
+
+/**
+ * Read the inputs for one active output with one read per port. Only switches whose input differs
+ * from their latched state, or which are still being debounced, need a debounce update, so the
+ * rest of the port is skipped. Changes are reported as they are found.
+ */
+static int kscan_matrix_read_ports(const struct device *dev, const int output_idx,
+                                   bool *continue_scan) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+    const struct kscan_gpio *out_gpio = &config->outputs.gpios[output_idx];
+
+    for (int g = 0; g < data->port_groups_len; g++) {
+        const struct kscan_matrix_port_group *group = &data->port_groups[g];
+        const size_t word = (output_idx * data->port_groups_len) + g;
+
+        gpio_port_value_t value;
+        int err = gpio_port_get(group->port, &value);
         if (err) {
-            LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
+            LOG_ERR("Failed to read port %s: %i", group->port->name, err);
             return err;
         }
 
-#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS > 0
-        k_busy_wait(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS);
-#endif
-        struct kscan_gpio_port_state state = {0};
+        gpio_port_pins_t pending =
+            ((value ^ data->pressed_pins[word]) & group->pins) | data->settling_pins[word];
 
-        for (int j = 0; j < data->inputs.len; j++) {
+        for (int j = group->first; pending && j < group->first + group->len; j++) {
             const struct kscan_gpio *in_gpio = &data->inputs.gpios[j];
+            const gpio_port_pins_t pin = BIT(in_gpio->spec.pin);
 
-            const int index = state_index_io(config, in_gpio->index, out_gpio->index);
-            const int active = kscan_gpio_pin_get(in_gpio, &state);
-            if (active < 0) {
-                LOG_ERR("Failed to read port %s: %i", in_gpio->spec.port->name, active);
-                return active;
+            if (!(pending & pin)) {
+                continue;
             }
+            pending &= ~pin;
 
-            zmk_debounce_update(&data->matrix_state[index], active, config->debounce_scan_period_ms,
+            const int index = state_index_io(config, in_gpio->index, out_gpio->index);
+            struct zmk_debounce_state *state = &data->matrix_state[index];
+
+            zmk_debounce_update(state, (value & pin) != 0, config->debounce_scan_period_ms,
                                 &config->debounce_config);
+
+            const bool pressed = zmk_debounce_is_pressed(state);
+            WRITE_BIT(data->pressed_pins[word], in_gpio->spec.pin, pressed);
+            WRITE_BIT(data->settling_pins[word], in_gpio->spec.pin, state->counter > 0);
+
+            if (zmk_debounce_get_changed(state)) {
+                kscan_matrix_report(dev, in_gpio, out_gpio, pressed);
+            }
         }
 
-        err = gpio_pin_set_dt(&out_gpio->spec, 0);
-        if (err) {
-            LOG_ERR("Failed to set output %i inactive: %i", out_gpio->index, err);
-            return err;
+        *continue_scan =
+            *continue_scan || data->pressed_pins[word] != 0 || data->settling_pins[word] != 0;
+    }
+
+    return 0;
+}
+
+static void kscan_matrix_init_port_groups(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+
+    data->port_groups_len = 0;
+
+    for (int i = 0; i < data->inputs.len; i++) {
+        const struct gpio_dt_spec *spec = &data->inputs.gpios[i].spec;
+
+        if (data->port_groups_len == 0 ||
+            data->port_groups[data->port_groups_len - 1].port != spec->port) {
+            data->port_groups[data->port_groups_len++] =
+                (struct kscan_matrix_port_group){.port = spec->port, .first = i};
         }
 
-#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS > 0
-        k_busy_wait(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS);
-#endif
+        struct kscan_matrix_port_group *group = &data->port_groups[data->port_groups_len - 1];
+
+        group->pins |= BIT(spec->pin);
+        group->len++;
     }
+}
 
-    // Process the new state.
-    bool continue_scan = false;
+#endif // USE_PORT_PARALLEL
+
+/**
+ * Read and debounce the inputs for one output, which must already be active.
+ */
+static int kscan_matrix_read_inputs(const struct device *dev, const int output_idx,
+                                    bool *continue_scan) {
+#if USE_BITSLICED_DEBOUNCE
+    return kscan_matrix_read_bitsliced(dev, output_idx, continue_scan);
+#elif USE_PORT_PARALLEL
+    return kscan_matrix_read_ports(dev, output_idx, continue_scan);
+#else
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+    const struct kscan_gpio *out_gpio = &config->outputs.gpios[output_idx];
+    struct kscan_gpio_port_state state = {0};
+
+    for (int j = 0; j < data->inputs.len; j++) {
+        const struct kscan_gpio *in_gpio = &data->inputs.gpios[j];
 
+        const int index = state_index_io(config, in_gpio->index, out_gpio->index);
+        const int active = kscan_gpio_pin_get(in_gpio, &state);
+        if (active < 0) {
+            LOG_ERR("Failed to read port %s: %i", in_gpio->spec.port->name, active);
+            return active;
+        }
+
+        zmk_debounce_update(&data->matrix_state[index], active, config->debounce_scan_period_ms,
+                            &config->debounce_config);
+    }
+
+    return 0;
+#endif // USE_BITSLICED_DEBOUNCE / USE_PORT_PARALLEL
+}
+
+/**
+ * Report changes once every output has been read, and schedule the next scan.
+ */
+static void kscan_matrix_read_finish(const struct device *dev, bool continue_scan) {
+#if !USE_PORT_PARALLEL && !USE_BITSLICED_DEBOUNCE
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+
+    // Process the new state.
     for (int r = 0; r < config->rows; r++) {
         for (int c = 0; c < config->cols; c++) {
             const int index = state_index_rc(config, r, c);
@@ -277,8 +590,12 @@ static int kscan_matrix_read(const struct device *dev) {
             continue_scan = continue_scan || zmk_debounce_is_active(state);
         }
     }
+#endif // !USE_PORT_PARALLEL && !USE_BITSLICED_DEBOUNCE
 
     if (continue_scan) {
+#if USE_POLLING
+        kscan_matrix_poll_reset(dev);
+#endif
         // At least one key is pressed or the debouncer has not yet decided if
         // it is pressed. Poll quickly until everything is released.
         kscan_matrix_read_continue(dev);
@@ -286,15 +603,182 @@ static int kscan_matrix_read(const struct device *dev) {
         // All keys are released. Return to normal.
         kscan_matrix_read_end(dev);
     }
+}
+
+/**
+ * Set an output inactive and, if there is one, the next output active. With chained output writes,
+ * both are done with a single port write when the two outputs are on the same port, which halves
+ * the bus transactions per scan on port expanders such as shift registers.
+ *
+ * @returns 1 if the next output was set active, 0 if it was not, or a negative errno.
+ */
+static int kscan_matrix_advance_output(const struct device *dev, const int output_idx) {
+    const struct kscan_matrix_config *config = dev->config;
+    const struct kscan_gpio *out_gpio = &config->outputs.gpios[output_idx];
+
+#if USE_CHAINED_OUTPUTS
+    if (output_idx + 1 < config->outputs.len) {
+        const struct kscan_gpio *next_gpio = &config->outputs.gpios[output_idx + 1];
+
+        if (next_gpio->spec.port == out_gpio->spec.port) {
+            const gpio_port_pins_t next_pin = BIT(next_gpio->spec.pin);
+
+            int err = gpio_port_set_masked(out_gpio->spec.port, BIT(out_gpio->spec.pin) | next_pin,
+                                           next_pin);
+            if (err) {
+                LOG_ERR("Failed to switch from output %i to %i: %i", out_gpio->index,
+                        next_gpio->index, err);
+                return err;
+            }
+
+            return 1;
+        }
+    }
+#endif // USE_CHAINED_OUTPUTS
+
+    int err = gpio_pin_set_dt(&out_gpio->spec, 0);
+    if (err) {
+        LOG_ERR("Failed to set output %i inactive: %i", out_gpio->index, err);
+        return err;
+    }
 
     return 0;
 }
 
+#if USE_SETTLE_YIELD
+
+static void kscan_matrix_read_reset(struct kscan_matrix_data *data) {
+    data->scan_output = 0;
+    data->scan_output_active = false;
+    data->scan_continue = false;
+}
+
+/**
+ * Scan the matrix as a state machine, which gives up the CPU while outputs settle. This is called
+ * to start a scan, and again each time a settling delay ends.
+ */
+static int kscan_matrix_read(const struct device *dev) {
+    struct kscan_matrix_data *data = dev->data;
+    const struct kscan_matrix_config *config = dev->config;
+
+    if (data->scan_output == 0 && !data->scan_output_active) {
+        data->scan_start_ticks = k_uptime_ticks();
+    }
+
+    while (data->scan_output < config->outputs.len) {
+        const struct kscan_gpio *out_gpio = &config->outputs.gpios[data->scan_output];
+        int err;
+
+        if (!data->scan_output_active) {
+            err = gpio_pin_set_dt(&out_gpio->spec, 1);
+            if (err) {
+                LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
+                kscan_matrix_read_reset(data);
+                return err;
+            }
+
+            data->scan_output_active = true;
+
+#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS > 0
+            kscan_matrix_schedule(data, K_USEC(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS));
+            return 0;
+#endif
+        }
+
+        err = kscan_matrix_read_inputs(dev, data->scan_output, &data->scan_continue);
+        if (err) {
+            kscan_matrix_read_reset(data);
+            return err;
+        }
+
+        err = kscan_matrix_advance_output(dev, data->scan_output);
+        if (err < 0) {
+            kscan_matrix_read_reset(data);
+            return err;
+        }
+
+        data->scan_output_active = err > 0;
+        data->scan_output++;
+
+#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS > 0
+        if (data->scan_output < config->outputs.len) {
+            kscan_matrix_schedule(data, K_USEC(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS));
+            return 0;
+        }
+#endif
+    }
+
+    const bool continue_scan = data->scan_continue;
+    kscan_matrix_read_reset(data);
+
+    // Changes are reported after yielding for every output, so report when the scan started.
+    const int64_t previous = zmk_kscan_time_begin(data->scan_start_ticks);
+    kscan_matrix_read_finish(dev, continue_scan);
+    zmk_kscan_time_end(previous);
+
+    return 0;
+}
+
+#else
+
+static int kscan_matrix_read(const struct device *dev) {
+    const struct kscan_matrix_config *config = dev->config;
+    bool continue_scan = false;
+    bool output_active = false;
+
+    // Scan the matrix.
+    for (int i = 0; i < config->outputs.len; i++) {
+        const struct kscan_gpio *out_gpio = &config->outputs.gpios[i];
+        int err;
+
+        if (!output_active) {
+            err = gpio_pin_set_dt(&out_gpio->spec, 1);
+            if (err) {
+                LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
+                return err;
+            }
+        }
+
+#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS > 0
+        k_busy_wait(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS);
+#endif
+
+        err = kscan_matrix_read_inputs(dev, i, &continue_scan);
+        if (err) {
+            return err;
+        }
+
+        err = kscan_matrix_advance_output(dev, i);
+        if (err < 0) {
+            return err;
+        }
+
+        output_active = err > 0;
+
+#if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS > 0
+        k_busy_wait(CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS);
+#endif
+    }
+
+    kscan_matrix_read_finish(dev, continue_scan);
+
+    return 0;
+}
+
+#endif // USE_SETTLE_YIELD
+
+#if USE_TIMER_SCAN
+static void kscan_matrix_timer_handler(struct k_timer *timer) {
+    struct kscan_matrix_data *data = CONTAINER_OF(timer, struct kscan_matrix_data, timer);
+    kscan_matrix_read(data->dev);
+}
+#else
 static void kscan_matrix_work_handler(struct k_work *work) {
     struct k_work_delayable *dwork = k_work_delayable_from_work(work);
     struct kscan_matrix_data *data = CONTAINER_OF(dwork, struct kscan_matrix_data, work);
     kscan_matrix_read(data->dev);
 }
+#endif
 
 static int kscan_matrix_configure(const struct device *dev, const kscan_callback_t callback) {
     struct kscan_matrix_data *data = dev->data;
@@ -312,14 +796,29 @@ static int kscan_matrix_enable(const struct device *dev) {
 
     data->scan_time = k_uptime_get();
 
+#if USE_POLLING
+    kscan_matrix_poll_reset(dev);
+#endif
+
     // Read will automatically start interrupts/polling once done.
     return kscan_matrix_read(dev);
 }
 
 static int kscan_matrix_disable(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
+#if USE_SETTLE_YIELD
+    const struct kscan_matrix_config *config = dev->config;
+#endif
 
-    k_work_cancel_delayable(&data->work);
+    kscan_matrix_cancel(data);
+
+#if USE_SETTLE_YIELD
+    // Abandon any scan which was waiting for an output to settle.
+    if (data->scan_output_active) {
+        gpio_pin_set_dt(&config->outputs.gpios[data->scan_output].spec, 0);
+    }
+    kscan_matrix_read_reset(data);
+#endif
 
 #if USE_INTERRUPTS
     return kscan_matrix_interrupt_disable(dev);
@@ -451,7 +950,15 @@ static int kscan_matrix_init(const struct device *dev) {
     // Sort inputs by port so we can read each port just once per scan.
     kscan_gpio_list_sort_by_port(&data->inputs);
 
+#if USE_PORT_PARALLEL
+    kscan_matrix_init_port_groups(dev);
+#endif
+
+#if USE_TIMER_SCAN
+    k_timer_init(&data->timer, kscan_matrix_timer_handler, NULL);
+#else
     k_work_init_delayable(&data->work, kscan_matrix_work_handler);
+#endif
 
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     pm_device_init_suspended(dev);
@@ -497,6 +1004,13 @@ static const struct kscan_driver_api kscan_matrix_api = {
                  "ZMK_KSCAN_DEBOUNCE_PRESS_MS or debounce-press-ms is too large");                 \
     BUILD_ASSERT(INST_DEBOUNCE_RELEASE_MS(n) <= DEBOUNCE_COUNTER_MAX,                              \
                  "ZMK_KSCAN_DEBOUNCE_RELEASE_MS or debounce-release-ms is too large");             \
+    BUILD_ASSERT(INST_DEBOUNCE_ALGORITHM(n) != ZMK_DEBOUNCE_ALGORITHM_EAGER_PRESS ||               \
+                     INST_DEBOUNCE_PRESS_MS(n) + INST_DEBOUNCE_RELEASE_MS(n) <=                    \
+                         DEBOUNCE_COUNTER_MAX,                                                     \
+                 "Eager press debounce-press-ms and debounce-release-ms are too large together");  \
+    BUILD_ASSERT(!USE_BITSLICED_DEBOUNCE ||                                                        \
+                     INST_DEBOUNCE_ALGORITHM(n) == ZMK_DEBOUNCE_ALGORITHM_INTEGRATOR,              \
+                 "ZMK_KSCAN_MATRIX_BITSLICED_DEBOUNCE only supports the integrator algorithm");    \
                                                                                                    \
     static struct kscan_gpio kscan_matrix_rows_##n[] = {                                           \
         LISTIFY(INST_ROWS_LEN(n), KSCAN_GPIO_ROW_CFG_INIT, (, ), n)};                              \
@@ -504,16 +1018,28 @@ static const struct kscan_driver_api kscan_matrix_api = {
     static struct kscan_gpio kscan_matrix_cols_##n[] = {                                           \
         LISTIFY(INST_COLS_LEN(n), KSCAN_GPIO_COL_CFG_INIT, (, ), n)};                              \
                                                                                                    \
-    static struct zmk_debounce_state kscan_matrix_state_##n[INST_MATRIX_LEN(n)];                   \
+    COND_BITSLICED_DEBOUNCE(                                                                       \
+        (static struct zmk_debounce_bitsliced_state                                                \
+             kscan_matrix_state_##n[INST_OUTPUTS_LEN(n) * INST_BITSLICED_WORDS(n)];),              \
+        (static struct zmk_debounce_state kscan_matrix_state_##n[INST_MATRIX_LEN(n)];))            \
                                                                                                    \
     COND_INTERRUPTS(                                                                               \
         (static struct kscan_matrix_irq_callback kscan_matrix_irqs_##n[INST_INPUTS_LEN(n)];))      \
                                                                                                    \
+    COND_PORT_PARALLEL(                                                                            \
+        (static struct kscan_matrix_port_group kscan_matrix_port_groups_##n[INST_INPUTS_LEN(n)];   \
+         static gpio_port_pins_t kscan_matrix_pressed_pins_##n[INST_MATRIX_LEN(n)];                \
+         static gpio_port_pins_t kscan_matrix_settling_pins_##n[INST_MATRIX_LEN(n)];))             \
+                                                                                                   \
     static struct kscan_matrix_data kscan_matrix_data_##n = {                                      \
         .inputs =                                                                                  \
             KSCAN_GPIO_LIST(COND_DIODE_DIR(n, (kscan_matrix_cols_##n), (kscan_matrix_rows_##n))),  \
-        .matrix_state = kscan_matrix_state_##n,                                                    \
-        COND_INTERRUPTS((.irqs = kscan_matrix_irqs_##n, ))};                                       \
+        COND_BITSLICED_DEBOUNCE((.bitsliced_state = kscan_matrix_state_##n, ),                     \
+                                (.matrix_state = kscan_matrix_state_##n, ))                        \
+        COND_PORT_PARALLEL((.port_groups = kscan_matrix_port_groups_##n,                           \
+                            .pressed_pins = kscan_matrix_pressed_pins_##n,                         \
+                            .settling_pins = kscan_matrix_settling_pins_##n, ))                    \
+            COND_INTERRUPTS((.irqs = kscan_matrix_irqs_##n, ))};                                   \
                                                                                                    \
     static const struct kscan_matrix_config kscan_matrix_config_##n = {                            \
         .rows = ARRAY_SIZE(kscan_matrix_rows_##n),                                                 \
@@ -524,6 +1050,7 @@ static const struct kscan_driver_api kscan_matrix_api = {
             {                                                                                      \
                 .debounce_press_ms = INST_DEBOUNCE_PRESS_MS(n),                                    \
                 .debounce_release_ms = INST_DEBOUNCE_RELEASE_MS(n),                                \
+                .algorithm = INST_DEBOUNCE_ALGORITHM(n),                                           \
             },                                                                                     \
         .debounce_scan_period_ms = DT_INST_PROP(n, debounce_scan_period_ms),                       \
         .poll_period_ms = DT_INST_PROP(n, poll_period_ms),                                         \
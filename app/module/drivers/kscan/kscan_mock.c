@@ -22,8 +22,37 @@ struct kscan_mock_data {
     uint32_t event_index;
     struct k_work_delayable work;
     const struct device *dev;
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_TIMING)
+    uint64_t last_event_ns;
+    uint64_t longest_event_ns;
+#endif
 };
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_TIMING)
+#include <time.h>
+
+// Simulated time does not advance while the CPU is busy, so measure in host time instead. The
+// next mock event only runs once everything queued by the previous one has been processed.
+static void kscan_mock_timing_mark(struct kscan_mock_data *data) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+    if (data->last_event_ns && now - data->last_event_ns > data->longest_event_ns) {
+        data->longest_event_ns = now - data->last_event_ns;
+    }
+    data->last_event_ns = now;
+}
+
+static void kscan_mock_timing_report(const struct kscan_mock_data *data) {
+    printk("kscan_mock: %u events, longest %llu ns\n", data->event_index,
+           (unsigned long long)data->longest_event_ns);
+}
+#else
+static inline void kscan_mock_timing_mark(struct kscan_mock_data *data) {}
+static inline void kscan_mock_timing_report(const struct kscan_mock_data *data) {}
+#endif
+
 static int kscan_mock_disable_callback(const struct device *dev) {
     struct kscan_mock_data *data = dev->data;
 
@@ -65,11 +94,13 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         struct k_work_delayable *d_work = k_work_delayable_from_work(work);                        \
         struct kscan_mock_data *data = CONTAINER_OF(d_work, struct kscan_mock_data, work);         \
         const struct kscan_mock_config_##n *cfg = data->dev->config;                               \
+        kscan_mock_timing_mark(data);                                                              \
         if (data->event_index >= DT_INST_PROP_LEN(n, events)) {                                    \
-            if (cfg->exit_after)                                                                   \
+            if (cfg->exit_after) {                                                                 \
+                kscan_mock_timing_report(data);                                                    \
                 exit(0);                                                                           \
-            else                                                                                   \
-                return;                                                                            \
+            }                                                                                      \
+            return;                                                                                \
         }                                                                                          \
         uint32_t ev = cfg->events[data->event_index];                                              \
         LOG_DBG("ev %u row %d column %d state %d\n", ev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),       \
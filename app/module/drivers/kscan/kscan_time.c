@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zmk/kscan_time.h>
+
+// Zero means no driver has set a time. Since reports only nest by preemption on a single CPU,
+// restoring the previous value at the end of each report keeps this correct without a lock.
+static int64_t event_ticks;
+
+int64_t zmk_kscan_time_begin(int64_t ticks) {
+    const int64_t previous = event_ticks;
+
+    event_ticks = ticks;
+    return previous;
+}
+
+void zmk_kscan_time_end(int64_t previous) { event_ticks = previous; }
+
+int64_t zmk_kscan_event_time(void) { return event_ticks ? event_ticks : k_uptime_ticks(); }
@@ -29,41 +29,46 @@ struct bvd_config {
 };
 
 struct bvd_data {
+    const struct device *dev;
     const struct device *adc;
     struct adc_channel_cfg acc;
     struct adc_sequence as;
     struct battery_value value;
+    // Set while a data ready trigger is registered, which makes sampling asynchronous.
+    sensor_trigger_handler_t handler;
+    struct sensor_trigger trigger;
+    struct k_work_delayable read_work;
 };
 
-static int bvd_sample_fetch(const struct device *dev, enum sensor_channel chan) {
-    struct bvd_data *drv_data = dev->data;
-    const struct bvd_config *drv_cfg = dev->config;
-    struct adc_sequence *as = &drv_data->as;
-
-    // Make sure selected channel is supported
-    if (chan != SENSOR_CHAN_GAUGE_VOLTAGE && chan != SENSOR_CHAN_GAUGE_STATE_OF_CHARGE &&
-        chan != SENSOR_CHAN_ALL) {
-        LOG_DBG("Selected channel is not supported: %d.", chan);
-        return -ENOTSUP;
-    }
-
-    int rc = 0;
+#if DT_INST_NODE_HAS_PROP(0, power_gpios)
+// Time for any capacitance to charge up after the divider is powered.
+#define BVD_SETTLE_TIME K_MSEC(10)
+#else
+#define BVD_SETTLE_TIME K_NO_WAIT
+#endif
 
+static int bvd_power_set(const struct device *dev, int value) {
 #if DT_INST_NODE_HAS_PROP(0, power_gpios)
-    // Enable power before sampling
-    rc = gpio_pin_set_dt(&drv_cfg->power, 1);
+    const struct bvd_config *drv_cfg = dev->config;
 
+    int rc = gpio_pin_set_dt(&drv_cfg->power, value);
     if (rc != 0) {
-        LOG_DBG("Failed to enable ADC power GPIO: %d", rc);
-        return rc;
+        LOG_DBG("Failed to %s ADC power GPIO: %d", value ? "enable" : "disable", rc);
     }
 
-    // wait for any capacitance to charge up
-    k_sleep(K_MSEC(10));
+    return rc;
+#else
+    return 0;
 #endif // DT_INST_NODE_HAS_PROP(0, power_gpios)
+}
+
+// Reads the ADC once the divider has settled, then powers it back off.
+static int bvd_read(const struct device *dev) {
+    struct bvd_data *drv_data = dev->data;
+    const struct bvd_config *drv_cfg = dev->config;
+    struct adc_sequence *as = &drv_data->as;
 
-    // Read ADC
-    rc = adc_read(drv_data->adc, as);
+    int rc = adc_read(drv_data->adc, as);
     as->calibrate = false;
 
     if (rc == 0) {
@@ -83,17 +88,73 @@ static int bvd_sample_fetch(const struct device *dev, enum sensor_channel chan)
         LOG_DBG("Failed to read ADC: %d", rc);
     }
 
+    int rc2 = bvd_power_set(dev, 0);
+
+    return rc != 0 ? rc : rc2;
+}
+
+static void bvd_read_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct bvd_data *drv_data = CONTAINER_OF(dwork, struct bvd_data, read_work);
+
+    if (bvd_read(drv_data->dev) == 0 && drv_data->handler) {
+        drv_data->handler(drv_data->dev, &drv_data->trigger);
+    }
+}
+
+static int bvd_sample_fetch(const struct device *dev, enum sensor_channel chan) {
+    struct bvd_data *drv_data = dev->data;
+
+    // Make sure selected channel is supported
+    if (chan != SENSOR_CHAN_GAUGE_VOLTAGE && chan != SENSOR_CHAN_GAUGE_STATE_OF_CHARGE &&
+        chan != SENSOR_CHAN_ALL) {
+        LOG_DBG("Selected channel is not supported: %d.", chan);
+        return -ENOTSUP;
+    }
+
+    // A sample is already on its way.
+    if (k_work_delayable_is_pending(&drv_data->read_work)) {
+        return 0;
+    }
+
+    // Enable power before sampling
+    int rc = bvd_power_set(dev, 1);
+    if (rc != 0) {
+        return rc;
+    }
+
+    // With a data ready trigger, the caller is told when the sample is ready instead of waiting
+    // for the divider to settle.
+    if (drv_data->handler) {
+        k_work_schedule(&drv_data->read_work, BVD_SETTLE_TIME);
+        return 0;
+    }
+
 #if DT_INST_NODE_HAS_PROP(0, power_gpios)
-    // Disable power GPIO if present
-    int rc2 = gpio_pin_set_dt(&drv_cfg->power, 0);
+    k_sleep(BVD_SETTLE_TIME);
+#endif
+
+    return bvd_read(dev);
+}
+
+static int bvd_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                           sensor_trigger_handler_t handler) {
+    struct bvd_data *drv_data = dev->data;
 
-    if (rc2 != 0) {
-        LOG_DBG("Failed to disable ADC power GPIO: %d", rc2);
-        return rc2;
+    if (trig->type != SENSOR_TRIG_DATA_READY) {
+        return -ENOTSUP;
     }
-#endif // DT_INST_NODE_HAS_PROP(0, power_gpios)
 
-    return rc;
+    if (!handler) {
+        struct k_work_sync sync;
+
+        k_work_cancel_delayable_sync(&drv_data->read_work, &sync);
+    }
+
+    drv_data->trigger = *trig;
+    drv_data->handler = handler;
+
+    return 0;
 }
 
 static int bvd_channel_get(const struct device *dev, enum sensor_channel chan,
@@ -105,6 +166,7 @@ static int bvd_channel_get(const struct device *dev, enum sensor_channel chan,
 static const struct sensor_driver_api bvd_api = {
     .sample_fetch = bvd_sample_fetch,
     .channel_get = bvd_channel_get,
+    .trigger_set = bvd_trigger_set,
 };
 
 static int bvd_init(const struct device *dev) {
@@ -118,6 +180,9 @@ static int bvd_init(const struct device *dev) {
 
     int rc = 0;
 
+    drv_data->dev = dev;
+    k_work_init_delayable(&drv_data->read_work, bvd_read_work_cb);
+
 #if DT_INST_NODE_HAS_PROP(0, power_gpios)
     if (!device_is_ready(drv_cfg->power.port)) {
         LOG_ERR("GPIO port for power control is not ready");
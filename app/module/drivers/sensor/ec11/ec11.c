@@ -34,6 +34,11 @@ static int ec11_sample_fetch(const struct device *dev, enum sensor_channel chan)
 
     __ASSERT_NO_MSG(chan == SENSOR_CHAN_ALL || chan == SENSOR_CHAN_ROTATION);
 
+    // The decoder accumulates steps in hardware, so a fetch just takes its count.
+    if (drv_cfg->qdec) {
+        return sensor_sample_fetch_chan(drv_cfg->qdec, chan);
+    }
+
     val = ec11_get_ab_state(dev);
 
     LOG_DBG("prev: %d, new: %d", drv_data->ab_state, val);
@@ -83,6 +88,10 @@ static int ec11_channel_get(const struct device *dev, enum sensor_channel chan,
         return -ENOTSUP;
     }
 
+    if (drv_cfg->qdec) {
+        return sensor_channel_get(drv_cfg->qdec, chan, val);
+    }
+
     drv_data->pulses = 0;
 
     if (drv_cfg->steps > 0) {
@@ -100,10 +109,25 @@ static int ec11_channel_get(const struct device *dev, enum sensor_channel chan,
     return 0;
 }
 
-static const struct sensor_driver_api ec11_driver_api = {
+static int ec11_api_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                                sensor_trigger_handler_t handler) {
+    const struct ec11_config *drv_cfg = dev->config;
+
+    // The decoder raises the trigger itself once per report period with any steps counted, and
+    // the trigger is passed on as is so the handler still recognizes it.
+    if (drv_cfg->qdec) {
+        return sensor_trigger_set(drv_cfg->qdec, trig, handler);
+    }
+
 #ifdef CONFIG_EC11_TRIGGER
-    .trigger_set = ec11_trigger_set,
+    return ec11_trigger_set(dev, trig, handler);
+#else
+    return -ENOTSUP;
 #endif
+}
+
+static const struct sensor_driver_api ec11_driver_api = {
+    .trigger_set = ec11_api_trigger_set,
     .sample_fetch = ec11_sample_fetch,
     .channel_get = ec11_channel_get,
 };
@@ -112,6 +136,16 @@ int ec11_init(const struct device *dev) {
     struct ec11_data *drv_data = dev->data;
     const struct ec11_config *drv_cfg = dev->config;
 
+    if (drv_cfg->qdec) {
+        if (!device_is_ready(drv_cfg->qdec)) {
+            LOG_ERR("Quadrature decoder device is not ready");
+            return -ENODEV;
+        }
+
+        LOG_DBG("Using quadrature decoder %s", drv_cfg->qdec->name);
+        return 0;
+    }
+
     LOG_DBG("A: %s %d B: %s %d resolution %d", drv_cfg->a.port->name, drv_cfg->a.pin,
             drv_cfg->b.port->name, drv_cfg->b.pin, drv_cfg->resolution);
 
@@ -148,10 +182,15 @@ int ec11_init(const struct device *dev) {
 }
 
 #define EC11_INST(n)                                                                               \
+    BUILD_ASSERT(DT_INST_NODE_HAS_PROP(n, qdec) ||                                                 \
+                     (DT_INST_NODE_HAS_PROP(n, a_gpios) && DT_INST_NODE_HAS_PROP(n, b_gpios)),     \
+                 "EC11 encoders need either a `qdec` or both `a-gpios` and `b-gpios`");            \
     static struct ec11_data ec11_data_##n;                                                         \
     static const struct ec11_config ec11_cfg_##n = {                                               \
-        .a = GPIO_DT_SPEC_INST_GET(n, a_gpios),                                                    \
-        .b = GPIO_DT_SPEC_INST_GET(n, b_gpios),                                                    \
+        .a = GPIO_DT_SPEC_INST_GET_OR(n, a_gpios, {0}),                                            \
+        .b = GPIO_DT_SPEC_INST_GET_OR(n, b_gpios, {0}),                                            \
+        .qdec = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, qdec),                                        \
+                            (DEVICE_DT_GET(DT_INST_PHANDLE(n, qdec))), (NULL)),                    \
         .resolution = DT_INST_PROP_OR(n, resolution, 1),                                           \
         .steps = DT_INST_PROP_OR(n, steps, 0),                                                     \
     };                                                                                             \
@@ -13,6 +13,8 @@
 struct ec11_config {
     const struct gpio_dt_spec a;
     const struct gpio_dt_spec b;
+    /** Quadrature decoder peripheral which decodes A/B in hardware instead of the GPIOs. */
+    const struct device *qdec;
 
     const uint16_t steps;
     const uint8_t resolution;
@@ -20,6 +20,8 @@ struct enc_mock_config {
     bool exit_after;
     const int16_t *events;
     size_t events_len;
+    uint32_t generator_rate_hz;
+    uint32_t generator_duration_ms;
 };
 
 struct enc_mock_data {
@@ -29,6 +31,8 @@ struct enc_mock_data {
     size_t event_index;
     struct k_work_delayable work;
     const struct device *dev;
+    uint32_t generated;
+    int64_t generator_start_ms;
 };
 
 static void enc_mock_work_cb(struct k_work *work) {
@@ -57,10 +61,45 @@ static int enc_mock_trigger_set(const struct device *dev, const struct sensor_tr
     return 0;
 }
 
+// In generator mode the events are replayed over and over at the generator rate, the next one only
+// being scheduled once the previous one has been fetched, so the rate reached shows how fast
+// sensor events are handled.
+static int enc_mock_generate(const struct device *dev) {
+    struct enc_mock_data *drv_data = dev->data;
+    const struct enc_mock_config *drv_cfg = dev->config;
+    const int64_t now = k_uptime_get();
+
+    if (drv_data->generated++ == 0) {
+        drv_data->generator_start_ms = now;
+    }
+
+    drv_data->event_index = (drv_data->event_index + 1) % drv_cfg->events_len;
+
+    const uint32_t elapsed_ms = now - drv_data->generator_start_ms;
+    if (drv_cfg->generator_duration_ms == 0 || elapsed_ms < drv_cfg->generator_duration_ms) {
+        k_work_schedule(&drv_data->work,
+                        K_USEC(MAX(USEC_PER_SEC / drv_cfg->generator_rate_hz, 1)));
+        return 0;
+    }
+
+    LOG_INF("%s generated %u events in %u ms (%u/s)", dev->name, drv_data->generated, elapsed_ms,
+            (uint32_t)((uint64_t)drv_data->generated * 1000 / MAX(elapsed_ms, 1)));
+
+    if (drv_cfg->exit_after) {
+        exit(0);
+    }
+
+    return 0;
+}
+
 static int enc_mock_sample_fetch(const struct device *dev, enum sensor_channel chan) {
     struct enc_mock_data *drv_data = dev->data;
     const struct enc_mock_config *drv_cfg = dev->config;
 
+    if (drv_cfg->generator_rate_hz > 0) {
+        return enc_mock_generate(dev);
+    }
+
     drv_data->event_index++;
 
     if (drv_data->event_index < drv_cfg->events_len - 1) {
@@ -105,8 +144,10 @@ int enc_mock_init(const struct device *dev) {
         .events = mock_data_##n,                                                                   \
         .events_len = DT_INST_PROP_LEN(n, events),                                                 \
         .startup_delay = DT_INST_PROP(n, event_startup_delay),                                     \
-        .event_period = DT_INST_PROP(n, event_period),                                             \
+        .event_period = DT_INST_PROP_OR(n, event_period, 0),                                       \
         .exit_after = DT_INST_PROP(n, exit_after),                                                 \
+        .generator_rate_hz = DT_INST_PROP_OR(n, generator_rate_hz, 0),                             \
+        .generator_duration_ms = DT_INST_PROP(n, generator_duration_ms),                           \
     };                                                                                             \
     DEVICE_DT_INST_DEFINE(n, enc_mock_init, NULL, &enc_mock_data_##n, &enc_mock_cfg_##n,           \
                           POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY, &enc_mock_driver_api);
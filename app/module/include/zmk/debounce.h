@@ -19,11 +19,35 @@ struct zmk_debounce_state {
     uint16_t counter : DEBOUNCE_COUNTER_BITS;
 };
 
+enum zmk_debounce_algorithm {
+    /** A press or release is latched once the input has been stable for its debounce time. */
+    ZMK_DEBOUNCE_ALGORITHM_INTEGRATOR,
+    /**
+     * A press is latched on the first active sample, after which the input is ignored for the press
+     * debounce time. Releases are debounced as with ZMK_DEBOUNCE_ALGORITHM_INTEGRATOR.
+     */
+    ZMK_DEBOUNCE_ALGORITHM_EAGER_PRESS,
+    /**
+     * Presses and releases are both latched on the first sample that differs from the latched
+     * state, after which the input is ignored for the press or release debounce time. Every
+     * direction reversal is reported as soon as the switch makes it.
+     */
+    ZMK_DEBOUNCE_ALGORITHM_RAPID_TRIGGER,
+};
+
 struct zmk_debounce_config {
-    /** Duration a switch must be pressed to latch as pressed. */
+    /**
+     * Duration a switch must be pressed to latch as pressed, or with
+     * ZMK_DEBOUNCE_ALGORITHM_EAGER_PRESS and ZMK_DEBOUNCE_ALGORITHM_RAPID_TRIGGER, the duration to
+     * ignore the switch after a press.
+     */
     uint32_t debounce_press_ms;
-    /** Duration a switch must be released to latch as released. */
+    /**
+     * Duration a switch must be released to latch as released, or with
+     * ZMK_DEBOUNCE_ALGORITHM_RAPID_TRIGGER, the duration to ignore the switch after a release.
+     */
     uint32_t debounce_release_ms;
+    enum zmk_debounce_algorithm algorithm;
 };
 
 /**
@@ -54,3 +78,50 @@ bool zmk_debounce_is_pressed(const struct zmk_debounce_state *state);
  * debounce_update.
  */
 bool zmk_debounce_get_changed(const struct zmk_debounce_state *state);
+
+#if IS_ENABLED(CONFIG_ZMK_DEBOUNCE_BITSLICED)
+
+#define ZMK_DEBOUNCE_BITSLICED_LANES 32
+
+/**
+ * Debounce state for up to 32 switches, with the same behavior as 32 zmk_debounce_state. Bit N of
+ * each word belongs to switch N, and the counters are stored as bit-planes so all switches are
+ * updated together with a few logical operations per counter bit.
+ */
+struct zmk_debounce_bitsliced_state {
+    uint32_t pressed;
+    uint32_t changed;
+    /** counter[B] holds bit B of every switch's counter. */
+    uint32_t counter[DEBOUNCE_COUNTER_BITS];
+};
+
+/**
+ * Debounces up to 32 switches at once. Only ZMK_DEBOUNCE_ALGORITHM_INTEGRATOR is supported.
+ *
+ * @param state The state for the switches to debounce.
+ * @param active Bitmask of the switches which are currently pressed.
+ * @param lanes Bitmask of the switches to update. Other switches are left untouched.
+ * @param elapsed_ms Time elapsed since the previous update in milliseconds.
+ * @param config Debounce settings.
+ */
+void zmk_debounce_bitsliced_update(struct zmk_debounce_bitsliced_state *state, uint32_t active,
+                                   uint32_t lanes, const int elapsed_ms,
+                                   const struct zmk_debounce_config *config);
+
+/**
+ * @returns a bitmask of the switches for which zmk_debounce_is_active() would return true.
+ */
+uint32_t zmk_debounce_bitsliced_get_active(const struct zmk_debounce_bitsliced_state *state);
+
+/**
+ * @returns a bitmask of the switches which are latched as pressed.
+ */
+uint32_t zmk_debounce_bitsliced_get_pressed(const struct zmk_debounce_bitsliced_state *state);
+
+/**
+ * @returns a bitmask of the switches whose pressed state changed in the last update that included
+ * them.
+ */
+uint32_t zmk_debounce_bitsliced_get_changed(const struct zmk_debounce_bitsliced_state *state);
+
+#endif // IS_ENABLED(CONFIG_ZMK_DEBOUNCE_BITSLICED)
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Timestamps for kscan events.
+ *
+ * The kscan callback has no parameter for when an event happened, and some drivers report events
+ * well after they detected them. Such a driver brackets its callback with
+ * zmk_kscan_time_begin() and zmk_kscan_time_end(), and the receiver of the callback reads the
+ * time back with zmk_kscan_event_time(). Brackets nest, so a driver that is preempted by another
+ * driver reporting from an interrupt gets its own time back afterwards.
+ */
+
+/**
+ * @brief Set the time at which the events about to be reported happened.
+ *
+ * @param ticks Uptime in ticks, as returned by k_uptime_ticks().
+ * @returns the previous time, which must be passed to zmk_kscan_time_end().
+ */
+int64_t zmk_kscan_time_begin(int64_t ticks);
+
+/**
+ * @brief Restore the time that was set before the matching zmk_kscan_time_begin().
+ */
+void zmk_kscan_time_end(int64_t previous);
+
+/**
+ * @brief Get the time at which the event currently being reported happened.
+ *
+ * @returns the uptime in ticks set by the reporting driver, or the current uptime if the driver
+ *          did not set one.
+ */
+int64_t zmk_kscan_event_time(void);
@@ -27,8 +27,81 @@ static void decrement_counter(struct zmk_debounce_state *state, const int elapse
     }
 }
 
+// Eager press reuses the counter for both phases of a press. Below debounce_press_ms, it counts the
+// time since the press, during which the input is ignored. From debounce_press_ms up, it is the
+// release integrator, offset by debounce_press_ms so the two phases can't be confused. The sum of
+// the two times must therefore fit in the counter.
+static void eager_press_update(struct zmk_debounce_state *state, const bool active,
+                               const int elapsed_ms, const struct zmk_debounce_config *config) {
+    state->changed = false;
+
+    if (!state->pressed) {
+        if (active) {
+            state->pressed = true;
+            state->counter = 0;
+            state->changed = true;
+        }
+        return;
+    }
+
+    if (state->counter < config->debounce_press_ms) {
+        increment_counter(state, elapsed_ms);
+        if (state->counter > config->debounce_press_ms) {
+            state->counter = config->debounce_press_ms;
+        }
+        return;
+    }
+
+    if (active) {
+        decrement_counter(state, elapsed_ms);
+        if (state->counter < config->debounce_press_ms) {
+            state->counter = config->debounce_press_ms;
+        }
+        return;
+    }
+
+    if (state->counter - config->debounce_press_ms < config->debounce_release_ms) {
+        increment_counter(state, elapsed_ms);
+        return;
+    }
+
+    state->pressed = false;
+    state->counter = 0;
+    state->changed = true;
+}
+
+// Rapid trigger counts down the time left to ignore the input after each change. Once it reaches
+// zero, the first sample that differs from the latched state flips it.
+static void rapid_trigger_update(struct zmk_debounce_state *state, const bool active,
+                                 const int elapsed_ms, const struct zmk_debounce_config *config) {
+    state->changed = false;
+
+    if (state->counter > 0) {
+        decrement_counter(state, elapsed_ms);
+        return;
+    }
+
+    if (active == state->pressed) {
+        return;
+    }
+
+    state->pressed = active;
+    state->counter = active ? config->debounce_press_ms : config->debounce_release_ms;
+    state->changed = true;
+}
+
 void zmk_debounce_update(struct zmk_debounce_state *state, const bool active, const int elapsed_ms,
                          const struct zmk_debounce_config *config) {
+    if (config->algorithm == ZMK_DEBOUNCE_ALGORITHM_EAGER_PRESS) {
+        eager_press_update(state, active, elapsed_ms, config);
+        return;
+    }
+
+    if (config->algorithm == ZMK_DEBOUNCE_ALGORITHM_RAPID_TRIGGER) {
+        rapid_trigger_update(state, active, elapsed_ms, config);
+        return;
+    }
+
     // This uses a variation of the integrator debouncing described at
     // https://www.kennethkuhn.com/electronics/debounce.c
     // Every update where "active" does not match the current state, we increment
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zmk/debounce.h>
+
+// This is the same integrator as zmk_debounce_update(), with the counters of 32 switches stored
+// as bit-planes. Adding, subtracting and comparing against a constant then work on all of them at
+// once, one plane at a time, the same way a ripple-carry adder works on the bits of one number.
+
+/**
+ * @returns a bitmask of the lanes whose counter is less than value.
+ */
+static uint32_t counter_less_than(const struct zmk_debounce_bitsliced_state *state,
+                                  const uint32_t value) {
+    if (value > DEBOUNCE_COUNTER_MAX) {
+        return UINT32_MAX;
+    }
+
+    uint32_t less = 0;
+    uint32_t equal = UINT32_MAX;
+
+    for (int b = DEBOUNCE_COUNTER_BITS - 1; b >= 0; b--) {
+        const uint32_t plane = state->counter[b];
+
+        if (value & BIT(b)) {
+            less |= equal & ~plane;
+            equal &= plane;
+        } else {
+            equal &= ~plane;
+        }
+    }
+
+    return less;
+}
+
+static void counter_set(struct zmk_debounce_bitsliced_state *state, const uint32_t lanes,
+                        const uint32_t value) {
+    for (int b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        state->counter[b] = (value & BIT(b)) ? (state->counter[b] | lanes)
+                                             : (state->counter[b] & ~lanes);
+    }
+}
+
+static void increment_counter(struct zmk_debounce_bitsliced_state *state, const uint32_t lanes,
+                              const int elapsed_ms) {
+    uint32_t carry = 0;
+
+    for (int b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        const uint32_t plane = state->counter[b];
+        const uint32_t add = (elapsed_ms & BIT(b)) ? lanes : 0;
+
+        state->counter[b] = (plane & ~lanes) | ((plane ^ add ^ carry) & lanes);
+        carry = ((plane & add) | (carry & (plane ^ add))) & lanes;
+    }
+
+    // Anything larger than the counter overflowed, so saturate it.
+    if (carry || elapsed_ms > DEBOUNCE_COUNTER_MAX) {
+        counter_set(state, elapsed_ms > DEBOUNCE_COUNTER_MAX ? lanes : carry,
+                    DEBOUNCE_COUNTER_MAX);
+    }
+}
+
+static void decrement_counter(struct zmk_debounce_bitsliced_state *state, const uint32_t lanes,
+                              const int elapsed_ms) {
+    if (elapsed_ms > DEBOUNCE_COUNTER_MAX) {
+        counter_set(state, lanes, 0);
+        return;
+    }
+
+    // Saturating at zero means any lane smaller than the amount just becomes zero.
+    const uint32_t underflow = counter_less_than(state, elapsed_ms) & lanes;
+    const uint32_t subtract_lanes = lanes & ~underflow;
+    uint32_t borrow = 0;
+
+    for (int b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        const uint32_t plane = state->counter[b];
+        const uint32_t sub = (elapsed_ms & BIT(b)) ? subtract_lanes : 0;
+
+        state->counter[b] =
+            (plane & ~subtract_lanes) | ((plane ^ sub ^ borrow) & subtract_lanes);
+        borrow = ((~plane & sub) | (borrow & ~(plane ^ sub))) & subtract_lanes;
+    }
+
+    counter_set(state, underflow, 0);
+}
+
+void zmk_debounce_bitsliced_update(struct zmk_debounce_bitsliced_state *state, uint32_t active,
+                                   uint32_t lanes, const int elapsed_ms,
+                                   const struct zmk_debounce_config *config) {
+    const uint32_t mismatch = (active ^ state->pressed) & lanes;
+    const uint32_t match = ~mismatch & lanes;
+
+    // Switches whose counter is below the threshold for their current state.
+    const uint32_t below = (state->pressed & counter_less_than(state, config->debounce_release_ms)) |
+                           (~state->pressed & counter_less_than(state, config->debounce_press_ms));
+
+    const uint32_t flip = mismatch & ~below;
+
+    if (match) {
+        decrement_counter(state, match, elapsed_ms);
+    }
+
+    if (mismatch & below) {
+        increment_counter(state, mismatch & below, elapsed_ms);
+    }
+
+    if (flip) {
+        state->pressed ^= flip;
+        counter_set(state, flip, 0);
+    }
+
+    state->changed = (state->changed & ~lanes) | flip;
+}
+
+uint32_t zmk_debounce_bitsliced_get_active(const struct zmk_debounce_bitsliced_state *state) {
+    uint32_t active = state->pressed;
+
+    for (int b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        active |= state->counter[b];
+    }
+
+    return active;
+}
+
+uint32_t zmk_debounce_bitsliced_get_pressed(const struct zmk_debounce_bitsliced_state *state) {
+    return state->pressed;
+}
+
+uint32_t zmk_debounce_bitsliced_get_changed(const struct zmk_debounce_bitsliced_state *state) {
+    return state->changed;
+}
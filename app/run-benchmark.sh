@@ -0,0 +1,126 @@
+#!/bin/sh
+
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+##
+# Builds benchmark cases for native_posix_64 and reports the average cost of a key event in each,
+# as one JSON object per line. The cost of booting, measured by the `boot` case, is subtracted.
+#
+# Optional environment variables, paths can be absolute or relative to $(pwd):
+#  ZMK_SRC_DIR:          Path to zmk/app (default is ./)
+#  ZMK_BUILD_DIR:        Path to build directory (default is $ZMK_SRC_DIR/build)
+#  ZMK_EXTRA_MODULES:    Path to at most one module (in addition to any in west.yml)
+#  ZMK_BENCH_VERBOSE:    Be more verbose
+#  ZMK_BENCH_RUNS:       Runs per case, of which the fastest is reported (default is 5)
+#
+# Instruction counts are only reported when `perf` is available, otherwise they are null.
+
+if [ -z "$1" ]; then
+    echo "Usage: ./run-benchmark.sh <path to benchmark case | all>"
+    exit 1
+fi
+
+path="$1"
+bench_dir="${ZMK_SRC_DIR-.}/benchmarks"
+if [ $path = "all" ]; then
+    path="$bench_dir"
+fi
+
+ZMK_BUILD_DIR=${ZMK_BUILD_DIR:-${ZMK_SRC_DIR:-.}/build}
+runs=${ZMK_BENCH_RUNS:-5}
+results=${ZMK_BUILD_DIR}/benchmarks/results.jsonl
+mkdir -p ${ZMK_BUILD_DIR}/benchmarks
+
+# Builds a case and prints "<events> <wall ns> <instructions>" for its fastest run.
+measure() {
+    case_path="$1"
+    case_name=$(realpath $case_path | sed -n -e "s|.*/benchmarks/||p")
+    build_dir=${ZMK_BUILD_DIR}/benchmarks/$case_name
+
+    build_cmd="west build ${ZMK_SRC_DIR:+-s $ZMK_SRC_DIR} -d $build_dir \
+        -b native_posix_64 -p -- -DZMK_CONFIG="$(realpath $case_path)" \
+        -DCONFIG_LOG=n -DCONFIG_ASSERT=n -DCONFIG_DEBUG=n \
+        -DCONFIG_NATIVE_POSIX_SLOWDOWN_TO_REAL_TIME=n \
+        ${ZMK_EXTRA_MODULES:+-DZMK_EXTRA_MODULES="$(realpath ${ZMK_EXTRA_MODULES})"}"
+
+    if [ -z ${ZMK_BENCH_VERBOSE} ]; then
+        $build_cmd >/dev/null 2>&1
+    else
+        $build_cmd >&2
+    fi
+
+    if [ $? -gt 0 ]; then
+        echo "FAILED: $case_name did not build" >&2
+        return 1
+    fi
+
+    # The mock kscan events end up as a single cell array in the final devicetree.
+    events=$(sed -n -e '/compatible = "zmk,kscan-mock"/,/};/{s/.*events = <\(.*\)>;.*/\1/p}' \
+        $build_dir/zephyr/zephyr.dts | wc -w)
+
+    best_ns=
+    best_instructions=null
+    i=0
+    while [ $i -lt $runs ]; do
+        start=$(date +%s%N)
+        if command -v perf >/dev/null 2>&1; then
+            perf stat -x, -e instructions:u -o $build_dir/perf.csv $build_dir/zephyr/zmk.exe \
+                >/dev/null 2>&1
+            instructions=$(awk -F, '$3 ~ /^instructions/ {print $1}' $build_dir/perf.csv)
+        else
+            $build_dir/zephyr/zmk.exe >/dev/null 2>&1
+            instructions=null
+        fi
+        ns=$(($(date +%s%N) - start))
+
+        if [ -z "$best_ns" ] || [ $ns -lt $best_ns ]; then
+            best_ns=$ns
+        fi
+        case "$instructions" in
+        '' | *[!0-9]*) ;;
+        *)
+            if [ $best_instructions = null ] || [ $instructions -lt $best_instructions ]; then
+                best_instructions=$instructions
+            fi
+            ;;
+        esac
+        i=$((i + 1))
+    done
+
+    echo "$events $best_ns $best_instructions"
+}
+
+baseline=$(measure $bench_dir/boot) || exit 1
+set -- $baseline
+boot_ns=$2
+boot_instructions=$3
+
+cases=$(find $path -name native_posix_64.keymap -exec dirname \{\} \; | sort)
+: >$results
+err=0
+
+for case_path in $cases; do
+    case_name=$(realpath $case_path | sed -n -e "s|.*/benchmarks/||p")
+    if [ "$case_name" = "boot" ]; then
+        continue
+    fi
+
+    result=$(measure $case_path)
+    if [ $? -gt 0 ]; then
+        err=1
+        continue
+    fi
+
+    set -- $result
+    echo "$case_name $1 $runs $2 $3" | awk -v boot_ns=$boot_ns -v boot_instructions=$boot_instructions '{
+        per_event_instructions = "null"
+        if ($5 != "null" && boot_instructions != "null" && $2 > 0) {
+            per_event_instructions = sprintf("%d", ($5 - boot_instructions) / $2)
+        }
+        printf "{\"case\": \"%s\", \"events\": %d, \"runs\": %d, \"wall_ns_per_event\": %d, \"instructions_per_event\": %s}\n",
+            $1, $2, $3, $2 > 0 ? ($4 - boot_ns) / $2 : 0, per_event_instructions
+    }' | tee -a $results
+done
+
+exit $err
@@ -0,0 +1,104 @@
+#!/bin/sh
+
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+##
+# Generates keymaps at scale with scripts/stress_keymap.py, builds them for native_posix_64 and
+# reports, as one JSON object per line, their throughput, the longest time taken by one key event
+# and their footprint relative to a minimal keymap.
+#
+# Cases are given as <feature>=<size>, where feature is one of positions, layers, combos or
+# hold-tap. The default is "positions=240 layers=32 combos=256 hold-tap=16".
+#
+# Optional environment variables, paths can be absolute or relative to $(pwd):
+#  ZMK_SRC_DIR:          Path to zmk/app (default is ./)
+#  ZMK_BUILD_DIR:        Path to build directory (default is $ZMK_SRC_DIR/build)
+#  ZMK_EXTRA_MODULES:    Path to at most one module (in addition to any in west.yml)
+#  ZMK_STRESS_VERBOSE:   Be more verbose
+#  ZMK_STRESS_EVENTS:    Approximate number of mock events per case (default is 2000)
+#
+# Footprints are those of the native_posix_64 executable, so only the differences between cases
+# are meaningful, not the sizes themselves.
+
+src_dir=${ZMK_SRC_DIR:-.}
+ZMK_BUILD_DIR=${ZMK_BUILD_DIR:-${src_dir}/build}
+stress_dir=${ZMK_BUILD_DIR}/stress
+results=${stress_dir}/results.jsonl
+events=${ZMK_STRESS_EVENTS:-2000}
+mkdir -p $stress_dir
+
+if [ $# -eq 0 ]; then
+    set -- positions=240 layers=32 combos=256 hold-tap=16
+fi
+
+# Generates, builds and runs a case, printing "<events> <wall ns> <longest ns> <text> <data> <bss>".
+measure() {
+    feature=$1
+    size=$2
+    case_dir=$stress_dir/$feature-$size
+    build_dir=$case_dir/build
+
+    count=$(python3 $src_dir/scripts/stress_keymap.py --events $events $feature $size \
+        $case_dir/config)
+    if [ $? -gt 0 ]; then
+        return 1
+    fi
+
+    build_cmd="west build ${ZMK_SRC_DIR:+-s $ZMK_SRC_DIR} -d $build_dir \
+        -b native_posix_64 -p -- -DZMK_CONFIG="$(realpath $case_dir/config)" \
+        -DCONFIG_LOG=n -DCONFIG_ASSERT=n -DCONFIG_DEBUG=n \
+        -DCONFIG_NATIVE_POSIX_SLOWDOWN_TO_REAL_TIME=n \
+        ${ZMK_EXTRA_MODULES:+-DZMK_EXTRA_MODULES="$(realpath ${ZMK_EXTRA_MODULES})"}"
+
+    if [ -z ${ZMK_STRESS_VERBOSE} ]; then
+        $build_cmd >/dev/null 2>&1
+    else
+        $build_cmd >&2
+    fi
+
+    if [ $? -gt 0 ]; then
+        echo "FAILED: $feature=$size did not build" >&2
+        return 1
+    fi
+
+    start=$(date +%s%N)
+    longest=$($build_dir/zephyr/zmk.exe 2>/dev/null |
+        sed -n -e 's/^kscan_mock: .* longest \([0-9]*\) ns$/\1/p')
+    ns=$(($(date +%s%N) - start))
+
+    footprint=$(size $build_dir/zephyr/zmk.exe | awk 'NR == 2 {print $1, $2, $3}')
+    echo "$count $ns ${longest:-0} $footprint"
+}
+
+baseline=$(measure boot 16) || exit 1
+set -- $baseline "$@"
+boot_ns=$2
+boot_text=$4
+boot_ram=$(($5 + $6))
+shift 6
+
+: >$results
+err=0
+
+for case in "$@"; do
+    feature=${case%%=*}
+    size=${case#*=}
+
+    result=$(measure $feature $size)
+    if [ $? -gt 0 ]; then
+        err=1
+        continue
+    fi
+
+    set -- $result
+    echo "$feature $size $1 $2 $3 $4 $(($5 + $6))" | awk -v boot_ns=$boot_ns \
+        -v boot_text=$boot_text -v boot_ram=$boot_ram '{
+        ns = $4 > boot_ns ? $4 - boot_ns : 1
+        printf "{\"feature\": \"%s\", \"size\": %d, \"events\": %d, ", $1, $2, $3
+        printf "\"events_per_s\": %d, \"longest_event_ns\": %d, ", $3 * 1e9 / ns, $5
+        printf "\"flash_bytes\": %d, \"ram_bytes\": %d}\n", $6 - boot_text, $7 - boot_ram
+    }' | tee -a $results
+done
+
+exit $err
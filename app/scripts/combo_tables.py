@@ -0,0 +1,120 @@
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""Generates the const combo lookup tables of combo.c from the devicetree of a build."""
+
+import argparse
+import pickle
+import sys
+from pathlib import Path
+
+# Must match the LISTIFY limit of the combos array in combo.c. Combos with more keys than this
+# are left out of that array, and so get no bit here either.
+MAX_KEYS_PER_COMBO = 20
+
+
+def combo_order(combos_node):
+    # combo.c lists combos by key position count first, then in devicetree order, and each combo's
+    # bit in the masks is its index in that list.
+    children = list(combos_node.children.values())
+    return [
+        child
+        for length in range(MAX_KEYS_PER_COMBO)
+        for child in children
+        if len(child.props["key-positions"].val) == length
+    ]
+
+
+def layer_count(edt, all_layers):
+    keymaps = edt.compat2okay.get("zmk,keymap", [])
+    if not keymaps:
+        return 0
+
+    layers = keymaps[0].children.values()
+    return len([layer for layer in layers if all_layers or layer.status == "okay"])
+
+
+def prop_val(node, name, default):
+    prop = node.props.get(name)
+    return prop.val if prop is not None else default
+
+
+def mask_words(bits, words):
+    mask = [0] * words
+    for bit in bits:
+        mask[bit // 32] |= 1 << (bit % 32)
+    return "{" + ", ".join(f"0x{word:08x}" for word in mask) + "}"
+
+
+def rows(masks, words):
+    return " ".join(f"[{key}] = {mask_words(bits, words)}," for key, bits in sorted(masks.items()))
+
+
+def generate(edt, all_layers):
+    lines = [
+        "/* Generated by scripts/combo_tables.py from the devicetree, do not edit. */",
+        "",
+        "#pragma once",
+        "",
+    ]
+
+    combos_nodes = edt.compat2okay.get("zmk,combos", [])
+    if not combos_nodes:
+        return "\n".join(lines + ["#define ZMK_COMBO_TABLES_COMBOS_LEN 0", ""])
+
+    combos_node = combos_nodes[0]
+    combos = combo_order(combos_node)
+    words = max(1, -(-len(combos_node.children) // 32))
+    layers = layer_count(edt, all_layers)
+
+    position_masks = {}
+    layer_masks = {}
+    prior_idle = []
+    for index, combo in enumerate(combos):
+        for position in combo.props["key-positions"].val:
+            position_masks.setdefault(position, []).append(index)
+
+        combo_layers = prop_val(combo, "layers", [])
+        for layer in range(layers):
+            if not combo_layers or (layer < 32 and layer in combo_layers):
+                layer_masks.setdefault(layer, []).append(index)
+
+        if prop_val(combo, "require-prior-idle-ms", -1) > 0:
+            prior_idle.append(index)
+
+    lines += [
+        f"#define ZMK_COMBO_TABLES_COMBOS_LEN {len(combos)}",
+        f"#define ZMK_COMBO_TABLES_LAYERS_LEN {layers}",
+        "",
+        f"#define ZMK_COMBO_TABLES_POSITION_ROWS {rows(position_masks, words)}",
+        "",
+        f"#define ZMK_COMBO_TABLES_LAYER_ROWS {rows(layer_masks, words)}",
+        "",
+        f"#define ZMK_COMBO_TABLES_PRIOR_IDLE_MASK {mask_words(prior_idle, words)}",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("edt_pickle", type=Path, help="edt.pickle of the build")
+    parser.add_argument("output", type=Path, help="header to write")
+    parser.add_argument("--zephyr-base", type=Path, required=True,
+                        help="Zephyr tree, to load the devicetree library the pickle was made with")
+    parser.add_argument("--all-layers", action="store_true",
+                        help="count disabled layers as well, as the keymap does with ZMK Studio")
+    args = parser.parse_args()
+
+    sys.path.insert(0, str(args.zephyr_base / "scripts" / "dts" / "python-devicetree" / "src"))
+    with args.edt_pickle.open("rb") as f:
+        edt = pickle.load(f)
+
+    header = generate(edt, args.all_layers)
+    # Only touch the header when it changes, so an unrelated reconfigure doesn't rebuild combo.c.
+    if not args.output.exists() or args.output.read_text() != header:
+        args.output.parent.mkdir(parents=True, exist_ok=True)
+        args.output.write_text(header)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,216 @@
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""Attributes the RAM and flash of a ZMK build to its subsystems, from the linker map."""
+
+import argparse
+import json
+import re
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+# The first pattern matching an object file name in the app library picks its subsystem. Those
+# matching none of them are counted as "core". Object files only keep the base name of their
+# source, so src/display/main.c counts as core along with src/main.c.
+APP_SUBSYSTEMS = [
+    (r"^behavior_hold_tap\.", "hold-tap"),
+    (r"^behavior_", "behaviors"),
+    (r"^combo\.", "combos"),
+    (r"^(keymap|conditional_layer|matrix_transform|physical_layouts)\.", "keymap"),
+    (r"^(central|central_reorder|central_bas_proxy|peripheral|service|wired)\.", "split"),
+    (r"^(ble|ble_conn_params|hog)\.", "bluetooth"),
+    (r"^(usb|usb_hid)\.", "usb"),
+    (r"^(hid|hid_listener|hid_indicators|hid_gaming|endpoints)\.", "hid"),
+    (r"^(rgb_underglow|rgb_per_key|backlight)\.", "lighting"),
+    (r"^(status_screen|glyph_label|theme|.*_status)\.", "display"),
+    (r"^(studio|rpc|core|core_subsystem|.*_subsystem|msg_framing|.*_rpc_transport)\.", "studio"),
+    (r"^(input_|mouse|pointing|resolution_multipliers)", "pointing"),
+    (r"^(battery|ext_power_generic|pm|activity|gpio_key_wakeup_trigger)\.", "power"),
+    (r"^(event_manager|.*_changed|.*_event|.*_pressed)\.", "events"),
+    (r"^kscan", "kscan"),
+]
+
+# Libraries outside the app, by their archive name.
+LIBRARY_SUBSYSTEMS = [
+    (r"^libsubsys__bluetooth", "zephyr-bluetooth"),
+    (r"^libsubsys__usb", "zephyr-usb"),
+    (r"lvgl", "lvgl"),
+    (r"^libkernel", "zephyr-kernel"),
+    (r"^libdrivers__", "zephyr-drivers"),
+    (r"^libzephyr", "zephyr"),
+    (r"^lib(subsys|lib|arch|soc)__", "zephyr-other"),
+    (r"^libmodules__", "modules"),
+]
+
+ZMK_EXCLUDED = ("lvgl", "modules", "other")
+
+MEMORY_REGION = re.compile(r"^(?P<name>\S+)\s+0x(?P<origin>[0-9a-f]+)\s+0x(?P<length>[0-9a-f]+)"
+                           r"(?:\s+(?P<attrs>\S+))?$")
+# Output sections start in the first column, input sections in the second. Either may have its
+# name alone on a line when it is too long, with the rest on the next line.
+OUTPUT_SECTION = re.compile(
+    r"^(?P<name>\S+)?\s+0x(?P<addr>[0-9a-f]+)\s+0x(?P<size>[0-9a-f]+)"
+    r"(?:\s+load address 0x(?P<load>[0-9a-f]+))?$"
+)
+INPUT_SECTION = re.compile(
+    r"^ (?P<name>\S+)?\s+0x(?P<addr>[0-9a-f]+)\s+0x(?P<size>[0-9a-f]+)\s+(?P<obj>\S+)$"
+)
+OBJECT = re.compile(r"(?P<lib>[^/()]+\.a)\((?P<obj>[^)]+)\)$|(?P<file>[^/]+)$")
+
+
+class Regions:
+    def __init__(self):
+        self.regions = []
+
+    def add(self, origin, length, attrs):
+        self.regions.append((origin, origin + length, "ram" if "w" in attrs else "flash"))
+
+    def kind(self, addr):
+        for start, end, kind in self.regions:
+            if start <= addr < end:
+                return kind
+        return None
+
+
+def subsystem_for(obj):
+    match = OBJECT.search(obj)
+    if not match:
+        return "other"
+
+    lib = match.group("lib")
+    name = match.group("obj") or match.group("file")
+
+    if lib == "libapp.a":
+        for pattern, subsystem in APP_SUBSYSTEMS:
+            if re.search(pattern, name):
+                return subsystem
+        return "core"
+
+    for pattern, subsystem in LIBRARY_SUBSYSTEMS:
+        if lib and re.search(pattern, lib):
+            return subsystem
+
+    return "other"
+
+
+def symbol_for(section):
+    """With -ffunction-sections and -fdata-sections, the symbol ends the section name."""
+    return section.rsplit(".", 1)[-1] if section.count(".") > 1 else section
+
+
+def parse_map(path):
+    totals = defaultdict(lambda: {"ram": 0, "flash": 0})
+    symbols = defaultdict(list)
+    regions = Regions()
+    output_kinds = ()
+    pending_output = pending_input = None
+    part = None
+
+    for line in Path(path).read_text(errors="replace").splitlines():
+        if line.startswith("Memory Configuration"):
+            part = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            part = "map"
+            continue
+
+        if part == "memory":
+            match = MEMORY_REGION.match(line)
+            if match and match.group("name") != "*default*" and match.group("attrs"):
+                regions.add(int(match.group("origin"), 16), int(match.group("length"), 16),
+                            match.group("attrs"))
+            continue
+
+        if part != "map" or not line.strip():
+            continue
+
+        if not line.startswith(" ") or pending_output:
+            match = OUTPUT_SECTION.match(line)
+            if match and (match.group("name") or pending_output):
+                kinds = {regions.kind(int(match.group("addr"), 16))}
+                if match.group("load"):
+                    kinds.add(regions.kind(int(match.group("load"), 16)))
+                output_kinds = tuple(kind for kind in kinds if kind)
+                pending_output = None
+                continue
+            pending_output = line if re.match(r"^\S+$", line) else None
+            if pending_output:
+                continue
+
+        match = INPUT_SECTION.match(line)
+        if match:
+            name = match.group("name") or pending_input
+            pending_input = None
+            size = int(match.group("size"), 16)
+            if name is None or size == 0:
+                continue
+
+            subsystem = subsystem_for(match.group("obj"))
+            for kind in output_kinds:
+                totals[subsystem][kind] += size
+            if "ram" in output_kinds:
+                symbols[subsystem].append((size, symbol_for(name)))
+            continue
+
+        pending_input = line[1:] if re.match(r"^ \S+$", line) else None
+
+    return totals, symbols
+
+
+def parse_budgets(spec):
+    budgets = {}
+    for item in spec.split():
+        subsystem, _, size = item.partition("=")
+        try:
+            budgets[subsystem] = int(size, 0)
+        except ValueError:
+            sys.exit(f"Invalid footprint budget '{item}', expected <subsystem>=<bytes>")
+    return budgets
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("map", type=Path, help="Linker map, such as build/zephyr/zephyr.map")
+    parser.add_argument("--json", type=Path, help="Also write the totals to this file")
+    parser.add_argument("--top", type=int, default=3, help="Number of largest RAM users to list")
+    parser.add_argument("--ram-budgets", default="", help='RAM budgets, like "combos=2048"')
+    parser.add_argument("--zmk-ram-budget", type=int, default=0, help="RAM budget of ZMK")
+    parser.add_argument("--zmk-flash-budget", type=int, default=0, help="Flash budget of ZMK")
+    args = parser.parse_args()
+
+    totals, symbols = parse_map(args.map)
+    zmk = [s for s in totals if not s.startswith("zephyr") and s not in ZMK_EXCLUDED]
+
+    print(f"{'subsystem':<18} {'RAM':>8} {'flash':>8}  largest RAM users")
+    for subsystem in sorted(totals, key=lambda s: (-totals[s]["ram"], -totals[s]["flash"])):
+        largest = sorted(symbols[subsystem], reverse=True)[: args.top]
+        users = ", ".join(f"{name} ({size})" for size, name in largest)
+        ram, flash = totals[subsystem]["ram"], totals[subsystem]["flash"]
+        print(f"{subsystem:<18} {ram:>8} {flash:>8}  {users}")
+
+    zmk_ram = sum(totals[s]["ram"] for s in zmk)
+    zmk_flash = sum(totals[s]["flash"] for s in zmk)
+    print(f"{'ZMK total':<18} {zmk_ram:>8} {zmk_flash:>8}")
+
+    if args.json:
+        args.json.write_text(json.dumps(totals, indent=2, sort_keys=True) + "\n")
+
+    errors = []
+    for subsystem, budget in parse_budgets(args.ram_budgets).items():
+        ram = totals[subsystem]["ram"] if subsystem in totals else 0
+        if ram > budget:
+            errors.append(f"{subsystem} uses {ram} bytes of RAM, over its budget of {budget}")
+    if args.zmk_ram_budget and zmk_ram > args.zmk_ram_budget:
+        errors.append(f"ZMK uses {zmk_ram} bytes of RAM, over its budget of {args.zmk_ram_budget}")
+    if args.zmk_flash_budget and zmk_flash > args.zmk_flash_budget:
+        errors.append(
+            f"ZMK uses {zmk_flash} bytes of flash, over its budget of {args.zmk_flash_budget}"
+        )
+
+    for error in errors:
+        print(f"error: {error}", file=sys.stderr)
+    sys.exit(1 if errors else 0)
+
+
+if __name__ == "__main__":
+    main()
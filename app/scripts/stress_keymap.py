@@ -0,0 +1,220 @@
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""Generates native_posix_64 keymaps and mock kscan event streams that exercise ZMK at scale."""
+
+import argparse
+import math
+from pathlib import Path
+
+COLUMNS = 16
+KEYS = [chr(c) for c in range(ord("A"), ord("Z") + 1)]
+TAP_MS = 10
+
+
+def press(pos, msec=TAP_MS):
+    return f"ZMK_MOCK_PRESS({pos // COLUMNS}, {pos % COLUMNS}, {msec})"
+
+
+def release(pos, msec=TAP_MS):
+    return f"ZMK_MOCK_RELEASE({pos // COLUMNS}, {pos % COLUMNS}, {msec})"
+
+
+def tap(pos, msec=TAP_MS):
+    return [press(pos, msec), release(pos, msec)]
+
+
+def plain_bindings(positions):
+    return [f"&kp {KEYS[i % len(KEYS)]}" for i in range(positions)]
+
+
+def layer(name, bindings):
+    rows = [
+        " ".join(bindings[i : i + COLUMNS]) for i in range(0, len(bindings), COLUMNS)
+    ]
+    body = "\n".join(f"                {row}" for row in rows)
+    return f"""        {name} {{
+            bindings = <
+{body}
+            >;
+        }};
+"""
+
+
+def repeat_to(pattern, events):
+    """Repeat a pattern of events until there are at least the given number of them."""
+    return pattern * max(1, math.ceil(events / len(pattern)))
+
+
+def boot(size, events):
+    return {"layers": [plain_bindings(COLUMNS)], "events": []}
+
+
+def positions(size, events):
+    pattern = [ev for pos in range(size) for ev in tap(pos)]
+    return {"layers": [plain_bindings(size)], "events": repeat_to(pattern, events)}
+
+
+def layers(size, events):
+    # Every layer toggles the one above it from position 1 and is otherwise transparent, so once
+    # position 1 has been tapped enough times all of them are active and position 0 falls through
+    # every one of them to the base layer.
+    keys = []
+    for i in range(size):
+        bindings = plain_bindings(COLUMNS) if i == 0 else ["&trans"] * COLUMNS
+        bindings[1] = f"&tog {i + 1}" if i + 1 < size else "&trans"
+        keys.append(bindings)
+
+    activate = [ev for _ in range(size - 1) for ev in tap(1)]
+    pattern = tap(0) + tap(2)
+    return {
+        "layers": keys,
+        "events": activate + repeat_to(pattern, events - len(activate)),
+        "conf": ["CONFIG_ZMK_KEYMAP_LAYER_STATE_WIDE=y"] if size > 32 else [],
+    }
+
+
+def combo_pairs(size):
+    """Spread two key combos over as few positions as fit them, sharing keys between combos."""
+    keys = 2
+    while keys * (keys - 1) // 2 < size:
+        keys += 1
+    pairs = [(a, a + gap) for gap in range(1, keys) for a in range(keys - gap)]
+    return pairs[:size], keys
+
+
+def combos(size, events):
+    pairs, keys = combo_pairs(size)
+    positions = max(COLUMNS, math.ceil(keys / COLUMNS) * COLUMNS)
+
+    # Fire every combo once, tapping each key of a combo on its own in between so the combos it
+    # belongs to have to be considered and then rejected.
+    pattern = []
+    for a, b in pairs:
+        pattern += [press(a), press(b), release(a), release(b)]
+        pattern += tap(a, 60)
+
+    definitions = [
+        f"""        combo_{a}_{b} {{
+            timeout-ms = <50>;
+            key-positions = <{a} {b}>;
+            bindings = <&kp Z>;
+        }};
+"""
+        for a, b in pairs
+    ]
+    return {
+        "layers": [plain_bindings(positions)],
+        "combos": definitions,
+        "events": repeat_to(pattern, events),
+    }
+
+
+def hold_tap(size, events):
+    positions = max(COLUMNS, math.ceil((size + 1) / COLUMNS) * COLUMNS)
+    bindings = plain_bindings(positions)
+    for i in range(size):
+        bindings[i] = f"&ht LS({KEYS[i % len(KEYS)]}) {KEYS[i % len(KEYS)]}"
+
+    # Press every hold-tap before any of them is decided, then roll over a plain key, so each one
+    # captures the presses after it until the plain key decides them all at once.
+    plain = size
+    pattern = [press(i, 5) for i in range(size)] + tap(plain, 5)
+    pattern += [release(i, 5) for i in reversed(range(size))]
+    pattern[-1] = release(0, 300)
+
+    captured = 2 * size + 2
+    return {
+        "layers": [bindings],
+        "hold_tap": True,
+        "events": repeat_to(pattern, events),
+        "conf": [
+            f"CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_HELD={max(size, 10)}",
+            f"CONFIG_ZMK_BEHAVIOR_HOLD_TAP_MAX_CAPTURED_EVENTS={max(captured, 40)}",
+        ],
+    }
+
+
+GENERATORS = {
+    "boot": boot,
+    "positions": positions,
+    "layers": layers,
+    "combos": combos,
+    "hold-tap": hold_tap,
+}
+
+
+def render(case):
+    positions = len(case["layers"][0])
+    out = [
+        "/*",
+        " * Generated by scripts/stress_keymap.py.",
+        " */",
+        "",
+        "#include <dt-bindings/zmk/keys.h>",
+        "#include <behaviors.dtsi>",
+        "#include <dt-bindings/zmk/kscan_mock.h>",
+        "",
+        "/ {",
+    ]
+
+    if case.get("hold_tap"):
+        out += [
+            "    behaviors {",
+            "        ht: stress_hold_tap {",
+            '            compatible = "zmk,behavior-hold-tap";',
+            "            #binding-cells = <2>;",
+            '            flavor = "balanced";',
+            "            tapping-term-ms = <200>;",
+            "            bindings = <&kp>, <&kp>;",
+            "        };",
+            "    };",
+            "",
+        ]
+
+    if case.get("combos"):
+        out += ["    combos {", '        compatible = "zmk,combos";', ""]
+        out += case["combos"]
+        out += ["    };", ""]
+
+    out += ["    keymap {", '        compatible = "zmk,keymap";', ""]
+    out += [layer(f"layer_{i}", bindings) for i, bindings in enumerate(case["layers"])]
+    out += ["    };", "};", ""]
+
+    out += [
+        "&kscan {",
+        f"    rows = <{positions // COLUMNS}>;",
+        f"    columns = <{COLUMNS}>;",
+        "    events = <",
+    ]
+    out += [f"        {ev}" for ev in case["events"]]
+    out += ["    >;", "};", ""]
+
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("feature", choices=GENERATORS.keys())
+    parser.add_argument("size", type=int, help="Number of positions, layers, combos or hold-taps")
+    parser.add_argument("out_dir", type=Path, help="Directory to write the case to")
+    parser.add_argument(
+        "--events", type=int, default=2000, help="Approximate number of mock events"
+    )
+    args = parser.parse_args()
+
+    if args.feature == "positions" and args.size % COLUMNS:
+        parser.error(f"positions must be a multiple of {COLUMNS}")
+
+    case = GENERATORS[args.feature](args.size, args.events)
+    if len(case["layers"][0]) > 255 * COLUMNS:
+        parser.error("too many positions for the mock kscan")
+
+    args.out_dir.mkdir(parents=True, exist_ok=True)
+    (args.out_dir / "native_posix_64.keymap").write_text(render(case))
+    conf = ["CONFIG_ZMK_KSCAN_MOCK_TIMING=y"] + case.get("conf", [])
+    (args.out_dir / "native_posix_64.conf").write_text("\n".join(conf) + "\n")
+    print(len(case["events"]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+# Copyright (c) 2026 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""Turns a trace from the `telemetry export` shell command into mock kscan events.
+
+The events can be included in a native_posix_64 keymap to replay a real typing session with its
+original timing, as a test that reproduces a timing-sensitive bug or as a benchmark of a real
+workload. The keyboard reports sent while the trace was recorded are listed alongside, so a replay
+with telemetry enabled can be checked against them.
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+FORMAT_VERSION = 1
+RECORD = struct.Struct("<IBBH")
+
+# The values of enum zmk_telemetry_record_type that are replayed or checked.
+POSITION_PRESSED = 0
+POSITION_RELEASED = 1
+KEYBOARD_REPORT = 7
+
+SOURCE_LOCAL = 255
+# The mock kscan has 15 bits for the delay after each event.
+MAX_MOCK_MSEC = 0x7FFF
+
+HEADER = re.compile(r"zmk-telemetry (?P<version>\d+) dropped (?P<dropped>\d+)")
+HEX_LINE = re.compile(r"^(?:[0-9a-f]{16})+$")
+
+
+def read_records(path):
+    """Read the records of every export in a terminal log, ignoring anything around them."""
+    records = []
+    exporting = False
+
+    for line in Path(path).read_text(errors="replace").splitlines():
+        # Strip prompts and colors that the shell may add.
+        line = re.sub(r"\x1b\[[0-9;]*[A-Za-z]", "", line).strip()
+
+        match = HEADER.search(line)
+        if match:
+            if int(match.group("version")) != FORMAT_VERSION:
+                sys.exit(f"Unsupported trace format version {match.group('version')}")
+            if int(match.group("dropped")) > 0:
+                print(
+                    f"warning: {match.group('dropped')} records were dropped while recording",
+                    file=sys.stderr,
+                )
+            exporting = True
+            continue
+
+        if not exporting:
+            continue
+
+        if line == "end":
+            exporting = False
+        elif HEX_LINE.match(line):
+            data = bytes.fromhex(line)
+            records += [RECORD.unpack_from(data, i) for i in range(0, len(data), RECORD.size)]
+
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("trace", type=Path, help="Terminal log with one or more exports")
+    parser.add_argument("out_dir", type=Path, help="Directory for events.dtsi and reports.txt")
+    parser.add_argument(
+        "--columns", type=int, required=True, help="Columns of the mock kscan to replay on"
+    )
+    parser.add_argument("--rows", type=int, help="Rows of the mock kscan, to set in events.dtsi")
+    parser.add_argument(
+        "--max-gap-ms",
+        type=int,
+        default=2000,
+        help="Shorten longer pauses between events to this (default is 2000)",
+    )
+    parser.add_argument(
+        "--local-only", action="store_true", help="Skip events from split peripherals"
+    )
+    args = parser.parse_args()
+
+    max_gap = min(args.max_gap_ms, MAX_MOCK_MSEC)
+    events = []
+    reports = []
+    start = None
+    last = None
+
+    for timestamp, record_type, arg, value in read_records(args.trace):
+        if start is None:
+            start = last = timestamp
+
+        if record_type == KEYBOARD_REPORT:
+            # Timestamps wrap after about 71 minutes, so only their differences are used.
+            reports.append(((timestamp - start) & 0xFFFFFFFF, arg, value))
+        elif record_type in (POSITION_PRESSED, POSITION_RELEASED):
+            if args.local_only and arg != SOURCE_LOCAL:
+                continue
+
+            if events:
+                gap_ms = round(((timestamp - last) & 0xFFFFFFFF) / 1000)
+                events[-1][3] = min(gap_ms, max_gap)
+            last = timestamp
+            events.append([record_type == POSITION_PRESSED, value // args.columns,
+                           value % args.columns, 0])
+
+    if not events:
+        sys.exit("No key position records found in the trace")
+
+    # Leave time after the last event for everything it started to finish.
+    events[-1][3] = max_gap
+
+    lines = ["&kscan {"]
+    if args.rows:
+        lines += [f"    rows = <{args.rows}>;", f"    columns = <{args.columns}>;"]
+    lines += ["    events = <"]
+    lines += [
+        f"        ZMK_MOCK_{'PRESS' if pressed else 'RELEASE'}({row}, {col}, {msec})"
+        for pressed, row, col, msec in events
+    ]
+    lines += ["    >;", "};", ""]
+
+    args.out_dir.mkdir(parents=True, exist_ok=True)
+    (args.out_dir / "events.dtsi").write_text("\n".join(lines))
+    (args.out_dir / "reports.txt").write_text(
+        "".join(f"{us:>12} {transport} {crc:04x}\n" for us, transport, crc in reports)
+    )
+
+    print(f"{len(events)} key events and {len(reports)} keyboard reports written to {args.out_dir}")
+
+
+if __name__ == "__main__":
+    main()
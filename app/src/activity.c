@@ -17,6 +17,9 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/activity_state_changed.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/sensor_event.h>
+#if IS_ENABLED(CONFIG_ZMK_SLEEP) && IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+#include <zmk/events/usb_conn_state_changed.h>
+#endif
 
 #include <zmk/pm.h>
 
@@ -63,19 +66,57 @@ int set_state(enum zmk_activity_state state) {
 
 enum zmk_activity_state zmk_activity_get_state(void) { return activity_state; }
 
+// There is no periodic check: activity_work is scheduled for the next deadline (going idle while
+// active, going to sleep while idle), and when it runs it either makes that transition or, if
+// there was activity in between, moves the deadline to the new one. Noting activity while active
+// is then just a timestamp store.
+static void activity_work_handler(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(activity_work, activity_work_handler);
+
+static void schedule_deadline(uint32_t timeout_ms) {
+    const uint32_t inactive_time = k_uptime_get_32() - activity_last_uptime;
+
+    k_work_reschedule(&activity_work,
+                      K_MSEC(inactive_time < timeout_ms ? timeout_ms - inactive_time : 0));
+}
+
 static int note_activity(void) {
-    activity_last_uptime = k_uptime_get();
+    activity_last_uptime = k_uptime_get_32();
 
+    if (activity_state == ZMK_ACTIVITY_ACTIVE) {
+        return 0;
+    }
+
+    schedule_deadline(MAX_IDLE_MS);
     return set_state(ZMK_ACTIVITY_ACTIVE);
 }
 
-static int activity_event_listener(const zmk_event_t *eh) { return note_activity(); }
+static int activity_event_listener(const zmk_event_t *eh) {
+#if IS_ENABLED(CONFIG_ZMK_SLEEP) && IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    // Sleep is held off while USB power is present, so unplugging can make it due right away
+    if (as_zmk_usb_conn_state_changed(eh)) {
+        if (activity_state == ZMK_ACTIVITY_IDLE) {
+            schedule_deadline(MAX_SLEEP_MS);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+#endif
+
+    note_activity();
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+static void activity_work_handler(struct k_work *work) {
+    const uint32_t inactive_time = k_uptime_get_32() - activity_last_uptime;
+
+    if (inactive_time < MAX_IDLE_MS) {
+        schedule_deadline(MAX_IDLE_MS);
+        return;
+    }
 
-void activity_work_handler(struct k_work *work) {
-    int32_t current = k_uptime_get();
-    int32_t inactive_time = current - activity_last_uptime;
 #if IS_ENABLED(CONFIG_ZMK_SLEEP)
-    if (inactive_time > MAX_SLEEP_MS && !is_usb_power_present()) {
+    if (inactive_time >= MAX_SLEEP_MS && !is_usb_power_present()) {
         // Put devices in suspend power mode before sleeping
         set_state(ZMK_ACTIVITY_SLEEP);
 
@@ -86,29 +127,32 @@ void activity_work_handler(struct k_work *work) {
         }
 
         sys_poweroff();
-    } else
+    }
 #endif /* IS_ENABLED(CONFIG_ZMK_SLEEP) */
-        if (inactive_time > MAX_IDLE_MS) {
-            set_state(ZMK_ACTIVITY_IDLE);
-        }
-}
-
-K_WORK_DEFINE(activity_work, activity_work_handler);
 
-void activity_expiry_function(struct k_timer *_timer) { k_work_submit(&activity_work); }
+    set_state(ZMK_ACTIVITY_IDLE);
 
-K_TIMER_DEFINE(activity_timer, activity_expiry_function, NULL);
+#if IS_ENABLED(CONFIG_ZMK_SLEEP)
+    // With USB power present this waits for the next activity or USB change instead
+    if (!is_usb_power_present()) {
+        schedule_deadline(MAX_SLEEP_MS);
+    }
+#endif /* IS_ENABLED(CONFIG_ZMK_SLEEP) */
+}
 
 static int activity_init(void) {
-    activity_last_uptime = k_uptime_get();
+    activity_last_uptime = k_uptime_get_32();
 
-    k_timer_start(&activity_timer, K_SECONDS(1), K_SECONDS(1));
+    schedule_deadline(MAX_IDLE_MS);
     return 0;
 }
 
 ZMK_LISTENER(activity, activity_event_listener);
 ZMK_SUBSCRIPTION(activity, zmk_position_state_changed);
 ZMK_SUBSCRIPTION(activity, zmk_sensor_event);
+#if IS_ENABLED(CONFIG_ZMK_SLEEP) && IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+ZMK_SUBSCRIPTION(activity, zmk_usb_conn_state_changed);
+#endif
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
@@ -116,7 +160,15 @@ static void note_activity_work_cb(struct k_work *_work) { note_activity(); }
 
 K_WORK_DEFINE(note_activity_work, note_activity_work_cb);
 
-static void activity_input_listener(struct input_event *ev) { k_work_submit(&note_activity_work); }
+// Input events arrive on the input thread. While active only the timestamp changes, which is safe
+// from there; waking up from idle raises an event, so that's left to the system work queue.
+static void activity_input_listener(struct input_event *ev) {
+    activity_last_uptime = k_uptime_get_32();
+
+    if (activity_state != ZMK_ACTIVITY_ACTIVE) {
+        k_work_submit(&note_activity_work);
+    }
+}
 
 INPUT_CALLBACK_DEFINE(NULL, activity_input_listener);
 
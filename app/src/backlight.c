@@ -15,6 +15,8 @@
 
 #include <zmk/activity.h>
 #include <zmk/backlight.h>
+#include <zmk/energy.h>
+#include <zmk/settings.h>
 #include <zmk/usb.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/activity_state_changed.h>
@@ -42,9 +44,14 @@ struct backlight_state {
 static struct backlight_state state = {.brightness = CONFIG_ZMK_BACKLIGHT_BRT_START,
                                        .on = IS_ENABLED(CONFIG_ZMK_BACKLIGHT_ON_START)};
 
-static int zmk_backlight_update(void) {
-    uint8_t brt = zmk_backlight_get_brt();
-    LOG_DBG("Update backlight brightness: %d%%", brt);
+// The brightness the LEDs were last set to, or UINT8_MAX before they've been set, so unchanged
+// brightness levels aren't written to them again.
+static uint8_t applied_brt = UINT8_MAX;
+
+static int backlight_apply_brt(uint8_t brt) {
+    if (brt == applied_brt) {
+        return 0;
+    }
 
     for (int i = 0; i < BACKLIGHT_NUM_LEDS; i++) {
         int rc = led_set_brightness(backlight_dev, i, brt);
@@ -53,9 +60,56 @@ static int zmk_backlight_update(void) {
             return rc;
         }
     }
+
+    applied_brt = brt;
+    zmk_energy_set_duty(ZMK_ENERGY_BACKLIGHT, brt * 10);
     return 0;
 }
 
+#if CONFIG_ZMK_BACKLIGHT_FADE_MS > 0
+
+static uint8_t fade_start_brt;
+static int64_t fade_start_time;
+
+static void backlight_fade_work_cb(struct k_work *work) {
+    const uint8_t target = zmk_backlight_get_brt();
+    const int64_t elapsed = k_uptime_get() - fade_start_time;
+
+    if (elapsed >= CONFIG_ZMK_BACKLIGHT_FADE_MS) {
+        backlight_apply_brt(target);
+        return;
+    }
+
+    const int delta = (int)target - fade_start_brt;
+    const uint8_t brt = fade_start_brt + (delta * elapsed / CONFIG_ZMK_BACKLIGHT_FADE_MS);
+
+    if (backlight_apply_brt(brt) == 0) {
+        k_work_reschedule(k_work_delayable_from_work(work),
+                          K_MSEC(CONFIG_ZMK_BACKLIGHT_FADE_STEP_MS));
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(backlight_fade_work, backlight_fade_work_cb);
+
+#endif // CONFIG_ZMK_BACKLIGHT_FADE_MS > 0
+
+static int zmk_backlight_update(void) {
+    uint8_t brt = zmk_backlight_get_brt();
+    LOG_DBG("Update backlight brightness: %d%%", brt);
+
+#if CONFIG_ZMK_BACKLIGHT_FADE_MS > 0
+    // The first update sets the brightness right away, later ones fade from wherever the LEDs are
+    if (applied_brt != UINT8_MAX) {
+        fade_start_brt = applied_brt;
+        fade_start_time = k_uptime_get();
+        k_work_reschedule(&backlight_fade_work, K_NO_WAIT);
+        return 0;
+    }
+#endif // CONFIG_ZMK_BACKLIGHT_FADE_MS > 0
+
+    return backlight_apply_brt(brt);
+}
+
 #if IS_ENABLED(CONFIG_SETTINGS)
 static int backlight_settings_load_cb(const char *name, size_t len, settings_read_cb read_cb,
                                       void *cb_arg) {
@@ -78,11 +132,11 @@ static int backlight_settings_load_cb(const char *name, size_t len, settings_rea
 SETTINGS_STATIC_HANDLER_DEFINE(backlight, "backlight", NULL, backlight_settings_load_cb, NULL,
                                NULL);
 
-static void backlight_save_work_handler(struct k_work *work) {
+static void backlight_save_cb(void) {
     settings_save_one("backlight/state", &state, sizeof(state));
 }
 
-static struct k_work_delayable backlight_save_work;
+ZMK_SETTINGS_SAVE_DEFINE(backlight_save, backlight_save_cb);
 #endif
 
 static int zmk_backlight_init(void) {
@@ -91,9 +145,6 @@ static int zmk_backlight_init(void) {
         return -ENODEV;
     }
 
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&backlight_save_work, backlight_save_work_handler);
-#endif
 #if IS_ENABLED(CONFIG_ZMK_BACKLIGHT_AUTO_OFF_USB)
     state.on = zmk_usb_is_powered();
 #endif
@@ -107,8 +158,7 @@ static int zmk_backlight_update_and_save(void) {
     }
 
 #if IS_ENABLED(CONFIG_SETTINGS)
-    int ret = k_work_reschedule(&backlight_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
-    return MIN(ret, 0);
+    return zmk_settings_save_schedule(&backlight_save);
 #else
     return 0;
 #endif
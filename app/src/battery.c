@@ -13,6 +13,8 @@
 
 #include <zephyr/logging/log.h>
 
+#include <stdlib.h>
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/event_manager.h>
@@ -50,18 +52,77 @@ static uint8_t lithium_ion_mv_to_pct(int16_t bat_mv) {
 
 #endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING_FETCH_MODE_LITHIUM_VOLTAGE)
 
-static int zmk_battery_update(const struct device *battery) {
-    struct sensor_value state_of_charge;
-    int rc;
-
 #if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING_FETCH_MODE_STATE_OF_CHARGE)
+#define BATTERY_FETCH_CHANNEL SENSOR_CHAN_GAUGE_STATE_OF_CHARGE
+#elif IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING_FETCH_MODE_LITHIUM_VOLTAGE)
+#define BATTERY_FETCH_CHANNEL SENSOR_CHAN_VOLTAGE
+#else
+#error "Not a supported reporting fetch mode"
+#endif
 
-    rc = sensor_sample_fetch_chan(battery, SENSOR_CHAN_GAUGE_STATE_OF_CHARGE);
-    if (rc != 0) {
-        LOG_DBG("Failed to fetch battery values: %d", rc);
-        return rc;
+// Set if the battery sensor reports finished samples through a data ready trigger, in which case
+// a fetch only starts the sample and the result is published once the trigger fires.
+static bool battery_async;
+
+static void zmk_battery_timer(struct k_timer *timer);
+
+K_TIMER_DEFINE(battery_timer, zmk_battery_timer, NULL);
+
+// The filtered state of charge, with this many fractional bits.
+#define FILTER_FRACTION_BITS 8
+
+static int32_t filtered_state_of_charge;
+static bool battery_reported;
+static uint32_t report_interval_s = CONFIG_ZMK_BATTERY_REPORT_INTERVAL;
+
+static uint8_t zmk_battery_filter(uint8_t sample) {
+    const int32_t value = (int32_t)sample << FILTER_FRACTION_BITS;
+
+    if (!battery_reported) {
+        filtered_state_of_charge = value;
+    } else {
+        // A moving average smooths out ADC noise and the brief sag while the radio transmits.
+        filtered_state_of_charge +=
+            (value - filtered_state_of_charge) >> CONFIG_ZMK_BATTERY_REPORT_FILTER_SHIFT;
     }
 
+    return (filtered_state_of_charge + BIT(FILTER_FRACTION_BITS - 1)) >> FILTER_FRACTION_BITS;
+}
+
+static bool zmk_battery_level_changed(uint8_t level) {
+    if (!battery_reported) {
+        return true;
+    }
+
+    // Empty and full are always reported, however close the last report was.
+    if (level != last_state_of_charge && (level == 0 || level == 100)) {
+        return true;
+    }
+
+    return abs(level - last_state_of_charge) >= CONFIG_ZMK_BATTERY_REPORT_HYSTERESIS;
+}
+
+static void zmk_battery_set_interval(uint32_t interval_s) {
+    if (interval_s != report_interval_s) {
+        report_interval_s = interval_s;
+        k_timer_start(&battery_timer, K_SECONDS(interval_s), K_SECONDS(interval_s));
+    }
+}
+
+// While the level holds steady the battery is barely discharging, so it is sampled less often.
+static void zmk_battery_back_off(void) {
+#if CONFIG_ZMK_BATTERY_REPORT_INTERVAL_MAX > 0
+    zmk_battery_set_interval(
+        MAX(MIN(report_interval_s * 2, CONFIG_ZMK_BATTERY_REPORT_INTERVAL_MAX),
+            CONFIG_ZMK_BATTERY_REPORT_INTERVAL));
+#endif
+}
+
+static int zmk_battery_publish(const struct device *battery) {
+    struct sensor_value state_of_charge;
+    int rc;
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING_FETCH_MODE_STATE_OF_CHARGE)
     rc = sensor_channel_get(battery, SENSOR_CHAN_GAUGE_STATE_OF_CHARGE, &state_of_charge);
 
     if (rc != 0) {
@@ -69,12 +130,6 @@ static int zmk_battery_update(const struct device *battery) {
         return rc;
     }
 #elif IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING_FETCH_MODE_LITHIUM_VOLTAGE)
-    rc = sensor_sample_fetch_chan(battery, SENSOR_CHAN_VOLTAGE);
-    if (rc != 0) {
-        LOG_DBG("Failed to fetch battery values: %d", rc);
-        return rc;
-    }
-
     struct sensor_value voltage;
     rc = sensor_channel_get(battery, SENSOR_CHAN_VOLTAGE, &voltage);
 
@@ -87,12 +142,16 @@ static int zmk_battery_update(const struct device *battery) {
     state_of_charge.val1 = lithium_ion_mv_to_pct(mv);
 
     LOG_DBG("State of change %d from %d mv", state_of_charge.val1, mv);
-#else
-#error "Not a supported reporting fetch mode"
 #endif
 
-    if (last_state_of_charge != state_of_charge.val1) {
-        last_state_of_charge = state_of_charge.val1;
+    const uint8_t level = zmk_battery_filter(state_of_charge.val1);
+
+    if (!zmk_battery_level_changed(level)) {
+        zmk_battery_back_off();
+    } else {
+        last_state_of_charge = level;
+        battery_reported = true;
+        zmk_battery_set_interval(CONFIG_ZMK_BATTERY_REPORT_INTERVAL);
 #if IS_ENABLED(CONFIG_BT_BAS)
         LOG_DBG("Setting BAS GATT battery level to %d.", last_state_of_charge);
 
@@ -110,7 +169,21 @@ static int zmk_battery_update(const struct device *battery) {
     return rc;
 }
 
-static void zmk_battery_work(struct k_work *work) {
+static int zmk_battery_update(const struct device *battery) {
+    int rc = sensor_sample_fetch_chan(battery, BATTERY_FETCH_CHANNEL);
+    if (rc != 0) {
+        LOG_DBG("Failed to fetch battery values: %d", rc);
+        return rc;
+    }
+
+    if (battery_async) {
+        return 0;
+    }
+
+    return zmk_battery_publish(battery);
+}
+
+ZMK_WORKQUEUE_PROFILE_HANDLER(zmk_battery_work) {
     int rc = zmk_battery_update(battery);
 
     if (rc != 0) {
@@ -118,16 +191,31 @@ static void zmk_battery_work(struct k_work *work) {
     }
 }
 
-K_WORK_DEFINE(battery_work, zmk_battery_work);
+K_WORK_DEFINE(battery_work, ZMK_WORKQUEUE_PROFILED(zmk_battery_work));
 
-static void zmk_battery_timer(struct k_timer *timer) {
-    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &battery_work);
+static void zmk_battery_publish_work(struct k_work *work) {
+    int rc = zmk_battery_publish(battery);
+
+    if (rc != 0) {
+        LOG_DBG("Failed to publish battery value: %d.", rc);
+    }
 }
 
-K_TIMER_DEFINE(battery_timer, zmk_battery_timer, NULL);
+K_WORK_DEFINE(battery_publish_work, zmk_battery_publish_work);
+
+static void zmk_battery_data_ready(const struct device *dev, const struct sensor_trigger *trig) {
+    // The handler runs in the driver's context, so publishing is left to the low priority queue.
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &battery_publish_work);
+}
+
+static void zmk_battery_timer(struct k_timer *timer) {
+    ZMK_WORKQUEUE_PROFILE_SUBMITTED(zmk_battery_work);
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &battery_work);
+}
 
 static void zmk_battery_start_reporting() {
     if (device_is_ready(battery)) {
+        report_interval_s = CONFIG_ZMK_BATTERY_REPORT_INTERVAL;
         k_timer_start(&battery_timer, K_NO_WAIT, K_SECONDS(CONFIG_ZMK_BATTERY_REPORT_INTERVAL));
     }
 }
@@ -148,6 +236,14 @@ static int zmk_battery_init(void) {
         return -ENODEV;
     }
 
+    static const struct sensor_trigger data_ready = {
+        .type = SENSOR_TRIG_DATA_READY,
+        .chan = BATTERY_FETCH_CHANNEL,
+    };
+
+    battery_async = sensor_trigger_set(battery, &data_ready, zmk_battery_data_ready) == 0;
+    LOG_DBG("Battery sampling is %s", battery_async ? "asynchronous" : "synchronous");
+
     zmk_battery_start_reporting();
     return 0;
 }
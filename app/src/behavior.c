@@ -6,6 +6,7 @@
 
 #include <zephyr/device.h>
 #include <zephyr/init.h>
+#include <zephyr/spinlock.h>
 #include <zephyr/sys/crc.h>
 #include <zephyr/sys/util_macro.h>
 #include <string.h>
@@ -35,11 +36,55 @@ const struct device *zmk_behavior_get_binding(const char *name) {
     return behavior_get_binding(name);
 }
 
-const struct device *z_impl_behavior_get_binding(const char *name) {
-    if (name == NULL || name[0] == '\0') {
+#if CONFIG_ZMK_BEHAVIOR_BINDING_CACHE_SIZE > 0
+
+// Keymaps, macros and other bindings hand us the same few name pointers over and over, and each
+// press looks its behavior up several times, so remember which device a name pointer resolved to.
+// Only ready devices are cached. Since a runtime-constructed binding may reuse a name buffer for a
+// different behavior, a hit on anything other than the device's own name string is re-verified.
+struct behavior_binding_cache_entry {
+    const char *name;
+    const struct device *device;
+};
+
+static struct behavior_binding_cache_entry
+    behavior_binding_cache[CONFIG_ZMK_BEHAVIOR_BINDING_CACHE_SIZE];
+static struct k_spinlock behavior_binding_cache_lock;
+
+static inline struct behavior_binding_cache_entry *behavior_binding_cache_slot(const char *name) {
+    size_t idx = ((uintptr_t)name >> 2) % CONFIG_ZMK_BEHAVIOR_BINDING_CACHE_SIZE;
+    return &behavior_binding_cache[idx];
+}
+
+static const struct device *behavior_binding_cache_get(const char *name) {
+    struct behavior_binding_cache_entry *slot = behavior_binding_cache_slot(name);
+
+    k_spinlock_key_t key = k_spin_lock(&behavior_binding_cache_lock);
+    struct behavior_binding_cache_entry entry = *slot;
+    k_spin_unlock(&behavior_binding_cache_lock, key);
+
+    if (entry.name != name) {
         return NULL;
     }
 
+    if (entry.device->name == name || strcmp(entry.device->name, name) == 0) {
+        return entry.device;
+    }
+
+    return NULL;
+}
+
+static void behavior_binding_cache_put(const char *name, const struct device *device) {
+    struct behavior_binding_cache_entry *slot = behavior_binding_cache_slot(name);
+
+    k_spinlock_key_t key = k_spin_lock(&behavior_binding_cache_lock);
+    *slot = (struct behavior_binding_cache_entry){.name = name, .device = device};
+    k_spin_unlock(&behavior_binding_cache_lock, key);
+}
+
+#endif // CONFIG_ZMK_BEHAVIOR_BINDING_CACHE_SIZE > 0
+
+static const struct device *find_behavior_by_name(const char *name) {
     STRUCT_SECTION_FOREACH(zmk_behavior_ref, item) {
         if (z_device_is_ready(item->device) && item->device->name == name) {
             return item->device;
@@ -55,6 +100,28 @@ const struct device *z_impl_behavior_get_binding(const char *name) {
     return NULL;
 }
 
+const struct device *z_impl_behavior_get_binding(const char *name) {
+    if (name == NULL || name[0] == '\0') {
+        return NULL;
+    }
+
+#if CONFIG_ZMK_BEHAVIOR_BINDING_CACHE_SIZE > 0
+    const struct device *cached = behavior_binding_cache_get(name);
+    if (cached) {
+        return cached;
+    }
+
+    const struct device *device = find_behavior_by_name(name);
+    if (device) {
+        behavior_binding_cache_put(name, device);
+    }
+
+    return device;
+#else
+    return find_behavior_by_name(name);
+#endif
+}
+
 static int invoke_locally(struct zmk_behavior_binding *binding,
                           struct zmk_behavior_binding_event event, bool pressed) {
     if (pressed) {
@@ -105,9 +172,7 @@ int zmk_behavior_invoke_binding(const struct zmk_behavior_binding *src_binding,
 #endif
     case BEHAVIOR_LOCALITY_GLOBAL:
 #if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
-        for (int i = 0; i < ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT; i++) {
-            zmk_split_central_invoke_behavior(i, &binding, event, pressed);
-        }
+        zmk_split_central_invoke_global_behavior(&binding, event, pressed);
 #endif
         return invoke_locally(&binding, event, pressed);
     }
@@ -126,6 +191,60 @@ int zmk_behavior_get_empty_param_metadata(const struct device *dev,
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+#if CONFIG_ZMK_BEHAVIOR_METADATA_CACHE_SIZE > 0
+
+// Macros and other behaviors work their metadata out from their bindings each time they're asked,
+// and Studio asks for every binding it sets, so remember the metadata each device returned.
+struct behavior_metadata_cache_entry {
+    const struct device *device;
+    struct behavior_parameter_metadata metadata;
+};
+
+static struct behavior_metadata_cache_entry
+    behavior_metadata_cache[CONFIG_ZMK_BEHAVIOR_METADATA_CACHE_SIZE];
+static struct k_spinlock behavior_metadata_cache_lock;
+
+static inline struct behavior_metadata_cache_entry *
+behavior_metadata_cache_slot(const struct device *dev) {
+    size_t idx = ((uintptr_t)dev / sizeof(struct device)) % CONFIG_ZMK_BEHAVIOR_METADATA_CACHE_SIZE;
+    return &behavior_metadata_cache[idx];
+}
+
+#endif // CONFIG_ZMK_BEHAVIOR_METADATA_CACHE_SIZE > 0
+
+int zmk_behavior_get_parameter_metadata(const struct device *dev,
+                                        struct behavior_parameter_metadata *metadata) {
+#if CONFIG_ZMK_BEHAVIOR_METADATA_CACHE_SIZE > 0
+    struct behavior_metadata_cache_entry *slot = behavior_metadata_cache_slot(dev);
+    bool hit = false;
+
+    K_SPINLOCK(&behavior_metadata_cache_lock) {
+        if (slot->device == dev) {
+            *metadata = slot->metadata;
+            hit = true;
+        }
+    }
+
+    if (hit) {
+        return 0;
+    }
+
+    int ret = behavior_get_parameter_metadata(dev, metadata);
+    if (ret < 0) {
+        return ret;
+    }
+
+    K_SPINLOCK(&behavior_metadata_cache_lock) {
+        *slot = (struct behavior_metadata_cache_entry){.device = dev, .metadata = *metadata};
+    }
+
+    return ret;
+#else
+    return behavior_get_parameter_metadata(dev, metadata);
+#endif // CONFIG_ZMK_BEHAVIOR_METADATA_CACHE_SIZE > 0
+}
+
 static int validate_hid_usage(uint16_t usage_page, uint16_t usage_id) {
     LOG_DBG("Validate usage %d in page %d", usage_id, usage_page);
     switch (usage_page) {
@@ -246,7 +365,7 @@ int zmk_behavior_validate_binding(const struct zmk_behavior_binding *binding) {
     }
 
     struct behavior_parameter_metadata metadata;
-    int ret = behavior_get_parameter_metadata(behavior, &metadata);
+    int ret = zmk_behavior_get_parameter_metadata(behavior, &metadata);
 
     if (ret < 0) {
         LOG_WRN("Failed getting metadata for %s: %d", binding->behavior_dev, ret);
@@ -261,11 +380,100 @@ int zmk_behavior_validate_binding(const struct zmk_behavior_binding *binding) {
 
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS)
 
+// The local ID map section is in RAM, so once every ID is assigned the section is sorted by ID and
+// looking up an ID becomes a binary search. With CRC16 IDs, the ID of a name is its hash, so
+// looking up a name is the same search plus a compare.
+static bool local_id_map_sorted;
+
+static void sort_local_id_map(void) {
+    size_t count;
+    STRUCT_SECTION_COUNT(zmk_behavior_local_id_map, &count);
+
+    // Only done once the IDs are known, and there are few behaviors, so insertion sort will do.
+    for (size_t i = 1; i < count; i++) {
+        struct zmk_behavior_local_id_map *item;
+        STRUCT_SECTION_GET(zmk_behavior_local_id_map, i, &item);
+        const struct zmk_behavior_local_id_map moving = *item;
+        size_t j = i;
+
+        for (; j > 0; j--) {
+            struct zmk_behavior_local_id_map *prev, *dest;
+            STRUCT_SECTION_GET(zmk_behavior_local_id_map, j - 1, &prev);
+
+            if (prev->local_id <= moving.local_id) {
+                break;
+            }
+
+            STRUCT_SECTION_GET(zmk_behavior_local_id_map, j, &dest);
+            *dest = *prev;
+        }
+
+        STRUCT_SECTION_GET(zmk_behavior_local_id_map, j, &item);
+        *item = moving;
+    }
+
+    local_id_map_sorted = true;
+}
+
+/**
+ * @returns the index of the first entry of the sorted local ID map with @p local_id, or the number
+ * of entries if there is none.
+ */
+static size_t local_id_map_search(zmk_behavior_local_id_t local_id) {
+    size_t count, lo = 0, hi;
+    STRUCT_SECTION_COUNT(zmk_behavior_local_id_map, &count);
+
+    hi = count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        struct zmk_behavior_local_id_map *item;
+        STRUCT_SECTION_GET(zmk_behavior_local_id_map, mid, &item);
+
+        if (item->local_id < local_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
 zmk_behavior_local_id_t zmk_behavior_get_local_id(const char *name) {
     if (!name) {
         return UINT16_MAX;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_ID_TYPE_CRC16)
+    if (local_id_map_sorted) {
+        const zmk_behavior_local_id_t local_id = crc16_ansi(name, strlen(name));
+        size_t count;
+        STRUCT_SECTION_COUNT(zmk_behavior_local_id_map, &count);
+
+        for (size_t i = local_id_map_search(local_id); i < count; i++) {
+            struct zmk_behavior_local_id_map *item;
+            STRUCT_SECTION_GET(zmk_behavior_local_id_map, i, &item);
+
+            if (item->local_id != local_id) {
+                break;
+            }
+
+            if (z_device_is_ready(item->device) && strcmp(item->device->name, name) == 0) {
+                return local_id;
+            }
+        }
+
+        return UINT16_MAX;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_ID_TYPE_CRC16)
+
+    // Names in bindings are usually the device's own name string, so try the cheap compare first.
+    STRUCT_SECTION_FOREACH(zmk_behavior_local_id_map, item) {
+        if (z_device_is_ready(item->device) && item->device->name == name) {
+            return item->local_id;
+        }
+    }
+
     STRUCT_SECTION_FOREACH(zmk_behavior_local_id_map, item) {
         if (z_device_is_ready(item->device) && strcmp(item->device->name, name) == 0) {
             return item->local_id;
@@ -276,6 +484,26 @@ zmk_behavior_local_id_t zmk_behavior_get_local_id(const char *name) {
 }
 
 const char *zmk_behavior_find_behavior_name_from_local_id(zmk_behavior_local_id_t local_id) {
+    if (local_id_map_sorted) {
+        size_t count;
+        STRUCT_SECTION_COUNT(zmk_behavior_local_id_map, &count);
+
+        for (size_t i = local_id_map_search(local_id); i < count; i++) {
+            struct zmk_behavior_local_id_map *item;
+            STRUCT_SECTION_GET(zmk_behavior_local_id_map, i, &item);
+
+            if (item->local_id != local_id) {
+                break;
+            }
+
+            if (z_device_is_ready(item->device)) {
+                return item->device->name;
+            }
+        }
+
+        return NULL;
+    }
+
     STRUCT_SECTION_FOREACH(zmk_behavior_local_id_map, item) {
         if (z_device_is_ready(item->device) && item->local_id == local_id) {
             return item->device->name;
@@ -292,6 +520,8 @@ static int behavior_local_id_init(void) {
         item->local_id = crc16_ansi(item->device->name, strlen(item->device->name));
     }
 
+    sort_local_id_map();
+
     return 0;
 }
 
@@ -306,6 +536,9 @@ static int behavior_handle_set(const char *name, size_t len, settings_read_cb re
     const char *next;
 
     if (settings_name_steq(name, "local_id", &next) && next) {
+        // IDs are changing, so search linearly until they are sorted again on commit.
+        local_id_map_sorted = false;
+
         char *endptr;
         zmk_behavior_local_id_t local_id = strtoul(next, &endptr, 10);
         if (*endptr != '\0') {
@@ -364,6 +597,8 @@ static int behavior_handle_commit(void) {
         settings_save_one(setting_name, device_name, strlen(device_name));
     }
 
+    sort_local_id_map();
+
     return 0;
 }
 
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+
+#include <zmk/behavior_instances.h>
+
+static bool instance_used(const struct zmk_behavior_instance_pool *pool, int index) {
+    return sys_bitfield_test_bit((mem_addr_t)pool->used, index);
+}
+
+static int scan_position(const struct zmk_behavior_instance_pool *pool, uint32_t position) {
+    for (int i = 0; i < pool->size; i++) {
+        if (instance_used(pool, i) && pool->positions[i] == position) {
+            return i;
+        }
+    }
+
+    return -ENOENT;
+}
+
+int zmk_behavior_instance_alloc(struct zmk_behavior_instance_pool *pool, uint32_t position) {
+    for (int i = 0; i < pool->size; i++) {
+        if (instance_used(pool, i)) {
+            continue;
+        }
+
+        sys_bitfield_set_bit((mem_addr_t)pool->used, i);
+        pool->positions[i] = position;
+
+        if (position < ZMK_BEHAVIOR_INSTANCE_POSITIONS &&
+            pool->by_position[position] == ZMK_BEHAVIOR_INSTANCE_NONE) {
+            pool->by_position[position] = i;
+        }
+
+        return i;
+    }
+
+    return -ENOMEM;
+}
+
+void zmk_behavior_instance_free(struct zmk_behavior_instance_pool *pool, int index) {
+    const uint32_t position = pool->positions[index];
+
+    sys_bitfield_clear_bit((mem_addr_t)pool->used, index);
+
+    if (position < ZMK_BEHAVIOR_INSTANCE_POSITIONS && pool->by_position[position] == index) {
+        // Another instance may have been taken for the position while this one was still in use.
+        const int next = scan_position(pool, position);
+
+        pool->by_position[position] = next >= 0 ? next : ZMK_BEHAVIOR_INSTANCE_NONE;
+    }
+}
+
+int zmk_behavior_instance_find(const struct zmk_behavior_instance_pool *pool, uint32_t position) {
+    if (position >= ZMK_BEHAVIOR_INSTANCE_POSITIONS) {
+        return scan_position(pool, position);
+    }
+
+    const uint8_t index = pool->by_position[position];
+
+    return index == ZMK_BEHAVIOR_INSTANCE_NONE ? -ENOENT : index;
+}
+
+int zmk_behavior_instance_next(const struct zmk_behavior_instance_pool *pool, int from) {
+    for (int i = from; i < pool->size; i++) {
+        if (instance_used(pool, i)) {
+            return i;
+        }
+    }
+
+    return -ENOENT;
+}
@@ -6,7 +6,10 @@
 
 #include <zmk/behavior_queue.h>
 #include <zmk/behavior.h>
+#include <zmk/queue_stats.h>
+#include <zmk/workqueue.h>
 
+#include <zephyr/init.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <drivers/behavior.h>
@@ -18,45 +21,170 @@ struct q_item {
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
     uint8_t source;
 #endif
-    struct zmk_behavior_binding binding;
+    bool is_steps : 1;
     bool press : 1;
-    uint32_t wait : 31;
+    uint32_t wait : 30;
+    union {
+        struct zmk_behavior_binding binding;
+        struct {
+            const struct zmk_behavior_queue_step *steps;
+            uint32_t param1;
+            uint32_t param2;
+            uint16_t count;
+        } sequence;
+    };
+};
+
+#define BEHAVIOR_QUEUE_LANES CONFIG_ZMK_BEHAVIORS_QUEUE_LANES
+
+// Each lane runs its items in order, independently of the other lanes. Items are assigned a lane
+// by key position, so the press and release queued for a key always end up in the same lane.
+struct behavior_queue_lane {
+    struct k_msgq msgq;
+    struct k_work_delayable work;
+    // The item being run, which for a sequence stays current across the waits between its steps.
+    struct q_item current_item;
+    bool have_current_item;
+    bool current_step_pressed;
+    bool processing;
+    uint16_t current_step;
 };
 
-K_MSGQ_DEFINE(zmk_behavior_queue_msgq, sizeof(struct q_item), CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE, 4);
+static char __aligned(4) lane_buffers[BEHAVIOR_QUEUE_LANES]
+                                     [CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE * sizeof(struct q_item)];
+static struct behavior_queue_lane lanes[BEHAVIOR_QUEUE_LANES];
+
+static atomic_t overflow_count = ATOMIC_INIT(0);
+
+static uint32_t select_param(uint8_t param_source, uint32_t step_param,
+                             const struct q_item *item) {
+    switch (param_source) {
+    case ZMK_BEHAVIOR_QUEUE_PARAM_SEQUENCE_1ST:
+        return item->sequence.param1;
+    case ZMK_BEHAVIOR_QUEUE_PARAM_SEQUENCE_2ND:
+        return item->sequence.param2;
+    default:
+        return step_param;
+    }
+}
+
+// Get the next press or release to invoke for the current item of the lane. Returns true if it
+// is the last one for the item.
+static bool next_invocation(struct behavior_queue_lane *lane, struct zmk_behavior_binding *binding,
+                            bool *press, uint32_t *wait) {
+    const struct q_item *item = &lane->current_item;
+
+    if (!item->is_steps) {
+        *binding = item->binding;
+        *press = item->press;
+        *wait = item->wait;
+        return true;
+    }
+
+    const struct zmk_behavior_queue_step *step = &item->sequence.steps[lane->current_step];
+
+    *binding = step->binding;
+    binding->param1 = select_param(step->param1_source, step->binding.param1, item);
+    binding->param2 = select_param(step->param2_source, step->binding.param2, item);
 
-static void behavior_queue_process_next(struct k_work *work);
-static K_WORK_DELAYABLE_DEFINE(queue_work, behavior_queue_process_next);
+    switch (step->op) {
+    case ZMK_BEHAVIOR_QUEUE_STEP_TAP:
+        if (!lane->current_step_pressed) {
+            lane->current_step_pressed = true;
+            *press = true;
+            *wait = step->tap_ms;
+            return false;
+        }
+        lane->current_step_pressed = false;
+        *press = false;
+        break;
+    case ZMK_BEHAVIOR_QUEUE_STEP_PRESS:
+        *press = true;
+        break;
+    default:
+        *press = false;
+        break;
+    }
+
+    *wait = step->wait_ms;
+    lane->current_step++;
+    return lane->current_step >= item->sequence.count;
+}
 
 static void behavior_queue_process_next(struct k_work *work) {
-    struct q_item item = {.wait = 0};
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    struct behavior_queue_lane *lane = CONTAINER_OF(d_work, struct behavior_queue_lane, work);
+
+    lane->processing = true;
+
+    while (lane->have_current_item ||
+           k_msgq_get(&lane->msgq, &lane->current_item, K_NO_WAIT) == 0) {
+        if (!lane->have_current_item) {
+            lane->have_current_item = true;
+            lane->current_step = 0;
+            lane->current_step_pressed = false;
+        }
+
+        struct zmk_behavior_binding binding;
+        bool press;
+        uint32_t wait;
 
-    while (k_msgq_get(&zmk_behavior_queue_msgq, &item, K_NO_WAIT) == 0) {
-        LOG_DBG("Invoking %s: 0x%02x 0x%02x", item.binding.behavior_dev, item.binding.param1,
-                item.binding.param2);
+        if (next_invocation(lane, &binding, &press, &wait)) {
+            lane->have_current_item = false;
+        }
 
-        struct zmk_behavior_binding_event event = {.position = item.position,
+        LOG_DBG("Invoking %s: 0x%02x 0x%02x", binding.behavior_dev, binding.param1,
+                binding.param2);
+
+        struct zmk_behavior_binding_event event = {.position = lane->current_item.position,
                                                    .timestamp = k_uptime_get(),
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
-                                                   .source = item.source
+                                                   .source = lane->current_item.source
 #endif
         };
 
-        if (item.press) {
-            zmk_behavior_invoke_binding(&item.binding, event, true);
+        if (press) {
+            zmk_behavior_invoke_binding(&binding, event, true);
         } else {
-            zmk_behavior_invoke_binding(&item.binding, event, false);
+            zmk_behavior_invoke_binding(&binding, event, false);
         }
 
-        LOG_DBG("Processing next queued behavior in %dms", item.wait);
+        LOG_DBG("Processing next queued behavior in %dms", wait);
 
-        if (item.wait > 0) {
-            k_work_schedule(&queue_work, K_MSEC(item.wait));
+        if (wait > 0) {
+            k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &lane->work,
+                                      K_MSEC(wait));
             break;
         }
     }
+
+    lane->processing = false;
+}
+
+// All lanes are sized by the same option, so they share one set of counters.
+ZMK_QUEUE_STATS_DEFINE(behavior_queue_lanes, "behavior queue lanes",
+                       CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE);
+
+static int queue_item(const struct q_item *item) {
+    struct behavior_queue_lane *lane = &lanes[item->position % BEHAVIOR_QUEUE_LANES];
+
+    const int ret = ZMK_QUEUE_STATS_MSGQ_PUT(behavior_queue_lanes, &lane->msgq, item, K_NO_WAIT);
+    if (ret < 0) {
+        atomic_inc(&overflow_count);
+        LOG_WRN("Behavior queue full, dropping item for position %d", item->position);
+        return ret;
+    }
+
+    // Items queued by a behavior invoked from the lane are picked up by its running loop.
+    if (!lane->processing && !k_work_delayable_is_pending(&lane->work)) {
+        behavior_queue_process_next(&lane->work.work);
+    }
+
+    return 0;
 }
 
+uint32_t zmk_behavior_queue_overflow_count(void) { return (uint32_t)atomic_get(&overflow_count); }
+
 int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
                            const struct zmk_behavior_binding binding, bool press, uint32_t wait) {
     struct q_item item = {
@@ -69,14 +197,42 @@ int zmk_behavior_queue_add(const struct zmk_behavior_binding_event *event,
 #endif
     };
 
-    const int ret = k_msgq_put(&zmk_behavior_queue_msgq, &item, K_NO_WAIT);
-    if (ret < 0) {
-        return ret;
+    return queue_item(&item);
+}
+
+int zmk_behavior_queue_add_steps(const struct zmk_behavior_binding_event *event,
+                                 const struct zmk_behavior_queue_step *steps, uint16_t count,
+                                 uint32_t param1, uint32_t param2) {
+    if (count == 0) {
+        return 0;
     }
 
-    if (!k_work_delayable_is_pending(&queue_work)) {
-        behavior_queue_process_next(&queue_work.work);
+    struct q_item item = {
+        .is_steps = true,
+        .sequence =
+            {
+                .steps = steps,
+                .param1 = param1,
+                .param2 = param2,
+                .count = count,
+            },
+        .position = event->position,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+        .source = event->source,
+#endif
+    };
+
+    return queue_item(&item);
+}
+
+static int behavior_queue_init(void) {
+    for (int i = 0; i < BEHAVIOR_QUEUE_LANES; i++) {
+        k_msgq_init(&lanes[i].msgq, lane_buffers[i], sizeof(struct q_item),
+                    CONFIG_ZMK_BEHAVIORS_QUEUE_SIZE);
+        k_work_init_delayable(&lanes[i].work, behavior_queue_process_next);
     }
 
     return 0;
 }
+
+SYS_INIT(behavior_queue_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
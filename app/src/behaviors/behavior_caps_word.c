@@ -36,20 +36,36 @@ struct behavior_caps_word_config {
     struct caps_word_continue_item continuations[];
 };
 
+// One bit per keyboard page usage
+#define KEY_USAGE_BITMAP_WORDS (256 / 32)
+
 struct behavior_caps_word_data {
+    uint8_t index;
     bool active;
+    // Keyboard page usages on the include list, built at init so keycodes that aren't on it are
+    // told apart with a bit test instead of a search of the list.
+    uint32_t listed_keys[KEY_USAGE_BITMAP_WORDS];
 };
 
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) <= 32,
+             "The active caps word bitmap only supports 32 instances");
+
+// Bit n is set while caps word instance n is active, so the keycode listener can return right
+// away when none is.
+static uint32_t active_caps_words;
+
 static void activate_caps_word(const struct device *dev) {
     struct behavior_caps_word_data *data = dev->data;
 
     data->active = true;
+    WRITE_BIT(active_caps_words, data->index, true);
 }
 
 static void deactivate_caps_word(const struct device *dev) {
     struct behavior_caps_word_data *data = dev->data;
 
     data->active = false;
+    WRITE_BIT(active_caps_words, data->index, false);
 }
 
 static int on_caps_word_binding_pressed(struct zmk_behavior_binding *binding,
@@ -87,18 +103,28 @@ ZMK_SUBSCRIPTION(behavior_caps_word, zmk_keycode_state_changed);
 #define GET_DEV(inst) DEVICE_DT_INST_GET(inst),
 static const struct device *devs[] = {DT_INST_FOREACH_STATUS_OKAY(GET_DEV)};
 
-static bool caps_word_is_caps_includelist(const struct behavior_caps_word_config *config,
-                                          uint16_t usage_page, uint8_t usage_id,
-                                          uint8_t implicit_modifiers) {
+static inline bool key_usage_bit_test(const uint32_t *bitmap, uint8_t usage_id) {
+    return (bitmap[usage_id / 32] & BIT(usage_id % 32)) != 0;
+}
+
+static bool caps_word_is_caps_includelist(const struct device *dev, uint16_t usage_page,
+                                          uint8_t usage_id, uint8_t implicit_modifiers) {
+    const struct behavior_caps_word_config *config = dev->config;
+    const struct behavior_caps_word_data *data = dev->data;
+
+    if (usage_page == HID_USAGE_KEY && !key_usage_bit_test(data->listed_keys, usage_id)) {
+        return false;
+    }
+
+    const zmk_mod_flags_t mods = implicit_modifiers | zmk_hid_get_explicit_mods();
+
     for (int i = 0; i < config->continuations_count; i++) {
         const struct caps_word_continue_item *continuation = &config->continuations[i];
         LOG_DBG("Comparing with 0x%02X - 0x%02X (with implicit mods: 0x%02X)", continuation->page,
                 continuation->id, continuation->implicit_modifiers);
 
         if (continuation->page == usage_page && continuation->id == usage_id &&
-            (continuation->implicit_modifiers &
-             (implicit_modifiers | zmk_hid_get_explicit_mods())) ==
-                continuation->implicit_modifiers) {
+            (continuation->implicit_modifiers & mods) == continuation->implicit_modifiers) {
             LOG_DBG("Continuing capsword, found included usage: 0x%02X - 0x%02X", usage_page,
                     usage_id);
             return true;
@@ -133,21 +159,15 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
-    for (int i = 0; i < ARRAY_SIZE(devs); i++) {
-        const struct device *dev = devs[i];
-
-        struct behavior_caps_word_data *data = dev->data;
-        if (!data->active) {
-            continue;
-        }
-
+    for (uint32_t active = active_caps_words; active != 0; active &= active - 1) {
+        const struct device *dev = devs[__builtin_ctz(active)];
         const struct behavior_caps_word_config *config = dev->config;
 
         caps_word_enhance_usage(config, ev);
 
         if (!caps_word_is_alpha(ev->keycode) && !caps_word_is_numeric(ev->keycode) &&
             !is_mod(ev->usage_page, ev->keycode) &&
-            !caps_word_is_caps_includelist(config, ev->usage_page, ev->keycode,
+            !caps_word_is_caps_includelist(dev, ev->usage_page, ev->keycode,
                                            ev->implicit_modifiers)) {
             LOG_DBG("Deactivating caps_word for 0x%02X - 0x%02X", ev->usage_page, ev->keycode);
             deactivate_caps_word(dev);
@@ -157,6 +177,23 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
     return ZMK_EV_EVENT_BUBBLE;
 }
 
+static int behavior_caps_word_init(const struct device *dev) {
+    const struct behavior_caps_word_config *config = dev->config;
+    struct behavior_caps_word_data *data = dev->data;
+
+    for (int i = 0; i < config->continuations_count; i++) {
+        const struct caps_word_continue_item *continuation = &config->continuations[i];
+
+        if (continuation->page != HID_USAGE_KEY || continuation->id > UINT8_MAX) {
+            continue;
+        }
+
+        WRITE_BIT(data->listed_keys[continuation->id / 32], continuation->id % 32, true);
+    }
+
+    return 0;
+}
+
 #define CAPS_WORD_LABEL(i, _n) DT_INST_LABEL(i)
 
 #define PARSE_BREAK(i)                                                                             \
@@ -165,13 +202,14 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
 #define BREAK_ITEM(i, n) PARSE_BREAK(DT_INST_PROP_BY_IDX(n, continue_list, i))
 
 #define KP_INST(n)                                                                                 \
-    static struct behavior_caps_word_data behavior_caps_word_data_##n = {.active = false};         \
+    static struct behavior_caps_word_data behavior_caps_word_data_##n = {.index = n,               \
+                                                                         .active = false};         \
     static const struct behavior_caps_word_config behavior_caps_word_config_##n = {                \
         .mods = DT_INST_PROP_OR(n, mods, MOD_LSFT),                                                \
         .continuations = {LISTIFY(DT_INST_PROP_LEN(n, continue_list), BREAK_ITEM, (, ), n)},       \
         .continuations_count = DT_INST_PROP_LEN(n, continue_list),                                 \
     };                                                                                             \
-    BEHAVIOR_DT_INST_DEFINE(n, NULL, NULL, &behavior_caps_word_data_##n,                           \
+    BEHAVIOR_DT_INST_DEFINE(n, behavior_caps_word_init, NULL, &behavior_caps_word_data_##n,        \
                             &behavior_caps_word_config_##n, POST_KERNEL,                           \
                             CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_caps_word_driver_api);
 
@@ -6,19 +6,30 @@
 
 #define DT_DRV_COMPAT zmk_behavior_hold_tap
 
+#include <string.h>
 #include <zephyr/device.h>
 #include <drivers/behavior.h>
 #include <zmk/keys.h>
 #include <dt-bindings/zmk/keys.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_instances.h>
 #include <zmk/matrix.h>
+#include <zmk/workqueue.h>
 #include <zmk/endpoints.h>
 #include <zmk/event_manager.h>
+#include <zmk/event_pool.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
+#include <zmk/keystroke_timeline.h>
+#include <zmk/telemetry.h>
 #include <zmk/behavior.h>
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS_SHELL)
+#include <stdio.h>
+#include <zephyr/shell/shell.h>
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS_SHELL)
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
@@ -50,8 +61,11 @@ enum decision_moment {
     HT_OTHER_KEY_UP,
     HT_TIMER_EVENT,
     HT_QUICK_TAP,
+    HT_PREDICTED_HOLD,
 };
 
+#define HT_DECISION_MOMENTS (HT_PREDICTED_HOLD + 1)
+
 struct behavior_hold_tap_config {
     int tapping_term_ms;
     char *hold_behavior_dev;
@@ -63,14 +77,45 @@ struct behavior_hold_tap_config {
     bool hold_while_undecided_linger;
     bool retro_tap;
     bool hold_trigger_on_release;
+    // hold_trigger_key_positions within the keymap as a bitmap, filled in at init
+    uint32_t *hold_trigger_key_positions_mask;
     int32_t hold_trigger_key_positions_len;
     int32_t hold_trigger_key_positions[];
 };
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+
+#define STATS_BUCKETS CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS_BUCKETS
+#define STATS_BUCKET_MS CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS_BUCKET_MS
+
+enum stats_outcome {
+    STATS_OUTCOME_TAP,
+    STATS_OUTCOME_HOLD,
+    STATS_OUTCOMES,
+};
+
+// Histograms have buckets of STATS_BUCKET_MS, the last one also counting everything longer.
+// Counts stop at UINT16_MAX rather than wrapping.
+struct hold_tap_stats {
+    uint16_t decisions[HT_DECISION_MOMENTS][STATS_OUTCOMES];
+    // Time from the press to the decision.
+    uint16_t decision_ms[STATS_OUTCOMES][STATS_BUCKETS];
+    // Time from the press to the first other key press while undecided.
+    uint16_t interrupt_gap_ms[STATS_BUCKETS];
+    // Time since the previous tap of the same position, for presses that follow one.
+    uint16_t repress_gap_ms[STATS_BUCKETS];
+    uint16_t retro_taps;
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+
 struct behavior_hold_tap_data {
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
     struct behavior_parameter_metadata_set set;
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+    struct hold_tap_stats stats;
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
 };
 
 // this data is specific for each hold-tap
@@ -84,11 +129,16 @@ struct active_hold_tap {
     int64_t timestamp;
     enum status status;
     const struct behavior_hold_tap_config *config;
-    struct k_work_delayable work;
+    struct zmk_workqueue_deadline deadline;
     bool work_is_cancelled;
 
     // initialized to -1, which is to be interpreted as "no other key has been pressed yet"
     int32_t position_of_first_other_key_pressed;
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+    struct hold_tap_stats *stats;
+    bool interrupted;
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
 };
 
 // The undecided hold tap is the hold tap that needs to be decided before
@@ -98,86 +148,215 @@ struct active_hold_tap {
 // its key-up has been processed and the delayed work is cleaned up.
 struct active_hold_tap *undecided_hold_tap = NULL;
 struct active_hold_tap active_hold_taps[ZMK_BHV_HOLD_TAP_MAX_HELD] = {};
+ZMK_BEHAVIOR_INSTANCE_POOL_DEFINE(hold_tap_instances, ZMK_BHV_HOLD_TAP_MAX_HELD);
 // We capture most position_state_changed events and some modifiers_state_changed events.
 
-enum captured_event_tag {
-    ET_NONE,
-    ET_POS_CHANGED,
-    ET_CODE_CHANGED,
-};
+// Captured events are kept in the shared event pool, while references to them are kept in order
+// in a ring buffer. Slot indexes only ever increase and are
+// wrapped on access, so the distances below never need special casing at the wrap point.
+//
+// The events in [captured_events_head, captured_events_head + captured_events_len) belong to the
+// undecided hold-tap. Once it's decided they are handed to release_captured_events() as a batch,
+// whose slots stay reserved until each event has been re-raised: captured_events_floor is the
+// oldest slot still in use by a batch that hasn't been fully released.
+zmk_event_pool_ref_t captured_events[ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS] = {};
+static uint32_t captured_events_floor;
+static uint32_t captured_events_head;
+static uint32_t captured_events_len;
+static uint8_t captured_events_release_depth;
+
+#define CAPTURED_EVENT_AT(_idx) (&captured_events[(_idx) % ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS])
+
+// Key positions with a keydown captured for the undecided hold-tap.
+static uint32_t captured_keydown_positions[DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)];
 
-union captured_event_data {
-    struct zmk_position_state_changed_event position;
-    struct zmk_keycode_state_changed_event keycode;
-};
+static void store_last_hold_tapped(struct active_hold_tap *hold_tap) {
+    zmk_keystroke_timeline_note_hold_tap(hold_tap->position, hold_tap->timestamp);
+}
 
-struct captured_event {
-    enum captured_event_tag tag;
-    union captured_event_data data;
-};
+static bool is_quick_tap(struct active_hold_tap *hold_tap) {
+    struct zmk_keystroke last_tapped;
 
-struct captured_event captured_events[ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS] = {};
+    if (zmk_keystroke_timeline_last_tap(0, &last_tapped) < 0) {
+        return false;
+    }
 
-// Keep track of which key was tapped most recently for the standard, if it is a hold-tap
-// a position, will be given, if not it will just be INT32_MIN
-struct last_tapped {
-    int32_t position;
-    int64_t timestamp;
-};
+    if ((last_tapped.timestamp + hold_tap->config->require_prior_idle_ms) > hold_tap->timestamp) {
+        return true;
+    } else {
+        return (last_tapped.position == hold_tap->position) &&
+               (last_tapped.timestamp + hold_tap->config->quick_tap_ms) > hold_tap->timestamp;
+    }
+}
 
-// Set time stamp to large negative number initially for test suites, but not
-// int64 min since it will overflow if -1 is added
-struct last_tapped last_tapped = {INT32_MIN, INT32_MIN};
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
 
-static void store_last_tapped(int64_t timestamp) {
-    if (timestamp > last_tapped.timestamp) {
-        last_tapped.position = INT32_MIN;
-        last_tapped.timestamp = timestamp;
+static void stats_count(uint16_t *count) {
+    if (*count < UINT16_MAX) {
+        (*count)++;
     }
 }
 
-static void store_last_hold_tapped(struct active_hold_tap *hold_tap) {
-    last_tapped.position = hold_tap->position;
-    last_tapped.timestamp = hold_tap->timestamp;
+static void stats_count_ms(uint16_t *histogram, int64_t ms) {
+    stats_count(&histogram[CLAMP(ms / STATS_BUCKET_MS, 0, STATS_BUCKETS - 1)]);
 }
 
-static bool is_quick_tap(struct active_hold_tap *hold_tap) {
-    if ((last_tapped.timestamp + hold_tap->config->require_prior_idle_ms) > hold_tap->timestamp) {
-        return true;
+static void stats_record_press(struct active_hold_tap *hold_tap) {
+    struct zmk_keystroke last_tapped;
+
+    hold_tap->interrupted = false;
+
+    if (zmk_keystroke_timeline_last_tap(0, &last_tapped) == 0 &&
+        last_tapped.position == hold_tap->position) {
+        stats_count_ms(hold_tap->stats->repress_gap_ms,
+                       hold_tap->timestamp - last_tapped.timestamp);
+    }
+}
+
+static void stats_record_interrupt(struct active_hold_tap *hold_tap, int64_t timestamp) {
+    if (hold_tap->interrupted) {
+        return;
+    }
+
+    hold_tap->interrupted = true;
+    stats_count_ms(hold_tap->stats->interrupt_gap_ms, timestamp - hold_tap->timestamp);
+}
+
+static void stats_record_decision(struct active_hold_tap *hold_tap,
+                                  enum decision_moment decision_moment) {
+    enum stats_outcome outcome =
+        hold_tap->status == STATUS_TAP ? STATS_OUTCOME_TAP : STATS_OUTCOME_HOLD;
+
+    stats_count(&hold_tap->stats->decisions[decision_moment][outcome]);
+    stats_count_ms(hold_tap->stats->decision_ms[outcome], k_uptime_get() - hold_tap->timestamp);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_PREDICTIVE)
+
+// Number of taps that must be seen on a position before its statistics are trusted.
+#define PREDICTIVE_MIN_SAMPLES 8
+
+// For each position, a moving average of how long the key is held down when it is tapped.
+struct tap_duration_stats {
+    uint16_t avg_ms;
+    uint8_t samples;
+};
+
+static struct tap_duration_stats tap_durations[ZMK_KEYMAP_LEN];
+
+static void store_tap_duration(struct active_hold_tap *hold_tap, int64_t release_timestamp) {
+    if (hold_tap->position < 0 || hold_tap->position >= ZMK_KEYMAP_LEN) {
+        return;
+    }
+
+    struct tap_duration_stats *stats = &tap_durations[hold_tap->position];
+    int64_t duration = release_timestamp - hold_tap->timestamp;
+
+    if (duration < 0 || duration > hold_tap->config->tapping_term_ms) {
+        return;
+    }
+
+    if (stats->samples == 0) {
+        stats->avg_ms = duration;
     } else {
-        return (last_tapped.position == hold_tap->position) &&
-               (last_tapped.timestamp + hold_tap->config->quick_tap_ms) > hold_tap->timestamp;
+        // Exponential moving average with a 1/8 weight for the newest sample.
+        stats->avg_ms = (int32_t)stats->avg_ms + ((int32_t)duration - (int32_t)stats->avg_ms) / 8;
+    }
+
+    if (stats->samples < UINT8_MAX) {
+        stats->samples++;
     }
 }
 
-static int capture_event(struct captured_event *data) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        if (captured_events[i].tag == ET_NONE) {
-            captured_events[i] = *data;
-            return 0;
-        }
+// When another key goes down while the hold-tap has been held for much longer than it usually is
+// when tapped, the overlap can only be explained by a hold. Deciding now saves waiting for the
+// other key's release or for the tapping term.
+static bool is_predicted_hold(struct active_hold_tap *hold_tap, int64_t timestamp) {
+    if (hold_tap->position < 0 || hold_tap->position >= ZMK_KEYMAP_LEN) {
+        return false;
+    }
+
+    const struct tap_duration_stats *stats = &tap_durations[hold_tap->position];
+
+    if (stats->samples < PREDICTIVE_MIN_SAMPLES) {
+        return false;
     }
-    return -ENOMEM;
+
+    int64_t held = timestamp - hold_tap->timestamp;
+    int64_t threshold =
+        (int64_t)stats->avg_ms * CONFIG_ZMK_BEHAVIOR_HOLD_TAP_PREDICTIVE_FACTOR_PERCENT / 100;
+
+    return held > threshold && held < hold_tap->config->tapping_term_ms;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_PREDICTIVE)
+
+static bool captured_events_full() {
+    return (captured_events_head + captured_events_len) - captured_events_floor >=
+           ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS;
+}
+
+static int capture_event(const zmk_event_t *eh) {
+    if (captured_events_full()) {
+        return -ENOMEM;
+    }
+
+    zmk_event_pool_ref_t ref = zmk_event_pool_capture(eh);
+    if (ref == ZMK_EVENT_POOL_REF_NONE) {
+        return -ENOMEM;
+    }
+
+    *CAPTURED_EVENT_AT(captured_events_head + captured_events_len) = ref;
+    captured_events_len++;
+
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev != NULL && ev->state && ev->position < ZMK_KEYMAP_LEN) {
+        sys_bitfield_set_bit((mem_addr_t)captured_keydown_positions, ev->position);
+    }
+
+    return 0;
 }
 
 static bool have_captured_keydown_event(uint32_t position) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        struct captured_event *ev = &captured_events[i];
-        if (ev->tag == ET_NONE) {
-            return false;
-        }
+    if (position < ZMK_KEYMAP_LEN) {
+        return sys_bitfield_test_bit((mem_addr_t)captured_keydown_positions, position);
+    }
 
-        if (ev->tag != ET_POS_CHANGED) {
+    for (uint32_t i = captured_events_head; i < captured_events_head + captured_events_len; i++) {
+        const struct zmk_position_state_changed *ev =
+            ZMK_EVENT_POOL_AS(*CAPTURED_EVENT_AT(i), zmk_position_state_changed);
+
+        if (ev == NULL) {
             continue;
         }
 
-        if (ev->data.position.data.position == position && ev->data.position.data.state) {
+        if (ev->position == position && ev->state) {
             return true;
         }
     }
     return false;
 }
 
+static void decide_hold_tap(struct active_hold_tap *hold_tap,
+                            enum decision_moment decision_moment);
+
+// Make room for one more captured event. Rather than dropping events when the buffer is full,
+// the undecided hold-tap is decided as if its tapping term expired, which releases the events
+// it captured. The same goes for the shared event pool, but it may be full of events held by
+// combos, in which case the event can't be captured at all. Returns false if there's no undecided
+// hold-tap left to capture the event.
+static bool reserve_captured_event(const zmk_event_t *eh) {
+    while (undecided_hold_tap != NULL &&
+           (captured_events_full() || !zmk_event_pool_can_capture(eh))) {
+        LOG_WRN("%d deciding early, no room left to capture events", undecided_hold_tap->position);
+        decide_hold_tap(undecided_hold_tap, HT_TIMER_EVENT);
+    }
+
+    return undecided_hold_tap != NULL;
+}
+
 const struct zmk_listener zmk_listener_behavior_hold_tap;
 
 static void release_captured_events() {
@@ -185,96 +364,98 @@ static void release_captured_events() {
         return;
     }
 
-    // We use a trick to prevent copying the captured_events array.
-    //
-    // Events for different mod-tap instances are separated by a NULL pointer.
+    // Take the events captured by the hold-tap that was just decided as a batch. Re-raising them
+    // may make another hold-tap undecided, which captures the rest of the batch (or events they
+    // cause) after it in the ring, keeping everything in order. Should that hold-tap be decided in
+    // turn, the nested call releases its own, earlier, events before we carry on with ours.
     //
-    // The first event popped will never be caught by the next active hold-tap
-    // because to start capturing a mod-tap-key-down event must first completely
-    // go through the events queue.
-    //
-    // Example of this release process;
-    // [mt2_down, k1_down, k1_up, mt2_up, null, ...]
-    //  ^
+    // Example of this release process, with the batch between | and new captures after it;
+    // |mt2_down, k1_down, k1_up, mt2_up|
     // mt2_down position event isn't captured because no hold-tap is active.
     // mt2_down behavior event is handled, now we have an undecided hold-tap
-    // [null, k1_down, k1_up, mt2_up, null, ...]
-    //        ^
-    // k1_down  is captured by the mt2 mod-tap
-    // !note that searches for find_captured_keydown_event by the mt2 behavior will stop at the
-    // first null encountered [mt1_down, null, k1_up, mt2_up, null, ...]
-    //                  ^
+    // |k1_down, k1_up, mt2_up|
+    // k1_down is captured by the mt2 mod-tap
+    // |k1_up, mt2_up| k1_down
     // k1_up event is captured by the new hold-tap:
-    // [k1_down, k1_up, null, mt2_up, null, ...]
-    //                        ^
+    // |mt2_up| k1_down, k1_up
     // mt2_up event is not captured but causes release of mt2 behavior
-    // [k1_down, k1_up, null, null, null, ...]
+    // || |k1_down, k1_up|
     // now mt2 will start releasing it's own captured positions.
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_CAPTURED_EVENTS; i++) {
-        struct captured_event *captured_event = &captured_events[i];
-        enum captured_event_tag tag = captured_event->tag;
-
-        if (tag == ET_NONE) {
-            return;
+    uint32_t next = captured_events_head;
+    uint32_t end = captured_events_head + captured_events_len;
+
+    captured_events_head = end;
+    captured_events_len = 0;
+    memset(captured_keydown_positions, 0, sizeof(captured_keydown_positions));
+    captured_events_release_depth++;
+
+    for (; next < end; next++) {
+        zmk_event_pool_ref_t ref = *CAPTURED_EVENT_AT(next);
+        zmk_event_t *captured_event = zmk_event_pool_get(ref);
+        const struct zmk_position_state_changed *position;
+        const struct zmk_keycode_state_changed *keycode;
+
+        // Free the slot if no earlier batch is still being released from further down the ring
+        if (captured_events_floor == next) {
+            captured_events_floor = next + 1;
         }
 
-        captured_events[i].tag = ET_NONE;
         if (undecided_hold_tap != NULL) {
             k_msleep(10);
         }
 
-        switch (tag) {
-        case ET_CODE_CHANGED:
-            LOG_DBG("Releasing mods changed event 0x%02X %s",
-                    captured_event->data.keycode.data.keycode,
-                    (captured_event->data.keycode.data.state ? "pressed" : "released"));
-            ZMK_EVENT_RAISE_AT(captured_event->data.keycode, behavior_hold_tap);
-            break;
-        case ET_POS_CHANGED:
-            LOG_DBG("Releasing key position event for position %d %s",
-                    captured_event->data.position.data.position,
-                    (captured_event->data.position.data.state ? "pressed" : "released"));
-            ZMK_EVENT_RAISE_AT(captured_event->data.position, behavior_hold_tap);
-            break;
-        default:
+        if ((keycode = as_zmk_keycode_state_changed(captured_event)) != NULL) {
+            LOG_DBG("Releasing mods changed event 0x%02X %s", keycode->keycode,
+                    (keycode->state ? "pressed" : "released"));
+            zmk_event_manager_raise_at(captured_event, &zmk_listener_behavior_hold_tap);
+        } else if ((position = as_zmk_position_state_changed(captured_event)) != NULL) {
+            LOG_DBG("Releasing key position event for position %d %s", position->position,
+                    (position->state ? "pressed" : "released"));
+            zmk_event_manager_raise_at(captured_event, &zmk_listener_behavior_hold_tap);
+        } else {
             LOG_ERR("Unhandled captured event type");
-            break;
         }
+
+        zmk_event_pool_unref(ref);
+    }
+
+    // Slots released by nested calls out of order are only reclaimed once every batch is done
+    if (--captured_events_release_depth == 0) {
+        captured_events_floor = captured_events_head;
     }
 }
 
 static struct active_hold_tap *find_hold_tap(uint32_t position) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-        if (active_hold_taps[i].position == position) {
-            return &active_hold_taps[i];
-        }
-    }
-    return NULL;
+    const int index = zmk_behavior_instance_find(&hold_tap_instances, position);
+
+    return index < 0 ? NULL : &active_hold_taps[index];
 }
 
 static struct active_hold_tap *store_hold_tap(struct zmk_behavior_binding_event *event,
                                               uint32_t param_hold, uint32_t param_tap,
                                               const struct behavior_hold_tap_config *config) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-        if (active_hold_taps[i].position != ZMK_BHV_HOLD_TAP_POSITION_NOT_USED) {
-            continue;
-        }
-        active_hold_taps[i].position = event->position;
+    const int index = zmk_behavior_instance_alloc(&hold_tap_instances, event->position);
+    if (index < 0) {
+        return NULL;
+    }
+
+    struct active_hold_tap *hold_tap = &active_hold_taps[index];
+
+    hold_tap->position = event->position;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
-        active_hold_taps[i].source = event->source;
+    hold_tap->source = event->source;
 #endif
-        active_hold_taps[i].status = STATUS_UNDECIDED;
-        active_hold_taps[i].config = config;
-        active_hold_taps[i].param_hold = param_hold;
-        active_hold_taps[i].param_tap = param_tap;
-        active_hold_taps[i].timestamp = event->timestamp;
-        active_hold_taps[i].position_of_first_other_key_pressed = -1;
-        return &active_hold_taps[i];
-    }
-    return NULL;
+    hold_tap->status = STATUS_UNDECIDED;
+    hold_tap->config = config;
+    hold_tap->param_hold = param_hold;
+    hold_tap->param_tap = param_tap;
+    hold_tap->timestamp = event->timestamp;
+    hold_tap->position_of_first_other_key_pressed = -1;
+    return hold_tap;
 }
 
 static void clear_hold_tap(struct active_hold_tap *hold_tap) {
+    zmk_behavior_instance_free(&hold_tap_instances, hold_tap - active_hold_taps);
     hold_tap->position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
     hold_tap->status = STATUS_UNDECIDED;
     hold_tap->work_is_cancelled = false;
@@ -294,6 +475,9 @@ static void decide_balanced(struct active_hold_tap *hold_tap, enum decision_mome
     case HT_QUICK_TAP:
         hold_tap->status = STATUS_TAP;
         return;
+    case HT_PREDICTED_HOLD:
+        hold_tap->status = STATUS_HOLD_INTERRUPT;
+        return;
     default:
         return;
     }
@@ -310,6 +494,9 @@ static void decide_tap_preferred(struct active_hold_tap *hold_tap, enum decision
     case HT_QUICK_TAP:
         hold_tap->status = STATUS_TAP;
         return;
+    case HT_PREDICTED_HOLD:
+        hold_tap->status = STATUS_HOLD_INTERRUPT;
+        return;
     default:
         return;
     }
@@ -386,6 +573,8 @@ static inline const char *status_str(enum status status) {
 
 static inline const char *decision_moment_str(enum decision_moment decision_moment) {
     switch (decision_moment) {
+    case HT_KEY_DOWN:
+        return "key-down";
     case HT_KEY_UP:
         return "key-up";
     case HT_OTHER_KEY_DOWN:
@@ -396,6 +585,8 @@ static inline const char *decision_moment_str(enum decision_moment decision_mome
         return "quick-tap";
     case HT_TIMER_EVENT:
         return "timer";
+    case HT_PREDICTED_HOLD:
+        return "predicted-hold";
     default:
         return "UNKNOWN STATUS";
     }
@@ -493,9 +684,16 @@ static int release_binding(struct active_hold_tap *hold_tap) {
 }
 
 static bool is_first_other_key_pressed_trigger_key(struct active_hold_tap *hold_tap) {
-    for (int i = 0; i < hold_tap->config->hold_trigger_key_positions_len; i++) {
-        if (hold_tap->config->hold_trigger_key_positions[i] ==
-            hold_tap->position_of_first_other_key_pressed) {
+    const struct behavior_hold_tap_config *config = hold_tap->config;
+    int32_t position = hold_tap->position_of_first_other_key_pressed;
+
+    if (position >= 0 && position < ZMK_KEYMAP_LEN) {
+        return sys_bitfield_test_bit((mem_addr_t)config->hold_trigger_key_positions_mask, position);
+    }
+
+    // Virtual key positions, such as those of combos, are outside the bitmap
+    for (int i = 0; i < config->hold_trigger_key_positions_len; i++) {
+        if (config->hold_trigger_key_positions[i] == position) {
             return true;
         }
     }
@@ -569,6 +767,12 @@ static void decide_hold_tap(struct active_hold_tap *hold_tap,
     LOG_DBG("%d decided %s (%s decision moment %s)", hold_tap->position,
             status_str(hold_tap->status), flavor_str(hold_tap->config->flavor),
             decision_moment_str(decision_moment));
+    zmk_telemetry_record(hold_tap->status == STATUS_TAP ? ZMK_TELEMETRY_HOLD_TAP_TAP
+                                                        : ZMK_TELEMETRY_HOLD_TAP_HOLD,
+                         decision_moment, MIN(k_uptime_get() - hold_tap->timestamp, UINT16_MAX));
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+    stats_record_decision(hold_tap, decision_moment);
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
     undecided_hold_tap = NULL;
     press_binding(hold_tap);
     release_captured_events();
@@ -581,6 +785,9 @@ static void decide_retro_tap(struct active_hold_tap *hold_tap) {
     if (hold_tap->status == STATUS_HOLD_TIMER) {
         release_binding(hold_tap);
         LOG_DBG("%d retro tap", hold_tap->position);
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+        stats_count(&hold_tap->stats->retro_taps);
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
         hold_tap->status = STATUS_TAP;
         press_binding(hold_tap);
         return;
@@ -588,11 +795,9 @@ static void decide_retro_tap(struct active_hold_tap *hold_tap) {
 }
 
 static void update_hold_status_for_retro_tap(uint32_t ignore_position) {
-    for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
+    ZMK_BEHAVIOR_INSTANCE_FOREACH(&hold_tap_instances, i) {
         struct active_hold_tap *hold_tap = &active_hold_taps[i];
-        if (hold_tap->position == ignore_position ||
-            hold_tap->position == ZMK_BHV_HOLD_TAP_POSITION_NOT_USED ||
-            hold_tap->config->retro_tap == false) {
+        if (hold_tap->position == ignore_position || hold_tap->config->retro_tap == false) {
             continue;
         }
         if (hold_tap->status == STATUS_HOLD_TIMER) {
@@ -626,16 +831,20 @@ static int on_hold_tap_binding_pressed(struct zmk_behavior_binding *binding,
     LOG_DBG("%d new undecided hold_tap", event.position);
     undecided_hold_tap = hold_tap;
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+    hold_tap->stats = &((struct behavior_hold_tap_data *)dev->data)->stats;
+    stats_record_press(hold_tap);
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+
     if (is_quick_tap(hold_tap)) {
         decide_hold_tap(hold_tap, HT_QUICK_TAP);
     }
 
     decide_hold_tap(hold_tap, HT_KEY_DOWN);
 
-    // if this behavior was queued we have to adjust the timer to only
-    // wait for the remaining time.
-    int32_t tapping_term_ms_left = (hold_tap->timestamp + cfg->tapping_term_ms) - k_uptime_get();
-    k_work_schedule(&hold_tap->work, K_MSEC(tapping_term_ms_left));
+    // if this behavior was queued, the deadline is already closer than the full tapping term.
+    zmk_workqueue_deadline_schedule(&hold_tap->deadline,
+                                    hold_tap->timestamp + cfg->tapping_term_ms);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -650,12 +859,23 @@ static int on_hold_tap_binding_released(struct zmk_behavior_binding *binding,
 
     // If these events were queued, the timer event may be queued too late or not at all.
     // We insert a timer event before the TH_KEY_UP event to verify.
-    int work_cancel_result = k_work_cancel_delayable(&hold_tap->work);
+    int work_cancel_result = zmk_workqueue_deadline_cancel(&hold_tap->deadline);
     if (event.timestamp > (hold_tap->timestamp + hold_tap->config->tapping_term_ms)) {
         decide_hold_tap(hold_tap, HT_TIMER_EVENT);
     }
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_PREDICTIVE)
+    bool undecided_before_release = hold_tap->status == STATUS_UNDECIDED;
+#endif
+
     decide_hold_tap(hold_tap, HT_KEY_UP);
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_PREDICTIVE)
+    if (undecided_before_release && hold_tap->status == STATUS_TAP) {
+        store_tap_duration(hold_tap, event.timestamp);
+    }
+#endif
+
     decide_retro_tap(hold_tap);
     release_binding(hold_tap);
 
@@ -744,6 +964,12 @@ static int position_state_changed_listener(const zmk_event_t *eh) {
         undecided_hold_tap->position_of_first_other_key_pressed = ev->position;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+    if (ev->state && undecided_hold_tap->position != ev->position) {
+        stats_record_interrupt(undecided_hold_tap, ev->timestamp);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS)
+
     if (undecided_hold_tap->position == ev->position) {
         if (ev->state) { // keydown
             LOG_ERR("hold-tap listener should be called before before most other listeners!");
@@ -774,13 +1000,28 @@ static int position_state_changed_listener(const zmk_event_t *eh) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
+    if (!reserve_captured_event(eh)) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
     LOG_DBG("%d capturing %d %s event", undecided_hold_tap->position, ev->position,
             ev->state ? "down" : "up");
-    struct captured_event capture = {
-        .tag = ET_POS_CHANGED,
-        .data = {.position = copy_raised_zmk_position_state_changed(ev)},
-    };
-    capture_event(&capture);
+    capture_event(eh);
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_PREDICTIVE)
+    if (ev->state && is_predicted_hold(undecided_hold_tap, ev->timestamp)) {
+        struct active_hold_tap *hold_tap = undecided_hold_tap;
+
+        // Only some flavors act on a prediction, the others still decide on the key press below.
+        // Once decided, releasing the captured events can make one of them the next undecided
+        // hold-tap, which must not then be decided by its own key press.
+        decide_hold_tap(hold_tap, HT_PREDICTED_HOLD);
+        if (hold_tap->status != STATUS_UNDECIDED) {
+            return ZMK_EV_EVENT_CAPTURED;
+        }
+    }
+#endif
+
     decide_hold_tap(undecided_hold_tap, ev->state ? HT_OTHER_KEY_DOWN : HT_OTHER_KEY_UP);
     return ZMK_EV_EVENT_CAPTURED;
 }
@@ -789,10 +1030,6 @@ static int keycode_state_changed_listener(const zmk_event_t *eh) {
     // we want to catch layer-up events too... how?
     struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
 
-    if (ev->state && !is_mod(ev->usage_page, ev->keycode)) {
-        store_last_tapped(ev->timestamp);
-    }
-
     if (undecided_hold_tap == NULL) {
         // LOG_DBG("0x%02X bubble (no undecided hold_tap active)", ev->keycode);
         return ZMK_EV_EVENT_BUBBLE;
@@ -809,13 +1046,15 @@ static int keycode_state_changed_listener(const zmk_event_t *eh) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
+    if (!reserve_captured_event(eh)) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
     // only key-up events will bubble through position_state_changed_listener
     // if a undecided_hold_tap is active.
     LOG_DBG("%d capturing 0x%02X %s event", undecided_hold_tap->position, ev->keycode,
             ev->state ? "down" : "up");
-    struct captured_event capture = {
-        .tag = ET_CODE_CHANGED, .data = {.keycode = copy_raised_zmk_keycode_state_changed(ev)}};
-    capture_event(&capture);
+    capture_event(eh);
     return ZMK_EV_EVENT_CAPTURED;
 }
 
@@ -833,9 +1072,8 @@ ZMK_SUBSCRIPTION(behavior_hold_tap, zmk_position_state_changed);
 // this should be modifiers_state_changed, but unfrotunately that's not implemented yet.
 ZMK_SUBSCRIPTION(behavior_hold_tap, zmk_keycode_state_changed);
 
-void behavior_hold_tap_timer_work_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
-    struct active_hold_tap *hold_tap = CONTAINER_OF(d_work, struct active_hold_tap, work);
+void behavior_hold_tap_timer_work_handler(struct zmk_workqueue_deadline *deadline) {
+    struct active_hold_tap *hold_tap = CONTAINER_OF(deadline, struct active_hold_tap, deadline);
 
     if (hold_tap->work_is_cancelled) {
         clear_hold_tap(hold_tap);
@@ -845,11 +1083,21 @@ void behavior_hold_tap_timer_work_handler(struct k_work *item) {
 }
 
 static int behavior_hold_tap_init(const struct device *dev) {
+    const struct behavior_hold_tap_config *config = dev->config;
     static bool init_first_run = true;
 
+    for (int i = 0; i < config->hold_trigger_key_positions_len; i++) {
+        int32_t position = config->hold_trigger_key_positions[i];
+
+        if (position >= 0 && position < ZMK_KEYMAP_LEN) {
+            sys_bitfield_set_bit((mem_addr_t)config->hold_trigger_key_positions_mask, position);
+        }
+    }
+
     if (init_first_run) {
         for (int i = 0; i < ZMK_BHV_HOLD_TAP_MAX_HELD; i++) {
-            k_work_init_delayable(&active_hold_taps[i].work, behavior_hold_tap_timer_work_handler);
+            zmk_workqueue_deadline_init(&active_hold_taps[i].deadline,
+                                        behavior_hold_tap_timer_work_handler);
             active_hold_taps[i].position = ZMK_BHV_HOLD_TAP_POSITION_NOT_USED;
         }
     }
@@ -858,6 +1106,7 @@ static int behavior_hold_tap_init(const struct device *dev) {
 }
 
 #define KP_INST(n)                                                                                 \
+    static uint32_t behavior_hold_tap_trigger_mask_##n[DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)];          \
     static const struct behavior_hold_tap_config behavior_hold_tap_config_##n = {                  \
         .tapping_term_ms = DT_INST_PROP(n, tapping_term_ms),                                       \
         .hold_behavior_dev = DEVICE_DT_NAME(DT_INST_PHANDLE_BY_IDX(n, bindings, 0)),               \
@@ -871,6 +1120,7 @@ static int behavior_hold_tap_init(const struct device *dev) {
         .hold_while_undecided_linger = DT_INST_PROP(n, hold_while_undecided_linger),               \
         .retro_tap = DT_INST_PROP(n, retro_tap),                                                   \
         .hold_trigger_on_release = DT_INST_PROP(n, hold_trigger_on_release),                       \
+        .hold_trigger_key_positions_mask = behavior_hold_tap_trigger_mask_##n,                     \
         .hold_trigger_key_positions = DT_INST_PROP(n, hold_trigger_key_positions),                 \
         .hold_trigger_key_positions_len = DT_INST_PROP_LEN(n, hold_trigger_key_positions),         \
     };                                                                                             \
@@ -881,4 +1131,79 @@ static int behavior_hold_tap_init(const struct device *dev) {
 
 DT_INST_FOREACH_STATUS_OKAY(KP_INST)
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS_SHELL)
+
+#define HOLD_TAP_DEVICE(n) DEVICE_DT_INST_GET(n),
+
+static const struct device *const hold_tap_devices[] = {
+    DT_INST_FOREACH_STATUS_OKAY(HOLD_TAP_DEVICE)};
+
+static void print_histogram(const struct shell *sh, const char *name, const uint16_t *histogram) {
+    char line[STATS_BUCKETS * 6 + 1];
+    int len = 0;
+
+    for (int i = 0; i < STATS_BUCKETS; i++) {
+        len += snprintf(line + len, sizeof(line) - len, "%6u", histogram[i]);
+    }
+
+    shell_print(sh, "  %-16s%s", name, line);
+}
+
+static int cmd_hold_tap_show(const struct shell *sh, size_t argc, char **argv) {
+    uint16_t bucket_starts[STATS_BUCKETS];
+
+    for (int i = 0; i < STATS_BUCKETS; i++) {
+        bucket_starts[i] = MIN(i * STATS_BUCKET_MS, UINT16_MAX);
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(hold_tap_devices); i++) {
+        const struct device *dev = hold_tap_devices[i];
+        const struct behavior_hold_tap_config *cfg = dev->config;
+        const struct hold_tap_stats *stats = &((struct behavior_hold_tap_data *)dev->data)->stats;
+
+        shell_print(sh, "%s: tapping-term-ms %d, quick-tap-ms %d, %s, %u retro taps", dev->name,
+                    cfg->tapping_term_ms, cfg->quick_tap_ms, flavor_str(cfg->flavor),
+                    stats->retro_taps);
+
+        shell_print(sh, "  %-16s%8s%8s", "decided on", "tap", "hold");
+        for (int m = 0; m < HT_DECISION_MOMENTS; m++) {
+            const uint16_t *counts = stats->decisions[m];
+
+            if (counts[STATS_OUTCOME_TAP] || counts[STATS_OUTCOME_HOLD]) {
+                shell_print(sh, "  %-16s%8u%8u", decision_moment_str(m),
+                            counts[STATS_OUTCOME_TAP], counts[STATS_OUTCOME_HOLD]);
+            }
+        }
+
+        print_histogram(sh, "from (ms)", bucket_starts);
+        print_histogram(sh, "tap decided", stats->decision_ms[STATS_OUTCOME_TAP]);
+        print_histogram(sh, "hold decided", stats->decision_ms[STATS_OUTCOME_HOLD]);
+        print_histogram(sh, "interrupted", stats->interrupt_gap_ms);
+        print_histogram(sh, "re-pressed", stats->repress_gap_ms);
+    }
+
+    return 0;
+}
+
+static int cmd_hold_tap_clear(const struct shell *sh, size_t argc, char **argv) {
+    for (int i = 0; i < ARRAY_SIZE(hold_tap_devices); i++) {
+        struct behavior_hold_tap_data *data = hold_tap_devices[i]->data;
+
+        memset(&data->stats, 0, sizeof(data->stats));
+    }
+
+    shell_print(sh, "Hold-tap statistics cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_hold_tap,
+    SHELL_CMD(show, NULL, "Print the decision statistics of each hold-tap", cmd_hold_tap_show),
+    SHELL_CMD(clear, NULL, "Reset the decision statistics", cmd_hold_tap_clear),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(hold_tap, &sub_hold_tap, "Hold-tap decision statistics", NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_HOLD_TAP_STATS_SHELL)
+
 #endif /* DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT) */
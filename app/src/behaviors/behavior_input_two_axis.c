@@ -17,17 +17,23 @@
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 #include <zmk/pointing/resolution_multipliers.h>
+#include <zmk/workqueue.h>
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+// Speeds and movement are calculated in fixed point, with this many fractional bits.
+#define FRACTION_BITS 16
+#define FRACTION_ONE (1 << FRACTION_BITS)
+
 struct vector2d {
-    float x;
-    float y;
+    int32_t x;
+    int32_t y;
 };
 
 struct movement_state_1d {
-    float remainder;
+    // Fraction of a unit of movement carried over to the next tick, in fixed point.
+    int32_t remainder;
     int16_t speed;
     int64_t start_time;
 };
@@ -38,10 +44,12 @@ struct movement_state_2d {
 };
 
 struct behavior_input_two_axis_data {
-    struct k_work_delayable tick_work;
     const struct device *dev;
 
     struct movement_state_2d state;
+    bool ticking;
+    // Uptime, in ticks, at which the shared tick next moves this instance.
+    int64_t next_tick;
 };
 
 struct behavior_input_two_axis_config {
@@ -56,19 +64,6 @@ struct behavior_input_two_axis_config {
     uint8_t acceleration_exponent;
 };
 
-#if CONFIG_MINIMAL_LIBC
-static float powf(float base, float exponent) {
-    // poor man's power implementation rounds the exponent down to the nearest integer.
-    float power = 1.0f;
-    for (; exponent >= 1.0f; exponent--) {
-        power = power * base;
-    }
-    return power;
-}
-#else
-#include <math.h>
-#endif
-
 static int64_t ticks_since_start(int64_t start, int64_t now, int64_t delay) {
     if (start == 0) {
         return 0;
@@ -108,13 +103,17 @@ static inline uint8_t get_acceleration_exponent(const struct behavior_input_two_
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
-static float speed(const struct behavior_input_two_axis_config *config, uint16_t code,
-                   float max_speed, int64_t duration_ticks) {
+/**
+ * Calculate the speed, in fixed point, for the time since the movement started.
+ */
+static int64_t speed(const struct behavior_input_two_axis_config *config, uint16_t code,
+                     int16_t max_speed, int64_t duration_ticks) {
     uint8_t accel_exp = get_acceleration_exponent(config, code);
+    int64_t duration_ms = 1000 * duration_ticks / CONFIG_SYS_CLOCK_TICKS_PER_SEC;
 
-    if ((1000 * duration_ticks / CONFIG_SYS_CLOCK_TICKS_PER_SEC) > config->time_to_max_speed_ms ||
-        config->time_to_max_speed_ms == 0 || accel_exp == 0) {
-        return max_speed;
+    if (duration_ms > config->time_to_max_speed_ms || config->time_to_max_speed_ms == 0 ||
+        accel_exp == 0) {
+        return (int64_t)max_speed * FRACTION_ONE;
     }
 
     // Calculate the speed based on MouseKeysAccel
@@ -123,35 +122,42 @@ static float speed(const struct behavior_input_two_axis_config *config, uint16_t
         return 0;
     }
 
-    float time_fraction = (float)(1000 * duration_ticks / CONFIG_SYS_CLOCK_TICKS_PER_SEC) /
-                          config->time_to_max_speed_ms;
-    return max_speed * powf(time_fraction, accel_exp);
+    // The exponent is an integer, so the power of the time fraction is a few fixed point
+    // multiplies, with no need for floating point.
+    int64_t time_fraction = (duration_ms * FRACTION_ONE) / config->time_to_max_speed_ms;
+    int64_t power = FRACTION_ONE;
+    for (uint8_t i = 0; i < accel_exp; i++) {
+        power = (power * time_fraction) >> FRACTION_BITS;
+    }
+
+    return max_speed * power;
 }
 
-static void track_remainder(float *move, float *remainder) {
-    float new_move = *move + *remainder;
-    *remainder = new_move - (int)new_move;
-    *move = (int)new_move;
+static int32_t track_remainder(int64_t move, int32_t *remainder) {
+    int64_t new_move = move + *remainder;
+    int32_t whole = new_move / FRACTION_ONE;
+
+    *remainder = new_move - ((int64_t)whole * FRACTION_ONE);
+    return whole;
 }
 
-static float update_movement_1d(const struct behavior_input_two_axis_config *config, uint16_t code,
-                                struct movement_state_1d *state, int64_t now) {
-    float move = 0;
+static int32_t update_movement_1d(const struct behavior_input_two_axis_config *config,
+                                  uint16_t code, struct movement_state_1d *state, int64_t now) {
     if (state->speed == 0) {
         state->remainder = 0;
-        return move;
+        return 0;
     }
 
     int64_t move_duration = ticks_since_start(state->start_time, now, config->delay_ms);
-    LOG_DBG("Calculated speed: %f", speed(config, code, state->speed, move_duration));
-    move =
-        (move_duration > 0)
-            ? (speed(config, code, state->speed, move_duration) * config->trigger_period_ms / 1000)
-            : 0;
+    int64_t move = 0;
+    if (move_duration > 0) {
+        int64_t current_speed = speed(config, code, state->speed, move_duration);
 
-    track_remainder(&(move), &(state->remainder));
+        LOG_DBG("Calculated speed: %lld/%d", current_speed, FRACTION_ONE);
+        move = current_speed * config->trigger_period_ms / 1000;
+    }
 
-    return move;
+    return track_remainder(move, &state->remainder);
 }
 static struct vector2d update_movement_2d(const struct behavior_input_two_axis_config *config,
                                           struct movement_state_2d *state, int64_t now) {
@@ -175,35 +181,92 @@ static bool should_be_working(struct behavior_input_two_axis_data *data) {
     return is_non_zero_2d_movement(&data->state);
 }
 
-static void tick_work_cb(struct k_work *work) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
-    struct behavior_input_two_axis_data *data =
-        CONTAINER_OF(d_work, struct behavior_input_two_axis_data, tick_work);
-    const struct device *dev = data->dev;
+static void tick_instance(const struct device *dev, int64_t now) {
+    struct behavior_input_two_axis_data *data = dev->data;
     const struct behavior_input_two_axis_config *cfg = dev->config;
 
-    uint64_t timestamp = k_uptime_ticks();
-
     // LOG_INF("x start: %llu, y start: %llu, current timestamp: %llu", data->state.x.start_time,
-    //         data->state.y.start_time, timestamp);
+    //         data->state.y.start_time, now);
 
-    struct vector2d move = update_movement_2d(cfg, &data->state, timestamp);
+    struct vector2d move = update_movement_2d(cfg, &data->state, now);
 
     int ret = 0;
-    bool have_x = is_non_zero_1d_movement(move.x);
-    bool have_y = is_non_zero_1d_movement(move.y);
+    int16_t move_x = CLAMP(move.x, INT16_MIN, INT16_MAX);
+    int16_t move_y = CLAMP(move.y, INT16_MIN, INT16_MAX);
+    bool have_x = is_non_zero_1d_movement(move_x);
+    bool have_y = is_non_zero_1d_movement(move_y);
     if (have_x) {
-        ret = input_report_rel(dev, cfg->x_code, (int16_t)CLAMP(move.x, INT16_MIN, INT16_MAX),
-                               !have_y, K_NO_WAIT);
+        ret = input_report_rel(dev, cfg->x_code, move_x, !have_y, K_NO_WAIT);
     }
     if (have_y) {
-        ret = input_report_rel(dev, cfg->y_code, (int16_t)CLAMP(move.y, INT16_MIN, INT16_MAX), true,
-                               K_NO_WAIT);
+        ret = input_report_rel(dev, cfg->y_code, move_y, true, K_NO_WAIT);
     }
 
-    if (should_be_working(data)) {
-        k_work_schedule(&data->tick_work, K_MSEC(cfg->trigger_period_ms));
+    data->next_tick = now + k_ms_to_ticks_ceil64(cfg->trigger_period_ms);
+}
+
+// All instances are moved by one tick, so instances active at the same time, like mouse key
+// movement and scrolling, report together and the listener can send their motion in one report.
+#define ITA_DEVICE(n) DEVICE_DT_INST_GET(n),
+
+static const struct device *const instances[] = {DT_INST_FOREACH_STATUS_OKAY(ITA_DEVICE)};
+
+static void tick_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(tick_work, tick_work_cb);
+
+static void schedule_tick(int64_t now) {
+    bool any_ticking = false;
+    int64_t next_tick = INT64_MAX;
+
+    for (int i = 0; i < ARRAY_SIZE(instances); i++) {
+        const struct behavior_input_two_axis_data *data = instances[i]->data;
+
+        if (data->ticking) {
+            any_ticking = true;
+            next_tick = MIN(next_tick, data->next_tick);
+        }
+    }
+
+    if (any_ticking) {
+        k_work_reschedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &tick_work,
+                                    K_TICKS(MAX(next_tick - now, 0)));
+    } else {
+        k_work_cancel_delayable(&tick_work);
+    }
+}
+
+static void tick_work_cb(struct k_work *work) {
+    int64_t now = k_uptime_ticks();
+
+    for (int i = 0; i < ARRAY_SIZE(instances); i++) {
+        struct behavior_input_two_axis_data *data = instances[i]->data;
+
+        if (data->ticking && data->next_tick <= now) {
+            tick_instance(instances[i], now);
+        }
     }
+
+    schedule_tick(now);
+}
+
+/**
+ * Get the first tick of an instance starting to move: one period from now, or earlier to join the
+ * next tick of another moving instance if that comes within the period.
+ */
+static int64_t first_tick(const struct device *dev, int64_t now) {
+    const struct behavior_input_two_axis_config *cfg = dev->config;
+    int64_t tick = now + k_ms_to_ticks_ceil64(cfg->trigger_period_ms);
+
+    for (int i = 0; i < ARRAY_SIZE(instances); i++) {
+        const struct behavior_input_two_axis_data *other = instances[i]->data;
+
+        if (instances[i] != dev && other->ticking && other->next_tick >= now) {
+            tick = MIN(tick, other->next_tick);
+        }
+    }
+
+    return tick;
 }
 
 static void set_start_times_for_activity_1d(struct movement_state_1d *state) {
@@ -220,17 +283,22 @@ static void set_start_times_for_activity(struct movement_state_2d *state) {
 
 static void update_work_scheduling(const struct device *dev) {
     struct behavior_input_two_axis_data *data = dev->data;
-    const struct behavior_input_two_axis_config *cfg = dev->config;
+    int64_t now = k_uptime_ticks();
 
     set_start_times_for_activity(&data->state);
 
     if (should_be_working(data)) {
-        k_work_schedule(&data->tick_work, K_MSEC(cfg->trigger_period_ms));
+        if (!data->ticking) {
+            data->next_tick = first_tick(dev, now);
+            data->ticking = true;
+        }
     } else {
-        k_work_cancel_delayable(&data->tick_work);
+        data->ticking = false;
         data->state.y.remainder = 0;
         data->state.x.remainder = 0;
     }
+
+    schedule_tick(now);
 }
 
 int behavior_input_two_axis_adjust_speed(const struct device *dev, int16_t dx, int16_t dy) {
@@ -251,7 +319,6 @@ static int behavior_input_two_axis_init(const struct device *dev) {
     struct behavior_input_two_axis_data *data = dev->data;
 
     data->dev = dev;
-    k_work_init_delayable(&data->tick_work, tick_work_cb);
 
     return 0;
 };
@@ -19,6 +19,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
+// Distinct usage pages repeated by all instances together. ZMK only sends keyboard and consumer
+// usages, so this leaves room for a couple more.
+#define MAX_REPEATED_USAGE_PAGES 4
+
 struct behavior_key_repeat_config {
     uint8_t index;
     uint8_t usage_pages_count;
@@ -26,21 +30,48 @@ struct behavior_key_repeat_config {
 };
 
 struct behavior_key_repeat_data {
-    struct zmk_keycode_state_changed last_keycode_pressed;
+    // Bit n is set if the instance repeats the usage page of last_keycodes[n]
+    uint8_t page_mask;
     struct zmk_keycode_state_changed current_keycode_pressed;
 };
 
+// The last keycode pressed on each usage page any instance repeats, shared by all instances so
+// each press is captured once however many there are. The sequence numbers tell which of the
+// pages an instance repeats was pressed last.
+static struct {
+    uint16_t usage_page;
+    uint32_t seq;
+    struct zmk_keycode_state_changed ev;
+} last_keycodes[MAX_REPEATED_USAGE_PAGES];
+
+static uint8_t last_keycodes_len;
+static uint32_t last_keycode_seq;
+
+static const struct zmk_keycode_state_changed *last_keycode_for(uint8_t page_mask) {
+    const struct zmk_keycode_state_changed *last = NULL;
+    uint32_t last_seq = 0;
+
+    for (int i = 0; i < last_keycodes_len; i++) {
+        if ((page_mask & BIT(i)) && last_keycodes[i].seq > last_seq) {
+            last = &last_keycodes[i].ev;
+            last_seq = last_keycodes[i].seq;
+        }
+    }
+
+    return last;
+}
+
 static int on_key_repeat_binding_pressed(struct zmk_behavior_binding *binding,
                                          struct zmk_behavior_binding_event event) {
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
     struct behavior_key_repeat_data *data = dev->data;
+    const struct zmk_keycode_state_changed *last = last_keycode_for(data->page_mask);
 
-    if (data->last_keycode_pressed.usage_page == 0) {
+    if (!last) {
         return ZMK_BEHAVIOR_OPAQUE;
     }
 
-    memcpy(&data->current_keycode_pressed, &data->last_keycode_pressed,
-           sizeof(struct zmk_keycode_state_changed));
+    data->current_keycode_pressed = *last;
     data->current_keycode_pressed.timestamp = k_uptime_get();
 
     raise_zmk_keycode_state_changed(data->current_keycode_pressed);
@@ -77,31 +108,49 @@ static int key_repeat_keycode_state_changed_listener(const zmk_event_t *eh);
 ZMK_LISTENER(behavior_key_repeat, key_repeat_keycode_state_changed_listener);
 ZMK_SUBSCRIPTION(behavior_key_repeat, zmk_keycode_state_changed);
 
-#define GET_DEV(inst) DEVICE_DT_INST_GET(inst),
-static const struct device *devs[] = {DT_INST_FOREACH_STATUS_OKAY(GET_DEV)};
-
 static int key_repeat_keycode_state_changed_listener(const zmk_event_t *eh) {
     struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
     if (ev == NULL || !ev->state) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
-    for (int i = 0; i < ARRAY_SIZE(devs); i++) {
-        const struct device *dev = devs[i];
+    for (int i = 0; i < last_keycodes_len; i++) {
+        if (last_keycodes[i].usage_page == ev->usage_page) {
+            last_keycodes[i].ev = *ev;
+            last_keycodes[i].ev.implicit_modifiers |= zmk_hid_get_explicit_mods();
+            last_keycodes[i].seq = ++last_keycode_seq;
+            break;
+        }
+    }
 
-        struct behavior_key_repeat_data *data = dev->data;
-        const struct behavior_key_repeat_config *config = dev->config;
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+static int behavior_key_repeat_init(const struct device *dev) {
+    const struct behavior_key_repeat_config *config = dev->config;
+    struct behavior_key_repeat_data *data = dev->data;
 
-        for (int u = 0; u < config->usage_pages_count; u++) {
-            if (config->usage_pages[u] == ev->usage_page) {
-                memcpy(&data->last_keycode_pressed, ev, sizeof(struct zmk_keycode_state_changed));
-                data->last_keycode_pressed.implicit_modifiers |= zmk_hid_get_explicit_mods();
-                break;
+    for (int u = 0; u < config->usage_pages_count; u++) {
+        int i = 0;
+
+        while (i < last_keycodes_len && last_keycodes[i].usage_page != config->usage_pages[u]) {
+            i++;
+        }
+
+        if (i == last_keycodes_len) {
+            if (last_keycodes_len == MAX_REPEATED_USAGE_PAGES) {
+                LOG_ERR("Key repeat supports at most %d distinct usage pages",
+                        MAX_REPEATED_USAGE_PAGES);
+                return -ENOMEM;
             }
+
+            last_keycodes[last_keycodes_len++].usage_page = config->usage_pages[u];
         }
+
+        data->page_mask |= BIT(i);
     }
 
-    return ZMK_EV_EVENT_BUBBLE;
+    return 0;
 }
 
 #define KR_INST(n)                                                                                 \
@@ -110,7 +159,7 @@ static int key_repeat_keycode_state_changed_listener(const zmk_event_t *eh) {
         .usage_pages = DT_INST_PROP(n, usage_pages),                                               \
         .usage_pages_count = DT_INST_PROP_LEN(n, usage_pages),                                     \
     };                                                                                             \
-    BEHAVIOR_DT_INST_DEFINE(n, NULL, NULL, &behavior_key_repeat_data_##n,                          \
+    BEHAVIOR_DT_INST_DEFINE(n, behavior_key_repeat_init, NULL, &behavior_key_repeat_data_##n,      \
                             &behavior_key_repeat_config_##n, POST_KERNEL,                          \
                             CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_key_repeat_driver_api);
 
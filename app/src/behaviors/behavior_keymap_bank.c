@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_keymap_bank
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+#include <zmk/workqueue.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+static uint8_t requested_bank;
+
+// Switching banks writes and reads settings, so it's done from the system work queue rather than
+// while the key press is being handled.
+static void select_bank_cb(struct k_work *work) {
+    int err = zmk_keymap_select_bank(requested_bank);
+    if (err < 0) {
+        LOG_ERR("Failed to switch to keymap bank %d (%d)", requested_bank, err);
+    }
+}
+
+static K_WORK_DEFINE(select_bank_work, select_bank_cb);
+
+static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
+                                     struct zmk_behavior_binding_event event) {
+    if (binding->param1 >= CONFIG_ZMK_KEYMAP_BANKS) {
+        LOG_ERR("Keymap bank %d is out of range", binding->param1);
+        return -EINVAL;
+    }
+
+    requested_bank = binding->param1;
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &select_bank_work);
+
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+static const struct behavior_parameter_value_metadata param_values[] = {
+    {
+        .display_name = "Bank",
+        .type = BEHAVIOR_PARAMETER_VALUE_TYPE_RANGE,
+        .range = {.min = 0, .max = CONFIG_ZMK_KEYMAP_BANKS - 1},
+    },
+};
+
+static const struct behavior_parameter_metadata_set param_metadata_set[] = {{
+    .param1_values = param_values,
+    .param1_values_len = ARRAY_SIZE(param_values),
+}};
+
+static const struct behavior_parameter_metadata metadata = {
+    .sets_len = ARRAY_SIZE(param_metadata_set),
+    .sets = param_metadata_set,
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+static const struct behavior_driver_api behavior_keymap_bank_driver_api = {
+    .binding_pressed = on_keymap_binding_pressed,
+    .binding_released = on_keymap_binding_released,
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+    .parameter_metadata = &metadata,
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+};
+
+BEHAVIOR_DT_INST_DEFINE(0, NULL, NULL, NULL, NULL, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+                        &behavior_keymap_bank_driver_api);
+
+#endif /* DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT) */
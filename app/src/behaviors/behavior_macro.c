@@ -10,16 +10,21 @@
 #include <zmk/behavior.h>
 #include <zmk/behavior_queue.h>
 #include <zmk/keymap.h>
+#include <zmk/keys.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 enum behavior_macro_mode {
-    MACRO_MODE_TAP,
-    MACRO_MODE_PRESS,
-    MACRO_MODE_RELEASE,
+    MACRO_MODE_TAP = ZMK_BEHAVIOR_QUEUE_STEP_TAP,
+    MACRO_MODE_PRESS = ZMK_BEHAVIOR_QUEUE_STEP_PRESS,
+    MACRO_MODE_RELEASE = ZMK_BEHAVIOR_QUEUE_STEP_RELEASE,
 };
 
-enum param_source { PARAM_SOURCE_BINDING, PARAM_SOURCE_MACRO_1ST, PARAM_SOURCE_MACRO_2ND };
+enum param_source {
+    PARAM_SOURCE_BINDING = ZMK_BEHAVIOR_QUEUE_PARAM_BINDING,
+    PARAM_SOURCE_MACRO_1ST = ZMK_BEHAVIOR_QUEUE_PARAM_SEQUENCE_1ST,
+    PARAM_SOURCE_MACRO_2ND = ZMK_BEHAVIOR_QUEUE_PARAM_SEQUENCE_2ND,
+};
 
 struct behavior_macro_trigger_state {
     uint32_t wait_ms;
@@ -32,18 +37,20 @@ struct behavior_macro_trigger_state {
 };
 
 struct behavior_macro_state {
-    struct behavior_macro_trigger_state release_state;
-
 #if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
     struct behavior_parameter_metadata_set set;
 #endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
 
-    uint32_t press_bindings_count;
+    // The bindings compiled at init, the steps for the press followed by those for the release.
+    struct zmk_behavior_queue_step *steps;
+    uint16_t press_steps_count;
+    uint16_t release_steps_count;
 };
 
 struct behavior_macro_config {
     uint32_t default_wait_ms;
     uint32_t default_tap_ms;
+    bool burst;
     uint32_t count;
     struct zmk_behavior_binding bindings[];
 };
@@ -61,6 +68,10 @@ struct behavior_macro_config {
 #define P2TO1 DEVICE_DT_NAME(DT_INST(0, zmk_macro_param_2to1))
 #define P2TO2 DEVICE_DT_NAME(DT_INST(0, zmk_macro_param_2to2))
 
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_key_press)
+#define KEY_PRESS DEVICE_DT_NAME(DT_INST(0, zmk_behavior_key_press))
+#endif
+
 #define ZM_IS_NODE_MATCH(a, b) (strcmp(a, b) == 0)
 #define IS_TAP_MODE(dev) ZM_IS_NODE_MATCH(dev, TAP_MODE)
 #define IS_PRESS_MODE(dev) ZM_IS_NODE_MATCH(dev, PRESS_MODE)
@@ -111,94 +122,149 @@ static bool handle_control_binding(struct behavior_macro_trigger_state *state,
     return true;
 }
 
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_key_press)
+
+// Whether a step is a tap of a plain key, which can overlap the taps next to it without changing
+// what the host types. Modifiers, keys with implicit modifiers and keys taking a macro parameter
+// would change or hide what the neighbouring keys type.
+static bool is_burst_step(const struct zmk_behavior_queue_step *step) {
+    if (step->op != ZMK_BEHAVIOR_QUEUE_STEP_TAP || step->param1_source != PARAM_SOURCE_BINDING ||
+        !ZM_IS_NODE_MATCH(step->binding.behavior_dev, KEY_PRESS)) {
+        return false;
+    }
+
+    const uint32_t encoded = step->binding.param1;
+    const uint8_t page = ZMK_HID_USAGE_PAGE(encoded) ?: HID_USAGE_KEY;
+
+    return page == HID_USAGE_KEY && SELECT_MODS(encoded) == 0 &&
+           !is_mod(page, ZMK_HID_USAGE_ID(encoded));
+}
+
+#else
+
+static bool is_burst_step(const struct zmk_behavior_queue_step *step) { return false; }
+
+#endif
+
+// Write a tap as a press and a release step, rolling it over the tap before when both are plain
+// keys: the next key is pressed before the previous one is released, so each key of a run only
+// takes its tap time instead of its tap and wait times. A repeated key needs a release in between
+// to be typed twice, so it starts a new run. Returns the number of steps now written.
+static uint16_t add_burst_step(struct zmk_behavior_queue_step *steps, uint16_t count,
+                               const struct zmk_behavior_queue_step *step, bool *in_run) {
+    if (!is_burst_step(step)) {
+        *in_run = false;
+        steps[count] = *step;
+        return count + 1;
+    }
+
+    struct zmk_behavior_queue_step press = *step;
+    struct zmk_behavior_queue_step release = *step;
+
+    press.op = ZMK_BEHAVIOR_QUEUE_STEP_PRESS;
+    release.op = ZMK_BEHAVIOR_QUEUE_STEP_RELEASE;
+
+    if (*in_run && steps[count - 1].binding.param1 != step->binding.param1) {
+        struct zmk_behavior_queue_step previous = steps[count - 1];
+
+        press.wait_ms = 0;
+        previous.wait_ms = step->tap_ms;
+        steps[count - 1] = press;
+        steps[count++] = previous;
+    } else {
+        press.wait_ms = step->tap_ms;
+        steps[count++] = press;
+    }
+
+    steps[count++] = release;
+    *in_run = true;
+    return count;
+}
+
+// Turn the bindings covered by the trigger state into steps for the behavior queue. Control
+// bindings are applied to the steps that follow them, so nothing is left to interpret when the
+// macro runs. Returns the number of steps written.
+static uint16_t compile_macro(struct behavior_macro_trigger_state state,
+                              const struct zmk_behavior_binding bindings[], bool burst,
+                              struct zmk_behavior_queue_step *steps) {
+    uint16_t count = 0;
+    bool in_run = false;
+
+    for (int i = state.start_index; i < state.start_index + state.count; i++) {
+        if (handle_control_binding(&state, &bindings[i])) {
+            continue;
+        }
+
+        const struct zmk_behavior_queue_step step = {
+            .binding = bindings[i],
+            .tap_ms = state.tap_ms,
+            .wait_ms = state.wait_ms,
+            .op = state.mode,
+            .param1_source = state.param1_source,
+            .param2_source = state.param2_source,
+        };
+
+        if (burst) {
+            count = add_burst_step(steps, count, &step, &in_run);
+        } else {
+            steps[count++] = step;
+        }
+
+        state.param1_source = PARAM_SOURCE_BINDING;
+        state.param2_source = PARAM_SOURCE_BINDING;
+    }
+
+    return count;
+}
+
 static int behavior_macro_init(const struct device *dev) {
     const struct behavior_macro_config *cfg = dev->config;
     struct behavior_macro_state *state = dev->data;
-    state->press_bindings_count = cfg->count;
-    state->release_state.start_index = cfg->count;
-    state->release_state.count = 0;
+    uint32_t press_bindings_count = cfg->count;
+    struct behavior_macro_trigger_state release_state = {.start_index = cfg->count};
 
     LOG_DBG("Precalculate initial release state:");
     for (int i = 0; i < cfg->count; i++) {
-        if (handle_control_binding(&state->release_state, &cfg->bindings[i])) {
+        if (handle_control_binding(&release_state, &cfg->bindings[i])) {
             // Updated state used for initial state on release.
         } else if (IS_PAUSE(cfg->bindings[i].behavior_dev)) {
-            state->release_state.start_index = i + 1;
-            state->release_state.count = cfg->count - state->release_state.start_index;
-            state->press_bindings_count = i;
-            LOG_DBG("Release will resume at %d", state->release_state.start_index);
+            release_state.start_index = i + 1;
+            release_state.count = cfg->count - release_state.start_index;
+            press_bindings_count = i;
+            LOG_DBG("Release will resume at %d", release_state.start_index);
             break;
         } else {
             // Ignore regular invokable bindings
         }
     }
 
-    return 0;
-};
-
-static uint32_t select_param(enum param_source param_source, uint32_t source_binding,
-                             const struct zmk_behavior_binding *macro_binding) {
-    switch (param_source) {
-    case PARAM_SOURCE_MACRO_1ST:
-        return macro_binding->param1;
-    case PARAM_SOURCE_MACRO_2ND:
-        return macro_binding->param2;
-    default:
-        return source_binding;
-    }
-};
+    struct behavior_macro_trigger_state press_state = {.mode = MACRO_MODE_TAP,
+                                                       .tap_ms = cfg->default_tap_ms,
+                                                       .wait_ms = cfg->default_wait_ms,
+                                                       .start_index = 0,
+                                                       .count = press_bindings_count};
 
-static void replace_params(struct behavior_macro_trigger_state *state,
-                           struct zmk_behavior_binding *binding,
-                           const struct zmk_behavior_binding *macro_binding) {
-    binding->param1 = select_param(state->param1_source, binding->param1, macro_binding);
-    binding->param2 = select_param(state->param2_source, binding->param2, macro_binding);
+    state->press_steps_count = compile_macro(press_state, cfg->bindings, cfg->burst, state->steps);
+    state->release_steps_count = compile_macro(release_state, cfg->bindings, cfg->burst,
+                                               &state->steps[state->press_steps_count]);
 
-    state->param1_source = PARAM_SOURCE_BINDING;
-    state->param2_source = PARAM_SOURCE_BINDING;
-}
+    return 0;
+};
 
 static void queue_macro(struct zmk_behavior_binding_event *event,
-                        const struct zmk_behavior_binding bindings[],
-                        struct behavior_macro_trigger_state state,
+                        const struct zmk_behavior_queue_step *steps, uint16_t steps_count,
                         const struct zmk_behavior_binding *macro_binding) {
-    LOG_DBG("Iterating macro bindings - starting: %d, count: %d", state.start_index, state.count);
-    for (int i = state.start_index; i < state.start_index + state.count; i++) {
-        if (!handle_control_binding(&state, &bindings[i])) {
-            struct zmk_behavior_binding binding = bindings[i];
-            replace_params(&state, &binding, macro_binding);
-
-            switch (state.mode) {
-            case MACRO_MODE_TAP:
-                zmk_behavior_queue_add(event, binding, true, state.tap_ms);
-                zmk_behavior_queue_add(event, binding, false, state.wait_ms);
-                break;
-            case MACRO_MODE_PRESS:
-                zmk_behavior_queue_add(event, binding, true, state.wait_ms);
-                break;
-            case MACRO_MODE_RELEASE:
-                zmk_behavior_queue_add(event, binding, false, state.wait_ms);
-                break;
-            default:
-                LOG_ERR("Unknown macro mode: %d", state.mode);
-                break;
-            }
-        }
-    }
+    LOG_DBG("Queueing macro steps - count: %d", steps_count);
+    zmk_behavior_queue_add_steps(event, steps, steps_count, macro_binding->param1,
+                                 macro_binding->param2);
 }
 
 static int on_macro_binding_pressed(struct zmk_behavior_binding *binding,
                                     struct zmk_behavior_binding_event event) {
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
-    const struct behavior_macro_config *cfg = dev->config;
     struct behavior_macro_state *state = dev->data;
-    struct behavior_macro_trigger_state trigger_state = {.mode = MACRO_MODE_TAP,
-                                                         .tap_ms = cfg->default_tap_ms,
-                                                         .wait_ms = cfg->default_wait_ms,
-                                                         .start_index = 0,
-                                                         .count = state->press_bindings_count};
 
-    queue_macro(&event, cfg->bindings, trigger_state, binding);
+    queue_macro(&event, state->steps, state->press_steps_count, binding);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -206,10 +272,10 @@ static int on_macro_binding_pressed(struct zmk_behavior_binding *binding,
 static int on_macro_binding_released(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
-    const struct behavior_macro_config *cfg = dev->config;
     struct behavior_macro_state *state = dev->data;
 
-    queue_macro(&event, cfg->bindings, state->release_state, binding);
+    queue_macro(&event, &state->steps[state->press_steps_count], state->release_steps_count,
+                binding);
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -313,11 +379,17 @@ static const struct behavior_driver_api behavior_macro_driver_api = {
 #define TRANSFORMED_BEHAVIORS(n)                                                                   \
     {LISTIFY(DT_PROP_LEN(n, bindings), ZMK_KEYMAP_EXTRACT_BINDING, (, ), n)},
 
+// Burst macros write each tap as a separate press and release step.
+#define MACRO_STEPS_LEN(inst) (DT_PROP_LEN(inst, bindings) * (DT_PROP(inst, burst) ? 2 : 1))
+
 #define MACRO_INST(inst)                                                                           \
-    static struct behavior_macro_state behavior_macro_state_##inst = {};                           \
+    static struct zmk_behavior_queue_step behavior_macro_steps_##inst[MACRO_STEPS_LEN(inst)];      \
+    static struct behavior_macro_state behavior_macro_state_##inst = {                             \
+        .steps = behavior_macro_steps_##inst};                                                     \
     static struct behavior_macro_config behavior_macro_config_##inst = {                           \
         .default_wait_ms = DT_PROP_OR(inst, wait_ms, CONFIG_ZMK_MACRO_DEFAULT_WAIT_MS),            \
         .default_tap_ms = DT_PROP_OR(inst, tap_ms, CONFIG_ZMK_MACRO_DEFAULT_TAP_MS),               \
+        .burst = DT_PROP(inst, burst),                                                             \
         .count = DT_PROP_LEN(inst, bindings),                                                      \
         .bindings = TRANSFORMED_BEHAVIORS(inst)};                                                  \
     BEHAVIOR_DT_DEFINE(inst, behavior_macro_init, NULL, &behavior_macro_state_##inst,              \
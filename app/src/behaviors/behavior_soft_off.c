@@ -17,6 +17,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 struct behavior_soft_off_config {
     bool split_peripheral_turn_off_on_press;
+    bool retain_state;
     uint32_t hold_time_ms;
 };
 
@@ -27,6 +28,17 @@ struct behavior_soft_off_data {
 #define IS_SPLIT_PERIPHERAL                                                                        \
     (IS_ENABLED(CONFIG_ZMK_SPLIT) && !IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL))
 
+static void soft_off(const struct behavior_soft_off_config *config) {
+#if IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+    if (config->retain_state) {
+        zmk_pm_soft_suspend();
+        return;
+    }
+#endif
+
+    zmk_pm_soft_off();
+}
+
 static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
                                      struct zmk_behavior_binding_event event) {
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
@@ -34,7 +46,7 @@ static int on_keymap_binding_pressed(struct zmk_behavior_binding *binding,
     const struct behavior_soft_off_config *config = dev->config;
 
     if (IS_SPLIT_PERIPHERAL && config->split_peripheral_turn_off_on_press) {
-        zmk_pm_soft_off();
+        soft_off(config);
     } else {
         data->press_start = k_uptime_get();
     }
@@ -50,7 +62,7 @@ static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
 
     if (config->hold_time_ms == 0) {
         LOG_DBG("No hold time set, triggering soft off");
-        zmk_pm_soft_off();
+        soft_off(config);
     } else {
         uint32_t hold_time = k_uptime_get() - data->press_start;
 
@@ -58,7 +70,7 @@ static int on_keymap_binding_released(struct zmk_behavior_binding *binding,
             if (IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)) {
                 k_sleep(K_MSEC(100));
             }
-            zmk_pm_soft_off();
+            soft_off(config);
         } else {
             LOG_INF("Not triggering soft off: held for %d and hold time is %d", hold_time,
                     config->hold_time_ms);
@@ -82,6 +94,7 @@ static const struct behavior_driver_api behavior_soft_off_driver_api = {
         .hold_time_ms = DT_INST_PROP_OR(n, hold_time_ms, 0),                                       \
         .split_peripheral_turn_off_on_press =                                                      \
             DT_INST_PROP_OR(n, split_peripheral_off_on_press, false),                              \
+        .retain_state = DT_INST_PROP(n, retain_state),                                             \
     };                                                                                             \
     static struct behavior_soft_off_data bso_data_##n = {};                                        \
     BEHAVIOR_DT_INST_DEFINE(n, NULL, NULL, &bso_data_##n, &bso_config_##n, POST_KERNEL,            \
@@ -19,6 +19,7 @@
 #include <zmk/events/modifiers_state_changed.h>
 #include <zmk/hid.h>
 #include <zmk/keymap.h>
+#include <zmk/workqueue.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -49,7 +50,7 @@ struct active_sticky_key {
     bool timer_started;
     bool timer_cancelled;
     int64_t release_at;
-    struct k_work_delayable release_timer;
+    struct zmk_workqueue_deadline release_timer;
     // usage page and keycode for the key that is being modified by this sticky key
     uint8_t modified_key_usage_page;
     uint32_t modified_key_keycode;
@@ -57,6 +58,19 @@ struct active_sticky_key {
 
 struct active_sticky_key active_sticky_keys[ZMK_BHV_STICKY_KEY_MAX_HELD] = {};
 
+// Bit i is set while active_sticky_keys[i] is in use, so the keycode listener can return right
+// away when no sticky key is armed.
+static uint32_t armed_sticky_keys[DIV_ROUND_UP(ZMK_BHV_STICKY_KEY_MAX_HELD, 32)] = {};
+
+static bool any_sticky_key_armed(void) {
+    for (int i = 0; i < ARRAY_SIZE(armed_sticky_keys); i++) {
+        if (armed_sticky_keys[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static struct active_sticky_key *store_sticky_key(struct zmk_behavior_binding_event *event,
                                                   uint32_t param1,
                                                   const struct behavior_sticky_key_config *config) {
@@ -77,6 +91,7 @@ static struct active_sticky_key *store_sticky_key(struct zmk_behavior_binding_ev
         sticky_key->timer_started = false;
         sticky_key->modified_key_usage_page = 0;
         sticky_key->modified_key_keycode = 0;
+        sys_bitfield_set_bit((mem_addr_t)armed_sticky_keys, i);
         return sticky_key;
     }
     return NULL;
@@ -86,6 +101,7 @@ static void clear_sticky_key(struct active_sticky_key *sticky_key) {
     LOG_DBG("clearing sticky key at position %d, param %d", sticky_key->position,
             sticky_key->param1);
     sticky_key->position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
+    sys_bitfield_clear_bit((mem_addr_t)armed_sticky_keys, sticky_key - active_sticky_keys);
 }
 
 static struct active_sticky_key *
@@ -145,7 +161,7 @@ static inline void on_sticky_key_timeout(struct active_sticky_key *sticky_key) {
 }
 
 static int stop_timer(struct active_sticky_key *sticky_key) {
-    int timer_cancel_result = k_work_cancel_delayable(&sticky_key->release_timer);
+    int timer_cancel_result = zmk_workqueue_deadline_cancel(&sticky_key->release_timer);
     if (timer_cancel_result == -EINPROGRESS) {
         // too late to cancel, we'll let the timer handler clear up.
         sticky_key->timer_cancelled = true;
@@ -199,9 +215,8 @@ static int on_sticky_key_binding_released(struct zmk_behavior_binding *binding,
     sticky_key->timer_started = true;
     sticky_key->release_at = event.timestamp + sticky_key->config->release_after_ms;
     // adjust timer in case this behavior was queued by a hold-tap
-    int32_t ms_left = sticky_key->release_at - k_uptime_get();
-    if (ms_left > 0) {
-        k_work_schedule(&sticky_key->release_timer, K_MSEC(ms_left));
+    if (sticky_key->release_at > k_uptime_get()) {
+        zmk_workqueue_deadline_schedule(&sticky_key->release_timer, sticky_key->release_at);
     }
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -251,7 +266,7 @@ ZMK_SUBSCRIPTION(behavior_sticky_key, zmk_keycode_state_changed);
 
 static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
     struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
-    if (ev == NULL) {
+    if (ev == NULL || !any_sticky_key_armed()) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
@@ -357,10 +372,9 @@ static int sticky_key_keycode_state_changed_listener(const zmk_event_t *eh) {
     return event_reraised ? ZMK_EV_EVENT_CAPTURED : ZMK_EV_EVENT_BUBBLE;
 }
 
-void behavior_sticky_key_timer_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
+void behavior_sticky_key_timer_handler(struct zmk_workqueue_deadline *deadline) {
     struct active_sticky_key *sticky_key =
-        CONTAINER_OF(d_work, struct active_sticky_key, release_timer);
+        CONTAINER_OF(deadline, struct active_sticky_key, release_timer);
     if (sticky_key->position == ZMK_BHV_STICKY_KEY_POSITION_FREE) {
         return;
     }
@@ -375,8 +389,8 @@ static int behavior_sticky_key_init(const struct device *dev) {
     static bool init_first_run = true;
     if (init_first_run) {
         for (int i = 0; i < ZMK_BHV_STICKY_KEY_MAX_HELD; i++) {
-            k_work_init_delayable(&active_sticky_keys[i].release_timer,
-                                  behavior_sticky_key_timer_handler);
+            zmk_workqueue_deadline_init(&active_sticky_keys[i].release_timer,
+                                        behavior_sticky_key_timer_handler);
             active_sticky_keys[i].position = ZMK_BHV_STICKY_KEY_POSITION_FREE;
         }
     }
@@ -16,13 +16,12 @@
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/hid.h>
+#include <zmk/workqueue.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
-#define ZMK_BHV_TAP_DANCE_MAX_HELD CONFIG_ZMK_BEHAVIOR_TAP_DANCE_MAX_HELD
-
 #define ZMK_BHV_TAP_DANCE_POSITION_FREE UINT32_MAX
 
 struct behavior_tap_dance_config {
@@ -31,6 +30,8 @@ struct behavior_tap_dance_config {
     struct zmk_behavior_binding *behaviors;
 };
 
+// A dance is identified by its behavior instance and the key it was pressed on, so the same
+// tap-dance can be held on several keys at once.
 struct active_tap_dance {
     // Tap Dance Data
     int counter;
@@ -38,73 +39,75 @@ struct active_tap_dance {
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
     uint8_t source;
 #endif
-    uint32_t param1;
-    uint32_t param2;
     bool is_pressed;
+    bool tap_dance_decided;
     const struct behavior_tap_dance_config *config;
 
     // Timer Data
-    bool timer_started;
-    bool timer_cancelled;
-    bool tap_dance_decided;
     int64_t release_at;
-    struct k_work_delayable release_timer;
+    struct zmk_workqueue_deadline release_timer;
 };
 
-struct active_tap_dance active_tap_dances[ZMK_BHV_TAP_DANCE_MAX_HELD] = {};
+#define ZMK_BHV_TAP_DANCE_MAX_HELD CONFIG_ZMK_BEHAVIOR_TAP_DANCE_MAX_HELD
 
-static struct active_tap_dance *find_tap_dance(uint32_t position) {
-    for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
-        if (active_tap_dances[i].position == position && !active_tap_dances[i].timer_cancelled) {
-            return &active_tap_dances[i];
+static struct active_tap_dance active_tap_dances[ZMK_BHV_TAP_DANCE_MAX_HELD] = {};
+
+// Slots with a dance in progress, so lookups and the position listener only visit those.
+static uint32_t active_tap_dances_mask[DIV_ROUND_UP(ZMK_BHV_TAP_DANCE_MAX_HELD, 32)] = {};
+
+#define FOR_EACH_ACTIVE_TAP_DANCE(_tap_dance)                                                      \
+    for (int _i = 0; _i < ZMK_BHV_TAP_DANCE_MAX_HELD; _i++)                                        \
+        for (struct active_tap_dance *_tap_dance = &active_tap_dances[_i];                         \
+             _tap_dance != NULL && sys_bitfield_test_bit((mem_addr_t)active_tap_dances_mask, _i);  \
+             _tap_dance = NULL)
+
+static struct active_tap_dance *find_tap_dance(const struct behavior_tap_dance_config *config,
+                                               uint32_t position) {
+    FOR_EACH_ACTIVE_TAP_DANCE(tap_dance) {
+        if (tap_dance->config == config && tap_dance->position == position) {
+            return tap_dance;
         }
     }
     return NULL;
 }
 
-static int new_tap_dance(struct zmk_behavior_binding_event *event,
-                         const struct behavior_tap_dance_config *config,
-                         struct active_tap_dance **tap_dance) {
+static struct active_tap_dance *new_tap_dance(struct zmk_behavior_binding_event *event,
+                                              const struct behavior_tap_dance_config *config) {
     for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
+        if (sys_bitfield_test_bit((mem_addr_t)active_tap_dances_mask, i)) {
+            continue;
+        }
+
         struct active_tap_dance *const ref_dance = &active_tap_dances[i];
-        if (ref_dance->position == ZMK_BHV_TAP_DANCE_POSITION_FREE) {
-            ref_dance->counter = 0;
-            ref_dance->position = event->position;
+        ref_dance->counter = 0;
+        ref_dance->position = event->position;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
-            ref_dance->source = event->source;
+        ref_dance->source = event->source;
 #endif
-            ref_dance->config = config;
-            ref_dance->release_at = 0;
-            ref_dance->is_pressed = true;
-            ref_dance->timer_started = true;
-            ref_dance->timer_cancelled = false;
-            ref_dance->tap_dance_decided = false;
-            *tap_dance = ref_dance;
-            return 0;
-        }
+        ref_dance->config = config;
+        ref_dance->release_at = 0;
+        ref_dance->is_pressed = true;
+        ref_dance->tap_dance_decided = false;
+        sys_bitfield_set_bit((mem_addr_t)active_tap_dances_mask, i);
+        return ref_dance;
     }
-    return -ENOMEM;
+    return NULL;
 }
 
 static void clear_tap_dance(struct active_tap_dance *tap_dance) {
     tap_dance->position = ZMK_BHV_TAP_DANCE_POSITION_FREE;
+    sys_bitfield_clear_bit((mem_addr_t)active_tap_dances_mask, tap_dance - active_tap_dances);
 }
 
-static int stop_timer(struct active_tap_dance *tap_dance) {
-    int timer_cancel_result = k_work_cancel_delayable(&tap_dance->release_timer);
-    if (timer_cancel_result == -EINPROGRESS) {
-        // too late to cancel, we'll let the timer handler clear up.
-        tap_dance->timer_cancelled = true;
-    }
-    return timer_cancel_result;
+static void stop_timer(struct active_tap_dance *tap_dance) {
+    zmk_workqueue_deadline_cancel(&tap_dance->release_timer);
 }
 
 static void reset_timer(struct active_tap_dance *tap_dance,
                         struct zmk_behavior_binding_event event) {
     tap_dance->release_at = event.timestamp + tap_dance->config->tapping_term_ms;
-    int32_t ms_left = tap_dance->release_at - k_uptime_get();
-    if (ms_left > 0) {
-        k_work_schedule(&tap_dance->release_timer, K_MSEC(ms_left));
+    if (tap_dance->release_at > k_uptime_get()) {
+        zmk_workqueue_deadline_schedule(&tap_dance->release_timer, tap_dance->release_at);
         LOG_DBG("Successfully reset timer at position %d", tap_dance->position);
     }
 }
@@ -140,10 +143,10 @@ static int on_tap_dance_binding_pressed(struct zmk_behavior_binding *binding,
                                         struct zmk_behavior_binding_event event) {
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
     const struct behavior_tap_dance_config *cfg = dev->config;
-    struct active_tap_dance *tap_dance;
-    tap_dance = find_tap_dance(event.position);
+    struct active_tap_dance *tap_dance = find_tap_dance(cfg, event.position);
     if (tap_dance == NULL) {
-        if (new_tap_dance(&event, cfg, &tap_dance) == -ENOMEM) {
+        tap_dance = new_tap_dance(&event, cfg);
+        if (tap_dance == NULL) {
             LOG_ERR("Unable to create new tap dance. Insufficient space in active_tap_dances[].");
             return ZMK_BEHAVIOR_OPAQUE;
         }
@@ -152,8 +155,8 @@ static int on_tap_dance_binding_pressed(struct zmk_behavior_binding *binding,
     tap_dance->is_pressed = true;
     LOG_DBG("%d tap dance pressed", event.position);
     stop_timer(tap_dance);
-    // Increment the counter on keypress. If the counter has reached its maximum
-    // value, invoke the last binding available.
+    // Increment the counter on keypress. Once the counter has reached its maximum value, no
+    // further tap can change the outcome, so invoke the last binding right away.
     if (tap_dance->counter < cfg->behavior_count) {
         tap_dance->counter++;
     }
@@ -169,7 +172,8 @@ static int on_tap_dance_binding_pressed(struct zmk_behavior_binding *binding,
 static int on_tap_dance_binding_released(struct zmk_behavior_binding *binding,
                                          struct zmk_behavior_binding_event event) {
     LOG_DBG("%d tap dance keybind released", event.position);
-    struct active_tap_dance *tap_dance = find_tap_dance(event.position);
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    struct active_tap_dance *tap_dance = find_tap_dance(dev->config, event.position);
     if (tap_dance == NULL) {
         LOG_ERR("ACTIVE TAP DANCE CLEARED TOO EARLY");
         return ZMK_BEHAVIOR_OPAQUE;
@@ -181,14 +185,10 @@ static int on_tap_dance_binding_released(struct zmk_behavior_binding *binding,
     return ZMK_BEHAVIOR_OPAQUE;
 }
 
-void behavior_tap_dance_timer_handler(struct k_work *item) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(item);
+void behavior_tap_dance_timer_handler(struct zmk_workqueue_deadline *deadline) {
     struct active_tap_dance *tap_dance =
-        CONTAINER_OF(d_work, struct active_tap_dance, release_timer);
-    if (tap_dance->position == ZMK_BHV_TAP_DANCE_POSITION_FREE) {
-        return;
-    }
-    if (tap_dance->timer_cancelled) {
+        CONTAINER_OF(deadline, struct active_tap_dance, release_timer);
+    if (tap_dance->position == ZMK_BHV_TAP_DANCE_POSITION_FREE || tap_dance->tap_dance_decided) {
         return;
     }
     LOG_DBG("Tap dance has been decided via timer. Counter reached: %d", tap_dance->counter);
@@ -221,22 +221,19 @@ static int tap_dance_position_state_changed_listener(const zmk_event_t *eh) {
         LOG_DBG("Ignore upstroke at position %d.", ev->position);
         return ZMK_EV_EVENT_BUBBLE;
     }
-    for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
-        struct active_tap_dance *tap_dance = &active_tap_dances[i];
-        if (tap_dance->position == ZMK_BHV_TAP_DANCE_POSITION_FREE) {
-            continue;
-        }
+    // Decide every undecided dance, in slot order, so the outcome doesn't depend on which one
+    // happens to be found first.
+    FOR_EACH_ACTIVE_TAP_DANCE(tap_dance) {
         if (tap_dance->position == ev->position) {
             continue;
         }
         stop_timer(tap_dance);
-        LOG_DBG("Tap dance interrupted, activating tap-dance at %d", tap_dance->position);
         if (!tap_dance->tap_dance_decided) {
+            LOG_DBG("Tap dance interrupted, activating tap-dance at %d", tap_dance->position);
             press_tap_dance_behavior(tap_dance, ev->timestamp);
             if (!tap_dance->is_pressed) {
                 release_tap_dance_behavior(tap_dance, ev->timestamp);
             }
-            return ZMK_EV_EVENT_BUBBLE;
         }
     }
     return ZMK_EV_EVENT_BUBBLE;
@@ -246,8 +243,8 @@ static int behavior_tap_dance_init(const struct device *dev) {
     static bool init_first_run = true;
     if (init_first_run) {
         for (int i = 0; i < ZMK_BHV_TAP_DANCE_MAX_HELD; i++) {
-            k_work_init_delayable(&active_tap_dances[i].release_timer,
-                                  behavior_tap_dance_timer_handler);
+            zmk_workqueue_deadline_init(&active_tap_dances[i].release_timer,
+                                        behavior_tap_dance_timer_handler);
             clear_tap_dance(&active_tap_dances[i]);
         }
     }
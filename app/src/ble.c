@@ -32,11 +32,16 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/ble.h>
+#include <zmk/settings.h>
 #include <zmk/keys.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/ble_active_profile_changed.h>
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
+#include <zmk/pointing/resolution_multipliers.h>
+#endif
+
 #if IS_ENABLED(CONFIG_ZMK_BLE_PASSKEY_ENTRY)
 #include <zmk/events/keycode_state_changed.h>
 
@@ -99,6 +104,60 @@ bool zmk_ble_active_profile_is_open(void) {
     return !bt_addr_le_cmp(&profiles[active_profile].peer, BT_ADDR_LE_ANY);
 }
 
+#if IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
+
+// Profiles whose host didn't switch to the 2M PHY when asked. They aren't asked again until the
+// profile is paired to a different host or the keyboard restarts.
+static ATOMIC_DEFINE(phy_2m_refused, ZMK_BLE_PROFILE_COUNT);
+static ATOMIC_DEFINE(phy_2m_requested, ZMK_BLE_PROFILE_COUNT);
+
+static void request_phy_2m(struct bt_conn *conn, int profile) {
+    if (profile < 0 || atomic_test_bit(phy_2m_refused, profile)) {
+        return;
+    }
+
+    int err = bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+    if (err) {
+        LOG_DBG("Failed to request 2M PHY (%d)", err);
+        atomic_set_bit(phy_2m_refused, profile);
+        return;
+    }
+
+    atomic_set_bit(phy_2m_requested, profile);
+}
+
+static void le_phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *param) {
+    int profile = zmk_ble_profile_index(bt_conn_get_dst(conn));
+
+    LOG_DBG("PHY updated: tx %d rx %d", param->tx_phy, param->rx_phy);
+
+    if (profile < 0 || !atomic_test_and_clear_bit(phy_2m_requested, profile)) {
+        return;
+    }
+
+    if (param->tx_phy != BT_GAP_LE_PHY_2M) {
+        LOG_DBG("Host stayed on PHY %d, not asking profile %d again", param->tx_phy, profile);
+        atomic_set_bit(phy_2m_refused, profile);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_HOST_DATA_LEN)
+
+static void request_data_len(struct bt_conn *conn) {
+    int err = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    if (err) {
+        LOG_DBG("Failed to request data length extension (%d)", err);
+    }
+}
+
+static void le_data_len_updated(struct bt_conn *conn, struct bt_conn_le_data_len_info *info) {
+    LOG_DBG("Data length updated: tx %d bytes, rx %d bytes", info->tx_max_len, info->rx_max_len);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_HOST_DATA_LEN)
+
 void set_profile_address(uint8_t index, const bt_addr_le_t *addr) {
     char setting_name[17];
     char addr_str[BT_ADDR_LE_STR_LEN];
@@ -106,6 +165,9 @@ void set_profile_address(uint8_t index, const bt_addr_le_t *addr) {
     bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
 
     memcpy(&profiles[index].peer, addr, sizeof(bt_addr_le_t));
+#if IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
+    atomic_clear_bit(phy_2m_refused, index);
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
     sprintf(setting_name, "ble/profiles/%d", index);
     LOG_DBG("Setting profile addr for %s to %s", setting_name, addr_str);
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -131,6 +193,89 @@ bool zmk_ble_active_profile_is_connected(void) {
     return info.state == BT_CONN_STATE_CONNECTED;
 }
 
+bool zmk_ble_conn_is_active_profile(const struct bt_conn *conn) {
+    return bt_addr_le_cmp(bt_conn_get_dst(conn), &profiles[active_profile].peer) == 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+
+#if ZMK_BLE_IS_CENTRAL
+BUILD_ASSERT(CONFIG_ZMK_BLE_KEPT_HOSTS + ZMK_SPLIT_BLE_PERIPHERAL_COUNT <= CONFIG_BT_MAX_CONN,
+             "CONFIG_BT_MAX_CONN must leave a connection for each kept host and split peripheral");
+#endif // ZMK_BLE_IS_CENTRAL
+
+// Hosts of the other profiles stay connected at a long interval with high latency, which only
+// costs an occasional empty packet, so switching to them doesn't wait for a reconnection.
+static const struct bt_le_conn_param active_host_params = BT_LE_CONN_PARAM_INIT(
+    CONFIG_BT_PERIPHERAL_PREF_MIN_INT, CONFIG_BT_PERIPHERAL_PREF_MAX_INT,
+    CONFIG_BT_PERIPHERAL_PREF_LATENCY, CONFIG_BT_PERIPHERAL_PREF_TIMEOUT);
+
+static const struct bt_le_conn_param inactive_host_params = BT_LE_CONN_PARAM_INIT(
+    CONFIG_ZMK_BLE_INACTIVE_HOST_CONN_INTERVAL, CONFIG_ZMK_BLE_INACTIVE_HOST_CONN_INTERVAL,
+    CONFIG_ZMK_BLE_INACTIVE_HOST_CONN_LATENCY, CONFIG_BT_PERIPHERAL_PREF_TIMEOUT);
+
+static bool is_connected_host(struct bt_conn *conn) {
+    struct bt_conn_info info;
+
+    return bt_conn_get_info(conn, &info) == 0 && info.role == BT_CONN_ROLE_PERIPHERAL &&
+           info.state == BT_CONN_STATE_CONNECTED;
+}
+
+static void update_host_conn_params(struct bt_conn *conn, void *data) {
+    if (!is_connected_host(conn)) {
+        return;
+    }
+
+    // With adaptive parameters, the active host's are switched by activity instead.
+    const bool active = zmk_ble_conn_is_active_profile(conn);
+    if (active && IS_ENABLED(CONFIG_ZMK_BLE_ADAPTIVE_CONN_PARAMS)) {
+        return;
+    }
+
+    int err = bt_conn_le_param_update(conn, active ? &active_host_params : &inactive_host_params);
+    if (err && err != -EALREADY) {
+        LOG_WRN("Failed to update host connection parameters (%d)", err);
+    }
+}
+
+static void update_hosts_conn_params(void) {
+    bt_conn_foreach(BT_CONN_TYPE_LE, update_host_conn_params, NULL);
+}
+
+static void count_connected_host(struct bt_conn *conn, void *data) {
+    if (is_connected_host(conn)) {
+        (*(int *)data)++;
+    }
+}
+
+// Whether to keep advertising for the bonded host of another profile, while the active profile's
+// host is connected.
+static bool kept_host_missing(void) {
+    int connected_hosts = 0;
+
+    bt_conn_foreach(BT_CONN_TYPE_LE, count_connected_host, &connected_hosts);
+    if (connected_hosts >= CONFIG_ZMK_BLE_KEPT_HOSTS) {
+        return false;
+    }
+
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        if (i == active_profile || !bt_addr_le_cmp(&profiles[i].peer, BT_ADDR_LE_ANY)) {
+            continue;
+        }
+
+        struct bt_conn *conn = bt_conn_lookup_addr_le(BT_ID_DEFAULT, &profiles[i].peer);
+        if (conn == NULL) {
+            return true;
+        }
+
+        bt_conn_unref(conn);
+    }
+
+    return false;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+
 #define CHECKED_ADV_STOP()                                                                         \
     err = bt_le_adv_stop();                                                                        \
     advertising_status = ZMK_ADV_NONE;                                                             \
@@ -147,8 +292,7 @@ bool zmk_ble_active_profile_is_connected(void) {
         bt_conn_unref(conn);                                                                       \
         return 0;                                                                                  \
     }                                                                                              \
-    err = bt_le_adv_start(BT_LE_ADV_CONN_DIR_LOW_DUTY(addr), zmk_ble_ad, ARRAY_SIZE(zmk_ble_ad),   \
-                          NULL, 0);                                                                \
+    err = bt_le_adv_start(BT_LE_ADV_CONN_DIR(addr), zmk_ble_ad, ARRAY_SIZE(zmk_ble_ad), NULL, 0);  \
     if (err) {                                                                                     \
         LOG_ERR("Advertising failed to start (err %d)", err);                                      \
         return err;                                                                                \
@@ -163,24 +307,46 @@ bool zmk_ble_active_profile_is_connected(void) {
     }                                                                                              \
     advertising_status = ZMK_ADV_CONN;
 
+// Set while soft-suspended, which keeps the keyboard from advertising.
+static bool suspended;
+// Set when the next advertising should be directed at the active profile's host first.
+static bool fast_reconnect;
+
+static void request_fast_reconnect(void) {
+    if (IS_ENABLED(CONFIG_ZMK_BLE_FAST_RECONNECT)) {
+        fast_reconnect = true;
+    }
+}
+
 int update_advertising(void) {
     int err = 0;
     bt_addr_le_t *addr;
     struct bt_conn *conn;
     enum advertising_type desired_adv = ZMK_ADV_NONE;
 
-    if (zmk_ble_active_profile_is_open()) {
+    if (suspended) {
+        desired_adv = ZMK_ADV_NONE;
+    } else if (zmk_ble_active_profile_is_open()) {
         desired_adv = ZMK_ADV_CONN;
     } else if (!zmk_ble_active_profile_is_connected()) {
         desired_adv = ZMK_ADV_CONN;
-        // Need to fix directed advertising for privacy centrals. See
-        // https://github.com/zephyrproject-rtos/zephyr/pull/14984 char
-        // addr_str[BT_ADDR_LE_STR_LEN]; bt_addr_le_to_str(zmk_ble_active_profile_addr(), addr_str,
-        // sizeof(addr_str));
 
-        // LOG_DBG("Directed advertising to %s", addr_str);
-        // desired_adv = ZMK_ADV_DIR;
+        // High duty cycle directed advertising reconnects a bonded host far faster than open
+        // advertising, but only lasts 1.28 seconds. When it times out, the failed connection
+        // updates the advertising again, and it falls back to open advertising.
+        if (fast_reconnect) {
+            fast_reconnect = false;
+            desired_adv = ZMK_ADV_DIR;
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+    // The hosts of other profiles reconnect through open advertising while there's room for them.
+    if (desired_adv == ZMK_ADV_NONE && !suspended && kept_host_missing()) {
+        desired_adv = ZMK_ADV_CONN;
     }
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+
     LOG_DBG("advertising from %d to %d", advertising_status, desired_adv);
 
     switch (desired_adv + CURR_ADV(advertising_status)) {
@@ -212,10 +378,47 @@ static void update_advertising_callback(struct k_work *work) { update_advertisin
 
 K_WORK_DEFINE(update_advertising_work, update_advertising_callback);
 
+#if IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+
+static void disconnect_host(struct bt_conn *conn, void *data) {
+    struct bt_conn_info info;
+
+    bt_conn_get_info(conn, &info);
+
+    if (info.role == BT_CONN_ROLE_PERIPHERAL) {
+        bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+    }
+}
+
+int zmk_ble_suspend(void) {
+    suspended = true;
+    bt_conn_foreach(BT_CONN_TYPE_LE, disconnect_host, NULL);
+
+    return update_advertising();
+}
+
+int zmk_ble_resume(void) {
+    suspended = false;
+    // Waking from soft-suspend tries the last host first, to get the next keystroke out.
+    request_fast_reconnect();
+
+    return update_advertising();
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+
 static void clear_profile_bond(uint8_t profile) {
     if (bt_addr_le_cmp(&profiles[profile].peer, BT_ADDR_LE_ANY)) {
         bt_unpair(BT_ID_DEFAULT, &profiles[profile].peer);
         set_profile_address(profile, BT_ADDR_LE_ANY);
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
+        // A new host will negotiate its own multipliers.
+        zmk_pointing_resolution_multipliers_set_profile(
+            (struct zmk_pointing_resolution_multipliers){},
+            (struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_BLE,
+                                           .ble = {.profile_index = profile}});
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
     }
 }
 
@@ -251,16 +454,16 @@ int zmk_ble_profile_index(const bt_addr_le_t *addr) {
 }
 
 #if IS_ENABLED(CONFIG_SETTINGS)
-static void ble_save_profile_work(struct k_work *work) {
+static void ble_save_profile_cb(void) {
     settings_save_one("ble/active_profile", &active_profile, sizeof(active_profile));
 }
 
-static struct k_work_delayable ble_save_work;
+ZMK_SETTINGS_SAVE_DEFINE(ble_save, ble_save_profile_cb);
 #endif
 
 static int ble_save_profile(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
-    return k_work_reschedule(&ble_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    return zmk_settings_save_schedule(&ble_save);
 #else
     return 0;
 #endif
@@ -279,8 +482,13 @@ int zmk_ble_prof_select(uint8_t index) {
     active_profile = index;
     ble_save_profile();
 
+    request_fast_reconnect();
     update_advertising();
 
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+    update_hosts_conn_params();
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+
     raise_profile_changed_event();
 
     return 0;
@@ -395,6 +603,15 @@ int zmk_ble_put_peripheral_addr(const bt_addr_le_t *addr) {
     return -ENOMEM;
 }
 
+const bt_addr_le_t *zmk_ble_get_peripheral_addr(int index) {
+    if (index < 0 || index >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT ||
+        bt_addr_le_cmp(&peripheral_addrs[index], BT_ADDR_LE_ANY) == 0) {
+        return NULL;
+    }
+
+    return &peripheral_addrs[index];
+}
+
 #endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) */
 
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -475,10 +692,6 @@ static struct settings_handler profiles_handler = {
 
 #endif /* IS_ENABLED(CONFIG_SETTINGS) */
 
-static bool is_conn_active_profile(const struct bt_conn *conn) {
-    return bt_addr_le_cmp(bt_conn_get_dst(conn), &profiles[active_profile].peer) == 0;
-}
-
 static void connected(struct bt_conn *conn, uint8_t err) {
     char addr[BT_ADDR_LE_STR_LEN];
     struct bt_conn_info info;
@@ -502,9 +715,23 @@ static void connected(struct bt_conn *conn, uint8_t err) {
 
     LOG_DBG("Connected %s", addr);
 
+#if IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
+    request_phy_2m(conn, zmk_ble_profile_index(bt_conn_get_dst(conn)));
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_HOST_DATA_LEN)
+    request_data_len(conn);
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_HOST_DATA_LEN)
+
     update_advertising();
 
-    if (is_conn_active_profile(conn)) {
+#if IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+    if (!zmk_ble_conn_is_active_profile(conn)) {
+        update_host_conn_params(conn, NULL);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED)
+
+    if (zmk_ble_conn_is_active_profile(conn)) {
         LOG_DBG("Active profile connected");
         k_work_submit(&raise_profile_changed_event_work);
     }
@@ -525,11 +752,17 @@ static void disconnected(struct bt_conn *conn, uint8_t reason) {
         return;
     }
 
+    // A host which dropped the connection, e.g. after going out of range or to sleep, is likely
+    // to look for the keyboard again soon. Disconnecting on purpose doesn't call for it.
+    if (zmk_ble_conn_is_active_profile(conn) && reason != BT_HCI_ERR_LOCALHOST_TERM_CONN) {
+        request_fast_reconnect();
+    }
+
     // We need to do this in a work callback, otherwise the advertising update will still see the
     // connection for a profile as active, and not start advertising yet.
     k_work_submit(&update_advertising_work);
 
-    if (is_conn_active_profile(conn)) {
+    if (zmk_ble_conn_is_active_profile(conn)) {
         LOG_DBG("Active profile disconnected");
         k_work_submit(&raise_profile_changed_event_work);
     }
@@ -561,6 +794,12 @@ static struct bt_conn_cb conn_callbacks = {
     .disconnected = disconnected,
     .security_changed = security_changed,
     .le_param_updated = le_param_updated,
+#if IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
+    .le_phy_updated = le_phy_updated,
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_HOST_PHY_2M)
+#if IS_ENABLED(CONFIG_ZMK_BLE_HOST_DATA_LEN)
+    .le_data_len_updated = le_data_len_updated,
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_HOST_DATA_LEN)
 };
 
 /*
@@ -668,6 +907,7 @@ static void zmk_ble_ready(int err) {
         return;
     }
 
+    request_fast_reconnect();
     update_advertising();
 }
 
@@ -721,7 +961,6 @@ static int zmk_ble_init(void) {
 
 #if IS_ENABLED(CONFIG_SETTINGS)
     settings_register(&profiles_handler);
-    k_work_init_delayable(&ble_save_work, ble_save_profile_work);
 #else
     zmk_ble_complete_startup();
 #endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/ble.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+// Connections are switched to a short interval with no peripheral latency as soon as there is
+// activity, and back to a long interval with high latency once nothing has happened for the
+// quiet period. Activity only records a timestamp, so it is cheap enough to note for every report.
+
+static const struct bt_le_conn_param active_params = BT_LE_CONN_PARAM_INIT(
+    CONFIG_ZMK_BLE_ACTIVE_CONN_INTERVAL, CONFIG_ZMK_BLE_ACTIVE_CONN_INTERVAL,
+    CONFIG_ZMK_BLE_ACTIVE_CONN_LATENCY, CONFIG_ZMK_BLE_CONN_TIMEOUT);
+
+static const struct bt_le_conn_param quiet_params = BT_LE_CONN_PARAM_INIT(
+    CONFIG_ZMK_BLE_QUIET_CONN_INTERVAL_MIN, CONFIG_ZMK_BLE_QUIET_CONN_INTERVAL_MAX,
+    CONFIG_ZMK_BLE_QUIET_CONN_LATENCY, CONFIG_ZMK_BLE_CONN_TIMEOUT);
+
+static atomic_t low_latency;
+static atomic_t last_activity;
+
+static void update_conn_params(struct bt_conn *conn, void *data) {
+    const struct bt_le_conn_param *params = data;
+    struct bt_conn_info info;
+
+    if (bt_conn_get_info(conn, &info) < 0 || info.state != BT_CONN_STATE_CONNECTED) {
+        return;
+    }
+
+    // Split peripheral links are managed by the split central's own low latency mode.
+    if (IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY) && info.role == BT_CONN_ROLE_CENTRAL) {
+        return;
+    }
+
+    // Hosts of inactive profiles stay at their own relaxed parameters.
+    if (IS_ENABLED(CONFIG_ZMK_BLE_KEEP_HOSTS_CONNECTED) && info.role == BT_CONN_ROLE_PERIPHERAL &&
+        !zmk_ble_conn_is_active_profile(conn)) {
+        return;
+    }
+
+    int err = bt_conn_le_param_update(conn, params);
+    if (err && err != -EALREADY) {
+        LOG_WRN("Failed to update connection parameters (%d)", err);
+    }
+}
+
+static void apply_conn_params(const struct bt_le_conn_param *params) {
+    bt_conn_foreach(BT_CONN_TYPE_LE, update_conn_params, (void *)params);
+}
+
+static void relax_work_cb(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(relax_work, relax_work_cb);
+
+static void relax_work_cb(struct k_work *work) {
+    uint32_t quiet_ms = k_uptime_get_32() - (uint32_t)atomic_get(&last_activity);
+
+    if (quiet_ms < CONFIG_ZMK_BLE_CONN_PARAMS_QUIET_MS) {
+        k_work_reschedule(&relax_work, K_MSEC(CONFIG_ZMK_BLE_CONN_PARAMS_QUIET_MS - quiet_ms));
+        return;
+    }
+
+    if (atomic_cas(&low_latency, true, false)) {
+        LOG_DBG("Relaxing connection parameters after %u ms without activity", quiet_ms);
+        apply_conn_params(&quiet_params);
+    }
+}
+
+static void boost_work_cb(struct k_work *work) {
+    LOG_DBG("Requesting low latency connection parameters");
+    apply_conn_params(&active_params);
+    k_work_reschedule(&relax_work, K_MSEC(CONFIG_ZMK_BLE_CONN_PARAMS_QUIET_MS));
+}
+
+K_WORK_DEFINE(boost_work, boost_work_cb);
+
+void zmk_ble_conn_params_note_activity(void) {
+    atomic_set(&last_activity, k_uptime_get_32());
+
+    if (atomic_cas(&low_latency, false, true)) {
+        k_work_submit(&boost_work);
+    }
+}
+
+static int conn_params_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+
+    if (ev) {
+        // Idle is a stronger signal than the quiet period, so don't wait for it.
+        if (ev->state != ZMK_ACTIVITY_ACTIVE && atomic_cas(&low_latency, true, false)) {
+            k_work_cancel_delayable(&relax_work);
+            apply_conn_params(&quiet_params);
+        }
+
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    zmk_ble_conn_params_note_activity();
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(ble_conn_params, conn_params_listener);
+ZMK_SUBSCRIPTION(ble_conn_params, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(ble_conn_params, zmk_activity_state_changed);
@@ -15,13 +15,16 @@
 #include <drivers/behavior.h>
 
 #include <zmk/behavior.h>
+#include <zmk/combo_tables.h>
 #include <zmk/event_manager.h>
+#include <zmk/event_pool.h>
 #include <zmk/events/position_state_changed.h>
-#include <zmk/events/keycode_state_changed.h>
 #include <zmk/hid.h>
 #include <zmk/matrix.h>
 #include <zmk/keymap.h>
+#include <zmk/keystroke_timeline.h>
 #include <zmk/virtual_key_position.h>
+#include <zmk/workqueue.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -50,7 +53,6 @@ struct combo_cfg {
     int16_t key_position_len;
     int16_t require_prior_idle_ms;
     int32_t timeout_ms;
-    uint32_t layer_mask;
     struct zmk_behavior_binding behavior;
     // if slow release is set, the combo releases when the last key is released.
     // otherwise, the combo releases when the first key is released.
@@ -63,7 +65,7 @@ struct active_combo {
     // The keys are removed from this array when they are released.
     // Once this array is empty, the behavior is released.
     uint16_t key_positions_pressed_count;
-    struct zmk_position_state_changed_event key_positions_pressed[MAX_COMBO_KEYS];
+    zmk_event_pool_ref_t key_positions_pressed[MAX_COMBO_KEYS];
 };
 
 #define PROP_BIT_AT_IDX(n, prop, idx) BIT(DT_PROP_BY_IDX(n, prop, idx))
@@ -84,7 +86,6 @@ struct active_combo {
                         .key_position_len = DT_PROP_LEN(n, key_positions),                         \
                         .behavior = ZMK_KEYMAP_EXTRACT_BINDING(0, n),                              \
                         .slow_release = DT_PROP(n, slow_release),                                  \
-                        .layer_mask = NODE_PROP_BITMASK(n, layers),                                \
                     }, ),                                                                          \
                 ())
 
@@ -108,73 +109,91 @@ static const struct combo_cfg combos[] = {
 #define BYTES_FOR_COMBOS_MASK DIV_ROUND_UP(COMBO_CHILDREN_COUNT, 32)
 
 uint8_t pressed_keys_count = 0;
-// set of keys pressed
-struct zmk_position_state_changed_event pressed_keys[MAX_COMBO_KEYS] = {};
+// set of keys pressed, as references to the events in the shared event pool
+zmk_event_pool_ref_t pressed_keys[MAX_COMBO_KEYS] = {};
 // the set of candidate combos based on the currently pressed_keys
 uint32_t candidates[BYTES_FOR_COMBOS_MASK];
 // the last candidate that was completely pressed
 int16_t fully_pressed_combo = INT16_MAX;
+// The lookups below are generated from the devicetree by scripts/combo_tables.py, with each combo's
+// bit at its index in `combos`. The asserts catch the generator and this file disagreeing.
+BUILD_ASSERT(ZMK_COMBO_TABLES_COMBOS_LEN == ARRAY_SIZE(combos),
+             "The generated combo tables don't match the combos array");
+BUILD_ASSERT(ZMK_COMBO_TABLES_LAYERS_LEN == ZMK_KEYMAP_LAYERS_LEN,
+             "The generated combo tables don't match the keymap layers");
+
 // a lookup dict that maps a key position to all combos on that position
-uint32_t combo_lookup[ZMK_KEYMAP_LEN][BYTES_FOR_COMBOS_MASK] = {};
+static const uint32_t combo_lookup[ZMK_KEYMAP_LEN][BYTES_FOR_COMBOS_MASK] = {
+    ZMK_COMBO_TABLES_POSITION_ROWS};
+// a lookup dict that maps a highest active layer to all combos active on that layer
+static const uint32_t combo_layer_lookup[ZMK_KEYMAP_LAYERS_LEN][BYTES_FOR_COMBOS_MASK] = {
+    ZMK_COMBO_TABLES_LAYER_ROWS};
+// the set of combos that have a require-prior-idle-ms and need a quick tap check
+static const uint32_t combo_prior_idle_mask[BYTES_FOR_COMBOS_MASK] =
+    ZMK_COMBO_TABLES_PRIOR_IDLE_MASK;
 // combos that have been activated and still have (some) keys pressed
 // this array is always contiguous from 0.
 struct active_combo active_combos[CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS] = {};
 uint8_t active_combo_count = 0;
 
-struct k_work_delayable timeout_task;
+struct zmk_workqueue_deadline timeout_task;
 int64_t timeout_task_timeout_at;
 
-// this keeps track of the last non-combo, non-mod key tap
-int64_t last_tapped_timestamp = INT32_MIN;
-// this keeps track of the last time a combo was pressed
-int64_t last_combo_timestamp = INT32_MIN;
-
-static void store_last_tapped(int64_t timestamp) {
-    if (timestamp > last_combo_timestamp) {
-        last_tapped_timestamp = timestamp;
-    }
-}
+// Returns the index of the first combo set in the mask at or after `from`, or -1 if none is.
+// Lets loops over candidates skip straight between set bits instead of testing every combo.
+static int next_combo_in_mask(const uint32_t *mask, int from) {
+    for (int word = from / 32; word < BYTES_FOR_COMBOS_MASK; word++) {
+        uint32_t bits = mask[word];
 
-// Store the combo key pointer in the combos array, one pointer for each key position
-// The combos are sorted shortest-first, then by virtual-key-position.
-static int initialize_combo(size_t index) {
-    const struct combo_cfg *new_combo = &combos[index];
+        if (word == from / 32) {
+            bits &= ~0U << (from % 32);
+        }
 
-    for (size_t kp = 0; kp < new_combo->key_position_len; kp++) {
-        sys_bitfield_set_bit((mem_addr_t)&combo_lookup[new_combo->key_positions[kp]], index);
+        if (bits) {
+            return (word * 32) + __builtin_ctz(bits);
+        }
     }
 
-    return 0;
+    return -1;
 }
 
-static bool combo_active_on_layer(const struct combo_cfg *combo, uint8_t layer) {
-    if (!combo->layer_mask) {
-        return true;
-    }
-
-    return combo->layer_mask & BIT(layer);
-}
+#define FOR_EACH_COMBO_IN_MASK(_mask, _idx)                                                        \
+    for (int _idx = next_combo_in_mask(_mask, 0); _idx >= 0;                                       \
+         _idx = next_combo_in_mask(_mask, _idx + 1))
 
 static bool is_quick_tap(const struct combo_cfg *combo, int64_t timestamp) {
-    return (last_tapped_timestamp + combo->require_prior_idle_ms) > timestamp;
+    // Only keycodes tapped outside of combos count, so a combo doesn't hold off the next one.
+    const uint8_t skip = ZMK_KEYSTROKE_COMBO | ZMK_KEYSTROKE_HOLD_TAP;
+    struct zmk_keystroke last_tap;
+
+    return zmk_keystroke_timeline_last_tap(skip, &last_tap) == 0 &&
+           (last_tap.timestamp + combo->require_prior_idle_ms) > timestamp;
 }
 
 static int setup_candidates_for_first_keypress(int32_t position, int64_t timestamp) {
     int number_of_combo_candidates = 0;
     uint8_t highest_active_layer = zmk_keymap_highest_layer_active();
 
-    for (size_t i = 0; i < ARRAY_SIZE(combos); i++) {
-        if (sys_bitfield_test_bit((mem_addr_t)&combo_lookup[position], i)) {
-            const struct combo_cfg *combo = &combos[i];
-            if (combo_active_on_layer(combo, highest_active_layer) &&
-                !is_quick_tap(combo, timestamp)) {
-                sys_bitfield_set_bit((mem_addr_t)&candidates, i);
-                number_of_combo_candidates++;
-            }
-            // LOG_DBG("combo timeout %d %d %d", position, i, candidates[i].timeout_at);
+    if (highest_active_layer >= ZMK_KEYMAP_LAYERS_LEN) {
+        return 0;
+    }
+
+    uint32_t idle_candidates[BYTES_FOR_COMBOS_MASK];
+    for (int i = 0; i < BYTES_FOR_COMBOS_MASK; i++) {
+        candidates[i] = combo_lookup[position][i] & combo_layer_lookup[highest_active_layer][i];
+        idle_candidates[i] = candidates[i] & combo_prior_idle_mask[i];
+    }
+
+    FOR_EACH_COMBO_IN_MASK(idle_candidates, i) {
+        if (is_quick_tap(&combos[i], timestamp)) {
+            sys_bitfield_clear_bit((mem_addr_t)&candidates, i);
         }
     }
 
+    for (int i = 0; i < BYTES_FOR_COMBOS_MASK; i++) {
+        number_of_combo_candidates += __builtin_popcount(candidates[i]);
+    }
+
     return number_of_combo_candidates;
 }
 
@@ -201,19 +220,21 @@ static int filter_candidates(int32_t position) {
     return matches;
 }
 
+static inline struct zmk_position_state_changed *pressed_key(zmk_event_pool_ref_t ref) {
+    return ZMK_EVENT_POOL_AS(ref, zmk_position_state_changed);
+}
+
 static int64_t first_candidate_timeout() {
     if (pressed_keys_count == 0) {
         return LONG_MAX;
     }
 
     int64_t first_timeout = LONG_MAX;
-    for (int i = 0; i < ARRAY_SIZE(combos); i++) {
-        if (sys_bitfield_test_bit((mem_addr_t)&candidates, i)) {
-            first_timeout = MIN(first_timeout, combos[i].timeout_ms);
-        }
+    FOR_EACH_COMBO_IN_MASK(candidates, i) {
+        first_timeout = MIN(first_timeout, combos[i].timeout_ms);
     }
 
-    return pressed_keys[0].data.timestamp + first_timeout;
+    return pressed_key(pressed_keys[0])->timestamp + first_timeout;
 }
 
 static inline bool candidate_is_completely_pressed(const struct combo_cfg *candidate) {
@@ -225,20 +246,39 @@ static inline bool candidate_is_completely_pressed(const struct combo_cfg *candi
     return candidate->key_position_len == pressed_keys_count;
 }
 
+// Whether the completely pressed combo is the only candidate left, i.e. no longer combo containing
+// the pressed keys can still be completed, so it can activate without waiting for timeouts.
+static bool fully_pressed_combo_is_unambiguous() {
+    if (fully_pressed_combo == INT16_MAX) {
+        return false;
+    }
+
+    for (int i = 0; i < BYTES_FOR_COMBOS_MASK; i++) {
+        uint32_t others = candidates[i];
+
+        if (i == fully_pressed_combo / 32) {
+            others &= ~BIT(fully_pressed_combo % 32);
+        }
+
+        if (others) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static int cleanup();
 
 static int filter_timed_out_candidates(int64_t timestamp) {
     __ASSERT(pressed_keys_count > 0, "Searching for a candidate timeout with no keys pressed");
 
     int remaining_candidates = 0;
-    for (int i = 0; i < ARRAY_SIZE(combos); i++) {
-        if (sys_bitfield_test_bit((mem_addr_t)&candidates, i)) {
-
-            if (pressed_keys[0].data.timestamp + combos[i].timeout_ms > timestamp) {
-                remaining_candidates++;
-            } else {
-                sys_bitfield_clear_bit((mem_addr_t)&candidates, i);
-            }
+    FOR_EACH_COMBO_IN_MASK(candidates, i) {
+        if (pressed_key(pressed_keys[0])->timestamp + combos[i].timeout_ms > timestamp) {
+            remaining_candidates++;
+        } else {
+            sys_bitfield_clear_bit((mem_addr_t)&candidates, i);
         }
     }
 
@@ -249,30 +289,40 @@ static int filter_timed_out_candidates(int64_t timestamp) {
     return remaining_candidates;
 }
 
-static int capture_pressed_key(const struct zmk_position_state_changed *ev) {
+static int capture_pressed_key(const zmk_event_t *ev) {
     if (pressed_keys_count == MAX_COMBO_KEYS) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
-    pressed_keys[pressed_keys_count++] = copy_raised_zmk_position_state_changed(ev);
+    zmk_event_pool_ref_t ref = zmk_event_pool_capture(ev);
+    if (ref == ZMK_EVENT_POOL_REF_NONE) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    pressed_keys[pressed_keys_count++] = ref;
     return ZMK_EV_EVENT_CAPTURED;
 }
 
 const struct zmk_listener zmk_listener_combo;
 
 static int release_pressed_keys() {
+    // Re-raised events may be captured again, refilling pressed_keys while we go through them.
+    zmk_event_pool_ref_t refs[MAX_COMBO_KEYS];
     uint8_t count = pressed_keys_count;
+
+    memcpy(refs, pressed_keys, count * sizeof(refs[0]));
     pressed_keys_count = 0;
     for (int i = 0; i < count; i++) {
-        struct zmk_position_state_changed_event *ev = &pressed_keys[i];
+        zmk_event_t *ev = zmk_event_pool_get(refs[i]);
         if (i == 0) {
-            LOG_DBG("combo: releasing position event %d", ev->data.position);
-            ZMK_EVENT_RELEASE(*ev);
+            LOG_DBG("combo: releasing position event %d", pressed_key(refs[i])->position);
+            zmk_event_manager_release(ev);
         } else {
             // reprocess events (see tests/combo/fully-overlapping-combos-3 for why this is needed)
-            LOG_DBG("combo: reraising position event %d", ev->data.position);
-            ZMK_EVENT_RAISE(*ev);
+            LOG_DBG("combo: reraising position event %d", pressed_key(refs[i])->position);
+            zmk_event_manager_raise(ev);
         }
+        zmk_event_pool_unref(refs[i]);
     }
 
     return count;
@@ -288,7 +338,7 @@ static inline int press_combo_behavior(int combo_idx, const struct combo_cfg *co
 #endif
     };
 
-    last_combo_timestamp = timestamp;
+    zmk_keystroke_timeline_note_combo(timestamp);
 
     return zmk_behavior_invoke_binding(&combo->behavior, event, true);
 }
@@ -345,7 +395,7 @@ static void activate_combo(int combo_idx) {
     }
     move_pressed_keys_to_active_combo(active_combo);
     press_combo_behavior(combo_idx, &combos[combo_idx],
-                         active_combo->key_positions_pressed[0].data.timestamp);
+                         pressed_key(active_combo->key_positions_pressed[0])->timestamp);
 }
 
 static void deactivate_combo(int active_combo_index) {
@@ -371,9 +421,10 @@ static bool release_combo_key(int32_t position, int64_t timestamp) {
             if (key_released) {
                 active_combo->key_positions_pressed[i - 1] = active_combo->key_positions_pressed[i];
                 all_keys_released = false;
-            } else if (active_combo->key_positions_pressed[i].data.position != position) {
+            } else if (pressed_key(active_combo->key_positions_pressed[i])->position != position) {
                 all_keys_released = false;
             } else { // position matches
+                zmk_event_pool_unref(active_combo->key_positions_pressed[i]);
                 key_released = true;
             }
         }
@@ -394,7 +445,7 @@ static bool release_combo_key(int32_t position, int64_t timestamp) {
 }
 
 static int cleanup() {
-    k_work_cancel_delayable(&timeout_task);
+    zmk_workqueue_deadline_cancel(&timeout_task);
     memset(candidates, 0, BYTES_FOR_COMBOS_MASK * sizeof(uint32_t));
     if (fully_pressed_combo != INT16_MAX) {
         activate_combo(fully_pressed_combo);
@@ -410,12 +461,11 @@ static void update_timeout_task() {
     }
     if (first_timeout == LLONG_MAX) {
         timeout_task_timeout_at = 0;
-        k_work_cancel_delayable(&timeout_task);
+        zmk_workqueue_deadline_cancel(&timeout_task);
         return;
     }
-    if (k_work_schedule(&timeout_task, K_MSEC(first_timeout - k_uptime_get())) >= 0) {
-        timeout_task_timeout_at = first_timeout;
-    }
+    zmk_workqueue_deadline_schedule(&timeout_task, first_timeout);
+    timeout_task_timeout_at = first_timeout;
 }
 
 static int position_state_down(const zmk_event_t *ev, struct zmk_position_state_changed *data) {
@@ -431,22 +481,21 @@ static int position_state_down(const zmk_event_t *ev, struct zmk_position_state_
     }
 
     LOG_DBG("combo: capturing position event %d", data->position);
-    int ret = capture_pressed_key(data);
+    int ret = capture_pressed_key(ev);
     update_timeout_task();
 
     if (num_candidates) {
-        for (int i = 0; i < ARRAY_SIZE(combos); i++) {
-            if (sys_bitfield_test_bit((mem_addr_t)&candidates, i)) {
-                const struct combo_cfg *candidate_combo = &combos[i];
-                if (candidate_is_completely_pressed(candidate_combo)) {
-                    fully_pressed_combo = i;
-                    if (num_candidates == 1) {
-                        cleanup();
-                    }
+        // Combos are sorted shortest-first, so only the first candidate can be completely pressed
+        int i = next_combo_in_mask(candidates, 0);
+        if (i >= 0) {
+            if (candidate_is_completely_pressed(&combos[i])) {
+                fully_pressed_combo = i;
+                if (num_candidates == 1) {
+                    cleanup();
                 }
-
-                return ret;
             }
+
+            return ret;
         }
     } else {
         cleanup();
@@ -472,12 +521,15 @@ static int position_state_up(const zmk_event_t *ev, struct zmk_position_state_ch
     return ZMK_EV_EVENT_BUBBLE;
 }
 
-static void combo_timeout_handler(struct k_work *item) {
+static void combo_timeout_handler(struct zmk_workqueue_deadline *deadline) {
     if (timeout_task_timeout_at == 0 || k_uptime_get() < timeout_task_timeout_at) {
         // timer was cancelled or rescheduled.
         return;
     }
-    if (filter_timed_out_candidates(timeout_task_timeout_at) == 0) {
+    // Once the longer combos have timed out, a completely pressed one is activated right away
+    // instead of waiting out its own timeout as well.
+    if (filter_timed_out_candidates(timeout_task_timeout_at) == 0 ||
+        fully_pressed_combo_is_unambiguous()) {
         LOG_DBG("CLEANUP!");
         cleanup();
     }
@@ -499,37 +551,23 @@ static int position_state_changed_listener(const zmk_event_t *ev) {
     }
 }
 
-static int keycode_state_changed_listener(const zmk_event_t *eh) {
-    struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
-    if (ev->state && !is_mod(ev->usage_page, ev->keycode)) {
-        store_last_tapped(ev->timestamp);
-    }
-    return ZMK_EV_EVENT_BUBBLE;
-}
-
 int behavior_combo_listener(const zmk_event_t *eh) {
     if (as_zmk_position_state_changed(eh) != NULL) {
         return position_state_changed_listener(eh);
-    } else if (as_zmk_keycode_state_changed(eh) != NULL) {
-        return keycode_state_changed_listener(eh);
     }
     return ZMK_EV_EVENT_BUBBLE;
 }
 
 ZMK_LISTENER(combo, behavior_combo_listener);
 ZMK_SUBSCRIPTION(combo, zmk_position_state_changed);
-ZMK_SUBSCRIPTION(combo, zmk_keycode_state_changed);
 
 static int combo_init(void) {
     for (size_t i = 0; i < CONFIG_ZMK_COMBO_MAX_PRESSED_COMBOS; i++) {
         active_combos[i].combo_idx = UINT16_MAX;
     }
 
-    k_work_init_delayable(&timeout_task, combo_timeout_handler);
+    zmk_workqueue_deadline_init(&timeout_task, combo_timeout_handler);
     LOG_WRN("Have %d combos!", ARRAY_SIZE(combos));
-    for (int i = 0; i < ARRAY_SIZE(combos); i++) {
-        initialize_combo(i);
-    }
     return 0;
 }
 
@@ -10,6 +10,7 @@
 #include <zephyr/kernel.h>
 
 #include <zephyr/devicetree.h>
+#include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 
 #include <zmk/event_manager.h>
@@ -20,25 +21,28 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
-static K_SEM_DEFINE(conditional_layer_sem, 1, 1);
-
 // Conditional layer configuration that activates the specified then-layer when all if-layers are
 // active. With two if-layers, this is referred to as "tri-layer", and is commonly used to activate
 // a third "adjust" layer if and only if the "lower" and "raise" layers are both active.
 struct conditional_layer_cfg {
-    // A bitmask of each layer that must be pressed for this conditional layer config to activate.
-    zmk_keymap_layers_state_t if_layers_state_mask;
+    // Each layer that must be pressed for this conditional layer config to activate.
+    const uint8_t *if_layers;
+    size_t if_layers_len;
 
     // The layer number that should be active while all layers in the if-layers mask are active.
     int8_t then_layer;
 };
 
-#define IF_LAYER_BIT(node_id, prop, idx) BIT(DT_PROP_BY_IDX(node_id, prop, idx)) |
+#define IF_LAYERS_DECL(n)                                                                          \
+    static const uint8_t DT_CAT(if_layers_, n)[] = DT_PROP(n, if_layers);
+
+DT_INST_FOREACH_CHILD(0, IF_LAYERS_DECL)
 
 // Evaluates to conditional_layer_cfg struct initializer.
 #define CONDITIONAL_LAYER_DECL(n)                                                                  \
     {                                                                                              \
-        .if_layers_state_mask = DT_FOREACH_PROP_ELEM(n, if_layers, IF_LAYER_BIT) 0,                \
+        .if_layers = DT_CAT(if_layers_, n),                                                        \
+        .if_layers_len = DT_PROP_LEN(n, if_layers),                                                \
         .then_layer = DT_PROP(n, then_layer),                                                      \
     },
 
@@ -49,76 +53,109 @@ static const struct conditional_layer_cfg CONDITIONAL_LAYER_CFGS[] = {
 static const int32_t NUM_CONDITIONAL_LAYER_CFGS =
     sizeof(CONDITIONAL_LAYER_CFGS) / sizeof(*CONDITIONAL_LAYER_CFGS);
 
+// A bitmask of the if-layers of each config, and of the then-layers of all of them, built at init
+// since the layer state may span several words when wide layer states are enabled.
+static zmk_keymap_layers_state_t if_layers_state_masks[ARRAY_SIZE(CONDITIONAL_LAYER_CFGS)];
+static zmk_keymap_layers_state_t then_layers_state_mask;
+
 static void conditional_layer_activate(int8_t layer) {
-    // This may trigger another event that could, in turn, activate additional then-layers. However,
-    // the process will eventually terminate (at worst, when every layer is active).
-    if (!zmk_keymap_layer_active(layer)) {
-        LOG_DBG("layer %d", layer);
-        zmk_keymap_layer_activate(layer);
-    }
+    LOG_DBG("layer %d", layer);
+    zmk_keymap_layer_activate(layer);
 }
 
 static void conditional_layer_deactivate(int8_t layer) {
     // This may deactivate a then-layer that's already active via another mechanism (e.g., a
     // momentary layer behavior). However, the same problem arises when multiple keys with the same
     // &mo binding are held and then one is released, so it's probably not an issue in practice.
-    if (zmk_keymap_layer_active(layer)) {
-        LOG_DBG("layer %d", layer);
-        zmk_keymap_layer_deactivate(layer);
+    LOG_DBG("layer %d", layer);
+    zmk_keymap_layer_deactivate(layer);
+}
+
+// Computes the layer state in which each then-layer is active if and only if all of its if-layers
+// are. Since a then-layer may be an if-layer of another config, passes repeat until the state
+// settles. Chains of configs settle within one pass per config, plus one to confirm it, which also
+// bounds configs that depend on each other in a cycle.
+static void resolve_then_layers(zmk_keymap_layers_state_t *state) {
+    const uint32_t *then_words = Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(&then_layers_state_mask);
+
+    for (int pass = 0; pass <= NUM_CONDITIONAL_LAYER_CFGS; pass++) {
+        zmk_keymap_layers_state_t next = *state;
+        uint32_t *next_words = Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(&next);
+
+        for (int w = 0; w < ZMK_KEYMAP_LAYERS_STATE_WORDS; w++) {
+            next_words[w] &= ~then_words[w];
+        }
+
+        for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
+            if (zmk_keymap_layers_state_contains(state, &if_layers_state_masks[i])) {
+                zmk_keymap_layers_state_write(&next, CONDITIONAL_LAYER_CFGS[i].then_layer, true);
+            }
+        }
+
+        if (zmk_keymap_layers_state_equal(&next, state)) {
+            return;
+        }
+
+        *state = next;
     }
 }
 
 static int layer_state_changed_listener(const zmk_event_t *ev) {
-    static bool conditional_layer_updates_needed;
+    zmk_keymap_layers_state_t layer_state = zmk_keymap_layer_state();
+    zmk_keymap_layers_state_t target_state = layer_state;
+    zmk_keymap_layers_state_t changed;
 
-    conditional_layer_updates_needed = true;
+    resolve_then_layers(&target_state);
+    zmk_keymap_layers_state_diff(&changed, &layer_state, &target_state);
 
-    // Semaphore ensures we don't re-enter the loop in the middle of doing update, and
-    // ensures that "waterfalling layer updates" are all processed to trigger subsequent
-    // nested conditional layers properly.
-    if (k_sem_take(&conditional_layer_sem, K_NO_WAIT) < 0) {
+    // Once the changes below are committed, the event they raise finds the resolved state and
+    // changes nothing, so then-layers never cascade through nested events.
+    if (zmk_keymap_layers_state_highest(&changed) == ZMK_KEYMAP_LAYER_ID_INVAL) {
         return 0;
     }
 
-    while (conditional_layer_updates_needed) {
-        int8_t max_then_layer = -1;
-        uint32_t then_layers = 0;
-        uint32_t then_layer_state = 0;
+    // Apply all then-layer changes together so their events all find the resolved state
+    zmk_keymap_layer_state_begin();
 
-        conditional_layer_updates_needed = false;
+    for (int w = 0; w < ZMK_KEYMAP_LAYERS_STATE_WORDS; w++) {
+        uint32_t word = Z_ZMK_KEYMAP_LAYERS_STATE_WORDS(&changed)[w];
 
-        // On layer state changes, examines each conditional layer config to determine if then-layer
-        // in the config should activate based on the currently active set of if-layers.
-        for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
-            const struct conditional_layer_cfg *cfg = CONDITIONAL_LAYER_CFGS + i;
-            zmk_keymap_layers_state_t mask = cfg->if_layers_state_mask;
-            then_layers |= BIT(cfg->then_layer);
-            max_then_layer = MAX(max_then_layer, cfg->then_layer);
-
-            // Activate then-layer if and only if all if-layers are already active. Note that we
-            // reevaluate the current layer state for each config since activation of one layer can
-            // also trigger activation of another.
-            if ((zmk_keymap_layer_state() & mask) == mask) {
-                then_layer_state |= BIT(cfg->then_layer);
-            }
-        }
+        while (word) {
+            zmk_keymap_layer_id_t layer = (w * 32) + __builtin_ctz(word);
 
-        for (uint8_t layer = 0; layer <= max_then_layer; layer++) {
-            if ((BIT(layer) & then_layers) != 0U) {
-                if ((BIT(layer) & then_layer_state) != 0U) {
-                    conditional_layer_activate(layer);
-                } else {
-                    conditional_layer_deactivate(layer);
-                }
+            word &= word - 1;
+
+            if (zmk_keymap_layers_state_test(&target_state, layer)) {
+                conditional_layer_activate(layer);
+            } else {
+                conditional_layer_deactivate(layer);
             }
         }
     }
 
-    k_sem_give(&conditional_layer_sem);
+    zmk_keymap_layer_state_commit();
     return 0;
 }
 
 ZMK_LISTENER(conditional_layer, layer_state_changed_listener);
 ZMK_SUBSCRIPTION(conditional_layer, zmk_layer_state_changed);
 
+static int conditional_layer_init(void) {
+    zmk_keymap_layers_state_clear(&then_layers_state_mask);
+
+    for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
+        const struct conditional_layer_cfg *cfg = CONDITIONAL_LAYER_CFGS + i;
+
+        zmk_keymap_layers_state_write(&then_layers_state_mask, cfg->then_layer, true);
+        zmk_keymap_layers_state_clear(&if_layers_state_masks[i]);
+        for (int j = 0; j < cfg->if_layers_len; j++) {
+            zmk_keymap_layers_state_write(&if_layers_state_masks[i], cfg->if_layers[j], true);
+        }
+    }
+
+    return 0;
+}
+
+SYS_INIT(conditional_layer_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
 #endif
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <lvgl.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display/glyph_label.h>
+
+// Status widgets only ever show a small set of characters: digits, a few symbols and the layer
+// names. Each glyph is converted to 1 bpp the first time it is drawn and kept, so a label update
+// only ORs cached rows into the label's alpha bitmap instead of going through LVGL's font
+// rendering for every glyph of every redraw. All of this runs on the display work queue.
+
+struct cached_glyph {
+    const lv_font_t *font;
+    uint32_t letter;
+    const uint8_t *bitmap;
+    uint16_t adv_w;
+    uint16_t box_w;
+    uint16_t box_h;
+    int16_t ofs_x;
+    int16_t ofs_y;
+};
+
+struct glyph_label {
+    uint8_t *buf;
+    size_t buf_size;
+};
+
+static struct cached_glyph glyphs[CONFIG_ZMK_DISPLAY_GLYPH_CACHE_GLYPHS];
+static size_t glyph_count;
+static uint8_t glyph_pool[CONFIG_ZMK_DISPLAY_GLYPH_CACHE_SIZE];
+static size_t glyph_pool_used;
+
+// Glyphs that don't fit in the cache any more are converted into this again on every use.
+static struct cached_glyph uncached_glyph;
+static uint8_t uncached_bitmap[128];
+
+static inline size_t glyph_stride(uint16_t box_w) { return DIV_ROUND_UP(box_w, 8); }
+
+static void convert_glyph(const lv_font_t *font, uint32_t letter, const lv_font_glyph_dsc_t *dsc,
+                          uint8_t *bitmap) {
+    const size_t stride = glyph_stride(dsc->box_w);
+    const uint8_t *src = lv_font_get_glyph_bitmap(font, letter);
+    // LVGL draws 3 bpp glyphs as 4 bpp as well.
+    const uint8_t bpp = dsc->bpp == 3 ? 4 : dsc->bpp;
+    const uint8_t mask = BIT(bpp) - 1;
+
+    memset(bitmap, 0, stride * dsc->box_h);
+
+    if (src == NULL) {
+        return;
+    }
+
+    // Source pixels are packed without padding between rows. Anything at least half covered is
+    // kept, anything less is dropped.
+    for (uint16_t y = 0; y < dsc->box_h; y++) {
+        for (uint16_t x = 0; x < dsc->box_w; x++) {
+            const size_t bit = (y * dsc->box_w + x) * bpp;
+            const uint8_t value = (src[bit / 8] >> (8 - bpp - bit % 8)) & mask;
+
+            if (value > mask / 2) {
+                bitmap[y * stride + x / 8] |= BIT(7 - x % 8);
+            }
+        }
+    }
+}
+
+static const struct cached_glyph *get_glyph(const lv_font_t *font, uint32_t letter) {
+    for (size_t i = 0; i < glyph_count; i++) {
+        if (glyphs[i].font == font && glyphs[i].letter == letter) {
+            return &glyphs[i];
+        }
+    }
+
+    lv_font_glyph_dsc_t dsc;
+    if (!lv_font_get_glyph_dsc(font, &dsc, letter, 0)) {
+        return NULL;
+    }
+
+    const size_t size = glyph_stride(dsc.box_w) * dsc.box_h;
+    struct cached_glyph *glyph;
+    uint8_t *bitmap;
+
+    if (glyph_count < ARRAY_SIZE(glyphs) && glyph_pool_used + size <= sizeof(glyph_pool)) {
+        glyph = &glyphs[glyph_count++];
+        bitmap = &glyph_pool[glyph_pool_used];
+        glyph_pool_used += size;
+    } else if (size <= sizeof(uncached_bitmap)) {
+        LOG_DBG("Glyph cache full, converting 0x%x on every use", letter);
+        glyph = &uncached_glyph;
+        bitmap = uncached_bitmap;
+    } else {
+        LOG_WRN("Glyph 0x%x is too large to draw", letter);
+        return NULL;
+    }
+
+    convert_glyph(font, letter, &dsc, bitmap);
+
+    *glyph = (struct cached_glyph){
+        .font = font,
+        .letter = letter,
+        .bitmap = bitmap,
+        .adv_w = dsc.adv_w,
+        .box_w = dsc.box_w,
+        .box_h = dsc.box_h,
+        .ofs_x = dsc.ofs_x,
+        .ofs_y = dsc.ofs_y,
+    };
+
+    return glyph;
+}
+
+static void blit_glyph(uint8_t *buf, size_t stride, lv_coord_t width, lv_coord_t height,
+                       const struct cached_glyph *glyph, lv_coord_t x, lv_coord_t y) {
+    const size_t src_stride = glyph_stride(glyph->box_w);
+
+    for (uint16_t row = 0; row < glyph->box_h; row++) {
+        const lv_coord_t dest_y = y + row;
+
+        if (dest_y < 0 || dest_y >= height) {
+            continue;
+        }
+
+        uint8_t *dest = &buf[dest_y * stride];
+        const uint8_t *src = &glyph->bitmap[row * src_stride];
+
+        for (size_t i = 0; i < src_stride; i++) {
+            const lv_coord_t dest_x = x + i * 8;
+
+            if (dest_x <= -8 || dest_x >= width) {
+                continue;
+            }
+
+            if (dest_x < 0) {
+                dest[0] |= src[i] << -dest_x;
+                continue;
+            }
+
+            dest[dest_x / 8] |= src[i] >> (dest_x % 8);
+            if (dest_x % 8 != 0 && dest_x / 8 + 1 < stride) {
+                dest[dest_x / 8 + 1] |= src[i] << (8 - dest_x % 8);
+            }
+        }
+    }
+}
+
+void zmk_glyph_label_set_text(lv_obj_t *obj, const char *text) {
+    struct glyph_label *label = lv_obj_get_user_data(obj);
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    const lv_coord_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
+    const lv_color_t color = lv_obj_get_style_text_color(obj, LV_PART_MAIN);
+    lv_coord_t width = 0;
+    uint32_t i = 0;
+
+    while (text[i] != '\0') {
+        const struct cached_glyph *glyph = get_glyph(font, _lv_txt_encoded_next(text, &i));
+
+        if (glyph != NULL) {
+            width += glyph->adv_w + letter_space;
+        }
+    }
+
+    // Keep a one pixel wide image for empty text, so the label still has its line height.
+    width = MAX(width, 1);
+
+    const lv_coord_t height = font->line_height;
+    const size_t stride = DIV_ROUND_UP(width, 8);
+    const size_t size = stride * height;
+
+    if (size > label->buf_size) {
+        uint8_t *buf = lv_mem_realloc(label->buf, size);
+
+        if (buf == NULL) {
+            LOG_ERR("Failed to allocate the label text bitmap");
+            return;
+        }
+
+        label->buf = buf;
+        label->buf_size = size;
+    }
+
+    memset(label->buf, 0, size);
+
+    lv_coord_t pen_x = 0;
+    i = 0;
+
+    while (text[i] != '\0') {
+        const struct cached_glyph *glyph = get_glyph(font, _lv_txt_encoded_next(text, &i));
+
+        if (glyph == NULL) {
+            continue;
+        }
+
+        blit_glyph(label->buf, stride, width, height, glyph, pen_x + glyph->ofs_x,
+                   font->line_height - font->base_line - glyph->box_h - glyph->ofs_y);
+        pen_x += glyph->adv_w + letter_space;
+    }
+
+    // Alpha only images are drawn in the recolor color.
+    if (lv_obj_get_style_img_recolor(obj, LV_PART_MAIN).full != color.full) {
+        lv_obj_set_style_img_recolor(obj, color, LV_PART_MAIN);
+    }
+
+    // Setting the buffer again resizes the object and drops the old image from LVGL's cache.
+    lv_canvas_set_buffer(obj, label->buf, width, height, LV_IMG_CF_ALPHA_1BIT);
+}
+
+static void glyph_label_delete_cb(lv_event_t *e) {
+    struct glyph_label *label = lv_event_get_user_data(e);
+
+    lv_mem_free(label->buf);
+    lv_mem_free(label);
+}
+
+lv_obj_t *zmk_glyph_label_create(lv_obj_t *parent) {
+    struct glyph_label *label = lv_mem_alloc(sizeof(struct glyph_label));
+
+    if (label == NULL) {
+        LOG_ERR("Failed to allocate glyph label");
+        return NULL;
+    }
+
+    *label = (struct glyph_label){};
+
+    lv_obj_t *obj = lv_canvas_create(parent);
+    lv_obj_set_user_data(obj, label);
+    lv_obj_add_event_cb(obj, glyph_label_delete_cb, LV_EVENT_DELETE, label);
+
+    zmk_glyph_label_set_text(obj, "");
+
+    return obj;
+}
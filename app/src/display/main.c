@@ -21,6 +21,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/event_manager.h>
 #include <zmk/events/activity_state_changed.h>
 #include <zmk/display/status_screen.h>
+#include <zmk/energy.h>
+#include <zmk/workqueue.h>
 
 static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
 
@@ -37,10 +39,6 @@ static lv_obj_t *screen;
 
 __attribute__((weak)) lv_obj_t *zmk_display_status_screen() { return NULL; }
 
-void display_tick_cb(struct k_work *work) { lv_task_handler(); }
-
-K_WORK_DEFINE(display_tick_work, display_tick_cb);
-
 #if IS_ENABLED(CONFIG_ZMK_DISPLAY_WORK_QUEUE_DEDICATED)
 
 K_THREAD_STACK_DEFINE(display_work_stack_area, CONFIG_ZMK_DISPLAY_DEDICATED_THREAD_STACK_SIZE);
@@ -57,9 +55,68 @@ struct k_work_q *zmk_display_work_q() {
 #endif
 }
 
-void display_timer_cb() { k_work_submit_to_queue(zmk_display_work_q(), &display_tick_work); }
+// LVGL runs every tick period only while something is animating or waiting to be drawn. Once the
+// UI is static, it runs when a widget changes, and otherwise only every idle tick period for LVGL's
+// own timers. After each run, the display work waits long enough to keep LVGL within its share of
+// the CPU, so long redraws during typing bursts leave room for input processing.
+
+// Only accessed from the display work queue.
+static bool ticking = false;
+static int64_t next_tick_allowed;
+
+ZMK_WORKQUEUE_PROFILE_HANDLER(display_tick_cb);
 
-K_TIMER_DEFINE(display_timer, display_timer_cb, NULL);
+K_WORK_DELAYABLE_DEFINE(display_tick_work, ZMK_WORKQUEUE_PROFILED(display_tick_cb));
+
+static bool display_ui_busy(void) {
+    lv_disp_t *disp = lv_disp_get_default();
+
+    return lv_anim_count_running() > 0 || (disp != NULL && disp->inv_p > 0);
+}
+
+static void display_tick_cb(struct k_work *work) {
+    const int64_t start = k_uptime_get();
+    lv_disp_t *disp = lv_disp_get_default();
+
+    // Areas invalidated before the handler runs are redrawn and flushed to the display by it.
+    if (disp != NULL && disp->inv_p > 0) {
+        zmk_energy_display_refreshed();
+    }
+
+    uint32_t delay = lv_task_handler();
+    const int64_t elapsed = k_uptime_get() - start;
+
+    if (!ticking) {
+        return;
+    }
+
+    // LVGL reports when its next timer is due, but while static that is just the refresh timer.
+    delay = display_ui_busy() ? MAX(delay, CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS)
+                              : CONFIG_ZMK_DISPLAY_IDLE_TICK_PERIOD_MS;
+
+    const uint32_t budget_wait = elapsed * (100 - CONFIG_ZMK_DISPLAY_MAX_CPU_PERCENT) /
+                                 CONFIG_ZMK_DISPLAY_MAX_CPU_PERCENT;
+    next_tick_allowed = start + elapsed + budget_wait;
+
+    k_work_reschedule_for_queue(zmk_display_work_q(), &display_tick_work,
+                                K_MSEC(MAX(delay, budget_wait)));
+}
+
+void zmk_display_request_tick(void) {
+    if (!ticking) {
+        return;
+    }
+
+    const int64_t wait = MAX(next_tick_allowed - k_uptime_get(), 0);
+
+    // Never push back a tick that is already due sooner.
+    if (k_work_delayable_is_pending(&display_tick_work) &&
+        k_ticks_to_ms_ceil64(k_work_delayable_remaining_get(&display_tick_work)) <= wait) {
+        return;
+    }
+
+    k_work_reschedule_for_queue(zmk_display_work_q(), &display_tick_work, K_MSEC(wait));
+}
 
 void unblank_display_cb(struct k_work *work) {
 #if DT_HAS_CHOSEN(zmk_display_led)
@@ -67,8 +124,8 @@ void unblank_display_cb(struct k_work *work) {
 #endif
     display_blanking_off(display);
 #if !IS_ENABLED(CONFIG_ARCH_POSIX)
-    k_timer_start(&display_timer, K_MSEC(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS),
-                  K_MSEC(CONFIG_ZMK_DISPLAY_TICK_PERIOD_MS));
+    ticking = true;
+    k_work_reschedule_for_queue(zmk_display_work_q(), &display_tick_work, K_NO_WAIT);
 #endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
 }
 
@@ -76,7 +133,8 @@ void unblank_display_cb(struct k_work *work) {
 
 void blank_display_cb(struct k_work *work) {
 #if !IS_ENABLED(CONFIG_ARCH_POSIX)
-    k_timer_stop(&display_timer);
+    ticking = false;
+    k_work_cancel_delayable(&display_tick_work);
 #endif // !IS_ENABLED(CONFIG_ARCH_POSIX)
     display_blanking_on(display);
 #if DT_HAS_CHOSEN(zmk_display_led)
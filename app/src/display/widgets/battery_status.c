@@ -11,6 +11,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/battery.h>
 #include <zmk/display.h>
+#include <zmk/display/glyph_label.h>
 #include <zmk/display/widgets/battery_status.h>
 #include <zmk/usb.h>
 #include <zmk/events/usb_conn_state_changed.h>
@@ -54,7 +55,7 @@ static void set_battery_symbol(lv_obj_t *label, struct battery_status_state stat
         strcat(text, LV_SYMBOL_BATTERY_EMPTY);
     }
 #endif
-    lv_label_set_text(label, text);
+    zmk_glyph_label_set_text(label, text);
 }
 
 void battery_status_update_cb(struct battery_status_state state) {
@@ -76,13 +77,14 @@ static struct battery_status_state battery_status_get_state(const zmk_event_t *e
 ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_status, struct battery_status_state,
                             battery_status_update_cb, battery_status_get_state)
 
-ZMK_SUBSCRIPTION(widget_battery_status, zmk_battery_state_changed);
+ZMK_SUBSCRIPTION_COALESCED(widget_battery_status, zmk_battery_state_changed,
+                           CONFIG_ZMK_DISPLAY_WIDGET_EVENT_COALESCE_MS);
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
-ZMK_SUBSCRIPTION(widget_battery_status, zmk_usb_conn_state_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_battery_status, zmk_usb_conn_state_changed, OBSERVER);
 #endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
 
 int zmk_widget_battery_status_init(struct zmk_widget_battery_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+    widget->obj = zmk_glyph_label_create(parent);
 
     sys_slist_append(&widgets, &widget->node);
 
@@ -10,6 +10,7 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
+#include <zmk/display/glyph_label.h>
 #include <zmk/display/widgets/output_status.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/ble_active_profile_changed.h>
@@ -57,7 +58,7 @@ static void set_status_symbol(lv_obj_t *label, struct output_status_state state)
         break;
     }
 
-    lv_label_set_text(label, text);
+    zmk_glyph_label_set_text(label, text);
 }
 
 static void output_status_update_cb(struct output_status_state state) {
@@ -67,15 +68,15 @@ static void output_status_update_cb(struct output_status_state state) {
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_output_status, struct output_status_state,
                             output_status_update_cb, get_state)
-ZMK_SUBSCRIPTION(widget_output_status, zmk_endpoint_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_output_status, zmk_endpoint_changed, OBSERVER);
 // We don't get an endpoint changed event when the active profile connects/disconnects
 // but there wasn't another endpoint to switch from/to, so update on BLE events too.
 #if defined(CONFIG_ZMK_BLE)
-ZMK_SUBSCRIPTION(widget_output_status, zmk_ble_active_profile_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_output_status, zmk_ble_active_profile_changed, OBSERVER);
 #endif
 
 int zmk_widget_output_status_init(struct zmk_widget_output_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+    widget->obj = zmk_glyph_label_create(parent);
 
     sys_slist_append(&widgets, &widget->node);
 
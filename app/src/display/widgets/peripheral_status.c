@@ -10,6 +10,7 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
+#include <zmk/display/glyph_label.h>
 #include <zmk/display/widgets/peripheral_status.h>
 #include <zmk/event_manager.h>
 #include <zmk/split/bluetooth/peripheral.h>
@@ -30,7 +31,7 @@ static void set_status_symbol(lv_obj_t *label, struct peripheral_status_state st
         state.connected ? (LV_SYMBOL_WIFI " " LV_SYMBOL_OK) : (LV_SYMBOL_WIFI " " LV_SYMBOL_CLOSE);
 
     LOG_DBG("connected? %s", state.connected ? "true" : "false");
-    lv_label_set_text(label, text);
+    zmk_glyph_label_set_text(label, text);
 }
 
 static void output_status_update_cb(struct peripheral_status_state state) {
@@ -40,11 +41,11 @@ static void output_status_update_cb(struct peripheral_status_state state) {
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_peripheral_status, struct peripheral_status_state,
                             output_status_update_cb, get_state)
-ZMK_SUBSCRIPTION(widget_peripheral_status, zmk_split_peripheral_status_changed);
+ZMK_SUBSCRIPTION_PRIORITY(widget_peripheral_status, zmk_split_peripheral_status_changed, OBSERVER);
 
 int zmk_widget_peripheral_status_init(struct zmk_widget_peripheral_status *widget,
                                       lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+    widget->obj = zmk_glyph_label_create(parent);
 
     sys_slist_append(&widgets, &widget->node);
 
@@ -8,6 +8,7 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
+#include <zmk/display/glyph_label.h>
 #include <zmk/display/widgets/wpm_status.h>
 #include <zmk/events/wpm_state_changed.h>
 #include <zmk/event_manager.h>
@@ -30,7 +31,7 @@ void set_wpm_symbol(lv_obj_t *label, struct wpm_status_state state) {
     LOG_DBG("WPM changed to %i", state.wpm);
     snprintf(text, sizeof(text), "%i", state.wpm);
 
-    lv_label_set_text(label, text);
+    zmk_glyph_label_set_text(label, text);
     lv_obj_align(label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
 }
 
@@ -41,10 +42,11 @@ void wpm_status_update_cb(struct wpm_status_state state) {
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_wpm_status, struct wpm_status_state, wpm_status_update_cb,
                             wpm_status_get_state)
-ZMK_SUBSCRIPTION(widget_wpm_status, zmk_wpm_state_changed);
+ZMK_SUBSCRIPTION_COALESCED(widget_wpm_status, zmk_wpm_state_changed,
+                           CONFIG_ZMK_DISPLAY_WIDGET_EVENT_COALESCE_MS);
 
 int zmk_widget_wpm_status_init(struct zmk_widget_wpm_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+    widget->obj = zmk_glyph_label_create(parent);
     lv_obj_align(widget->obj, LV_ALIGN_RIGHT_MID, 0, 0);
 
     sys_slist_append(&widgets, &widget->node);
@@ -6,8 +6,10 @@
 
 #include <zephyr/init.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
 
 #include <stdio.h>
+#include <string.h>
 
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
@@ -15,10 +17,13 @@
 #include <dt-bindings/zmk/hid_usage_pages.h>
 #include <zmk/usb_hid.h>
 #include <zmk/hog.h>
+#include <zmk/settings.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/ble_active_profile_changed.h>
 #include <zmk/events/usb_conn_state_changed.h>
 #include <zmk/events/endpoint_changed.h>
+#include <zmk/telemetry.h>
+#include <zmk/latency_probe.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -31,18 +36,87 @@ static enum zmk_transport preferred_transport =
     ZMK_TRANSPORT_USB; /* Used if multiple endpoints are ready */
 
 static void update_current_endpoint(void);
+static bool is_usb_ready(void);
+static bool is_ble_ready(void);
+
+#define TRANSPORT_COUNT (ZMK_TRANSPORT_BLE + 1)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+// The consumer usages are part of the keyboard report, which is sent for changes to either.
+typedef struct zmk_hid_composite_report_body keyboard_report_body_t;
+#define KEYBOARD_REPORT_BODY (&zmk_hid_get_composite_report()->body)
+#else
+typedef struct zmk_hid_keyboard_report_body keyboard_report_body_t;
+#define KEYBOARD_REPORT_BODY (&zmk_hid_get_keyboard_report()->body)
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
+#define CONSUMER_REPORT_BODY (&zmk_hid_get_consumer_report()->body)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
+
+// The last report successfully sent to each transport for each report type. Listeners may ask for
+// a report to be sent without it having changed, which would otherwise cost a whole USB transfer
+// or BLE notification.
+static keyboard_report_body_t last_keyboard_report[TRANSPORT_COUNT];
+static bool last_keyboard_report_valid[TRANSPORT_COUNT];
+static struct zmk_hid_consumer_report_body last_consumer_report[TRANSPORT_COUNT];
+static bool last_consumer_report_valid[TRANSPORT_COUNT];
+
+static void invalidate_last_reports(void) {
+    memset(last_keyboard_report_valid, 0, sizeof(last_keyboard_report_valid));
+    memset(last_consumer_report_valid, 0, sizeof(last_consumer_report_valid));
+}
+
+// Returns true if the report matches the last one sent. Otherwise, records the report as the last
+// one sent, assuming the caller is about to send it.
+static bool report_unchanged(void *last, bool *last_valid, const void *report, size_t len) {
+    if (*last_valid && memcmp(last, report, len) == 0) {
+        return true;
+    }
+
+    memcpy(last, report, len);
+    *last_valid = true;
+    return false;
+}
+
+#define SKIP_IF_UNCHANGED(_type, _transport, _body)                                                \
+    do {                                                                                           \
+        if (report_unchanged(&last_##_type##_report[_transport],                                   \
+                             &last_##_type##_report_valid[_transport], _body,                      \
+                             sizeof(last_##_type##_report[0]))) {                                  \
+            LOG_DBG("Skipping unchanged " #_type " report");                                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+// A failed send leaves the host state unknown, so the next report has to go out regardless.
+#define RECORD_SEND_RESULT(_type, _transport, _err)                                                \
+    do {                                                                                           \
+        if (_err) {                                                                                \
+            last_##_type##_report_valid[_transport] = false;                                       \
+        }                                                                                          \
+    } while (0)
+
+#else
+
+static void invalidate_last_reports(void) {}
+
+#define SKIP_IF_UNCHANGED(_type, _transport, _body)
+#define RECORD_SEND_RESULT(_type, _transport, _err)
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_SKIP_UNCHANGED_REPORTS)
 
 #if IS_ENABLED(CONFIG_SETTINGS)
-static void endpoints_save_preferred_work(struct k_work *work) {
+static void endpoints_save_preferred_cb(void) {
     settings_save_one("endpoints/preferred", &preferred_transport, sizeof(preferred_transport));
 }
 
-static struct k_work_delayable endpoints_save_work;
+ZMK_SETTINGS_SAVE_DEFINE(endpoints_save, endpoints_save_preferred_cb);
 #endif
 
 static int endpoints_save_preferred(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
-    return k_work_reschedule(&endpoints_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    return zmk_settings_save_schedule(&endpoints_save);
 #else
     return 0;
 #endif
@@ -118,8 +192,8 @@ int zmk_endpoints_toggle_transport(void) {
 
 struct zmk_endpoint_instance zmk_endpoints_selected(void) { return current_instance; }
 
-static int send_keyboard_report(void) {
-    switch (current_instance.transport) {
+static int send_keyboard_report_to_transport(enum zmk_transport transport) {
+    switch (transport) {
     case ZMK_TRANSPORT_USB: {
 #if IS_ENABLED(CONFIG_ZMK_USB)
         int err = zmk_usb_hid_send_keyboard_report();
@@ -135,8 +209,11 @@ static int send_keyboard_report(void) {
 
     case ZMK_TRANSPORT_BLE: {
 #if IS_ENABLED(CONFIG_ZMK_BLE)
-        struct zmk_hid_keyboard_report *keyboard_report = zmk_hid_get_keyboard_report();
-        int err = zmk_hog_send_keyboard_report(&keyboard_report->body);
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+        int err = zmk_hog_send_composite_report(KEYBOARD_REPORT_BODY);
+#else
+        int err = zmk_hog_send_keyboard_report(KEYBOARD_REPORT_BODY);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
         if (err) {
             LOG_ERR("FAILED TO SEND OVER HOG: %d", err);
         }
@@ -148,12 +225,13 @@ static int send_keyboard_report(void) {
     }
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
+    LOG_ERR("Unhandled endpoint transport %d", transport);
     return -ENOTSUP;
 }
 
-static int send_consumer_report(void) {
-    switch (current_instance.transport) {
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+static int send_consumer_report_to_transport(enum zmk_transport transport) {
+    switch (transport) {
     case ZMK_TRANSPORT_USB: {
 #if IS_ENABLED(CONFIG_ZMK_USB)
         int err = zmk_usb_hid_send_consumer_report();
@@ -169,8 +247,7 @@ static int send_consumer_report(void) {
 
     case ZMK_TRANSPORT_BLE: {
 #if IS_ENABLED(CONFIG_ZMK_BLE)
-        struct zmk_hid_consumer_report *consumer_report = zmk_hid_get_consumer_report();
-        int err = zmk_hog_send_consumer_report(&consumer_report->body);
+        int err = zmk_hog_send_consumer_report(CONSUMER_REPORT_BODY);
         if (err) {
             LOG_ERR("FAILED TO SEND OVER HOG: %d", err);
         }
@@ -182,19 +259,99 @@ static int send_consumer_report(void) {
     }
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
+    LOG_ERR("Unhandled endpoint transport %d", transport);
     return -ENOTSUP;
 }
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
+typedef int (*transport_send_fn)(enum zmk_transport transport);
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+// Every ready transport gets the report, USB first. Sending over BLE only queues the report for
+// the HOG work queue, so a congested link never holds back USB.
+static int send_to_outputs(transport_send_fn send) {
+    bool sent = false;
+    int ret = 0;
+
+    if (is_usb_ready()) {
+        ret = send(ZMK_TRANSPORT_USB);
+        sent = true;
+    }
+
+    if (is_ble_ready()) {
+        int err = send(ZMK_TRANSPORT_BLE);
+        ret = ret ? ret : err;
+        sent = true;
+    }
+
+    // With nothing ready, report the failure of the selected endpoint as usual.
+    return sent ? ret : send(current_instance.transport);
+}
+
+#else
+
+static int send_to_outputs(transport_send_fn send) { return send(current_instance.transport); }
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+static inline uint32_t telemetry_send_start(void) {
+    return IS_ENABLED(CONFIG_ZMK_TELEMETRY) ? k_cycle_get_32() : 0;
+}
+
+static inline void telemetry_send_done(enum zmk_transport transport, uint32_t start, int err) {
+    if (IS_ENABLED(CONFIG_ZMK_TELEMETRY)) {
+        uint32_t us = k_cyc_to_us_ceil32(k_cycle_get_32() - start);
+        zmk_telemetry_record(ZMK_TELEMETRY_HID_REPORT_SENT, transport, MIN(us, UINT16_MAX));
+    }
+
+    if (!err) {
+        zmk_latency_probe_report_sent(transport);
+    }
+}
+
+static int send_keyboard_report_on(enum zmk_transport transport) {
+    SKIP_IF_UNCHANGED(keyboard, transport, KEYBOARD_REPORT_BODY);
+
+    uint32_t start = telemetry_send_start();
+    int err = send_keyboard_report_to_transport(transport);
+    telemetry_send_done(transport, start, err);
+
+    // Lets a replayed trace be checked against the reports sent when it was recorded.
+    if (IS_ENABLED(CONFIG_ZMK_TELEMETRY) && !err) {
+        zmk_telemetry_record(ZMK_TELEMETRY_KEYBOARD_REPORT, transport,
+                             crc16_ansi((const uint8_t *)KEYBOARD_REPORT_BODY,
+                                        sizeof(keyboard_report_body_t)));
+    }
+    RECORD_SEND_RESULT(keyboard, transport, err);
+    return err;
+}
+
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+static int send_consumer_report_on(enum zmk_transport transport) {
+    SKIP_IF_UNCHANGED(consumer, transport, CONSUMER_REPORT_BODY);
+
+    uint32_t start = telemetry_send_start();
+    int err = send_consumer_report_to_transport(transport);
+    telemetry_send_done(transport, start, err);
+    RECORD_SEND_RESULT(consumer, transport, err);
+    return err;
+}
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
 
 int zmk_endpoints_send_report(uint16_t usage_page) {
 
     LOG_DBG("usage page 0x%02X", usage_page);
     switch (usage_page) {
     case HID_USAGE_KEY:
-        return send_keyboard_report();
+        return send_to_outputs(send_keyboard_report_on);
 
     case HID_USAGE_CONSUMER:
-        return send_consumer_report();
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+        return send_to_outputs(send_keyboard_report_on);
+#else
+        return send_to_outputs(send_consumer_report_on);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
     }
 
     LOG_ERR("Unsupported usage page %d", usage_page);
@@ -202,8 +359,8 @@ int zmk_endpoints_send_report(uint16_t usage_page) {
 }
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
-int zmk_endpoints_send_mouse_report() {
-    switch (current_instance.transport) {
+static int send_mouse_report_to_transport(enum zmk_transport transport) {
+    switch (transport) {
     case ZMK_TRANSPORT_USB: {
 #if IS_ENABLED(CONFIG_ZMK_USB)
         int err = zmk_usb_hid_send_mouse_report();
@@ -232,9 +389,51 @@ int zmk_endpoints_send_mouse_report() {
     }
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
+    LOG_ERR("Unhandled endpoint transport %d", transport);
     return -ENOTSUP;
 }
+
+int zmk_endpoints_send_mouse_report() { return send_to_outputs(send_mouse_report_to_transport); }
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+static int send_abs_pointer_report_to_transport(enum zmk_transport transport) {
+    switch (transport) {
+    case ZMK_TRANSPORT_USB: {
+#if IS_ENABLED(CONFIG_ZMK_USB)
+        int err = zmk_usb_hid_send_abs_pointer_report();
+        if (err) {
+            LOG_ERR("FAILED TO SEND OVER USB: %d", err);
+        }
+        return err;
+#else
+        LOG_ERR("USB endpoint is not supported");
+        return -ENOTSUP;
+#endif /* IS_ENABLED(CONFIG_ZMK_USB) */
+    }
+
+    case ZMK_TRANSPORT_BLE: {
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+        struct zmk_hid_abs_pointer_report *abs_pointer_report = zmk_hid_get_abs_pointer_report();
+        int err = zmk_hog_send_abs_pointer_report(&abs_pointer_report->body);
+        if (err) {
+            LOG_ERR("FAILED TO SEND OVER HOG: %d", err);
+        }
+        return err;
+#else
+        LOG_ERR("BLE HOG endpoint is not supported");
+        return -ENOTSUP;
+#endif /* IS_ENABLED(CONFIG_ZMK_BLE) */
+    }
+    }
+
+    LOG_ERR("Unhandled endpoint transport %d", transport);
+    return -ENOTSUP;
+}
+
+int zmk_endpoints_send_abs_pointer_report(void) {
+    return send_to_outputs(send_abs_pointer_report_to_transport);
+}
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -320,10 +519,6 @@ static struct zmk_endpoint_instance get_selected_instance(void) {
 }
 
 static int zmk_endpoints_init(void) {
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&endpoints_save_work, endpoints_save_preferred_work);
-#endif
-
     current_instance = get_selected_instance();
 
     return 0;
@@ -348,6 +543,7 @@ static void update_current_endpoint(void) {
         zmk_endpoints_clear_current();
 
         current_instance = new_instance;
+        invalidate_last_reports();
 
         char endpoint_str[ZMK_ENDPOINT_STR_LEN];
         zmk_endpoint_instance_to_str(current_instance, endpoint_str, sizeof(endpoint_str));
@@ -358,6 +554,8 @@ static void update_current_endpoint(void) {
 }
 
 static int endpoint_listener(const zmk_event_t *eh) {
+    // A reconnected host starts with nothing pressed, whatever was last sent to it.
+    invalidate_last_reports();
     update_current_endpoint();
     return 0;
 }
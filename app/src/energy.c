@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+
+#if IS_ENABLED(CONFIG_BT)
+#include <zephyr/bluetooth/conn.h>
+#endif // IS_ENABLED(CONFIG_BT)
+
+#if IS_ENABLED(CONFIG_ZMK_ENERGY_SHELL)
+#include <zephyr/shell/shell.h>
+#endif // IS_ENABLED(CONFIG_ZMK_ENERGY_SHELL)
+
+#include <zmk/activity.h>
+#include <zmk/battery.h>
+#include <zmk/energy.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+// Charges are accumulated in µA·ms, which is 1/3600000 µAh.
+#define UA_MS_PER_UAH 3600000ULL
+
+// Accounting is updated from the threads the loads and connections change on, and read from the
+// shell's.
+static struct k_spinlock lock;
+
+static int64_t cleared_ms;
+static uint64_t cpu_cycles_at_clear;
+static uint8_t battery_at_clear;
+
+static enum zmk_activity_state activity_state = ZMK_ACTIVITY_ACTIVE;
+static int64_t activity_since_ms;
+static uint64_t active_ms;
+static uint64_t idle_ms;
+
+struct duty_account {
+    uint16_t permille;
+    int64_t since_ms;
+    // Duty integrated over time, in permille·ms.
+    uint64_t permille_ms;
+};
+
+static struct duty_account loads[ZMK_ENERGY_LOADS];
+
+static uint32_t display_refreshes;
+
+static void accrue_duty(struct duty_account *account, int64_t now) {
+    account->permille_ms += (uint64_t)account->permille * (now - account->since_ms);
+    account->since_ms = now;
+}
+
+static void accrue_activity(int64_t now) {
+    if (activity_state == ZMK_ACTIVITY_ACTIVE) {
+        active_ms += now - activity_since_ms;
+    } else {
+        idle_ms += now - activity_since_ms;
+    }
+    activity_since_ms = now;
+}
+
+void zmk_energy_set_duty(enum zmk_energy_load load, uint16_t permille) {
+    const int64_t now = k_uptime_get();
+
+    K_SPINLOCK(&lock) {
+        accrue_duty(&loads[load], now);
+        loads[load].permille = MIN(permille, 1000);
+    }
+}
+
+void zmk_energy_display_refreshed(void) {
+    K_SPINLOCK(&lock) { display_refreshes++; }
+}
+
+static uint64_t cpu_cycles(void) {
+    k_thread_runtime_stats_t stats;
+
+    if (k_thread_runtime_stats_all_get(&stats) < 0) {
+        return 0;
+    }
+
+    return stats.total_cycles;
+}
+
+static uint8_t battery_state_of_charge(void) {
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    return zmk_battery_state_of_charge();
+#else
+    return 0;
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+}
+
+#if IS_ENABLED(CONFIG_BT)
+
+// The radio is on for about CONFIG_ZMK_ENERGY_RADIO_EVENT_US each connection interval, so each
+// connection counts the events it had at the intervals it was connected with.
+struct conn_account {
+    bool connected;
+    bool split;
+    // Connection interval, in units of 1.25 ms.
+    uint16_t interval;
+    int64_t since_ms;
+};
+
+static struct conn_account conns[CONFIG_BT_MAX_CONN];
+static uint64_t host_conn_events;
+static uint64_t split_conn_events;
+
+static void accrue_conn(struct conn_account *account, int64_t now) {
+    if (!account->connected || account->interval == 0) {
+        return;
+    }
+
+    const uint64_t events = (now - account->since_ms) * 4 / (account->interval * 5);
+
+    // Only whole events are counted, so the remainder is left for the next accrual.
+    account->since_ms += events * account->interval * 5 / 4;
+
+    if (account->split) {
+        split_conn_events += events;
+    } else {
+        host_conn_events += events;
+    }
+}
+
+static void conn_account_update(struct bt_conn *conn, bool connected) {
+    struct bt_conn_info info;
+    const int64_t now = k_uptime_get();
+
+    if (bt_conn_get_info(conn, &info) < 0 || info.type != BT_CONN_TYPE_LE) {
+        return;
+    }
+
+    K_SPINLOCK(&lock) {
+        struct conn_account *account = &conns[bt_conn_index(conn)];
+
+        accrue_conn(account, now);
+
+        if (!account->connected) {
+            account->since_ms = now;
+        }
+
+        account->connected = connected;
+        account->interval = info.le.interval;
+        // The central connects to the split peripherals, and a peripheral only to the central.
+        account->split = IS_ENABLED(CONFIG_ZMK_SPLIT_BLE) &&
+                         (!IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) ||
+                          info.role == BT_CONN_ROLE_CENTRAL);
+    }
+}
+
+static void energy_connected(struct bt_conn *conn, uint8_t err) {
+    if (err == 0) {
+        conn_account_update(conn, true);
+    }
+}
+
+static void energy_disconnected(struct bt_conn *conn, uint8_t reason) {
+    conn_account_update(conn, false);
+}
+
+static void energy_le_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+                                    uint16_t timeout) {
+    conn_account_update(conn, true);
+}
+
+BT_CONN_CB_DEFINE(energy_conn_callbacks) = {
+    .connected = energy_connected,
+    .disconnected = energy_disconnected,
+    .le_param_updated = energy_le_param_updated,
+};
+
+#endif // IS_ENABLED(CONFIG_BT)
+
+static uint32_t ua_ms_to_uah(uint64_t ua_ms) { return ua_ms / UA_MS_PER_UAH; }
+
+void zmk_energy_get_report(struct zmk_energy_report *report) {
+    const int64_t now = k_uptime_get();
+    const uint64_t cpu_ms = k_cyc_to_ms_floor64(cpu_cycles() - cpu_cycles_at_clear);
+
+    memset(report, 0, sizeof(*report));
+
+    K_SPINLOCK(&lock) {
+        accrue_activity(now);
+        for (int i = 0; i < ZMK_ENERGY_LOADS; i++) {
+            accrue_duty(&loads[i], now);
+            report->load_full_duty_ms[i] = loads[i].permille_ms / 1000;
+        }
+
+#if IS_ENABLED(CONFIG_BT)
+        for (int i = 0; i < ARRAY_SIZE(conns); i++) {
+            accrue_conn(&conns[i], now);
+        }
+
+        report->host_conn_events = host_conn_events;
+        report->split_conn_events = split_conn_events;
+#endif // IS_ENABLED(CONFIG_BT)
+
+        report->elapsed_ms = now - cleared_ms;
+        report->active_ms = active_ms;
+        report->idle_ms = idle_ms;
+        report->display_refreshes = display_refreshes;
+    }
+
+    report->cpu_ms = cpu_ms;
+    report->battery_start = battery_at_clear;
+    report->battery_now = battery_state_of_charge();
+
+    const uint64_t radio_ua_ms_per_event =
+        (uint64_t)CONFIG_ZMK_ENERGY_RADIO_UA * CONFIG_ZMK_ENERGY_RADIO_EVENT_US / 1000;
+
+    report->charge_uah[ZMK_ENERGY_CONSUMER_BASE] =
+        ua_ms_to_uah((uint64_t)CONFIG_ZMK_ENERGY_BASE_UA * report->elapsed_ms);
+    report->charge_uah[ZMK_ENERGY_CONSUMER_CPU] =
+        ua_ms_to_uah((uint64_t)CONFIG_ZMK_ENERGY_CPU_UA * report->cpu_ms);
+    report->charge_uah[ZMK_ENERGY_CONSUMER_RADIO_HOST] =
+        ua_ms_to_uah(radio_ua_ms_per_event * report->host_conn_events);
+    report->charge_uah[ZMK_ENERGY_CONSUMER_RADIO_SPLIT] =
+        ua_ms_to_uah(radio_ua_ms_per_event * report->split_conn_events);
+    report->charge_uah[ZMK_ENERGY_CONSUMER_UNDERGLOW] = ua_ms_to_uah(
+        (uint64_t)CONFIG_ZMK_ENERGY_UNDERGLOW_UA * report->load_full_duty_ms[ZMK_ENERGY_UNDERGLOW]);
+    report->charge_uah[ZMK_ENERGY_CONSUMER_BACKLIGHT] = ua_ms_to_uah(
+        (uint64_t)CONFIG_ZMK_ENERGY_BACKLIGHT_UA * report->load_full_duty_ms[ZMK_ENERGY_BACKLIGHT]);
+    report->charge_uah[ZMK_ENERGY_CONSUMER_DISPLAY] =
+        ua_ms_to_uah((uint64_t)CONFIG_ZMK_ENERGY_DISPLAY_REFRESH_NC * report->display_refreshes);
+}
+
+void zmk_energy_clear(void) {
+    const int64_t now = k_uptime_get();
+    const uint64_t cycles = cpu_cycles();
+
+    K_SPINLOCK(&lock) {
+        cleared_ms = now;
+        cpu_cycles_at_clear = cycles;
+
+        activity_since_ms = now;
+        active_ms = 0;
+        idle_ms = 0;
+
+        for (int i = 0; i < ZMK_ENERGY_LOADS; i++) {
+            loads[i].since_ms = now;
+            loads[i].permille_ms = 0;
+        }
+
+        display_refreshes = 0;
+
+#if IS_ENABLED(CONFIG_BT)
+        for (int i = 0; i < ARRAY_SIZE(conns); i++) {
+            conns[i].since_ms = now;
+        }
+
+        host_conn_events = 0;
+        split_conn_events = 0;
+#endif // IS_ENABLED(CONFIG_BT)
+    }
+
+    battery_at_clear = battery_state_of_charge();
+}
+
+static int energy_activity_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+    const int64_t now = k_uptime_get();
+
+    K_SPINLOCK(&lock) {
+        accrue_activity(now);
+        activity_state = ev->state;
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(energy, energy_activity_listener);
+ZMK_SUBSCRIPTION_PRIORITY(energy, zmk_activity_state_changed, OBSERVER);
+
+static int energy_init(void) {
+    zmk_energy_clear();
+    return 0;
+}
+
+SYS_INIT(energy_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if IS_ENABLED(CONFIG_ZMK_ENERGY_SHELL)
+
+static const char *const consumer_names[ZMK_ENERGY_CONSUMERS] = {
+    [ZMK_ENERGY_CONSUMER_BASE] = "base",
+    [ZMK_ENERGY_CONSUMER_CPU] = "cpu",
+    [ZMK_ENERGY_CONSUMER_RADIO_HOST] = "radio (host)",
+    [ZMK_ENERGY_CONSUMER_RADIO_SPLIT] = "radio (split)",
+    [ZMK_ENERGY_CONSUMER_UNDERGLOW] = "underglow",
+    [ZMK_ENERGY_CONSUMER_BACKLIGHT] = "backlight",
+    [ZMK_ENERGY_CONSUMER_DISPLAY] = "display",
+};
+
+static void print_thread_cpu(const struct k_thread *thread, void *user_data) {
+    const struct shell *sh = user_data;
+    k_thread_runtime_stats_t stats;
+
+    if (k_thread_runtime_stats_get((k_tid_t)thread, &stats) < 0) {
+        return;
+    }
+
+    const char *name = k_thread_name_get((k_tid_t)thread);
+
+    shell_print(sh, "  %-32s %10llu ms", name ? name : "-",
+                k_cyc_to_ms_floor64(stats.execution_cycles));
+}
+
+static int cmd_energy_show(const struct shell *sh, size_t argc, char **argv) {
+    struct zmk_energy_report report;
+    uint32_t total_uah = 0;
+
+    zmk_energy_get_report(&report);
+
+    shell_print(sh, "Over %u ms (%u ms active, %u ms idle):", report.elapsed_ms,
+                report.active_ms, report.idle_ms);
+    shell_print(sh, "  cpu %u ms, host conn events %u, split conn events %u", report.cpu_ms,
+                report.host_conn_events, report.split_conn_events);
+    shell_print(sh, "  underglow %u ms, backlight %u ms at full duty, %u display refreshes",
+                report.load_full_duty_ms[ZMK_ENERGY_UNDERGLOW],
+                report.load_full_duty_ms[ZMK_ENERGY_BACKLIGHT], report.display_refreshes);
+
+    shell_print(sh, "%-16s %10s", "consumer", "est. µAh");
+    for (int i = 0; i < ZMK_ENERGY_CONSUMERS; i++) {
+        shell_print(sh, "%-16s %10u", consumer_names[i], report.charge_uah[i]);
+        total_uah += report.charge_uah[i];
+    }
+    shell_print(sh, "%-16s %10u", "total", total_uah);
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    shell_print(sh, "Battery went from %u%% to %u%%", report.battery_start, report.battery_now);
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+    shell_print(sh, "CPU time of each thread since boot:");
+    k_thread_foreach_unlocked(print_thread_cpu, (void *)sh);
+
+    return 0;
+}
+
+static int cmd_energy_clear(const struct shell *sh, size_t argc, char **argv) {
+    zmk_energy_clear();
+    shell_print(sh, "Energy accounting restarted");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_energy,
+                               SHELL_CMD(show, NULL, "Print the estimated charge of each consumer",
+                                         cmd_energy_show),
+                               SHELL_CMD(clear, NULL, "Restart accounting from now",
+                                         cmd_energy_clear),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(energy, &sub_energy, "ZMK energy accounting", NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_ENERGY_SHELL)
@@ -5,11 +5,15 @@
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/init.h>
 #include <zephyr/logging/log.h>
+#include <string.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/event_manager.h>
+#include <zmk/queue_stats.h>
+#include <zmk/workqueue.h>
 
 extern struct zmk_event_type *__event_type_start[];
 extern struct zmk_event_type *__event_type_end[];
@@ -17,16 +21,156 @@ extern struct zmk_event_type *__event_type_end[];
 extern struct zmk_event_subscription __event_subscriptions_start[];
 extern struct zmk_event_subscription __event_subscriptions_end[];
 
-int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_DEFER_OBSERVERS)
+
+struct deferred_event_slot {
+    uint8_t data[CONFIG_ZMK_EVENT_MANAGER_DEFERRED_SLOT_SIZE] __aligned(8);
+    uint8_t start_index;
+};
+
+K_MSGQ_DEFINE(deferred_events_msgq, sizeof(struct deferred_event_slot),
+              CONFIG_ZMK_EVENT_MANAGER_DEFERRED_QUEUE_SIZE, 8);
+
+ZMK_QUEUE_STATS_DEFINE(deferred_events_msgq, "deferred events",
+                       CONFIG_ZMK_EVENT_MANAGER_DEFERRED_QUEUE_SIZE);
+
+ZMK_WORKQUEUE_PROFILE_HANDLER(deferred_events_work_cb);
+
+static K_WORK_DEFINE(deferred_events_work, ZMK_WORKQUEUE_PROFILED(deferred_events_work_cb));
+
+static int defer_event(const zmk_event_t *event, size_t size, uint8_t start_index) {
+    if (size > CONFIG_ZMK_EVENT_MANAGER_DEFERRED_SLOT_SIZE) {
+        LOG_ERR("Event %s is too large to defer (%d > %d)", event->event->name, (int)size,
+                CONFIG_ZMK_EVENT_MANAGER_DEFERRED_SLOT_SIZE);
+        return -EMSGSIZE;
+    }
+
+    struct deferred_event_slot slot = {.start_index = start_index};
+    memcpy(slot.data, event, size);
+
+    int ret =
+        ZMK_QUEUE_STATS_MSGQ_PUT(deferred_events_msgq, &deferred_events_msgq, &slot, K_NO_WAIT);
+    if (ret < 0) {
+        LOG_WRN("Deferred event queue full, unable to defer %s", event->event->name);
+        return -ENOMEM;
+    }
+
+    ZMK_WORKQUEUE_PROFILE_SUBMITTED(deferred_events_work_cb);
+    k_work_submit(&deferred_events_work);
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_DEFER_OBSERVERS)
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+
+// Statistics are updated without locking; events raised concurrently from several threads may
+// occasionally lose a sample, which is acceptable for profiling purposes.
+static void record_timing(struct zmk_event_timing_stats *stats, uint32_t cycles) {
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+    uint8_t bucket = 0;
+
+    while (us > 0 && bucket < ZMK_EVENT_TIMING_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+
+    if (stats->count == 0 || cycles < stats->min_cycles) {
+        stats->min_cycles = cycles;
+    }
+    stats->max_cycles = MAX(stats->max_cycles, cycles);
+    stats->total_cycles += cycles;
+    stats->buckets[bucket]++;
+    stats->count++;
+}
+
+static int call_listener(struct zmk_event_subscription *ev_sub, zmk_event_t *event) {
+    uint32_t start = k_cycle_get_32();
+    int ret = ev_sub->callback(event);
+    record_timing(&ev_sub->timing, k_cycle_get_32() - start);
+
+    return ret;
+}
+
+#else
+
+static inline int call_listener(struct zmk_event_subscription *ev_sub, zmk_event_t *event) {
+    return ev_sub->callback(event);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+
+static void coalesce_event(struct zmk_event_coalescing *coalescing, const zmk_event_t *event) {
+    k_spinlock_key_t key = k_spin_lock(&coalescing->lock);
+    bool deliver_now = !coalescing->window_open;
+
+    if (deliver_now) {
+        coalescing->window_open = true;
+    } else {
+        memcpy(coalescing->latest, event, event->event->size);
+        coalescing->pending = true;
+    }
+
+    k_spin_unlock(&coalescing->lock, key);
+
+    if (deliver_now) {
+        k_work_schedule(&coalescing->work, K_MSEC(coalescing->window_ms));
+        coalescing->listener->callback(event);
+    }
+}
+
+static void coalescing_work_cb(struct k_work *work) {
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    struct zmk_event_coalescing *coalescing =
+        CONTAINER_OF(d_work, struct zmk_event_coalescing, work);
+
+    k_spinlock_key_t key = k_spin_lock(&coalescing->lock);
+
+    if (!coalescing->pending) {
+        coalescing->window_open = false;
+        k_spin_unlock(&coalescing->lock, key);
+        return;
+    }
+
+    memcpy(coalescing->delivered, coalescing->latest, coalescing->latest->event->size);
+    coalescing->pending = false;
+
+    k_spin_unlock(&coalescing->lock, key);
+
+    k_work_schedule(&coalescing->work, K_MSEC(coalescing->window_ms));
+    coalescing->listener->callback(coalescing->delivered);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+
+static int dispatch_from(zmk_event_t *event, uint8_t start_index, bool allow_defer) {
     int ret = 0;
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = start_index; i < len; i++) {
+    uint8_t end_index = event->event->subscriptions_start + event->event->subscriptions_len;
+    for (int i = start_index; i < end_index; i++) {
         struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
-        if (ev_sub->event_type != event->event) {
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_DEFER_OBSERVERS)
+        // Observers sort last, so everything from here on can be handed off to the work queue.
+        // If the event can't be queued, fall back to notifying the observers synchronously.
+        if (allow_defer && ev_sub->priority == ZMK_SUBSCRIPTION_PRIORITY_OBSERVER &&
+            defer_event(event, event->event->size, i) == 0) {
+            return 0;
+        }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+        // Coalesced subscriptions are always observers, so they never affect event flow
+        if (ev_sub->coalescing) {
+            coalesce_event(ev_sub->coalescing, event);
             continue;
         }
+#endif
+
         event->last_listener_index = i;
-        ret = ev_sub->listener->callback(event);
+        ret = call_listener(ev_sub, event);
         switch (ret) {
         case ZMK_EV_EVENT_BUBBLE:
             continue;
@@ -45,38 +189,175 @@ int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
     return 0;
 }
 
-int zmk_event_manager_raise(zmk_event_t *event) { return zmk_event_manager_handle_from(event, 0); }
+static int handle_from(zmk_event_t *event, uint8_t start_index, bool allow_defer) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+    uint32_t start = k_cycle_get_32();
+    int ret = dispatch_from(event, start_index, allow_defer);
+    record_timing(&((struct zmk_event_type *)event->event)->timing, k_cycle_get_32() - start);
 
-int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener) {
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = 0; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
+    return ret;
+#else
+    return dispatch_from(event, start_index, allow_defer);
+#endif
+}
+
+int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
+    return handle_from(event, start_index, true);
+}
 
-        if (ev_sub->event_type == event->event && ev_sub->listener == listener) {
-            return zmk_event_manager_handle_from(event, i + 1);
+static int find_listener_index(const zmk_event_t *event, const struct zmk_listener *listener) {
+    uint8_t end_index = event->event->subscriptions_start + event->event->subscriptions_len;
+    for (int i = event->event->subscriptions_start; i < end_index; i++) {
+        if (__event_subscriptions_start[i].listener == listener) {
+            return i;
         }
     }
 
-    LOG_WRN("Unable to find where to raise this after event");
+    return -ENOENT;
+}
+
+int zmk_event_manager_raise(zmk_event_t *event) {
+    return zmk_event_manager_handle_from(event, event->event->subscriptions_start);
+}
+
+int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener) {
+    int index = find_listener_index(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this after event");
+        return -EINVAL;
+    }
 
-    return -EINVAL;
+    return zmk_event_manager_handle_from(event, index + 1);
 }
 
 int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener) {
-    uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
-    for (int i = 0; i < len; i++) {
-        struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
+    int index = find_listener_index(event, listener);
+    if (index < 0) {
+        LOG_WRN("Unable to find where to raise this event");
+        return -EINVAL;
+    }
+
+    return zmk_event_manager_handle_from(event, index);
+}
+
+int zmk_event_manager_release(zmk_event_t *event) {
+    return zmk_event_manager_handle_from(event, event->last_listener_index + 1);
+}
 
-        if (ev_sub->event_type == event->event && ev_sub->listener == listener) {
-            return zmk_event_manager_handle_from(event, i);
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_DEFER_OBSERVERS)
+
+static void deferred_events_work_cb(struct k_work *work) {
+    struct deferred_event_slot slot;
+
+    while (k_msgq_get(&deferred_events_msgq, &slot, K_NO_WAIT) == 0) {
+        zmk_event_t *event = (zmk_event_t *)slot.data;
+        handle_from(event, slot.start_index, false);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_DEFER_OBSERVERS)
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+
+void zmk_event_manager_timing_foreach(zmk_event_manager_timing_cb cb, void *user_data) {
+    for (struct zmk_event_type **type = __event_type_start; type < __event_type_end; type++) {
+        cb(*type, NULL, &(*type)->timing, user_data);
+
+        for (int i = (*type)->subscriptions_start;
+             i < (*type)->subscriptions_start + (*type)->subscriptions_len; i++) {
+            struct zmk_event_subscription *ev_sub = __event_subscriptions_start + i;
+            cb(*type, ev_sub->listener, &ev_sub->timing, user_data);
         }
     }
+}
 
-    LOG_WRN("Unable to find where to raise this event");
+void zmk_event_manager_timing_reset(void) {
+    for (struct zmk_event_type **type = __event_type_start; type < __event_type_end; type++) {
+        memset(&(*type)->timing, 0, sizeof((*type)->timing));
+    }
 
-    return -EINVAL;
+    for (struct zmk_event_subscription *ev_sub = __event_subscriptions_start;
+         ev_sub < __event_subscriptions_end; ev_sub++) {
+        memset(&ev_sub->timing, 0, sizeof(ev_sub->timing));
+    }
 }
 
-int zmk_event_manager_release(zmk_event_t *event) {
-    return zmk_event_manager_handle_from(event, event->last_listener_index + 1);
+uint32_t zmk_event_timing_stats_percentile_us(const struct zmk_event_timing_stats *stats,
+                                              uint8_t percentile) {
+    uint32_t max_us = k_cyc_to_us_ceil32(stats->max_cycles);
+    uint64_t target = ((uint64_t)stats->count * percentile + 99) / 100;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < ZMK_EVENT_TIMING_BUCKETS; i++) {
+        seen += stats->buckets[i];
+        if (seen >= target) {
+            return MIN(BIT(i), max_us);
+        }
+    }
+
+    return max_us;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TIMING)
+
+static bool subscription_sorts_after(const struct zmk_event_subscription *a,
+                                     const struct zmk_event_subscription *b) {
+    if (a->event_type != b->event_type) {
+        return (uintptr_t)a->event_type > (uintptr_t)b->event_type;
+    }
+
+    return a->priority > b->priority;
 }
+
+static int event_manager_init(void) {
+    size_t len = __event_subscriptions_end - __event_subscriptions_start;
+
+    __ASSERT(len <= UINT8_MAX, "Too many event subscriptions: %d", (int)len);
+
+    // Stable insertion sort, so each event type's subscriptions end up contiguous and in priority
+    // order, while the link order of listeners with the same priority is preserved.
+    for (size_t i = 1; i < len; i++) {
+        struct zmk_event_subscription sub = __event_subscriptions_start[i];
+        size_t j = i;
+
+        while (j > 0 && subscription_sorts_after(&__event_subscriptions_start[j - 1], &sub)) {
+            __event_subscriptions_start[j] = __event_subscriptions_start[j - 1];
+            j--;
+        }
+
+        __event_subscriptions_start[j] = sub;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        __event_subscriptions_start[i].callback = __event_subscriptions_start[i].listener->callback;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_COALESCING)
+    for (size_t i = 0; i < len; i++) {
+        if (__event_subscriptions_start[i].coalescing) {
+            k_work_init_delayable(&__event_subscriptions_start[i].coalescing->work,
+                                  coalescing_work_cb);
+        }
+    }
+#endif
+
+    for (struct zmk_event_type **type = __event_type_start; type < __event_type_end; type++) {
+        (*type)->subscriptions_start = 0;
+        (*type)->subscriptions_len = 0;
+
+        for (size_t i = 0; i < len; i++) {
+            if (__event_subscriptions_start[i].event_type != *type) {
+                continue;
+            }
+
+            if ((*type)->subscriptions_len == 0) {
+                (*type)->subscriptions_start = i;
+            }
+            (*type)->subscriptions_len++;
+        }
+    }
+
+    return 0;
+}
+
+SYS_INIT(event_manager_init, PRE_KERNEL_1, 0);
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <zmk/event_manager.h>
+
+static void print_stats(const struct zmk_event_type *type, const struct zmk_listener *listener,
+                        const struct zmk_event_timing_stats *stats, void *user_data) {
+    const struct shell *sh = user_data;
+
+    if (stats->count == 0) {
+        return;
+    }
+
+    shell_print(sh, "%s%-32s count %u min %uus avg %uus max %uus p99 %uus",
+                listener ? "  " : "", listener ? listener->name : type->name, stats->count,
+                k_cyc_to_us_floor32(stats->min_cycles),
+                (uint32_t)k_cyc_to_us_floor64(stats->total_cycles / stats->count),
+                k_cyc_to_us_ceil32(stats->max_cycles),
+                zmk_event_timing_stats_percentile_us(stats, 99));
+}
+
+static int cmd_timing_show(const struct shell *sh, size_t argc, char **argv) {
+    zmk_event_manager_timing_foreach(print_stats, (void *)sh);
+    return 0;
+}
+
+static int cmd_timing_reset(const struct shell *sh, size_t argc, char **argv) {
+    zmk_event_manager_timing_reset();
+    shell_print(sh, "Event timing statistics cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_event_timing,
+                               SHELL_CMD(show, NULL, "Show per event and listener timing",
+                                         cmd_timing_show),
+                               SHELL_CMD(reset, NULL, "Clear timing statistics", cmd_timing_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(event_timing, &sub_event_timing, "ZMK event manager timing statistics", NULL);
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_pool.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/queue_stats.h>
+
+BUILD_ASSERT(CONFIG_ZMK_EVENT_POOL_SIZE < ZMK_EVENT_POOL_REF_NONE,
+             "CONFIG_ZMK_EVENT_POOL_SIZE must leave room for ZMK_EVENT_POOL_REF_NONE");
+
+// Slots are sized for the events hold-taps and combos capture.
+union event_pool_slot {
+    zmk_event_t header;
+    struct zmk_position_state_changed_event position;
+    struct zmk_keycode_state_changed_event keycode;
+};
+
+static union event_pool_slot slots[CONFIG_ZMK_EVENT_POOL_SIZE];
+static uint8_t refcounts[CONFIG_ZMK_EVENT_POOL_SIZE];
+static uint8_t slots_used;
+
+ZMK_QUEUE_STATS_DEFINE(event_pool, "event pool", CONFIG_ZMK_EVENT_POOL_SIZE);
+
+static zmk_event_pool_ref_t ref_of(const zmk_event_t *event) {
+    const union event_pool_slot *slot = CONTAINER_OF(event, union event_pool_slot, header);
+
+    if (slot < slots || slot >= slots + CONFIG_ZMK_EVENT_POOL_SIZE) {
+        return ZMK_EVENT_POOL_REF_NONE;
+    }
+
+    return slot - slots;
+}
+
+bool zmk_event_pool_can_capture(const zmk_event_t *event) {
+    return ref_of(event) != ZMK_EVENT_POOL_REF_NONE ||
+           (event->event->size <= sizeof(union event_pool_slot) &&
+            slots_used < CONFIG_ZMK_EVENT_POOL_SIZE);
+}
+
+zmk_event_pool_ref_t zmk_event_pool_capture(const zmk_event_t *event) {
+    zmk_event_pool_ref_t ref = ref_of(event);
+
+    if (ref != ZMK_EVENT_POOL_REF_NONE) {
+        refcounts[ref]++;
+        return ref;
+    }
+
+    if (event->event->size > sizeof(union event_pool_slot)) {
+        LOG_ERR("Event %s is too large to pool (%d > %d)", event->event->name, event->event->size,
+                sizeof(union event_pool_slot));
+        return ZMK_EVENT_POOL_REF_NONE;
+    }
+
+    if (slots_used == CONFIG_ZMK_EVENT_POOL_SIZE) {
+        LOG_WRN("Event pool full, unable to capture %s", event->event->name);
+        ZMK_QUEUE_STATS_OVERFLOW(event_pool);
+        return ZMK_EVENT_POOL_REF_NONE;
+    }
+
+    for (ref = 0; refcounts[ref] > 0; ref++) {
+    }
+
+    memcpy(&slots[ref], event, event->event->size);
+    refcounts[ref] = 1;
+    slots_used++;
+    ZMK_QUEUE_STATS_PUT(event_pool, slots_used);
+
+    return ref;
+}
+
+zmk_event_t *zmk_event_pool_get(zmk_event_pool_ref_t ref) {
+    __ASSERT(ref < CONFIG_ZMK_EVENT_POOL_SIZE && refcounts[ref] > 0, "Invalid event pool ref");
+
+    return &slots[ref].header;
+}
+
+void zmk_event_pool_unref(zmk_event_pool_ref_t ref) {
+    __ASSERT(ref < CONFIG_ZMK_EVENT_POOL_SIZE && refcounts[ref] > 0, "Invalid event pool ref");
+
+    if (--refcounts[ref] == 0) {
+        slots_used--;
+    }
+}
@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zmk/events/highest_layer_changed.h>
+
+ZMK_EVENT_IMPL(zmk_highest_layer_changed);
@@ -15,6 +15,9 @@
 #include <zephyr/drivers/gpio.h>
 
 #include <drivers/ext_power.h>
+#include <zmk/settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
@@ -29,13 +32,17 @@ struct ext_power_generic_config {
 
 struct ext_power_generic_data {
     bool status;
+#if IS_ENABLED(CONFIG_ZMK_EXT_POWER_IDLE_OFF)
+    // Power is cut for being idle, while status still says it's enabled.
+    bool idle_off;
+#endif
 #if IS_ENABLED(CONFIG_SETTINGS)
     bool settings_init;
 #endif
 };
 
 #if IS_ENABLED(CONFIG_SETTINGS)
-static void ext_power_save_state_work(struct k_work *work) {
+static void ext_power_save_state_cb(void) {
     char setting_path[40];
     const struct device *ext_power = DEVICE_DT_GET(DT_DRV_INST(0));
     struct ext_power_generic_data *data = ext_power->data;
@@ -44,45 +51,56 @@ static void ext_power_save_state_work(struct k_work *work) {
     settings_save_one(setting_path, &data->status, sizeof(data->status));
 }
 
-static struct k_work_delayable ext_power_save_work;
+ZMK_SETTINGS_SAVE_DEFINE(ext_power_save, ext_power_save_state_cb);
 #endif
 
 int ext_power_save_state(void) {
 #if IS_ENABLED(CONFIG_SETTINGS)
-    int ret = k_work_reschedule(&ext_power_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
-    return MIN(ret, 0);
+    return zmk_settings_save_schedule(&ext_power_save);
 #else
     return 0;
 #endif
 }
 
-static int ext_power_generic_enable(const struct device *dev) {
-    struct ext_power_generic_data *data = dev->data;
+static int ext_power_generic_set_pins(const struct device *dev, int value) {
     const struct ext_power_generic_config *config = dev->config;
 
     for (int i = 0; i < config->control_gpios_count; i++) {
         const struct gpio_dt_spec *gpio = &config->control[i];
-        if (gpio_pin_set_dt(gpio, 1)) {
-            LOG_WRN("Failed to set ext-power control pin %d", i);
+        if (gpio_pin_set_dt(gpio, value)) {
+            LOG_WRN("Failed to %s ext-power control pin %d", value ? "set" : "clear", i);
             return -EIO;
         }
     }
+
+    return 0;
+}
+
+static int ext_power_generic_enable(const struct device *dev) {
+    struct ext_power_generic_data *data = dev->data;
+
+    int rc = ext_power_generic_set_pins(dev, 1);
+    if (rc < 0) {
+        return rc;
+    }
     data->status = true;
+#if IS_ENABLED(CONFIG_ZMK_EXT_POWER_IDLE_OFF)
+    data->idle_off = false;
+#endif
     return ext_power_save_state();
 }
 
 static int ext_power_generic_disable(const struct device *dev) {
     struct ext_power_generic_data *data = dev->data;
-    const struct ext_power_generic_config *config = dev->config;
 
-    for (int i = 0; i < config->control_gpios_count; i++) {
-        const struct gpio_dt_spec *gpio = &config->control[i];
-        if (gpio_pin_set_dt(gpio, 0)) {
-            LOG_WRN("Failed to clear ext-power control pin %d", i);
-            return -EIO;
-        }
+    int rc = ext_power_generic_set_pins(dev, 0);
+    if (rc < 0) {
+        return rc;
     }
     data->status = false;
+#if IS_ENABLED(CONFIG_ZMK_EXT_POWER_IDLE_OFF)
+    data->idle_off = false;
+#endif
     return ext_power_save_state();
 }
 
@@ -134,7 +152,7 @@ static int ext_power_settings_commit() {
     if (!data->settings_init) {
 
         data->status = true;
-        k_work_schedule(&ext_power_save_work, K_NO_WAIT);
+        zmk_settings_save_schedule(&ext_power_save);
 
         ext_power_enable(dev);
     }
@@ -147,6 +165,53 @@ SETTINGS_STATIC_HANDLER_DEFINE(ext_power, "ext_power/state", NULL, ext_power_set
 
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_EXT_POWER_IDLE_OFF)
+
+// Devices powered by the rail are brought back up off the event path, once the power has had time
+// to settle, so the keystroke that woke the keyboard isn't held up by them.
+static void ext_power_idle_restore_cb(struct k_work *work) {
+#if IS_ENABLED(CONFIG_PM_DEVICE_POWER_DOMAIN)
+    pm_device_children_action_run(DEVICE_DT_GET(DT_DRV_INST(0)), PM_DEVICE_ACTION_TURN_ON, NULL);
+#endif
+}
+
+static K_WORK_DELAYABLE_DEFINE(ext_power_idle_restore_work, ext_power_idle_restore_cb);
+
+static int ext_power_idle_listener(const zmk_event_t *eh) {
+    const struct device *dev = DEVICE_DT_GET(DT_DRV_INST(0));
+    const struct ext_power_generic_config *config = dev->config;
+    struct ext_power_generic_data *data = dev->data;
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+
+    if (ev->state == ZMK_ACTIVITY_ACTIVE) {
+        if (!data->idle_off) {
+            return ZMK_EV_EVENT_BUBBLE;
+        }
+
+        // Power is restored right away, ahead of the listeners that light up LEDs and displays.
+        if (ext_power_generic_set_pins(dev, 1) == 0) {
+            data->idle_off = false;
+            k_work_reschedule(&ext_power_idle_restore_work, K_MSEC(config->init_delay_ms));
+        }
+    } else if (ev->state == ZMK_ACTIVITY_IDLE && data->status && !data->idle_off) {
+        k_work_cancel_delayable(&ext_power_idle_restore_work);
+#if IS_ENABLED(CONFIG_PM_DEVICE_POWER_DOMAIN)
+        pm_device_children_action_run(dev, PM_DEVICE_ACTION_TURN_OFF, NULL);
+#endif
+        if (ext_power_generic_set_pins(dev, 0) == 0) {
+            LOG_DBG("Cutting external power while idle");
+            data->idle_off = true;
+        }
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(ext_power_idle, ext_power_idle_listener);
+ZMK_SUBSCRIPTION_PRIORITY(ext_power_idle, zmk_activity_state_changed, CRITICAL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_EXT_POWER_IDLE_OFF)
+
 static int ext_power_generic_init(const struct device *dev) {
     const struct ext_power_generic_config *config = dev->config;
 
@@ -158,10 +223,6 @@ static int ext_power_generic_init(const struct device *dev) {
         }
     }
 
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&ext_power_save_work, ext_power_save_state_work);
-#endif
-
     // Enable by default. We may get disabled again once settings load.
     ext_power_enable(dev);
 
@@ -31,6 +31,13 @@ static struct zmk_hid_mouse_report mouse_report = {
     .report_id = ZMK_HID_REPORT_ID_MOUSE,
     .body = {.buttons = 0, .d_x = 0, .d_y = 0, .d_scroll_y = 0}};
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+static struct zmk_hid_abs_pointer_report abs_pointer_report = {
+    .report_id = ZMK_HID_REPORT_ID_ABS_POINTER};
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 // Keep track of how often a modifier was pressed.
@@ -117,6 +124,20 @@ static zmk_hid_boot_report_t *boot_report_rollover(uint8_t modifiers) {
 
 #define TOGGLE_KEYBOARD(code, val) WRITE_BIT(keyboard_report.body.keys[code / 8], code % 8, val)
 
+#define KEYBOARD_KEYS_WORDS DIV_ROUND_UP(sizeof(keyboard_report.body.keys), 4)
+
+// The packed report bitmap isn't word aligned, so words are assembled little-endian from bytes,
+// which keeps bit n of word w as usage (w * 32) + n.
+static inline uint32_t keyboard_keys_word(int word) {
+    uint32_t value = 0;
+
+    for (int i = 0; i < 4 && (word * 4) + i < sizeof(keyboard_report.body.keys); i++) {
+        value |= (uint32_t)keyboard_report.body.keys[(word * 4) + i] << (i * 8);
+    }
+
+    return value;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
     if (keys_held > HID_BOOT_KEY_LEN) {
@@ -126,33 +147,36 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
     boot_report.modifiers = keyboard_report.body.modifiers;
     memset(&boot_report.keys, 0, HID_BOOT_KEY_LEN);
     int ix = 0;
-    uint8_t base_code = 0;
-    for (int i = 0; i < sizeof(keyboard_report.body.keys); ++i) {
-        if (ix == keys_held) {
-            break;
-        }
-        if (!keyboard_report.body.keys[i]) {
-            continue;
-        }
-        base_code = i * 8;
-        for (int j = 0; j < 8; ++j) {
-            if (keyboard_report.body.keys[i] & BIT(j)) {
-                boot_report.keys[ix++] = base_code + j;
-            }
+    for (int word = 0; word < KEYBOARD_KEYS_WORDS && ix < keys_held; word++) {
+        uint32_t bits = keyboard_keys_word(word);
+
+        while (bits && ix < keys_held) {
+            boot_report.keys[ix++] = (word * 32) + __builtin_ctz(bits);
+            bits &= bits - 1;
         }
     }
     return &boot_report;
 }
 #endif
 
+static inline bool check_keyboard_usage(zmk_key_t usage) {
+    if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
+        return false;
+    }
+    return keyboard_report.body.keys[usage / 8] & (1 << (usage % 8));
+}
+
 static inline int select_keyboard_usage(zmk_key_t usage) {
     if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
         return -EINVAL;
     }
-    TOGGLE_KEYBOARD(usage, 1);
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    ++keys_held;
+    // Only count real transitions so the held count always matches the bitmap.
+    if (!check_keyboard_usage(usage)) {
+        ++keys_held;
+    }
 #endif
+    TOGGLE_KEYBOARD(usage, 1);
     return 0;
 }
 
@@ -160,34 +184,64 @@ static inline int deselect_keyboard_usage(zmk_key_t usage) {
     if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
         return -EINVAL;
     }
-    TOGGLE_KEYBOARD(usage, 0);
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    --keys_held;
+    if (check_keyboard_usage(usage)) {
+        --keys_held;
+    }
 #endif
+    TOGGLE_KEYBOARD(usage, 0);
     return 0;
 }
 
-static inline bool check_keyboard_usage(zmk_key_t usage) {
-    if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
-        return false;
-    }
-    return keyboard_report.body.keys[usage / 8] & (1 << (usage % 8));
+#elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+
+#define KEYBOARD_SLOT_WORDS DIV_ROUND_UP(CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE, 32)
+
+BUILD_ASSERT(CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE < UINT8_MAX,
+             "The HKRO slot index can't address this many keys");
+
+// Reverse index from usage to report slot plus one, zero meaning not pressed.
+static uint8_t usage_slots[UINT8_MAX + 1];
+
+// One set bit per slot in use, so the zero-initialized state is an empty report.
+static uint32_t used_slots[KEYBOARD_SLOT_WORDS];
+
+static void reset_keyboard_slots(void) {
+    memset(usage_slots, 0, sizeof(usage_slots));
+    memset(used_slots, 0, sizeof(used_slots));
 }
 
-#elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+static int take_free_slot(void) {
+    // Taking the lowest free slot keeps the report filled front to back.
+    for (int i = 0; i < KEYBOARD_SLOT_WORDS; i++) {
+        uint32_t free = ~used_slots[i];
 
-#define TOGGLE_KEYBOARD(match, val)                                                                \
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {                          \
-        if (keyboard_report.body.keys[idx] != match) {                                             \
-            continue;                                                                              \
-        }                                                                                          \
-        keyboard_report.body.keys[idx] = val;                                                      \
-        if (val) {                                                                                 \
-            break;                                                                                 \
-        }                                                                                          \
+        if (i == KEYBOARD_SLOT_WORDS - 1 && CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE % 32) {
+            free &= BIT_MASK(CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE % 32);
+        }
+
+        if (free) {
+            int bit = __builtin_ctz(free);
+
+            used_slots[i] |= BIT(bit);
+            return (i * 32) + bit;
+        }
     }
 
+    return -ENOMEM;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+static int count_used_slots(void) {
+    int count = 0;
+
+    for (int i = 0; i < KEYBOARD_SLOT_WORDS; i++) {
+        count += __builtin_popcount(used_slots[i]);
+    }
+
+    return count;
+}
+
 zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
     if (keys_held > HID_BOOT_KEY_LEN) {
         return boot_report_rollover(keyboard_report.body.modifiers);
@@ -220,31 +274,60 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
 }
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
+static inline int check_keyboard_usage(zmk_key_t usage) {
+    return usage > 0 && usage <= UINT8_MAX && usage_slots[usage] != 0;
+}
+
 static inline int select_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(0U, usage);
+    if (usage == 0 || usage > UINT8_MAX) {
+        return -EINVAL;
+    }
+
+    if (usage_slots[usage]) {
+        return 0;
+    }
+
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    // Keys that don't fit in the report still count, so that the boot report shows rollover.
     ++keys_held;
 #endif
+
+    int slot = take_free_slot();
+    if (slot < 0) {
+        return 0;
+    }
+
+    keyboard_report.body.keys[slot] = usage;
+    usage_slots[usage] = slot + 1;
     return 0;
 }
 
 static inline int deselect_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(usage, 0U);
+    if (usage == 0 || usage > UINT8_MAX) {
+        return -EINVAL;
+    }
+
+    if (!usage_slots[usage]) {
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+        // Releasing a key that didn't fit in the report.
+        if (keys_held > count_used_slots()) {
+            --keys_held;
+        }
+#endif
+        return 0;
+    }
+
+    int slot = usage_slots[usage] - 1;
+
+    keyboard_report.body.keys[slot] = 0;
+    usage_slots[usage] = 0;
+    used_slots[slot / 32] &= ~BIT(slot % 32);
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
     --keys_held;
 #endif
     return 0;
 }
 
-static inline int check_keyboard_usage(zmk_key_t usage) {
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {
-        if (keyboard_report.body.keys[idx] == usage) {
-            return true;
-        }
-    }
-    return false;
-}
-
 #else
 #error "A proper HID report type must be selected"
 #endif
@@ -316,6 +399,12 @@ bool zmk_hid_keyboard_is_pressed(zmk_key_t code) {
 
 void zmk_hid_keyboard_clear(void) {
     memset(&keyboard_report.body, 0, sizeof(keyboard_report.body));
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+    reset_keyboard_slots();
+#endif // IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    keys_held = 0;
+#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 }
 
 int zmk_hid_consumer_press(zmk_key_t code) {
@@ -466,14 +555,45 @@ void zmk_hid_mouse_clear(void) {
     memset(&mouse_report.body, 0, sizeof(mouse_report.body));
 }
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+void zmk_hid_abs_pointer_set(uint16_t x, uint16_t y) {
+    abs_pointer_report.body.x = MIN(x, ZMK_HID_ABS_POINTER_MAX);
+    abs_pointer_report.body.y = MIN(y, ZMK_HID_ABS_POINTER_MAX);
+    LOG_DBG("Absolute pointer set to %d/%d", abs_pointer_report.body.x,
+            abs_pointer_report.body.y);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 struct zmk_hid_keyboard_report *zmk_hid_get_keyboard_report(void) { return &keyboard_report; }
 
 struct zmk_hid_consumer_report *zmk_hid_get_consumer_report(void) { return &consumer_report; }
 
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+static struct zmk_hid_composite_report composite_report = {
+    .report_id = ZMK_HID_REPORT_ID_KEYBOARD};
+
+struct zmk_hid_composite_report *zmk_hid_get_composite_report(void) {
+    composite_report.body.keyboard = keyboard_report.body;
+    composite_report.body.consumer = consumer_report.body;
+    return &composite_report;
+}
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
 struct zmk_hid_mouse_report *zmk_hid_get_mouse_report(void) { return &mouse_report; }
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+struct zmk_hid_abs_pointer_report *zmk_hid_get_abs_pointer_report(void) {
+    abs_pointer_report.body.buttons = mouse_report.body.buttons;
+    return &abs_pointer_report;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
@@ -10,14 +10,21 @@
 #include <zephyr/usb/class/usb_hid.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 #include <string.h>
 
+#include <zmk/hid.h>
 #include <zmk/hid_gaming.h>
 #include <zmk/keymap.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
+#include <zmk/events/usb_conn_state_changed.h>
+#include <zmk/endpoints.h>
+#include <zmk/hog.h>
+#include <zmk/usb.h>
 #include <zmk/usb_hid.h>
 #include <zmk/matrix.h>
+#include <zmk/workqueue.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -28,32 +35,33 @@ static bool gaming_mode_active = true;
 static struct zmk_gaming_keyboard_report gaming_reports[ZMK_GAMING_DEVICE_COUNT];
 
 // Track which keys are currently pressed in gaming HID (position -> key mapping)
-// Use a reasonable max size since ZMK_KEYMAP_LEN might not be available here
-#define GAMING_MAX_POSITIONS 64
-static uint8_t gaming_pressed_keys[GAMING_MAX_POSITIONS];
+static zmk_key_t gaming_pressed_keys[ZMK_KEYMAP_LEN];
 
 // We'll use ZMK's existing USB HID infrastructure
 
-// Position to device mapping for Corne 42-key layout
-// Consolidated grouping: YU, HJ, NM groups maintained, everything else in main group
+// Position to device mapping, generated from the zmk,gaming-hid-groups node. Positions that no
+// group lists are left at 0, the main device.
+#define GAMING_GROUP_POSITION(node_id, prop, idx)                                                  \
+    [DT_PROP_BY_IDX(node_id, prop, idx)] = DT_PROP(node_id, device),
+#define GAMING_GROUP_POSITIONS(node_id)                                                            \
+    DT_FOREACH_PROP_ELEM(node_id, positions, GAMING_GROUP_POSITION)
+#define GAMING_GROUP_CHECK(node_id)                                                                \
+    BUILD_ASSERT(DT_PROP(node_id, device) < ZMK_GAMING_DEVICE_COUNT,                               \
+                 "Gaming HID group device must be less than CONFIG_ZMK_HID_GAMING_DEVICE_COUNT")
+
+static const uint8_t gaming_device_for_position[ZMK_KEYMAP_LEN] = {
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_gaming_hid_groups)
+    DT_FOREACH_CHILD_STATUS_OKAY(ZMK_GAMING_GROUPS_NODE, GAMING_GROUP_POSITIONS)
+#endif
+};
+
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_gaming_hid_groups)
+DT_FOREACH_CHILD_STATUS_OKAY_SEP(ZMK_GAMING_GROUPS_NODE, GAMING_GROUP_CHECK, (;));
+#endif
+
 uint8_t zmk_hid_gaming_get_device_for_position(uint32_t position) {
-    switch (position) {
-        // YU group (positions 6,7)
-        case 6: case 7:
-            return ZMK_GAMING_DEVICE_GROUP_YU;
-            
-        // HJ group (positions 18,19)  
-        case 18: case 19:
-            return ZMK_GAMING_DEVICE_GROUP_HJ;
-            
-        // NM group (positions 30,31)
-        case 30: case 31:
-            return ZMK_GAMING_DEVICE_GROUP_NM;
-            
-        // Main group: all other keys
-        default:
-            return ZMK_GAMING_DEVICE_MAIN;
-    }
+    return position < ZMK_KEYMAP_LEN ? gaming_device_for_position[position]
+                                     : ZMK_GAMING_DEVICE_MAIN;
 }
 
 // We'll send reports through ZMK's existing USB HID system
@@ -66,33 +74,158 @@ static void zmk_hid_gaming_init_reports(void) {
     }
 }
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+
+#if DT_NODE_HAS_PROP(ZMK_GAMING_GROUPS_NODE, nkro_usage_min)
+BUILD_ASSERT(DT_PROP_LEN(ZMK_GAMING_GROUPS_NODE, nkro_usage_min) == ZMK_GAMING_DEVICE_COUNT,
+             "nkro-usage-min needs one entry per gaming HID device");
+#endif
+
+#if DT_NODE_HAS_PROP(ZMK_GAMING_GROUPS_NODE, nkro_usage_max)
+BUILD_ASSERT(DT_PROP_LEN(ZMK_GAMING_GROUPS_NODE, nkro_usage_max) == ZMK_GAMING_DEVICE_COUNT,
+             "nkro-usage-max needs one entry per gaming HID device");
+#endif
+
+#define GAMING_NKRO_RANGE_CHECK(idx, _)                                                            \
+    BUILD_ASSERT(ZMK_GAMING_NKRO_USAGE_MIN(idx) <= ZMK_GAMING_NKRO_USAGE_MAX(idx) &&               \
+                     ZMK_GAMING_NKRO_USAGE_MIN(idx) + ZMK_GAMING_NKRO_BITMAP_SIZE(idx) * 8 <=      \
+                         HID_USAGE_KEY_KEYBOARD_LEFTCONTROL,                                       \
+                 "Gaming HID NKRO usage ranges must end below the modifier usages")
+#define GAMING_NKRO_USAGE_MIN(idx, _) ZMK_GAMING_NKRO_USAGE_MIN(idx)
+#define GAMING_NKRO_BITMAP_SIZE(idx, _) ZMK_GAMING_NKRO_BITMAP_SIZE(idx)
+
+LISTIFY(ZMK_GAMING_DEVICE_COUNT, GAMING_NKRO_RANGE_CHECK, (;));
+
+static const uint8_t gaming_nkro_usage_min[ZMK_GAMING_DEVICE_COUNT] = {
+    LISTIFY(ZMK_GAMING_DEVICE_COUNT, GAMING_NKRO_USAGE_MIN, (, ))};
+static const uint8_t gaming_nkro_bitmap_size[ZMK_GAMING_DEVICE_COUNT] = {
+    LISTIFY(ZMK_GAMING_DEVICE_COUNT, GAMING_NKRO_BITMAP_SIZE, (, ))};
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+
+size_t zmk_hid_gaming_get_keyboard_report_size(uint8_t device_id) {
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+    return offsetof(struct zmk_gaming_keyboard_report, body.keys) +
+           gaming_nkro_bitmap_size[device_id];
+#else
+    return sizeof(struct zmk_gaming_keyboard_report);
+#endif
+}
+
 // Send gaming HID report using ZMK's USB HID infrastructure
 static int zmk_hid_gaming_send_report(uint8_t device_id) {
     if (device_id >= ZMK_GAMING_DEVICE_COUNT) {
         return -EINVAL;
     }
 
-#if IS_ENABLED(CONFIG_ZMK_USB)
     // Send the gaming report with the specific report ID
     struct zmk_gaming_keyboard_report *report = &gaming_reports[device_id];
     
     // Make sure report ID is set correctly
     report->report_id = ZMK_HID_GAMING_REPORT_ID_MAIN + device_id;
-    
-    // Send the report through the USB HID endpoint
-    size_t report_size = sizeof(struct zmk_gaming_keyboard_report);
-    
-    // Use ZMK's USB HID send function - this will send our custom report
+
     LOG_DBG("Sending gaming report: device_id=%d, report_id=0x%02x, keys=[%02x,%02x,%02x,%02x,%02x,%02x]", 
             device_id, report->report_id, 
             report->body.keys[0], report->body.keys[1], report->body.keys[2], 
             report->body.keys[3], report->body.keys[4], report->body.keys[5]);
-    return zmk_usb_hid_send_report((uint8_t *)report, report_size);
+
+    // Gaming reports follow the keyboard's selected endpoint
+    switch (zmk_endpoints_selected().transport) {
+    case ZMK_TRANSPORT_USB:
+#if IS_ENABLED(CONFIG_ZMK_USB)
+        return zmk_usb_hid_send_report((uint8_t *)report,
+                                       zmk_hid_gaming_get_keyboard_report_size(device_id));
 #else
+        return -ENOTSUP;
+#endif // IS_ENABLED(CONFIG_ZMK_USB)
+    case ZMK_TRANSPORT_BLE:
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+        return zmk_hog_send_gaming_report(device_id, &report->body);
+#else
+        return -ENOTSUP;
+#endif // IS_ENABLED(CONFIG_ZMK_BLE)
+    default:
+        return -ENOTSUP;
+    }
+}
+
+BUILD_ASSERT(ZMK_GAMING_DEVICE_COUNT <= sizeof(atomic_val_t) * 8,
+             "Every gaming HID device needs a bit in the dirty device mask");
+
+// Devices whose report changed since the last flush. Key changes only mark their device, and all
+// the changes made while one batch of key events is processed go out together once it's done, so
+// a chord across several devices reaches the host as back to back reports.
+static atomic_t gaming_dirty_devices;
+
+static void gaming_flush_work_handler(struct k_work *work) {
+    atomic_val_t dirty = atomic_clear(&gaming_dirty_devices);
+
+    while (dirty) {
+        const uint8_t device_id = __builtin_ctz(dirty);
+        int ret = zmk_hid_gaming_send_report(device_id);
+
+        if (ret < 0) {
+            LOG_WRN("Failed to send gaming report for device %d (%d)", device_id, ret);
+        }
+
+        dirty &= dirty - 1;
+    }
+}
+
+K_WORK_DEFINE(gaming_flush_work, gaming_flush_work_handler);
+
+// Key events are raised from the input work queue, so the flush submitted here runs right after
+// the event batch currently being processed.
+static int zmk_hid_gaming_queue_report(uint8_t device_id) {
+    atomic_set_bit(&gaming_dirty_devices, device_id);
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &gaming_flush_work);
     return 0;
-#endif
 }
 
+void zmk_hid_gaming_announce(void) {
+    atomic_set(&gaming_dirty_devices, BIT_MASK(ZMK_GAMING_DEVICE_COUNT));
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &gaming_flush_work);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+
+// Sets or clears one key in a device's bitmap. Modifier keys go in the modifier byte, and keys
+// outside the device's usage range are refused, so the caller can send them some other way.
+static int gaming_nkro_write_key(uint8_t device_id, zmk_key_t key, bool pressed) {
+    struct zmk_gaming_keyboard_report_body *body = &gaming_reports[device_id].body;
+    const uint32_t usage = ZMK_HID_USAGE_ID(key);
+    uint8_t *byte;
+    uint8_t bit;
+
+    if (ZMK_HID_USAGE_PAGE(key) != HID_USAGE_KEY) {
+        return -ENOTSUP;
+    }
+
+    if (usage >= HID_USAGE_KEY_KEYBOARD_LEFTCONTROL && usage <= HID_USAGE_KEY_KEYBOARD_RIGHT_GUI) {
+        byte = &body->modifiers;
+        bit = BIT(usage - HID_USAGE_KEY_KEYBOARD_LEFTCONTROL);
+    } else {
+        const uint32_t offset = usage - gaming_nkro_usage_min[device_id];
+
+        if (usage < gaming_nkro_usage_min[device_id] ||
+            offset >= gaming_nkro_bitmap_size[device_id] * 8) {
+            return -ENOTSUP;
+        }
+
+        byte = &body->keys[offset / 8];
+        bit = BIT(offset % 8);
+    }
+
+    if (!!(*byte & bit) == pressed) {
+        return 0;
+    }
+
+    *byte ^= bit;
+    return zmk_hid_gaming_queue_report(device_id);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+
 // Gaming mode control
 bool zmk_hid_gaming_is_active(void) {
     return gaming_mode_active;
@@ -102,13 +235,9 @@ void zmk_hid_gaming_set_active(bool active) {
     if (gaming_mode_active != active) {
         gaming_mode_active = active;
         if (active) {
-            // Clear all gaming reports
+            // Clearing sends an empty report for each gaming device, which makes the host aware of
+            // them
             zmk_hid_gaming_keyboard_clear_all();
-            
-            // Send an empty report for each gaming device to make Linux aware of them
-            for (int i = 0; i < ZMK_GAMING_DEVICE_COUNT; i++) {
-                zmk_hid_gaming_send_report(i);
-            }
         } else {
             // Send empty reports to clear all gaming devices
             zmk_hid_gaming_keyboard_clear_all();
@@ -122,6 +251,9 @@ int zmk_hid_gaming_keyboard_press(uint8_t device_id, zmk_key_t key) {
         return -EINVAL;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+    return gaming_nkro_write_key(device_id, key, true);
+#else
     struct zmk_gaming_keyboard_report *report = &gaming_reports[device_id];
     
     // Find empty slot or check if already pressed
@@ -131,11 +263,12 @@ int zmk_hid_gaming_keyboard_press(uint8_t device_id, zmk_key_t key) {
         }
         if (report->body.keys[i] == 0) {
             report->body.keys[i] = key;
-            return zmk_hid_gaming_send_report(device_id);
+            return zmk_hid_gaming_queue_report(device_id);
         }
     }
     
     return -ENOMEM; // No more key slots
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
 }
 
 int zmk_hid_gaming_keyboard_release(uint8_t device_id, zmk_key_t key) {
@@ -143,6 +276,9 @@ int zmk_hid_gaming_keyboard_release(uint8_t device_id, zmk_key_t key) {
         return -EINVAL;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+    return gaming_nkro_write_key(device_id, key, false);
+#else
     struct zmk_gaming_keyboard_report *report = &gaming_reports[device_id];
     
     // Find and remove key
@@ -153,11 +289,12 @@ int zmk_hid_gaming_keyboard_release(uint8_t device_id, zmk_key_t key) {
                 report->body.keys[j] = report->body.keys[j + 1];
             }
             report->body.keys[ZMK_GAMING_MAX_KEYS_PER_DEVICE - 1] = 0;
-            return zmk_hid_gaming_send_report(device_id);
+            return zmk_hid_gaming_queue_report(device_id);
         }
     }
     
     return 0; // Key not found, no error
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
 }
 
 void zmk_hid_gaming_keyboard_clear(uint8_t device_id) {
@@ -166,9 +303,14 @@ void zmk_hid_gaming_keyboard_clear(uint8_t device_id) {
     }
 
     struct zmk_gaming_keyboard_report *report = &gaming_reports[device_id];
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING_REPORT_TYPE_NKRO)
+    // Modifier keys are part of the bitmap here, so they're released too
+    memset(&report->body, 0, sizeof(report->body));
+#else
     memset(report->body.keys, 0, ZMK_GAMING_MAX_KEYS_PER_DEVICE);
+#endif
     
-    zmk_hid_gaming_send_report(device_id);
+    zmk_hid_gaming_queue_report(device_id);
 }
 
 void zmk_hid_gaming_keyboard_clear_all(void) {
@@ -184,7 +326,7 @@ int zmk_hid_gaming_register_mod(uint8_t device_id, zmk_mod_t modifier) {
 
     struct zmk_gaming_keyboard_report *report = &gaming_reports[device_id];
     report->body.modifiers |= modifier;
-    return zmk_hid_gaming_send_report(device_id);
+    return zmk_hid_gaming_queue_report(device_id);
 }
 
 int zmk_hid_gaming_unregister_mod(uint8_t device_id, zmk_mod_t modifier) {
@@ -194,7 +336,7 @@ int zmk_hid_gaming_unregister_mod(uint8_t device_id, zmk_mod_t modifier) {
 
     struct zmk_gaming_keyboard_report *report = &gaming_reports[device_id];
     report->body.modifiers &= ~modifier;
-    return zmk_hid_gaming_send_report(device_id);
+    return zmk_hid_gaming_queue_report(device_id);
 }
 
 struct zmk_gaming_keyboard_report *zmk_hid_gaming_get_keyboard_report(uint8_t device_id) {
@@ -204,22 +346,169 @@ struct zmk_gaming_keyboard_report *zmk_hid_gaming_get_keyboard_report(uint8_t de
     return &gaming_reports[device_id];
 }
 
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_gaming_socd)
+
+// Each pair keeps which of its keys are held and which are reported, so every press and release
+// is resolved in constant time. Keys are found through a table indexed by keyboard usage.
+#define GAMING_SOCD_NODE DT_INST(0, zmk_gaming_socd)
+
+enum gaming_socd_resolution {
+    GAMING_SOCD_LAST_INPUT,
+    GAMING_SOCD_NEUTRAL,
+    GAMING_SOCD_FIRST_INPUT,
+};
+
+struct gaming_socd_pair {
+    const uint8_t usages[2];
+    const enum gaming_socd_resolution resolution;
+    bool held[2];
+    bool reported[2];
+    // Device and full keycode each key was last pressed with, to report it again later
+    uint8_t device[2];
+    zmk_key_t key[2];
+};
+
+#define GAMING_SOCD_CHECK(node_id)                                                                 \
+    BUILD_ASSERT(DT_PROP_LEN(node_id, keys) == 2, "Gaming SOCD pairs need exactly two keys")
+#define GAMING_SOCD_PAIR(node_id)                                                                  \
+    {                                                                                              \
+        .usages = {ZMK_HID_USAGE_ID(DT_PROP_BY_IDX(node_id, keys, 0)),                             \
+                   ZMK_HID_USAGE_ID(DT_PROP_BY_IDX(node_id, keys, 1))},                            \
+        .resolution = DT_ENUM_IDX(node_id, resolution),                                            \
+    },
+
+DT_FOREACH_CHILD_STATUS_OKAY_SEP(GAMING_SOCD_NODE, GAMING_SOCD_CHECK, (;));
+
+static struct gaming_socd_pair gaming_socd_pairs[] = {
+    DT_FOREACH_CHILD_STATUS_OKAY(GAMING_SOCD_NODE, GAMING_SOCD_PAIR)};
+
+BUILD_ASSERT(ARRAY_SIZE(gaming_socd_pairs) <= 127, "At most 127 gaming SOCD pairs are supported");
+
+// For each keyboard usage, 1 + twice its pair index + its side in the pair, or 0 if it has no pair
+static uint8_t gaming_socd_lookup[256];
+
+static void gaming_socd_init(void) {
+    for (int i = 0; i < ARRAY_SIZE(gaming_socd_pairs); i++) {
+        for (int side = 0; side < 2; side++) {
+            const uint8_t usage = gaming_socd_pairs[i].usages[side];
+
+            if (gaming_socd_lookup[usage] != 0) {
+                LOG_WRN("Usage 0x%02x is in more than one gaming SOCD pair", usage);
+                continue;
+            }
+
+            gaming_socd_lookup[usage] = 1 + i * 2 + side;
+        }
+    }
+}
+
+static int gaming_socd_find(zmk_key_t key, struct gaming_socd_pair **pair) {
+    if (ZMK_HID_USAGE_PAGE(key) != HID_USAGE_KEY || ZMK_HID_USAGE_ID(key) > UINT8_MAX) {
+        return -ENOENT;
+    }
+
+    const uint8_t entry = gaming_socd_lookup[ZMK_HID_USAGE_ID(key)];
+
+    if (entry == 0) {
+        return -ENOENT;
+    }
+
+    *pair = &gaming_socd_pairs[(entry - 1) / 2];
+    return (entry - 1) % 2;
+}
+
+static void gaming_socd_unreport(struct gaming_socd_pair *pair, int side) {
+    if (pair->reported[side]) {
+        pair->reported[side] = false;
+        zmk_hid_gaming_keyboard_release(pair->device[side], pair->key[side]);
+    }
+}
+
+static int gaming_key_press(uint8_t device_id, zmk_key_t key) {
+    struct gaming_socd_pair *pair;
+    const int side = gaming_socd_find(key, &pair);
+
+    if (side < 0) {
+        return zmk_hid_gaming_keyboard_press(device_id, key);
+    }
+
+    const int other = !side;
+    const bool report = !pair->held[other] || pair->resolution == GAMING_SOCD_LAST_INPUT;
+
+    if (report) {
+        int ret = zmk_hid_gaming_keyboard_press(device_id, key);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    pair->held[side] = true;
+    pair->reported[side] = report;
+    pair->device[side] = device_id;
+    pair->key[side] = key;
+
+    if (pair->held[other] && pair->resolution != GAMING_SOCD_FIRST_INPUT) {
+        gaming_socd_unreport(pair, other);
+    }
+
+    return 0;
+}
+
+static int gaming_key_release(uint8_t device_id, zmk_key_t key) {
+    struct gaming_socd_pair *pair;
+    const int side = gaming_socd_find(key, &pair);
+
+    if (side < 0) {
+        return zmk_hid_gaming_keyboard_release(device_id, key);
+    }
+
+    const int other = !side;
+
+    pair->held[side] = false;
+    gaming_socd_unreport(pair, side);
+
+    // The key still held is reported again, whichever way the overlap was resolved
+    if (pair->held[other] && !pair->reported[other]) {
+        pair->reported[other] =
+            zmk_hid_gaming_keyboard_press(pair->device[other], pair->key[other]) == 0;
+    }
+
+    return 0;
+}
+
+#else
+
+static inline void gaming_socd_init(void) {}
+
+static inline int gaming_key_press(uint8_t device_id, zmk_key_t key) {
+    return zmk_hid_gaming_keyboard_press(device_id, key);
+}
+
+static inline int gaming_key_release(uint8_t device_id, zmk_key_t key) {
+    return zmk_hid_gaming_keyboard_release(device_id, key);
+}
+
+#endif // DT_HAS_COMPAT_STATUS_OKAY(zmk_gaming_socd)
+
 // Position-based gaming HID handling with tracking
 int zmk_hid_gaming_position_press(uint32_t position, zmk_key_t key) {
-    if (position >= GAMING_MAX_POSITIONS) {
+    if (position >= ZMK_KEYMAP_LEN) {
         return -EINVAL;
     }
     
     uint8_t device_id = zmk_hid_gaming_get_device_for_position(position);
-    
+    int ret = gaming_key_press(device_id, key);
+
     // Track that this position sent a key to gaming HID
-    gaming_pressed_keys[position] = key;
-    
-    return zmk_hid_gaming_keyboard_press(device_id, key);
+    if (ret == 0) {
+        gaming_pressed_keys[position] = key;
+    }
+
+    return ret;
 }
 
 int zmk_hid_gaming_position_release(uint32_t position) {
-    if (position >= GAMING_MAX_POSITIONS) {
+    if (position >= ZMK_KEYMAP_LEN) {
         return -EINVAL;
     }
     
@@ -234,26 +523,31 @@ int zmk_hid_gaming_position_release(uint32_t position) {
     // Clear the tracking
     gaming_pressed_keys[position] = 0;
     
-    return zmk_hid_gaming_keyboard_release(device_id, key);
+    return gaming_key_release(device_id, key);
 }
 
 // Layer state change listener removed - gaming HID is always active now
 
-// Periodic keep-alive to ensure all gaming devices stay visible to Linux
-static void gaming_hid_keepalive_work_handler(struct k_work *work) {
-    // Send empty reports to all gaming devices to keep them active
-    for (int i = 0; i < ZMK_GAMING_DEVICE_COUNT; i++) {
-        zmk_hid_gaming_send_report(i);
-    }
-}
+#if IS_ENABLED(CONFIG_ZMK_USB)
 
-K_WORK_DEFINE(gaming_hid_keepalive_work, gaming_hid_keepalive_work_handler);
+// Every device's report is sent once when the host has configured or resumed the keyboard, which
+// makes it aware of all the gaming devices. Nothing has to be resent periodically after that.
+static int gaming_hid_usb_listener(const zmk_event_t *eh) {
+    static bool was_ready;
+    const bool ready = zmk_usb_is_hid_ready();
 
-static void gaming_hid_keepalive_timer_handler(struct k_timer *timer) {
-    k_work_submit(&gaming_hid_keepalive_work);
+    if (ready && (!was_ready || zmk_usb_get_status() == USB_DC_RESUME)) {
+        zmk_hid_gaming_announce();
+    }
+
+    was_ready = ready;
+    return ZMK_EV_EVENT_BUBBLE;
 }
 
-K_TIMER_DEFINE(gaming_hid_keepalive_timer, gaming_hid_keepalive_timer_handler, NULL);
+ZMK_LISTENER(gaming_hid_usb, gaming_hid_usb_listener);
+ZMK_SUBSCRIPTION(gaming_hid_usb, zmk_usb_conn_state_changed);
+
+#endif // IS_ENABLED(CONFIG_ZMK_USB)
 
 // Initialize gaming HID system  
 static int zmk_hid_gaming_init(void) {
@@ -262,17 +556,7 @@ static int zmk_hid_gaming_init(void) {
     
     // Initialize position tracking
     memset(gaming_pressed_keys, 0, sizeof(gaming_pressed_keys));
-
-    // Send initial empty reports multiple times to make Linux aware of all gaming devices
-    for (int j = 0; j < 3; j++) {
-        for (int i = 0; i < ZMK_GAMING_DEVICE_COUNT; i++) {
-            zmk_hid_gaming_send_report(i);
-        }
-        k_sleep(K_MSEC(10)); // Small delay between batches
-    }
-
-    // Start periodic keep-alive timer (every 5 seconds)
-    k_timer_start(&gaming_hid_keepalive_timer, K_SECONDS(5), K_SECONDS(5));
+    gaming_socd_init();
 
     LOG_INF("Gaming HID initialized with %d virtual devices - always active for global position-based split", ZMK_GAMING_DEVICE_COUNT);
     return 0;
@@ -16,7 +16,12 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
-static zmk_hid_indicators_t hid_indicators[ZMK_ENDPOINT_COUNT];
+// Set reports arrive on the USB and Bluetooth stack threads, so each entry is only ever read or
+// written atomically.
+static atomic_t hid_indicators[ZMK_ENDPOINT_COUNT];
+
+// The indicators last raised, or -1 if none have been yet. Only touched on the system work queue.
+static int16_t raised_indicators = -1;
 
 zmk_hid_indicators_t zmk_hid_indicators_get_current_profile(void) {
     return zmk_hid_indicators_get_profile(zmk_endpoints_selected());
@@ -24,12 +29,17 @@ zmk_hid_indicators_t zmk_hid_indicators_get_current_profile(void) {
 
 zmk_hid_indicators_t zmk_hid_indicators_get_profile(struct zmk_endpoint_instance endpoint) {
     const int profile = zmk_endpoint_instance_to_index(endpoint);
-    return hid_indicators[profile];
+    return (zmk_hid_indicators_t)atomic_get(&hid_indicators[profile]);
 }
 
 static void raise_led_changed_event(struct k_work *_work) {
     const zmk_hid_indicators_t indicators = zmk_hid_indicators_get_current_profile();
 
+    if (indicators == raised_indicators) {
+        return;
+    }
+
+    raised_indicators = indicators;
     raise_zmk_hid_indicators_changed((struct zmk_hid_indicators_changed){.indicators = indicators});
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS) && IS_ENABLED(CONFIG_ZMK_SPLIT)
@@ -37,18 +47,32 @@ static void raise_led_changed_event(struct k_work *_work) {
 #endif
 }
 
-static K_WORK_DEFINE(led_changed_work, raise_led_changed_event);
+static K_WORK_DELAYABLE_DEFINE(led_changed_work, raise_led_changed_event);
 
 void zmk_hid_indicators_set_profile(zmk_hid_indicators_t indicators,
                                     struct zmk_endpoint_instance endpoint) {
     int profile = zmk_endpoint_instance_to_index(endpoint);
 
-    // This write is not happening on the main thread. To prevent potential data races, every
-    // operation involving hid_indicators must be atomic. Currently, each function either reads
-    // or writes only one entry at a time, so it is safe to do these operations without a lock.
-    hid_indicators[profile] = indicators;
-
-    k_work_submit(&led_changed_work);
+    if ((zmk_hid_indicators_t)atomic_set(&hid_indicators[profile], indicators) == indicators) {
+        return;
+    }
+
+    // Other endpoints' indicators are raised once they're selected, by profile_listener().
+    if (profile != zmk_endpoint_instance_to_index(zmk_endpoints_selected())) {
+        return;
+    }
+
+#if CONFIG_ZMK_HID_INDICATORS_COALESCE_MS > 0
+    // Scheduling doesn't push back an already scheduled raise, so a burst of reports is raised
+    // once, at most the coalescing time after the first.
+    k_work_schedule(&led_changed_work, K_MSEC(CONFIG_ZMK_HID_INDICATORS_COALESCE_MS));
+#else
+    if (k_current_get() == k_work_queue_thread_get(&k_sys_work_q)) {
+        raise_led_changed_event(NULL);
+    } else {
+        k_work_schedule(&led_changed_work, K_NO_WAIT);
+    }
+#endif
 }
 
 void zmk_hid_indicators_process_report(struct zmk_hid_led_report_body *report,
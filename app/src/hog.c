@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include <zephyr/settings/settings.h>
 #include <zephyr/init.h>
 
@@ -18,6 +20,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/endpoints_types.h>
 #include <zmk/hog.h>
 #include <zmk/hid.h>
+#include <zmk/queue_stats.h>
+#include <zmk/workqueue.h>
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 #include <zmk/pointing/resolution_multipliers.h>
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
@@ -67,11 +71,15 @@ static struct hids_report led_indicators = {
 
 #endif // IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
 
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
 static struct hids_report consumer_input = {
     .id = ZMK_HID_REPORT_ID_CONSUMER,
     .type = HIDS_INPUT,
 };
 
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
 static struct hids_report mouse_input = {
@@ -88,8 +96,26 @@ static struct hids_report mouse_feature = {
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+static struct hids_report abs_pointer_input = {
+    .id = ZMK_HID_REPORT_ID_ABS_POINTER,
+    .type = HIDS_INPUT,
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+#define HOG_GAMING_INPUT(idx, _) {.id = ZMK_HID_GAMING_REPORT_ID_MAIN + (idx), .type = HIDS_INPUT}
+
+static struct hids_report gaming_inputs[ZMK_GAMING_DEVICE_COUNT] = {
+    LISTIFY(ZMK_GAMING_DEVICE_COUNT, HOG_GAMING_INPUT, (, ))};
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
 static bool host_requests_notification = false;
 static uint8_t ctrl_point;
 // static uint8_t proto_mode;
@@ -114,9 +140,12 @@ static ssize_t read_hids_report_map(struct bt_conn *conn, const struct bt_gatt_a
 
 static ssize_t read_hids_input_report(struct bt_conn *conn, const struct bt_gatt_attr *attr,
                                       void *buf, uint16_t len, uint16_t offset) {
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    struct zmk_hid_composite_report_body *report_body = &zmk_hid_get_composite_report()->body;
+#else
     struct zmk_hid_keyboard_report_body *report_body = &zmk_hid_get_keyboard_report()->body;
-    return bt_gatt_attr_read(conn, attr, buf, len, offset, report_body,
-                             sizeof(struct zmk_hid_keyboard_report_body));
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, report_body, sizeof(*report_body));
 }
 
 #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
@@ -147,6 +176,8 @@ static ssize_t write_hids_leds_report(struct bt_conn *conn, const struct bt_gatt
 
 #endif // IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
 
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
 static ssize_t read_hids_consumer_input_report(struct bt_conn *conn,
                                                const struct bt_gatt_attr *attr, void *buf,
                                                uint16_t len, uint16_t offset) {
@@ -155,6 +186,8 @@ static ssize_t read_hids_consumer_input_report(struct bt_conn *conn,
                              sizeof(struct zmk_hid_consumer_report_body));
 }
 
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
 static ssize_t read_hids_mouse_input_report(struct bt_conn *conn, const struct bt_gatt_attr *attr,
@@ -201,8 +234,50 @@ static ssize_t write_hids_mouse_feature_report(struct bt_conn *conn,
 
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+static ssize_t read_hids_abs_pointer_input_report(struct bt_conn *conn,
+                                                  const struct bt_gatt_attr *attr, void *buf,
+                                                  uint16_t len, uint16_t offset) {
+    struct zmk_hid_abs_pointer_report_body *report_body =
+        &zmk_hid_get_abs_pointer_report()->body;
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, report_body,
+                             sizeof(struct zmk_hid_abs_pointer_report_body));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+static size_t gaming_report_body_size(uint8_t device_id) {
+    return zmk_hid_gaming_get_keyboard_report_size(device_id) -
+           offsetof(struct zmk_gaming_keyboard_report, body);
+}
+
+static ssize_t read_hids_gaming_input_report(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                                             void *buf, uint16_t len, uint16_t offset) {
+    const struct hids_report *report_ref = attr->user_data;
+    const uint8_t device_id = report_ref->id - ZMK_HID_GAMING_REPORT_ID_MAIN;
+    struct zmk_gaming_keyboard_report *report = zmk_hid_gaming_get_keyboard_report(device_id);
+
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, &report->body,
+                             gaming_report_body_size(device_id));
+}
+
+// One input report characteristic per gaming device. The value's user data is its report
+// reference, so the read callback knows which device is being read.
+#define HOG_GAMING_INPUT_ATTRS(idx, _)                                                             \
+    BT_GATT_CHARACTERISTIC(BT_UUID_HIDS_REPORT, BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,           \
+                           BT_GATT_PERM_READ_ENCRYPT, read_hids_gaming_input_report, NULL,         \
+                           &gaming_inputs[idx]),                                                   \
+        BT_GATT_CCC(input_ccc_changed, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),    \
+        BT_GATT_DESCRIPTOR(BT_UUID_HIDS_REPORT_REF, BT_GATT_PERM_READ_ENCRYPT,                     \
+                           read_hids_report_ref, NULL, &gaming_inputs[idx])
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
 // static ssize_t write_proto_mode(struct bt_conn *conn,
 //                                 const struct bt_gatt_attr *attr,
 //                                 const void *buf, uint16_t len, uint16_t offset,
@@ -245,11 +320,13 @@ BT_GATT_SERVICE_DEFINE(
     BT_GATT_DESCRIPTOR(BT_UUID_HIDS_REPORT_REF, BT_GATT_PERM_READ_ENCRYPT, read_hids_report_ref,
                        NULL, &input),
 
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
     BT_GATT_CHARACTERISTIC(BT_UUID_HIDS_REPORT, BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
                            BT_GATT_PERM_READ_ENCRYPT, read_hids_consumer_input_report, NULL, NULL),
     BT_GATT_CCC(input_ccc_changed, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
     BT_GATT_DESCRIPTOR(BT_UUID_HIDS_REPORT_REF, BT_GATT_PERM_READ_ENCRYPT, read_hids_report_ref,
                        NULL, &consumer_input),
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
     BT_GATT_CHARACTERISTIC(BT_UUID_HIDS_REPORT, BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
@@ -267,6 +344,15 @@ BT_GATT_SERVICE_DEFINE(
                        NULL, &mouse_feature),
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    BT_GATT_CHARACTERISTIC(BT_UUID_HIDS_REPORT, BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ_ENCRYPT, read_hids_abs_pointer_input_report, NULL,
+                           NULL),
+    BT_GATT_CCC(input_ccc_changed, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
+    BT_GATT_DESCRIPTOR(BT_UUID_HIDS_REPORT_REF, BT_GATT_PERM_READ_ENCRYPT, read_hids_report_ref,
+                       NULL, &abs_pointer_input),
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
 #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
@@ -278,6 +364,10 @@ BT_GATT_SERVICE_DEFINE(
                        NULL, &led_indicators),
 #endif // IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+    LISTIFY(ZMK_GAMING_DEVICE_COUNT, HOG_GAMING_INPUT_ATTRS, (, )),
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
     BT_GATT_CHARACTERISTIC(BT_UUID_HIDS_CTRL_POINT, BT_GATT_CHRC_WRITE_WITHOUT_RESP,
                            BT_GATT_PERM_WRITE, NULL, write_ctrl_point, &ctrl_point));
 
@@ -285,164 +375,444 @@ K_THREAD_STACK_DEFINE(hog_q_stack, CONFIG_ZMK_BLE_THREAD_STACK_SIZE);
 
 struct k_work_q hog_work_q;
 
-K_MSGQ_DEFINE(zmk_hog_keyboard_msgq, sizeof(struct zmk_hid_keyboard_report_body),
-              CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE, 4);
+// All reports go through one scheduler: each report type has its own queue, and the send work
+// drains them in priority order, so a burst of mouse motion never delays a key press. Queueing
+// never blocks; a full queue drops its oldest report, except that mouse motion is merged into the
+// newest queued report whenever its buttons are unchanged.
+struct hog_report_queue {
+    uint8_t *buffer;
+    size_t item_size;
+    uint8_t capacity;
+    uint8_t head;
+    uint8_t len;
+    uint16_t attr_index;
+    struct zmk_hog_queue_stats stats;
+#if IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
+    struct zmk_queue_stats *queue_stats;
+#endif // IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
+};
 
-void send_keyboard_report_callback(struct k_work *work) {
-    struct zmk_hid_keyboard_report_body report;
+#define HOG_REPORT_QUEUE(_name, _type, _capacity, _attr_index)                                     \
+    static _type _name##_buffer[_capacity];                                                        \
+    ZMK_QUEUE_STATS_DEFINE(_name, "HOG " STRINGIFY(_name), _capacity);                             \
+    static struct hog_report_queue _name = {                                                       \
+        .buffer = (uint8_t *)_name##_buffer,                                                       \
+        .item_size = sizeof(_type),                                                                \
+        .capacity = _capacity,                                                                     \
+        .attr_index = _attr_index,                                                                 \
+        IF_ENABLED(CONFIG_ZMK_QUEUE_STATS, (.queue_stats = &ZMK_QUEUE_STATS(_name), ))}
+
+// Indices of the input report characteristic values in hog_svc.
+#define HOG_ATTR_KEYBOARD_INPUT 5
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+#define HOG_ATTR_MOUSE_INPUT 9
+#else
+#define HOG_ATTR_CONSUMER_INPUT 9
+#define HOG_ATTR_MOUSE_INPUT 13
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+// The absolute pointer follows the mouse input report, and its feature report if there is one.
+#if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
+#define HOG_ATTR_ABS_POINTER_INPUT (HOG_ATTR_MOUSE_INPUT + 7)
+#else
+#define HOG_ATTR_ABS_POINTER_INPUT (HOG_ATTR_MOUSE_INPUT + 4)
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
-    while (k_msgq_get(&zmk_hog_keyboard_msgq, &report, K_NO_WAIT) == 0) {
-        struct bt_conn *conn = zmk_ble_active_profile_conn();
-        if (conn == NULL) {
-            return;
-        }
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+// The gaming reports are the last input reports, right before the control point characteristic.
+// Each one takes four attributes: declaration, value, CCC and report reference.
+#define HOG_GAMING_INPUT_ATTR_COUNT 4
+#define HOG_CTRL_POINT_ATTR_COUNT 2
 
-        struct bt_gatt_notify_params notify_params = {
-            .attr = &hog_svc.attrs[5],
-            .data = &report,
-            .len = sizeof(report),
-        };
-
-        int err = bt_gatt_notify_cb(conn, &notify_params);
-        if (err == -EPERM) {
-            bt_conn_set_security(conn, BT_SECURITY_L2);
-        } else if (err) {
-            LOG_DBG("Error notifying %d", err);
-        }
+static const struct bt_gatt_attr *gaming_input_attr(uint8_t device_id) {
+    return &hog_svc.attrs[hog_svc.attr_count - HOG_CTRL_POINT_ATTR_COUNT -
+                          (ZMK_GAMING_DEVICE_COUNT - device_id) * HOG_GAMING_INPUT_ATTR_COUNT + 1];
+}
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
 
-        bt_conn_unref(conn);
+BUILD_ASSERT(CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE <= UINT8_MAX);
+
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+HOG_REPORT_QUEUE(keyboard_queue, struct zmk_hid_composite_report_body,
+                 CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE, HOG_ATTR_KEYBOARD_INPUT);
+#else
+BUILD_ASSERT(CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE <= UINT8_MAX);
+
+HOG_REPORT_QUEUE(keyboard_queue, struct zmk_hid_keyboard_report_body,
+                 CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE, HOG_ATTR_KEYBOARD_INPUT);
+HOG_REPORT_QUEUE(consumer_queue, struct zmk_hid_consumer_report_body,
+                 CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE, HOG_ATTR_CONSUMER_INPUT);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+BUILD_ASSERT(CONFIG_ZMK_BLE_GAMING_REPORT_QUEUE_SIZE <= UINT8_MAX);
+
+// A gaming report and the device it's for. Its attribute is looked up from the device when sent.
+struct hog_gaming_report {
+    uint8_t device_id;
+    struct zmk_gaming_keyboard_report_body body;
+} __packed;
+
+HOG_REPORT_QUEUE(gaming_queue, struct hog_gaming_report, CONFIG_ZMK_BLE_GAMING_REPORT_QUEUE_SIZE,
+                 0);
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+BUILD_ASSERT(CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE <= UINT8_MAX);
+
+HOG_REPORT_QUEUE(mouse_queue, struct zmk_hid_mouse_report_body,
+                 CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE, HOG_ATTR_MOUSE_INPUT);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+HOG_REPORT_QUEUE(abs_pointer_queue, struct zmk_hid_abs_pointer_report_body,
+                 CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE, HOG_ATTR_ABS_POINTER_INPUT);
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+// Highest priority first.
+static struct hog_report_queue *const report_queues[] = {
+    [ZMK_HOG_REPORT_KEYBOARD] = &keyboard_queue,
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+    [ZMK_HOG_REPORT_GAMING] = &gaming_queue,
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    [ZMK_HOG_REPORT_CONSUMER] = &consumer_queue,
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    [ZMK_HOG_REPORT_MOUSE] = &mouse_queue,
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    [ZMK_HOG_REPORT_ABS_POINTER] = &abs_pointer_queue,
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+};
+
+static struct k_spinlock report_queues_lock;
+
+static uint8_t *report_queue_at(struct hog_report_queue *queue, uint8_t offset) {
+    return queue->buffer + ((queue->head + offset) % queue->capacity) * queue->item_size;
+}
+
+static void report_queue_drop_oldest(struct hog_report_queue *queue) {
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->len--;
+    queue->stats.dropped++;
+#if IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
+    zmk_queue_stats_record_overflow(queue->queue_stats);
+#endif // IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
+}
+
+static void report_queue_push(struct hog_report_queue *queue, const void *report) {
+    if (queue->len == queue->capacity) {
+        LOG_WRN("HOG report queue full, dropping oldest report");
+        report_queue_drop_oldest(queue);
     }
+
+    memcpy(report_queue_at(queue, queue->len++), report, queue->item_size);
+    queue->stats.queued++;
+#if IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
+    zmk_queue_stats_record_put(queue->queue_stats, queue->len);
+#endif // IS_ENABLED(CONFIG_ZMK_QUEUE_STATS)
 }
 
-K_WORK_DEFINE(hog_keyboard_work, send_keyboard_report_callback);
+static bool report_queue_pop(struct hog_report_queue *queue, void *report) {
+    if (queue->len == 0) {
+        return false;
+    }
 
-int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_keyboard_msgq, report, K_MSEC(100));
-    if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Keyboard message queue full, popping first message and queueing again");
-            struct zmk_hid_keyboard_report_body discarded_report;
-            k_msgq_get(&zmk_hog_keyboard_msgq, &discarded_report, K_NO_WAIT);
-            return zmk_hog_send_keyboard_report(report);
+    memcpy(report, report_queue_at(queue, 0), queue->item_size);
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->len--;
+
+    return true;
+}
+
+union hog_report {
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    struct zmk_hid_composite_report_body composite;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    struct zmk_hid_keyboard_report_body keyboard;
+    struct zmk_hid_consumer_report_body consumer;
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+    struct hog_gaming_report gaming;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    struct zmk_hid_mouse_report_body mouse;
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    struct zmk_hid_abs_pointer_report_body abs_pointer;
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+};
+
+static struct hog_report_queue *pop_next_report(union hog_report *report) {
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+    struct hog_report_queue *queue = NULL;
+
+    for (int i = 0; i < ARRAY_SIZE(report_queues); i++) {
+#if IS_ENABLED(CONFIG_ZMK_BLE_MOUSE_REPORT_PACING)
+        // Paced mouse reports are sent by mouse_flush_work instead.
+        if (i == ZMK_HOG_REPORT_MOUSE) {
+            continue;
         }
-        default:
-            LOG_WRN("Failed to queue keyboard report to send (%d)", err);
-            return err;
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MOUSE_REPORT_PACING)
+
+        if (report_queue_pop(report_queues[i], report)) {
+            queue = report_queues[i];
+            break;
         }
     }
 
-    k_work_submit_to_queue(&hog_work_q, &hog_keyboard_work);
+    k_spin_unlock(&report_queues_lock, key);
+    return queue;
+}
 
-    return 0;
-};
+static void notify_report(struct bt_conn *conn, const struct hog_report_queue *queue,
+                          const union hog_report *report) {
+    struct bt_gatt_notify_params notify_params = {
+        .attr = &hog_svc.attrs[queue->attr_index],
+        .data = report,
+        .len = queue->item_size,
+    };
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+    if (queue == &gaming_queue) {
+        notify_params.attr = gaming_input_attr(report->gaming.device_id);
+        notify_params.data = &report->gaming.body;
+        notify_params.len = gaming_report_body_size(report->gaming.device_id);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
 
-K_MSGQ_DEFINE(zmk_hog_consumer_msgq, sizeof(struct zmk_hid_consumer_report_body),
-              CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE, 4);
+    int err = bt_gatt_notify_cb(conn, &notify_params);
+    if (err == -EPERM) {
+        bt_conn_set_security(conn, BT_SECURITY_L2);
+    } else if (err) {
+        LOG_DBG("Error notifying %d", err);
+    }
+}
 
-void send_consumer_report_callback(struct k_work *work) {
-    struct zmk_hid_consumer_report_body report;
+ZMK_WORKQUEUE_PROFILE_HANDLER(send_reports_callback) {
+    union hog_report report;
+    struct hog_report_queue *queue;
 
-    while (k_msgq_get(&zmk_hog_consumer_msgq, &report, K_NO_WAIT) == 0) {
+    while ((queue = pop_next_report(&report)) != NULL) {
         struct bt_conn *conn = zmk_ble_active_profile_conn();
         if (conn == NULL) {
             return;
         }
 
-        struct bt_gatt_notify_params notify_params = {
-            .attr = &hog_svc.attrs[9],
-            .data = &report,
-            .len = sizeof(report),
-        };
-
-        int err = bt_gatt_notify_cb(conn, &notify_params);
-        if (err == -EPERM) {
-            bt_conn_set_security(conn, BT_SECURITY_L2);
-        } else if (err) {
-            LOG_DBG("Error notifying %d", err);
-        }
-
+        notify_report(conn, queue, &report);
         bt_conn_unref(conn);
     }
-};
+}
 
-K_WORK_DEFINE(hog_consumer_work, send_consumer_report_callback);
+K_WORK_DEFINE(hog_send_work, ZMK_WORKQUEUE_PROFILED(send_reports_callback));
 
-int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_consumer_msgq, report, K_MSEC(100));
-    if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Consumer message queue full, popping first message and queueing again");
-            struct zmk_hid_consumer_report_body discarded_report;
-            k_msgq_get(&zmk_hog_consumer_msgq, &discarded_report, K_NO_WAIT);
-            return zmk_hog_send_consumer_report(report);
-        }
-        default:
-            LOG_WRN("Failed to queue consumer report to send (%d)", err);
-            return err;
-        }
-    }
+static inline void note_report_activity(void) {
+#if IS_ENABLED(CONFIG_ZMK_BLE_ADAPTIVE_CONN_PARAMS)
+    zmk_ble_conn_params_note_activity();
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_ADAPTIVE_CONN_PARAMS)
+}
+
+static int queue_report(struct hog_report_queue *queue, const void *report) {
+    note_report_activity();
+
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+    report_queue_push(queue, report);
+    k_spin_unlock(&report_queues_lock, key);
 
-    k_work_submit_to_queue(&hog_work_q, &hog_consumer_work);
+    ZMK_WORKQUEUE_PROFILE_SUBMITTED(send_reports_callback);
+    k_work_submit_to_queue(&hog_work_q, &hog_send_work);
 
     return 0;
-};
+}
+
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+
+int zmk_hog_send_composite_report(struct zmk_hid_composite_report_body *report) {
+    return queue_report(&keyboard_queue, report);
+}
+
+#else
+
+int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *report) {
+    return queue_report(&keyboard_queue, report);
+}
+
+int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
+    return queue_report(&consumer_queue, report);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 
-K_MSGQ_DEFINE(zmk_hog_mouse_msgq, sizeof(struct zmk_hid_mouse_report_body),
-              CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE, 4);
+static bool add_motion(int16_t *total, int16_t delta) {
+    int32_t sum = (int32_t)*total + delta;
 
-void send_mouse_report_callback(struct k_work *work) {
-    struct zmk_hid_mouse_report_body report;
-    while (k_msgq_get(&zmk_hog_mouse_msgq, &report, K_NO_WAIT) == 0) {
-        struct bt_conn *conn = zmk_ble_active_profile_conn();
-        if (conn == NULL) {
-            return;
-        }
+    if (sum < INT16_MIN || sum > INT16_MAX) {
+        return false;
+    }
 
-        struct bt_gatt_notify_params notify_params = {
-            .attr = &hog_svc.attrs[13],
-            .data = &report,
-            .len = sizeof(report),
-        };
-
-        int err = bt_gatt_notify_cb(conn, &notify_params);
-        if (err == -EPERM) {
-            bt_conn_set_security(conn, BT_SECURITY_L2);
-        } else if (err) {
-            LOG_DBG("Error notifying %d", err);
-        }
+    *total = sum;
+    return true;
+}
 
-        bt_conn_unref(conn);
+// Sums the motion of a new report into the newest queued one if the buttons match. Nothing is
+// changed unless every axis fits.
+static bool merge_mouse_report(struct zmk_hid_mouse_report_body *queued,
+                               const struct zmk_hid_mouse_report_body *report) {
+    if (queued->buttons != report->buttons) {
+        return false;
     }
-};
 
-K_WORK_DEFINE(hog_mouse_work, send_mouse_report_callback);
+    struct zmk_hid_mouse_report_body merged = *queued;
+
+    if (!add_motion(&merged.d_x, report->d_x) || !add_motion(&merged.d_y, report->d_y) ||
+        !add_motion(&merged.d_scroll_y, report->d_scroll_y) ||
+        !add_motion(&merged.d_scroll_x, report->d_scroll_x)) {
+        return false;
+    }
+
+    *queued = merged;
+    return true;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BLE_MOUSE_REPORT_PACING)
+
+// A connection event can only carry so many notifications, so mouse reports are sent at most once
+// per connection interval. Motion arriving in between is summed into the pending report.
+static int64_t next_mouse_flush_at;
+
+static void flush_mouse_report(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(mouse_flush_work, flush_mouse_report);
+
+static void schedule_mouse_flush(void) {
+    k_work_schedule_for_queue(&hog_work_q, &mouse_flush_work,
+                              K_MSEC(MAX(next_mouse_flush_at - k_uptime_get(), 0)));
+}
+
+static void flush_mouse_report(struct k_work *work) {
+    union hog_report report;
+
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+    bool popped = report_queue_pop(&mouse_queue, &report);
+    bool more = mouse_queue.len > 0;
+    k_spin_unlock(&report_queues_lock, key);
+
+    if (!popped) {
+        return;
+    }
+
+    struct bt_conn *conn = zmk_ble_active_profile_conn();
+    if (conn == NULL) {
+        return;
+    }
+
+    struct bt_conn_info info;
+    uint32_t interval_us = 0;
+    if (bt_conn_get_info(conn, &info) == 0) {
+        // The connection interval is in units of 1.25 ms.
+        interval_us = info.le.interval * 1250U;
+    }
+
+    notify_report(conn, &mouse_queue, &report);
+    bt_conn_unref(conn);
+
+    next_mouse_flush_at = k_uptime_get() + DIV_ROUND_UP(interval_us, 1000);
+
+    if (more) {
+        schedule_mouse_flush();
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MOUSE_REPORT_PACING)
 
 int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_mouse_msgq, report, K_MSEC(100));
-    if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Consumer message queue full, popping first message and queueing again");
-            struct zmk_hid_mouse_report_body discarded_report;
-            k_msgq_get(&zmk_hog_mouse_msgq, &discarded_report, K_NO_WAIT);
-            return zmk_hog_send_mouse_report(report);
-        }
-        default:
-            LOG_WRN("Failed to queue mouse report to send (%d)", err);
-            return err;
-        }
+    note_report_activity();
+
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+
+    if (mouse_queue.len > 0 &&
+        merge_mouse_report((struct zmk_hid_mouse_report_body *)report_queue_at(
+                               &mouse_queue, mouse_queue.len - 1),
+                           report)) {
+        mouse_queue.stats.merged++;
+        k_spin_unlock(&report_queues_lock, key);
+        return 0;
     }
 
-    k_work_submit_to_queue(&hog_work_q, &hog_mouse_work);
+#if IS_ENABLED(CONFIG_ZMK_BLE_MOUSE_REPORT_PACING)
+    report_queue_push(&mouse_queue, report);
+    k_spin_unlock(&report_queues_lock, key);
+
+    schedule_mouse_flush();
 
     return 0;
-};
+#else
+    k_spin_unlock(&report_queues_lock, key);
+
+    return queue_report(&mouse_queue, report);
+#endif // IS_ENABLED(CONFIG_ZMK_BLE_MOUSE_REPORT_PACING)
+}
+
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+int zmk_hog_send_abs_pointer_report(struct zmk_hid_abs_pointer_report_body *report) {
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+
+    // Only the latest position matters, so it replaces a queued report with the same buttons.
+    if (abs_pointer_queue.len > 0) {
+        struct zmk_hid_abs_pointer_report_body *queued =
+            (struct zmk_hid_abs_pointer_report_body *)report_queue_at(
+                &abs_pointer_queue, abs_pointer_queue.len - 1);
+
+        if (queued->buttons == report->buttons) {
+            *queued = *report;
+            abs_pointer_queue.stats.merged++;
+            k_spin_unlock(&report_queues_lock, key);
+
+            note_report_activity();
+            ZMK_WORKQUEUE_PROFILE_SUBMITTED(send_reports_callback);
+            k_work_submit_to_queue(&hog_work_q, &hog_send_work);
+            return 0;
+        }
+    }
+
+    k_spin_unlock(&report_queues_lock, key);
+
+    return queue_report(&abs_pointer_queue, report);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+int zmk_hog_send_gaming_report(uint8_t device_id,
+                               const struct zmk_gaming_keyboard_report_body *body) {
+    if (device_id >= ZMK_GAMING_DEVICE_COUNT) {
+        return -EINVAL;
+    }
+
+    struct hog_gaming_report report = {.device_id = device_id, .body = *body};
+
+    return queue_report(&gaming_queue, &report);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+int zmk_hog_get_queue_stats(enum zmk_hog_report_type type, struct zmk_hog_queue_stats *stats) {
+    if (type >= ARRAY_SIZE(report_queues)) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&report_queues_lock);
+    *stats = report_queues[type]->stats;
+    k_spin_unlock(&report_queues_lock, key);
+
+    return 0;
+}
+
 static int zmk_hog_init(void) {
     static const struct k_work_queue_config queue_config = {.name = "HID Over GATT Send Work"};
     k_work_queue_start(&hog_work_q, hog_q_stack, K_THREAD_STACK_SIZEOF(hog_q_stack),
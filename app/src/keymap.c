@@ -6,6 +6,7 @@
 
 #include <drivers/behavior.h>
 #include <zephyr/sys/util.h>
+#include <zephyr/sys/crc.h>
 #include <zephyr/settings/settings.h>
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -17,10 +18,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/matrix.h>
 #include <zmk/sensors.h>
 #include <zmk/virtual_key_position.h>
+#include <zmk/workqueue.h>
 
 #include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/layer_state_changed.h>
+#include <zmk/events/highest_layer_changed.h>
 #include <zmk/events/sensor_event.h>
 
 #if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
@@ -30,7 +34,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/keys.h>
 #endif // CONFIG_ZMK_HID_GAMING
 
-static zmk_keymap_layers_state_t _zmk_keymap_layer_state = 0;
+static zmk_keymap_layers_state_t _zmk_keymap_layer_state;
 static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 
 #define DT_DRV_COMPAT zmk_keymap
@@ -41,6 +45,10 @@ static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 
 #endif
 
+BUILD_ASSERT(ZMK_KEYMAP_LAYERS_LEN <= ZMK_KEYMAP_LAYERS_STATE_WORDS * 32,
+             "Keymaps with more than 32 layers require CONFIG_ZMK_KEYMAP_LAYER_STATE_WIDE");
+BUILD_ASSERT(ZMK_KEYMAP_LAYERS_LEN < ZMK_KEYMAP_LAYER_ID_INVAL, "Too many keymap layers");
+
 #define TRANSFORMED_LAYER(node)                                                                    \
     {COND_CODE_1(DT_NODE_HAS_PROP(node, bindings),                                                 \
                  (LISTIFY(DT_PROP_LEN(node, bindings), ZMK_KEYMAP_EXTRACT_BINDING, (, ), node)),   \
@@ -49,18 +57,24 @@ static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 #if ZMK_KEYMAP_HAS_SENSORS
 #define _TRANSFORM_SENSOR_ENTRY(idx, layer)                                                        \
     {                                                                                              \
-        .behavior_dev = DEVICE_DT_NAME(DT_PHANDLE_BY_IDX(layer, sensor_bindings, idx)),            \
-        .param1 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(layer, sensor_bindings, idx, param1), (0),    \
-                              (DT_PHA_BY_IDX(layer, sensor_bindings, idx, param1))),               \
-        .param2 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(layer, sensor_bindings, idx, param2), (0),    \
-                              (DT_PHA_BY_IDX(layer, sensor_bindings, idx, param2))),               \
+        .binding =                                                                                 \
+            {                                                                                      \
+                .behavior_dev = DEVICE_DT_NAME(DT_PHANDLE_BY_IDX(layer, sensor_bindings, idx)),    \
+                .param1 =                                                                          \
+                    COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(layer, sensor_bindings, idx, param1), (0),  \
+                                (DT_PHA_BY_IDX(layer, sensor_bindings, idx, param1))),             \
+                .param2 =                                                                          \
+                    COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(layer, sensor_bindings, idx, param2), (0),  \
+                                (DT_PHA_BY_IDX(layer, sensor_bindings, idx, param2))),             \
+            },                                                                                     \
+        .layer_id = DT_NODE_CHILD_IDX(layer), .sensor_index = idx,                                 \
     }
 
 #define SENSOR_LAYER(node)                                                                         \
     COND_CODE_1(                                                                                   \
         DT_NODE_HAS_PROP(node, sensor_bindings),                                                   \
-        ({LISTIFY(DT_PROP_LEN(node, sensor_bindings), _TRANSFORM_SENSOR_ENTRY, (, ), node)}),      \
-        ({}))
+        (LISTIFY(DT_PROP_LEN(node, sensor_bindings), _TRANSFORM_SENSOR_ENTRY, (, ), node), ),      \
+        ())
 
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
@@ -68,10 +82,65 @@ static zmk_keymap_layer_id_t _zmk_keymap_layer_default = 0;
 
 // State
 
-// When a behavior handles a key position "down" event, we record the layer state
-// here so that even if that layer is deactivated before the "up", event, we
-// still send the release event to the behavior in that layer also.
-static uint32_t zmk_keymap_active_behavior_layer[ZMK_KEYMAP_LEN];
+// When a behavior handles a key position "down" event, we record the index of the layer it was
+// found on here so that even if that layer is deactivated before the "up" event, we still send
+// the release event to the behavior in that layer also. Only the resolved index is kept, rather
+// than a copy of the whole layer state, so this costs one byte per position however many layers.
+static zmk_keymap_layer_index_t zmk_keymap_active_behavior_layer_idx[ZMK_KEYMAP_LEN];
+
+// Per key position, the highest active layer index whose binding doesn't simply fall through to
+// the layers below. Entries are recomputed lazily on the next press after anything that affects
+// resolution (layer state, layer order, bindings or physical layout) bumps the generation.
+struct keymap_position_cache_entry {
+    uint8_t generation;
+    zmk_keymap_layer_index_t layer_idx;
+};
+
+static struct keymap_position_cache_entry keymap_position_cache[ZMK_KEYMAP_LEN];
+static uint8_t keymap_position_cache_generation = 1;
+
+static void invalidate_position_cache(void) {
+    // Generation zero is reserved for "never resolved", so on wrap-around reset all entries
+    if (++keymap_position_cache_generation == 0) {
+        memset(keymap_position_cache, 0, sizeof(keymap_position_cache));
+        keymap_position_cache_generation = 1;
+    }
+}
+
+// Per layer index and key position, the highest layer index at or below it whose binding doesn't
+// simply fall through, or ZMK_KEYMAP_LAYER_ID_INVAL if there's none. Unlike the position cache it
+// doesn't depend on which layers are active, so it's only rebuilt after the bindings, layer order
+// or physical layout change.
+static zmk_keymap_layer_index_t opaque_layer_idx[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN];
+static bool opaque_layers_stale = true;
+
+static inline void invalidate_opaque_layers(void) { opaque_layers_stale = true; }
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+// Set whenever a binding may have changed, so the gaming HID routes are rebuilt before they're used
+static bool gaming_routes_stale = true;
+
+static inline void invalidate_gaming_routes(void) { gaming_routes_stale = true; }
+
+#else
+
+static inline void invalidate_gaming_routes(void) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_FAST_DISPATCH)
+
+// Set whenever a binding may have changed, so the binding kinds are rebuilt before they're used
+static bool binding_kinds_stale = true;
+
+static inline void invalidate_binding_kinds(void) { binding_kinds_stale = true; }
+
+#else
+
+static inline void invalidate_binding_kinds(void) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_FAST_DISPATCH)
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
@@ -79,26 +148,136 @@ static uint8_t keymap_layer_orders[ZMK_KEYMAP_LAYERS_LEN];
 
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
-#define KEYMAP_VAR(_name, _opts, no_init)                                                          \
-    static _opts struct zmk_behavior_binding _name[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN] = {      \
-        COND_CODE_0(                                                                               \
-            no_init,                                                                               \
-            (COND_CODE_1(IS_ENABLED(CONFIG_ZMK_STUDIO),                                            \
-                         (DT_INST_FOREACH_CHILD_SEP(0, TRANSFORMED_LAYER, (, ))),                  \
-                         (DT_INST_FOREACH_CHILD_STATUS_OKAY_SEP(0, TRANSFORMED_LAYER, (, ))))),    \
-            (0))};
+// The keymap from the devicetree stays in flash. Bindings changed at runtime are kept in a small
+// overlay instead of a RAM copy of the whole keymap, see layer_binding().
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT)
+
+#define FOREACH_KEYMAP_LAYER_SEP(fn, sep)                                                          \
+    COND_CODE_1(IS_ENABLED(CONFIG_ZMK_STUDIO), (DT_INST_FOREACH_CHILD_SEP(0, fn, sep)),            \
+                (DT_INST_FOREACH_CHILD_STATUS_OKAY_SEP(0, fn, sep)))
+
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(zmk_behavior_transparent) <= 1 &&
+                 DT_NUM_INST_STATUS_OKAY(zmk_behavior_none) <= 1,
+             "CONFIG_ZMK_KEYMAP_COMPACT requires a single transparent and none behavior");
+
+// &trans and &none, which most keys of the upper layers are bound to, only take the byte giving
+// the kind of each key's binding. The other bindings are stored in full, one layer after another.
+enum compact_binding_kind {
+    // Past the end of the layer's bindings.
+    COMPACT_BINDING_EMPTY,
+    COMPACT_BINDING_STORED,
+    COMPACT_BINDING_TRANS,
+    COMPACT_BINDING_NONE,
+};
 
-KEYMAP_VAR(zmk_keymap, COND_CODE_1(IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE), (), (const)),
-           IS_ENABLED(CONFIG_ZMK_STUDIO))
+#define COMPACT_BINDING_IS(idx, node, compat)                                                      \
+    DT_NODE_HAS_COMPAT(DT_PHANDLE_BY_IDX(node, bindings, idx), compat)
 
-#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+#define COMPACT_BINDING_KIND(idx, node)                                                            \
+    (COMPACT_BINDING_IS(idx, node, zmk_behavior_transparent) ? COMPACT_BINDING_TRANS               \
+     : COMPACT_BINDING_IS(idx, node, zmk_behavior_none)      ? COMPACT_BINDING_NONE                \
+                                                             : COMPACT_BINDING_STORED)
+
+#define COMPACT_STORED_BINDING(idx, node)                                                          \
+    COND_CODE_0(COMPACT_BINDING_IS(idx, node, zmk_behavior_transparent),                           \
+                (COND_CODE_0(COMPACT_BINDING_IS(idx, node, zmk_behavior_none),                     \
+                             (ZMK_KEYMAP_EXTRACT_BINDING(idx, node), ), ())),                      \
+                ())
+
+#define COMPACT_LAYER_KINDS(node)                                                                  \
+    {COND_CODE_1(DT_NODE_HAS_PROP(node, bindings),                                                 \
+                 (LISTIFY(DT_PROP_LEN(node, bindings), COMPACT_BINDING_KIND, (, ), node)), ())}
+
+#define COMPACT_LAYER_BINDINGS(node)                                                               \
+    COND_CODE_1(DT_NODE_HAS_PROP(node, bindings),                                                  \
+                (LISTIFY(DT_PROP_LEN(node, bindings), COMPACT_STORED_BINDING, (), node)), ())
+
+#define COMPACT_ONLY_BINDING(compat)                                                               \
+    {                                                                                              \
+        .behavior_dev = COND_CODE_1(DT_HAS_COMPAT_STATUS_OKAY(compat),                             \
+                                    (DEVICE_DT_NAME(DT_COMPAT_GET_ANY_STATUS_OKAY(compat))),       \
+                                    (NULL)),                                                       \
+    }
+
+#define COMPACT_WORDS DIV_ROUND_UP(ZMK_KEYMAP_LEN, 32)
+
+static const uint8_t compact_kinds[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN] = {
+    FOREACH_KEYMAP_LAYER_SEP(COMPACT_LAYER_KINDS, (, ))};
+
+static const struct zmk_behavior_binding compact_bindings[] = {
+    FOREACH_KEYMAP_LAYER_SEP(COMPACT_LAYER_BINDINGS, ())};
+
+static const struct zmk_behavior_binding compact_trans_binding =
+    COMPACT_ONLY_BINDING(zmk_behavior_transparent);
+static const struct zmk_behavior_binding compact_none_binding =
+    COMPACT_ONLY_BINDING(zmk_behavior_none);
+static const struct zmk_behavior_binding compact_empty_binding = {};
+
+// Built from compact_kinds at init: the positions of each layer with a stored binding, and the
+// index in compact_bindings of the first one of each group of 32 positions.
+static uint32_t compact_stored[ZMK_KEYMAP_LAYERS_LEN][COMPACT_WORDS];
+static uint16_t compact_first[ZMK_KEYMAP_LAYERS_LEN][COMPACT_WORDS];
+
+static void compact_keymap_init(void) {
+    uint16_t next = 0;
+
+    for (int layer = 0; layer < ZMK_KEYMAP_LAYERS_LEN; layer++) {
+        for (int pos = 0; pos < ZMK_KEYMAP_LEN; pos++) {
+            if (pos % 32 == 0) {
+                compact_first[layer][pos / 32] = next;
+            }
+
+            if (compact_kinds[layer][pos] == COMPACT_BINDING_STORED) {
+                compact_stored[layer][pos / 32] |= BIT(pos % 32);
+                next++;
+            }
+        }
+    }
+
+    __ASSERT(next == ARRAY_SIZE(compact_bindings), "Compact keymap tables don't match");
+}
+
+static const struct zmk_behavior_binding *stock_binding(uint8_t layer, uint8_t position) {
+    switch (compact_kinds[layer][position]) {
+    case COMPACT_BINDING_STORED: {
+        const uint32_t before = compact_stored[layer][position / 32] & (BIT(position % 32) - 1);
 
-KEYMAP_VAR(zmk_stock_keymap, const, 0)
+        return &compact_bindings[compact_first[layer][position / 32] + __builtin_popcount(before)];
+    }
+    case COMPACT_BINDING_TRANS:
+        return &compact_trans_binding;
+    case COMPACT_BINDING_NONE:
+        return &compact_none_binding;
+    default:
+        return &compact_empty_binding;
+    }
+}
+
+#else
+
+static const struct zmk_behavior_binding zmk_keymap[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN] = {
+    COND_CODE_1(IS_ENABLED(CONFIG_ZMK_STUDIO),
+                (DT_INST_FOREACH_CHILD_SEP(0, TRANSFORMED_LAYER, (, ))),
+                (DT_INST_FOREACH_CHILD_STATUS_OKAY_SEP(0, TRANSFORMED_LAYER, (, ))))};
+
+static const struct zmk_behavior_binding *stock_binding(uint8_t layer, uint8_t position) {
+    return &zmk_keymap[layer][position];
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT)
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
 static char zmk_keymap_layer_names[ZMK_KEYMAP_LAYERS_LEN][CONFIG_ZMK_KEYMAP_LAYER_NAME_MAX_LEN] = {
     DT_INST_FOREACH_CHILD_SEP(0, LAYER_NAME, (, ))};
 
-static uint32_t changed_layer_names = 0;
+#if CONFIG_ZMK_KEYMAP_BANKS > 1
+// Names a bank starts out with, before its own names are loaded.
+static const char *const zmk_keymap_stock_layer_names[ZMK_KEYMAP_LAYERS_LEN] = {
+    DT_INST_FOREACH_CHILD_SEP(0, LAYER_NAME, (, ))};
+#endif // CONFIG_ZMK_KEYMAP_BANKS > 1
+
+static zmk_keymap_layers_state_t changed_layer_names;
 
 #else
 
@@ -107,11 +286,159 @@ static const char *zmk_keymap_layer_names[ZMK_KEYMAP_LAYERS_LEN] = {
 
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
+#define PENDING_ARRAY_SIZE DIV_ROUND_UP(ZMK_KEYMAP_LEN, 8)
+
+struct keymap_overlay_entry {
+    struct zmk_behavior_binding binding;
+    uint8_t layer;
+    uint8_t position;
+};
+
+// Never more entries than the keymap has bindings. 0 makes room to change every one of them, so
+// bindings loaded from settings always fit.
+#if CONFIG_ZMK_KEYMAP_CHANGED_BINDINGS_MAX > 0
+#define KEYMAP_OVERLAY_MAX                                                                         \
+    MIN(CONFIG_ZMK_KEYMAP_CHANGED_BINDINGS_MAX, ZMK_KEYMAP_LAYERS_LEN * ZMK_KEYMAP_LEN)
+#else
+#define KEYMAP_OVERLAY_MAX (ZMK_KEYMAP_LAYERS_LEN * ZMK_KEYMAP_LEN)
+#endif
+
+static struct keymap_overlay_entry keymap_overlay[KEYMAP_OVERLAY_MAX];
+static uint16_t keymap_overlay_len;
+// Positions of each layer with an entry in the overlay, so unchanged positions, which are nearly
+// all of them, are looked up without searching it.
+static uint8_t keymap_overlay_positions[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
+
+static bool overlay_has(uint8_t layer, uint8_t position) {
+    return keymap_overlay_positions[layer][position / 8] & BIT(position % 8);
+}
+
+static struct keymap_overlay_entry *overlay_find(uint8_t layer, uint8_t position) {
+    if (!overlay_has(layer, position)) {
+        return NULL;
+    }
+
+    for (int i = 0; i < keymap_overlay_len; i++) {
+        if (keymap_overlay[i].layer == layer && keymap_overlay[i].position == position) {
+            return &keymap_overlay[i];
+        }
+    }
+
+    return NULL;
+}
+
+static const struct zmk_behavior_binding *layer_binding(uint8_t layer, uint8_t position) {
+    const struct keymap_overlay_entry *entry = overlay_find(layer, position);
+
+    return entry ? &entry->binding : stock_binding(layer, position);
+}
+
+// Bindings loaded from settings carry a local ID and a device name that may not be the same
+// pointer as the keymap's, so only the behavior and its parameters are compared.
+static bool same_binding(const struct zmk_behavior_binding *a,
+                         const struct zmk_behavior_binding *b) {
+    if (a->param1 != b->param1 || a->param2 != b->param2) {
+        return false;
+    }
+
+    if (a->behavior_dev == b->behavior_dev) {
+        return true;
+    }
+
+    return a->behavior_dev && b->behavior_dev && strcmp(a->behavior_dev, b->behavior_dev) == 0;
+}
+
+// Change a binding, dropping its overlay entry once it's back to the one in the keymap.
+static int overlay_set(uint8_t layer, uint8_t position,
+                       const struct zmk_behavior_binding *binding) {
+    struct keymap_overlay_entry *entry = overlay_find(layer, position);
+
+    if (same_binding(stock_binding(layer, position), binding)) {
+        if (entry) {
+            *entry = keymap_overlay[--keymap_overlay_len];
+            WRITE_BIT(keymap_overlay_positions[layer][position / 8], position % 8, 0);
+        }
+
+        return 0;
+    }
+
+    if (!entry) {
+        if (keymap_overlay_len == ARRAY_SIZE(keymap_overlay)) {
+            LOG_WRN("No room left to change the binding of layer %d at key position %d", layer,
+                    position);
+            return -ENOMEM;
+        }
+
+        entry = &keymap_overlay[keymap_overlay_len++];
+        entry->layer = layer;
+        entry->position = position;
+        WRITE_BIT(keymap_overlay_positions[layer][position / 8], position % 8, 1);
+    }
+
+    entry->binding = *binding;
+    return 0;
+}
+
+static void overlay_clear(void) {
+    keymap_overlay_len = 0;
+    memset(keymap_overlay_positions, 0, sizeof(keymap_overlay_positions));
+}
+
+#else
+
+static const struct zmk_behavior_binding *layer_binding(uint8_t layer, uint8_t position) {
+    return stock_binding(layer, position);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
+
 #if ZMK_KEYMAP_HAS_SENSORS
 
-static struct zmk_behavior_binding
-    zmk_sensor_keymap[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_SENSORS_LEN] = {
-        DT_INST_FOREACH_CHILD_SEP(0, SENSOR_LAYER, (, ))};
+// Only the layers that have sensor bindings get entries, most layers of deep keymaps have none.
+struct sensor_keymap_entry {
+    struct zmk_behavior_binding binding;
+    zmk_keymap_layer_id_t layer_id;
+    uint8_t sensor_index;
+};
+
+static struct sensor_keymap_entry zmk_sensor_keymap[] = {DT_INST_FOREACH_CHILD(0, SENSOR_LAYER)};
+
+// The layers with a binding for each sensor whose behavior was found when the keymap was loaded.
+static zmk_keymap_layers_state_t sensor_layers[ZMK_KEYMAP_SENSORS_LEN];
+
+static void resolve_sensor_keymap(void) {
+    for (int i = 0; i < ARRAY_SIZE(zmk_sensor_keymap); i++) {
+        struct sensor_keymap_entry *entry = &zmk_sensor_keymap[i];
+
+        if (entry->sensor_index >= ZMK_KEYMAP_SENSORS_LEN) {
+            LOG_WRN("Layer %d has a binding for missing sensor %d", entry->layer_id,
+                    entry->sensor_index);
+            continue;
+        }
+
+        if (!zmk_behavior_get_binding(entry->binding.behavior_dev)) {
+            LOG_WRN("No behavior %s for sensor %d on layer %d", entry->binding.behavior_dev,
+                    entry->sensor_index, entry->layer_id);
+            continue;
+        }
+
+        zmk_keymap_layers_state_write(&sensor_layers[entry->sensor_index], entry->layer_id, true);
+    }
+}
+
+static struct sensor_keymap_entry *sensor_keymap_entry(zmk_keymap_layer_id_t layer_id,
+                                                       uint8_t sensor_index) {
+    for (int i = 0; i < ARRAY_SIZE(zmk_sensor_keymap); i++) {
+        if (zmk_sensor_keymap[i].layer_id == layer_id &&
+            zmk_sensor_keymap[i].sensor_index == sensor_index) {
+            return &zmk_sensor_keymap[i];
+        }
+    }
+
+    return NULL;
+}
 
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
@@ -142,6 +469,74 @@ uint8_t map_layer_id_to_index(zmk_keymap_layer_id_t layer_id) {
 
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
+// The index of the highest active layer, kept up to date as layer states and ordering change.
+static zmk_keymap_layer_index_t _zmk_keymap_highest_layer_idx;
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+
+// The layer state with one bit per layer index rather than per layer ID, so the highest active
+// index can be found with a single highest-set-bit search.
+static zmk_keymap_layers_state_t _zmk_keymap_layer_index_state;
+
+#define LAYER_INDEX_STATE (&_zmk_keymap_layer_index_state)
+
+static void rebuild_layer_index_state(void) {
+    zmk_keymap_layers_state_clear(&_zmk_keymap_layer_index_state);
+
+    for (int layer_idx = 0; layer_idx < ZMK_KEYMAP_LAYERS_LEN; layer_idx++) {
+        zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
+
+        if (layer_id != ZMK_KEYMAP_LAYER_ID_INVAL &&
+            zmk_keymap_layers_state_test(&_zmk_keymap_layer_state, layer_id)) {
+            zmk_keymap_layers_state_write(&_zmk_keymap_layer_index_state, layer_idx, true);
+        }
+    }
+}
+
+#else
+
+// Without reordering, layer IDs and indexes are the same
+#define LAYER_INDEX_STATE (&_zmk_keymap_layer_state)
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+
+static void update_highest_layer_active(void) {
+    // The default layer is always active, and layers ordered below it are never used
+    zmk_keymap_layer_index_t default_idx = LAYER_ID_TO_INDEX(_zmk_keymap_layer_default);
+    zmk_keymap_layer_index_t highest = zmk_keymap_layers_state_highest(LAYER_INDEX_STATE);
+
+    if (highest == ZMK_KEYMAP_LAYER_ID_INVAL || highest < default_idx) {
+        highest = default_idx;
+    }
+
+    if (highest == _zmk_keymap_highest_layer_idx) {
+        return;
+    }
+
+    LOG_DBG("highest_layer_changed: index %d", highest);
+    _zmk_keymap_highest_layer_idx = highest;
+
+    int ret = raise_highest_layer_changed(highest);
+    if (ret < 0) {
+        LOG_WRN("Failed to raise highest layer changed (%d)", ret);
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+
+static void layer_order_changed(void) {
+    rebuild_layer_index_state();
+    update_highest_layer_active();
+    invalidate_position_cache();
+    invalidate_opaque_layers();
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+
+// Nesting depth of layer state transactions, and the state when the outermost one began
+static uint8_t layer_state_transaction_depth;
+static zmk_keymap_layers_state_t layer_state_transaction_start;
+
 static inline int set_layer_state(zmk_keymap_layer_id_t layer_id, bool state) {
     int ret = 0;
     if (layer_id >= ZMK_KEYMAP_LAYERS_LEN) {
@@ -153,11 +548,24 @@ static inline int set_layer_state(zmk_keymap_layer_id_t layer_id, bool state) {
         return 0;
     }
 
-    zmk_keymap_layers_state_t old_state = _zmk_keymap_layer_state;
-    WRITE_BIT(_zmk_keymap_layer_state, layer_id, state);
     // Don't send state changes unless there was an actual change
-    if (old_state != _zmk_keymap_layer_state) {
+    if (zmk_keymap_layers_state_test(&_zmk_keymap_layer_state, layer_id) != state) {
+        zmk_keymap_layers_state_write(&_zmk_keymap_layer_state, layer_id, state);
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+        zmk_keymap_layer_index_t layer_idx = LAYER_ID_TO_INDEX(layer_id);
+        if (layer_idx != ZMK_KEYMAP_LAYER_ID_INVAL) {
+            zmk_keymap_layers_state_write(&_zmk_keymap_layer_index_state, layer_idx, state);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
         LOG_DBG("layer_changed: layer %d state %d", layer_id, state);
+        invalidate_position_cache();
+
+        // Events for changes in a transaction are raised once, when it's committed
+        if (layer_state_transaction_depth > 0) {
+            return 0;
+        }
+
+        update_highest_layer_active();
         ret = raise_layer_state_changed(layer_id, state);
         if (ret < 0) {
             LOG_WRN("Failed to raise layer state changed (%d)", ret);
@@ -181,7 +589,8 @@ bool zmk_keymap_layer_active_with_state(zmk_keymap_layer_id_t layer,
                                         zmk_keymap_layers_state_t state_to_test) {
     // The default layer is assumed to be ALWAYS ACTIVE so we include an || here to ensure nobody
     // breaks up that assumption by accident
-    return (state_to_test & (BIT(layer))) == (BIT(layer)) || layer == _zmk_keymap_layer_default;
+    return zmk_keymap_layers_state_test(&state_to_test, layer) ||
+           layer == _zmk_keymap_layer_default;
 };
 
 bool zmk_keymap_layer_active(zmk_keymap_layer_id_t layer) {
@@ -189,19 +598,7 @@ bool zmk_keymap_layer_active(zmk_keymap_layer_id_t layer) {
 };
 
 zmk_keymap_layer_index_t zmk_keymap_highest_layer_active(void) {
-    for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
-         layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default); layer_idx--) {
-        zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
-
-        if (layer_id == ZMK_KEYMAP_LAYER_ID_INVAL) {
-            continue;
-        }
-        if (zmk_keymap_layer_active(layer_id)) {
-            return LAYER_ID_TO_INDEX(layer_id);
-        }
-    }
-
-    return LAYER_ID_TO_INDEX(zmk_keymap_layer_default());
+    return _zmk_keymap_highest_layer_idx;
 }
 
 int zmk_keymap_layer_activate(zmk_keymap_layer_id_t layer) { return set_layer_state(layer, true); };
@@ -219,15 +616,73 @@ int zmk_keymap_layer_toggle(zmk_keymap_layer_id_t layer) {
 };
 
 int zmk_keymap_layer_to(zmk_keymap_layer_id_t layer) {
+    zmk_keymap_layer_state_begin();
+
     for (int i = ZMK_KEYMAP_LAYERS_LEN - 1; i >= 0; i--) {
         zmk_keymap_layer_deactivate(i);
     }
 
     zmk_keymap_layer_activate(layer);
 
+    zmk_keymap_layer_state_commit();
+
     return 0;
 }
 
+void zmk_keymap_layer_state_begin(void) {
+    __ASSERT(layer_state_transaction_depth < UINT8_MAX, "Too many nested layer transactions");
+
+    if (layer_state_transaction_depth++ == 0) {
+        layer_state_transaction_start = _zmk_keymap_layer_state;
+    }
+}
+
+int zmk_keymap_layer_state_commit(void) {
+    if (layer_state_transaction_depth == 0) {
+        return -EINVAL;
+    }
+
+    if (--layer_state_transaction_depth > 0) {
+        return 0;
+    }
+
+    zmk_keymap_layers_state_t changed;
+    zmk_keymap_layers_state_diff(&changed, &layer_state_transaction_start,
+                                 &_zmk_keymap_layer_state);
+
+    if (zmk_keymap_layers_state_highest(&changed) == ZMK_KEYMAP_LAYER_ID_INVAL) {
+        // Any changes made cancelled each other out
+        return 0;
+    }
+
+    update_highest_layer_active();
+
+    // One event per changed layer, deactivations from the highest layer down first, then
+    // activations, the same order zmk_keymap_layer_to() raised them in before transactions.
+    int ret = 0;
+
+    for (int pass = 0; pass < 2; pass++) {
+        const bool state = pass == 1;
+
+        for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+            zmk_keymap_layer_id_t layer_id = state ? i : ZMK_KEYMAP_LAYERS_LEN - 1 - i;
+
+            if (!zmk_keymap_layers_state_test(&changed, layer_id) ||
+                zmk_keymap_layers_state_test(&_zmk_keymap_layer_state, layer_id) != state) {
+                continue;
+            }
+
+            int err = raise_layer_state_changed(layer_id, state);
+            if (err < 0) {
+                LOG_WRN("Failed to raise layer state changed (%d)", err);
+                ret = ret < 0 ? ret : err;
+            }
+        }
+    }
+
+    return ret;
+}
+
 const char *zmk_keymap_layer_name(zmk_keymap_layer_id_t layer_id) {
     ASSERT_LAYER_VAL(layer_id, NULL)
 
@@ -261,14 +716,32 @@ zmk_keymap_get_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t bind
         return NULL;
     }
 
-    return &zmk_keymap[layer_id][mapped_idx];
+    return layer_binding(layer_id, mapped_idx);
 }
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
-#define PENDING_ARRAY_SIZE DIV_ROUND_UP(ZMK_KEYMAP_LEN, 8)
-
 static uint8_t zmk_keymap_layer_pending_changes[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
+// Number of bits set in zmk_keymap_layer_pending_changes, and the layers that have any.
+static uint32_t pending_change_count;
+static zmk_keymap_layers_state_t pending_change_layers;
+
+static void mark_pending_change(zmk_keymap_layer_id_t layer_id, uint32_t position) {
+    uint8_t *pending = zmk_keymap_layer_pending_changes[layer_id];
+
+    if (!(pending[position / 8] & BIT(position % 8))) {
+        WRITE_BIT(pending[position / 8], position % 8, 1);
+        pending_change_count++;
+        zmk_keymap_layers_state_write(&pending_change_layers, layer_id, true);
+    }
+}
+
+static void invalidate_binding_caches(void) {
+    invalidate_position_cache();
+    invalidate_gaming_routes();
+    invalidate_binding_kinds();
+    invalidate_opaque_layers();
+}
 
 int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx,
                                         struct zmk_behavior_binding binding) {
@@ -297,22 +770,97 @@ int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t
         return -EINVAL;
     }
 
-    if (memcmp(&zmk_keymap[layer_id][storage_binding_idx], &binding, sizeof(binding)) == 0) {
+    if (same_binding(layer_binding(layer_id, storage_binding_idx), &binding)) {
         LOG_DBG("Not setting, no change to layer %d at index %d (%d)", layer_id, binding_idx,
                 storage_binding_idx);
         return 0;
     }
 
-    uint8_t *pending = zmk_keymap_layer_pending_changes[layer_id];
-
-    WRITE_BIT(pending[storage_binding_idx / 8], storage_binding_idx % 8, 1);
-
     // TODO: Need a mutex to protect access to the keymap data?
-    memcpy(&zmk_keymap[layer_id][storage_binding_idx], &binding, sizeof(binding));
+    ret = overlay_set(layer_id, storage_binding_idx, &binding);
+    if (ret < 0) {
+        return ret;
+    }
+
+    mark_pending_change(layer_id, storage_binding_idx);
+    invalidate_binding_caches();
 
     return 0;
 }
 
+int zmk_keymap_set_layer_bindings_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t start_idx,
+                                         const struct zmk_behavior_binding *bindings,
+                                         size_t count) {
+    if (start_idx + count > ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    ASSERT_LAYER_VAL(layer_id, -EINVAL)
+
+    const uint32_t *pos_map;
+    int ret = zmk_physical_layouts_get_selected_to_stock_position_map(&pos_map);
+    if (ret < 0) {
+        LOG_WRN("Failed to get the mapping to determine where to set the bindings (%d)", ret);
+        return ret;
+    }
+
+    if (start_idx + count > ret) {
+        LOG_WRN("Unable to set bindings up to index %d which isn't mapped", start_idx + count - 1);
+        return -EINVAL;
+    }
+
+    // Check everything before changing anything, so the bindings are either all set or none are.
+    int overlay_len = keymap_overlay_len;
+
+    for (int i = 0; i < count; i++) {
+        uint32_t pos = pos_map[start_idx + i];
+
+        if (pos >= ZMK_KEYMAP_LEN) {
+            LOG_WRN("Can't set layer binding at unmapped/invalid index %d", start_idx + i);
+            return -EINVAL;
+        }
+
+        bool is_stock = same_binding(stock_binding(layer_id, pos), &bindings[i]);
+
+        if (is_stock && overlay_has(layer_id, pos)) {
+            overlay_len--;
+        } else if (!is_stock && !overlay_has(layer_id, pos)) {
+            overlay_len++;
+        }
+    }
+
+    if (overlay_len > ARRAY_SIZE(keymap_overlay)) {
+        LOG_WRN("No room left to change %d bindings of layer %d", count, layer_id);
+        return -ENOMEM;
+    }
+
+    int changed = 0;
+
+    // Bindings going back to the keymap free their overlay entries first, so the new entries
+    // always fit.
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < count; i++) {
+            uint32_t pos = pos_map[start_idx + i];
+            bool is_stock = same_binding(stock_binding(layer_id, pos), &bindings[i]);
+
+            if (is_stock != (pass == 0) ||
+                same_binding(layer_binding(layer_id, pos), &bindings[i])) {
+                continue;
+            }
+
+            overlay_set(layer_id, pos, &bindings[i]);
+            mark_pending_change(layer_id, pos);
+            changed++;
+        }
+    }
+
+    if (changed > 0) {
+        invalidate_binding_caches();
+    }
+
+    return changed;
+}
+
 #else
 
 int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t binding_idx,
@@ -320,6 +868,12 @@ int zmk_keymap_set_layer_binding_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t
     return -ENOTSUP;
 }
 
+int zmk_keymap_set_layer_bindings_at_idx(zmk_keymap_layer_id_t layer_id, uint8_t start_idx,
+                                         const struct zmk_behavior_binding *bindings,
+                                         size_t count) {
+    return -ENOTSUP;
+}
+
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
@@ -353,24 +907,28 @@ int zmk_keymap_move_layer(zmk_keymap_layer_index_t start_idx, zmk_keymap_layer_i
         keymap_layer_orders[dest_idx] = val;
     }
 
+    layer_order_changed();
+
     return 0;
 }
 
 int zmk_keymap_add_layer(void) {
-    uint32_t seen_layer_ids = 0;
+    zmk_keymap_layers_state_t seen_layer_ids;
+    zmk_keymap_layers_state_clear(&seen_layer_ids);
     LOG_HEXDUMP_DBG(keymap_layer_orders, ZMK_KEYMAP_LAYERS_LEN, "Order");
 
     for (int index = 0; index < ZMK_KEYMAP_LAYERS_LEN; index++) {
         zmk_keymap_layer_id_t id = LAYER_INDEX_TO_ID(index);
 
         if (id != ZMK_KEYMAP_LAYER_ID_INVAL) {
-            WRITE_BIT(seen_layer_ids, id, 1);
+            zmk_keymap_layers_state_write(&seen_layer_ids, id, true);
             continue;
         }
 
         for (int candidate_id = 0; candidate_id < ZMK_KEYMAP_LAYERS_LEN; candidate_id++) {
-            if (!(seen_layer_ids & BIT(candidate_id))) {
+            if (!zmk_keymap_layers_state_test(&seen_layer_ids, candidate_id)) {
                 keymap_layer_orders[index] = candidate_id;
+                layer_order_changed();
                 return index;
             }
         }
@@ -395,6 +953,7 @@ int zmk_keymap_remove_layer(zmk_keymap_layer_index_t index) {
     }
 
     keymap_layer_orders[ZMK_KEYMAP_LAYERS_LEN - 1] = ZMK_KEYMAP_LAYER_ID_INVAL;
+    layer_order_changed();
 
     LOG_HEXDUMP_DBG(keymap_layer_orders, ZMK_KEYMAP_LAYERS_LEN, "Order");
 
@@ -410,6 +969,7 @@ int zmk_keymap_restore_layer(zmk_keymap_layer_id_t id, zmk_keymap_layer_index_t
     }
 
     keymap_layer_orders[at_index] = id;
+    layer_order_changed();
 
     return 0;
 }
@@ -428,7 +988,7 @@ int zmk_keymap_set_layer_name(zmk_keymap_layer_id_t id, const char *name, size_t
         zmk_keymap_layer_names[id][size] = 0;
     }
 
-    WRITE_BIT(changed_layer_names, id, 1);
+    zmk_keymap_layers_state_write(&changed_layer_names, id, true);
 
     return 0;
 }
@@ -455,8 +1015,6 @@ int zmk_keymap_set_layer_name(zmk_keymap_layer_id_t id, const char *name, size_t
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
-#define PENDING_ARRAY_SIZE DIV_ROUND_UP(ZMK_KEYMAP_LEN, 8)
-
 static uint8_t zmk_keymap_layer_pending_changes[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
 
 struct zmk_behavior_binding_setting {
@@ -465,78 +1023,192 @@ struct zmk_behavior_binding_setting {
     uint32_t param2;
 } __packed;
 
+// The bindings of a layer that were changed from the stock keymap are saved together as one
+// setting, instead of one setting per binding. Only changed positions are stored, so changes to
+// the stock keymap still apply to the others.
+#define LAYER_BINDINGS_SETTING_VERSION 1
+
+struct zmk_keymap_layer_binding_setting {
+    uint8_t position;
+    struct zmk_behavior_binding_setting binding;
+} __packed;
+
+struct zmk_keymap_layer_bindings_setting {
+    uint8_t version;
+    uint8_t count;
+    // CRC-32 of the bindings that follow.
+    uint32_t crc;
+    struct zmk_keymap_layer_binding_setting bindings[ZMK_KEYMAP_LEN];
+} __packed;
+
+#define LAYER_BINDINGS_SETTING_HEADER_LEN                                                          \
+    offsetof(struct zmk_keymap_layer_bindings_setting, bindings)
+
+// Shared by saving and loading, which both happen from the settings/work queue context.
+static struct zmk_keymap_layer_bindings_setting layer_bindings_setting;
+
+// Positions of each layer that are stored in settings.
+static uint8_t zmk_keymap_layer_stored[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
+// Positions of each layer that are still stored in the old format of one setting per binding.
+static uint8_t zmk_keymap_layer_legacy[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
+static zmk_keymap_layers_state_t loaded_layer_bindings;
+
+static void clear_pending_changes(void) {
+    memset(zmk_keymap_layer_pending_changes, 0, sizeof(zmk_keymap_layer_pending_changes));
+    pending_change_count = 0;
+    zmk_keymap_layers_state_clear(&pending_change_layers);
+}
+
 int zmk_keymap_check_unsaved_changes(void) {
-    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        uint8_t *pending = zmk_keymap_layer_pending_changes[l];
-        for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
-            if (pending[kp / 8] & BIT(kp % 8)) {
-                return 1;
-            }
-        }
+    if (pending_change_count > 0) {
+        return 1;
+    }
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
-        if (settings_layer_orders[l] != keymap_layer_orders[l]) {
-            return 1;
-        }
-#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    if (memcmp(settings_layer_orders, keymap_layer_orders, sizeof(keymap_layer_orders)) != 0) {
+        return 1;
     }
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 
     return 0;
 }
 
-#define LAYER_ORDER_SETTINGS_KEY "keymap/layer_order"
-#define LAYER_NAME_SETTINGS_KEY "keymap/l_n/%d"
+// The settings of banks other than the first are kept under a "b<bank>/" prefix, the first bank
+// keeps the names used before there were banks. Bindings stored one setting per binding predate
+// banks, so they only exist for the first one.
+#define BANK_SETTINGS_KEY "keymap/bank"
+#define LAYER_ORDER_SETTINGS_KEY "keymap/%slayer_order"
+#define LAYER_NAME_SETTINGS_KEY "keymap/%sl_n/%d"
 #define LAYER_BINDING_SETTINGS_KEY "keymap/l/%d/%d"
+#define LAYER_BINDINGS_SETTINGS_KEY "keymap/%slb/%d"
 
-static int save_bindings(void) {
-    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        uint8_t *pending = zmk_keymap_layer_pending_changes[l];
+BUILD_ASSERT(CONFIG_ZMK_KEYMAP_BANKS <= 8, "At most 8 keymap banks are supported");
 
-        for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
-            if (pending[kp / 8] & BIT(kp % 8)) {
+static uint8_t active_bank;
 
-                const struct zmk_behavior_binding *binding = &zmk_keymap[l][kp];
-                LOG_DBG("Pending save for layer %d at key position %d: %s with %d, %d", l, kp,
-                        binding->behavior_dev, binding->param1, binding->param2);
+static const char *bank_prefix(void) {
+    static const char *const prefixes[] = {"", "b1/", "b2/", "b3/", "b4/", "b5/", "b6/", "b7/"};
 
-                struct zmk_behavior_binding_setting binding_setting = {
-                    .behavior_local_id = zmk_behavior_get_local_id(binding->behavior_dev),
-                    .param1 = binding->param1,
-                    .param2 = binding->param2,
-                };
+    return prefixes[active_bank];
+}
 
-                // We can skip any trailing zero params, regardless of the behavior
-                // and if those params are meaningful.
-                size_t len = sizeof(binding_setting);
-                if (binding_setting.param2 == 0) {
-                    len -= 4;
+static bool layer_has_bits(const uint8_t *bits) {
+    for (int i = 0; i < PENDING_ARRAY_SIZE; i++) {
+        if (bits[i]) {
+            return true;
+        }
+    }
 
-                    if (binding_setting.param1 == 0) {
-                        len -= 4;
-                    }
-                }
+    return false;
+}
 
-                char setting_name[20];
-                sprintf(setting_name, LAYER_BINDING_SETTINGS_KEY, l, kp);
+static void delete_legacy_bindings(int l) {
+    uint8_t *legacy = zmk_keymap_layer_legacy[l];
+
+    for (int kp = 0; kp < ZMK_KEYMAP_LEN; kp++) {
+        if (legacy[kp / 8] & BIT(kp % 8)) {
+            char setting_name[20];
+            sprintf(setting_name, LAYER_BINDING_SETTINGS_KEY, l, kp);
+            settings_delete(setting_name);
+        }
+    }
 
-                int ret = settings_save_one(setting_name, &binding_setting, len);
-                if (ret < 0) {
-                    LOG_ERR("Failed to save keymap binding at %d on layer %d (%d)", l, kp, ret);
-                    return ret;
-                }
+    memset(legacy, 0, PENDING_ARRAY_SIZE);
+}
 
-                WRITE_BIT(pending[kp / 8], kp % 8, 0);
-            }
+static int save_layer_bindings(int l) {
+    uint8_t *pending = zmk_keymap_layer_pending_changes[l];
+    uint8_t *stored = zmk_keymap_layer_stored[l];
+    struct zmk_keymap_layer_bindings_setting *setting = &layer_bindings_setting;
+    uint8_t count = 0;
+
+    for (int i = 0; i < PENDING_ARRAY_SIZE; i++) {
+        for (uint8_t bits = stored[i] | pending[i]; bits; bits &= bits - 1) {
+            const int kp = i * 8 + __builtin_ctz(bits);
+            const struct zmk_behavior_binding *binding = layer_binding(l, kp);
+            LOG_DBG("Saving layer %d at key position %d: %s with %d, %d", l, kp,
+                    binding->behavior_dev, binding->param1, binding->param2);
+
+            setting->bindings[count++] = (struct zmk_keymap_layer_binding_setting){
+                .position = kp,
+                .binding =
+                    {
+                        .behavior_local_id = zmk_behavior_get_local_id(binding->behavior_dev),
+                        .param1 = binding->param1,
+                        .param2 = binding->param2,
+                    },
+            };
+        }
+    }
+
+    setting->version = LAYER_BINDINGS_SETTING_VERSION;
+    setting->count = count;
+
+    const size_t bindings_len = count * sizeof(setting->bindings[0]);
+    setting->crc = crc32_ieee((const uint8_t *)setting->bindings, bindings_len);
+
+    char setting_name[20];
+    sprintf(setting_name, LAYER_BINDINGS_SETTINGS_KEY, bank_prefix(), l);
+
+    int ret = settings_save_one(setting_name, setting,
+                                LAYER_BINDINGS_SETTING_HEADER_LEN + bindings_len);
+    if (ret < 0) {
+        LOG_ERR("Failed to save keymap bindings of layer %d (%d)", l, ret);
+        return ret;
+    }
+
+    for (int i = 0; i < PENDING_ARRAY_SIZE; i++) {
+        pending_change_count -= __builtin_popcount(pending[i]);
+        stored[i] |= pending[i];
+        pending[i] = 0;
+    }
+    zmk_keymap_layers_state_write(&pending_change_layers, l, false);
+
+    // Only drop the old settings once the layer setting that replaces them is written.
+    delete_legacy_bindings(l);
+
+    return 0;
+}
+
+static int save_bindings(void) {
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN && pending_change_count > 0; l++) {
+        if (!zmk_keymap_layers_state_test(&pending_change_layers, l)) {
+            continue;
+        }
+
+        int ret = save_layer_bindings(l);
+        if (ret < 0) {
+            return ret;
         }
     }
 
     return 0;
 }
 
+static void migrate_legacy_bindings_cb(struct k_work *work) {
+    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        if (!layer_has_bits(zmk_keymap_layer_legacy[l])) {
+            continue;
+        }
+
+        LOG_INF("Migrating keymap bindings of layer %d to a single setting", l);
+
+        for (int i = 0; i < PENDING_ARRAY_SIZE; i++) {
+            zmk_keymap_layer_stored[l][i] |= zmk_keymap_layer_legacy[l][i];
+        }
+
+        save_layer_bindings(l);
+    }
+}
+
+static K_WORK_DEFINE(migrate_legacy_bindings_work, migrate_legacy_bindings_cb);
+
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
 static int save_layer_orders(void) {
-    int ret = settings_save_one(LAYER_ORDER_SETTINGS_KEY, keymap_layer_orders,
-                                ARRAY_SIZE(keymap_layer_orders));
+    char setting_name[24];
+    sprintf(setting_name, LAYER_ORDER_SETTINGS_KEY, bank_prefix());
+
+    int ret = settings_save_one(setting_name, keymap_layer_orders, ARRAY_SIZE(keymap_layer_orders));
     if (ret < 0) {
         return ret;
     }
@@ -548,9 +1220,9 @@ static int save_layer_orders(void) {
 
 static int save_layer_names(void) {
     for (int id = 0; id < ZMK_KEYMAP_LAYERS_LEN; id++) {
-        if (changed_layer_names & BIT(id)) {
-            char setting_name[14];
-            sprintf(setting_name, LAYER_NAME_SETTINGS_KEY, id);
+        if (zmk_keymap_layers_state_test(&changed_layer_names, id)) {
+            char setting_name[20];
+            sprintf(setting_name, LAYER_NAME_SETTINGS_KEY, bank_prefix(), id);
             int ret = settings_save_one(setting_name, zmk_keymap_layer_names[id],
                                         strlen(zmk_keymap_layer_names[id]));
             if (ret < 0) {
@@ -559,7 +1231,7 @@ static int save_layer_names(void) {
         }
     }
 
-    changed_layer_names = 0;
+    zmk_keymap_layers_state_clear(&changed_layer_names);
     return 0;
 }
 
@@ -593,33 +1265,72 @@ static void load_stock_keymap_layer_ordering() {
         keymap_layer_orders[i] = ZMK_KEYMAP_LAYER_ID_INVAL;
         i++;
     }
+
+    layer_order_changed();
 }
 #endif
 
 static void reload_from_stock_keymap(void) {
-    for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
-            zmk_keymap[l][k] = zmk_stock_keymap[l][k];
-        }
-    }
+    overlay_clear();
+    invalidate_position_cache();
+    invalidate_gaming_routes();
+    invalidate_binding_kinds();
+    invalidate_opaque_layers();
 }
 
 int zmk_keymap_discard_changes(void) {
     load_stock_keymap_layer_ordering();
     reload_from_stock_keymap();
 
+    zmk_keymap_layers_state_clear(&loaded_layer_bindings);
+    memset(zmk_keymap_layer_stored, 0, sizeof(zmk_keymap_layer_stored));
+    memset(zmk_keymap_layer_legacy, 0, sizeof(zmk_keymap_layer_legacy));
+
     int ret = settings_load_subtree("keymap");
     if (ret >= 0) {
-        changed_layer_names = 0;
-
-        for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-            memset(zmk_keymap_layer_pending_changes[l], 0, PENDING_ARRAY_SIZE);
-        }
+        zmk_keymap_layers_state_clear(&changed_layer_names);
+        clear_pending_changes();
     }
 
     return ret;
 }
 
+// Replace the keymap with the one of the active bank, dropping any unsaved changes.
+static int load_bank(void) {
+#if CONFIG_ZMK_KEYMAP_BANKS > 1
+    for (int id = 0; id < ZMK_KEYMAP_LAYERS_LEN; id++) {
+        strncpy(zmk_keymap_layer_names[id], zmk_keymap_stock_layer_names[id],
+                CONFIG_ZMK_KEYMAP_LAYER_NAME_MAX_LEN - 1);
+        zmk_keymap_layer_names[id][CONFIG_ZMK_KEYMAP_LAYER_NAME_MAX_LEN - 1] = '\0';
+    }
+#endif // CONFIG_ZMK_KEYMAP_BANKS > 1
+
+    return zmk_keymap_discard_changes();
+}
+
+int zmk_keymap_select_bank(uint8_t bank) {
+    if (bank >= CONFIG_ZMK_KEYMAP_BANKS) {
+        return -EINVAL;
+    }
+
+    if (bank == active_bank) {
+        return 0;
+    }
+
+    int ret = settings_save_one(BANK_SETTINGS_KEY, &bank, sizeof(bank));
+    if (ret < 0) {
+        LOG_ERR("Failed to save the keymap bank (%d)", ret);
+        return ret;
+    }
+
+    LOG_INF("Switching to keymap bank %d", bank);
+    active_bank = bank;
+
+    return load_bank();
+}
+
+uint8_t zmk_keymap_active_bank(void) { return active_bank; }
+
 static int keymap_track_changed_bindings(const char *key, size_t len, settings_read_cb read_cb,
                                          void *cb_arg, void *param) {
     const char *next;
@@ -646,7 +1357,9 @@ static int keymap_track_changed_bindings(const char *key, size_t len, settings_r
 }
 
 int zmk_keymap_reset_settings(void) {
-    settings_delete(LAYER_ORDER_SETTINGS_KEY);
+    char layer_order_setting_name[24];
+    sprintf(layer_order_setting_name, LAYER_ORDER_SETTINGS_KEY, bank_prefix());
+    settings_delete(layer_order_setting_name);
 
     uint8_t zmk_keymap_layer_changes[ZMK_KEYMAP_LAYERS_LEN][PENDING_ARRAY_SIZE];
 
@@ -654,15 +1367,18 @@ int zmk_keymap_reset_settings(void) {
                                  &zmk_keymap_layer_changes);
 
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        char layer_name_setting_name[14];
-        sprintf(layer_name_setting_name, LAYER_NAME_SETTINGS_KEY, l);
+        char layer_name_setting_name[20];
+        sprintf(layer_name_setting_name, LAYER_NAME_SETTINGS_KEY, bank_prefix(), l);
         settings_delete(layer_name_setting_name);
 
+        char layer_bindings_setting_name[20];
+        sprintf(layer_bindings_setting_name, LAYER_BINDINGS_SETTINGS_KEY, bank_prefix(), l);
+        settings_delete(layer_bindings_setting_name);
+
         uint8_t *changes = zmk_keymap_layer_changes[l];
 
-        for (int k = 0; k < ZMK_KEYMAP_LEN; k++) {
-            if (memcmp(&zmk_keymap[l][k], &zmk_stock_keymap[l][k],
-                       sizeof(struct zmk_behavior_binding_setting)) == 0) {
+        for (int k = 0; k < ZMK_KEYMAP_LEN && active_bank == 0; k++) {
+            if (!overlay_has(l, k)) {
                 continue;
             }
 
@@ -675,6 +1391,10 @@ int zmk_keymap_reset_settings(void) {
         }
     }
 
+    memset(zmk_keymap_layer_stored, 0, sizeof(zmk_keymap_layer_stored));
+    memset(zmk_keymap_layer_legacy, 0, sizeof(zmk_keymap_layer_legacy));
+    zmk_keymap_layers_state_clear(&loaded_layer_bindings);
+
     load_stock_keymap_layer_ordering();
 
     reload_from_stock_keymap();
@@ -690,12 +1410,98 @@ int zmk_keymap_discard_changes(void) { return -ENOTSUP; }
 
 int zmk_keymap_reset_settings(void) { return -ENOTSUP; }
 
+int zmk_keymap_select_bank(uint8_t bank) { return -ENOTSUP; }
+
+uint8_t zmk_keymap_active_bank(void) { return 0; }
+
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
+// Used as `DT_FOREACH_STATUS_OKAY(compat, IS_BEHAVIOR_INST) false` to check a behavior device
+// against every instance of a compatible.
+#define IS_BEHAVIOR_INST(node_id) behavior == DEVICE_DT_GET(node_id) ||
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_FAST_DISPATCH)
+
+// Bindings whose behavior the keymap invokes itself. These behaviors run on the central, take
+// absolute parameters and keep no state, so skipping their driver changes nothing but the time.
+enum keymap_binding_kind {
+    KEYMAP_BINDING_GENERIC,
+    KEYMAP_BINDING_KEY_PRESS,
+    KEYMAP_BINDING_MOMENTARY_LAYER,
+    KEYMAP_BINDING_TRANSPARENT,
+};
+
+static uint8_t binding_kinds[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN];
+
+static enum keymap_binding_kind binding_kind_of(const struct zmk_behavior_binding *binding) {
+    const struct device *behavior = binding ? zmk_behavior_get_binding(binding->behavior_dev)
+                                            : NULL;
+
+    if (!behavior) {
+        return KEYMAP_BINDING_GENERIC;
+    }
+
+    if (DT_FOREACH_STATUS_OKAY(zmk_behavior_key_press, IS_BEHAVIOR_INST) false) {
+        return KEYMAP_BINDING_KEY_PRESS;
+    }
+
+    if (DT_FOREACH_STATUS_OKAY(zmk_behavior_momentary_layer, IS_BEHAVIOR_INST) false) {
+        return KEYMAP_BINDING_MOMENTARY_LAYER;
+    }
+
+    if (DT_FOREACH_STATUS_OKAY(zmk_behavior_transparent, IS_BEHAVIOR_INST) false) {
+        return KEYMAP_BINDING_TRANSPARENT;
+    }
+
+    return KEYMAP_BINDING_GENERIC;
+}
+
+static void rebuild_binding_kinds(void) {
+    for (zmk_keymap_layer_id_t l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        for (uint32_t p = 0; p < ZMK_KEYMAP_LEN; p++) {
+            binding_kinds[l][p] = binding_kind_of(zmk_keymap_get_layer_binding_at_idx(l, p));
+        }
+    }
+
+    binding_kinds_stale = false;
+}
+
+// Returns -ENOTSUP for bindings that have to go through their behavior driver
+static int invoke_binding_directly(const struct zmk_behavior_binding *binding,
+                                   zmk_keymap_layer_id_t layer_id, uint32_t position, bool pressed,
+                                   int64_t timestamp) {
+    // Bindings are only found for valid layers and positions
+    if (!binding) {
+        return -ENOTSUP;
+    }
+
+    if (binding_kinds_stale) {
+        rebuild_binding_kinds();
+    }
+
+    switch (binding_kinds[layer_id][position]) {
+    case KEYMAP_BINDING_KEY_PRESS:
+        return raise_zmk_keycode_state_changed_from_encoded(binding->param1, pressed, timestamp);
+    case KEYMAP_BINDING_MOMENTARY_LAYER:
+        return pressed ? zmk_keymap_layer_activate(binding->param1)
+                       : zmk_keymap_layer_deactivate(binding->param1);
+    case KEYMAP_BINDING_TRANSPARENT:
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    default:
+        return -ENOTSUP;
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_FAST_DISPATCH)
+
 int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_id,
                                     uint32_t position, bool pressed, int64_t timestamp) {
     const struct zmk_behavior_binding *binding =
         zmk_keymap_get_layer_binding_at_idx(layer_id, position);
+    if (!binding) {
+        return -EINVAL;
+    }
+
     struct zmk_behavior_binding_event event = {
         .layer = layer_id,
         .position = position,
@@ -708,92 +1514,221 @@ int zmk_keymap_apply_position_state(uint8_t source, zmk_keymap_layer_id_t layer_
     LOG_DBG("layer_id: %d position: %d, binding name: %s", layer_id, position,
             binding->behavior_dev);
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_FAST_DISPATCH)
+    int ret = invoke_binding_directly(binding, layer_id, position, pressed, timestamp);
+    if (ret != -ENOTSUP) {
+        return ret;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_FAST_DISPATCH)
+
     return zmk_behavior_invoke_binding(binding, event, pressed);
 }
 
+// Only explicitly transparent bindings fall through. A missing binding or one whose behavior
+// can't be found stops at its layer, so invoking it reports the error instead of silently
+// running a binding of a lower layer.
+static bool binding_falls_through(const struct zmk_behavior_binding *binding) {
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_behavior_transparent)
+    if (!binding) {
+        return false;
+    }
+
+    const struct device *behavior = zmk_behavior_get_binding(binding->behavior_dev);
+
+    return behavior != NULL && behavior == DEVICE_DT_GET(DT_INST(0, zmk_behavior_transparent));
+#else
+    return false;
+#endif
+}
+
+static void rebuild_opaque_layers(void) {
+    for (uint32_t p = 0; p < ZMK_KEYMAP_LEN; p++) {
+        zmk_keymap_layer_index_t opaque_idx = ZMK_KEYMAP_LAYER_ID_INVAL;
+
+        for (int layer_idx = 0; layer_idx < ZMK_KEYMAP_LAYERS_LEN; layer_idx++) {
+            zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
+
+            if (layer_id != ZMK_KEYMAP_LAYER_ID_INVAL &&
+                !binding_falls_through(zmk_keymap_get_layer_binding_at_idx(layer_id, p))) {
+                opaque_idx = layer_idx;
+            }
+
+            opaque_layer_idx[layer_idx][p] = opaque_idx;
+        }
+    }
+
+    opaque_layers_stale = false;
+}
+
+// The highest layer index at or below the given one whose binding doesn't fall through, or -1
+static int opaque_layer_idx_at_or_below(int layer_idx, uint32_t position) {
+    if (opaque_layers_stale) {
+        rebuild_opaque_layers();
+    }
+
+    zmk_keymap_layer_index_t idx = opaque_layer_idx[layer_idx][position];
+
+    return idx == ZMK_KEYMAP_LAYER_ID_INVAL ? -1 : idx;
+}
+
+static zmk_keymap_layer_index_t resolve_position_layer_idx(uint32_t position) {
+    const int default_idx = LAYER_ID_TO_INDEX(_zmk_keymap_layer_default);
+
+    // We use int here to be sure we don't loop layer_idx back to UINT8_MAX. Each step jumps over
+    // the layers whose binding falls through, so only opaque bindings have their layer checked.
+    for (int layer_idx = zmk_keymap_highest_layer_active(); layer_idx >= default_idx; layer_idx--) {
+        layer_idx = opaque_layer_idx_at_or_below(layer_idx, position);
+        if (layer_idx < default_idx) {
+            break;
+        }
+
+        if (zmk_keymap_layer_active(LAYER_INDEX_TO_ID(layer_idx))) {
+            return layer_idx;
+        }
+    }
+
+    return default_idx;
+}
+
+static zmk_keymap_layer_index_t cached_position_layer_idx(uint32_t position) {
+    struct keymap_position_cache_entry *entry = &keymap_position_cache[position];
+
+    if (entry->generation != keymap_position_cache_generation) {
+        entry->layer_idx = resolve_position_layer_idx(position);
+        entry->generation = keymap_position_cache_generation;
+    }
+
+    return entry->layer_idx;
+}
+
 int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pressed,
                                       int64_t timestamp) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    zmk_keymap_layer_index_t start_idx;
     if (pressed) {
-        zmk_keymap_active_behavior_layer[position] = _zmk_keymap_layer_state;
+        start_idx = cached_position_layer_idx(position);
+        zmk_keymap_active_behavior_layer_idx[position] = start_idx;
+    } else {
+        start_idx = zmk_keymap_active_behavior_layer_idx[position];
     }
 
-    // We use int here to be sure we don't loop layer_idx back to UINT8_MAX
-    for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
-         layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default); layer_idx--) {
+    // Layers above the start index are either inactive or only fall through, so skip them. Should
+    // a behavior still report being transparent at runtime, we continue to lower active layers.
+    for (int layer_idx = start_idx; layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default);
+         layer_idx--) {
+        // Below the start layer, jump straight to the next binding that doesn't fall through
+        if (layer_idx != start_idx) {
+            layer_idx = opaque_layer_idx_at_or_below(layer_idx, position);
+            if (layer_idx < LAYER_ID_TO_INDEX(_zmk_keymap_layer_default)) {
+                break;
+            }
+        }
+
         zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
 
         if (layer_id == ZMK_KEYMAP_LAYER_ID_INVAL) {
             continue;
         }
-        if (zmk_keymap_layer_active_with_state(layer_id,
-                                               zmk_keymap_active_behavior_layer[position])) {
-            int ret =
-                zmk_keymap_apply_position_state(source, layer_id, position, pressed, timestamp);
-            if (ret > 0) {
-                LOG_DBG("behavior processing to continue to next layer");
-                continue;
-            } else if (ret < 0) {
-                LOG_DBG("Behavior returned error: %d", ret);
-                return ret;
-            } else {
-                return ret;
-            }
+
+        // The start layer was active on press, so it's used for the release even if deactivated
+        if (layer_idx != start_idx && !zmk_keymap_layer_active(layer_id)) {
+            continue;
+        }
+
+        int ret = zmk_keymap_apply_position_state(source, layer_id, position, pressed, timestamp);
+        if (ret > 0) {
+            LOG_DBG("behavior processing to continue to next layer");
+            continue;
+        }
+
+        if (pressed) {
+            zmk_keymap_active_behavior_layer_idx[position] = layer_idx;
         }
+
+        if (ret < 0) {
+            LOG_DBG("Behavior returned error: %d", ret);
+        }
+
+        return ret;
     }
 
     return -ENOTSUP;
 }
 
 #if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
-int zmk_keymap_gaming_position_state_changed(uint8_t source, uint32_t position, bool pressed,
-                                           int64_t timestamp) {
-    // Handle gaming HID routing - ONLY gaming HID, no normal processing
-    // Use the same layer state logic as normal keymap to ensure press/release consistency
-    uint32_t layer_state_to_use;
-    if (pressed) {
-        zmk_keymap_active_behavior_layer[position] = _zmk_keymap_layer_state;
-        layer_state_to_use = _zmk_keymap_layer_state;
-    } else {
-        layer_state_to_use = zmk_keymap_active_behavior_layer[position];
-    }
 
-    // Process through normal keymap to get the key that would be sent
-    for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1;
-         layer_idx >= LAYER_ID_TO_INDEX(_zmk_keymap_layer_default); layer_idx--) {
-        zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
+// For each layer, the positions whose binding is a plain &kp on a layer routed to gaming HID, and
+// the keycode they send. Rebuilt once after the bindings change, so routing a key event is just a
+// bit test and a table lookup.
+static uint8_t gaming_routable[ZMK_KEYMAP_LAYERS_LEN][DIV_ROUND_UP(ZMK_KEYMAP_LEN, 8)];
+static uint32_t gaming_keycodes[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN];
 
-        if (layer_id == ZMK_KEYMAP_LAYER_ID_INVAL) {
+// Positions whose last press was sent through gaming HID, so their release goes the same way
+static uint8_t gaming_routed_positions[DIV_ROUND_UP(ZMK_KEYMAP_LEN, 8)];
+
+static bool is_gaming_routable_binding(const struct zmk_behavior_binding *binding) {
+    const struct device *behavior = binding ? zmk_behavior_get_binding(binding->behavior_dev)
+                                            : NULL;
+
+    return behavior && (DT_FOREACH_STATUS_OKAY(zmk_behavior_key_press, IS_BEHAVIOR_INST) false);
+}
+
+static void rebuild_gaming_routes(void) {
+    memset(gaming_routable, 0, sizeof(gaming_routable));
+
+    for (zmk_keymap_layer_id_t l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+        if (l >= 32 || !(CONFIG_ZMK_HID_GAMING_LAYERS & BIT(l))) {
             continue;
         }
-        if (zmk_keymap_layer_active_with_state(layer_id, layer_state_to_use)) {
+
+        for (uint32_t p = 0; p < ZMK_KEYMAP_LEN; p++) {
             const struct zmk_behavior_binding *binding =
-                zmk_keymap_get_layer_binding_at_idx(layer_id, position);
-            
-            // Check if this is a simple key press behavior (&kp) - route to gaming HID
-            // BUT only for basic layer 0 and gaming layer 1 to avoid interfering with symbol layers
-            if (binding->behavior_dev && 
-                (strstr(binding->behavior_dev, "key_press") != NULL) &&
-                (layer_id == 0 || layer_id == 1)) {
-                // This is a &kp behavior on base or gaming layer - route to gaming HID with position tracking
-                int ret;
-                if (pressed) {
-                    ret = zmk_hid_gaming_position_press(position, binding->param1);
-                } else {
-                    ret = zmk_hid_gaming_position_release(position);
-                }
-                
-                if (ret == 0) {
-                    // Successfully handled by gaming system - return success
-                    return 0;
-                }
+                zmk_keymap_get_layer_binding_at_idx(l, p);
+
+            if (is_gaming_routable_binding(binding)) {
+                WRITE_BIT(gaming_routable[l][p / 8], p % 8, 1);
+                gaming_keycodes[l][p] = binding->param1;
             }
-            
-            // If gaming HID failed, fall back to normal processing
-            return zmk_keymap_position_state_changed(source, position, pressed, timestamp);
         }
     }
 
-    // If no layer matched, fall back to normal processing
+    gaming_routes_stale = false;
+}
+
+int zmk_keymap_gaming_position_state_changed(uint8_t source, uint32_t position, bool pressed,
+                                           int64_t timestamp) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    uint8_t *routed = &gaming_routed_positions[position / 8];
+
+    if (pressed) {
+        if (gaming_routes_stale) {
+            rebuild_gaming_routes();
+        }
+
+        zmk_keymap_layer_id_t layer_id = LAYER_INDEX_TO_ID(zmk_keymap_highest_layer_active());
+
+        if (layer_id != ZMK_KEYMAP_LAYER_ID_INVAL &&
+            (gaming_routable[layer_id][position / 8] & BIT(position % 8)) &&
+            zmk_hid_gaming_position_press(position, gaming_keycodes[layer_id][position]) == 0) {
+            *routed |= BIT(position % 8);
+            return 0;
+        }
+    } else if (*routed & BIT(position % 8)) {
+        // Release through gaming HID whenever the press went there, even if the layer changed
+        *routed &= ~BIT(position % 8);
+
+        if (zmk_hid_gaming_position_release(position) == 0) {
+            return 0;
+        }
+    }
+
+    // Everything gaming HID doesn't handle goes through normal processing
     return zmk_keymap_position_state_changed(source, position, pressed, timestamp);
 }
 #endif // CONFIG_ZMK_HID_GAMING
@@ -804,24 +1739,24 @@ int zmk_keymap_sensor_event(uint8_t sensor_index,
                             size_t channel_data_size, int64_t timestamp) {
     bool opaque_response = false;
 
+    if (sensor_index >= ZMK_KEYMAP_SENSORS_LEN) {
+        return -EINVAL;
+    }
+
     for (int layer_idx = ZMK_KEYMAP_LAYERS_LEN - 1; layer_idx >= 0; layer_idx--) {
         uint8_t layer_id = LAYER_INDEX_TO_ID(layer_idx);
 
-        if (layer_id >= ZMK_KEYMAP_LAYERS_LEN) {
+        if (layer_id >= ZMK_KEYMAP_LAYERS_LEN ||
+            !zmk_keymap_layers_state_test(&sensor_layers[sensor_index], layer_id)) {
             continue;
         }
 
-        struct zmk_behavior_binding *binding = &zmk_sensor_keymap[layer_id][sensor_index];
+        struct zmk_behavior_binding *binding =
+            &sensor_keymap_entry(layer_id, sensor_index)->binding;
 
         LOG_DBG("layer idx: %d, layer id: %d sensor_index: %d, binding name: %s", layer_idx,
                 layer_id, sensor_index, binding->behavior_dev);
 
-        const struct device *behavior = zmk_behavior_get_binding(binding->behavior_dev);
-        if (!behavior) {
-            LOG_DBG("No behavior assigned to %d on layer %d", sensor_index, layer_id);
-            continue;
-        }
-
         struct zmk_behavior_binding_event event = {
             .layer = layer_id,
             .position = ZMK_VIRTUAL_KEY_POSITION_SENSOR(sensor_index),
@@ -862,6 +1797,15 @@ int zmk_keymap_sensor_event(uint8_t sensor_index,
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
 int keymap_listener(const zmk_event_t *eh) {
+    if (as_zmk_physical_layout_selection_changed(eh)) {
+        // The binding each position maps to depends on the selected layout
+        invalidate_position_cache();
+        invalidate_gaming_routes();
+        invalidate_binding_kinds();
+        invalidate_opaque_layers();
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
     const struct zmk_position_state_changed *pos_ev;
     if ((pos_ev = as_zmk_position_state_changed(eh)) != NULL) {
 #if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
@@ -887,6 +1831,7 @@ int keymap_listener(const zmk_event_t *eh) {
 
 ZMK_LISTENER(keymap, keymap_listener);
 ZMK_SUBSCRIPTION(keymap, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(keymap, zmk_physical_layout_selection_changed);
 
 #if ZMK_KEYMAP_HAS_SENSORS
 ZMK_SUBSCRIPTION(keymap, zmk_sensor_event);
@@ -894,11 +1839,139 @@ ZMK_SUBSCRIPTION(keymap, zmk_sensor_event);
 
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
+static struct zmk_behavior_binding
+binding_from_setting(const struct zmk_behavior_binding_setting *binding_setting) {
+    const char *name =
+        zmk_behavior_find_behavior_name_from_local_id(binding_setting->behavior_local_id);
+
+    if (!name) {
+        LOG_WRN("Loaded device %d from settings but no device found by that local ID",
+                binding_setting->behavior_local_id);
+    }
+
+    return (struct zmk_behavior_binding){
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        .local_id = binding_setting->behavior_local_id,
+#endif
+        .behavior_dev = name,
+        .param1 = binding_setting->param1,
+        .param2 = binding_setting->param2,
+    };
+}
+
+static int load_layer_bindings(uint8_t layer, size_t len, settings_read_cb read_cb,
+                               void *cb_arg) {
+    struct zmk_keymap_layer_bindings_setting *setting = &layer_bindings_setting;
+
+    if (len < LAYER_BINDINGS_SETTING_HEADER_LEN || len > sizeof(*setting)) {
+        LOG_ERR("Invalid layer bindings setting size %d for layer %d", len, layer);
+        return -EINVAL;
+    }
+
+    int err = read_cb(cb_arg, setting, len);
+    if (err <= 0) {
+        LOG_ERR("Failed to handle keymap layer bindings from settings (err %d)", err);
+        return err;
+    }
+
+    const size_t bindings_len = setting->count * sizeof(setting->bindings[0]);
+
+    if (setting->version != LAYER_BINDINGS_SETTING_VERSION) {
+        LOG_WRN("Unsupported layer bindings setting version %d for layer %d", setting->version,
+                layer);
+        return -EINVAL;
+    }
+
+    if (LAYER_BINDINGS_SETTING_HEADER_LEN + bindings_len != len ||
+        crc32_ieee((const uint8_t *)setting->bindings, bindings_len) != setting->crc) {
+        LOG_ERR("Corrupt layer bindings setting for layer %d", layer);
+        return -EINVAL;
+    }
+
+    zmk_keymap_layers_state_write(&loaded_layer_bindings, layer, true);
+
+    int dropped = 0;
+
+    for (int i = 0; i < setting->count; i++) {
+        const struct zmk_keymap_layer_binding_setting *binding = &setting->bindings[i];
+
+        if (binding->position >= ZMK_KEYMAP_LEN) {
+            LOG_WRN("Key position %d is larger than max of %d", binding->position,
+                    ZMK_KEYMAP_LEN);
+            continue;
+        }
+
+        const struct zmk_behavior_binding loaded = binding_from_setting(&binding->binding);
+
+        if (overlay_set(layer, binding->position, &loaded) < 0) {
+            dropped++;
+            continue;
+        }
+
+        WRITE_BIT(zmk_keymap_layer_stored[layer][binding->position / 8], binding->position % 8,
+                  1);
+    }
+
+    if (dropped > 0) {
+        LOG_ERR("%d saved bindings of layer %d don't fit in CONFIG_ZMK_KEYMAP_CHANGED_BINDINGS_MAX",
+                dropped, layer);
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+// The bank setting may be loaded after the settings of some bank, which were then applied or
+// skipped for the bank that was active before, so the keymap is loaded again once settings are.
+static bool bank_settings_seen;
+static bool bank_reload_needed;
+
+static int load_active_bank(size_t len, settings_read_cb read_cb, void *cb_arg) {
+    uint8_t bank;
+
+    int err = read_cb(cb_arg, &bank, sizeof(bank));
+    if (err <= 0) {
+        LOG_ERR("Failed to handle keymap bank from settings (err %d)", err);
+        return err;
+    }
+
+    if (bank >= CONFIG_ZMK_KEYMAP_BANKS) {
+        LOG_WRN("Stored keymap bank %d is out of range, keeping bank %d", bank, active_bank);
+        return 0;
+    }
+
+    if (bank != active_bank && bank_settings_seen) {
+        bank_reload_needed = true;
+    }
+
+    active_bank = bank;
+    return 0;
+}
+
+static void reload_bank_cb(struct k_work *work) { load_bank(); }
+
+static K_WORK_DEFINE(reload_bank_work, reload_bank_cb);
+
 static int keymap_handle_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
     const char *next;
 
     LOG_DBG("Setting Keymap setting %s", name);
 
+    if (settings_name_steq(name, "bank", &next) && !next) {
+        return load_active_bank(len, read_cb, cb_arg);
+    }
+
+    uint8_t bank = 0;
+    if (name[0] == 'b' && name[1] >= '1' && name[1] <= '7' && name[2] == '/') {
+        bank = name[1] - '0';
+        name += 3;
+    }
+
+    bank_settings_seen = true;
+    if (bank != active_bank) {
+        return 0;
+    }
+
     if (settings_name_steq(name, "l_n", &next) && next) {
         char *endptr;
         zmk_keymap_layer_id_t layer = strtoul(next, &endptr, 10);
@@ -958,22 +2031,36 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
             return err;
         }
 
-        const char *name =
-            zmk_behavior_find_behavior_name_from_local_id(binding_setting.behavior_local_id);
+        WRITE_BIT(zmk_keymap_layer_legacy[layer][key_position / 8], key_position % 8, 1);
 
-        if (!name) {
-            LOG_WRN("Loaded device %d from settings but no device found by that local ID",
-                    binding_setting.behavior_local_id);
+        // A leftover from before the layer was migrated, the layer setting is newer.
+        if (zmk_keymap_layers_state_test(&loaded_layer_bindings, layer)) {
+            return 0;
         }
 
-        zmk_keymap[layer][key_position] = (struct zmk_behavior_binding){
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-            .local_id = binding_setting.behavior_local_id,
-#endif
-            .behavior_dev = name,
-            .param1 = binding_setting.param1,
-            .param2 = binding_setting.param2,
-        };
+        const struct zmk_behavior_binding loaded = binding_from_setting(&binding_setting);
+
+        err = overlay_set(layer, key_position, &loaded);
+        if (err < 0) {
+            LOG_ERR("Saved binding of layer %d at key position %d doesn't fit in "
+                    "CONFIG_ZMK_KEYMAP_CHANGED_BINDINGS_MAX",
+                    layer, key_position);
+            return err;
+        }
+    } else if (settings_name_steq(name, "lb", &next) && next) {
+        char *endptr;
+        uint8_t layer = strtoul(next, &endptr, 10);
+        if (*endptr != '\0') {
+            LOG_WRN("Invalid layer number: %s with endptr %s", next, endptr);
+            return -EINVAL;
+        }
+
+        if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+            LOG_WRN("Layer %d is larger than max of %d", layer, ZMK_KEYMAP_LAYERS_LEN);
+            return -EINVAL;
+        }
+
+        return load_layer_bindings(layer, len, read_cb, cb_arg);
     }
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
     else if (settings_name_steq(name, "layer_order", &next) && !next) {
@@ -996,19 +2083,39 @@ static int keymap_handle_set(const char *name, size_t len, settings_read_cb read
 };
 
 static int keymap_handle_commit(void) {
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+    bank_settings_seen = false;
+    if (bank_reload_needed) {
+        bank_reload_needed = false;
+        k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &reload_bank_work);
+    }
+
     for (int l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
-        for (int p = 0; p < ZMK_KEYMAP_LEN; p++) {
-            struct zmk_behavior_binding *binding = &zmk_keymap[l][p];
+        if (layer_has_bits(zmk_keymap_layer_legacy[l])) {
+            k_work_submit(&migrate_legacy_bindings_work);
+            break;
+        }
+    }
 
-            if (binding->local_id > 0 && !binding->behavior_dev) {
-                binding->behavior_dev =
-                    zmk_behavior_find_behavior_name_from_local_id(binding->local_id);
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    layer_order_changed();
+#else
+    invalidate_position_cache();
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    invalidate_gaming_routes();
+    invalidate_binding_kinds();
+    invalidate_opaque_layers();
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+    for (int i = 0; i < keymap_overlay_len; i++) {
+        struct zmk_behavior_binding *binding = &keymap_overlay[i].binding;
+
+        if (binding->local_id > 0 && !binding->behavior_dev) {
+            binding->behavior_dev =
+                zmk_behavior_find_behavior_name_from_local_id(binding->local_id);
 
-                if (!binding->behavior_dev) {
-                    LOG_ERR("Failed to finding device for local ID %d after settings load",
-                            binding->local_id);
-                }
+            if (!binding->behavior_dev) {
+                LOG_ERR("Failed to finding device for local ID %d after settings load",
+                        binding->local_id);
             }
         }
     }
@@ -1023,6 +2130,12 @@ SETTINGS_STATIC_HANDLER_DEFINE(keymap, "keymap", NULL, keymap_handle_set, keymap
 #endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_SETTINGS_STORAGE)
 
 int keymap_init(void) {
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT)
+    compact_keymap_init();
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_COMPACT)
+#if ZMK_KEYMAP_HAS_SENSORS
+    resolve_sensor_keymap();
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
 #if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
     load_stock_keymap_layer_ordering();
 #endif
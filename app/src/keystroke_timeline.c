@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/keys.h>
+#include <zmk/keystroke_timeline.h>
+
+#define TIMELINE_SIZE CONFIG_ZMK_KEYSTROKE_TIMELINE_SIZE
+
+static struct zmk_keystroke timeline[TIMELINE_SIZE];
+// Index the next entry goes to, and how many entries there are, up to the size.
+static uint8_t timeline_next;
+static uint8_t timeline_len;
+
+// The latest tap of each kind, by its combo and hold-tap flags. They're kept outside of the
+// timeline, so a burst of releases and modifiers never pushes the last tap out of it.
+#define TAP_KIND(flags) (((flags) & (ZMK_KEYSTROKE_COMBO | ZMK_KEYSTROKE_HOLD_TAP)) >> 2)
+#define TAP_KINDS 4
+
+static struct zmk_keystroke last_taps[TAP_KINDS];
+// When each of the taps above was recorded, to order taps of different kinds at the same time.
+static uint32_t last_tap_seqs[TAP_KINDS];
+static uint8_t last_taps_valid;
+static uint32_t record_seq;
+
+// Set to a large negative number initially for test suites, but not int64 min since it will
+// overflow if a time is added to it.
+static int64_t last_combo_timestamp = INT32_MIN;
+
+static bool is_tap(uint8_t flags) {
+    return (flags & ZMK_KEYSTROKE_PRESSED) != 0 && (flags & ZMK_KEYSTROKE_MODIFIER) == 0;
+}
+
+// Whether a tap comes after another one. On a tie the one recorded last wins, except that a
+// hold-tap's tap comes before the keycode it presses at the same time, so it wins that tie and the
+// tap has its position.
+static bool is_later_tap(const struct zmk_keystroke *tap, uint32_t seq,
+                         const struct zmk_keystroke *other, uint32_t other_seq) {
+    if (tap->timestamp != other->timestamp) {
+        return tap->timestamp > other->timestamp;
+    }
+
+    bool tap_held = (tap->flags & ZMK_KEYSTROKE_HOLD_TAP) != 0;
+    bool other_held = (other->flags & ZMK_KEYSTROKE_HOLD_TAP) != 0;
+
+    if (tap_held != other_held) {
+        return tap_held;
+    }
+
+    // Of two hold-taps tapped at the same time, the first one keeps the tap.
+    return tap_held ? seq < other_seq : seq > other_seq;
+}
+
+static void record(int32_t position, int64_t timestamp, uint8_t flags) {
+    timeline[timeline_next] = (struct zmk_keystroke){
+        .timestamp = timestamp,
+        .position = position,
+        .flags = flags,
+    };
+
+    if (is_tap(flags)) {
+        const uint8_t kind = TAP_KIND(flags);
+
+        if ((last_taps_valid & BIT(kind)) == 0 ||
+            is_later_tap(&timeline[timeline_next], record_seq, &last_taps[kind],
+                         last_tap_seqs[kind])) {
+            last_taps[kind] = timeline[timeline_next];
+            last_tap_seqs[kind] = record_seq;
+            last_taps_valid |= BIT(kind);
+        }
+    }
+
+    record_seq++;
+    timeline_next = (timeline_next + 1) % TIMELINE_SIZE;
+    timeline_len = MIN(timeline_len + 1, TIMELINE_SIZE);
+}
+
+static const struct zmk_keystroke *entry_at(int age) {
+    return &timeline[(timeline_next + TIMELINE_SIZE - 1 - age) % TIMELINE_SIZE];
+}
+
+void zmk_keystroke_timeline_note_combo(int64_t timestamp) { last_combo_timestamp = timestamp; }
+
+void zmk_keystroke_timeline_note_hold_tap(int32_t position, int64_t timestamp) {
+    record(position, timestamp, ZMK_KEYSTROKE_PRESSED | ZMK_KEYSTROKE_HOLD_TAP);
+}
+
+int zmk_keystroke_timeline_last_tap(uint8_t skip, struct zmk_keystroke *tap) {
+    int found = -1;
+
+    for (int kind = 0; kind < TAP_KINDS; kind++) {
+        if ((last_taps_valid & BIT(kind)) == 0 || (last_taps[kind].flags & skip) != 0) {
+            continue;
+        }
+
+        if (found < 0 || is_later_tap(&last_taps[kind], last_tap_seqs[kind], &last_taps[found],
+                                      last_tap_seqs[found])) {
+            found = kind;
+        }
+    }
+
+    if (found < 0) {
+        return -ENOENT;
+    }
+
+    *tap = last_taps[found];
+    return 0;
+}
+
+int zmk_keystroke_timeline_get(int age, struct zmk_keystroke *entry) {
+    if (age < 0 || age >= timeline_len) {
+        return -ENOENT;
+    }
+
+    *entry = *entry_at(age);
+    return 0;
+}
+
+static int keystroke_timeline_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    uint8_t flags = 0;
+
+    if (ev->state) {
+        flags |= ZMK_KEYSTROKE_PRESSED;
+    }
+
+    if (is_mod(ev->usage_page, ev->keycode)) {
+        flags |= ZMK_KEYSTROKE_MODIFIER;
+    }
+
+    if (ev->timestamp <= last_combo_timestamp) {
+        flags |= ZMK_KEYSTROKE_COMBO;
+    }
+
+    record(ZMK_KEYSTROKE_NO_POSITION, ev->timestamp, flags);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(keystroke_timeline, keystroke_timeline_listener);
+ZMK_SUBSCRIPTION(keystroke_timeline, zmk_keycode_state_changed);
@@ -29,6 +29,10 @@ struct ksbb_config {
     bool auto_enable;
     struct ksbb_entry *entries;
     size_t entries_len;
+    // Bit (row % 32) and (column % 32) are set for the row and column of each entry, so most
+    // events can be told apart from every entry without searching them.
+    uint32_t row_mask;
+    uint32_t column_mask;
 };
 
 struct ksbb_data {
@@ -58,6 +62,10 @@ const struct device *find_ksbb_for_inner(const struct device *inner_dev) {
 struct ksbb_entry *find_sideband_behavior(const struct device *dev, uint32_t row, uint32_t column) {
     const struct ksbb_config *cfg = dev->config;
 
+    if (!(cfg->row_mask & BIT(row % 32)) || !(cfg->column_mask & BIT(column % 32))) {
+        return NULL;
+    }
+
     for (int e = 0; e < cfg->entries_len; e++) {
         struct ksbb_entry *candidate = &cfg->entries[e];
 
@@ -190,6 +198,9 @@ static const struct kscan_driver_api ksbb_api = {
         .binding = ZMK_KEYMAP_EXTRACT_BINDING(0, e),                                               \
     }
 
+#define ENTRY_ROW_BIT(e) | BIT(DT_PROP(e, row) % 32)
+#define ENTRY_COLUMN_BIT(e) | BIT(DT_PROP(e, column) % 32)
+
 #define KSBB_INST(n)                                                                               \
     COND_CODE_1(DT_INST_PROP_OR(n, auto_enable, false), (static int ksbb_auto_enable_##n(void) {   \
                     const struct device *dev = DEVICE_DT_GET(DT_DRV_INST(n));                      \
@@ -208,6 +219,8 @@ static const struct kscan_driver_api ksbb_api = {
         .auto_enable = DT_INST_PROP_OR(n, auto_enable, false),                                     \
         .entries = entries_##n,                                                                    \
         .entries_len = ARRAY_SIZE(entries_##n),                                                    \
+        .row_mask = (0 DT_INST_FOREACH_CHILD_STATUS_OKAY(n, ENTRY_ROW_BIT)),                       \
+        .column_mask = (0 DT_INST_FOREACH_CHILD_STATUS_OKAY(n, ENTRY_COLUMN_BIT)),                 \
     };                                                                                             \
     struct ksbb_data ksbb_data_##n = {};                                                           \
     PM_DEVICE_DT_INST_DEFINE(n, ksbb_pm_action);                                                   \
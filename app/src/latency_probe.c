@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_GPIO)
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/init.h>
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_GPIO)
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_SHELL)
+#include <zephyr/shell/shell.h>
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_SHELL)
+
+#include <zmk/latency_probe.h>
+
+// A bucket holds at most twice the window, just before it is halved.
+BUILD_ASSERT(CONFIG_ZMK_LATENCY_PROBE_WINDOW <= UINT16_MAX / 2,
+             "The latency probe window must fit the histogram buckets");
+
+static struct zmk_latency_probe_histogram histograms[ZMK_LATENCY_PROBE_STAGES];
+static struct k_spinlock lock;
+
+// The edge of the key event being raised. Reports are only measured against it when they are sent
+// from the same thread, so one sent meanwhile by another thread is not counted.
+static uint32_t current_edge;
+static k_tid_t current_edge_thread;
+
+// The edge of the oldest report handed to USB that the host has not taken yet.
+static uint32_t usb_edge;
+static bool usb_edge_pending;
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_GPIO)
+
+static const struct gpio_dt_spec probe_gpio =
+    GPIO_DT_SPEC_GET(DT_CHOSEN(zmk_latency_probe), gpios);
+
+static int latency_probe_gpio_init(void) {
+    if (!gpio_is_ready_dt(&probe_gpio)) {
+        return -ENODEV;
+    }
+
+    return gpio_pin_configure_dt(&probe_gpio, GPIO_OUTPUT_INACTIVE);
+}
+
+SYS_INIT(latency_probe_gpio_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_GPIO)
+
+static uint8_t bucket_for(uint32_t us) {
+    if (us < 2) {
+        return 0;
+    }
+
+    return MIN(31 - __builtin_clz(us), ZMK_LATENCY_PROBE_BUCKETS - 1);
+}
+
+static void record(enum zmk_latency_probe_stage stage, uint32_t edge_cycles) {
+    const uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - edge_cycles);
+
+    K_SPINLOCK(&lock) {
+        struct zmk_latency_probe_histogram *histogram = &histograms[stage];
+
+        histogram->buckets[bucket_for(us)]++;
+        histogram->count++;
+        histogram->max_us = MAX(histogram->max_us, us);
+
+        if (histogram->count % CONFIG_ZMK_LATENCY_PROBE_WINDOW == 0) {
+            for (int i = 0; i < ZMK_LATENCY_PROBE_BUCKETS; i++) {
+                histogram->buckets[i] /= 2;
+            }
+        }
+    }
+}
+
+uint32_t zmk_latency_probe_edge_cycles(int64_t ticks) {
+    const int64_t age = k_uptime_ticks() - ticks;
+
+    return k_cycle_get_32() - k_ticks_to_cyc_floor32(CLAMP(age, 0, INT32_MAX));
+}
+
+void zmk_latency_probe_edge_begin(uint32_t edge_cycles) {
+    current_edge = edge_cycles;
+    current_edge_thread = k_current_get();
+}
+
+void zmk_latency_probe_edge_end(void) { current_edge_thread = NULL; }
+
+void zmk_latency_probe_report_sent(enum zmk_transport transport) {
+    if (current_edge_thread == NULL || current_edge_thread != k_current_get()) {
+        return;
+    }
+
+    record(transport == ZMK_TRANSPORT_USB ? ZMK_LATENCY_PROBE_USB_SENT : ZMK_LATENCY_PROBE_BLE_SENT,
+           current_edge);
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_GPIO)
+    gpio_pin_toggle_dt(&probe_gpio);
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_GPIO)
+
+    if (transport == ZMK_TRANSPORT_USB) {
+        K_SPINLOCK(&lock) {
+            if (!usb_edge_pending) {
+                usb_edge = current_edge;
+                usb_edge_pending = true;
+            }
+        }
+    }
+}
+
+void zmk_latency_probe_usb_report_delivered(void) {
+    bool pending = false;
+    uint32_t edge = 0;
+
+    K_SPINLOCK(&lock) {
+        pending = usb_edge_pending;
+        edge = usb_edge;
+        usb_edge_pending = false;
+    }
+
+    if (pending) {
+        record(ZMK_LATENCY_PROBE_USB_DELIVERED, edge);
+    }
+}
+
+void zmk_latency_probe_get_histogram(enum zmk_latency_probe_stage stage,
+                                     struct zmk_latency_probe_histogram *histogram) {
+    K_SPINLOCK(&lock) { *histogram = histograms[stage]; }
+}
+
+void zmk_latency_probe_clear(void) {
+    K_SPINLOCK(&lock) { memset(histograms, 0, sizeof(histograms)); }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_SHELL)
+
+static const char *const stage_names[ZMK_LATENCY_PROBE_STAGES] = {
+    [ZMK_LATENCY_PROBE_USB_SENT] = "USB sent",
+    [ZMK_LATENCY_PROBE_BLE_SENT] = "BLE sent",
+    [ZMK_LATENCY_PROBE_USB_DELIVERED] = "USB delivered",
+};
+
+static int cmd_latency_show(const struct shell *sh, size_t argc, char **argv) {
+    for (int stage = 0; stage < ZMK_LATENCY_PROBE_STAGES; stage++) {
+        struct zmk_latency_probe_histogram histogram;
+
+        zmk_latency_probe_get_histogram(stage, &histogram);
+        shell_print(sh, "%s: %u reports, longest %u us", stage_names[stage], histogram.count,
+                    histogram.max_us);
+
+        for (int i = 0; i < ZMK_LATENCY_PROBE_BUCKETS; i++) {
+            if (histogram.buckets[i] == 0) {
+                continue;
+            }
+
+            if (i == ZMK_LATENCY_PROBE_BUCKETS - 1) {
+                shell_print(sh, "  %6u+      us %5u", BIT(i), histogram.buckets[i]);
+            } else {
+                shell_print(sh, "  %6u-%-6u us %5u", i == 0 ? 0 : BIT(i), BIT(i + 1) - 1,
+                            histogram.buckets[i]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_latency_clear(const struct shell *sh, size_t argc, char **argv) {
+    zmk_latency_probe_clear();
+    shell_print(sh, "Latency histograms cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_latency,
+                               SHELL_CMD(show, NULL, "Print the latency histograms",
+                                         cmd_latency_show),
+                               SHELL_CMD(clear, NULL, "Reset the latency histograms",
+                                         cmd_latency_clear),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(latency, &sub_latency, "Latency from kscan edges to HID reports", NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE_SHELL)
@@ -8,10 +8,14 @@
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/iterable_sections.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
 #if IS_ENABLED(CONFIG_ZMK_DISPLAY)
 
 #include <zmk/display.h>
@@ -19,12 +23,112 @@ LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_BOOT_PROFILE)
+
+#define BOOT_PROFILE(stage, start)                                                                 \
+    LOG_INF("Boot profile: %s took %lld ms, done at %lld ms", stage, k_uptime_get() - (start),     \
+            k_uptime_get())
+
+static int boot_profile_listener(const zmk_event_t *eh) {
+    static bool first_key_seen;
+
+    if (!first_key_seen) {
+        first_key_seen = true;
+        LOG_INF("Boot profile: first key position event at %lld ms", k_uptime_get());
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(boot_profile, boot_profile_listener);
+ZMK_SUBSCRIPTION(boot_profile, zmk_position_state_changed);
+
+#else
+
+#define BOOT_PROFILE(stage, start)
+
+#endif // IS_ENABLED(CONFIG_ZMK_BOOT_PROFILE)
+
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_STAGED_LOAD)
+
+// Kscan, the keymap and HID are already running with the stock keymap by the time main() runs.
+// The settings needed to reconnect and select the right output and layout are loaded and
+// committed first, the rest, e.g. keymap changes and lighting, are then applied on top.
+static const char *const early_settings[] = {"bt", "ble", "behavior", "physical_layouts",
+                                             "endpoints"};
+
+static bool is_early_setting(const char *name) {
+    for (int i = 0; i < ARRAY_SIZE(early_settings); i++) {
+        if (settings_name_steq(name, early_settings[i], NULL)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int load_staged_setting(const char *key, size_t len, settings_read_cb read_cb,
+                               void *cb_arg, void *param) {
+    const bool early = *(const bool *)param;
+
+    if (is_early_setting(key) != early) {
+        return 0;
+    }
+
+    const char *next;
+    struct settings_handler_static *handler = settings_parse_and_lookup(key, &next);
+
+    if (handler == NULL || handler->h_set == NULL) {
+        return 0;
+    }
+
+    int err = handler->h_set(next, len, read_cb, cb_arg);
+    if (err < 0) {
+        LOG_WRN("Failed to load setting %s (%d)", key, err);
+    }
+
+    return 0;
+}
+
+static void load_settings_staged(void) {
+    int64_t start = k_uptime_get();
+    bool early = true;
+
+    settings_load_subtree_direct(NULL, load_staged_setting, &early);
+    for (int i = 0; i < ARRAY_SIZE(early_settings); i++) {
+        settings_commit_subtree(early_settings[i]);
+    }
+
+    BOOT_PROFILE("early settings", start);
+
+    start = k_uptime_get();
+    early = false;
+
+    settings_load_subtree_direct(NULL, load_staged_setting, &early);
+    STRUCT_SECTION_FOREACH(settings_handler_static, handler) {
+        if (handler->h_commit != NULL && !is_early_setting(handler->name)) {
+            handler->h_commit();
+        }
+    }
+
+    BOOT_PROFILE("remaining settings", start);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SETTINGS_STAGED_LOAD)
+
 int main(void) {
     LOG_INF("Welcome to ZMK!\n");
+    BOOT_PROFILE("kernel and SYS_INIT", 0);
 
 #if IS_ENABLED(CONFIG_SETTINGS)
     settings_subsys_init();
+#if IS_ENABLED(CONFIG_ZMK_SETTINGS_STAGED_LOAD)
+    load_settings_staged();
+#else
+    int64_t start = k_uptime_get();
     settings_load();
+    BOOT_PROFILE("settings", start);
+#endif
 #endif
 
 #ifdef CONFIG_ZMK_DISPLAY
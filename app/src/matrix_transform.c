@@ -14,8 +14,10 @@
 #define DT_DRV_COMPAT zmk_matrix_transform
 
 struct zmk_matrix_transform {
-    uint32_t const *lookup_table;
+    uint16_t const *lookup_table;
     size_t len;
+    struct zmk_matrix_transform_row_column const *inverse_table;
+    size_t inverse_len;
     uint8_t rows;
     uint8_t columns;
     uint8_t col_offset;
@@ -35,6 +37,9 @@ struct zmk_matrix_transform {
  * initialized to 0, and the keymap index of 0 is a valid index. We want to
  * be able to detect the condition when an unassigned matrix position is
  * pressed and we want to return an error.
+ *
+ * The `inverse_table` is the map itself, decoded at compile time, so finding
+ * the row,column pair of a keymap position is a single lookup too.
  */
 
 #define INDEX_OFFSET 1
@@ -45,9 +50,18 @@ struct zmk_matrix_transform {
     [(KT_ROW(DT_INST_PROP_BY_IDX(n, map, i)) * DT_INST_PROP(n, columns)) +                         \
         KT_COL(DT_INST_PROP_BY_IDX(n, map, i))] = i + INDEX_OFFSET
 
+#define TRANSFORM_INVERSE_ENTRY(i, n)                                                              \
+    {                                                                                              \
+        .row = KT_ROW(DT_INST_PROP_BY_IDX(n, map, i)),                                             \
+        .column = KT_COL(DT_INST_PROP_BY_IDX(n, map, i)),                                          \
+    }
+
 #define MATRIX_TRANSFORM_INIT(n)                                                                   \
-    static const uint32_t _CONCAT(zmk_transform_lookup_table_, n)[] = {                            \
+    static const uint16_t _CONCAT(zmk_transform_lookup_table_, n)[] = {                            \
         LISTIFY(DT_INST_PROP_LEN(n, map), TRANSFORM_LOOKUP_ENTRY, (, ), n)};                       \
+    static const struct zmk_matrix_transform_row_column                                            \
+        _CONCAT(zmk_transform_inverse_table_, n)[] = {                                             \
+            LISTIFY(DT_INST_PROP_LEN(n, map), TRANSFORM_INVERSE_ENTRY, (, ), n)};                  \
     const struct zmk_matrix_transform _CONCAT(zmk_matrix_transform_, DT_DRV_INST(n)) = {           \
         .rows = DT_INST_PROP(n, rows),                                                             \
         .columns = DT_INST_PROP(n, columns),                                                       \
@@ -55,6 +69,8 @@ struct zmk_matrix_transform {
         .row_offset = DT_INST_PROP(n, row_offset),                                                 \
         .lookup_table = _CONCAT(zmk_transform_lookup_table_, n),                                   \
         .len = ARRAY_SIZE(_CONCAT(zmk_transform_lookup_table_, n)),                                \
+        .inverse_table = _CONCAT(zmk_transform_inverse_table_, n),                                 \
+        .inverse_len = ARRAY_SIZE(_CONCAT(zmk_transform_inverse_table_, n)),                       \
     };
 
 DT_INST_FOREACH_STATUS_OKAY(MATRIX_TRANSFORM_INIT);
@@ -73,6 +89,20 @@ const struct zmk_matrix_transform zmk_matrix_transform_default = {
 `
 #endif // DT_HAS_COMPAT_STATUS_OKAY(zmk_matrix_transform)
 
+static inline int32_t lookup_position(zmk_matrix_transform_t mt, uint32_t row, uint32_t column) {
+    uint32_t lookup_index = (row * mt->columns) + column;
+    if (lookup_index >= mt->len) {
+        return -EINVAL;
+    }
+
+    int32_t val = mt->lookup_table[lookup_index];
+    if (val == 0) {
+        return -EINVAL;
+    }
+
+    return val - INDEX_OFFSET;
+}
+
 int32_t zmk_matrix_transform_row_column_to_position(zmk_matrix_transform_t mt, uint32_t row,
                                                     uint32_t column) {
     column += mt->col_offset;
@@ -82,15 +112,56 @@ int32_t zmk_matrix_transform_row_column_to_position(zmk_matrix_transform_t mt, u
         return (row * mt->columns) + column;
     }
 
-    uint16_t lookup_index = ((row * mt->columns) + column);
-    if (lookup_index >= mt->len) {
-        return -EINVAL;
+    return lookup_position(mt, row, column);
+}
+
+void zmk_matrix_transform_row_columns_to_positions(
+    zmk_matrix_transform_t mt, const struct zmk_matrix_transform_row_column *row_columns,
+    size_t len, int32_t *positions) {
+    const uint32_t row_offset = mt->row_offset;
+    const uint32_t col_offset = mt->col_offset;
+
+    if (!mt->lookup_table) {
+        for (size_t i = 0; i < len; i++) {
+            positions[i] = ((row_columns[i].row + row_offset) * mt->columns) +
+                           row_columns[i].column + col_offset;
+        }
+
+        return;
     }
 
-    int32_t val = mt->lookup_table[lookup_index];
-    if (val == 0) {
+    for (size_t i = 0; i < len; i++) {
+        positions[i] = lookup_position(mt, row_columns[i].row + row_offset,
+                                       row_columns[i].column + col_offset);
+    }
+}
+
+int zmk_matrix_transform_position_to_row_column(zmk_matrix_transform_t mt, uint32_t position,
+                                                struct zmk_matrix_transform_row_column *rc) {
+    uint32_t row, column;
+
+    if (mt->inverse_table) {
+        if (position >= mt->inverse_len) {
+            return -EINVAL;
+        }
+
+        row = mt->inverse_table[position].row;
+        column = mt->inverse_table[position].column;
+    } else {
+        if (position >= mt->len) {
+            return -EINVAL;
+        }
+
+        row = position / mt->columns;
+        column = position % mt->columns;
+    }
+
+    // Positions of other parts of a composite kscan aren't reachable through this transform
+    if (row < mt->row_offset || column < mt->col_offset) {
         return -EINVAL;
     }
 
-    return val - INDEX_OFFSET;
-};
\ No newline at end of file
+    rc->row = row - mt->row_offset;
+    rc->column = column - mt->col_offset;
+    return 0;
+}
@@ -18,10 +18,14 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/kscan_time.h>
+#include <zmk/latency_probe.h>
 #include <zmk/matrix.h>
 #include <zmk/physical_layouts.h>
+#include <zmk/queue_stats.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
+#include <zmk/workqueue.h>
 
 ZMK_EVENT_IMPL(zmk_physical_layout_selection_changed);
 
@@ -171,14 +175,24 @@ struct zmk_kscan_event {
     uint32_t row;
     uint32_t column;
     uint32_t state;
+    /** Uptime in milliseconds when the kscan driver detected the event. */
+    int64_t timestamp;
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    /** Cycle count when the kscan driver detected the event. */
+    uint32_t edge_cycles;
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
 };
 
 static struct zmk_kscan_msg_processor {
     struct k_work work;
+    /** Set while a drain of the queue is submitted but has not started yet. */
+    atomic_t drain_pending;
 } msg_processor;
 
 K_MSGQ_DEFINE(physical_layouts_kscan_msgq, sizeof(struct zmk_kscan_event),
-              CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE, 4);
+              CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE, 8);
+
+ZMK_QUEUE_STATS_DEFINE(kscan_msgq, "kscan events", CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE);
 
 static void zmk_physical_layout_kscan_callback(const struct device *dev, uint32_t row,
                                                uint32_t column, bool pressed) {
@@ -186,37 +200,135 @@ static void zmk_physical_layout_kscan_callback(const struct device *dev, uint32_
         return;
     }
 
+    const int64_t ticks = zmk_kscan_event_time();
     struct zmk_kscan_event ev = {
         .row = row,
         .column = column,
-        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED)};
+        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED),
+        .timestamp = k_ticks_to_ms_floor64(ticks),
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+        .edge_cycles = zmk_latency_probe_edge_cycles(ticks),
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    };
+
+    if (ZMK_QUEUE_STATS_MSGQ_PUT(kscan_msgq, &physical_layouts_kscan_msgq, &ev, K_NO_WAIT) < 0) {
+        LOG_WRN("Kscan event queue full, dropping row: %d, col: %d", row, column);
+    }
+
+    // Every event of a scan is handled by a single drain, so only submit the first time.
+    if (atomic_cas(&msg_processor.drain_pending, false, true)) {
+        ZMK_WORKQUEUE_PROFILE_SUBMITTED(zmk_physical_layouts_kscan_process_msgq);
+        k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &msg_processor.work);
+    }
+}
+
+// Take the queued events, up to a batch, along with the positions they map to.
+static size_t drain_kscan_msgq(struct zmk_kscan_event events[CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE],
+                               int32_t positions[CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE]) {
+    struct zmk_matrix_transform_row_column row_columns[CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE];
+    size_t len = 0;
+
+    while (len < CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE &&
+           k_msgq_get(&physical_layouts_kscan_msgq, &events[len], K_NO_WAIT) == 0) {
+        row_columns[len] = (struct zmk_matrix_transform_row_column){
+            .row = events[len].row,
+            .column = events[len].column,
+        };
+        len++;
+    }
+
+    // The whole batch goes through one transform, so a layout switched to while the kscan keeps
+    // running takes over between scans. Rows and columns name the same switches in all layouts
+    // sharing a kscan, so events scanned before the switch still map to the right keys.
+    zmk_matrix_transform_t transform = active->matrix_transform;
 
-    k_msgq_put(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&msg_processor.work);
+    zmk_matrix_transform_row_columns_to_positions(transform, row_columns, len, positions);
+
+    return len;
+}
+
+static void raise_kscan_event(const struct zmk_kscan_event *ev, int32_t position) {
+    const uint32_t start_cycles = k_cycle_get_32();
+
+#if IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+    zmk_latency_probe_edge_begin(ev->edge_cycles);
+#endif // IS_ENABLED(CONFIG_ZMK_LATENCY_PROBE)
+
+    raise_zmk_position_state_changed((struct zmk_position_state_changed){
+        .source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+        .state = (ev->state == ZMK_KSCAN_EVENT_STATE_PRESSED),
+        .position = position,
+        .timestamp = ev->timestamp});
+
+    zmk_latency_probe_edge_end();
+    zmk_workqueue_input_budget_check(start_cycles, position);
 }
 
-static void zmk_physical_layouts_kscan_process_msgq(struct k_work *item) {
-    struct zmk_kscan_event ev;
+ZMK_WORKQUEUE_PROFILE_HANDLER(zmk_physical_layouts_kscan_process_msgq) {
+    struct zmk_kscan_event events[CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE];
+    int32_t positions[CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE];
+
+    // Clear this before draining, so an event queued after the last get submits a new drain.
+    atomic_set(&msg_processor.drain_pending, false);
+
+    const size_t len = drain_kscan_msgq(events, positions);
 
-    while (k_msgq_get(&physical_layouts_kscan_msgq, &ev, K_NO_WAIT) == 0) {
-        bool pressed = (ev.state == ZMK_KSCAN_EVENT_STATE_PRESSED);
-        int32_t position = zmk_matrix_transform_row_column_to_position(active->matrix_transform,
-                                                                       ev.row, ev.column);
+    for (size_t i = 0; i < len; i++) {
+        const struct zmk_kscan_event *ev = &events[i];
+        bool pressed = (ev->state == ZMK_KSCAN_EVENT_STATE_PRESSED);
 
-        if (position < 0) {
-            LOG_WRN("Not found in transform: row: %d, col: %d, pressed: %s", ev.row, ev.column,
+        if (positions[i] < 0) {
+            LOG_WRN("Not found in transform: row: %d, col: %d, pressed: %s", ev->row, ev->column,
                     (pressed ? "true" : "false"));
             continue;
         }
 
-        LOG_DBG("Row: %d, col: %d, position: %d, pressed: %s", ev.row, ev.column, position,
+        LOG_DBG("Row: %d, col: %d, position: %d, pressed: %s", ev->row, ev->column, positions[i],
                 (pressed ? "true" : "false"));
-        raise_zmk_position_state_changed(
-            (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
-                                                .state = pressed,
-                                                .position = position,
-                                                .timestamp = k_uptime_get()});
+
+        raise_kscan_event(ev, positions[i]);
     }
+
+    // Anything queued while events were being raised is picked up by the drain it submitted.
+}
+
+int zmk_physical_layouts_raise_merged(const struct zmk_position_state_changed *events,
+                                      size_t len) {
+    struct zmk_kscan_event local[CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE];
+    int32_t positions[CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE];
+    size_t next_local = 0;
+
+    // Both drains run on the input work queue, so the local events taken here can't be raised
+    // concurrently. A drain already submitted for them finds the queue empty.
+    const size_t local_len = drain_kscan_msgq(local, positions);
+
+    for (size_t i = 0; i <= len; i++) {
+        // Local events go first on ties, as they would have if their own drain had run first.
+        while (next_local < local_len &&
+               (i == len || local[next_local].timestamp <= events[i].timestamp)) {
+            const struct zmk_kscan_event *ev = &local[next_local];
+            const int32_t position = positions[next_local++];
+
+            if (position < 0) {
+                LOG_WRN("Not found in transform: row: %d, col: %d", ev->row, ev->column);
+                continue;
+            }
+
+            LOG_DBG("Row: %d, col: %d, position: %d", ev->row, ev->column, position);
+            raise_kscan_event(ev, position);
+        }
+
+        if (i == len) {
+            break;
+        }
+
+        int ret = raise_zmk_position_state_changed(events[i]);
+        if (ret < 0) {
+            LOG_WRN("Failed to raise merged position event (%d)", ret);
+        }
+    }
+
+    return 0;
 }
 
 static const struct zmk_physical_layout *get_default_layout(void) {
@@ -257,7 +369,10 @@ int zmk_physical_layouts_select_layout(const struct zmk_physical_layout *dest_la
         return 0;
     }
 
-    if (active) {
+    // Layouts scanned by the same kscan device keep it running, only the transform changes
+    bool hot_swap = active && active->kscan == dest_layout->kscan;
+
+    if (active && !hot_swap) {
         if (active->kscan) {
             kscan_disable_callback(active->kscan);
 #if IS_ENABLED(CONFIG_PM_DEVICE_RUNTIME)
@@ -279,7 +394,7 @@ int zmk_physical_layouts_select_layout(const struct zmk_physical_layout *dest_la
 
     active = dest_layout;
 
-    if (active->kscan) {
+    if (active->kscan && !hot_swap) {
 #if IS_ENABLED(CONFIG_PM_DEVICE_RUNTIME)
         int err = pm_device_runtime_get(active->kscan);
         if (err < 0) {
@@ -467,7 +582,8 @@ SETTINGS_STATIC_HANDLER_DEFINE(physical_layouts, "physical_layouts", NULL,
 #endif // IS_ENABLED(CONFIG_SETTINGS)
 
 static int zmk_physical_layouts_init(void) {
-    k_work_init(&msg_processor.work, zmk_physical_layouts_kscan_process_msgq);
+    k_work_init(&msg_processor.work,
+                ZMK_WORKQUEUE_PROFILED(zmk_physical_layouts_kscan_process_msgq));
 
 #if IS_ENABLED(CONFIG_PM_DEVICE)
     for (int l = 0; l < ARRAY_SIZE(layouts); l++) {
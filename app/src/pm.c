@@ -16,6 +16,15 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/endpoints.h>
+#include <zmk/pm.h>
+
+#if IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+#include <zmk/ble.h>
+#endif
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#endif
 
 // Reimplement some of the device work from Zephyr PM to work with the new `sys_poweroff` API.
 // TODO: Tweak this to smarter runtime PM of subsystems on sleep.
@@ -134,4 +143,76 @@ int zmk_pm_soft_off(void) {
     return 0;
 }
 
-#endif // IS_ENABLED(CONFIG_ZMK_PM_SOFT_OFF)
\ No newline at end of file
+#endif // IS_ENABLED(CONFIG_ZMK_PM_SOFT_OFF)
+
+#if IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
+
+#define HAS_HOST_BLE                                                                               \
+    (IS_ENABLED(CONFIG_ZMK_BLE) &&                                                                 \
+     (!IS_ENABLED(CONFIG_ZMK_SPLIT) || IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)))
+
+// Unlike soft-off, wake-up capable kscan devices are never suspended, so the next key press
+// reaches the listener below and resumes everything else.
+static bool soft_suspended;
+static int32_t wake_position = -1;
+
+int zmk_pm_soft_suspend(void) {
+#if !IS_ENABLED(CONFIG_ZMK_SPLIT) || IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+    zmk_endpoints_clear_current();
+    // Need to sleep to give any other threads a chance so submit endpoint data.
+    k_sleep(K_MSEC(100));
+#endif
+
+#if HAS_HOST_BLE
+    zmk_ble_suspend();
+#endif
+
+    int err = zmk_pm_suspend_devices();
+    if (err < 0) {
+        zmk_pm_resume_devices();
+#if HAS_HOST_BLE
+        zmk_ble_resume();
+#endif
+        return err;
+    }
+
+    LOG_DBG("soft-suspend: waiting for a key press");
+    soft_suspended = true;
+    return 0;
+}
+
+static void zmk_pm_soft_resume(void) {
+    LOG_DBG("soft-suspend: resuming");
+    soft_suspended = false;
+    zmk_pm_resume_devices();
+
+#if HAS_HOST_BLE
+    zmk_ble_resume();
+#endif
+}
+
+static int soft_suspend_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (ev->state && soft_suspended) {
+        wake_position = ev->position;
+        zmk_pm_soft_resume();
+        return ZMK_EV_EVENT_HANDLED;
+    }
+
+    if (!ev->state && ev->position == wake_position) {
+        wake_position = -1;
+        return ZMK_EV_EVENT_HANDLED;
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(pm_soft_suspend, soft_suspend_listener);
+ZMK_SUBSCRIPTION_PRIORITY(pm_soft_suspend, zmk_position_state_changed, CRITICAL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_PM_SOFT_SUSPEND)
\ No newline at end of file
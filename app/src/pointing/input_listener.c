@@ -41,7 +41,9 @@ enum input_listener_xy_data_mode {
 };
 
 struct input_listener_axis_data {
-    int16_t value;
+    // Wider than the HID report fields, so that a burst of motion or scrolling accumulated between
+    // reports can't wrap around.
+    int32_t value;
 };
 
 struct input_listener_xy_data {
@@ -65,9 +67,35 @@ struct input_processor_remainder_data {
     int16_t x, y, wheel, h_wheel;
 };
 
+#define USE_FUSED_PROCESSORS IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_FUSED_PROCESSORS)
+
+#if USE_FUSED_PROCESSORS
+/**
+ * The combined effect of a processor chain on events of one type and code, built the first time
+ * such an event is processed.
+ */
+struct input_listener_fused_entry {
+    uint8_t type;
+    uint16_t code;
+    /** Whether the chain can be applied as this entry, or has to run processor by processor. */
+    bool fused;
+    /** Whether a processor in the chain scales the value, rather than at most inverting it. */
+    bool scaled;
+    uint16_t out_code;
+    int16_t mul;
+    int16_t div;
+    /** Remainder of the scaling processor, if it tracks remainders. */
+    int16_t *remainder;
+};
+#endif // USE_FUSED_PROCESSORS
+
 struct input_listener_processor_data {
     size_t remainders_len;
     struct input_processor_remainder_data *remainders;
+#if USE_FUSED_PROCESSORS
+    struct input_listener_fused_entry fused[CONFIG_ZMK_INPUT_LISTENER_FUSED_PROCESSORS_CODES];
+    size_t fused_len;
+#endif // USE_FUSED_PROCESSORS
 };
 
 struct input_listener_config {
@@ -77,20 +105,35 @@ struct input_listener_config {
     struct input_listener_layer_override layer_overrides[];
 };
 
+struct input_listener_mouse_data {
+    struct input_listener_xy_data data;
+    struct input_listener_xy_data wheel_data;
+
+    uint8_t button_set;
+    uint8_t button_clear;
+};
+
+#define USE_REPORT_RATE_LIMIT IS_ENABLED(CONFIG_ZMK_INPUT_LISTENER_REPORT_RATE_LIMIT)
+
 struct input_listener_data {
     union {
-        struct {
-            struct input_listener_xy_data data;
-            struct input_listener_xy_data wheel_data;
-
-            uint8_t button_set;
-            uint8_t button_clear;
-        } mouse;
+        struct input_listener_mouse_data mouse;
     };
 
+#if USE_REPORT_RATE_LIMIT
+    // Motion is accumulated in mouse until the endpoint can take another report.
+    struct k_spinlock lock;
+#endif // USE_REPORT_RATE_LIMIT
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    // Devices only report the axes that changed, so the last position is kept between reports.
+    int32_t abs_x;
+    int32_t abs_y;
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
-    int16_t wheel_remainder;
-    int16_t h_wheel_remainder;
+    int32_t wheel_remainder;
+    int32_t h_wheel_remainder;
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
     struct input_listener_processor_data base_processor_data;
@@ -121,7 +164,25 @@ static void handle_rel_code(struct input_listener_data *data, struct input_event
 }
 
 static void handle_abs_code(const struct input_listener_config *config,
-                            struct input_listener_data *data, struct input_event *evt) {}
+                            struct input_listener_data *data, struct input_event *evt) {
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    // Positions are expected in the report's range by now, e.g. scaled by an input processor.
+    switch (evt->code) {
+    case INPUT_ABS_X:
+        data->abs_x = CLAMP(evt->value, 0, ZMK_HID_ABS_POINTER_MAX);
+        break;
+    case INPUT_ABS_Y:
+        data->abs_y = CLAMP(evt->value, 0, ZMK_HID_ABS_POINTER_MAX);
+        break;
+    default:
+        return;
+    }
+
+    data->mouse.data.mode = INPUT_LISTENER_XY_DATA_MODE_ABS;
+    data->mouse.data.x.value = data->abs_x;
+    data->mouse.data.y.value = data->abs_y;
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+}
 
 static void handle_key_code(const struct input_listener_config *config,
                             struct input_listener_data *data, struct input_event *evt) {
@@ -153,9 +214,149 @@ static inline bool is_y_data(const struct input_event *evt) {
     return evt->type == INPUT_EV_REL && evt->code == INPUT_REL_Y;
 }
 
+static int16_t *select_remainder(struct input_processor_remainder_data *remainders, uint8_t type,
+                                 uint16_t code) {
+    if (!remainders || type != INPUT_EV_REL) {
+        return NULL;
+    }
+
+    switch (code) {
+    case INPUT_REL_X:
+        return &remainders->x;
+    case INPUT_REL_Y:
+        return &remainders->y;
+    case INPUT_REL_WHEEL:
+        return &remainders->wheel;
+    case INPUT_REL_HWHEEL:
+        return &remainders->h_wheel;
+    default:
+        return NULL;
+    }
+}
+
+#if USE_FUSED_PROCESSORS
+
+static bool mapping_scales(const struct zmk_input_processor_mapping *mapping) {
+    return mapping->div != 1 || (mapping->mul != 1 && mapping->mul != -1);
+}
+
+/**
+ * Combine the mappings of every processor in a chain. Chains with a processor that has no mapping,
+ * or with more than one scaling processor, are left unfused, since rounding after each of several
+ * scalers can't be reproduced with a single multiply and divide.
+ */
+static void build_fused_entry(const struct input_listener_config_entry *cfg,
+                              struct input_listener_processor_data *processor_data,
+                              struct input_listener_fused_entry *entry) {
+    size_t remainder_index = 0;
+
+    entry->fused = false;
+    entry->scaled = false;
+    entry->out_code = entry->code;
+    entry->mul = 1;
+    entry->div = 1;
+    entry->remainder = NULL;
+
+    for (size_t p = 0; p < cfg->processors_len; p++) {
+        const struct zmk_input_processor_entry *proc_e = &cfg->processors[p];
+        struct input_processor_remainder_data *remainders = NULL;
+        if (proc_e->track_remainders) {
+            remainders = &processor_data->remainders[remainder_index++];
+        }
+
+        struct zmk_input_processor_mapping mapping = {.code = entry->out_code, .mul = 1, .div = 1};
+        int ret = zmk_input_processor_get_mapping(proc_e->dev, entry->type, proc_e->param1,
+                                                  proc_e->param2, &mapping);
+        if (ret < 0) {
+            return;
+        }
+
+        if (mapping_scales(&mapping)) {
+            if (entry->scaled) {
+                return;
+            }
+
+            entry->scaled = true;
+            entry->div = mapping.div;
+            entry->remainder = select_remainder(remainders, entry->type, entry->out_code);
+        }
+
+        entry->mul *= mapping.mul;
+        entry->out_code = mapping.code;
+    }
+
+    entry->fused = true;
+}
+
+/**
+ * Apply a chain with a single lookup and at most one multiply and divide, if it can be fused.
+ *
+ * @returns true if the event was processed, or false if the chain has to run processor by
+ *          processor.
+ */
+static bool apply_fused_config(const struct input_listener_config_entry *cfg,
+                               struct input_listener_processor_data *processor_data,
+                               struct input_event *evt) {
+    struct input_listener_fused_entry *entry = NULL;
+
+    for (size_t i = 0; i < processor_data->fused_len; i++) {
+        if (processor_data->fused[i].type == evt->type &&
+            processor_data->fused[i].code == evt->code) {
+            entry = &processor_data->fused[i];
+            break;
+        }
+    }
+
+    if (!entry) {
+        if (processor_data->fused_len == ARRAY_SIZE(processor_data->fused)) {
+            return false;
+        }
+
+        entry = &processor_data->fused[processor_data->fused_len++];
+        entry->type = evt->type;
+        entry->code = evt->code;
+        build_fused_entry(cfg, processor_data, entry);
+    }
+
+    if (!entry->fused) {
+        return false;
+    }
+
+    evt->code = entry->out_code;
+
+    if (!entry->scaled) {
+        evt->value *= entry->mul;
+        return true;
+    }
+
+    // Matches the arithmetic of the scaler input processor.
+    int32_t value_mul = evt->value * (int32_t)entry->mul;
+
+    if (entry->remainder) {
+        value_mul += *entry->remainder;
+    }
+
+    int32_t scaled = value_mul / (int32_t)entry->div;
+
+    if (entry->remainder) {
+        *entry->remainder = value_mul - (scaled * entry->div);
+    }
+
+    evt->value = scaled;
+    return true;
+}
+
+#endif // USE_FUSED_PROCESSORS
+
 static int apply_config(uint8_t listener_index, const struct input_listener_config_entry *cfg,
                         struct input_listener_processor_data *processor_data,
                         struct input_listener_data *data, struct input_event *evt) {
+#if USE_FUSED_PROCESSORS
+    if (apply_fused_config(cfg, processor_data, evt)) {
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+#endif // USE_FUSED_PROCESSORS
+
     size_t remainder_index = 0;
     for (size_t p = 0; p < cfg->processors_len; p++) {
         const struct zmk_input_processor_entry *proc_e = &cfg->processors[p];
@@ -164,25 +365,7 @@ static int apply_config(uint8_t listener_index, const struct input_listener_conf
             remainders = &processor_data->remainders[remainder_index++];
         }
 
-        int16_t *remainder = NULL;
-        if (remainders) {
-            if (evt->type == INPUT_EV_REL) {
-                switch (evt->code) {
-                case INPUT_REL_X:
-                    remainder = &remainders->x;
-                    break;
-                case INPUT_REL_Y:
-                    remainder = &remainders->y;
-                    break;
-                case INPUT_REL_WHEEL:
-                    remainder = &remainders->wheel;
-                    break;
-                case INPUT_REL_HWHEEL:
-                    remainder = &remainders->h_wheel;
-                    break;
-                }
-            }
-        }
+        int16_t *remainder = select_remainder(remainders, evt->type, evt->code);
 
         LOG_DBG("LISTENER INDEX: %d", listener_index);
         struct zmk_input_processor_state state = {.input_device_index = listener_index,
@@ -240,7 +423,7 @@ static void clear_xy_data(struct input_listener_xy_data *data) {
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 static void apply_resolution_scaling(struct input_listener_data *data, struct input_event *evt) {
-    int16_t *remainder;
+    int32_t *remainder;
     uint8_t div;
 
     switch (evt->code) {
@@ -256,13 +439,170 @@ static void apply_resolution_scaling(struct input_listener_data *data, struct in
         return;
     }
 
-    int16_t val = evt->value + *remainder;
-    int16_t scaled = val / (int16_t)div;
-    *remainder = val - (scaled * (int16_t)div);
+    int32_t val = evt->value + *remainder;
+    int32_t scaled = val / (int32_t)div;
+    *remainder = val - (scaled * (int32_t)div);
     evt->value = val;
 }
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+// Listeners send from the input thread, and from the report work when rate limited, so two of
+// them can be building a report at the same time. Each adds its deltas to the shared report and
+// sends it while holding this, so neither can clear the other's movement before it was sent.
+static K_MUTEX_DEFINE(mouse_report_lock);
+
+/**
+ * Called with mouse_report_lock held. Adds the data to the HID report, sending the absolute pointer
+ * report right away.
+ *
+ * @returns true if the relative mouse report has to be sent as well.
+ */
+static bool add_to_mouse_report(const struct input_listener_mouse_data *mouse) {
+    if (mouse->wheel_data.mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        zmk_hid_mouse_scroll_update(CLAMP(mouse->wheel_data.x.value, INT16_MIN, INT16_MAX),
+                                    CLAMP(mouse->wheel_data.y.value, INT16_MIN, INT16_MAX));
+    }
+
+    if (mouse->data.mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        zmk_hid_mouse_movement_update(CLAMP(mouse->data.x.value, INT16_MIN, INT16_MAX),
+                                      CLAMP(mouse->data.y.value, INT16_MIN, INT16_MAX));
+    }
+
+    if (mouse->button_set != 0) {
+        for (int i = 0; i < ZMK_HID_MOUSE_NUM_BUTTONS; i++) {
+            if ((mouse->button_set & BIT(i)) != 0) {
+                zmk_hid_mouse_button_press(i);
+            }
+        }
+    }
+
+    if (mouse->button_clear != 0) {
+        for (int i = 0; i < ZMK_HID_MOUSE_NUM_BUTTONS; i++) {
+            if ((mouse->button_clear & BIT(i)) != 0) {
+                zmk_hid_mouse_button_release(i);
+            }
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    if (mouse->data.mode == INPUT_LISTENER_XY_DATA_MODE_ABS) {
+        zmk_hid_abs_pointer_set(mouse->data.x.value, mouse->data.y.value);
+        zmk_endpoints_send_abs_pointer_report();
+
+        // The absolute report carries the buttons too, so only scrolling needs the mouse report.
+        return mouse->wheel_data.mode == INPUT_LISTENER_XY_DATA_MODE_REL;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+
+    return true;
+}
+
+static void send_relative_mouse_report(void) {
+    zmk_endpoints_send_mouse_report();
+    zmk_hid_mouse_scroll_set(0, 0);
+    zmk_hid_mouse_movement_set(0, 0);
+}
+
+static void clear_mouse_data(struct input_listener_mouse_data *mouse) {
+    clear_xy_data(&mouse->data);
+    clear_xy_data(&mouse->wheel_data);
+
+    mouse->button_set = mouse->button_clear = 0;
+}
+
+#if USE_REPORT_RATE_LIMIT
+
+// All listeners share one report interval and one report, so motion from several devices, like the
+// move and scroll instances of mouse keys, goes out together instead of in reports of its own.
+static struct input_listener_data *paced_listeners[DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT)];
+static struct k_spinlock pacing_lock;
+static int64_t last_report_time;
+
+static int64_t report_interval_ms(void) {
+    switch (zmk_endpoints_selected().transport) {
+    case ZMK_TRANSPORT_BLE:
+        return CONFIG_ZMK_INPUT_LISTENER_BLE_REPORT_INTERVAL_MS;
+    case ZMK_TRANSPORT_USB:
+    default:
+        return CONFIG_ZMK_INPUT_LISTENER_USB_REPORT_INTERVAL_MS;
+    }
+}
+
+static bool has_mouse_data(const struct input_listener_mouse_data *mouse) {
+    return mouse->data.mode != INPUT_LISTENER_XY_DATA_MODE_NONE ||
+           mouse->wheel_data.mode != INPUT_LISTENER_XY_DATA_MODE_NONE || mouse->button_set != 0 ||
+           mouse->button_clear != 0;
+}
+
+static void flush_mouse_data(void) {
+    bool send_relative = false;
+
+    k_mutex_lock(&mouse_report_lock, K_FOREVER);
+
+    for (int i = 0; i < ARRAY_SIZE(paced_listeners); i++) {
+        struct input_listener_data *data = paced_listeners[i];
+        struct input_listener_mouse_data mouse;
+
+        if (!data) {
+            continue;
+        }
+
+        K_SPINLOCK(&data->lock) {
+            mouse = data->mouse;
+            clear_mouse_data(&data->mouse);
+        }
+
+        if (has_mouse_data(&mouse)) {
+            send_relative |= add_to_mouse_report(&mouse);
+        }
+    }
+
+    K_SPINLOCK(&pacing_lock) { last_report_time = k_uptime_get(); }
+
+    if (send_relative) {
+        send_relative_mouse_report();
+    }
+
+    k_mutex_unlock(&mouse_report_lock);
+}
+
+static void report_work_cb(struct k_work *work) { flush_mouse_data(); }
+
+static K_WORK_DELAYABLE_DEFINE(report_work, report_work_cb);
+
+/**
+ * Called with data->lock held on each sync. Schedules the accumulated report for when the
+ * endpoint's report interval has passed. Button changes are always sent right away, so a quick
+ * click is never merged into a single report.
+ *
+ * @returns true if the caller should flush the report once it has released the lock.
+ */
+static bool schedule_mouse_report(const struct input_listener_config *config,
+                                  struct input_listener_data *data) {
+    paced_listeners[config->listener_index] = data;
+
+    if (data->mouse.button_set != 0 || data->mouse.button_clear != 0) {
+        return true;
+    }
+
+    int64_t next_report_time;
+
+    K_SPINLOCK(&pacing_lock) { next_report_time = last_report_time + report_interval_ms(); }
+
+    if (k_uptime_get() >= next_report_time) {
+        // Flushed a kernel tick later rather than inline, so the motion of every device synced in
+        // the same pass lands in the same report.
+        k_work_schedule(&report_work, K_TICKS(1));
+    } else {
+        // Keep an already scheduled flush, so continuous motion is reported at the full rate.
+        k_work_schedule(&report_work, K_TIMEOUT_ABS_MS(next_report_time));
+    }
+
+    return false;
+}
+
+#endif // USE_REPORT_RATE_LIMIT
+
 static void input_handler(const struct input_listener_config *config,
                           struct input_listener_data *data, struct input_event *evt) {
     // First, process to update the event data as needed.
@@ -279,6 +619,10 @@ static void input_handler(const struct input_listener_config *config,
     apply_resolution_scaling(data, evt);
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 
+#if USE_REPORT_RATE_LIMIT
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+#endif
+
     switch (evt->type) {
     case INPUT_EV_REL:
         handle_rel_code(data, evt);
@@ -291,41 +635,26 @@ static void input_handler(const struct input_listener_config *config,
         break;
     }
 
-    if (evt->sync) {
-        if (data->mouse.wheel_data.mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
-            zmk_hid_mouse_scroll_set(data->mouse.wheel_data.x.value,
-                                     data->mouse.wheel_data.y.value);
-        }
+#if USE_REPORT_RATE_LIMIT
+    const bool flush = evt->sync && schedule_mouse_report(config, data);
 
-        if (data->mouse.data.mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
-            zmk_hid_mouse_movement_set(data->mouse.data.x.value, data->mouse.data.y.value);
-        }
+    k_spin_unlock(&data->lock, key);
 
-        if (data->mouse.button_set != 0) {
-            for (int i = 0; i < ZMK_HID_MOUSE_NUM_BUTTONS; i++) {
-                if ((data->mouse.button_set & BIT(i)) != 0) {
-                    zmk_hid_mouse_button_press(i);
-                }
-            }
-        }
+    if (flush) {
+        flush_mouse_data();
+    }
+#else
+    if (evt->sync) {
+        k_mutex_lock(&mouse_report_lock, K_FOREVER);
 
-        if (data->mouse.button_clear != 0) {
-            for (int i = 0; i < ZMK_HID_MOUSE_NUM_BUTTONS; i++) {
-                if ((data->mouse.button_clear & BIT(i)) != 0) {
-                    zmk_hid_mouse_button_release(i);
-                }
-            }
+        if (add_to_mouse_report(&data->mouse)) {
+            send_relative_mouse_report();
         }
 
-        zmk_endpoints_send_mouse_report();
-        zmk_hid_mouse_scroll_set(0, 0);
-        zmk_hid_mouse_movement_set(0, 0);
-
-        clear_xy_data(&data->mouse.data);
-        clear_xy_data(&data->mouse.wheel_data);
-
-        data->mouse.button_set = data->mouse.button_clear = 0;
+        k_mutex_unlock(&mouse_report_lock);
+        clear_mouse_data(&data->mouse);
     }
+#endif // USE_REPORT_RATE_LIMIT
 }
 
 #endif // VALID_LISTENER_COUNT > 0
@@ -40,8 +40,20 @@ static int cm_handle_event(const struct device *dev, struct input_event *event,
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
+static int cm_get_mapping(const struct device *dev, uint8_t type, uint32_t param1, uint32_t param2,
+                          struct zmk_input_processor_mapping *mapping) {
+    struct input_event event = {.type = type, .code = mapping->code};
+
+    cm_handle_event(dev, &event, param1, param2, NULL);
+
+    mapping->code = event.code;
+
+    return 0;
+}
+
 static struct zmk_input_processor_driver_api cm_driver_api = {
     .handle_event = cm_handle_event,
+    .get_mapping = cm_get_mapping,
 };
 
 #define TL_INST(n)                                                                                 \
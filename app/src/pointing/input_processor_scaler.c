@@ -22,16 +22,17 @@ struct scaler_config {
 
 static int scale_val(struct input_event *event, uint32_t mul, uint32_t div,
                      struct zmk_input_processor_state *state) {
-    int16_t value_mul = event->value * (int16_t)mul;
+    // Absolute positions use the whole 16 bit range, so the product needs more.
+    int32_t value_mul = event->value * (int32_t)mul;
 
     if (state && state->remainder) {
         value_mul += *state->remainder;
     }
 
-    int16_t scaled = value_mul / (int16_t)div;
+    int32_t scaled = value_mul / (int32_t)div;
 
     if (state && state->remainder) {
-        *state->remainder = value_mul - (scaled * (int16_t)div);
+        *state->remainder = value_mul - (scaled * (int32_t)div);
     }
 
     LOG_DBG("scaled %d with %d/%d to %d with remainder %d", event->value, mul, div, scaled,
@@ -59,8 +60,28 @@ static int scaler_handle_event(const struct device *dev, struct input_event *eve
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
+static int scaler_get_mapping(const struct device *dev, uint8_t type, uint32_t param1,
+                              uint32_t param2, struct zmk_input_processor_mapping *mapping) {
+    const struct scaler_config *cfg = dev->config;
+
+    if (type != cfg->type) {
+        return 0;
+    }
+
+    for (int i = 0; i < cfg->codes_len; i++) {
+        if (cfg->codes[i] == mapping->code) {
+            mapping->mul *= (int16_t)param1;
+            mapping->div *= (int16_t)param2;
+            break;
+        }
+    }
+
+    return 0;
+}
+
 static struct zmk_input_processor_driver_api scaler_driver_api = {
     .handle_event = scaler_handle_event,
+    .get_mapping = scaler_get_mapping,
 };
 
 #define SCALER_INST(n)                                                                             \
@@ -12,6 +12,8 @@
 #include <zephyr/logging/log.h>
 #include <zmk/keymap.h>
 #include <zmk/behavior.h>
+#include <zmk/queue_stats.h>
+#include <zmk/workqueue.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/layer_state_changed.h>
@@ -42,6 +44,12 @@ struct temp_layer_data {
 /* Static Work Queue Items */
 static struct k_work_delayable layer_disable_works[MAX_LAYERS];
 
+// Input events only record when they happened. The disable work is armed once and, when it
+// fires, re-arms itself for whatever is left of the timeout since the latest event.
+static atomic_t layer_last_activity[MAX_LAYERS];
+static atomic_t layer_timeouts[MAX_LAYERS];
+static ATOMIC_DEFINE(layer_disable_armed, MAX_LAYERS);
+
 /* Position Search */
 static bool position_is_excluded(const struct temp_layer_config *config, uint32_t position) {
     if (!config->excluded_positions || !config->num_positions) {
@@ -88,6 +96,9 @@ struct layer_state_action {
 K_MSGQ_DEFINE(temp_layer_action_msgq, sizeof(struct layer_state_action),
               CONFIG_ZMK_INPUT_PROCESSOR_TEMP_LAYER_MAX_ACTION_EVENTS, 4);
 
+ZMK_QUEUE_STATS_DEFINE(temp_layer_action_msgq, "temp layer actions",
+                       CONFIG_ZMK_INPUT_PROCESSOR_TEMP_LAYER_MAX_ACTION_EVENTS);
+
 static void layer_action_work_cb(struct k_work *work) {
 
     const struct device *dev = DEVICE_DT_INST_GET(0);
@@ -116,15 +127,56 @@ static void layer_action_work_cb(struct k_work *work) {
 
 static K_WORK_DEFINE(layer_action_work, layer_action_work_cb);
 
+/* Deadline Tracking */
+static uint32_t layer_time_left(int layer_index) {
+    uint32_t idle = k_uptime_get_32() - (uint32_t)atomic_get(&layer_last_activity[layer_index]);
+    uint32_t timeout = (uint32_t)atomic_get(&layer_timeouts[layer_index]);
+
+    return idle < timeout ? timeout - idle : 0;
+}
+
+static void note_layer_activity(int layer_index, uint32_t timeout_ms) {
+    atomic_set(&layer_last_activity[layer_index], k_uptime_get_32());
+    atomic_set(&layer_timeouts[layer_index], timeout_ms);
+
+    if (!atomic_test_and_set_bit(layer_disable_armed, layer_index)) {
+        k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT),
+                                  &layer_disable_works[layer_index], K_MSEC(timeout_ms));
+    }
+}
+
+static void cancel_layer_disable(int layer_index) {
+    k_work_cancel_delayable(&layer_disable_works[layer_index]);
+    atomic_clear_bit(layer_disable_armed, layer_index);
+}
+
 /* Work Queue Callback */
 static void layer_disable_callback(struct k_work *work) {
     struct k_work_delayable *d_work = k_work_delayable_from_work(work);
     int layer_index = ARRAY_INDEX(layer_disable_works, d_work);
 
+    uint32_t time_left = layer_time_left(layer_index);
+    if (time_left > 0) {
+        k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), d_work,
+                                  K_MSEC(time_left));
+        return;
+    }
+
+    atomic_clear_bit(layer_disable_armed, layer_index);
+
+    // An event between the check and disarming would have seen the work still armed.
+    time_left = layer_time_left(layer_index);
+    if (time_left > 0 && !atomic_test_and_set_bit(layer_disable_armed, layer_index)) {
+        k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), d_work,
+                                  K_MSEC(time_left));
+        return;
+    }
+
     struct layer_state_action action = {.layer = layer_index, .activate = false};
 
-    int ret = k_msgq_put(&temp_layer_action_msgq, &action, K_MSEC(10));
-    k_work_submit(&layer_action_work);
+    int ret = ZMK_QUEUE_STATS_MSGQ_PUT(temp_layer_action_msgq, &temp_layer_action_msgq, &action,
+                                       K_MSEC(10));
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &layer_action_work);
 }
 
 /* Event Handlers */
@@ -137,7 +189,7 @@ static int handle_layer_state_changed(const struct device *dev, const zmk_event_
     if (!zmk_keymap_layer_active(zmk_keymap_layer_index_to_id(data->state.toggle_layer))) {
         LOG_DBG("Deactivating layer that was activated by this processor");
         data->state.is_active = false;
-        k_work_cancel_delayable(&layer_disable_works[data->state.toggle_layer]);
+        cancel_layer_disable(data->state.toggle_layer);
     }
     ret = k_mutex_unlock(&data->lock);
     if (ret < 0) {
@@ -238,6 +290,15 @@ static int temp_layer_handle_event(const struct device *dev, struct input_event
 
     struct temp_layer_data *data = (struct temp_layer_data *)dev->data;
 
+    if (param2 > 0) {
+        note_layer_activity(param1, param2);
+    }
+
+    // Continuous motion with the layer already active needs nothing else.
+    if (data->state.is_active && data->state.toggle_layer == param1) {
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
     int ret = k_mutex_lock(&data->lock, K_FOREVER);
     if (ret < 0) {
         return ret;
@@ -251,12 +312,9 @@ static int temp_layer_handle_event(const struct device *dev, struct input_event
         !should_quick_tap(cfg, data->state.last_tapped_timestamp, k_uptime_get())) {
         struct layer_state_action action = {.layer = param1, .activate = true};
 
-        int ret = k_msgq_put(&temp_layer_action_msgq, &action, K_MSEC(10));
-        k_work_submit(&layer_action_work);
-    }
-
-    if (param2 > 0) {
-        k_work_reschedule(&layer_disable_works[param1], K_MSEC(param2));
+        int ret = ZMK_QUEUE_STATS_MSGQ_PUT(temp_layer_action_msgq, &temp_layer_action_msgq,
+                                           &action, K_MSEC(10));
+        k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &layer_action_work);
     }
 
     k_mutex_unlock(&data->lock);
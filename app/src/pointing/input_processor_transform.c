@@ -68,8 +68,21 @@ static int ipt_handle_event(const struct device *dev, struct input_event *event,
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
+static int ipt_get_mapping(const struct device *dev, uint8_t type, uint32_t param1,
+                           uint32_t param2, struct zmk_input_processor_mapping *mapping) {
+    struct input_event event = {.type = type, .code = mapping->code, .value = 1};
+
+    ipt_handle_event(dev, &event, param1, param2, NULL);
+
+    mapping->code = event.code;
+    mapping->mul *= event.value;
+
+    return 0;
+}
+
 static struct zmk_input_processor_driver_api ipt_driver_api = {
     .handle_event = ipt_handle_event,
+    .get_mapping = ipt_get_mapping,
 };
 
 static int ipt_init(const struct device *dev) { return 0; }
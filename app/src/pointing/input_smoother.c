@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_input_smoother
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Motion from a split peripheral arrives in bursts, one per connection interval. Each burst is
+// spread over the time the next one is expected to take, so the cursor moves at the estimated
+// velocity instead of jumping. Only motion that was actually received is ever emitted, so the
+// cost is up to one frame interval of extra latency rather than overshoot.
+
+// Frame interval estimates are kept with this many fractional bits.
+#define INTERVAL_FRACTION_BITS 4
+
+struct input_smoother_config {
+    uint16_t emit_interval_ms;
+    uint16_t max_frame_interval_ms;
+};
+
+struct input_smoother_data {
+    const struct device *dev;
+    struct k_spinlock lock;
+    struct k_work_delayable emit_work;
+    int64_t last_frame_time;
+    uint32_t frame_interval;
+    // Motion of the frame currently being received, until its sync event.
+    int32_t pending_x;
+    int32_t pending_y;
+    // Motion received but not emitted yet, and the number of steps left to emit it in.
+    int32_t remaining_x;
+    int32_t remaining_y;
+    uint16_t steps_left;
+};
+
+static void report_motion(const struct device *dev, int32_t x, int32_t y) {
+    if (x != 0) {
+        input_report_rel(dev, INPUT_REL_X, x, y == 0, K_NO_WAIT);
+    }
+
+    if (y != 0) {
+        input_report_rel(dev, INPUT_REL_Y, y, true, K_NO_WAIT);
+    }
+}
+
+static void emit_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct input_smoother_data *data = CONTAINER_OF(dwork, struct input_smoother_data, emit_work);
+    const struct input_smoother_config *config = data->dev->config;
+    int32_t x = 0, y = 0;
+    bool more = false;
+
+    K_SPINLOCK(&data->lock) {
+        if (data->steps_left == 0) {
+            K_SPINLOCK_BREAK;
+        }
+
+        // Dividing what is left keeps the rounding error from ever adding up past one step.
+        x = data->remaining_x / data->steps_left;
+        y = data->remaining_y / data->steps_left;
+        data->remaining_x -= x;
+        data->remaining_y -= y;
+        data->steps_left--;
+        more = data->steps_left > 0;
+    }
+
+    report_motion(data->dev, x, y);
+
+    if (more) {
+        k_work_schedule(&data->emit_work, K_MSEC(config->emit_interval_ms));
+    }
+}
+
+static void handle_frame(const struct device *dev) {
+    const struct input_smoother_config *config = dev->config;
+    struct input_smoother_data *data = dev->data;
+
+    K_SPINLOCK(&data->lock) {
+        const int64_t now = k_uptime_get();
+        const int64_t interval = now - data->last_frame_time;
+
+        data->last_frame_time = now;
+
+        // A long gap is the start of a new movement, not a slower one, so it isn't counted.
+        if (interval > 0 && interval <= config->max_frame_interval_ms) {
+            data->frame_interval +=
+                (((uint32_t)interval << INTERVAL_FRACTION_BITS) - data->frame_interval) >> 2;
+        }
+
+        const uint32_t emit_interval = config->emit_interval_ms << INTERVAL_FRACTION_BITS;
+
+        data->remaining_x += data->pending_x;
+        data->remaining_y += data->pending_y;
+        data->pending_x = 0;
+        data->pending_y = 0;
+        data->steps_left = MAX(1, (data->frame_interval + emit_interval / 2) / emit_interval);
+    }
+
+    // The first step goes out right away, the rest follow every emit interval.
+    k_work_reschedule(&data->emit_work, K_NO_WAIT);
+}
+
+static void flush(const struct device *dev) {
+    struct input_smoother_data *data = dev->data;
+    struct k_work_sync sync;
+    int32_t x, y;
+
+    k_work_cancel_delayable_sync(&data->emit_work, &sync);
+
+    K_SPINLOCK(&data->lock) {
+        x = data->remaining_x + data->pending_x;
+        y = data->remaining_y + data->pending_y;
+        data->remaining_x = 0;
+        data->remaining_y = 0;
+        data->pending_x = 0;
+        data->pending_y = 0;
+        data->steps_left = 0;
+    }
+
+    report_motion(dev, x, y);
+}
+
+static void input_smoother_handle_event(const struct device *dev, struct input_event *evt) {
+    struct input_smoother_data *data = dev->data;
+
+    if (evt->type == INPUT_EV_REL && (evt->code == INPUT_REL_X || evt->code == INPUT_REL_Y)) {
+        K_SPINLOCK(&data->lock) {
+            if (evt->code == INPUT_REL_X) {
+                data->pending_x += evt->value;
+            } else {
+                data->pending_y += evt->value;
+            }
+        }
+
+        if (evt->sync) {
+            handle_frame(dev);
+        }
+
+        return;
+    }
+
+    // Everything else, e.g. buttons and scrolling, is passed through as soon as the motion before
+    // it has been caught up on.
+    flush(dev);
+    input_report(dev, evt->type, evt->code, evt->value, evt->sync, K_NO_WAIT);
+}
+
+static int input_smoother_init(const struct device *dev) {
+    const struct input_smoother_config *config = dev->config;
+    struct input_smoother_data *data = dev->data;
+
+    data->dev = dev;
+    // Until a frame interval has been measured, motion is passed on as it arrives.
+    data->frame_interval = config->emit_interval_ms << INTERVAL_FRACTION_BITS;
+    k_work_init_delayable(&data->emit_work, emit_work_cb);
+
+    return 0;
+}
+
+#define INPUT_SMOOTHER_INST(n)                                                                     \
+    BUILD_ASSERT(DT_INST_PROP(n, emit_interval_ms) > 0,                                            \
+                 "Input smoothers need an `emit-interval-ms` of at least 1");                      \
+    static struct input_smoother_data input_smoother_data_##n = {};                                \
+    static const struct input_smoother_config input_smoother_config_##n = {                        \
+        .emit_interval_ms = DT_INST_PROP(n, emit_interval_ms),                                     \
+        .max_frame_interval_ms = DT_INST_PROP(n, max_frame_interval_ms),                           \
+    };                                                                                             \
+    static void input_smoother_cb_##n(struct input_event *evt) {                                   \
+        input_smoother_handle_event(DEVICE_DT_INST_GET(n), evt);                                   \
+    }                                                                                              \
+    INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_INST_PHANDLE(n, device)), input_smoother_cb_##n);       \
+    DEVICE_DT_INST_DEFINE(n, input_smoother_init, NULL, &input_smoother_data_##n,                  \
+                          &input_smoother_config_##n, POST_KERNEL,                                 \
+                          CONFIG_ZMK_INPUT_SMOOTHER_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(INPUT_SMOOTHER_INST)
@@ -6,6 +6,8 @@
 
 #define DT_DRV_COMPAT zmk_input_split
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/input/input.h>
@@ -46,6 +48,131 @@ int zmk_input_split_report_peripheral_event(uint8_t reg, uint8_t type, uint16_t
 
 #include <zmk/split/peripheral.h>
 
+static void report_split_input(uint8_t reg, uint8_t type, uint16_t code, int32_t value,
+                               bool sync) {
+    struct zmk_split_transport_peripheral_event ev = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,
+        .data = {.input_event = {
+                     .reg = reg,
+                     .type = type,
+                     .code = code,
+                     .value = value,
+                     .sync = sync,
+                 }}};
+    zmk_split_peripheral_report_event(&ev);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT_AGGREGATE_MOTION)
+
+// Relative motion is summed between sends, so a fast sensor costs at most one event per axis each
+// interval instead of one per sample. The central sees the same synced events it always has.
+static const uint16_t zis_motion_codes[] = {INPUT_REL_X, INPUT_REL_Y, INPUT_REL_WHEEL,
+                                            INPUT_REL_HWHEEL};
+
+struct zis_motion {
+    uint8_t reg;
+    struct k_spinlock lock;
+    struct k_work_delayable work;
+    bool work_initialized;
+    int64_t last_send_time;
+    int32_t sums[ARRAY_SIZE(zis_motion_codes)];
+};
+
+static int zis_motion_index(const struct input_event *evt) {
+    if (evt->type != INPUT_EV_REL) {
+        return -ENOTSUP;
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(zis_motion_codes); i++) {
+        if (zis_motion_codes[i] == evt->code) {
+            return i;
+        }
+    }
+
+    return -ENOTSUP;
+}
+
+static void zis_motion_flush(struct zis_motion *motion) {
+    int32_t sums[ARRAY_SIZE(zis_motion_codes)];
+
+    K_SPINLOCK(&motion->lock) {
+        memcpy(sums, motion->sums, sizeof(sums));
+        memset(motion->sums, 0, sizeof(motion->sums));
+        motion->last_send_time = k_uptime_get();
+    }
+
+    int last = -1;
+    for (int i = 0; i < ARRAY_SIZE(sums); i++) {
+        if (sums[i] != 0) {
+            last = i;
+        }
+    }
+
+    for (int i = 0; i <= last; i++) {
+        if (sums[i] != 0) {
+            report_split_input(motion->reg, INPUT_EV_REL, zis_motion_codes[i], sums[i], i == last);
+        }
+    }
+}
+
+static void zis_motion_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct zis_motion *motion = CONTAINER_OF(dwork, struct zis_motion, work);
+
+    zis_motion_flush(motion);
+}
+
+/**
+ * Adds a processed event to the pending motion, scheduling a send for when the interval since
+ * the previous one has passed.
+ *
+ * @returns true if the event was taken, or false if the caller should forward it as is. Any
+ * pending motion has been sent by then, so it stays ordered before e.g. a button press.
+ */
+static bool zis_motion_handle(struct zis_motion *motion, const struct input_event *evt) {
+    if (!motion->work_initialized) {
+        k_work_init_delayable(&motion->work, zis_motion_work_cb);
+        motion->work_initialized = true;
+    }
+
+    const int idx = zis_motion_index(evt);
+    if (idx < 0) {
+        struct k_work_sync sync;
+
+        k_work_cancel_delayable_sync(&motion->work, &sync);
+        zis_motion_flush(motion);
+        return false;
+    }
+
+    int64_t next_send_time;
+
+    K_SPINLOCK(&motion->lock) {
+        motion->sums[idx] += evt->value;
+        next_send_time =
+            motion->last_send_time + CONFIG_ZMK_INPUT_SPLIT_AGGREGATE_MOTION_INTERVAL_MS;
+    }
+
+    if (evt->sync) {
+        // Keep an already scheduled send, so continuous motion goes out at the full rate.
+        k_work_schedule(&motion->work, K_TIMEOUT_ABS_MS(next_send_time));
+    }
+
+    return true;
+}
+
+#define ZIS_MOTION_DEFINE(n) static struct zis_motion motion_##n = {.reg = DT_INST_REG_ADDR(n)};
+#define ZIS_MOTION_HANDLE(n, evt)                                                                  \
+    if (zis_motion_handle(&motion_##n, evt)) {                                                     \
+        return;                                                                                    \
+    }
+
+#else
+
+#define ZIS_MOTION_DEFINE(n)
+#define ZIS_MOTION_HANDLE(n, evt)
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT_AGGREGATE_MOTION)
+
 #define ZIS_INST(n)                                                                                \
     static const struct zmk_input_processor_entry processors_##n[] =                               \
         COND_CODE_1(DT_INST_NODE_HAS_PROP(n, input_processors),                                    \
@@ -54,6 +181,7 @@ int zmk_input_split_report_peripheral_event(uint8_t reg, uint8_t type, uint16_t
                     ({}));                                                                         \
     BUILD_ASSERT(DT_INST_NODE_HAS_PROP(n, device),                                                 \
                  "Peripheral input splits need an `input` property set");                          \
+    ZIS_MOTION_DEFINE(n)                                                                           \
     void split_input_handler_##n(struct input_event *evt) {                                        \
         for (size_t i = 0; i < ARRAY_SIZE(processors_##n); i++) {                                  \
             int ret = zmk_input_processor_handle_event(processors_##n[i].dev, evt,                 \
@@ -63,16 +191,8 @@ int zmk_input_split_report_peripheral_event(uint8_t reg, uint8_t type, uint16_t
                 return;                                                                            \
             }                                                                                      \
         }                                                                                          \
-        struct zmk_split_transport_peripheral_event ev = {                                         \
-            .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,                         \
-            .data = {.input_event = {                                                              \
-                         .reg = DT_INST_REG_ADDR(n),                                               \
-                         .type = evt->type,                                                        \
-                         .code = evt->code,                                                        \
-                         .value = evt->value,                                                      \
-                         .sync = evt->sync,                                                        \
-                     }}};                                                                          \
-        zmk_split_peripheral_report_event(&ev);                                                    \
+        ZIS_MOTION_HANDLE(n, evt)                                                                  \
+        report_split_input(DT_INST_REG_ADDR(n), evt->type, evt->code, evt->value, evt->sync);      \
     }                                                                                              \
     INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_INST_PHANDLE(n, device)), split_input_handler_##n);
 
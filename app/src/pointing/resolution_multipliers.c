@@ -4,17 +4,109 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
 #include <zephyr/logging/log.h>
 
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
 #include <zmk/pointing/resolution_multipliers.h>
+#include <zmk/settings.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 static struct zmk_pointing_resolution_multipliers multipliers[ZMK_ENDPOINT_COUNT];
 
+#if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING_CACHE_MULTIPLIERS)
+
+// Hosts don't always set the feature report again when they reconnect, so the last multipliers
+// each one negotiated are kept in settings and used until it does. Endpoint indexes may change
+// between firmware versions, so the settings are named after the transport and profile instead.
+
+static ATOMIC_DEFINE(multipliers_dirty, ZMK_ENDPOINT_COUNT);
+
+static void multipliers_setting_name(char *name, size_t len,
+                                     struct zmk_endpoint_instance endpoint) {
+    switch (endpoint.transport) {
+    case ZMK_TRANSPORT_BLE:
+        snprintf(name, len, "pointing/res_mult/ble/%d", endpoint.ble.profile_index);
+        break;
+    case ZMK_TRANSPORT_USB:
+    default:
+        snprintf(name, len, "pointing/res_mult/usb");
+        break;
+    }
+}
+
+static void save_endpoint_multipliers(struct zmk_endpoint_instance endpoint) {
+    const int profile = zmk_endpoint_instance_to_index(endpoint);
+    char name[32];
+
+    if (!atomic_test_and_clear_bit(multipliers_dirty, profile)) {
+        return;
+    }
+
+    multipliers_setting_name(name, sizeof(name), endpoint);
+
+    int err = settings_save_one(name, &multipliers[profile], sizeof(multipliers[profile]));
+    if (err < 0) {
+        LOG_ERR("Failed to save resolution multipliers %s (err %d)", name, err);
+    }
+}
+
+static void multipliers_save_cb(void) {
+#if IS_ENABLED(CONFIG_ZMK_USB)
+    save_endpoint_multipliers((struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_USB});
+#endif // IS_ENABLED(CONFIG_ZMK_USB)
+
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        save_endpoint_multipliers((struct zmk_endpoint_instance){
+            .transport = ZMK_TRANSPORT_BLE, .ble = {.profile_index = i}});
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BLE)
+}
+
+ZMK_SETTINGS_SAVE_DEFINE(multipliers_save, multipliers_save_cb);
+
+static int multipliers_handle_set(const char *name, size_t len, settings_read_cb read_cb,
+                                  void *cb_arg) {
+    struct zmk_endpoint_instance endpoint = {.transport = ZMK_TRANSPORT_USB};
+    const char *next;
+
+    if (settings_name_steq(name, "ble", &next) && next) {
+        endpoint = (struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_BLE,
+                                                  .ble = {.profile_index = strtol(next, NULL, 10)}};
+
+        if (endpoint.ble.profile_index < 0 ||
+            endpoint.ble.profile_index >= ZMK_ENDPOINT_BLE_COUNT) {
+            LOG_WRN("Ignoring resolution multipliers for unknown profile %s", next);
+            return 0;
+        }
+    } else if (!settings_name_steq(name, "usb", &next) || next) {
+        return -ENOENT;
+    } else if (!IS_ENABLED(CONFIG_ZMK_USB)) {
+        return 0;
+    }
+
+    if (len != sizeof(struct zmk_pointing_resolution_multipliers)) {
+        return -EINVAL;
+    }
+
+    int err = read_cb(cb_arg, &multipliers[zmk_endpoint_instance_to_index(endpoint)],
+                      sizeof(struct zmk_pointing_resolution_multipliers));
+
+    return MIN(err, 0);
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(resolution_multipliers, "pointing/res_mult", NULL,
+                               multipliers_handle_set, NULL, NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING_CACHE_MULTIPLIERS)
+
 struct zmk_pointing_resolution_multipliers
 zmk_pointing_resolution_multipliers_get_current_profile(void) {
     return zmk_pointing_resolution_multipliers_get_profile(zmk_endpoints_selected());
@@ -33,7 +125,15 @@ void zmk_pointing_resolution_multipliers_set_profile(struct zmk_pointing_resolut
     // This write is not happening on the main thread. To prevent potential data races, every
     // operation involving hid_indicators must be atomic. Currently, each function either reads
     // or writes only one entry at a time, so it is safe to do these operations without a lock.
+#if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING_CACHE_MULTIPLIERS)
+    if (multipliers[profile].wheel != m.wheel || multipliers[profile].hor_wheel != m.hor_wheel) {
+        multipliers[profile] = m;
+        atomic_set_bit(multipliers_dirty, profile);
+        zmk_settings_save_schedule(&multipliers_save);
+    }
+#else
     multipliers[profile] = m;
+#endif
 }
 
 void zmk_pointing_resolution_multipliers_process_report(
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_ZMK_QUEUE_STATS_SHELL)
+#include <zephyr/shell/shell.h>
+#endif // IS_ENABLED(CONFIG_ZMK_QUEUE_STATS_SHELL)
+
+#include <zmk/queue_stats.h>
+
+// Queues are filled from ISRs and threads alike, and read from the shell.
+static struct k_spinlock lock;
+
+void zmk_queue_stats_record_put(struct zmk_queue_stats *stats, uint32_t used) {
+    K_SPINLOCK(&lock) {
+        stats->queued++;
+        stats->high_watermark = MAX(stats->high_watermark, used);
+    }
+}
+
+void zmk_queue_stats_record_overflow(struct zmk_queue_stats *stats) {
+    K_SPINLOCK(&lock) {
+        stats->overflows++;
+        // A queue that overflowed was full, even if no put saw it so.
+        stats->high_watermark = stats->capacity;
+    }
+}
+
+int zmk_queue_stats_msgq_put(struct zmk_queue_stats *stats, struct k_msgq *msgq, const void *data,
+                             k_timeout_t timeout) {
+    int ret = k_msgq_put(msgq, data, timeout);
+
+    if (ret < 0) {
+        zmk_queue_stats_record_overflow(stats);
+    } else {
+        zmk_queue_stats_record_put(stats, k_msgq_num_used_get(msgq));
+    }
+
+    return ret;
+}
+
+int zmk_queue_stats_get(size_t index, struct zmk_queue_stats *stats) {
+    size_t count;
+
+    STRUCT_SECTION_COUNT(zmk_queue_stats, &count);
+    if (index >= count) {
+        return -ENOENT;
+    }
+
+    struct zmk_queue_stats *entry;
+
+    STRUCT_SECTION_GET(zmk_queue_stats, index, &entry);
+    K_SPINLOCK(&lock) { *stats = *entry; }
+
+    return 0;
+}
+
+void zmk_queue_stats_clear(void) {
+    STRUCT_SECTION_FOREACH(zmk_queue_stats, stats) {
+        K_SPINLOCK(&lock) {
+            stats->queued = 0;
+            stats->overflows = 0;
+            stats->high_watermark = 0;
+        }
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_QUEUE_STATS_SHELL)
+
+static int cmd_queue_show(const struct shell *sh, size_t argc, char **argv) {
+    struct zmk_queue_stats stats;
+
+    shell_print(sh, "%-28s %8s %10s %8s %10s", "queue", "size", "queued", "lost", "watermark");
+
+    for (size_t i = 0; zmk_queue_stats_get(i, &stats) == 0; i++) {
+        shell_print(sh, "%-28s %8u %10u %8u %10u", stats.name, stats.capacity, stats.queued,
+                    stats.overflows, stats.high_watermark);
+    }
+
+    return 0;
+}
+
+static int cmd_queue_clear(const struct shell *sh, size_t argc, char **argv) {
+    zmk_queue_stats_clear();
+    shell_print(sh, "Queue statistics cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_queue,
+                               SHELL_CMD(show, NULL, "Print the counters of each bounded queue",
+                                         cmd_queue_show),
+                               SHELL_CMD(clear, NULL, "Reset the queue counters", cmd_queue_clear),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(queue, &sub_queue, "ZMK queue overflow and high watermark counters", NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_QUEUE_STATS_SHELL)
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_rgb_per_key
+
+#include <zephyr/device.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/drivers/led_strip.h>
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/physical_layouts.h>
+#include <zmk/workqueue.h>
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_LAYER_HIGHLIGHT) ||                                          \
+    IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_MODIFIERS)
+#define USE_KEYMAP 1
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+#include <zmk/keys.h>
+#include <zmk/events/layer_state_changed.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_MODIFIERS)
+#include <zmk/hid.h>
+#include <zmk/events/keycode_state_changed.h>
+#endif
+
+// Every effect works out which LEDs it changes on a frame, and only those LEDs are drawn again.
+// Frames are only produced while an effect is animating or something changed, so an idle board
+// costs nothing beyond the events it listens to.
+
+#define STRIP_NODE DT_INST_PHANDLE(0, led_strip)
+#define STRIP_NUM_PIXELS DT_PROP(STRIP_NODE, chain_length)
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW) && DT_HAS_CHOSEN(zmk_underglow)
+BUILD_ASSERT(!DT_SAME_NODE(DT_CHOSEN(zmk_underglow), STRIP_NODE),
+             "Underglow and per-key RGB can't share an LED strip");
+#endif
+
+#if DT_INST_NODE_HAS_PROP(0, key_positions)
+BUILD_ASSERT(DT_INST_PROP_LEN(0, key_positions) == STRIP_NUM_PIXELS,
+             "Per-key RGB needs one entry in `key-positions` for every LED of the strip");
+
+static const uint16_t led_positions[STRIP_NUM_PIXELS] = DT_INST_PROP(0, key_positions);
+#define LED_POSITION(led) led_positions[led]
+#else
+#define LED_POSITION(led) (led)
+#endif
+
+#define RGB_FROM_HEX(hex)                                                                          \
+    ((struct led_rgb){r : ((hex) >> 16) & 0xFF, g : ((hex) >> 8) & 0xFF, b : (hex) & 0xFF})
+
+enum per_key_change {
+    PER_KEY_CHANGE_LAYOUT,
+    PER_KEY_CHANGE_LAYERS,
+    PER_KEY_CHANGE_MODIFIERS,
+    PER_KEY_CHANGE_NUMBER,
+};
+
+struct rgb_per_key_effect {
+    // Marks the LEDs whose colour changes on this frame.
+    // @returns true while the effect needs more frames to animate.
+    bool (*update)(int64_t now);
+    // Draws one LED over the colour drawn by the effects before it in the table.
+    void (*render)(uint16_t led, struct led_rgb *rgb);
+};
+
+static const struct device *const led_strip = DEVICE_DT_GET(STRIP_NODE);
+
+static struct led_rgb pixels[STRIP_NUM_PIXELS];
+
+// Centre of the key each LED shows, in hundredths of a key, or INT16_MIN if it has no key.
+static int16_t led_x[STRIP_NUM_PIXELS];
+static int16_t led_y[STRIP_NUM_PIXELS];
+
+static const struct zmk_physical_layout *layout;
+
+static ATOMIC_DEFINE(dirty_leds, STRIP_NUM_PIXELS);
+static ATOMIC_DEFINE(pending_changes, PER_KEY_CHANGE_NUMBER);
+
+static void frame_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(frame_work, frame_work_cb);
+
+static void request_frame(enum per_key_change change) {
+    atomic_set_bit(pending_changes, change);
+    k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &frame_work,
+                              K_NO_WAIT);
+}
+
+static void mark_dirty(uint16_t led) { atomic_set_bit(dirty_leds, led); }
+
+static void mark_all_dirty(void) {
+    for (uint16_t led = 0; led < STRIP_NUM_PIXELS; led++) {
+        mark_dirty(led);
+    }
+}
+
+static void update_layout(void) {
+    struct zmk_physical_layout const *const *layouts;
+    const size_t layouts_len = zmk_physical_layouts_get_list(&layouts);
+    const int selected = zmk_physical_layouts_get_selected();
+
+    layout = (selected >= 0 && (size_t)selected < layouts_len) ? layouts[selected] : NULL;
+
+    for (uint16_t led = 0; led < STRIP_NUM_PIXELS; led++) {
+        const uint32_t position = LED_POSITION(led);
+
+        if (!layout || !layout->keys || position >= layout->keys_len) {
+            led_x[led] = INT16_MIN;
+            led_y[led] = INT16_MIN;
+            continue;
+        }
+
+        const struct zmk_key_physical_attrs *key = &layout->keys[position];
+        led_x[led] = key->x + key->width / 2;
+        led_y[led] = key->y + key->height / 2;
+    }
+
+    mark_all_dirty();
+}
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_RIPPLE)
+
+#define RIPPLE_WIDTH CONFIG_ZMK_RGB_PER_KEY_RIPPLE_WIDTH
+
+struct ripple {
+    int64_t start;
+    // Centre of the key the ripple started from, which may be a key without an LED.
+    int16_t x;
+    int16_t y;
+    // Radius the ripple was last drawn at, in hundredths of a key, or -1 before its first frame.
+    int32_t radius;
+    bool active;
+};
+
+static struct k_spinlock ripple_lock;
+static struct ripple ripples[CONFIG_ZMK_RGB_PER_KEY_RIPPLE_MAX];
+static uint8_t next_ripple;
+
+static bool ripple_covers(const struct ripple *ripple, uint16_t led) {
+    if (ripple->radius < 0 || led_x[led] == INT16_MIN) {
+        return false;
+    }
+
+    const int32_t dx = led_x[led] - ripple->x;
+    const int32_t dy = led_y[led] - ripple->y;
+    const int32_t distance_sq = dx * dx + dy * dy;
+    const int32_t inner = MAX(0, ripple->radius - RIPPLE_WIDTH / 2);
+    const int32_t outer = ripple->radius + RIPPLE_WIDTH / 2;
+
+    return distance_sq >= inner * inner && distance_sq <= outer * outer;
+}
+
+// Only the LEDs whose state differs between the old and the new ring are drawn again, which is
+// the edges of the ring rather than every LED it covers.
+static void ripple_mark_changes(const struct ripple *before, const struct ripple *after) {
+    for (uint16_t led = 0; led < STRIP_NUM_PIXELS; led++) {
+        if (ripple_covers(before, led) != ripple_covers(after, led)) {
+            mark_dirty(led);
+        }
+    }
+}
+
+static bool ripple_update(int64_t now) {
+    bool animating = false;
+
+    K_SPINLOCK(&ripple_lock) {
+        for (int i = 0; i < ARRAY_SIZE(ripples); i++) {
+            struct ripple *ripple = &ripples[i];
+
+            if (!ripple->active) {
+                continue;
+            }
+
+            const struct ripple before = *ripple;
+            const int64_t elapsed = now - ripple->start;
+
+            if (elapsed >= CONFIG_ZMK_RGB_PER_KEY_RIPPLE_DURATION_MS) {
+                ripple->active = false;
+                ripple->radius = -1;
+            } else {
+                ripple->radius = elapsed * CONFIG_ZMK_RGB_PER_KEY_RIPPLE_SPEED * 100 / 1000;
+                animating = true;
+            }
+
+            if (ripple->radius != before.radius) {
+                ripple_mark_changes(&before, ripple);
+            }
+        }
+    }
+
+    return animating;
+}
+
+static void ripple_render(uint16_t led, struct led_rgb *rgb) {
+    bool lit = false;
+
+    K_SPINLOCK(&ripple_lock) {
+        for (int i = 0; i < ARRAY_SIZE(ripples) && !lit; i++) {
+            lit = ripples[i].active && ripple_covers(&ripples[i], led);
+        }
+    }
+
+    if (lit) {
+        *rgb = RGB_FROM_HEX(CONFIG_ZMK_RGB_PER_KEY_RIPPLE_COLOR);
+    }
+}
+
+static void ripple_start(uint32_t position, int64_t timestamp) {
+    const struct zmk_physical_layout *current = layout;
+
+    if (!current || !current->keys || position >= current->keys_len) {
+        return;
+    }
+
+    const struct zmk_key_physical_attrs *key = &current->keys[position];
+
+    K_SPINLOCK(&ripple_lock) {
+        struct ripple *ripple = &ripples[next_ripple];
+
+        // Reusing the oldest ripple when all are in use leaves its ring behind, so clear it.
+        if (ripple->active) {
+            const struct ripple before = *ripple;
+
+            ripple->radius = -1;
+            ripple_mark_changes(&before, ripple);
+        }
+
+        *ripple = (struct ripple){
+            .start = timestamp,
+            .x = key->x + key->width / 2,
+            .y = key->y + key->height / 2,
+            .radius = -1,
+            .active = true,
+        };
+        next_ripple = (next_ripple + 1) % ARRAY_SIZE(ripples);
+    }
+
+    k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &frame_work,
+                              K_NO_WAIT);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_RIPPLE)
+
+#if USE_KEYMAP
+
+// The layer and the modifiers of the binding each LED's key currently resolves to. These only
+// change with the layer state, so they are looked up once per layer change instead of per frame.
+static zmk_keymap_layer_id_t led_layer[STRIP_NUM_PIXELS];
+static zmk_mod_flags_t led_mods[STRIP_NUM_PIXELS];
+
+static bool is_transparent(const struct zmk_behavior_binding *binding) {
+    return !binding || !binding->behavior_dev || strstr(binding->behavior_dev, "transparent");
+}
+
+static zmk_mod_flags_t binding_mods(const struct zmk_behavior_binding *binding) {
+    if (!binding || !binding->behavior_dev || !strstr(binding->behavior_dev, "key_press")) {
+        return 0;
+    }
+
+    const uint16_t page =
+        ZMK_HID_USAGE_PAGE(binding->param1) ? ZMK_HID_USAGE_PAGE(binding->param1) : HID_USAGE_KEY;
+    const uint16_t id = ZMK_HID_USAGE_ID(binding->param1);
+
+    return is_mod(page, id) ? BIT(id - HID_USAGE_KEY_KEYBOARD_LEFTCONTROL) : 0;
+}
+
+static void update_bindings(void) {
+    for (uint16_t led = 0; led < STRIP_NUM_PIXELS; led++) {
+        const uint32_t position = LED_POSITION(led);
+        zmk_keymap_layer_id_t layer = ZMK_KEYMAP_LAYER_ID_INVAL;
+        const struct zmk_behavior_binding *binding = NULL;
+
+        for (int index = ZMK_KEYMAP_LAYERS_LEN - 1; index >= 0; index--) {
+            const zmk_keymap_layer_id_t id = zmk_keymap_layer_index_to_id(index);
+
+            if (id == ZMK_KEYMAP_LAYER_ID_INVAL || !zmk_keymap_layer_active(id)) {
+                continue;
+            }
+
+            binding = zmk_keymap_get_layer_binding_at_idx(id, position);
+            if (!is_transparent(binding)) {
+                layer = id;
+                break;
+            }
+        }
+
+        const zmk_mod_flags_t mods = layer == ZMK_KEYMAP_LAYER_ID_INVAL ? 0 : binding_mods(binding);
+
+        if (layer != led_layer[led] || mods != led_mods[led]) {
+            led_layer[led] = layer;
+            led_mods[led] = mods;
+            mark_dirty(led);
+        }
+    }
+}
+
+#endif // USE_KEYMAP
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_LAYER_HIGHLIGHT)
+
+static void layer_render(uint16_t led, struct led_rgb *rgb) {
+    const zmk_keymap_layer_id_t layer = led_layer[led];
+
+    if (layer != ZMK_KEYMAP_LAYER_ID_INVAL && layer != zmk_keymap_layer_default()) {
+        *rgb = RGB_FROM_HEX(CONFIG_ZMK_RGB_PER_KEY_LAYER_COLOR);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_LAYER_HIGHLIGHT)
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_MODIFIERS)
+
+static zmk_mod_flags_t shown_mods;
+
+static bool modifier_update(int64_t now) {
+    if (!atomic_test_and_clear_bit(pending_changes, PER_KEY_CHANGE_MODIFIERS)) {
+        return false;
+    }
+
+    const zmk_mod_flags_t mods = zmk_hid_get_explicit_mods();
+    const zmk_mod_flags_t changed = mods ^ shown_mods;
+
+    shown_mods = mods;
+
+    for (uint16_t led = 0; changed && led < STRIP_NUM_PIXELS; led++) {
+        if (led_mods[led] & changed) {
+            mark_dirty(led);
+        }
+    }
+
+    return false;
+}
+
+static void modifier_render(uint16_t led, struct led_rgb *rgb) {
+    if (led_mods[led] & shown_mods) {
+        *rgb = RGB_FROM_HEX(CONFIG_ZMK_RGB_PER_KEY_MODIFIER_COLOR);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_MODIFIERS)
+
+// Effects later in the table are drawn on top of the ones before them.
+static const struct rgb_per_key_effect effects[] = {
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_LAYER_HIGHLIGHT)
+    {.render = layer_render},
+#endif
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_MODIFIERS)
+    {.update = modifier_update, .render = modifier_render},
+#endif
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_RIPPLE)
+    {.update = ripple_update, .render = ripple_render},
+#endif
+};
+
+static void frame_work_cb(struct k_work *work) {
+    const int64_t now = k_uptime_get();
+    bool animating = false;
+    bool changed = false;
+
+    if (atomic_test_and_clear_bit(pending_changes, PER_KEY_CHANGE_LAYOUT)) {
+        update_layout();
+    }
+
+#if USE_KEYMAP
+    if (atomic_test_and_clear_bit(pending_changes, PER_KEY_CHANGE_LAYERS)) {
+        update_bindings();
+    }
+#endif
+
+    for (int i = 0; i < ARRAY_SIZE(effects); i++) {
+        if (effects[i].update && effects[i].update(now)) {
+            animating = true;
+        }
+    }
+
+    for (uint16_t led = 0; led < STRIP_NUM_PIXELS; led++) {
+        if (!atomic_test_and_clear_bit(dirty_leds, led)) {
+            continue;
+        }
+
+        struct led_rgb rgb = RGB_FROM_HEX(CONFIG_ZMK_RGB_PER_KEY_BASE_COLOR);
+
+        for (int i = 0; i < ARRAY_SIZE(effects); i++) {
+            effects[i].render(led, &rgb);
+        }
+
+        pixels[led] = rgb;
+        changed = true;
+    }
+
+    if (changed) {
+        int err = led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
+        if (err < 0) {
+            LOG_ERR("Failed to update the per-key RGB strip (%d)", err);
+        }
+    }
+
+    if (animating) {
+        k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &frame_work,
+                                  K_MSEC(CONFIG_ZMK_RGB_PER_KEY_FRAME_INTERVAL_MS));
+    }
+}
+
+static int rgb_per_key_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *pos_ev = as_zmk_position_state_changed(eh);
+    if (pos_ev) {
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_RIPPLE)
+        if (pos_ev->state) {
+            ripple_start(pos_ev->position, pos_ev->timestamp);
+        }
+#endif
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (as_zmk_physical_layout_selection_changed(eh)) {
+        request_frame(PER_KEY_CHANGE_LAYOUT);
+        request_frame(PER_KEY_CHANGE_LAYERS);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+#if USE_KEYMAP
+    if (as_zmk_layer_state_changed(eh)) {
+        request_frame(PER_KEY_CHANGE_LAYERS);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_MODIFIERS)
+    const struct zmk_keycode_state_changed *key_ev = as_zmk_keycode_state_changed(eh);
+    if (key_ev && is_mod(key_ev->usage_page, key_ev->keycode)) {
+        request_frame(PER_KEY_CHANGE_MODIFIERS);
+    }
+#endif
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(rgb_per_key, rgb_per_key_listener);
+ZMK_SUBSCRIPTION(rgb_per_key, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(rgb_per_key, zmk_physical_layout_selection_changed);
+#if USE_KEYMAP
+ZMK_SUBSCRIPTION(rgb_per_key, zmk_layer_state_changed);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_RGB_PER_KEY_MODIFIERS)
+ZMK_SUBSCRIPTION(rgb_per_key, zmk_keycode_state_changed);
+#endif
+
+static int rgb_per_key_init(void) {
+    if (!device_is_ready(led_strip)) {
+        LOG_ERR("Per-key RGB LED strip \"%s\" is not ready", led_strip->name);
+        return -ENODEV;
+    }
+
+#if USE_KEYMAP
+    memset(led_layer, ZMK_KEYMAP_LAYER_ID_INVAL, sizeof(led_layer));
+#endif
+
+    request_frame(PER_KEY_CHANGE_LAYOUT);
+    request_frame(PER_KEY_CHANGE_LAYERS);
+
+    return 0;
+}
+
+SYS_INIT(rgb_per_key_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -11,13 +11,16 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <zephyr/logging/log.h>
 
 #include <zephyr/drivers/led_strip.h>
 #include <drivers/ext_power.h>
 
+#include <zmk/energy.h>
 #include <zmk/rgb_underglow.h>
+#include <zmk/settings.h>
 
 #include <zmk/activity.h>
 #include <zmk/usb.h>
@@ -26,6 +29,15 @@
 #include <zmk/events/usb_conn_state_changed.h>
 #include <zmk/workqueue.h>
 
+#define SYNC_SEND                                                                                  \
+    (IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL))
+#define SYNC_RECEIVE                                                                               \
+    (IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC) && !IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL))
+
+#if SYNC_SEND
+#include <zmk/split/central.h>
+#endif
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if !DT_HAS_CHOSEN(zmk_underglow)
@@ -37,6 +49,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define STRIP_CHOSEN DT_CHOSEN(zmk_underglow)
 #define STRIP_NUM_PIXELS DT_PROP(STRIP_CHOSEN, chain_length)
 
+#define UNDERGLOW_TICK_MS 50
+
 #define HUE_MAX 360
 #define SAT_MAX 100
 #define BRT_MAX 100
@@ -62,10 +76,25 @@ struct rgb_underglow_state {
 
 static const struct device *led_strip;
 
+// Effects render into the back buffer, which is then handed to the strip driver. Drivers are
+// allowed to overwrite the buffer they are given, so the front buffer keeps an intact copy of the
+// frame on the strip to compare the next one against.
 static struct led_rgb pixels[STRIP_NUM_PIXELS];
+static struct led_rgb shown_pixels[STRIP_NUM_PIXELS];
+
+// Writing a frame takes the strip's bus for the whole chain, so frames that didn't change are
+// skipped unless the strip may have lost what it is showing.
+static bool shown_pixels_valid;
 
 static struct rgb_underglow_state state;
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+// Uptime the current animation started at. Animations are drawn from the time since then rather
+// than from a step counter, so both halves of a split draw the same frame at the same time once
+// the peripherals have taken over the central's start time.
+static uint32_t animation_start;
+#endif
+
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_EXT_POWER)
 static const struct device *const ext_power = DEVICE_DT_GET(DT_INST(0, zmk_ext_power_generic));
 #endif
@@ -81,68 +110,52 @@ static struct zmk_led_hsb hsb_scale_zero_max(struct zmk_led_hsb hsb) {
     return hsb;
 }
 
+// Integer version of the usual sector based conversion. Every channel is worked out as a single
+// product over BRT_MAX * SAT_MAX * 60, so there is only one rounding step per channel.
+#define HSB_TO_RGB_DIV (BRT_MAX * SAT_MAX * 60)
+
 static struct led_rgb hsb_to_rgb(struct zmk_led_hsb hsb) {
-    float r = 0, g = 0, b = 0;
+    const uint8_t i = (hsb.h / 60) % 6;
+    const uint32_t f = hsb.h % 60;
+    const uint32_t v = hsb.b * 255;
 
-    uint8_t i = hsb.h / 60;
-    float v = hsb.b / ((float)BRT_MAX);
-    float s = hsb.s / ((float)SAT_MAX);
-    float f = hsb.h / ((float)HUE_MAX) * 6 - i;
-    float p = v * (1 - s);
-    float q = v * (1 - f * s);
-    float t = v * (1 - (1 - f) * s);
+    const uint8_t max = v * SAT_MAX * 60 / HSB_TO_RGB_DIV;
+    const uint8_t p = v * (SAT_MAX - hsb.s) * 60 / HSB_TO_RGB_DIV;
+    const uint8_t q = v * (SAT_MAX * 60 - f * hsb.s) / HSB_TO_RGB_DIV;
+    const uint8_t t = v * (SAT_MAX * 60 - (60 - f) * hsb.s) / HSB_TO_RGB_DIV;
 
-    switch (i % 6) {
+    switch (i) {
     case 0:
-        r = v;
-        g = t;
-        b = p;
-        break;
+        return (struct led_rgb){r : max, g : t, b : p};
     case 1:
-        r = q;
-        g = v;
-        b = p;
-        break;
+        return (struct led_rgb){r : q, g : max, b : p};
     case 2:
-        r = p;
-        g = v;
-        b = t;
-        break;
+        return (struct led_rgb){r : p, g : max, b : t};
     case 3:
-        r = p;
-        g = q;
-        b = v;
-        break;
+        return (struct led_rgb){r : p, g : q, b : max};
     case 4:
-        r = t;
-        g = p;
-        b = v;
-        break;
-    case 5:
-        r = v;
-        g = p;
-        b = q;
-        break;
+        return (struct led_rgb){r : t, g : p, b : max};
+    default:
+        return (struct led_rgb){r : max, g : p, b : q};
     }
-
-    struct led_rgb rgb = {r : r * 255, g : g * 255, b : b * 255};
-
-    return rgb;
 }
 
-static void zmk_rgb_underglow_effect_solid(void) {
+// Solid, breathe and spectrum light every pixel the same, so a frame is one conversion.
+static void fill_pixels(struct led_rgb rgb) {
     for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(state.color));
+        pixels[i] = rgb;
     }
 }
 
+static void zmk_rgb_underglow_effect_solid(void) {
+    fill_pixels(hsb_to_rgb(hsb_scale_min_max(state.color)));
+}
+
 static void zmk_rgb_underglow_effect_breathe(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.b = abs(state.animation_step - 1200) / 12;
+    struct zmk_led_hsb hsb = state.color;
+    hsb.b = abs(state.animation_step - 1200) / 12;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_zero_max(hsb));
-    }
+    fill_pixels(hsb_to_rgb(hsb_scale_zero_max(hsb)));
 
     state.animation_step += state.animation_speed * 10;
 
@@ -152,30 +165,111 @@ static void zmk_rgb_underglow_effect_breathe(void) {
 }
 
 static void zmk_rgb_underglow_effect_spectrum(void) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
-        hsb.h = state.animation_step;
+    struct zmk_led_hsb hsb = state.color;
+    hsb.h = state.animation_step;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(hsb));
-    }
+    fill_pixels(hsb_to_rgb(hsb_scale_min_max(hsb)));
 
     state.animation_step += state.animation_speed;
     state.animation_step = state.animation_step % HUE_MAX;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_HUE_WHEEL)
+
+// Swirl only ever changes the hue, so the colour of every hue at the current saturation and
+// brightness is kept, and only rebuilt when either of those changes.
+static struct led_rgb hue_wheel[HUE_MAX];
+static struct zmk_led_hsb hue_wheel_color = {.s = UINT8_MAX};
+
+static struct led_rgb swirl_color(struct zmk_led_hsb hsb) {
+    if (hsb.s != hue_wheel_color.s || hsb.b != hue_wheel_color.b) {
+        hue_wheel_color = hsb;
+
+        for (uint16_t h = 0; h < HUE_MAX; h++) {
+            hue_wheel_color.h = h;
+            hue_wheel[h] = hsb_to_rgb(hue_wheel_color);
+        }
+    }
+
+    return hue_wheel[hsb.h];
+}
+
+#else
+
+static struct led_rgb swirl_color(struct zmk_led_hsb hsb) { return hsb_to_rgb(hsb); }
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_HUE_WHEEL)
+
 static void zmk_rgb_underglow_effect_swirl(void) {
+    struct zmk_led_hsb hsb = hsb_scale_min_max(state.color);
+
     for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        struct zmk_led_hsb hsb = state.color;
         hsb.h = (HUE_MAX / STRIP_NUM_PIXELS * i + state.animation_step) % HUE_MAX;
 
-        pixels[i] = hsb_to_rgb(hsb_scale_min_max(hsb));
+        pixels[i] = swirl_color(hsb);
     }
 
     state.animation_step += state.animation_speed * 2;
     state.animation_step = state.animation_step % HUE_MAX;
 }
 
+static void zmk_rgb_underglow_update_strip(void) {
+    if (shown_pixels_valid && memcmp(pixels, shown_pixels, sizeof(pixels)) == 0) {
+        return;
+    }
+
+    memcpy(shown_pixels, pixels, sizeof(pixels));
+    shown_pixels_valid = true;
+
+    int err = led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
+    if (err < 0) {
+        LOG_ERR("Failed to update the RGB strip (%d)", err);
+        shown_pixels_valid = false;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_ENERGY)
+    // The LEDs draw current in proportion to how bright each colour channel is.
+    uint32_t channels = 0;
+    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
+        channels += pixels[i].r + pixels[i].g + pixels[i].b;
+    }
+    zmk_energy_set_duty(ZMK_ENERGY_UNDERGLOW, channels * 1000 / (STRIP_NUM_PIXELS * 3 * 255));
+#endif // IS_ENABLED(CONFIG_ZMK_ENERGY)
+}
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+// The step every effect would have counted up to after this many ticks.
+static uint16_t zmk_rgb_underglow_step_at(uint32_t ticks) {
+    switch (state.current_effect) {
+    case UNDERGLOW_EFFECT_BREATHE: {
+        const uint32_t step = state.animation_speed * 10;
+        return (ticks % (2400 / step + 1)) * step;
+    }
+    case UNDERGLOW_EFFECT_SPECTRUM:
+        return (ticks * state.animation_speed) % HUE_MAX;
+    case UNDERGLOW_EFFECT_SWIRL:
+        return (ticks * state.animation_speed * 2) % HUE_MAX;
+    default:
+        return 0;
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+static void zmk_rgb_underglow_restart_animation(void) {
+    state.animation_step = 0;
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    animation_start = k_uptime_get_32();
+#endif
+}
+
 static void zmk_rgb_underglow_tick(struct k_work *work) {
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    state.animation_step =
+        zmk_rgb_underglow_step_at((k_uptime_get_32() - animation_start) / UNDERGLOW_TICK_MS);
+#endif
+
     switch (state.current_effect) {
     case UNDERGLOW_EFFECT_SOLID:
         zmk_rgb_underglow_effect_solid();
@@ -191,24 +285,115 @@ static void zmk_rgb_underglow_tick(struct k_work *work) {
         break;
     }
 
-    int err = led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
-    if (err < 0) {
-        LOG_ERR("Failed to update the RGB strip (%d)", err);
+    zmk_rgb_underglow_update_strip();
+}
+
+static void zmk_rgb_underglow_off_handler(struct k_work *work) {
+    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
+        pixels[i] = (struct led_rgb){r : 0, g : 0, b : 0};
     }
+
+    zmk_rgb_underglow_update_strip();
 }
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_THREAD)
+
+// The thread draws whatever the current state calls for, so ticks and turning off are the same
+// request, and requests made while a frame is being drawn collapse into one more frame.
+static K_SEM_DEFINE(underglow_render_sem, 0, 1);
+
+static void zmk_rgb_underglow_render_thread(void *p1, void *p2, void *p3) {
+    while (true) {
+        k_sem_take(&underglow_render_sem, K_FOREVER);
+
+        if (state.on) {
+            zmk_rgb_underglow_tick(NULL);
+        } else {
+            zmk_rgb_underglow_off_handler(NULL);
+        }
+    }
+}
+
+K_THREAD_DEFINE(underglow_render_thread, CONFIG_ZMK_RGB_UNDERGLOW_THREAD_STACK_SIZE,
+                zmk_rgb_underglow_render_thread, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO,
+                0, 0);
+
+static void zmk_rgb_underglow_submit_tick(void) { k_sem_give(&underglow_render_sem); }
+
+static void zmk_rgb_underglow_submit_off(void) { k_sem_give(&underglow_render_sem); }
+
+#else
+
 K_WORK_DEFINE(underglow_tick_work, zmk_rgb_underglow_tick);
+K_WORK_DEFINE(underglow_off_work, zmk_rgb_underglow_off_handler);
+
+static void zmk_rgb_underglow_submit_tick(void) {
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &underglow_tick_work);
+}
+
+static void zmk_rgb_underglow_submit_off(void) {
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &underglow_off_work);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_THREAD)
 
 static void zmk_rgb_underglow_tick_handler(struct k_timer *timer) {
     if (!state.on) {
         return;
     }
 
-    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &underglow_tick_work);
+    zmk_rgb_underglow_submit_tick();
+
+    // A solid colour only changes along with the state, which restarts the timer, so one frame
+    // is all it needs.
+    if (state.current_effect == UNDERGLOW_EFFECT_SOLID) {
+        k_timer_stop(timer);
+    }
 }
 
 K_TIMER_DEFINE(underglow_tick, zmk_rgb_underglow_tick_handler, NULL);
 
+static void zmk_rgb_underglow_start_tick(void) {
+    if (state.on) {
+        k_timer_start(&underglow_tick, K_NO_WAIT, K_MSEC(UNDERGLOW_TICK_MS));
+    }
+}
+
+#if SYNC_SEND
+
+static void zmk_rgb_underglow_sync_work(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(underglow_sync_work, zmk_rgb_underglow_sync_work);
+
+// Sent whenever the state changes, and again every interval to catch peripherals that connected
+// since and to correct for the clocks of the halves running at slightly different rates.
+static void zmk_rgb_underglow_sync_work(struct k_work *work) {
+    const struct zmk_split_transport_rgb_sync sync = {
+        .elapsed_ms = k_uptime_get_32() - animation_start,
+        .hue = state.color.h,
+        .saturation = state.color.s,
+        .brightness = state.color.b,
+        .speed = state.animation_speed,
+        .effect = state.current_effect,
+        .on = state.on,
+    };
+
+    int err = zmk_split_central_update_rgb_sync(&sync);
+    if (err < 0 && err != -ENODEV) {
+        LOG_WRN("Failed to send the underglow sync to peripherals (%d)", err);
+    }
+
+    k_work_schedule(&underglow_sync_work, K_SECONDS(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC_INTERVAL));
+}
+
+#endif // SYNC_SEND
+
+static void zmk_rgb_underglow_schedule_sync(void) {
+#if SYNC_SEND
+    k_work_reschedule(&underglow_sync_work, K_NO_WAIT);
+#endif
+}
+
 #if IS_ENABLED(CONFIG_SETTINGS)
 static int rgb_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
     const char *next;
@@ -221,9 +406,7 @@ static int rgb_settings_set(const char *name, size_t len, settings_read_cb read_
 
         rc = read_cb(cb_arg, &state, sizeof(state));
         if (rc >= 0) {
-            if (state.on) {
-                k_timer_start(&underglow_tick, K_NO_WAIT, K_MSEC(50));
-            }
+            zmk_rgb_underglow_start_tick();
 
             return 0;
         }
@@ -236,11 +419,11 @@ static int rgb_settings_set(const char *name, size_t len, settings_read_cb read_
 
 SETTINGS_STATIC_HANDLER_DEFINE(rgb_underglow, "rgb/underglow", NULL, rgb_settings_set, NULL, NULL);
 
-static void zmk_rgb_underglow_save_state_work(struct k_work *_work) {
+static void zmk_rgb_underglow_save_state_cb(void) {
     settings_save_one("rgb/underglow/state", &state, sizeof(state));
 }
 
-static struct k_work_delayable underglow_save_work;
+ZMK_SETTINGS_SAVE_DEFINE(underglow_save, zmk_rgb_underglow_save_state_cb);
 #endif
 
 static int zmk_rgb_underglow_init(void) {
@@ -265,25 +448,22 @@ static int zmk_rgb_underglow_init(void) {
         on : IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_ON_START)
     };
 
-#if IS_ENABLED(CONFIG_SETTINGS)
-    k_work_init_delayable(&underglow_save_work, zmk_rgb_underglow_save_state_work);
-#endif
-
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_AUTO_OFF_USB)
     state.on = zmk_usb_is_powered();
 #endif
 
-    if (state.on) {
-        k_timer_start(&underglow_tick, K_NO_WAIT, K_MSEC(50));
-    }
+    zmk_rgb_underglow_restart_animation();
+    zmk_rgb_underglow_start_tick();
+    zmk_rgb_underglow_schedule_sync();
 
     return 0;
 }
 
 int zmk_rgb_underglow_save_state(void) {
+    zmk_rgb_underglow_schedule_sync();
+
 #if IS_ENABLED(CONFIG_SETTINGS)
-    int ret = k_work_reschedule(&underglow_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
-    return MIN(ret, 0);
+    return zmk_settings_save_schedule(&underglow_save);
 #else
     return 0;
 #endif
@@ -311,22 +491,14 @@ int zmk_rgb_underglow_on(void) {
 #endif
 
     state.on = true;
-    state.animation_step = 0;
-    k_timer_start(&underglow_tick, K_NO_WAIT, K_MSEC(50));
+    zmk_rgb_underglow_restart_animation();
+    // The strip may have been powered down, so the first frame is always written.
+    shown_pixels_valid = false;
+    zmk_rgb_underglow_start_tick();
 
     return zmk_rgb_underglow_save_state();
 }
 
-static void zmk_rgb_underglow_off_handler(struct k_work *work) {
-    for (int i = 0; i < STRIP_NUM_PIXELS; i++) {
-        pixels[i] = (struct led_rgb){r : 0, g : 0, b : 0};
-    }
-
-    led_strip_update_rgb(led_strip, pixels, STRIP_NUM_PIXELS);
-}
-
-K_WORK_DEFINE(underglow_off_work, zmk_rgb_underglow_off_handler);
-
 int zmk_rgb_underglow_off(void) {
     if (!led_strip)
         return -ENODEV;
@@ -340,11 +512,11 @@ int zmk_rgb_underglow_off(void) {
     }
 #endif
 
-    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &underglow_off_work);
-
     k_timer_stop(&underglow_tick);
     state.on = false;
 
+    zmk_rgb_underglow_submit_off();
+
     return zmk_rgb_underglow_save_state();
 }
 
@@ -361,7 +533,8 @@ int zmk_rgb_underglow_select_effect(int effect) {
     }
 
     state.current_effect = effect;
-    state.animation_step = 0;
+    zmk_rgb_underglow_restart_animation();
+    zmk_rgb_underglow_start_tick();
 
     return zmk_rgb_underglow_save_state();
 }
@@ -380,6 +553,8 @@ int zmk_rgb_underglow_set_hsb(struct zmk_led_hsb color) {
     }
 
     state.color = color;
+    zmk_rgb_underglow_start_tick();
+    zmk_rgb_underglow_schedule_sync();
 
     return 0;
 }
@@ -421,6 +596,7 @@ int zmk_rgb_underglow_change_hue(int direction) {
         return -ENODEV;
 
     state.color = zmk_rgb_underglow_calc_hue(direction);
+    zmk_rgb_underglow_start_tick();
 
     return zmk_rgb_underglow_save_state();
 }
@@ -430,6 +606,7 @@ int zmk_rgb_underglow_change_sat(int direction) {
         return -ENODEV;
 
     state.color = zmk_rgb_underglow_calc_sat(direction);
+    zmk_rgb_underglow_start_tick();
 
     return zmk_rgb_underglow_save_state();
 }
@@ -439,6 +616,7 @@ int zmk_rgb_underglow_change_brt(int direction) {
         return -ENODEV;
 
     state.color = zmk_rgb_underglow_calc_brt(direction);
+    zmk_rgb_underglow_start_tick();
 
     return zmk_rgb_underglow_save_state();
 }
@@ -460,6 +638,67 @@ int zmk_rgb_underglow_change_spd(int direction) {
     return zmk_rgb_underglow_save_state();
 }
 
+#if SYNC_RECEIVE
+
+static struct zmk_split_transport_rgb_sync received_sync;
+static int64_t received_sync_time;
+static struct k_spinlock received_sync_lock;
+
+static void zmk_rgb_underglow_apply_sync_work(struct k_work *work) {
+    struct zmk_split_transport_rgb_sync sync;
+    int64_t received_at;
+
+    K_SPINLOCK(&received_sync_lock) {
+        sync = received_sync;
+        received_at = received_sync_time;
+    }
+
+    if (!led_strip || sync.hue > HUE_MAX || sync.saturation > SAT_MAX ||
+        sync.brightness > BRT_MAX || sync.effect >= UNDERGLOW_EFFECT_NUMBER) {
+        LOG_WRN("Ignoring invalid underglow sync");
+        return;
+    }
+
+    const struct zmk_led_hsb color = {.h = sync.hue, .s = sync.saturation, .b = sync.brightness};
+    const uint8_t speed = CLAMP(sync.speed, 1, 5);
+    const bool changed = memcmp(&color, &state.color, sizeof(color)) != 0 ||
+                         speed != state.animation_speed || sync.effect != state.current_effect;
+
+    state.color = color;
+    state.animation_speed = speed;
+    state.current_effect = sync.effect;
+
+    if (sync.on && !state.on) {
+        zmk_rgb_underglow_on();
+    } else if (!sync.on && state.on) {
+        zmk_rgb_underglow_off();
+    } else if (changed) {
+        // The periodic resyncs usually change nothing, and saving on each of them would keep
+        // pushing the debounced save back.
+        zmk_rgb_underglow_save_state();
+    }
+
+    zmk_rgb_underglow_start_tick();
+
+    // Counted from when the sync arrived, so the time spent queued here doesn't shift the phase.
+    animation_start = (uint32_t)received_at - sync.elapsed_ms;
+}
+
+static K_WORK_DEFINE(underglow_apply_sync_work, zmk_rgb_underglow_apply_sync_work);
+
+int zmk_rgb_underglow_apply_sync(const struct zmk_split_transport_rgb_sync *sync) {
+    K_SPINLOCK(&received_sync_lock) {
+        received_sync = *sync;
+        received_sync_time = k_uptime_get();
+    }
+
+    k_work_submit(&underglow_apply_sync_work);
+
+    return 0;
+}
+
+#endif // SYNC_RECEIVE
+
 #if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_AUTO_OFF_IDLE) ||                                          \
     IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_AUTO_OFF_USB)
 struct rgb_underglow_sleep_state {
@@ -15,6 +15,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/sensors.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/sensor_event.h>
+#include <zmk/workqueue.h>
 
 #if ZMK_KEYMAP_HAS_SENSORS
 
@@ -55,6 +56,57 @@ static struct sensors_item_cfg sensors[] = {LISTIFY(ZMK_KEYMAP_SENSORS_LEN, SENS
 
 static ATOMIC_DEFINE(pending_sensors, ZMK_KEYMAP_SENSORS_LEN);
 
+#define USE_BATCHING (CONFIG_ZMK_KEYMAP_SENSORS_BATCH_MS > 0)
+
+#if USE_BATCHING
+
+// Rotation is summed for a short while after the first step, so a fast spin walks the keymap
+// layers once and lets the bound behavior trigger several times, instead of once per step.
+struct sensor_batch {
+    struct sensor_value value;
+    bool pending;
+};
+
+static struct sensor_batch batches[ZMK_KEYMAP_SENSORS_LEN];
+static struct k_spinlock batches_lock;
+
+static void raise_sensor_value(uint8_t sensor_index, struct sensor_value value);
+
+static void flush_sensor_batches(struct k_work *work) {
+    for (int i = 0; i < ARRAY_SIZE(batches); i++) {
+        struct sensor_batch batch;
+
+        K_SPINLOCK(&batches_lock) {
+            batch = batches[i];
+            batches[i] = (struct sensor_batch){0};
+        }
+
+        if (batch.pending) {
+            raise_sensor_value(i, batch.value);
+        }
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(sensor_batch_work, flush_sensor_batches);
+
+static void batch_sensor_value(uint8_t sensor_index, struct sensor_value value) {
+    K_SPINLOCK(&batches_lock) {
+        struct sensor_batch *batch = &batches[sensor_index];
+
+        batch->value.val1 += value.val1;
+        batch->value.val2 += value.val2;
+        batch->value.val1 += batch->value.val2 / 1000000;
+        batch->value.val2 %= 1000000;
+        batch->pending = true;
+    }
+
+    // Keeps the deadline of an already scheduled flush, so a batch never waits for longer.
+    k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &sensor_batch_work,
+                              K_MSEC(CONFIG_ZMK_KEYMAP_SENSORS_BATCH_MS));
+}
+
+#endif // USE_BATCHING
+
 const struct zmk_sensor_config *zmk_sensors_get_config_at_index(uint8_t sensor_index) {
     if (sensor_index > ARRAY_SIZE(configs)) {
         return NULL;
@@ -63,6 +115,15 @@ const struct zmk_sensor_config *zmk_sensors_get_config_at_index(uint8_t sensor_i
     return &configs[sensor_index];
 }
 
+static void raise_sensor_value(uint8_t sensor_index, struct sensor_value value) {
+    raise_zmk_sensor_event(
+        (struct zmk_sensor_event){.sensor_index = sensor_index,
+                                  .channel_data_size = 1,
+                                  .channel_data = {(struct zmk_sensor_channel_data){
+                                      .value = value, .channel = SENSOR_CHAN_ROTATION}},
+                                  .timestamp = k_uptime_get()});
+}
+
 static void trigger_sensor_data_for_position(uint32_t sensor_index) {
     int err;
     const struct sensors_item_cfg *item = &sensors[sensor_index];
@@ -81,12 +142,11 @@ static void trigger_sensor_data_for_position(uint32_t sensor_index) {
         return;
     }
 
-    raise_zmk_sensor_event(
-        (struct zmk_sensor_event){.sensor_index = item->sensor_index,
-                                  .channel_data_size = 1,
-                                  .channel_data = {(struct zmk_sensor_channel_data){
-                                      .value = value, .channel = item->trigger.chan}},
-                                  .timestamp = k_uptime_get()});
+#if USE_BATCHING
+    batch_sensor_value(item->sensor_index, value);
+#else
+    raise_sensor_value(item->sensor_index, value);
+#endif // USE_BATCHING
 }
 
 static void run_sensors_data_trigger(struct k_work *work) {
@@ -112,7 +172,7 @@ static void zmk_sensors_trigger_handler(const struct device *dev,
 
     if (k_is_in_isr()) {
         atomic_set_bit(pending_sensors, sensor_index);
-        k_work_submit(&sensor_data_work);
+        k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &sensor_data_work);
     } else {
         trigger_sensor_data_for_position(sensor_index);
     }
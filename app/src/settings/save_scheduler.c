@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/settings.h>
+#include <zmk/workqueue.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+// Every subsystem's changed settings are written together in one pass, so the flash is only
+// busy (and any garbage collection only happens) once per batch rather than once per subsystem.
+// Batches are written when the keyboard goes idle, or after the debounce period otherwise,
+// waiting for a pause in typing so a write never lands between key presses.
+
+static sys_slist_t pending_saves = SYS_SLIST_STATIC_INIT(&pending_saves);
+static struct k_spinlock lock;
+
+#if CONFIG_ZMK_SETTINGS_SAVE_TYPING_GAP > 0
+static atomic_t last_key_uptime;
+#endif
+
+static void flush_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_cb);
+
+int zmk_settings_save_schedule(struct zmk_settings_save *save) {
+    K_SPINLOCK(&lock) {
+        if (!save->pending) {
+            save->pending = true;
+            sys_slist_append(&pending_saves, &save->node);
+        }
+    }
+
+    int ret = k_work_reschedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER),
+                                          &flush_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    return MIN(ret, 0);
+}
+
+void zmk_settings_save_flush(void) {
+    k_work_cancel_delayable(&flush_work);
+
+    for (;;) {
+        struct zmk_settings_save *save = NULL;
+
+        K_SPINLOCK(&lock) {
+            sys_snode_t *node = sys_slist_get(&pending_saves);
+            if (node) {
+                save = CONTAINER_OF(node, struct zmk_settings_save, node);
+                save->pending = false;
+            }
+        }
+
+        if (!save) {
+            break;
+        }
+
+        save->save();
+    }
+}
+
+static void flush_work_cb(struct k_work *work) {
+#if CONFIG_ZMK_SETTINGS_SAVE_TYPING_GAP > 0
+    uint32_t since_key = k_uptime_get_32() - (uint32_t)atomic_get(&last_key_uptime);
+
+    if (since_key < CONFIG_ZMK_SETTINGS_SAVE_TYPING_GAP) {
+        k_work_reschedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &flush_work,
+                                    K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_TYPING_GAP - since_key));
+        return;
+    }
+#endif
+
+    zmk_settings_save_flush();
+}
+
+static int save_scheduler_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *activity = as_zmk_activity_state_changed(eh);
+
+    if (activity) {
+        // Sleeping powers off right after this event, so pending saves can't wait any longer.
+        if (activity->state != ZMK_ACTIVITY_ACTIVE) {
+            zmk_settings_save_flush();
+        }
+
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+#if CONFIG_ZMK_SETTINGS_SAVE_TYPING_GAP > 0
+    atomic_set(&last_key_uptime, k_uptime_get_32());
+#endif
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_save_scheduler, save_scheduler_listener);
+ZMK_SUBSCRIPTION(settings_save_scheduler, zmk_activity_state_changed);
+#if CONFIG_ZMK_SETTINGS_SAVE_TYPING_GAP > 0
+ZMK_SUBSCRIPTION(settings_save_scheduler, zmk_position_state_changed);
+#endif
@@ -33,6 +33,9 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/pointing/input_split.h>
 #include <zmk/hid_indicators_types.h>
 #include <zmk/physical_layouts.h>
+#include <zmk/queue_stats.h>
+#include <zmk/telemetry.h>
+#include <zmk/workqueue.h>
 
 static int start_scanning(void);
 
@@ -50,8 +53,25 @@ struct peripheral_slot {
     struct bt_gatt_discover_params discover_params;
     struct bt_gatt_subscribe_params subscribe_params;
     struct bt_gatt_subscribe_params sensor_subscribe_params;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+    struct bt_gatt_subscribe_params position_events_subscribe_params;
+    int64_t last_position_event_timestamp;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
     struct bt_gatt_discover_params sub_discover_params;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+    struct bt_gatt_read_params db_hash_read_params;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
     uint16_t run_behavior_handle;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    uint16_t run_behaviors_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    uint16_t rgb_sync_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    // Pings are written to the value handle of the characteristic the pongs are notified on.
+    struct bt_gatt_subscribe_params link_benchmark_subscribe_params;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     struct bt_gatt_subscribe_params batt_lvl_subscribe_params;
     struct bt_gatt_read_params batt_lvl_read_params;
@@ -140,24 +160,56 @@ static const struct bt_uuid_128 split_service_uuid = BT_UUID_INIT_128(ZMK_SPLIT_
 
 struct peripheral_event_wrapper {
     uint8_t source;
+    int64_t timestamp;
     struct zmk_split_transport_peripheral_event event;
 };
 
-K_MSGQ_DEFINE(peripheral_event_msgq, sizeof(struct peripheral_event_wrapper),
-              CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE, 4);
+// Each peripheral has its own event queue, drained round robin, so one busy peripheral can't
+// fill the queue and crowd out events from the others.
+static char __aligned(4) peripheral_event_buffers[ZMK_SPLIT_BLE_PERIPHERAL_COUNT]
+    [CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE * sizeof(struct peripheral_event_wrapper)];
+static struct k_msgq peripheral_event_msgqs[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+ZMK_QUEUE_STATS_DEFINE(peripheral_event_msgqs, "peripheral events",
+                       CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE);
 
 void peripheral_event_work_callback(struct k_work *work);
 
 K_WORK_DEFINE(peripheral_event_work, peripheral_event_work_callback);
 
+static void submit_peripheral_event_work(void) {
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &peripheral_event_work);
+}
+
+static int queue_peripheral_event(const struct peripheral_event_wrapper *ev) {
+    if (ev->source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        return -EINVAL;
+    }
+
+    int err = ZMK_QUEUE_STATS_MSGQ_PUT(peripheral_event_msgqs, &peripheral_event_msgqs[ev->source],
+                                       ev, K_NO_WAIT);
+    if (err < 0) {
+        LOG_WRN("Event queue for peripheral %d is full, dropping event (%d)", ev->source, err);
+    }
+
+    return err;
+}
+
+// Slot index plus one for each connection, by bt_conn_index(), so zero means not a peripheral.
+static uint8_t conn_slot_indexes[CONFIG_BT_MAX_CONN];
+
+static void index_peripheral_conn(int index) {
+    conn_slot_indexes[bt_conn_index(peripherals[index].conn)] = index + 1;
+}
+
 int peripheral_slot_index_for_conn(struct bt_conn *conn) {
-    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
-        if (peripherals[i].conn == conn) {
-            return i;
-        }
+    int index = conn_slot_indexes[bt_conn_index(conn)] - 1;
+
+    if (index < 0 || peripherals[index].conn != conn) {
+        return -EINVAL;
     }
 
-    return -EINVAL;
+    return index;
 }
 
 struct peripheral_slot *peripheral_slot_for_conn(struct bt_conn *conn) {
@@ -183,6 +235,7 @@ int release_peripheral_slot(int index) {
     LOG_DBG("Releasing peripheral slot at %d", index);
 
     if (slot->conn != NULL) {
+        conn_slot_indexes[bt_conn_index(slot->conn)] = 0;
         bt_conn_unref(slot->conn);
         slot->conn = NULL;
     }
@@ -195,14 +248,15 @@ int release_peripheral_slot(int index) {
                 uint32_t position = (i * 8) + j;
                 struct peripheral_event_wrapper ev = {
                     .source = index,
+                    .timestamp = k_uptime_get(),
                     .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
                               .data = {.key_position_event = {
                                            .position = position,
                                            .pressed = false,
                                        }}}};
 
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
+                queue_peripheral_event(&ev);
+                submit_peripheral_event_work();
             }
         }
     }
@@ -214,7 +268,20 @@ int release_peripheral_slot(int index) {
 
     // Clean up previously discovered handles;
     slot->subscribe_params.value_handle = 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+    slot->position_events_subscribe_params.value_handle = 0;
+    slot->last_position_event_timestamp = 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
     slot->run_behavior_handle = 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    slot->run_behaviors_handle = 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    slot->rgb_sync_handle = 0;
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    slot->link_benchmark_subscribe_params.value_handle = 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
     slot->selected_physical_layout_handle = 0;
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     slot->update_hid_indicators = 0;
@@ -288,14 +355,15 @@ static uint8_t split_central_sensor_notify_func(struct bt_conn *conn,
 
     struct peripheral_event_wrapper event_wrapper = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT,
                   .data = {.sensor_event = {
                                .channel_data = sensor_event.channel_data[0],
                                .sensor_index = sensor_event.sensor_index,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &event_wrapper, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&event_wrapper);
+    submit_peripheral_event_work();
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -326,6 +394,7 @@ static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
         if (&peripheral_input_slots[i].sub == params) {
             struct peripheral_event_wrapper event_wrapper = {
                 .source = peripheral_slot_index_for_conn(conn),
+                .timestamp = k_uptime_get(),
                 .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_INPUT_EVENT,
                           .data = {.input_event = {
                                        .reg = peripheral_input_slots[i].reg,
@@ -335,8 +404,8 @@ static uint8_t peripheral_input_event_notify_cb(struct bt_conn *conn,
                                        .value = payload.value,
                                    }}}};
 
-            k_msgq_put(&peripheral_event_msgq, &event_wrapper, K_NO_WAIT);
-            k_work_submit(&peripheral_event_work);
+            queue_peripheral_event(&event_wrapper);
+            submit_peripheral_event_work();
             break;
         }
     }
@@ -377,13 +446,14 @@ static uint8_t split_central_notify_func(struct bt_conn *conn,
                 bool pressed = slot->position_state[i] & BIT(j);
                 struct peripheral_event_wrapper ev = {
                     .source = peripheral_slot_index_for_conn(conn),
+                    .timestamp = k_uptime_get(),
                     .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
                               .data = {.key_position_event = {
                                            .position = position,
                                            .pressed = pressed,
                                        }}}};
-                k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
+                queue_peripheral_event(&ev);
+                submit_peripheral_event_work();
             }
         }
     }
@@ -391,6 +461,151 @@ static uint8_t split_central_notify_func(struct bt_conn *conn,
     return BT_GATT_ITER_CONTINUE;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+
+static uint8_t split_central_position_events_notify_func(struct bt_conn *conn,
+                                                         struct bt_gatt_subscribe_params *params,
+                                                         const void *data, uint16_t length) {
+    int64_t now = k_uptime_get();
+    int idx = peripheral_slot_index_for_conn(conn);
+
+    if (idx < 0) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    if (!data) {
+        LOG_DBG("[UNSUBSCRIBED]");
+        params->value_handle = 0U;
+        return BT_GATT_ITER_STOP;
+    }
+
+    LOG_DBG("[POSITION EVENTS NOTIFICATION] data %p length %u", data, length);
+
+    const struct zmk_split_position_events_payload *payload = data;
+    size_t count = 0;
+    size_t trailer_len = 0;
+
+    if (length >= sizeof(*payload)) {
+        count = (length - sizeof(*payload)) / sizeof(struct zmk_split_position_event);
+        trailer_len = (length - sizeof(*payload)) % sizeof(struct zmk_split_position_event);
+    }
+
+    if (count == 0 && trailer_len == 0) {
+        LOG_WRN("Ignoring position events notify with insufficient data length (%d)", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+    if (trailer_len > 0) {
+        uint8_t battery_level = ((const uint8_t *)&payload->events[count])[0];
+        LOG_DBG("Battery level: %u", battery_level);
+
+        struct peripheral_event_wrapper ev = {
+            .source = idx,
+            .timestamp = now,
+            .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
+                      .data = {.battery_event = {
+                                   .level = battery_level,
+                               }}}};
+        queue_peripheral_event(&ev);
+    }
+#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+
+    struct peripheral_slot *slot = &peripherals[idx];
+
+    // Work back from the last event to when the first one happened, then replay the deltas.
+    int64_t timestamp = now - sys_le16_to_cpu(payload->age);
+    for (size_t i = 1; i < count; i++) {
+        timestamp -= sys_le16_to_cpu(payload->events[i].delta);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const struct zmk_split_position_event *event = &payload->events[i];
+        uint8_t position = event->position & ~ZMK_SPLIT_POSITION_EVENT_PRESSED;
+        bool pressed = event->position & ZMK_SPLIT_POSITION_EVENT_PRESSED;
+
+        if (i > 0) {
+            timestamp += sys_le16_to_cpu(event->delta);
+        }
+
+        if (position >= POSITION_STATE_DATA_LEN * 8) {
+            LOG_WRN("Ignoring event for out of range position %d", position);
+            continue;
+        }
+
+        // A peripheral replaying events from before a reconnect can release keys that were
+        // already released here when the link dropped.
+        if (!!(slot->position_state[position / 8] & BIT(position % 8)) == pressed) {
+            LOG_DBG("Ignoring repeated %s of position %d", pressed ? "press" : "release", position);
+            continue;
+        }
+
+        WRITE_BIT(slot->position_state[position / 8], position % 8, pressed);
+        zmk_telemetry_record(ZMK_TELEMETRY_SPLIT_EVENT_RECEIVED, idx,
+                             MIN(now - timestamp, UINT16_MAX));
+
+        // Keep events from one peripheral in order even if the link latency estimate drifts.
+        slot->last_position_event_timestamp = MAX(timestamp, slot->last_position_event_timestamp);
+
+        struct peripheral_event_wrapper ev = {
+            .source = idx,
+            .timestamp = slot->last_position_event_timestamp,
+            .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT,
+                      .data = {.key_position_event = {
+                                   .position = position,
+                                   .pressed = pressed,
+                               }}}};
+        queue_peripheral_event(&ev);
+    }
+
+    submit_peripheral_event_work();
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+static uint8_t split_central_link_pong_notify_func(struct bt_conn *conn,
+                                                   struct bt_gatt_subscribe_params *params,
+                                                   const void *data, uint16_t length) {
+    if (!data) {
+        LOG_DBG("[UNSUBSCRIBED]");
+        params->value_handle = 0U;
+        return BT_GATT_ITER_STOP;
+    }
+
+    struct zmk_split_transport_link_pong pong;
+
+    if (length != sizeof(pong)) {
+        LOG_WRN("Ignoring link pong notify with incorrect data length (%d)", length);
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    memcpy(&pong, data, sizeof(pong));
+
+    // Pongs go through the same queue as key events, so the benchmarks see it fill up.
+    struct peripheral_event_wrapper ev = {
+        .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
+        .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_PONG,
+                  .data = {.link_pong = {
+                               .seq = sys_le32_to_cpu(pong.seq),
+                               .sent_us = sys_le32_to_cpu(pong.sent_us),
+                               .peripheral_us = sys_le32_to_cpu(pong.peripheral_us),
+                               .index = sys_le16_to_cpu(pong.index),
+                           }}}};
+
+    queue_peripheral_event(&ev);
+    submit_peripheral_event_work();
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
@@ -420,13 +635,14 @@ static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
 
     struct peripheral_event_wrapper ev = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
                   .data = {.battery_event = {
                                .level = battery_level,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
+    submit_peripheral_event_work();
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -464,13 +680,14 @@ static uint8_t split_central_battery_level_read_func(struct bt_conn *conn, uint8
 
     struct peripheral_event_wrapper ev = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
                   .data = {.battery_event = {
                                .level = battery_level,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
+    submit_peripheral_event_work();
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -495,6 +712,46 @@ static int split_central_subscribe(struct bt_conn *conn, struct bt_gatt_subscrib
     return err;
 }
 
+static int subscribe_to_peripheral(struct bt_conn *conn, struct peripheral_slot *slot,
+                                   struct bt_gatt_subscribe_params *params, uint16_t value_handle,
+                                   uint16_t ccc_handle, bt_gatt_notify_func_t notify) {
+    // Without a known CCC handle, the stack discovers it using disc_params.
+    params->disc_params = &slot->sub_discover_params;
+    params->end_handle = slot->discover_params.end_handle;
+    params->value_handle = value_handle;
+    params->ccc_handle = ccc_handle;
+    params->notify = notify;
+    params->value = BT_GATT_CCC_NOTIFY;
+    return split_central_subscribe(conn, params);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+
+static int read_peripheral_battery_level(struct bt_conn *conn, struct peripheral_slot *slot,
+                                         uint16_t value_handle) {
+    slot->batt_lvl_read_params.func = split_central_battery_level_read_func;
+    slot->batt_lvl_read_params.handle_count = 1;
+    slot->batt_lvl_read_params.single.handle = value_handle;
+    slot->batt_lvl_read_params.single.offset = 0;
+    return bt_gatt_read(conn, &slot->batt_lvl_read_params);
+}
+
+static int subscribe_to_peripheral_battery_level(struct bt_conn *conn, struct peripheral_slot *slot,
+                                                 uint16_t value_handle, uint16_t ccc_handle) {
+    if (IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS_BATTERY)) {
+        // Changes arrive with the position events, so only the current level is read.
+        slot->batt_lvl_subscribe_params.value_handle = value_handle;
+        slot->batt_lvl_subscribe_params.ccc_handle = ccc_handle;
+    } else {
+        subscribe_to_peripheral(conn, slot, &slot->batt_lvl_subscribe_params, value_handle,
+                                ccc_handle, split_central_battery_level_notify_func);
+    }
+
+    return read_peripheral_battery_level(conn, slot, value_handle);
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+
 static int update_peripheral_selected_layout(struct peripheral_slot *slot, uint8_t layout_idx) {
     if (slot->state != PERIPHERAL_SLOT_STATE_CONNECTED) {
         return -ENOTCONN;
@@ -535,6 +792,240 @@ static void update_peripherals_selected_physical_layout(struct k_work *_work) {
 K_WORK_DEFINE(update_peripherals_selected_layouts_work,
               update_peripherals_selected_physical_layout);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+
+// The handles found by discovery are saved per peripheral slot, along with the peripheral's GATT
+// database hash. On reconnect, reading the hash is a single request, and if it still matches, the
+// cached handles are subscribed to right away instead of discovering the split service again.
+
+#define DB_HASH_LEN 16
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+struct cached_input_handles {
+    uint16_t value_handle;
+    uint16_t ccc_handle;
+    uint8_t reg;
+} __packed;
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+
+struct peripheral_handle_cache {
+    uint8_t db_hash[DB_HASH_LEN];
+    uint16_t position_state;
+    uint16_t position_state_ccc;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+    uint16_t position_events;
+    uint16_t position_events_ccc;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+#if ZMK_KEYMAP_HAS_SENSORS
+    uint16_t sensor_state;
+    uint16_t sensor_state_ccc;
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+    uint16_t run_behavior;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    uint16_t run_behaviors;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    uint16_t rgb_sync;
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    uint16_t link_benchmark;
+    uint16_t link_benchmark_ccc;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    uint16_t selected_physical_layout;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    uint16_t update_hid_indicators;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+    uint16_t battery_level;
+    uint16_t battery_level_ccc;
+#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+    struct cached_input_handles inputs[ARRAY_SIZE(peripheral_input_slots)];
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+} __packed;
+
+static struct peripheral_handle_cache handle_caches[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+static bool handle_cache_valid[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+static int discover_split_service(struct bt_conn *conn, struct peripheral_slot *slot);
+
+static int read_db_hash(struct bt_conn *conn, struct peripheral_slot *slot,
+                        bt_gatt_read_func_t func) {
+    slot->db_hash_read_params.func = func;
+    slot->db_hash_read_params.handle_count = 0;
+    slot->db_hash_read_params.by_uuid.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+    slot->db_hash_read_params.by_uuid.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+    slot->db_hash_read_params.by_uuid.uuid = BT_UUID_GATT_DB_HASH;
+    return bt_gatt_read(conn, &slot->db_hash_read_params);
+}
+
+static uint8_t split_central_db_hash_saved_func(struct bt_conn *conn, uint8_t err,
+                                                struct bt_gatt_read_params *params,
+                                                const void *data, uint16_t length) {
+    int idx = peripheral_slot_index_for_conn(conn);
+    if (idx < 0) {
+        return BT_GATT_ITER_STOP;
+    }
+
+    if (err || !data || length != DB_HASH_LEN) {
+        LOG_DBG("Peripheral %d has no usable database hash, not caching handles (err %d)", idx,
+                err);
+        return BT_GATT_ITER_STOP;
+    }
+
+    // Requests on the bearer are handled in order, so the CCC handles looked up for the
+    // subscriptions made during discovery are known by now.
+    struct peripheral_slot *slot = &peripherals[idx];
+    struct peripheral_handle_cache *cache = &handle_caches[idx];
+
+    *cache = (struct peripheral_handle_cache){
+        .position_state = slot->subscribe_params.value_handle,
+        .position_state_ccc = slot->subscribe_params.ccc_handle,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+        .position_events = slot->position_events_subscribe_params.value_handle,
+        .position_events_ccc = slot->position_events_subscribe_params.ccc_handle,
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+#if ZMK_KEYMAP_HAS_SENSORS
+        .sensor_state = slot->sensor_subscribe_params.value_handle,
+        .sensor_state_ccc = slot->sensor_subscribe_params.ccc_handle,
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+        .run_behavior = slot->run_behavior_handle,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+        .run_behaviors = slot->run_behaviors_handle,
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+        .rgb_sync = slot->rgb_sync_handle,
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+        .link_benchmark = slot->link_benchmark_subscribe_params.value_handle,
+        .link_benchmark_ccc = slot->link_benchmark_subscribe_params.ccc_handle,
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+        .selected_physical_layout = slot->selected_physical_layout_handle,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+        .update_hid_indicators = slot->update_hid_indicators,
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+        .battery_level = slot->batt_lvl_subscribe_params.value_handle,
+        .battery_level_ccc = slot->batt_lvl_subscribe_params.ccc_handle,
+#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+    };
+    memcpy(cache->db_hash, data, DB_HASH_LEN);
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+    size_t input_count = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(peripheral_input_slots); i++) {
+        if (peripheral_input_slots[i].conn == conn && !input_slot_is_pending(i)) {
+            cache->inputs[input_count++] = (struct cached_input_handles){
+                .value_handle = peripheral_input_slots[i].sub.value_handle,
+                .ccc_handle = peripheral_input_slots[i].sub.ccc_handle,
+                .reg = peripheral_input_slots[i].reg,
+            };
+        }
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+
+    if (!cache->position_state_ccc) {
+        LOG_DBG("Position state CCC handle for peripheral %d not known yet, not caching", idx);
+        return BT_GATT_ITER_STOP;
+    }
+
+    handle_cache_valid[idx] = true;
+
+    char setting_name[32];
+    sprintf(setting_name, "ble_central/handles/%d", idx);
+    int ret = settings_save_one(setting_name, cache, sizeof(*cache));
+    if (ret < 0) {
+        LOG_WRN("Failed to save the GATT handles for peripheral %d (%d)", idx, ret);
+    }
+
+    return BT_GATT_ITER_STOP;
+}
+
+static void apply_handle_cache(struct bt_conn *conn, struct peripheral_slot *slot,
+                               const struct peripheral_handle_cache *cache) {
+    slot->discover_params.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+
+    subscribe_to_peripheral(conn, slot, &slot->subscribe_params, cache->position_state,
+                            cache->position_state_ccc, split_central_notify_func);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+    if (cache->position_events) {
+        subscribe_to_peripheral(conn, slot, &slot->position_events_subscribe_params,
+                                cache->position_events, cache->position_events_ccc,
+                                split_central_position_events_notify_func);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+#if ZMK_KEYMAP_HAS_SENSORS
+    subscribe_to_peripheral(conn, slot, &slot->sensor_subscribe_params, cache->sensor_state,
+                            cache->sensor_state_ccc, split_central_sensor_notify_func);
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+    subscribe_to_peripheral_battery_level(conn, slot, cache->battery_level,
+                                          cache->battery_level_ccc);
+#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    if (cache->link_benchmark) {
+        subscribe_to_peripheral(conn, slot, &slot->link_benchmark_subscribe_params,
+                                cache->link_benchmark, cache->link_benchmark_ccc,
+                                split_central_link_pong_notify_func);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+#if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+    for (size_t i = 0; i < ARRAY_SIZE(cache->inputs) && cache->inputs[i].value_handle; i++) {
+        struct peripheral_input_slot *input_slot;
+        if (reserve_next_open_input_slot(&input_slot, conn) < 0) {
+            LOG_WRN("No available slot for cached peripheral input subscription");
+            break;
+        }
+
+        input_slot->sub.value_handle = cache->inputs[i].value_handle;
+        input_slot->sub.ccc_handle = cache->inputs[i].ccc_handle;
+        input_slot->reg = cache->inputs[i].reg;
+        input_slot->sub.notify = peripheral_input_event_notify_cb;
+        input_slot->sub.value = BT_GATT_CCC_NOTIFY;
+        split_central_subscribe(conn, &input_slot->sub);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
+
+    slot->run_behavior_handle = cache->run_behavior;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    slot->run_behaviors_handle = cache->run_behaviors;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    slot->rgb_sync_handle = cache->rgb_sync;
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    slot->update_hid_indicators = cache->update_hid_indicators;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    slot->selected_physical_layout_handle = cache->selected_physical_layout;
+    k_work_submit(&update_peripherals_selected_layouts_work);
+}
+
+static uint8_t split_central_db_hash_check_func(struct bt_conn *conn, uint8_t err,
+                                                struct bt_gatt_read_params *params,
+                                                const void *data, uint16_t length) {
+    int idx = peripheral_slot_index_for_conn(conn);
+    if (idx < 0) {
+        return BT_GATT_ITER_STOP;
+    }
+
+    struct peripheral_slot *slot = &peripherals[idx];
+
+    if (!err && data && length == DB_HASH_LEN &&
+        memcmp(data, handle_caches[idx].db_hash, DB_HASH_LEN) == 0) {
+        LOG_DBG("Database hash for peripheral %d matches, using cached handles", idx);
+        apply_handle_cache(conn, slot, &handle_caches[idx]);
+        return BT_GATT_ITER_STOP;
+    }
+
+    LOG_DBG("Database hash for peripheral %d changed, discovering again (err %d)", idx, err);
+    handle_cache_valid[idx] = false;
+    discover_split_service(conn, slot);
+
+    return BT_GATT_ITER_STOP;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+
 static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
                                                  const struct bt_gatt_attr *attr,
                                                  struct bt_gatt_discover_params *params) {
@@ -562,12 +1053,17 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
         if (bt_uuid_cmp(chrc_uuid, BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_STATE_UUID)) ==
             0) {
             LOG_DBG("Found position state characteristic");
-            slot->subscribe_params.disc_params = &slot->sub_discover_params;
-            slot->subscribe_params.end_handle = slot->discover_params.end_handle;
-            slot->subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
-            slot->subscribe_params.notify = split_central_notify_func;
-            slot->subscribe_params.value = BT_GATT_CCC_NOTIFY;
-            split_central_subscribe(conn, &slot->subscribe_params);
+            subscribe_to_peripheral(conn, slot, &slot->subscribe_params,
+                                    bt_gatt_attr_value_handle(attr), 0, split_central_notify_func);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+        } else if (bt_uuid_cmp(chrc_uuid,
+                               BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_EVENTS_UUID)) == 0) {
+            // Once subscribed, the peripheral stops notifying the position state bitmap.
+            LOG_DBG("Found position events characteristic");
+            subscribe_to_peripheral(conn, slot, &slot->position_events_subscribe_params,
+                                    bt_gatt_attr_value_handle(attr), 0,
+                                    split_central_position_events_notify_func);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
 #if ZMK_KEYMAP_HAS_SENSORS
         } else if (bt_uuid_cmp(chrc_uuid,
                                BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_SENSOR_STATE_UUID)) == 0) {
@@ -575,12 +1071,9 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->discover_params.start_handle = attr->handle + 2;
             slot->discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
 
-            slot->sensor_subscribe_params.disc_params = &slot->sub_discover_params;
-            slot->sensor_subscribe_params.end_handle = slot->discover_params.end_handle;
-            slot->sensor_subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
-            slot->sensor_subscribe_params.notify = split_central_sensor_notify_func;
-            slot->sensor_subscribe_params.value = BT_GATT_CCC_NOTIFY;
-            split_central_subscribe(conn, &slot->sensor_subscribe_params);
+            subscribe_to_peripheral(conn, slot, &slot->sensor_subscribe_params,
+                                    bt_gatt_attr_value_handle(attr), 0,
+                                    split_central_sensor_notify_func);
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
         } else if (bt_uuid_cmp(chrc_uuid, BT_UUID_DECLARE_128(ZMK_SPLIT_BT_INPUT_EVENT_UUID)) ==
@@ -609,6 +1102,25 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
             slot->discover_params.uuid = NULL;
             slot->discover_params.start_handle = attr->handle + 2;
             slot->run_behavior_handle = bt_gatt_attr_value_handle(attr);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+        } else if (!bt_uuid_cmp(chrc_uuid,
+                                BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RUN_BEHAVIORS_UUID))) {
+            LOG_DBG("Found run behaviors handle");
+            slot->run_behaviors_handle = bt_gatt_attr_value_handle(attr);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+        } else if (!bt_uuid_cmp(chrc_uuid, BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RGB_SYNC_UUID))) {
+            LOG_DBG("Found RGB sync handle");
+            slot->rgb_sync_handle = bt_gatt_attr_value_handle(attr);
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+        } else if (!bt_uuid_cmp(chrc_uuid,
+                                BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_LINK_BENCHMARK_UUID))) {
+            LOG_DBG("Found link benchmark characteristic");
+            subscribe_to_peripheral(conn, slot, &slot->link_benchmark_subscribe_params,
+                                    bt_gatt_attr_value_handle(attr), 0,
+                                    split_central_link_pong_notify_func);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
         } else if (!bt_uuid_cmp(((struct bt_gatt_chrc *)attr->user_data)->uuid,
                                 BT_UUID_DECLARE_128(ZMK_SPLIT_BT_SELECT_PHYS_LAYOUT_UUID))) {
             LOG_DBG("Found select physical layout handle");
@@ -624,18 +1136,7 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
         } else if (!bt_uuid_cmp(((struct bt_gatt_chrc *)attr->user_data)->uuid,
                                 BT_UUID_BAS_BATTERY_LEVEL)) {
             LOG_DBG("Found battery level characteristics");
-            slot->batt_lvl_subscribe_params.disc_params = &slot->sub_discover_params;
-            slot->batt_lvl_subscribe_params.end_handle = slot->discover_params.end_handle;
-            slot->batt_lvl_subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
-            slot->batt_lvl_subscribe_params.notify = split_central_battery_level_notify_func;
-            slot->batt_lvl_subscribe_params.value = BT_GATT_CCC_NOTIFY;
-            split_central_subscribe(conn, &slot->batt_lvl_subscribe_params);
-
-            slot->batt_lvl_read_params.func = split_central_battery_level_read_func;
-            slot->batt_lvl_read_params.handle_count = 1;
-            slot->batt_lvl_read_params.single.handle = bt_gatt_attr_value_handle(attr);
-            slot->batt_lvl_read_params.single.offset = 0;
-            bt_gatt_read(conn, &slot->batt_lvl_read_params);
+            subscribe_to_peripheral_battery_level(conn, slot, bt_gatt_attr_value_handle(attr), 0);
 #endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
         }
         break;
@@ -707,6 +1208,12 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
     }
 #endif // IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+    if (subscribed) {
+        read_db_hash(conn, slot, split_central_db_hash_saved_func);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+
     return subscribed ? BT_GATT_ITER_STOP : BT_GATT_ITER_CONTINUE;
 }
 
@@ -745,27 +1252,46 @@ static uint8_t split_central_service_discovery_func(struct bt_conn *conn,
     return BT_GATT_ITER_STOP;
 }
 
+static int discover_split_service(struct bt_conn *conn, struct peripheral_slot *slot) {
+    slot->discover_params.uuid = &split_service_uuid.uuid;
+    slot->discover_params.func = split_central_service_discovery_func;
+    slot->discover_params.start_handle = 0x0001;
+    slot->discover_params.end_handle = 0xffff;
+    slot->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
+
+    int err = bt_gatt_discover(conn, &slot->discover_params);
+    if (err) {
+        LOG_ERR("Discover failed(err %d)", err);
+    }
+
+    return err;
+}
+
 static void split_central_process_connection(struct bt_conn *conn) {
     int err;
 
     LOG_DBG("Current security for connection: %d", bt_conn_get_security(conn));
 
-    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
-    if (slot == NULL) {
+    int idx = peripheral_slot_index_for_conn(conn);
+    if (idx < 0) {
         LOG_ERR("No peripheral state found for connection");
         return;
     }
 
+    struct peripheral_slot *slot = &peripherals[idx];
+
     if (!slot->subscribe_params.value_handle) {
-        slot->discover_params.uuid = &split_service_uuid.uuid;
-        slot->discover_params.func = split_central_service_discovery_func;
-        slot->discover_params.start_handle = 0x0001;
-        slot->discover_params.end_handle = 0xffff;
-        slot->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+        if (handle_cache_valid[idx]) {
+            err = read_db_hash(conn, slot, split_central_db_hash_check_func);
+        } else {
+            err = discover_split_service(conn, slot);
+        }
+#else
+        err = discover_split_service(conn, slot);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
 
-        err = bt_gatt_discover(slot->conn, &slot->discover_params);
         if (err) {
-            LOG_ERR("Discover failed(err %d)", err);
             return;
         }
     }
@@ -781,6 +1307,79 @@ static void split_central_process_connection(struct bt_conn *conn) {
     start_scanning();
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+
+// Once the addresses of all missing peripherals are known, the controller is left to connect to
+// whichever of them advertises first, instead of the host scanning, stopping and connecting to
+// them one at a time.
+
+static bool is_auto_connecting = false;
+
+static int start_auto_connect(void) {
+    if (is_auto_connecting) {
+        return 0;
+    }
+
+    int err = bt_le_filter_accept_list_clear();
+    if (err < 0) {
+        LOG_WRN("Failed to clear the filter accept list (err %d)", err);
+        return err;
+    }
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (peripherals[i].state != PERIPHERAL_SLOT_STATE_OPEN) {
+            continue;
+        }
+
+        const bt_addr_le_t *addr = zmk_ble_get_peripheral_addr(i);
+        if (addr == NULL) {
+            // Peripherals that haven't been paired yet can only be found by scanning.
+            return -ENOENT;
+        }
+
+        err = bt_le_filter_accept_list_add(addr);
+        if (err < 0) {
+            LOG_WRN("Failed to add a peripheral to the filter accept list (err %d)", err);
+            return err;
+        }
+    }
+
+    struct bt_le_conn_param *param =
+        BT_LE_CONN_PARAM(CONFIG_ZMK_SPLIT_BLE_PREF_INT, CONFIG_ZMK_SPLIT_BLE_PREF_INT,
+                         CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY, CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT);
+    err = bt_conn_le_create_auto(BT_CONN_LE_CREATE_CONN, param);
+    if (err < 0) {
+        LOG_WRN("Failed to start connecting to known peripherals (err %d)", err);
+        return err;
+    }
+
+    LOG_DBG("Connecting to known peripherals");
+    is_auto_connecting = true;
+    return 0;
+}
+
+static int stop_auto_connect(void) {
+    if (!is_auto_connecting) {
+        return 0;
+    }
+
+    is_auto_connecting = false;
+    return bt_conn_create_auto_stop();
+}
+
+static int claim_auto_connected_peripheral(struct bt_conn *conn) {
+    int idx = reserve_peripheral_slot(bt_conn_get_dst(conn));
+    if (idx < 0) {
+        return idx;
+    }
+
+    peripherals[idx].conn = bt_conn_ref(conn);
+    index_peripheral_conn(idx);
+    return idx;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+
 static int stop_scanning(void) {
     LOG_DBG("Stopping peripheral scanning");
     is_scanning = false;
@@ -822,8 +1421,11 @@ static bool split_central_eir_found(const bt_addr_le_t *addr) {
         LOG_ERR("Create conn failed (err %d) (create conn? 0x%04x)", err, BT_HCI_OP_LE_CREATE_CONN);
         release_peripheral_slot(slot_idx);
         start_scanning();
+        return false;
     }
 
+    index_peripheral_conn(slot_idx);
+
     return false;
 }
 
@@ -907,6 +1509,12 @@ static int start_scanning(void) {
         return 0;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+    if (start_auto_connect() == 0) {
+        return 0;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+
     // Start scanning otherwise.
     is_scanning = true;
     int err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, split_central_device_found);
@@ -932,6 +1540,18 @@ static void split_central_connected(struct bt_conn *conn, uint8_t conn_err) {
         return;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+    if (is_auto_connecting && peripheral_slot_index_for_conn(conn) < 0) {
+        is_auto_connecting = false;
+
+        if (!conn_err && claim_auto_connected_peripheral(conn) < 0) {
+            LOG_WRN("No peripheral slot for auto connected %s", addr);
+            bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+            return;
+        }
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+
     if (conn_err) {
         LOG_ERR("Failed to connect to %s (%u)", addr, conn_err);
 
@@ -959,13 +1579,14 @@ static void split_central_disconnected(struct bt_conn *conn, uint8_t reason) {
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     struct peripheral_event_wrapper ev = {
         .source = peripheral_slot_index_for_conn(conn),
+        .timestamp = k_uptime_get(),
         .event = {.type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT,
                   .data = {.battery_event = {
                                .level = 0,
                            }}}};
 
-    k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_event_work);
+    queue_peripheral_event(&ev);
+    submit_peripheral_event_work();
     // struct zmk_peripheral_battery_state_changed ev = {
     //     .source = peripheral_slot_index_for_conn(conn), .state_of_charge = 0};
     // k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
@@ -1026,6 +1647,157 @@ struct central_cmd_wrapper {
 K_MSGQ_DEFINE(zmk_split_central_split_run_msgq, sizeof(struct central_cmd_wrapper),
               CONFIG_ZMK_SPLIT_BLE_CENTRAL_SPLIT_RUN_QUEUE_SIZE, 4);
 
+ZMK_QUEUE_STATS_DEFINE(split_run_msgq, "peripheral commands",
+                       CONFIG_ZMK_SPLIT_BLE_CENTRAL_SPLIT_RUN_QUEUE_SIZE);
+
+static void write_run_behavior(struct peripheral_slot *slot, const char *behavior_dev,
+                               uint32_t param1, uint32_t param2, uint32_t position,
+                               uint8_t source, uint8_t state) {
+    if (!slot->run_behavior_handle) {
+        LOG_ERR("Run behavior handle not found");
+        return;
+    }
+
+    struct zmk_split_run_behavior_payload payload = {.data = {
+                                                         .param1 = param1,
+                                                         .param2 = param2,
+                                                         .position = position,
+                                                         .source = source,
+                                                         .state = state ? 1 : 0,
+                                                     }};
+    const size_t payload_dev_size = sizeof(payload.behavior_dev);
+    if (strlcpy(payload.behavior_dev, behavior_dev, payload_dev_size) >= payload_dev_size) {
+        LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
+                behavior_dev, payload.behavior_dev);
+    }
+
+    int err = bt_gatt_write_without_response(slot->conn, slot->run_behavior_handle, &payload,
+                                             sizeof(struct zmk_split_run_behavior_payload), true);
+
+    if (err) {
+        LOG_ERR("Failed to write the behavior characteristic (err %d)", err);
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+#define RUN_BEHAVIORS_MAX_LEN                                                                      \
+    (sizeof(struct zmk_split_run_behaviors_payload) +                                              \
+     CONFIG_ZMK_SPLIT_BEHAVIOR_BATCH_SIZE * sizeof(struct zmk_split_run_behaviors_entry))
+
+static void write_run_behaviors(struct peripheral_slot *slot,
+                                const struct zmk_split_transport_central_command *cmd) {
+    const typeof(cmd->data.invoke_behavior_batch) *batch = &cmd->data.invoke_behavior_batch;
+    size_t count = MIN(batch->count, ARRAY_SIZE(batch->invocations));
+
+    // The ATT header takes three bytes of the MTU.
+    size_t per_write = (bt_gatt_get_mtu(slot->conn) - 3 -
+                        sizeof(struct zmk_split_run_behaviors_payload)) /
+                       sizeof(struct zmk_split_run_behaviors_entry);
+
+    if (!slot->run_behaviors_handle || per_write == 0) {
+        // Fall back to one write per invocation, losing the waits between them.
+        for (size_t i = 0; i < count; i++) {
+            write_run_behavior(slot, batch->invocations[i].behavior_dev,
+                               batch->invocations[i].param1, batch->invocations[i].param2,
+                               batch->position, batch->event_source, batch->invocations[i].state);
+        }
+        return;
+    }
+
+    uint8_t buf[RUN_BEHAVIORS_MAX_LEN];
+    struct zmk_split_run_behaviors_payload *payload = (struct zmk_split_run_behaviors_payload *)buf;
+
+    payload->position = batch->position;
+    payload->source = batch->event_source;
+
+    // Batches that don't fit the MTU are split. The chunks all go to the same queue lane on the
+    // peripheral, so the last wait of a chunk still delays the first invocation of the next one.
+    for (size_t start = 0; start < count; start += per_write) {
+        size_t chunk = MIN(per_write, count - start);
+
+        for (size_t i = 0; i < chunk; i++) {
+            const struct zmk_split_transport_behavior_invocation *inv =
+                &batch->invocations[start + i];
+            struct zmk_split_run_behaviors_entry *entry = &payload->entries[i];
+
+            *entry = (struct zmk_split_run_behaviors_entry){
+                .state = inv->state ? 1 : 0,
+                .wait_ms = sys_cpu_to_le16(inv->wait_ms),
+                .param1 = sys_cpu_to_le32(inv->param1),
+                .param2 = sys_cpu_to_le32(inv->param2),
+            };
+
+            if (strlcpy(entry->behavior_dev, inv->behavior_dev, sizeof(entry->behavior_dev)) >=
+                sizeof(entry->behavior_dev)) {
+                LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
+                        inv->behavior_dev, entry->behavior_dev);
+            }
+        }
+
+        int err = bt_gatt_write_without_response(
+            slot->conn, slot->run_behaviors_handle, buf,
+            sizeof(struct zmk_split_run_behaviors_payload) +
+                chunk * sizeof(struct zmk_split_run_behaviors_entry),
+            true);
+        if (err) {
+            LOG_ERR("Failed to write the run behaviors characteristic (err %d)", err);
+            return;
+        }
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+static void write_rgb_sync(struct peripheral_slot *slot,
+                           const struct zmk_split_transport_central_command *cmd) {
+    // Peripherals running firmware without the characteristic just keep animating on their own.
+    if (!slot->rgb_sync_handle) {
+        return;
+    }
+
+    struct zmk_split_transport_rgb_sync payload = cmd->data.set_rgb_sync;
+
+    payload.elapsed_ms = sys_cpu_to_le32(payload.elapsed_ms);
+    payload.hue = sys_cpu_to_le16(payload.hue);
+
+    int err = bt_gatt_write_without_response(slot->conn, slot->rgb_sync_handle, &payload,
+                                             sizeof(payload), true);
+    if (err) {
+        LOG_ERR("Failed to write the RGB sync characteristic (err %d)", err);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+static void write_link_ping(struct peripheral_slot *slot,
+                            const struct zmk_split_transport_central_command *cmd) {
+    if (!slot->link_benchmark_subscribe_params.value_handle) {
+        LOG_WRN("Peripheral has no link benchmark characteristic");
+        return;
+    }
+
+    struct zmk_split_transport_link_ping payload = {
+        .seq = sys_cpu_to_le32(cmd->data.link_ping.seq),
+        .sent_us = sys_cpu_to_le32(cmd->data.link_ping.sent_us),
+        .count = sys_cpu_to_le16(cmd->data.link_ping.count),
+        .rate = sys_cpu_to_le16(cmd->data.link_ping.rate),
+    };
+
+    int err = bt_gatt_write_without_response(
+        slot->conn, slot->link_benchmark_subscribe_params.value_handle, &payload, sizeof(payload),
+        true);
+    if (err) {
+        LOG_ERR("Failed to write the link benchmark characteristic (err %d)", err);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 void split_central_split_run_callback(struct k_work *work) {
     struct central_cmd_wrapper payload_wrapper;
 
@@ -1038,38 +1810,20 @@ void split_central_split_run_callback(struct k_work *work) {
         }
 
         switch (payload_wrapper.cmd.type) {
-        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
-            if (!peripherals[payload_wrapper.source].run_behavior_handle) {
-                LOG_ERR("Run behavior handle not found");
-                continue;
-            }
-
-            struct zmk_split_run_behavior_payload payload = {
-                .data = {
-                    .param1 = payload_wrapper.cmd.data.invoke_behavior.param1,
-                    .param2 = payload_wrapper.cmd.data.invoke_behavior.param2,
-                    .position = payload_wrapper.cmd.data.invoke_behavior.position,
-                    .source = payload_wrapper.cmd.data.invoke_behavior.event_source,
-                    .state = payload_wrapper.cmd.data.invoke_behavior.state ? 1 : 0,
-                }};
-            const size_t payload_dev_size = sizeof(payload.behavior_dev);
-            if (strlcpy(payload.behavior_dev, payload_wrapper.cmd.data.invoke_behavior.behavior_dev,
-                        payload_dev_size) >= payload_dev_size) {
-                LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
-                        payload_wrapper.cmd.data.invoke_behavior.behavior_dev,
-                        payload.behavior_dev);
-            }
-
-            int err = bt_gatt_write_without_response(
-                peripherals[payload_wrapper.source].conn,
-                peripherals[payload_wrapper.source].run_behavior_handle, &payload,
-                sizeof(struct zmk_split_run_behavior_payload), true);
-
-            if (err) {
-                LOG_ERR("Failed to write the behavior characteristic (err %d)", err);
-            }
+        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR:
+            write_run_behavior(&peripherals[payload_wrapper.source],
+                               payload_wrapper.cmd.data.invoke_behavior.behavior_dev,
+                               payload_wrapper.cmd.data.invoke_behavior.param1,
+                               payload_wrapper.cmd.data.invoke_behavior.param2,
+                               payload_wrapper.cmd.data.invoke_behavior.position,
+                               payload_wrapper.cmd.data.invoke_behavior.event_source,
+                               payload_wrapper.cmd.data.invoke_behavior.state);
             break;
-        }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR_BATCH:
+            write_run_behaviors(&peripherals[payload_wrapper.source], &payload_wrapper.cmd);
+            break;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
         case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
             update_peripheral_selected_layout(
                 &peripherals[payload_wrapper.source],
@@ -1097,6 +1851,16 @@ void split_central_split_run_callback(struct k_work *work) {
             }
             break;
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_RGB_SYNC:
+            write_rgb_sync(&peripherals[payload_wrapper.source], &payload_wrapper.cmd);
+            break;
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+        case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_LINK_PING:
+            write_link_ping(&peripherals[payload_wrapper.source], &payload_wrapper.cmd);
+            break;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
         default:
             LOG_WRN("Unsupported wrapped central command type %d", payload_wrapper.cmd.type);
             return;
@@ -1109,7 +1873,9 @@ K_WORK_DEFINE(split_central_split_run_work, split_central_split_run_callback);
 static int split_bt_invoke_behavior_payload(struct central_cmd_wrapper payload_wrapper) {
     LOG_DBG("");
 
-    int err = k_msgq_put(&zmk_split_central_split_run_msgq, &payload_wrapper, K_MSEC(100));
+    // A full queue loses its oldest command below, which counts as an overflow.
+    int err = ZMK_QUEUE_STATS_MSGQ_PUT(split_run_msgq, &zmk_split_central_split_run_msgq,
+                                       &payload_wrapper, K_MSEC(100));
     if (err) {
         switch (err) {
         case -EAGAIN: {
@@ -1137,6 +1903,31 @@ static bool settings_loaded = false;
 
 static int central_ble_handle_set(const char *name, size_t len, settings_read_cb read_cb,
                                   void *cb_arg) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+    const char *next;
+
+    if (settings_name_steq(name, "handles", &next) && next) {
+        int i = atoi(next);
+        if (i < 0 || i >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+            LOG_ERR("Invalid peripheral slot for cached GATT handles");
+            return 0;
+        }
+
+        // Cached with a different set of features enabled, so discover again.
+        if (len != sizeof(struct peripheral_handle_cache)) {
+            return 0;
+        }
+
+        int err = read_cb(cb_arg, &handle_caches[i], sizeof(struct peripheral_handle_cache));
+        if (err <= 0) {
+            LOG_ERR("Failed to handle cached GATT handles from settings (err %d)", err);
+            return err;
+        }
+
+        handle_cache_valid[i] = true;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_HANDLE_CACHE)
+
     return 0;
 }
 
@@ -1146,6 +1937,12 @@ static struct settings_handler ble_central_settings_handler = {
 #endif // IS_ENABLED(CONFIG_SETTINGS)
 
 static int zmk_split_bt_central_init(void) {
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        k_msgq_init(&peripheral_event_msgqs[i], peripheral_event_buffers[i],
+                    sizeof(struct peripheral_event_wrapper),
+                    CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE);
+    }
+
     k_work_queue_start(&split_central_split_run_q, split_central_split_run_q_stack,
                        K_THREAD_STACK_SIZEOF(split_central_split_run_q_stack),
                        CONFIG_ZMK_BLE_THREAD_PRIORITY, NULL);
@@ -1161,15 +1958,86 @@ static int zmk_split_bt_central_init(void) {
 
 SYS_INIT(zmk_split_bt_central_init, APPLICATION, CONFIG_ZMK_BLE_INIT_PRIORITY);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY)
+
+// Peripherals can always send on the next connection event, but with peripheral latency they may
+// not be listening for the central's writes. Drop the latency while keys are being pressed, and
+// restore it once the split links have been quiet for a while. The interval stays at the minimum.
+
+static atomic_t split_links_low_latency;
+static atomic_t last_split_activity;
+
+static void update_peripheral_latency(uint16_t latency) {
+    struct bt_le_conn_param param =
+        BT_LE_CONN_PARAM_INIT(CONFIG_ZMK_SPLIT_BLE_PREF_INT, CONFIG_ZMK_SPLIT_BLE_PREF_INT, latency,
+                              CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT);
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (peripherals[i].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+            continue;
+        }
+
+        int err = bt_conn_le_param_update(peripherals[i].conn, &param);
+        if (err && err != -EALREADY) {
+            LOG_WRN("Failed to update peripheral %d connection latency (%d)", i, err);
+        }
+    }
+}
+
+static void split_links_relax_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(split_links_relax_work, split_links_relax_work_cb);
+
+static void split_links_relax_work_cb(struct k_work *work) {
+    uint32_t quiet_ms = k_uptime_get_32() - (uint32_t)atomic_get(&last_split_activity);
+
+    if (quiet_ms < CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY_QUIET_MS) {
+        k_work_reschedule(&split_links_relax_work,
+                          K_MSEC(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY_QUIET_MS - quiet_ms));
+        return;
+    }
+
+    if (atomic_cas(&split_links_low_latency, true, false)) {
+        LOG_DBG("Restoring split peripheral latency after %u ms without activity", quiet_ms);
+        update_peripheral_latency(CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY);
+    }
+}
+
+static void split_links_boost_work_cb(struct k_work *work) {
+    LOG_DBG("Dropping split peripheral latency");
+    update_peripheral_latency(0);
+    k_work_reschedule(&split_links_relax_work, K_MSEC(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY_QUIET_MS));
+}
+
+static K_WORK_DEFINE(split_links_boost_work, split_links_boost_work_cb);
+
+static void note_split_activity(void) {
+    atomic_set(&last_split_activity, k_uptime_get_32());
+
+    if (atomic_cas(&split_links_low_latency, false, true)) {
+        k_work_submit(&split_links_boost_work);
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY)
+
 static int zmk_split_bt_central_listener_cb(const zmk_event_t *eh) {
     if (as_zmk_physical_layout_selection_changed(eh)) {
         k_work_submit(&update_peripherals_selected_layouts_work);
     }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY)
+    if (as_zmk_position_state_changed(eh)) {
+        note_split_activity();
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY)
     return ZMK_EV_EVENT_BUBBLE;
 }
 
 ZMK_LISTENER(zmk_split_bt_central, zmk_split_bt_central_listener_cb);
 ZMK_SUBSCRIPTION(zmk_split_bt_central, zmk_physical_layout_selection_changed);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY)
+ZMK_SUBSCRIPTION_PRIORITY(zmk_split_bt_central, zmk_position_state_changed, OBSERVER);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_LOW_LATENCY)
 
 static int split_central_bt_send_command(uint8_t source,
                                          struct zmk_split_transport_central_command cmd) {
@@ -1180,7 +2048,17 @@ static int split_central_bt_send_command(uint8_t source,
     switch (cmd.type) {
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS:
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_PHYSICAL_LAYOUT:
-    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR: {
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR:
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR_BATCH:
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_RGB_SYNC:
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_LINK_PING:
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    {
         struct central_cmd_wrapper wrapper = {.source = source, .cmd = cmd};
         return split_bt_invoke_behavior_payload(wrapper);
     }
@@ -1216,6 +2094,13 @@ static int split_central_bt_set_enabled(bool enabled) {
             LOG_WRN("Failed to stop scanning for peripherals (%d)", err);
         }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+        err = stop_auto_connect();
+        if (err < 0) {
+            LOG_WRN("Failed to stop connecting to known peripherals (%d)", err);
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_AUTO_CONNECT)
+
         for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
             if (peripherals[i].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
                 continue;
@@ -1285,11 +2170,70 @@ static int finish_init() {
     return transport_status_cb(&bt_central, split_central_bt_get_status());
 }
 
+// Key position events taken in one drain, kept sorted by timestamp across peripherals, and raised
+// as one run merged with the local kscan events pending at the same time.
+static struct zmk_position_state_changed
+    position_run[CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE];
+static size_t position_run_len;
+
+static void flush_position_run(void) {
+    if (position_run_len == 0) {
+        return;
+    }
+
+    zmk_split_transport_central_position_event_run_handler(&bt_central, position_run,
+                                                           position_run_len);
+    position_run_len = 0;
+}
+
+static void add_to_position_run(const struct peripheral_event_wrapper *ev) {
+    if (position_run_len == ARRAY_SIZE(position_run)) {
+        flush_position_run();
+    }
+
+    // Each peripheral's events arrive in order, so inserting after equal timestamps keeps them so.
+    size_t i = position_run_len++;
+    for (; i > 0 && position_run[i - 1].timestamp > ev->timestamp; i--) {
+        position_run[i] = position_run[i - 1];
+    }
+
+    position_run[i] = (struct zmk_position_state_changed){
+        .source = ev->source,
+        .position = ev->event.data.key_position_event.position,
+        .state = ev->event.data.key_position_event.pressed,
+        .timestamp = ev->timestamp,
+    };
+}
+
 void peripheral_event_work_callback(struct k_work *work) {
+    static uint8_t next_queue;
     struct peripheral_event_wrapper ev;
-    while (k_msgq_get(&peripheral_event_msgq, &ev, K_NO_WAIT) == 0) {
+    int empty_queues = 0;
+
+    // Take one event from each queue in turn until all of them are empty.
+    while (empty_queues < ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        struct k_msgq *msgq = &peripheral_event_msgqs[next_queue];
+        next_queue = (next_queue + 1) % ZMK_SPLIT_BLE_PERIPHERAL_COUNT;
+
+        if (k_msgq_get(msgq, &ev, K_NO_WAIT) < 0) {
+            empty_queues++;
+            continue;
+        }
+
+        empty_queues = 0;
         LOG_DBG("Trigger key position state change for %d",
                 ev.event.data.key_position_event.position);
-        zmk_split_transport_central_peripheral_event_handler(&bt_central, ev.source, ev.event);
+
+        if (ev.event.type == ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_KEY_POSITION_EVENT) {
+            add_to_position_run(&ev);
+            continue;
+        }
+
+        // Other events stay ordered after the key positions taken before them.
+        flush_position_run();
+        zmk_split_transport_central_timed_peripheral_event_handler(&bt_central, ev.source, ev.event,
+                                                                   ev.timestamp);
     }
+
+    flush_position_run();
 }
@@ -14,6 +14,7 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/uuid.h>
 
@@ -22,6 +23,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/behavior.h>
 #include <zmk/matrix.h>
 #include <zmk/physical_layouts.h>
+#include <zmk/queue_stats.h>
 #include <zmk/split/transport/peripheral.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/split/bluetooth/service.h>
@@ -35,6 +37,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/sensor_event.h>
 #include <zmk/sensors.h>
 
+#define POSITION_EVENTS_BATTERY                                                                    \
+    (IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS_BATTERY) &&                                   \
+     IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING))
+
 #if ZMK_KEYMAP_HAS_SENSORS
 static struct sensor_event last_sensor_event;
 
@@ -66,15 +72,55 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
                                       const void *buf, uint16_t len, uint16_t offset,
                                       uint8_t flags);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+static ssize_t split_svc_run_behaviors(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                       const void *buf, uint16_t len, uint16_t offset,
+                                       uint8_t flags);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
 static ssize_t split_svc_num_of_positions(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
                                           void *buf, uint16_t len, uint16_t offset) {
     return bt_gatt_attr_read(conn, attrs, buf, len, offset, attrs->user_data, sizeof(uint8_t));
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+
+static void replay_subscription_changed(void);
+static void replay_disconnected(bool position_in_flight);
+
+#else
+
+static inline void replay_subscription_changed(void) {}
+static inline void replay_disconnected(bool position_in_flight) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+
+static atomic_t position_state_subscribed;
+
 static void split_svc_pos_state_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
     LOG_DBG("value %d", value);
+    atomic_set(&position_state_subscribed, value == BT_GATT_CCC_NOTIFY);
+    replay_subscription_changed();
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+
+BUILD_ASSERT(ZMK_KEYMAP_LEN <= ZMK_SPLIT_POSITION_EVENT_PRESSED,
+             "Position events carry key positions in seven bits, disable "
+             "CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS for keymaps with more than 128 positions");
+
+static atomic_t position_events_subscribed;
+
+static void split_svc_pos_events_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
+    LOG_DBG("value %d", value);
+    atomic_set(&position_events_subscribed, value == BT_GATT_CCC_NOTIFY);
+    replay_subscription_changed();
 }
 
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
 static zmk_hid_indicators_t hid_indicators = 0;
@@ -103,6 +149,62 @@ static ssize_t split_svc_update_indicators(struct bt_conn *conn, const struct bt
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+static ssize_t split_svc_rgb_sync(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                  const void *buf, uint16_t len, uint16_t offset, uint8_t flags) {
+    struct zmk_split_transport_central_command cmd = {
+        .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_RGB_SYNC,
+    };
+
+    if (offset != 0 || len != sizeof(cmd.data.set_rgb_sync)) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    memcpy(&cmd.data.set_rgb_sync, buf, len);
+    cmd.data.set_rgb_sync.elapsed_ms = sys_le32_to_cpu(cmd.data.set_rgb_sync.elapsed_ms);
+    cmd.data.set_rgb_sync.hue = sys_le16_to_cpu(cmd.data.set_rgb_sync.hue);
+
+    int err = zmk_split_transport_peripheral_command_handler(zmk_split_transport_peripheral_bt(),
+                                                             cmd);
+    if (err) {
+        LOG_ERR("Failed to apply the RGB sync: %d", err);
+    }
+
+    return len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+static void split_svc_link_benchmark_ccc(const struct bt_gatt_attr *attr, uint16_t value) {
+    LOG_DBG("value %d", value);
+}
+
+static ssize_t split_svc_link_ping(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                   const void *buf, uint16_t len, uint16_t offset, uint8_t flags) {
+    struct zmk_split_transport_central_command cmd = {
+        .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_LINK_PING,
+    };
+
+    if (offset != 0 || len != sizeof(cmd.data.link_ping)) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    memcpy(&cmd.data.link_ping, buf, len);
+    cmd.data.link_ping.seq = sys_le32_to_cpu(cmd.data.link_ping.seq);
+    cmd.data.link_ping.sent_us = sys_le32_to_cpu(cmd.data.link_ping.sent_us);
+    cmd.data.link_ping.count = sys_le16_to_cpu(cmd.data.link_ping.count);
+    cmd.data.link_ping.rate = sys_le16_to_cpu(cmd.data.link_ping.rate);
+
+    zmk_split_transport_peripheral_command_handler(zmk_split_transport_peripheral_bt(), cmd);
+
+    return len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 static uint8_t selected_phys_layout = 0;
 
 static void split_svc_select_phys_layout_callback(struct k_work *work) {
@@ -184,6 +286,11 @@ BT_GATT_SERVICE_DEFINE(
                            BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_READ_ENCRYPT,
                            split_svc_pos_state, NULL, &position_state),
     BT_GATT_CCC(split_svc_pos_state_ccc, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_POSITION_EVENTS_UUID),
+                           BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_READ_ENCRYPT, NULL, NULL, NULL),
+    BT_GATT_CCC(split_svc_pos_events_ccc, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
     BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_UUID),
                            BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
                            split_svc_run_behavior, &behavior_run_payload),
@@ -201,98 +308,556 @@ BT_GATT_SERVICE_DEFINE(
                                BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
                                split_svc_update_indicators, NULL),
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RUN_BEHAVIORS_UUID),
+                           BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
+                           split_svc_run_behaviors, NULL),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RGB_SYNC_UUID),
+                           BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
+                           split_svc_rgb_sync, NULL),
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
     BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_SELECT_PHYS_LAYOUT_UUID),
                            BT_GATT_CHRC_WRITE | BT_GATT_CHRC_READ,
                            BT_GATT_PERM_WRITE_ENCRYPT | BT_GATT_PERM_READ_ENCRYPT,
                            split_svc_get_selected_phys_layout, split_svc_select_phys_layout,
-                           NULL), );
+                           NULL),
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    // Kept last, so the attribute indexes used to notify the other characteristics don't change.
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_LINK_BENCHMARK_UUID),
+                           BT_GATT_CHRC_WRITE_WITHOUT_RESP | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_WRITE_ENCRYPT, NULL, split_svc_link_ping, NULL),
+    BT_GATT_CCC(split_svc_link_benchmark_ccc,
+                BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+);
 
 K_THREAD_STACK_DEFINE(service_q_stack, CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_STACK_SIZE);
 
 struct k_work_q service_work_q;
 
-K_MSGQ_DEFINE(position_state_msgq, sizeof(char[POS_STATE_LEN]),
-              CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
+#define SPLIT_SVC_POSITION_STATE_ATTR_IDX 1
 
-void send_position_state_callback(struct k_work *work) {
-    uint8_t state[POS_STATE_LEN];
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+#define SPLIT_SVC_POSITION_EVENTS_ATTR_IDX 4
+#define SPLIT_SVC_SENSOR_STATE_ATTR_IDX 11
+#else
+#define SPLIT_SVC_SENSOR_STATE_ATTR_IDX 8
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
 
-    while (k_msgq_get(&position_state_msgq, &state, K_NO_WAIT) == 0) {
-        int err = bt_gatt_notify(NULL, &split_svc.attrs[1], &state, sizeof(state));
-        if (err) {
-            LOG_DBG("Error notifying %d", err);
-        }
-    }
+// Nothing on the scan path waits for the radio. Changes are recorded below and flagged as pending
+// for their characteristic, then the notify work sends one notification per characteristic at a
+// time. The next one is sent from the completion callback, once the stack has a TX buffer again.
+
+enum split_svc_notification {
+    SPLIT_SVC_NOTIFY_POSITION,
+#if ZMK_KEYMAP_HAS_SENSORS
+    SPLIT_SVC_NOTIFY_SENSOR,
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+    SPLIT_SVC_NOTIFY_COUNT,
 };
 
-K_WORK_DEFINE(service_position_notify_work, send_position_state_callback);
+static ATOMIC_DEFINE(pending_notifications, SPLIT_SVC_NOTIFY_COUNT);
+static ATOMIC_DEFINE(notifications_in_flight, SPLIT_SVC_NOTIFY_COUNT);
+
+static struct bt_gatt_notify_params notify_params[SPLIT_SVC_NOTIFY_COUNT];
+
+static void split_svc_notify_work_cb(struct k_work *work);
+
+K_WORK_DEFINE(service_notify_work, split_svc_notify_work_cb);
+
+static void schedule_notification(enum split_svc_notification type) {
+    atomic_set_bit(pending_notifications, type);
+    k_work_submit_to_queue(&service_work_q, &service_notify_work);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_LATENCY_STATS)
+
+// Key events in the position notification being sent, with timestamps relative to the oldest.
+static struct {
+    uint32_t oldest;
+    uint32_t newest;
+    uint32_t offsets;
+    uint16_t count;
+} in_flight_positions;
+
+static struct k_spinlock latency_stats_lock;
+static struct zmk_split_bt_latency_stats latency_stats;
+
+static void start_position_latency(void) { in_flight_positions.count = 0; }
+
+static void track_position_latency(uint32_t timestamp) {
+    if (in_flight_positions.count++ == 0) {
+        in_flight_positions.oldest = timestamp;
+        in_flight_positions.offsets = 0;
+    }
+
+    in_flight_positions.offsets += timestamp - in_flight_positions.oldest;
+    in_flight_positions.newest = timestamp;
+}
+
+static void record_position_latency(void) {
+    uint32_t now = k_uptime_get_32();
+    uint32_t oldest_ms = now - in_flight_positions.oldest;
+    uint16_t count = in_flight_positions.count;
+
+    if (count == 0) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&latency_stats_lock);
+    latency_stats.events += count;
+    latency_stats.total_ms += count * oldest_ms - in_flight_positions.offsets;
+    latency_stats.max_ms = MAX(latency_stats.max_ms, oldest_ms);
+    latency_stats.last_ms = now - in_flight_positions.newest;
+    k_spin_unlock(&latency_stats_lock, key);
+
+    LOG_DBG("Sent %d key events, the oldest after %u ms", count, oldest_ms);
+}
+
+int zmk_split_bt_peripheral_get_latency_stats(struct zmk_split_bt_latency_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&latency_stats_lock);
+    *stats = latency_stats;
+    k_spin_unlock(&latency_stats_lock, key);
+
+    return 0;
+}
+
+#else
+
+static inline void start_position_latency(void) {}
+static inline void track_position_latency(uint32_t timestamp) {}
+static inline void record_position_latency(void) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_LATENCY_STATS)
+
+static void split_svc_notify_sent(struct bt_conn *conn, void *user_data) {
+    enum split_svc_notification type = (enum split_svc_notification)(uintptr_t)user_data;
+
+    if (type == SPLIT_SVC_NOTIFY_POSITION) {
+        record_position_latency();
+    }
+
+    atomic_clear_bit(notifications_in_flight, type);
+
+    if (atomic_test_bit(pending_notifications, type)) {
+        k_work_submit_to_queue(&service_work_q, &service_notify_work);
+    }
+}
+
+static void split_svc_notify(enum split_svc_notification type, const struct bt_gatt_attr *attr,
+                             const void *data, uint16_t len) {
+    struct bt_gatt_notify_params *params = &notify_params[type];
+
+    *params = (struct bt_gatt_notify_params){
+        .attr = attr,
+        .data = data,
+        .len = len,
+        .func = split_svc_notify_sent,
+        .user_data = (void *)(uintptr_t)type,
+    };
 
-int send_position_state() {
-    int err = k_msgq_put(&position_state_msgq, position_state, K_MSEC(100));
+    // Check for more data once this one completes. Set before notifying, since the completion
+    // callback can run before bt_gatt_notify_cb returns.
+    atomic_set_bit(pending_notifications, type);
+
+    int err = bt_gatt_notify_cb(NULL, params);
     if (err) {
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Position state message queue full, popping first message and queueing again");
-            uint8_t discarded_state[POS_STATE_LEN];
-            k_msgq_get(&position_state_msgq, &discarded_state, K_NO_WAIT);
-            return send_position_state();
+        LOG_DBG("Error notifying %d", err);
+        atomic_clear_bit(notifications_in_flight, type);
+    }
+}
+
+static void split_svc_disconnected(struct bt_conn *conn, uint8_t reason) {
+    replay_disconnected(atomic_test_bit(notifications_in_flight, SPLIT_SVC_NOTIFY_POSITION));
+
+    // Completion callbacks for notifications still queued on the connection never run.
+    for (int i = 0; i < SPLIT_SVC_NOTIFY_COUNT; i++) {
+        atomic_clear_bit(notifications_in_flight, i);
+    }
+}
+
+BT_CONN_CB_DEFINE(split_svc_conn_callbacks) = {
+    .disconnected = split_svc_disconnected,
+};
+
+struct position_event_entry {
+    uint32_t timestamp;
+    uint8_t position;
+    bool pressed;
+};
+
+static struct k_spinlock position_lock;
+
+#define POSITION_LOG_SIZE CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE
+
+static struct position_event_entry position_log[POSITION_LOG_SIZE];
+
+ZMK_QUEUE_STATS_DEFINE(position_log, "peripheral position events", POSITION_LOG_SIZE);
+static size_t position_log_head;
+static size_t position_log_len;
+
+// Set when the log overflows. Changes are then only kept in position_state, and the central is
+// brought up to date from its difference to notified_position_state before logging resumes.
+static bool position_log_overflowed;
+
+// The state the central has been sent so far.
+static uint8_t notified_position_state[POS_STATE_LEN];
+
+static int record_position_change(uint8_t position, bool pressed) {
+    bool overflowed = false;
+    k_spinlock_key_t key = k_spin_lock(&position_lock);
+
+    WRITE_BIT(position_state[position / 8], position % 8, pressed);
+
+    if (position_log_overflowed) {
+        // Covered by the position state difference.
+    } else if (position_log_len == ARRAY_SIZE(position_log)) {
+        position_log_overflowed = overflowed = true;
+        position_log_len = 0;
+        ZMK_QUEUE_STATS_OVERFLOW(position_log);
+    } else {
+        size_t idx = (position_log_head + position_log_len++) % ARRAY_SIZE(position_log);
+        position_log[idx] = (struct position_event_entry){
+            .timestamp = k_uptime_get_32(),
+            .position = position,
+            .pressed = pressed,
+        };
+        ZMK_QUEUE_STATS_PUT(position_log, position_log_len);
+    }
+
+    k_spin_unlock(&position_lock, key);
+
+    if (overflowed) {
+        LOG_WRN("Position event log full, sending the latest position state instead");
+    }
+
+    schedule_notification(SPLIT_SVC_NOTIFY_POSITION);
+    return 0;
+}
+
+// Takes the oldest change the central hasn't been sent, unless its position is set in `exclude`.
+static bool take_position_change(struct position_event_entry *entry, const uint8_t *exclude) {
+    bool found = false;
+    k_spinlock_key_t key = k_spin_lock(&position_lock);
+
+    if (position_log_len > 0) {
+        *entry = position_log[position_log_head];
+        found = !(exclude && (exclude[entry->position / 8] & BIT(entry->position % 8)));
+
+        if (found) {
+            position_log_head = (position_log_head + 1) % ARRAY_SIZE(position_log);
+            position_log_len--;
         }
-        default:
-            LOG_WRN("Failed to queue position state to send (%d)", err);
-            return err;
+    } else if (position_log_overflowed) {
+        for (int i = 0; i < POS_STATE_LEN && !found; i++) {
+            uint8_t changed = position_state[i] ^ notified_position_state[i];
+            if (exclude) {
+                changed &= ~exclude[i];
+            }
+
+            if (changed) {
+                uint8_t bit = __builtin_ctz(changed);
+                *entry = (struct position_event_entry){
+                    .timestamp = k_uptime_get_32(),
+                    .position = (i * 8) + bit,
+                    .pressed = position_state[i] & BIT(bit),
+                };
+                found = true;
+            }
         }
+
+        position_log_overflowed = found || memcmp(position_state, notified_position_state,
+                                                  sizeof(position_state)) != 0;
     }
 
-    k_work_submit_to_queue(&service_work_q, &service_position_notify_work);
+    if (found) {
+        WRITE_BIT(notified_position_state[entry->position / 8], entry->position % 8,
+                  entry->pressed);
+    }
 
-    return 0;
+    k_spin_unlock(&position_lock, key);
+    return found;
 }
 
-static int zmk_split_bt_position_pressed(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, true);
-    return send_position_state();
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+
+#define POSITION_EVENTS_BATCH_SIZE CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS_BATCH_SIZE
+
+struct position_events_batch {
+    struct zmk_split_position_events_payload payload;
+    struct zmk_split_position_event events[POSITION_EVENTS_BATCH_SIZE];
+    // Room for a battery level following a full batch of events.
+    uint8_t battery_level;
+} __packed;
+
+static struct position_events_batch batch;
+static size_t batch_count;
+static bool batch_has_battery_level;
+static uint32_t batch_first_timestamp;
+static uint32_t batch_last_timestamp;
+
+static void notify_position_events(void) {
+    batch.payload.age = sys_cpu_to_le16(MIN(k_uptime_get_32() - batch_last_timestamp, UINT16_MAX));
+
+    split_svc_notify(SPLIT_SVC_NOTIFY_POSITION,
+                     &split_svc.attrs[SPLIT_SVC_POSITION_EVENTS_ATTR_IDX], &batch,
+                     sizeof(batch.payload) + batch_count * sizeof(struct zmk_split_position_event) +
+                         (batch_has_battery_level ? sizeof(uint8_t) : 0));
 }
 
-static int zmk_split_bt_position_released(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, false);
-    return send_position_state();
+#if POSITION_EVENTS_BATTERY
+
+#define BATTERY_QUIET_MS CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS_BATTERY_QUIET_MS
+
+// Battery level the central hasn't been sent yet, or -1.
+static atomic_t pending_battery_level = ATOMIC_INIT(-1);
+// Set once the pending level has waited long enough for key events to carry it.
+static atomic_t battery_level_due;
+
+static void battery_quiet_work_cb(struct k_work *work) {
+    atomic_set(&battery_level_due, true);
+    schedule_notification(SPLIT_SVC_NOTIFY_POSITION);
 }
 
-#if ZMK_KEYMAP_HAS_SENSORS
-K_MSGQ_DEFINE(sensor_state_msgq, sizeof(struct sensor_event),
-              CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
+static K_WORK_DELAYABLE_DEFINE(battery_quiet_work, battery_quiet_work_cb);
 
-void send_sensor_state_callback(struct k_work *work) {
-    while (k_msgq_get(&sensor_state_msgq, &last_sensor_event, K_NO_WAIT) == 0) {
-        int err = bt_gatt_notify(NULL, &split_svc.attrs[8], &last_sensor_event,
-                                 sizeof(last_sensor_event));
-        if (err) {
-            LOG_DBG("Error notifying %d", err);
+static void report_battery_level(uint8_t level) {
+    atomic_set(&pending_battery_level, level);
+
+    // Only the first change starts the wait, so a level that keeps changing still goes out.
+    k_work_schedule_for_queue(&service_work_q, &battery_quiet_work, K_MSEC(BATTERY_QUIET_MS));
+}
+
+// Adds the pending battery level after `count` events, if there are events to carry it or it has
+// waited long enough to be sent on its own.
+static bool append_battery_level(size_t count) {
+    if (count == 0 && !atomic_clear(&battery_level_due)) {
+        return false;
+    }
+
+    atomic_val_t level = atomic_set(&pending_battery_level, -1);
+    if (level < 0) {
+        return false;
+    }
+
+    atomic_clear(&battery_level_due);
+    k_work_cancel_delayable(&battery_quiet_work);
+
+    ((uint8_t *)batch.events)[count * sizeof(struct zmk_split_position_event)] = level;
+    return true;
+}
+
+#else
+
+static inline bool append_battery_level(size_t count) { return false; }
+
+#endif // POSITION_EVENTS_BATTERY
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+
+// Set when the link dropped with the last batch still in flight, so it never reached the central.
+static bool batch_lost;
+
+static bool resend_lost_position_events(void) {
+    if (!batch_lost) {
+        return false;
+    }
+
+    batch_lost = false;
+
+    if (batch_count == 0 && !batch_has_battery_level) {
+        return false;
+    }
+
+    K_SPINLOCK(&position_lock) {
+        for (size_t i = 0; i < batch_count; i++) {
+            uint8_t position = batch.events[i].position & ~ZMK_SPLIT_POSITION_EVENT_PRESSED;
+            WRITE_BIT(notified_position_state[position / 8], position % 8,
+                      batch.events[i].position & ZMK_SPLIT_POSITION_EVENT_PRESSED);
         }
     }
-};
 
-K_WORK_DEFINE(service_sensor_notify_work, send_sensor_state_callback);
+    LOG_DBG("Resending %d key events lost on disconnect", (int)batch_count);
+    notify_position_events();
+    return true;
+}
 
-int send_sensor_state(struct sensor_event ev) {
-    int err = k_msgq_put(&sensor_state_msgq, &ev, K_MSEC(100));
-    if (err) {
-        // retry...
-        switch (err) {
-        case -EAGAIN: {
-            LOG_WRN("Sensor state message queue full, popping first message and queueing again");
-            struct sensor_event discarded_state;
-            k_msgq_get(&sensor_state_msgq, &discarded_state, K_NO_WAIT);
-            return send_sensor_state(ev);
+#else
+
+static inline bool resend_lost_position_events(void) { return false; }
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+
+static bool send_position_events(void) {
+    struct position_event_entry entry;
+    uint32_t last_timestamp = 0;
+    size_t count = 0;
+
+    if (resend_lost_position_events()) {
+        return true;
+    }
+
+    // Changes that were logged while the previous notification was in flight go out together.
+    while (count < POSITION_EVENTS_BATCH_SIZE && take_position_change(&entry, NULL)) {
+        uint16_t delta = count == 0 ? 0 : MIN(entry.timestamp - last_timestamp, UINT16_MAX);
+        track_position_latency(entry.timestamp);
+        batch.events[count++] = (struct zmk_split_position_event){
+            .position = entry.position | (entry.pressed ? ZMK_SPLIT_POSITION_EVENT_PRESSED : 0),
+            .delta = sys_cpu_to_le16(delta),
+        };
+        if (count == 1) {
+            batch_first_timestamp = entry.timestamp;
         }
-        default:
-            LOG_WRN("Failed to queue sensor state to send (%d)", err);
-            return err;
+        last_timestamp = entry.timestamp;
+    }
+
+    batch_has_battery_level = append_battery_level(count);
+    batch_count = count;
+
+    if (count == 0) {
+        if (!batch_has_battery_level) {
+            return false;
         }
+
+        batch_first_timestamp = last_timestamp = k_uptime_get_32();
     }
 
-    k_work_submit_to_queue(&service_work_q, &service_sensor_notify_work);
-    return 0;
+    batch_last_timestamp = last_timestamp;
+
+    notify_position_events();
+    return true;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+
+static bool send_position_state(void) {
+    static uint8_t state[POS_STATE_LEN];
+    uint8_t changed[POS_STATE_LEN] = {0};
+    struct position_event_entry entry;
+    bool found = false;
+
+    // Merge changes into one snapshot until a position changes twice, since the central would
+    // miss the intermediate state.
+    while (take_position_change(&entry, changed)) {
+        WRITE_BIT(changed[entry.position / 8], entry.position % 8, true);
+        track_position_latency(entry.timestamp);
+        found = true;
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    // Only this work item updates notified_position_state, so it is safe to read here.
+    memcpy(state, notified_position_state, sizeof(state));
+
+    split_svc_notify(SPLIT_SVC_NOTIFY_POSITION, &split_svc.attrs[SPLIT_SVC_POSITION_STATE_ATTR_IDX],
+                     state, sizeof(state));
+    return true;
+}
+
+static bool send_position_notification(void) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+    // Keep the log for the central to catch up on once it subscribes again.
+    if (!atomic_get(&position_state_subscribed) && !atomic_get(&position_events_subscribed)) {
+        return false;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+
+    start_position_latency();
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+    if (atomic_get(&position_events_subscribed)) {
+        return send_position_events();
+    }
+
+    // A lost state bitmap is covered by the next one, so there's no batch to send again.
+    batch_count = 0;
+    batch_has_battery_level = false;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_POSITION_EVENTS)
+
+    return send_position_state();
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+
+#define REPLAY_MAX_AGE_MS CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY_MAX_AGE_MS
+
+static void replay_subscription_changed(void) {
+    if (!atomic_get(&position_state_subscribed) && !atomic_get(&position_events_subscribed)) {
+        return;
+    }
+
+    const uint32_t now = k_uptime_get_32();
+
+    // Changes from before a long disconnect are dropped rather than replayed late. The central
+    // released their keys itself when the link dropped, so there's nothing to undo.
+    K_SPINLOCK(&position_lock) {
+        while (position_log_len > 0 &&
+               now - position_log[position_log_head].timestamp > REPLAY_MAX_AGE_MS) {
+            position_log_head = (position_log_head + 1) % ARRAY_SIZE(position_log);
+            position_log_len--;
+        }
+    }
+
+    if (batch_lost && now - batch_first_timestamp > REPLAY_MAX_AGE_MS) {
+        batch_lost = false;
+    }
+
+    schedule_notification(SPLIT_SVC_NOTIFY_POSITION);
+}
+
+static void replay_disconnected(bool position_in_flight) {
+    // The central releases every key it had from this peripheral when the link drops, so the
+    // changes still in the log are relative to nothing being pressed.
+    K_SPINLOCK(&position_lock) {
+        memset(notified_position_state, 0, sizeof(notified_position_state));
+    }
+
+    batch_lost = position_in_flight && (batch_count > 0 || batch_has_battery_level);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_REPLAY)
+
+static int zmk_split_bt_position_pressed(uint8_t position) {
+    return record_position_change(position, true);
+}
+
+static int zmk_split_bt_position_released(uint8_t position) {
+    return record_position_change(position, false);
+}
+
+#if ZMK_KEYMAP_HAS_SENSORS
+
+static struct k_spinlock sensor_lock;
+
+static struct sensor_event sensor_events[CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE];
+
+ZMK_QUEUE_STATS_DEFINE(sensor_events, "peripheral sensor events", ARRAY_SIZE(sensor_events));
+static size_t sensor_events_head;
+static size_t sensor_events_len;
+
+static bool send_sensor_state(void) {
+    bool found = false;
+    k_spinlock_key_t key = k_spin_lock(&sensor_lock);
+
+    if (sensor_events_len > 0) {
+        last_sensor_event = sensor_events[sensor_events_head];
+        sensor_events_head = (sensor_events_head + 1) % ARRAY_SIZE(sensor_events);
+        sensor_events_len--;
+        found = true;
+    }
+
+    k_spin_unlock(&sensor_lock, key);
+
+    if (found) {
+        split_svc_notify(SPLIT_SVC_NOTIFY_SENSOR, &split_svc.attrs[SPLIT_SVC_SENSOR_STATE_ATTR_IDX],
+                         &last_sensor_event, sizeof(last_sensor_event));
+    }
+
+    return found;
 }
 
 static int zmk_split_bt_sensor_triggered(uint8_t sensor_index,
@@ -302,13 +867,55 @@ static int zmk_split_bt_sensor_triggered(uint8_t sensor_index,
         return -EINVAL;
     }
 
-    struct sensor_event ev =
+    bool dropped = false;
+    k_spinlock_key_t key = k_spin_lock(&sensor_lock);
+
+    if (sensor_events_len == ARRAY_SIZE(sensor_events)) {
+        sensor_events_head = (sensor_events_head + 1) % ARRAY_SIZE(sensor_events);
+        sensor_events_len--;
+        dropped = true;
+        ZMK_QUEUE_STATS_OVERFLOW(sensor_events);
+    }
+
+    struct sensor_event *ev =
+        &sensor_events[(sensor_events_head + sensor_events_len++) % ARRAY_SIZE(sensor_events)];
+    *ev =
         (struct sensor_event){.sensor_index = sensor_index, .channel_data_size = channel_data_size};
-    memcpy(ev.channel_data, channel_data,
+    memcpy(ev->channel_data, channel_data,
            channel_data_size * sizeof(struct zmk_sensor_channel_data));
-    return send_sensor_state(ev);
+    ZMK_QUEUE_STATS_PUT(sensor_events, sensor_events_len);
+
+    k_spin_unlock(&sensor_lock, key);
+
+    if (dropped) {
+        LOG_WRN("Sensor event queue full, dropped the oldest event");
+    }
+
+    schedule_notification(SPLIT_SVC_NOTIFY_SENSOR);
+    return 0;
+}
+
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+
+static void split_svc_send_pending(enum split_svc_notification type, bool (*send)(void)) {
+    if (!atomic_test_bit(pending_notifications, type) ||
+        atomic_test_and_set_bit(notifications_in_flight, type)) {
+        return;
+    }
+
+    atomic_clear_bit(pending_notifications, type);
+
+    if (!send()) {
+        atomic_clear_bit(notifications_in_flight, type);
+    }
 }
+
+static void split_svc_notify_work_cb(struct k_work *work) {
+    split_svc_send_pending(SPLIT_SVC_NOTIFY_POSITION, send_position_notification);
+#if ZMK_KEYMAP_HAS_SENSORS
+    split_svc_send_pending(SPLIT_SVC_NOTIFY_SENSOR, send_sensor_state);
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
+}
 
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
 
@@ -334,6 +941,28 @@ static int zmk_split_bt_report_input(uint8_t reg, uint8_t type, uint16_t code, i
 
 #endif /* IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT) */
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+static int send_link_pong(const struct zmk_split_transport_link_pong *pong) {
+    static const struct bt_gatt_attr *attr;
+
+    if (!attr) {
+        attr = bt_gatt_find_by_uuid(split_svc.attrs, split_svc.attr_count,
+                                    BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_LINK_BENCHMARK_UUID));
+    }
+
+    struct zmk_split_transport_link_pong payload = {
+        .seq = sys_cpu_to_le32(pong->seq),
+        .sent_us = sys_cpu_to_le32(pong->sent_us),
+        .peripheral_us = sys_cpu_to_le32(pong->peripheral_us),
+        .index = sys_cpu_to_le16(pong->index),
+    };
+
+    return bt_gatt_notify(NULL, attr, &payload, sizeof(payload));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 static int service_init(void) {
     static const struct k_work_queue_config queue_config = {
         .name = "Split Peripheral Notification Queue"};
@@ -372,9 +1001,16 @@ int zmk_split_transport_peripheral_bt_report_event(
 
 #if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT:
-        // The BLE transport uses standard BAS service for propagation, so just return success here.
+#if POSITION_EVENTS_BATTERY
+        report_battery_level(ev->data.battery_event.level);
+#endif // POSITION_EVENTS_BATTERY
+        // The level is also kept in the standard BAS service, which needs nothing more here.
         return 0;
 #endif
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_PONG:
+        return send_link_pong(&ev->data.link_pong);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
     default:
         LOG_WRN("Unhandled event type %d", ev->type);
         return -ENOTSUP;
@@ -434,4 +1070,63 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
     }
 
     return len;
-}
\ No newline at end of file
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+static ssize_t split_svc_run_behaviors(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                       const void *buf, uint16_t len, uint16_t offset,
+                                       uint8_t flags) {
+    const struct zmk_split_run_behaviors_payload *payload = buf;
+    const size_t header_len = offsetof(struct zmk_split_run_behaviors_payload, entries);
+
+    // Write without response can't be split, so the whole batch is always in one write.
+    if (offset != 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+
+    if (len < header_len || (len - header_len) % sizeof(struct zmk_split_run_behaviors_entry)) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    size_t count = (len - header_len) / sizeof(struct zmk_split_run_behaviors_entry);
+
+    struct zmk_split_transport_central_command cmd = {
+        .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR_BATCH,
+        .data = {.invoke_behavior_batch = {
+                     .position = payload->position,
+                     .event_source = payload->source,
+                     .count = MIN(count, CONFIG_ZMK_SPLIT_BEHAVIOR_BATCH_SIZE),
+                 }}};
+
+    if (count > CONFIG_ZMK_SPLIT_BEHAVIOR_BATCH_SIZE) {
+        LOG_WRN("Dropping %d invocations over the batch size",
+                (int)(count - CONFIG_ZMK_SPLIT_BEHAVIOR_BATCH_SIZE));
+    }
+
+    for (size_t i = 0; i < cmd.data.invoke_behavior_batch.count; i++) {
+        const struct zmk_split_run_behaviors_entry *entry = &payload->entries[i];
+        struct zmk_split_transport_behavior_invocation *inv =
+            &cmd.data.invoke_behavior_batch.invocations[i];
+
+        *inv = (struct zmk_split_transport_behavior_invocation){
+            .state = entry->state,
+            .wait_ms = sys_le16_to_cpu(entry->wait_ms),
+            .param1 = sys_le32_to_cpu(entry->param1),
+            .param2 = sys_le32_to_cpu(entry->param2),
+        };
+
+        memcpy(inv->behavior_dev, entry->behavior_dev, sizeof(entry->behavior_dev));
+        inv->behavior_dev[sizeof(entry->behavior_dev)] = '\0';
+    }
+
+    int err = zmk_split_transport_peripheral_command_handler(zmk_split_transport_peripheral_bt(),
+                                                             cmd);
+    if (err) {
+        LOG_ERR("Failed to run behavior batch: %d", err);
+    }
+
+    return len;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
\ No newline at end of file
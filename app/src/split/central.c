@@ -5,13 +5,20 @@
  */
 
 #include <errno.h>
+#include <string.h>
 
 #include <zmk/stdlib.h>
 #include <zmk/split/transport/central.h>
 #include <zmk/split/central.h>
 #include <zmk/hid_indicators_types.h>
+#include <zmk/physical_layouts.h>
+#include <zmk/queue_stats.h>
 #include <zmk/pointing/input_split.h>
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+#include <zmk/split/link_benchmark.h>
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 #include <zephyr/logging/log.h>
 
 #include <zmk/event_manager.h>
@@ -32,6 +39,13 @@ static uint8_t peripheral_battery_levels[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT] = {
 int zmk_split_transport_central_peripheral_event_handler(
     const struct zmk_split_transport_central *transport, uint8_t source,
     struct zmk_split_transport_peripheral_event ev) {
+    return zmk_split_transport_central_timed_peripheral_event_handler(transport, source, ev,
+                                                                      k_uptime_get());
+}
+
+int zmk_split_transport_central_timed_peripheral_event_handler(
+    const struct zmk_split_transport_central *transport, uint8_t source,
+    struct zmk_split_transport_peripheral_event ev, int64_t timestamp) {
     if (transport != active_transport) {
         // Ignoring events from non-active transport
         LOG_WRN("Ignoring peripheral event from non-active transport");
@@ -43,7 +57,7 @@ int zmk_split_transport_central_peripheral_event_handler(
                                                       .position =
                                                           ev.data.key_position_event.position,
                                                       .state = ev.data.key_position_event.pressed,
-                                                      .timestamp = k_uptime_get()};
+                                                      .timestamp = timestamp};
         return raise_zmk_position_state_changed(state_ev);
     }
 #if IS_ENABLED(CONFIG_ZMK_INPUT_SPLIT)
@@ -66,24 +80,168 @@ int zmk_split_transport_central_peripheral_event_handler(
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SENSOR_EVENT: {
         struct zmk_sensor_event sensor_ev = {.sensor_index = ev.data.sensor_event.sensor_index,
                                              .channel_data_size = 1,
-                                             .timestamp = k_uptime_get()};
+                                             .timestamp = timestamp};
 
         sensor_ev.channel_data[0] = ev.data.sensor_event.channel_data;
 
         return raise_zmk_sensor_event(sensor_ev);
     }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_PONG:
+        zmk_split_link_benchmark_handle_pong(source, &ev.data.link_pong);
+        return 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
     default:
         LOG_WRN("GOT AN UNKNOWN EVENT TYPE %d", ev.type);
         return -ENOTSUP;
     }
 }
 
+int zmk_split_transport_central_position_event_run_handler(
+    const struct zmk_split_transport_central *transport,
+    const struct zmk_position_state_changed *events, size_t len) {
+    if (transport != active_transport) {
+        LOG_WRN("Ignoring peripheral event from non-active transport");
+        return -EINVAL;
+    }
+
+    return zmk_physical_layouts_raise_merged(events, len);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+// Invocations are collected per peripheral and sent from a work item, so a run of invocations made
+// back to back, like the steps of a macro, goes out as one command. A batch only holds invocations
+// for one key position, which keeps them in order on a single lane of the peripheral's behavior
+// queue. The time between invocations is sent along, so the peripheral replays them with the same
+// spacing.
+
+struct behavior_batch {
+    struct zmk_split_transport_central_command command;
+    int64_t last_invocation;
+};
+
+static struct behavior_batch behavior_batches[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT];
+
+// Held while sending, so batches reach the transport in the order they were started.
+K_MUTEX_DEFINE(behavior_batches_mutex);
+
+static int send_behavior_batch(uint8_t source) {
+    struct zmk_split_transport_central_command command = behavior_batches[source].command;
+    uint8_t count = command.data.invoke_behavior_batch.count;
+
+    if (count == 0) {
+        return 0;
+    }
+
+    behavior_batches[source].command.data.invoke_behavior_batch.count = 0;
+
+    if (!active_transport || !active_transport->api || !active_transport->api->send_command) {
+        return -ENODEV;
+    }
+
+    if (count == 1) {
+        // Peripherals without batching support still understand single invocations.
+        const struct zmk_split_transport_behavior_invocation *inv =
+            &command.data.invoke_behavior_batch.invocations[0];
+        struct zmk_split_transport_central_command single = {
+            .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR,
+            .data = {.invoke_behavior = {
+                         .param1 = inv->param1,
+                         .param2 = inv->param2,
+                         .position = command.data.invoke_behavior_batch.position,
+                         .event_source = command.data.invoke_behavior_batch.event_source,
+                         .state = inv->state,
+                     }}};
+        memcpy(single.data.invoke_behavior.behavior_dev, inv->behavior_dev,
+               sizeof(single.data.invoke_behavior.behavior_dev));
+
+        return active_transport->api->send_command(source, single);
+    }
+
+    return active_transport->api->send_command(source, command);
+}
+
+static void flush_behavior_batches(void) {
+    k_mutex_lock(&behavior_batches_mutex, K_FOREVER);
+
+    for (uint8_t source = 0; source < ARRAY_SIZE(behavior_batches); source++) {
+        int err = send_behavior_batch(source);
+        if (err < 0) {
+            LOG_WRN("Failed to send behavior batch to peripheral %d (%d)", source, err);
+        }
+    }
+
+    k_mutex_unlock(&behavior_batches_mutex);
+}
+
+static void flush_behavior_batches_work_cb(struct k_work *work) { flush_behavior_batches(); }
+
+K_WORK_DEFINE(flush_behavior_batches_work, flush_behavior_batches_work_cb);
+
+static int batch_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
+                                 struct zmk_behavior_binding_event event, bool state) {
+    if (source >= ARRAY_SIZE(behavior_batches)) {
+        return -EINVAL;
+    }
+
+    int err = 0;
+    int64_t now = k_uptime_get();
+
+    k_mutex_lock(&behavior_batches_mutex, K_FOREVER);
+
+    struct behavior_batch *batch = &behavior_batches[source];
+    typeof(batch->command.data.invoke_behavior_batch) *data =
+        &batch->command.data.invoke_behavior_batch;
+
+    if (data->count > 0 && (data->count >= ARRAY_SIZE(data->invocations) ||
+                            data->position != event.position ||
+                            data->event_source != event.source)) {
+        err = send_behavior_batch(source);
+    }
+
+    if (data->count == 0) {
+        batch->command.type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR_BATCH;
+        data->position = event.position;
+        data->event_source = event.source;
+    } else {
+        data->invocations[data->count - 1].wait_ms = MIN(now - batch->last_invocation, UINT16_MAX);
+    }
+
+    struct zmk_split_transport_behavior_invocation *inv = &data->invocations[data->count++];
+    *inv = (struct zmk_split_transport_behavior_invocation){
+        .param1 = binding->param1,
+        .param2 = binding->param2,
+        .state = state ? 1 : 0,
+    };
+
+    const size_t payload_dev_size = sizeof(inv->behavior_dev);
+    if (strlcpy(inv->behavior_dev, binding->behavior_dev, payload_dev_size) >= payload_dev_size) {
+        LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
+                binding->behavior_dev, inv->behavior_dev);
+    }
+
+    batch->last_invocation = now;
+
+    k_mutex_unlock(&behavior_batches_mutex);
+
+    k_work_submit(&flush_behavior_batches_work);
+
+    return err;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
 int zmk_split_central_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
                                       struct zmk_behavior_binding_event event, bool state) {
     if (!active_transport || !active_transport->api || !active_transport->api->send_command) {
         return -ENODEV;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    return batch_invoke_behavior(source, binding, event, state);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
     struct zmk_split_transport_central_command command =
         (struct zmk_split_transport_central_command){
             .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR,
@@ -110,12 +268,94 @@ int zmk_split_central_invoke_behavior(uint8_t source, struct zmk_behavior_bindin
     return active_transport->api->send_command(source, command);
 };
 
+// Behaviors with global locality are fanned out to the connected peripherals from a work item, so
+// the key press invoking them doesn't wait on a transport queue for each peripheral, and
+// disconnected peripherals don't take up a place in them.
+
+struct global_invocation {
+    struct zmk_behavior_binding binding;
+    struct zmk_behavior_binding_event event;
+    bool state;
+};
+
+K_MSGQ_DEFINE(global_invocation_msgq, sizeof(struct global_invocation),
+              CONFIG_ZMK_SPLIT_CENTRAL_GLOBAL_INVOCATION_QUEUE_SIZE, 4);
+
+ZMK_QUEUE_STATS_DEFINE(global_invocation_msgq, "global behavior invocations",
+                       CONFIG_ZMK_SPLIT_CENTRAL_GLOBAL_INVOCATION_QUEUE_SIZE);
+
+// Held while fanning out, so invocations reach each peripheral in the order they were made.
+K_MUTEX_DEFINE(global_invocations_mutex);
+
+static void flush_global_invocations(void) {
+    struct global_invocation inv;
+
+    k_mutex_lock(&global_invocations_mutex, K_FOREVER);
+
+    while (k_msgq_get(&global_invocation_msgq, &inv, K_NO_WAIT) == 0) {
+        if (!active_transport || !active_transport->api ||
+            !active_transport->api->get_available_source_ids) {
+            continue;
+        }
+
+        uint8_t source_ids[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT];
+
+        int ret = active_transport->api->get_available_source_ids(source_ids);
+        if (ret < 0) {
+            LOG_WRN("Failed to get the peripherals to invoke %s on (%d)", inv.binding.behavior_dev,
+                    ret);
+            continue;
+        }
+
+        for (size_t i = 0; i < ret; i++) {
+            int err = zmk_split_central_invoke_behavior(source_ids[i], &inv.binding, inv.event,
+                                                        inv.state);
+            if (err < 0) {
+                LOG_WRN("Failed to invoke %s on peripheral %d (%d)", inv.binding.behavior_dev,
+                        source_ids[i], err);
+            }
+        }
+    }
+
+    k_mutex_unlock(&global_invocations_mutex);
+}
+
+static void flush_global_invocations_work_cb(struct k_work *work) { flush_global_invocations(); }
+
+K_WORK_DEFINE(flush_global_invocations_work, flush_global_invocations_work_cb);
+
+int zmk_split_central_invoke_global_behavior(struct zmk_behavior_binding *binding,
+                                             struct zmk_behavior_binding_event event, bool state) {
+    struct global_invocation inv = {.binding = *binding, .event = event, .state = state};
+
+    int err =
+        ZMK_QUEUE_STATS_MSGQ_PUT(global_invocation_msgq, &global_invocation_msgq, &inv, K_NO_WAIT);
+    if (err < 0) {
+        LOG_WRN("Global behavior invocation queue full, not invoking %s on peripherals",
+                binding->behavior_dev);
+        return err;
+    }
+
+    k_work_submit(&flush_global_invocations_work);
+
+    return 0;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
-int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
+// Indicator changes are collected for ZMK_SPLIT_PERIPHERAL_HID_INDICATORS_COALESCE_MS before being
+// sent, and each peripheral is only written to when the result differs from what it was last sent.
+// Hosts repeating the same LED report, or a change that is undone within the window, cost nothing.
+
+static zmk_hid_indicators_t pending_hid_indicators;
+static zmk_hid_indicators_t sent_hid_indicators[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT];
+// Sources whose entry in sent_hid_indicators is known to match the peripheral.
+static uint32_t hid_indicators_sent_sources;
+
+static void send_hid_indicators_work_cb(struct k_work *work) {
     if (!active_transport || !active_transport->api ||
         !active_transport->api->get_available_source_ids || !active_transport->api->send_command) {
-        return -ENODEV;
+        return;
     }
 
     uint8_t source_ids[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT];
@@ -123,9 +363,11 @@ int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
     int ret = active_transport->api->get_available_source_ids(source_ids);
 
     if (ret < 0) {
-        return ret;
+        LOG_WRN("Failed to get the peripherals to send HID indicators to (%d)", ret);
+        return;
     }
 
+    const zmk_hid_indicators_t indicators = pending_hid_indicators;
     struct zmk_split_transport_central_command command =
         (struct zmk_split_transport_central_command){
             .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS,
@@ -137,19 +379,120 @@ int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
                         },
                 },
         };
+    uint32_t available_sources = 0;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    // Keep the indicator update ordered after any behaviors invoked before it.
+    flush_behavior_batches();
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
 
     for (size_t i = 0; i < ret; i++) {
-        ret = active_transport->api->send_command(source_ids[i], command);
-        if (ret < 0) {
-            return ret;
+        const uint8_t source = source_ids[i];
+
+        available_sources |= BIT(source);
+
+        if ((hid_indicators_sent_sources & BIT(source)) &&
+            sent_hid_indicators[source] == indicators) {
+            continue;
+        }
+
+        int err = active_transport->api->send_command(source, command);
+        if (err < 0) {
+            LOG_WRN("Failed to send HID indicators to peripheral %d (%d)", source, err);
+            hid_indicators_sent_sources &= ~BIT(source);
+            continue;
         }
+
+        sent_hid_indicators[source] = indicators;
+        hid_indicators_sent_sources |= BIT(source);
     }
 
+    // A peripheral that went away may have lost its state by the time it comes back.
+    hid_indicators_sent_sources &= available_sources;
+}
+
+static K_WORK_DELAYABLE_DEFINE(send_hid_indicators_work, send_hid_indicators_work_cb);
+
+int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
+    if (!active_transport || !active_transport->api ||
+        !active_transport->api->get_available_source_ids || !active_transport->api->send_command) {
+        return -ENODEV;
+    }
+
+    pending_hid_indicators = indicators;
+
+    // The first change starts the window, later ones within it are folded in.
+    k_work_schedule(&send_hid_indicators_work,
+                    K_MSEC(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS_COALESCE_MS));
+
     return 0;
 }
 
+static void forget_sent_hid_indicators(void) { hid_indicators_sent_sources = 0; }
+
+#else
+
+static inline void forget_sent_hid_indicators(void) {}
+
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+int zmk_split_central_update_rgb_sync(const struct zmk_split_transport_rgb_sync *sync) {
+    if (!active_transport || !active_transport->api ||
+        !active_transport->api->get_available_source_ids || !active_transport->api->send_command) {
+        return -ENODEV;
+    }
+
+    uint8_t source_ids[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT];
+
+    int ret = active_transport->api->get_available_source_ids(source_ids);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    struct zmk_split_transport_central_command command = {
+        .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_RGB_SYNC,
+        .data = {.set_rgb_sync = *sync},
+    };
+
+    // Behaviors invoked before the sync, such as an effect change, must not be applied after it.
+    flush_global_invocations();
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    flush_behavior_batches();
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+
+    for (size_t i = 0; i < ret; i++) {
+        int err = active_transport->api->send_command(source_ids[i], command);
+        if (err < 0) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+int zmk_split_central_send_link_ping(uint8_t source,
+                                     const struct zmk_split_transport_link_ping *ping) {
+    if (!active_transport || !active_transport->api || !active_transport->api->send_command) {
+        return -ENODEV;
+    }
+
+    struct zmk_split_transport_central_command command = {
+        .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_LINK_PING,
+        .data = {.link_ping = *ping},
+    };
+
+    return active_transport->api->send_command(source, command);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
 int zmk_split_central_get_peripheral_battery_level(uint8_t source, uint8_t *level) {
@@ -201,6 +544,10 @@ static int transport_status_changed_cb(const struct zmk_split_transport_central
     if (central == active_transport) {
         LOG_DBG("Central at %p changed status: enabled %d, available %d, connections %d", central,
                 status.enabled, status.available, status.connections);
+
+        // Peripherals may have reconnected with different state, so send the next change to all.
+        forget_sent_hid_indicators();
+
         if (status.connections == ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED) {
             return select_first_available_transport();
         }
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/workqueue.h>
+
+// Local and peripheral key events are held for up to the reorder window and then released in
+// timestamp order, so a peripheral event that was delayed by the split link is still seen before
+// local events that happened after it. Split transports stamp peripheral events with when they
+// happened, so this only works as well as the transport's timestamps do.
+//
+// Anything already older than the window passes straight through. It is older than every held
+// event, so this keeps the order, and it lets combos and hold-taps re-raise their captured events.
+
+#define REORDER_WINDOW_MS CONFIG_ZMK_SPLIT_CENTRAL_REORDER_WINDOW_MS
+
+// Sorted by timestamp, oldest first.
+static struct zmk_position_state_changed_event
+    held_events[CONFIG_ZMK_SPLIT_CENTRAL_REORDER_QUEUE_SIZE];
+static size_t held_count;
+
+static void release_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(release_work, release_work_cb);
+
+static void release_oldest_event(void) {
+    struct zmk_position_state_changed_event ev = held_events[0];
+
+    // Update the queue before releasing, in case a later listener raises another position event.
+    held_count--;
+    memmove(&held_events[0], &held_events[1], held_count * sizeof(held_events[0]));
+
+    LOG_DBG("Releasing position %d from source %d", ev.data.position, ev.data.source);
+    ZMK_EVENT_RELEASE(ev);
+}
+
+static void schedule_release(void) {
+    if (held_count == 0) {
+        return;
+    }
+
+    int64_t wait_ms = held_events[0].data.timestamp + REORDER_WINDOW_MS - k_uptime_get();
+    k_work_reschedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &release_work,
+                                K_MSEC(MAX(wait_ms, 0)));
+}
+
+static void release_work_cb(struct k_work *work) {
+    int64_t now = k_uptime_get();
+
+    while (held_count > 0 && held_events[0].data.timestamp + REORDER_WINDOW_MS <= now) {
+        release_oldest_event();
+    }
+
+    schedule_release();
+}
+
+static int split_central_reorder_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (ev->timestamp + REORDER_WINDOW_MS <= k_uptime_get()) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    while (held_count == ARRAY_SIZE(held_events)) {
+        if (ev->timestamp < held_events[0].data.timestamp) {
+            return ZMK_EV_EVENT_BUBBLE;
+        }
+
+        LOG_WRN("Reorder queue full, releasing the oldest position event early");
+        release_oldest_event();
+    }
+
+    size_t i = held_count;
+    while (i > 0 && held_events[i - 1].data.timestamp > ev->timestamp) {
+        i--;
+    }
+
+    memmove(&held_events[i + 1], &held_events[i], (held_count - i) * sizeof(held_events[0]));
+    held_events[i] = copy_raised_zmk_position_state_changed(ev);
+    held_count++;
+
+    schedule_release();
+
+    return ZMK_EV_EVENT_CAPTURED;
+}
+
+ZMK_LISTENER(split_central_reorder, split_central_reorder_listener);
+ZMK_SUBSCRIPTION_PRIORITY(split_central_reorder, zmk_position_state_changed, CRITICAL);
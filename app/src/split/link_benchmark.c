@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK_SHELL)
+#include <zephyr/shell/shell.h>
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK_SHELL)
+
+#include <zmk/split/central.h>
+#include <zmk/split/link_benchmark.h>
+
+// Pongs that haven't arrived this long after they were due are counted as lost.
+#define PONG_TIMEOUT_MS 1000
+
+// Rates tried by the throughput benchmark, in events per second.
+static const uint16_t rates[] = {50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000};
+
+// Only one benchmark runs at a time. Its pongs are counted by the central's event handler, on
+// another thread.
+static K_MUTEX_DEFINE(run_mutex);
+static struct k_spinlock lock;
+
+static uint32_t next_seq;
+
+static struct {
+    bool running;
+    uint8_t source;
+    // Pongs echoing any other sequence number belong to an earlier run.
+    uint32_t first_seq;
+    uint16_t seq_count;
+
+    uint16_t received;
+    uint64_t total_rtt_us;
+    uint32_t first_rx_us;
+    uint32_t last_rx_us;
+    uint32_t last_transit_us;
+    // Scaled by 16, as suggested by RFC 3550 for integer math.
+    uint32_t jitter_x16;
+    struct zmk_split_link_benchmark_rtt rtt;
+} run;
+
+static uint32_t uptime_us(void) { return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks()); }
+
+static uint8_t bucket_for(uint32_t us) {
+    if (us < 2) {
+        return 0;
+    }
+
+    return MIN(31 - __builtin_clz(us), ZMK_SPLIT_LINK_BENCHMARK_BUCKETS - 1);
+}
+
+void zmk_split_link_benchmark_handle_pong(uint8_t source,
+                                          const struct zmk_split_transport_link_pong *pong) {
+    const uint32_t now = uptime_us();
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (!run.running || source != run.source || pong->seq - run.first_seq >= run.seq_count) {
+        k_spin_unlock(&lock, key);
+        return;
+    }
+
+    const uint32_t rtt = now - pong->sent_us;
+    // The offset between the two clocks is part of the transit time, but cancels out between
+    // consecutive pongs.
+    const uint32_t transit = now - pong->peripheral_us;
+
+    if (run.received++ == 0) {
+        run.first_rx_us = now;
+        run.rtt.min_us = rtt;
+    } else {
+        const int32_t d = (int32_t)(transit - run.last_transit_us);
+
+        run.jitter_x16 += abs(d) - ((run.jitter_x16 + 8) >> 4);
+    }
+
+    run.last_rx_us = now;
+    run.last_transit_us = transit;
+    run.total_rtt_us += rtt;
+    run.rtt.min_us = MIN(run.rtt.min_us, rtt);
+    run.rtt.max_us = MAX(run.rtt.max_us, rtt);
+    run.rtt.buckets[bucket_for(rtt)]++;
+
+    k_spin_unlock(&lock, key);
+}
+
+static uint32_t start_run(uint8_t source, uint16_t seq_count) {
+    uint32_t first_seq;
+
+    K_SPINLOCK(&lock) {
+        memset(&run, 0, sizeof(run));
+        run.source = source;
+        run.first_seq = first_seq = next_seq;
+        run.seq_count = seq_count;
+        run.running = true;
+        next_seq += seq_count;
+    }
+
+    return first_seq;
+}
+
+static uint16_t received_pongs(void) {
+    uint16_t received;
+
+    K_SPINLOCK(&lock) { received = run.received; }
+
+    return received;
+}
+
+static void wait_for_pongs(uint16_t expected, uint32_t timeout_ms) {
+    const int64_t deadline = k_uptime_get() + timeout_ms;
+
+    while (received_pongs() < expected && k_uptime_get() < deadline) {
+        k_msleep(10);
+    }
+
+    K_SPINLOCK(&lock) { run.running = false; }
+}
+
+int zmk_split_link_benchmark_run_rtt(uint8_t source, uint16_t count, uint16_t interval_ms,
+                                     struct zmk_split_link_benchmark_rtt *result) {
+    if (k_mutex_lock(&run_mutex, K_NO_WAIT) < 0) {
+        return -EBUSY;
+    }
+
+    const uint32_t first_seq = start_run(source, count);
+    uint16_t sent = 0;
+    int err = 0;
+
+    for (; sent < count; sent++) {
+        struct zmk_split_transport_link_ping ping = {
+            .seq = first_seq + sent,
+            .sent_us = uptime_us(),
+            .count = 1,
+        };
+
+        err = zmk_split_central_send_link_ping(source, &ping);
+        if (err < 0) {
+            break;
+        }
+
+        k_msleep(interval_ms);
+    }
+
+    wait_for_pongs(sent, PONG_TIMEOUT_MS);
+
+    K_SPINLOCK(&lock) {
+        *result = run.rtt;
+        result->sent = sent;
+        result->received = run.received;
+        result->avg_us = run.received ? run.total_rtt_us / run.received : 0;
+        result->jitter_us = run.jitter_x16 >> 4;
+    }
+
+    k_mutex_unlock(&run_mutex);
+    return err;
+}
+
+int zmk_split_link_benchmark_run_rate(uint8_t source,
+                                      struct zmk_split_link_benchmark_rate *result) {
+    if (k_mutex_lock(&run_mutex, K_NO_WAIT) < 0) {
+        return -EBUSY;
+    }
+
+    const uint16_t burst = CONFIG_ZMK_SPLIT_LINK_BENCHMARK_BURST;
+    int err = 0;
+
+    *result = (struct zmk_split_link_benchmark_rate){0};
+
+    for (size_t i = 0; i < ARRAY_SIZE(rates); i++) {
+        struct zmk_split_transport_link_ping ping = {
+            .seq = start_run(source, 1),
+            .sent_us = uptime_us(),
+            .count = burst,
+            .rate = rates[i],
+        };
+
+        err = zmk_split_central_send_link_ping(source, &ping);
+        if (err < 0) {
+            K_SPINLOCK(&lock) { run.running = false; }
+            break;
+        }
+
+        wait_for_pongs(burst, (uint32_t)burst * MSEC_PER_SEC / rates[i] + PONG_TIMEOUT_MS);
+
+        uint16_t received;
+        uint32_t elapsed_us;
+
+        K_SPINLOCK(&lock) {
+            received = run.received;
+            elapsed_us = run.last_rx_us - run.first_rx_us;
+        }
+
+        if (received < burst) {
+            result->lossy_rate = rates[i];
+            result->lost = burst - received;
+            break;
+        }
+
+        result->max_rate = rates[i];
+        result->achieved_rate =
+            elapsed_us ? (uint64_t)(burst - 1) * USEC_PER_SEC / elapsed_us : rates[i];
+    }
+
+    k_mutex_unlock(&run_mutex);
+    return err;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK_SHELL)
+
+static unsigned long arg_or(size_t argc, char **argv, size_t index, unsigned long fallback) {
+    return index < argc ? strtoul(argv[index], NULL, 10) : fallback;
+}
+
+static int cmd_split_link_ping(const struct shell *sh, size_t argc, char **argv) {
+    struct zmk_split_link_benchmark_rtt rtt;
+    const uint8_t source = arg_or(argc, argv, 1, 0);
+
+    int err = zmk_split_link_benchmark_run_rtt(source, arg_or(argc, argv, 2, 100),
+                                               arg_or(argc, argv, 3, 20), &rtt);
+    if (err < 0) {
+        shell_error(sh, "Failed to ping peripheral %u: %d", source, err);
+        return err;
+    }
+
+    shell_print(sh, "%u of %u pongs, round trip min %u avg %u max %u us, jitter %u us",
+                rtt.received, rtt.sent, rtt.min_us, rtt.avg_us, rtt.max_us, rtt.jitter_us);
+
+    for (int i = 0; i < ZMK_SPLIT_LINK_BENCHMARK_BUCKETS; i++) {
+        if (rtt.buckets[i] == 0) {
+            continue;
+        }
+
+        if (i == ZMK_SPLIT_LINK_BENCHMARK_BUCKETS - 1) {
+            shell_print(sh, "  %6u+      us %5u", BIT(i), rtt.buckets[i]);
+        } else {
+            shell_print(sh, "  %6u-%-6u us %5u", i == 0 ? 0 : BIT(i), BIT(i + 1) - 1,
+                        rtt.buckets[i]);
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_split_link_rate(const struct shell *sh, size_t argc, char **argv) {
+    struct zmk_split_link_benchmark_rate rate;
+    const uint8_t source = arg_or(argc, argv, 1, 0);
+
+    int err = zmk_split_link_benchmark_run_rate(source, &rate);
+    if (err < 0) {
+        shell_error(sh, "Failed to run the rate benchmark on peripheral %u: %d", source, err);
+        return err;
+    }
+
+    shell_print(sh, "No events lost up to %u/s, received at %u/s", rate.max_rate,
+                rate.achieved_rate);
+    if (rate.lossy_rate) {
+        shell_print(sh, "%u of %u events lost at %u/s", rate.lost,
+                    CONFIG_ZMK_SPLIT_LINK_BENCHMARK_BURST, rate.lossy_rate);
+    }
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_split_link,
+    SHELL_CMD_ARG(ping, NULL, "Measure round trips: ping [source] [count] [interval ms]",
+                  cmd_split_link_ping, 1, 3),
+    SHELL_CMD_ARG(rate, NULL, "Find the highest lossless event rate: rate [source]",
+                  cmd_split_link_rate, 1, 1),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(split_link, &sub_split_link, "ZMK split link benchmarks", NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK_SHELL)
@@ -7,16 +7,22 @@
 #include <errno.h>
 
 #include <zmk/stdlib.h>
+#include <zmk/split/peripheral.h>
 #include <zmk/split/transport/peripheral.h>
 
 #include <drivers/behavior.h>
 #include <zmk/behavior.h>
+#include <zmk/behavior_queue.h>
 
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/sensor_event.h>
 #include <zmk/events/battery_state_changed.h>
 
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#include <zmk/rgb_underglow.h>
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+
 #include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 
@@ -24,6 +30,75 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 const struct zmk_split_transport_peripheral *active_transport;
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
+// Pongs are sent from a work item, so a burst doesn't hold up the transport's receive path. A new
+// ping replaces a burst still being sent.
+
+static struct k_spinlock link_ping_lock;
+static struct zmk_split_transport_link_ping link_ping;
+static uint32_t link_ping_received_us;
+static uint16_t link_pongs_sent;
+
+static uint32_t uptime_us(void) { return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks()); }
+
+static void send_link_pongs(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(link_pong_work, send_link_pongs);
+
+static void send_link_pongs(struct k_work *work) {
+    struct zmk_split_transport_link_ping ping;
+    uint32_t received_us;
+    uint16_t sent;
+
+    K_SPINLOCK(&link_ping_lock) {
+        ping = link_ping;
+        received_us = link_ping_received_us;
+        sent = link_pongs_sent;
+    }
+
+    uint32_t due = ping.count;
+    if (ping.rate > 0) {
+        due = MIN((uint64_t)(uptime_us() - received_us) * ping.rate / USEC_PER_SEC + 1, due);
+    }
+
+    for (; sent < due; sent++) {
+        struct zmk_split_transport_peripheral_event ev = {
+            .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_PONG,
+            .data = {.link_pong = {.seq = ping.seq,
+                                   .sent_us = ping.sent_us,
+                                   .peripheral_us = uptime_us(),
+                                   .index = sent}},
+        };
+
+        // A pong the transport has no room for is lost like any other event, which is what the
+        // central's throughput benchmark looks for.
+        zmk_split_peripheral_report_event(&ev);
+    }
+
+    K_SPINLOCK(&link_ping_lock) {
+        if (link_ping.seq == ping.seq) {
+            link_pongs_sent = sent;
+        }
+    }
+
+    if (sent < ping.count) {
+        k_work_schedule(&link_pong_work, K_USEC(DIV_ROUND_UP(USEC_PER_SEC, ping.rate)));
+    }
+}
+
+static void handle_link_ping(const struct zmk_split_transport_link_ping *ping) {
+    K_SPINLOCK(&link_ping_lock) {
+        link_ping = *ping;
+        link_ping_received_us = uptime_us();
+        link_pongs_sent = 0;
+    }
+
+    k_work_reschedule(&link_pong_work, K_NO_WAIT);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+
 int zmk_split_transport_peripheral_command_handler(
     const struct zmk_split_transport_peripheral *transport,
     struct zmk_split_transport_central_command cmd) {
@@ -50,7 +125,53 @@ int zmk_split_transport_peripheral_command_handler(
         if (err) {
             LOG_ERR("Failed to invoke behavior %s: %d", binding.behavior_dev, err);
         }
+        break;
+    }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR_BATCH: {
+        struct zmk_behavior_binding_event event = {
+            .position = cmd.data.invoke_behavior_batch.position,
+            .timestamp = k_uptime_get(),
+        };
+        uint8_t count = MIN(cmd.data.invoke_behavior_batch.count,
+                            ARRAY_SIZE(cmd.data.invoke_behavior_batch.invocations));
+
+        for (uint8_t i = 0; i < count; i++) {
+            const struct zmk_split_transport_behavior_invocation *inv =
+                &cmd.data.invoke_behavior_batch.invocations[i];
+
+            // The queue keeps the binding, so it needs a label that outlives the command.
+            const struct device *behavior = zmk_behavior_get_binding(inv->behavior_dev);
+            if (!behavior) {
+                LOG_WRN("Unknown behavior %s in batch, skipping", inv->behavior_dev);
+                continue;
+            }
+
+            struct zmk_behavior_binding binding = {
+                .behavior_dev = behavior->name,
+                .param1 = inv->param1,
+                .param2 = inv->param2,
+            };
+
+            int err = zmk_behavior_queue_add(&event, binding, inv->state > 0, inv->wait_ms);
+            if (err < 0) {
+                LOG_ERR("Failed to queue behavior %s: %d", binding.behavior_dev, err);
+                return err;
+            }
+        }
+
+        return 0;
     }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_RGB_SYNC:
+        return zmk_rgb_underglow_apply_sync(&cmd.data.set_rgb_sync);
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_LINK_PING:
+        handle_link_ping(&cmd.data.link_ping);
+        return 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
     default:
         LOG_WRN("Unhandled command type %d", cmd.type);
         return -ENOTSUP;
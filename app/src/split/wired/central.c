@@ -10,7 +10,6 @@
 #include <zephyr/pm/device.h>
 #include <zephyr/pm/device_runtime.h>
 #include <zephyr/settings/settings.h>
-#include <zephyr/sys/crc.h>
 #include <zephyr/sys/ring_buffer.h>
 
 #include <zephyr/logging/log.h>
@@ -29,7 +28,9 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/sensor_event.h>
 #include <zmk/pointing/input_split.h>
 #include <zmk/hid_indicators_types.h>
+#include <zmk/workqueue.h>
 #include <zmk/physical_layouts.h>
+#include <zmk/queue_stats.h>
 
 #include "wired.h"
 
@@ -38,6 +39,19 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define IS_HALF_DUPLEX_MODE                                                                        \
     (DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT) && DT_INST_PROP_OR(0, half_duplex, false))
 
+#define IS_SCHEDULED_HALF_DUPLEX_MODE                                                              \
+    (IS_HALF_DUPLEX_MODE && IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_SCHEDULED))
+#define IS_POLLED_HALF_DUPLEX_MODE (IS_HALF_DUPLEX_MODE && !IS_SCHEDULED_HALF_DUPLEX_MODE)
+
+#define IS_MULTI_DROP_MODE                                                                         \
+    (IS_SCHEDULED_HALF_DUPLEX_MODE && IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_DROP))
+
+#if IS_MULTI_DROP_MODE
+#define PERIPHERAL_COUNT CONFIG_ZMK_SPLIT_WIRED_MULTI_DROP_PERIPHERALS
+#else
+#define PERIPHERAL_COUNT 1
+#endif
+
 #define RX_BUFFER_SIZE                                                                             \
     ((sizeof(struct event_envelope) + sizeof(struct msg_postfix)) *                                \
      CONFIG_ZMK_SPLIT_WIRED_EVENT_BUFFER_ITEMS)
@@ -45,7 +59,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     ((sizeof(struct command_envelope) + sizeof(struct msg_postfix)) *                              \
      CONFIG_ZMK_SPLIT_WIRED_CMD_BUFFER_ITEMS)
 
-#if IS_HALF_DUPLEX_MODE
+#if IS_POLLED_HALF_DUPLEX_MODE
 
 static K_SEM_DEFINE(tx_sem, 0, 1);
 
@@ -54,6 +68,8 @@ static K_SEM_DEFINE(tx_sem, 0, 1);
 RING_BUF_DECLARE(rx_buf, RX_BUFFER_SIZE);
 RING_BUF_DECLARE(tx_buf, TX_BUFFER_SIZE);
 
+ZMK_QUEUE_STATS_DEFINE(tx_buf, "wired command TX bytes", TX_BUFFER_SIZE);
+
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
 static const struct device *uart = DEVICE_DT_GET(DT_INST_PHANDLE(0, device));
@@ -87,10 +103,37 @@ K_WORK_DEFINE(publish_events, publish_events_work);
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
 
-uint8_t async_rx_buf[RX_BUFFER_SIZE / 2][2];
+uint8_t __aligned(4) async_rx_buf[2][RX_BUFFER_SIZE / 2];
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
+K_MSGQ_DEFINE(event_msgq, sizeof(struct event_payload), CONFIG_ZMK_SPLIT_WIRED_EVENT_BUFFER_ITEMS,
+              4);
+
+ZMK_QUEUE_STATS_DEFINE(event_msgq, "wired events", CONFIG_ZMK_SPLIT_WIRED_EVENT_BUFFER_ITEMS);
+
+static void queue_event_frame(const uint8_t *payload, size_t payload_size) {
+    struct event_payload ev = {0};
+
+    memcpy(&ev, payload, MIN(payload_size, sizeof(ev)));
+
+    int ret = ZMK_QUEUE_STATS_MSGQ_PUT(event_msgq, &event_msgq, &ev, K_NO_WAIT);
+    if (ret < 0) {
+        LOG_WRN("Failed to queue peripheral event for processing (%d)", ret);
+        return;
+    }
+
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &publish_events);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
 
 static struct zmk_split_wired_async_state async_state = {
     .process_tx_work = &publish_events,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+    .frame_callback = queue_event_frame,
+    .max_payload_size = sizeof(struct event_payload),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
     .rx_bufs = {async_rx_buf[0], async_rx_buf[1]},
     .rx_bufs_len = RX_BUFFER_SIZE / 2,
     .rx_size_process_trigger = MSG_EXTRA_SIZE + 1,
@@ -103,7 +146,14 @@ static struct zmk_split_wired_async_state async_state = {
 
 #endif
 
-#if IS_HALF_DUPLEX_MODE
+#if IS_SCHEDULED_HALF_DUPLEX_MODE
+
+// Set while the peripheral owns the line.
+static atomic_t slot_open;
+
+static int can_tx(void) { return atomic_get(&slot_open) ? -EBUSY : 0; }
+
+#elif IS_POLLED_HALF_DUPLEX_MODE
 
 static int can_tx(void) { return k_sem_take(&tx_sem, K_NO_WAIT); }
 
@@ -178,6 +228,24 @@ static ssize_t get_payload_data_size(const struct zmk_split_transport_central_co
         return sizeof(cmd->data.set_physical_layout);
     case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_HID_INDICATORS:
         return sizeof(cmd->data.set_hid_indicators);
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_BAUD_RATE:
+        return sizeof(cmd->data.set_baud_rate);
+#if IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_RGB_SYNC:
+        return sizeof(cmd->data.set_rgb_sync);
+#endif // IS_ENABLED(CONFIG_ZMK_RGB_UNDERGLOW_SPLIT_SYNC)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_LINK_PING:
+        return sizeof(cmd->data.link_ping);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
+    case ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_INVOKE_BEHAVIOR_BATCH:
+        // Only the used invocations go over the wire.
+        return offsetof(typeof(cmd->data.invoke_behavior_batch), invocations) +
+               MIN(cmd->data.invoke_behavior_batch.count,
+                   ARRAY_SIZE(cmd->data.invoke_behavior_batch.invocations)) *
+                   sizeof(struct zmk_split_transport_behavior_invocation);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BEHAVIOR_BATCHING)
     default:
         return -ENOTSUP;
     }
@@ -185,7 +253,7 @@ static ssize_t get_payload_data_size(const struct zmk_split_transport_central_co
 
 static int split_central_wired_send_command(uint8_t source,
                                             struct zmk_split_transport_central_command cmd) {
-    if (source != 0) {
+    if (source >= PERIPHERAL_COUNT) {
         return -EINVAL;
     }
 
@@ -199,26 +267,18 @@ static int split_central_wired_send_command(uint8_t source,
     size_t payload_size =
         data_size + sizeof(source) + sizeof(enum zmk_split_transport_central_command_type);
 
-    if (ring_buf_space_get(&tx_buf) < MSG_EXTRA_SIZE + payload_size) {
+    struct command_payload payload = {
+        .source = source,
+        .cmd = cmd,
+    };
+
+    if (zmk_split_wired_put_msg(&tx_buf, &payload, payload_size) < 0) {
+        ZMK_QUEUE_STATS_OVERFLOW(tx_buf);
         LOG_WRN("No room to send command to the peripheral %d", source);
         return -ENOSPC;
     }
 
-    struct command_envelope env = {.prefix =
-                                       {
-                                           .magic_prefix = ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
-                                           .payload_size = payload_size,
-                                       },
-                                   .payload = {
-                                       .source = source,
-                                       .cmd = cmd,
-                                   }};
-
-    struct msg_postfix postfix = {.crc =
-                                      crc32_ieee((void *)&env, sizeof(env.prefix) + payload_size)};
-
-    ring_buf_put(&tx_buf, (uint8_t *)&env, sizeof(env.prefix) + payload_size);
-    ring_buf_put(&tx_buf, (uint8_t *)&postfix, sizeof(postfix));
+    ZMK_QUEUE_STATS_PUT(tx_buf, ring_buf_size_get(&tx_buf));
 
     if (can_tx() >= 0) {
         begin_tx();
@@ -227,7 +287,81 @@ static int split_central_wired_send_command(uint8_t source,
     return 0;
 }
 
-#if IS_HALF_DUPLEX_MODE
+#if IS_SCHEDULED_HALF_DUPLEX_MODE
+
+// The peripheral only transmits in slots granted by the central at a fixed period. A cycle is one
+// burst from the central carrying any pending commands and the grant, answered by one burst with
+// every event the peripheral accumulated since its last slot and an end of slot marker. The line
+// turns around twice per cycle, and no event waits longer than a period plus a slot for its turn.
+//
+// With several peripherals on the line, the grant is addressed to one of them at a time. Each
+// period starts a round where every peripheral gets a slot, one straight after the other, so an
+// event waits at most a period plus a slot for every peripheral.
+
+static int64_t next_slot_time;
+static uint8_t slot_owner;
+
+static void slot_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(slot_work, slot_work_cb);
+
+static void start_slots(void) {
+    atomic_set(&slot_open, false);
+    slot_owner = 0;
+    next_slot_time = k_uptime_get();
+    k_work_reschedule(&slot_work, K_NO_WAIT);
+}
+
+static void stop_slots(void) {
+    k_work_cancel_delayable(&slot_work);
+    atomic_set(&slot_open, false);
+}
+
+static void end_slot(void) {
+    if (!atomic_cas(&slot_open, true, false)) {
+        return;
+    }
+
+    // Commands queued while the peripheral had the line can go out now, instead of waiting for the
+    // next grant.
+    if (!ring_buf_is_empty(&tx_buf)) {
+        begin_tx();
+    }
+
+    if (++slot_owner < PERIPHERAL_COUNT) {
+        k_work_reschedule(&slot_work, K_NO_WAIT);
+        return;
+    }
+
+    slot_owner = 0;
+
+    // Keep to the fixed schedule, skipping cycles that have already been missed.
+    int64_t now = k_uptime_get();
+    next_slot_time += CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_SLOT_PERIOD_MS;
+    if (next_slot_time < now) {
+        next_slot_time = now;
+    }
+
+    k_work_reschedule(&slot_work, K_TIMEOUT_ABS_MS(next_slot_time));
+}
+
+static void slot_work_cb(struct k_work *work) {
+    if (atomic_get(&slot_open)) {
+        LOG_DBG("No end of slot from peripheral %d, taking the line back", slot_owner);
+        end_slot();
+        return;
+    }
+
+    split_central_wired_send_command(slot_owner,
+                                     (struct zmk_split_transport_central_command){
+                                         .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS,
+                                     });
+    atomic_set(&slot_open, true);
+
+    k_work_reschedule(&slot_work, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_SLOT_TIMEOUT_MS));
+}
+
+#elif IS_POLLED_HALF_DUPLEX_MODE
 
 void rx_done_cb(struct k_work *work);
 
@@ -247,6 +381,211 @@ void rx_done_cb(struct k_work *work) {
 
 #endif
 
+static uint32_t link_latency_ms;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+// The link is stepped up one standard rate at a time, up to the configured maximum. Each step is a
+// handshake: the peripheral acknowledges the new rate at the old one, both halves switch, and the
+// central confirms at the new rate. A missed acknowledgement caps the rate where it is, a missed
+// confirmation goes back to the previous rate, and too many bad frames step the rate back down.
+// Once at the cap, the same confirmation is sent periodically as a link check, and a failed check
+// drops back to the base rate, where the peripheral goes if it stops understanding the central.
+
+enum link_state {
+    LINK_IDLE,
+    LINK_AWAIT_ACK,
+    LINK_SWITCHING,
+    LINK_SETTLING,
+    LINK_AWAIT_CONFIRM,
+};
+
+static enum link_state link_state;
+static uint32_t base_baud_rate;
+static uint32_t current_baud_rate;
+static uint32_t target_baud_rate;
+static uint32_t previous_baud_rate;
+static uint32_t ceiling_baud_rate;
+static bool link_fallback;
+static int64_t link_request_time;
+static struct zmk_split_transport_link_stats last_link_stats;
+
+static void link_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(link_work, link_work_cb);
+
+static void apply_baud_rate(uint32_t baud_rate) {
+    if (!baud_rate || baud_rate == current_baud_rate) {
+        return;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
+    int ret = zmk_split_wired_async_set_baud_rate(&async_state, baud_rate);
+#else
+    int ret = zmk_split_wired_set_baud_rate(uart, baud_rate);
+#endif
+    if (ret < 0) {
+        LOG_WRN("Failed to set the wired split baud rate to %d (%d)", baud_rate, ret);
+        return;
+    }
+
+    current_baud_rate = baud_rate;
+}
+
+static int send_set_baud_rate(uint32_t baud_rate) {
+    link_request_time = k_uptime_get();
+
+    return split_central_wired_send_command(
+        0, (struct zmk_split_transport_central_command){
+               .type = ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_BAUD_RATE,
+               .data = {.set_baud_rate = {.baud_rate = baud_rate}},
+           });
+}
+
+static void wait_for_link(enum link_state state, k_timeout_t timeout) {
+    link_state = state;
+    k_work_reschedule(&link_work, timeout);
+}
+
+static void begin_baud_rate_change(uint32_t baud_rate, bool fallback) {
+    target_baud_rate = baud_rate;
+    link_fallback = fallback;
+
+    if (send_set_baud_rate(baud_rate) < 0) {
+        wait_for_link(LINK_IDLE, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_STEP_INTERVAL_MS));
+        return;
+    }
+
+    wait_for_link(LINK_AWAIT_ACK, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_TIMEOUT_MS));
+}
+
+static bool check_link_error_rate(void) {
+    struct zmk_split_transport_link_stats stats;
+    zmk_split_wired_get_link_stats(&stats);
+
+    uint32_t frames = stats.frames - last_link_stats.frames;
+    uint32_t errors = (stats.crc_errors - last_link_stats.crc_errors) +
+                      (stats.resyncs - last_link_stats.resyncs);
+    last_link_stats = stats;
+
+    return errors * 100 >
+           (frames + errors) * CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_MAX_ERROR_PERCENT;
+}
+
+static bool link_is_silent(void) {
+    struct zmk_split_transport_link_stats stats;
+    zmk_split_wired_get_link_stats(&stats);
+
+    return stats.frames == last_link_stats.frames;
+}
+
+static void link_work_cb(struct k_work *work) {
+    switch (link_state) {
+    case LINK_IDLE:
+        if (check_link_error_rate() && current_baud_rate > base_baud_rate) {
+            uint32_t lower = MAX(zmk_split_wired_next_baud_rate(current_baud_rate, false),
+                                 base_baud_rate);
+            LOG_WRN("Too many wired split link errors at %d baud, stepping down to %d",
+                    current_baud_rate, lower);
+            ceiling_baud_rate = lower;
+            begin_baud_rate_change(lower, true);
+            return;
+        }
+
+        uint32_t next = zmk_split_wired_next_baud_rate(current_baud_rate, true);
+        if (next && next <= ceiling_baud_rate) {
+            begin_baud_rate_change(next, false);
+            return;
+        }
+
+        // Nothing to change, so just check the link is still there.
+        previous_baud_rate = current_baud_rate;
+        if (send_set_baud_rate(current_baud_rate) < 0) {
+            wait_for_link(LINK_IDLE, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_STEP_INTERVAL_MS));
+            return;
+        }
+        wait_for_link(LINK_AWAIT_CONFIRM, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_TIMEOUT_MS));
+        break;
+    case LINK_AWAIT_ACK:
+        if (link_fallback) {
+            // The peripheral can't be reached at the current rate, so meet it at the base rate.
+            apply_baud_rate(base_baud_rate);
+        } else if (!link_is_silent()) {
+            LOG_DBG("Peripheral didn't accept %d baud, staying at %d", target_baud_rate,
+                    current_baud_rate);
+            ceiling_baud_rate = current_baud_rate;
+        }
+        wait_for_link(LINK_IDLE, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_STEP_INTERVAL_MS));
+        break;
+    case LINK_SWITCHING:
+        // Let pending commands go out at the old rate first.
+        if (!ring_buf_is_empty(&tx_buf)) {
+            k_work_reschedule(&link_work, K_MSEC(1));
+            return;
+        }
+
+        previous_baud_rate = current_baud_rate;
+        apply_baud_rate(target_baud_rate);
+        // Give the peripheral time to switch after sending its acknowledgement.
+        wait_for_link(LINK_SETTLING, K_MSEC(5));
+        break;
+    case LINK_SETTLING:
+        send_set_baud_rate(current_baud_rate);
+        wait_for_link(LINK_AWAIT_CONFIRM, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_TIMEOUT_MS));
+        break;
+    case LINK_AWAIT_CONFIRM:
+        if (previous_baud_rate != current_baud_rate) {
+            LOG_WRN("Wired split link failed at %d baud, going back to %d", current_baud_rate,
+                    previous_baud_rate);
+            apply_baud_rate(previous_baud_rate);
+            ceiling_baud_rate = previous_baud_rate;
+        } else if (current_baud_rate != base_baud_rate) {
+            LOG_WRN("Wired split link check failed at %d baud, going back to %d",
+                    current_baud_rate, base_baud_rate);
+            apply_baud_rate(base_baud_rate);
+        }
+        wait_for_link(LINK_IDLE, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_STEP_INTERVAL_MS));
+        break;
+    }
+}
+
+static void handle_link_ack(uint32_t baud_rate) {
+    switch (link_state) {
+    case LINK_AWAIT_ACK:
+        if (baud_rate != target_baud_rate) {
+            return;
+        }
+
+        link_latency_ms = k_uptime_get() - link_request_time;
+        wait_for_link(LINK_SWITCHING, K_NO_WAIT);
+        break;
+    case LINK_AWAIT_CONFIRM:
+        if (baud_rate != current_baud_rate) {
+            return;
+        }
+
+        link_latency_ms = k_uptime_get() - link_request_time;
+        if (previous_baud_rate != current_baud_rate) {
+            LOG_INF("Wired split link running at %d baud", current_baud_rate);
+        }
+        previous_baud_rate = current_baud_rate;
+        wait_for_link(LINK_IDLE, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_STEP_INTERVAL_MS));
+        break;
+    default:
+        break;
+    }
+}
+
+static void reset_link(void) {
+    k_work_cancel_delayable(&link_work);
+    apply_baud_rate(base_baud_rate);
+    ceiling_baud_rate = CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_MAX;
+    zmk_split_wired_get_link_stats(&last_link_stats);
+    wait_for_link(LINK_IDLE, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_STEP_INTERVAL_MS));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_INTERRUPT)
 
 static void serial_cb(const struct device *dev, void *user_data) {
@@ -254,7 +593,7 @@ static void serial_cb(const struct device *dev, void *user_data) {
     while (uart_irq_update(dev) && uart_irq_is_pending(dev)) {
         if (uart_irq_rx_ready(dev)) {
             zmk_split_wired_fifo_read(dev, &rx_buf, &publish_events, NULL);
-#if IS_HALF_DUPLEX_MODE
+#if IS_POLLED_HALF_DUPLEX_MODE
             k_work_reschedule(&rx_done_work,
                               K_TICKS(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_RX_COMPLETE_TIMEOUT));
 #endif
@@ -377,29 +716,51 @@ static int zmk_split_wired_central_init(void) {
 
 #endif // HAS_DETECT_GPIO
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+    if (zmk_split_wired_get_baud_rate(uart, &base_baud_rate) < 0) {
+        LOG_WRN("Failed to read the wired split baud rate, not adapting it");
+    }
+    current_baud_rate = base_baud_rate;
+    ceiling_baud_rate = base_baud_rate ? CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_MAX : 0;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
     return 0;
 }
 
 SYS_INIT(zmk_split_wired_central_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
 
 static int split_central_wired_get_available_source_ids(uint8_t *sources) {
-    sources[0] = 0;
+    for (uint8_t i = 0; i < PERIPHERAL_COUNT; i++) {
+        sources[i] = i;
+    }
 
-    return 1;
+    return PERIPHERAL_COUNT;
 }
 
 static int split_central_wired_set_enabled(bool enabled) {
     if (enabled) {
         begin_rx();
-#if IS_HALF_DUPLEX_MODE
+#if IS_SCHEDULED_HALF_DUPLEX_MODE
+        start_slots();
+#elif IS_POLLED_HALF_DUPLEX_MODE
         k_work_schedule(&rx_done_work, K_MSEC(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_RX_TIMEOUT));
 #endif
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+        if (base_baud_rate) {
+            reset_link();
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
         return 0;
 #if HAS_DETECT_GPIO
     } else {
-#if IS_HALF_DUPLEX_MODE
+#if IS_SCHEDULED_HALF_DUPLEX_MODE
+        stop_slots();
+#elif IS_POLLED_HALF_DUPLEX_MODE
         k_work_cancel_delayable(&rx_done_work);
 #endif
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+        k_work_cancel_delayable(&link_work);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
         stop_rx();
         return 0;
 #endif
@@ -418,34 +779,38 @@ split_central_wired_set_status_callback(zmk_split_transport_central_status_chang
     return 0;
 }
 
+#endif // HAS_DETECT_GPIO
+
 static struct zmk_split_transport_status split_central_wired_get_status() {
-    int detected = gpio_pin_get_dt(&detect_gpio);
-    if (detected > 0) {
-        return (struct zmk_split_transport_status){
-            .available = true,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
-
-        };
-    } else {
-        return (struct zmk_split_transport_status){
-            .available = false,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED,
+    struct zmk_split_transport_status status = {
+        .available = true,
+        .enabled = true, // Track this
+        .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+    };
 
-        };
+#if HAS_DETECT_GPIO
+    if (gpio_pin_get_dt(&detect_gpio) <= 0) {
+        status.available = false;
+        status.connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED;
     }
-}
-
 #endif // HAS_DETECT_GPIO
 
+    zmk_split_wired_get_link_stats(&status.link_stats);
+    status.link_stats.latency_ms = link_latency_ms;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+    status.link_stats.baud_rate = current_baud_rate;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+    return status;
+}
+
 static const struct zmk_split_transport_central_api central_api = {
     .send_command = split_central_wired_send_command,
     .get_available_source_ids = split_central_wired_get_available_source_ids,
     .set_enabled = split_central_wired_set_enabled,
+    .get_status = split_central_wired_get_status,
 #if HAS_DETECT_GPIO
     .set_status_callback = split_central_wired_set_status_callback,
-    .get_status = split_central_wired_get_status,
 #endif // HAS_DETECT_GPIO
 };
 
@@ -461,12 +826,48 @@ static void notify_transport_status(void) {
 
 #endif
 
+static void handle_peripheral_event(uint8_t source,
+                                    const struct zmk_split_transport_peripheral_event *ev) {
+    if (source >= PERIPHERAL_COUNT) {
+        LOG_WRN("Dropping event from unknown peripheral %d", source);
+        return;
+    }
+
+#if IS_SCHEDULED_HALF_DUPLEX_MODE
+    if (ev->type == ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SLOT_END) {
+        // A late marker from the previous owner mustn't end the slot of the next one.
+        if (source == slot_owner) {
+            end_slot();
+        }
+        return;
+    }
+#endif // IS_SCHEDULED_HALF_DUPLEX_MODE
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+    if (ev->type == ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_ACK) {
+        handle_link_ack(ev->data.link_ack.baud_rate);
+        return;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+    zmk_split_transport_central_peripheral_event_handler(&wired_central, source, *ev);
+}
+
 static void publish_events_work(struct k_work *work) {
 
-#if IS_HALF_DUPLEX_MODE
+#if IS_POLLED_HALF_DUPLEX_MODE
     k_work_reschedule(&rx_done_work,
                       K_MSEC(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_RX_COMPLETE_TIMEOUT));
-#endif // IS_HALF_DUPLEX_MODE
+#endif // IS_POLLED_HALF_DUPLEX_MODE
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+    // Frames parsed in place are queued once the ring buffer is empty, so they always come after
+    // what is already in it.
+    struct event_payload ev;
+    while (k_msgq_get(&event_msgq, &ev, K_NO_WAIT) == 0) {
+        handle_peripheral_event(ev.source, &ev.event);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
 
     while (ring_buf_size_get(&rx_buf) > MSG_EXTRA_SIZE) {
         struct event_envelope env;
@@ -474,8 +875,7 @@ static void publish_events_work(struct k_work *work) {
             zmk_split_wired_get_item(&rx_buf, (uint8_t *)&env, sizeof(struct event_envelope));
         switch (item_err) {
         case 0:
-            zmk_split_transport_central_peripheral_event_handler(&wired_central, env.payload.source,
-                                                                 env.payload.event);
+            handle_peripheral_event(env.payload.source, &env.payload.event);
             break;
         case -EAGAIN:
             return;
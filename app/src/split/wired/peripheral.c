@@ -10,7 +10,6 @@
 #include <zephyr/pm/device.h>
 #include <zephyr/pm/device_runtime.h>
 #include <zephyr/settings/settings.h>
-#include <zephyr/sys/crc.h>
 #include <zephyr/sys/ring_buffer.h>
 
 #include <zephyr/logging/log.h>
@@ -31,6 +30,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/pointing/input_split.h>
 #include <zmk/hid_indicators_types.h>
 #include <zmk/physical_layouts.h>
+#include <zmk/queue_stats.h>
 
 #include "wired.h"
 
@@ -49,7 +49,17 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 RING_BUF_DECLARE(chosen_rx_buf, RX_BUFFER_SIZE);
 RING_BUF_DECLARE(chosen_tx_buf, TX_BUFFER_SIZE);
 
+ZMK_QUEUE_STATS_DEFINE(chosen_tx_buf, "wired event TX bytes", TX_BUFFER_SIZE);
+
+#define IS_MULTI_DROP_MODE                                                                         \
+    (IS_HALF_DUPLEX_MODE && IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_SCHEDULED) &&            \
+     IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_MULTI_DROP))
+
+#if IS_MULTI_DROP_MODE
+static const uint8_t peripheral_id = CONFIG_ZMK_SPLIT_WIRED_MULTI_DROP_ADDRESS;
+#else
 static const uint8_t peripheral_id = 0;
+#endif
 
 K_SEM_DEFINE(tx_sem, 0, 1);
 
@@ -87,11 +97,23 @@ K_WORK_DEFINE(publish_commands, publish_commands_work);
 static void process_tx_cb(void);
 K_MSGQ_DEFINE(cmd_msg_queue, sizeof(struct zmk_split_transport_central_command), 3, 4);
 
+ZMK_QUEUE_STATS_DEFINE(cmd_msg_queue, "wired commands", 3);
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
 
-uint8_t async_rx_buf[RX_BUFFER_SIZE / 2][2];
+uint8_t __aligned(4) async_rx_buf[2][RX_BUFFER_SIZE / 2];
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
+static void handle_command_frame(const uint8_t *payload, size_t payload_size);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
 
 static struct zmk_split_wired_async_state async_state = {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+    .frame_callback = handle_command_frame,
+    .max_payload_size = sizeof(struct command_payload),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
     .rx_bufs = {async_rx_buf[0], async_rx_buf[1]},
     .rx_bufs_len = RX_BUFFER_SIZE / 2,
     .rx_size_process_trigger = sizeof(struct command_envelope),
@@ -202,11 +224,25 @@ static void detect_pin_irq_callback_handler(const struct device *port, struct gp
 
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+static uint32_t base_baud_rate;
+static uint32_t current_baud_rate;
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
 static int zmk_split_wired_peripheral_init(void) {
     if (!device_is_ready(uart)) {
         return -ENODEV;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+    if (zmk_split_wired_get_baud_rate(uart, &base_baud_rate) < 0) {
+        LOG_WRN("Failed to read the wired split baud rate, not adapting it");
+    }
+    current_baud_rate = base_baud_rate;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
 #if IS_ENABLED(CONFIG_PM_DEVICE_RUNTIME)
     pm_device_runtime_put(uart);
 #elif IS_ENABLED(CONFIG_PM_DEVICE)
@@ -285,6 +321,14 @@ static ssize_t get_payload_data_size(const struct zmk_split_transport_peripheral
         return sizeof(evt->data.sensor_event);
     case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_BATTERY_EVENT:
         return sizeof(evt->data.battery_event);
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_ACK:
+        return sizeof(evt->data.link_ack);
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SLOT_END:
+        return 0;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
+    case ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_PONG:
+        return sizeof(evt->data.link_pong);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_LINK_BENCHMARK)
     default:
         return -ENOTSUP;
     }
@@ -302,36 +346,21 @@ split_peripheral_wired_report_event(const struct zmk_split_transport_peripheral_
     size_t payload_size =
         data_size + sizeof(peripheral_id) + sizeof(enum zmk_split_transport_peripheral_event_type);
 
-    if (ring_buf_space_get(&chosen_tx_buf) < MSG_EXTRA_SIZE + payload_size) {
+    struct event_payload payload = {
+        .source = peripheral_id,
+        .event = *event,
+    };
+
+    LOG_HEXDUMP_DBG(&payload, payload_size, "Payload");
+
+    if (zmk_split_wired_put_msg(&chosen_tx_buf, &payload, payload_size) < 0) {
+        ZMK_QUEUE_STATS_OVERFLOW(chosen_tx_buf);
         LOG_WRN("No room to send peripheral to the central (have %d but only space for %d)",
                 MSG_EXTRA_SIZE + payload_size, ring_buf_space_get(&chosen_tx_buf));
         return -ENOSPC;
     }
 
-    struct event_envelope env = {.prefix =
-                                     {
-                                         .magic_prefix = ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
-                                         .payload_size = payload_size,
-                                     },
-                                 .payload = {
-                                     .source = peripheral_id,
-                                     .event = *event,
-                                 }};
-
-    struct msg_postfix postfix = {.crc =
-                                      crc32_ieee((void *)&env, sizeof(env.prefix) + payload_size)};
-
-    LOG_HEXDUMP_DBG(&env, sizeof(env.prefix) + payload_size, "Payload");
-
-    size_t put = ring_buf_put(&chosen_tx_buf, (uint8_t *)&env, sizeof(env.prefix) + payload_size);
-    if (put != sizeof(env.prefix) + payload_size) {
-        LOG_WRN("Failed to put the whole message (%d vs %d)", put,
-                sizeof(env.prefix) + payload_size);
-    }
-    put = ring_buf_put(&chosen_tx_buf, (uint8_t *)&postfix, sizeof(postfix));
-    if (put != sizeof(postfix)) {
-        LOG_WRN("Failed to put the whole message (%d vs %d)", put, sizeof(postfix));
-    }
+    ZMK_QUEUE_STATS_PUT(chosen_tx_buf, ring_buf_size_get(&chosen_tx_buf));
 
 #if !IS_HALF_DUPLEX_MODE
     begin_tx();
@@ -342,6 +371,12 @@ split_peripheral_wired_report_event(const struct zmk_split_transport_peripheral_
 
 static bool is_enabled;
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+static void fall_back_to_base_baud_rate(void);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
 static int split_peripheral_wired_set_enabled(bool enabled) {
     if (is_enabled == enabled) {
         return 0;
@@ -350,6 +385,10 @@ static int split_peripheral_wired_set_enabled(bool enabled) {
     is_enabled = enabled;
 
     if (enabled) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+        // A new connection always starts out at the base rate.
+        fall_back_to_base_baud_rate();
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
         begin_rx();
         return 0;
 #if HAS_DETECT_GPIO
@@ -372,33 +411,36 @@ split_peripheral_wired_set_status_callback(zmk_split_transport_peripheral_status
     return 0;
 }
 
+#endif // HAS_DETECT_GPIO
+
 static struct zmk_split_transport_status split_peripheral_wired_get_status() {
-    int detected = gpio_pin_get_dt(&detect_gpio);
-    if (detected > 0) {
-        return (struct zmk_split_transport_status){
-            .available = true,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
-
-        };
-    } else {
-        return (struct zmk_split_transport_status){
-            .available = false,
-            .enabled = true, // Track this
-            .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED,
+    struct zmk_split_transport_status status = {
+        .available = true,
+        .enabled = true, // Track this
+        .connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_ALL_CONNECTED,
+    };
 
-        };
+#if HAS_DETECT_GPIO
+    if (gpio_pin_get_dt(&detect_gpio) <= 0) {
+        status.available = false;
+        status.connections = ZMK_SPLIT_TRANSPORT_CONNECTIONS_STATUS_DISCONNECTED;
     }
-}
-
 #endif // HAS_DETECT_GPIO
 
+    zmk_split_wired_get_link_stats(&status.link_stats);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+    status.link_stats.baud_rate = current_baud_rate;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+    return status;
+}
+
 static const struct zmk_split_transport_peripheral_api peripheral_api = {
     .report_event = split_peripheral_wired_report_event,
     .set_enabled = split_peripheral_wired_set_enabled,
+    .get_status = split_peripheral_wired_get_status,
 #if HAS_DETECT_GPIO
     .set_status_callback = split_peripheral_wired_set_status_callback,
-    .get_status = split_peripheral_wired_get_status,
 #endif // HAS_DETECT_GPIO
 };
 
@@ -416,6 +458,168 @@ static void notify_transport_status(void) {
 
 #endif // HAS_DETECT_GPIO
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+// The central drives baud rate changes. A new rate is acknowledged at the old rate, and switched to
+// once the acknowledgement has gone out. It's only kept if the central confirms it at the new rate
+// before the probation period ends. Bad frames while away from the base rate also fall back to the
+// base rate, which is where the central goes when it loses the link.
+
+#define BAUD_PROBATION_MS (2 * CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD_TIMEOUT_MS)
+#define BAUD_FALLBACK_ERRORS 3
+
+static uint32_t previous_baud_rate;
+static uint32_t pending_baud_rate;
+
+static void apply_baud_rate(uint32_t baud_rate) {
+    if (!baud_rate || baud_rate == current_baud_rate) {
+        return;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
+    int ret = zmk_split_wired_async_set_baud_rate(&async_state, baud_rate);
+#else
+    int ret = zmk_split_wired_set_baud_rate(uart, baud_rate);
+#endif
+    if (ret >= 0) {
+        current_baud_rate = baud_rate;
+    }
+}
+
+static void send_link_ack(uint32_t baud_rate) {
+    struct zmk_split_transport_peripheral_event ev = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_LINK_ACK,
+        .data = {.link_ack = {.baud_rate = baud_rate}},
+    };
+
+    split_peripheral_wired_report_event(&ev);
+}
+
+static void baud_probation_work_cb(struct k_work *work) {
+    if (previous_baud_rate) {
+        LOG_WRN("Baud rate %d not confirmed, going back to %d", current_baud_rate,
+                previous_baud_rate);
+        apply_baud_rate(previous_baud_rate);
+        previous_baud_rate = 0;
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(baud_probation_work, baud_probation_work_cb);
+
+static void switch_baud_rate_work_cb(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(switch_baud_rate_work, switch_baud_rate_work_cb);
+
+static void switch_baud_rate_work_cb(struct k_work *work) {
+    static bool drained;
+
+    // Wait for the acknowledgement to be sent, then for its last bytes to leave the UART.
+    if (!ring_buf_is_empty(&chosen_tx_buf)) {
+        drained = false;
+        k_work_reschedule(&switch_baud_rate_work, K_MSEC(1));
+        return;
+    }
+
+    if (!drained) {
+        drained = true;
+        k_work_reschedule(&switch_baud_rate_work, K_MSEC(2));
+        return;
+    }
+
+    drained = false;
+    previous_baud_rate = current_baud_rate;
+    apply_baud_rate(pending_baud_rate);
+    k_work_reschedule(&baud_probation_work, K_MSEC(BAUD_PROBATION_MS));
+}
+
+static void handle_set_baud_rate(uint32_t baud_rate) {
+    if (baud_rate == current_baud_rate) {
+        // Either the confirmation of a change or a link check.
+        k_work_cancel_delayable(&baud_probation_work);
+        previous_baud_rate = 0;
+        send_link_ack(baud_rate);
+        return;
+    }
+
+    pending_baud_rate = baud_rate;
+    send_link_ack(baud_rate);
+    k_work_reschedule(&switch_baud_rate_work, K_MSEC(1));
+}
+
+static void fall_back_to_base_baud_rate(void) {
+    k_work_cancel_delayable(&switch_baud_rate_work);
+    k_work_cancel_delayable(&baud_probation_work);
+    previous_baud_rate = 0;
+    apply_baud_rate(base_baud_rate);
+}
+
+static void baud_fallback_work_cb(struct k_work *work) {
+    if (current_baud_rate != base_baud_rate) {
+        LOG_WRN("Link errors at %d baud, falling back to %d", current_baud_rate, base_baud_rate);
+        fall_back_to_base_baud_rate();
+    }
+}
+
+static K_WORK_DEFINE(baud_fallback_work, baud_fallback_work_cb);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+#if IS_HALF_DUPLEX_MODE && IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_SCHEDULED)
+
+// A poll is the central granting us a slot. Everything queued since the last one goes out in one
+// burst, closed by a marker so the central can take the line back without waiting for a timeout.
+static void slot_grant_work_cb(struct k_work *work) {
+    struct zmk_split_transport_peripheral_event ev = {
+        .type = ZMK_SPLIT_TRANSPORT_PERIPHERAL_EVENT_TYPE_SLOT_END,
+    };
+
+    split_peripheral_wired_report_event(&ev);
+    begin_tx();
+}
+
+static K_WORK_DEFINE(slot_grant_work, slot_grant_work_cb);
+
+#endif
+
+static int handle_command(uint8_t address, const struct zmk_split_transport_central_command *cmd) {
+#if IS_MULTI_DROP_MODE
+    // Everything the central sends is heard by every peripheral on the line.
+    if (address != peripheral_id) {
+        return 0;
+    }
+#endif // IS_MULTI_DROP_MODE
+
+    if (cmd->type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS) {
+#if IS_HALF_DUPLEX_MODE && IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_HALF_DUPLEX_SCHEDULED)
+        // Queued from a work item so the marker can't interleave with an event being queued.
+        k_work_submit(&slot_grant_work);
+#else
+        begin_tx();
+#endif
+        return 0;
+    }
+
+    int ret = ZMK_QUEUE_STATS_MSGQ_PUT(cmd_msg_queue, &cmd_msg_queue, cmd, K_NO_WAIT);
+    if (ret < 0) {
+        LOG_WRN("Failed to queue command for processing (%d)", ret);
+        return ret;
+    }
+
+    k_work_submit(&publish_commands);
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
+static void handle_command_frame(const uint8_t *payload, size_t payload_size) {
+    struct command_payload cmd_payload = {0};
+
+    memcpy(&cmd_payload, payload, MIN(payload_size, sizeof(cmd_payload)));
+    handle_command(cmd_payload.source, &cmd_payload.cmd);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
 static void process_tx_cb(void) {
     while (ring_buf_size_get(&chosen_rx_buf) > MSG_EXTRA_SIZE) {
         struct command_envelope env;
@@ -423,30 +627,35 @@ static void process_tx_cb(void) {
                                                 sizeof(struct command_envelope));
         switch (item_err) {
         case 0:
-            if (env.payload.cmd.type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_POLL_EVENTS) {
-                begin_tx();
-            } else {
-                int ret = k_msgq_put(&cmd_msg_queue, &env.payload.cmd, K_NO_WAIT);
-                if (ret < 0) {
-                    LOG_WRN("Failed to queue command for processing (%d)", ret);
-                    return;
-                }
-
-                k_work_submit(&publish_commands);
+            if (handle_command(env.payload.source, &env.payload.cmd) < 0) {
+                return;
             }
             break;
         case -EAGAIN:
             return;
         default:
             LOG_WRN("Issue fetching an item from the RX buffer: %d", item_err);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+            if (zmk_split_wired_get_consecutive_errors() >= BAUD_FALLBACK_ERRORS) {
+                k_work_submit(&baud_fallback_work);
+            }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
             return;
         }
     }
 }
+
 static void publish_commands_work(struct k_work *work) {
     struct zmk_split_transport_central_command cmd;
 
     while (k_msgq_get(&cmd_msg_queue, &cmd, K_NO_WAIT) >= 0) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+        if (cmd.type == ZMK_SPLIT_TRANSPORT_CENTRAL_CMD_TYPE_SET_BAUD_RATE) {
+            handle_set_baud_rate(cmd.data.set_baud_rate.baud_rate);
+            continue;
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
         zmk_split_transport_peripheral_command_handler(&wired_peripheral, cmd);
     }
 }
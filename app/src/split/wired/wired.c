@@ -13,6 +13,129 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+// Each half has a single wired link, so its counters can live here. They're updated from the UART
+// callbacks as well as from threads.
+static atomic_t rx_frames;
+static atomic_t rx_crc_errors;
+static atomic_t rx_resyncs;
+static atomic_t rx_consecutive_errors;
+
+static void count_good_frame(void) {
+    atomic_inc(&rx_frames);
+    atomic_clear(&rx_consecutive_errors);
+}
+
+static void count_bad_frame(atomic_t *counter) {
+    atomic_inc(counter);
+    atomic_inc(&rx_consecutive_errors);
+}
+
+void zmk_split_wired_get_link_stats(struct zmk_split_transport_link_stats *stats) {
+    stats->frames = (uint32_t)atomic_get(&rx_frames);
+    stats->crc_errors = (uint32_t)atomic_get(&rx_crc_errors);
+    stats->resyncs = (uint32_t)atomic_get(&rx_resyncs);
+}
+
+uint32_t zmk_split_wired_get_consecutive_errors(void) {
+    return (uint32_t)atomic_get(&rx_consecutive_errors);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+static const uint32_t standard_baud_rates[] = {
+    9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600, 1000000,
+};
+
+uint32_t zmk_split_wired_next_baud_rate(uint32_t baud_rate, bool up) {
+    if (up) {
+        for (size_t i = 0; i < ARRAY_SIZE(standard_baud_rates); i++) {
+            if (standard_baud_rates[i] > baud_rate) {
+                return standard_baud_rates[i];
+            }
+        }
+    } else {
+        for (size_t i = ARRAY_SIZE(standard_baud_rates); i > 0; i--) {
+            if (standard_baud_rates[i - 1] < baud_rate) {
+                return standard_baud_rates[i - 1];
+            }
+        }
+    }
+
+    return 0;
+}
+
+int zmk_split_wired_get_baud_rate(const struct device *uart, uint32_t *baud_rate) {
+    struct uart_config cfg;
+
+    int ret = uart_config_get(uart, &cfg);
+    if (ret < 0) {
+        return ret;
+    }
+
+    *baud_rate = cfg.baudrate;
+    return 0;
+}
+
+int zmk_split_wired_set_baud_rate(const struct device *uart, uint32_t baud_rate) {
+    struct uart_config cfg;
+
+    int ret = uart_config_get(uart, &cfg);
+    if (ret < 0) {
+        return ret;
+    }
+
+    cfg.baudrate = baud_rate;
+    ret = uart_configure(uart, &cfg);
+    if (ret < 0) {
+        LOG_WRN("Failed to set the wired split baud rate to %d (%d)", baud_rate, ret);
+        return ret;
+    }
+
+    LOG_DBG("Wired split baud rate set to %d", baud_rate);
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+int zmk_split_wired_put_msg(struct ring_buf *tx_buf, const void *payload, uint8_t payload_size) {
+    const struct msg_prefix prefix = {
+        .magic_prefix = ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
+        .payload_size = payload_size,
+    };
+    const size_t msg_size = MSG_EXTRA_SIZE + payload_size;
+
+    if (ring_buf_space_get(tx_buf) < msg_size) {
+        return -ENOSPC;
+    }
+
+    uint8_t *buf;
+    uint32_t claim_len = ring_buf_put_claim(tx_buf, &buf, msg_size);
+
+    if (claim_len == msg_size) {
+        memcpy(buf, &prefix, sizeof(prefix));
+        memcpy(buf + sizeof(prefix), payload, payload_size);
+
+        struct msg_postfix postfix = {.crc = crc32_ieee(buf, sizeof(prefix) + payload_size)};
+        memcpy(buf + sizeof(prefix) + payload_size, &postfix, sizeof(postfix));
+
+        return ring_buf_put_finish(tx_buf, msg_size);
+    }
+
+    // The free space wraps around the end of the ring buffer, so put the parts one at a time.
+    ring_buf_put_finish(tx_buf, 0);
+
+    struct msg_postfix postfix = {
+        .crc = crc32_ieee_update(crc32_ieee((const uint8_t *)&prefix, sizeof(prefix)), payload,
+                                 payload_size),
+    };
+
+    ring_buf_put(tx_buf, (const uint8_t *)&prefix, sizeof(prefix));
+    ring_buf_put(tx_buf, payload, payload_size);
+    ring_buf_put(tx_buf, (const uint8_t *)&postfix, sizeof(postfix));
+
+    return 0;
+}
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
 
 void zmk_split_wired_poll_out(struct ring_buf *tx_buf, const struct device *uart) {
@@ -166,11 +289,87 @@ int zmk_split_wired_async_rx_cancel(struct zmk_split_wired_async_state *state) {
     return uart_rx_disable(state->uart);
 }
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
+// Parse the frames in a chunk of received data without copying it out of the DMA buffer. Stops at
+// a frame that continues past the end of the chunk, and returns the number of bytes consumed.
+static size_t parse_frames_in_place(struct zmk_split_wired_async_state *state,
+                                    const uint8_t *data, size_t len) {
+    size_t pos = 0;
+    bool resyncing = false;
+
+    while (len - pos >= MSG_EXTRA_SIZE) {
+        const struct msg_prefix *prefix = (const struct msg_prefix *)&data[pos];
+
+        if (memcmp(prefix->magic_prefix, ZMK_SPLIT_WIRED_ENVELOPE_MAGIC_PREFIX,
+                   sizeof(prefix->magic_prefix)) != 0 ||
+            prefix->payload_size > state->max_payload_size) {
+            LOG_WRN("Prefix mismatch, discarding byte %0x", data[pos]);
+            if (!resyncing) {
+                count_bad_frame(&rx_resyncs);
+                resyncing = true;
+            }
+            pos++;
+            continue;
+        }
+
+        size_t crc_len = sizeof(struct msg_prefix) + prefix->payload_size;
+        if (len - pos < crc_len + sizeof(struct msg_postfix)) {
+            break;
+        }
+
+        resyncing = false;
+
+        struct msg_postfix postfix;
+        memcpy(&postfix, &data[pos + crc_len], sizeof(postfix));
+
+        uint32_t crc = crc32_ieee(&data[pos], crc_len);
+        if (crc != postfix.crc) {
+            LOG_WRN("Data corruption in received frame, ignoring %d vs %d", crc, postfix.crc);
+            count_bad_frame(&rx_crc_errors);
+        } else {
+            count_good_frame();
+            state->frame_callback(&data[pos + sizeof(struct msg_prefix)], prefix->payload_size);
+        }
+
+        pos += crc_len + sizeof(struct msg_postfix);
+    }
+
+    return pos;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+int zmk_split_wired_async_set_baud_rate(struct zmk_split_wired_async_state *state,
+                                        uint32_t baud_rate) {
+    state->pending_baud_rate = baud_rate;
+
+    int ret = uart_rx_disable(state->uart);
+    if (ret == -EFAULT) {
+        // RX isn't running, so there's nothing to restart.
+        state->pending_baud_rate = 0;
+        return zmk_split_wired_set_baud_rate(state->uart, baud_rate);
+    }
+
+    return ret;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
 static void restart_rx_work_cb(struct k_work *work) {
     struct k_work_delayable *dwork = k_work_delayable_from_work(work);
     struct zmk_split_wired_async_state *state =
         CONTAINER_OF(dwork, struct zmk_split_wired_async_state, restart_rx_work);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+    if (state->pending_baud_rate) {
+        zmk_split_wired_set_baud_rate(state->uart, state->pending_baud_rate);
+        state->pending_baud_rate = 0;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
     zmk_split_wired_async_rx(state);
 }
 
@@ -195,9 +394,26 @@ static void async_uart_cb(const struct device *dev, struct uart_event *ev, void
         }
         break;
     case UART_RX_RDY: {
-        size_t received =
-            ring_buf_put(state->rx_buf, &ev->data.rx.buf[ev->data.rx.offset], ev->data.rx.len);
-        if (received < ev->data.rx.len) {
+        const uint8_t *data = &ev->data.rx.buf[ev->data.rx.offset];
+        size_t len = ev->data.rx.len;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+        // Whole frames are handled straight from the DMA buffer. Anything left over is the start
+        // of a frame split across two reports, which is assembled in the ring buffer as before.
+        // Once the ring buffer has data, the following reports go there too to keep them in order.
+        if (state->frame_callback && ring_buf_is_empty(state->rx_buf)) {
+            size_t consumed = parse_frames_in_place(state, data, len);
+            data += consumed;
+            len -= consumed;
+
+            if (len == 0) {
+                break;
+            }
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
+        size_t received = ring_buf_put(state->rx_buf, data, len);
+        if (received < len) {
             LOG_ERR("RX overrun!");
             break;
         }
@@ -271,6 +487,8 @@ int zmk_split_wired_async_init(struct zmk_split_wired_async_state *state) {
 #endif
 
 int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_size) {
+    bool resyncing = false;
+
     while (ring_buf_size_get(rx_buf) > sizeof(struct msg_prefix) + sizeof(struct msg_postfix)) {
         struct msg_prefix prefix;
 
@@ -286,6 +504,11 @@ int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_s
 
             LOG_WRN("Prefix mismatch, discarding byte %0x", discarded_byte);
 
+            if (!resyncing) {
+                count_bad_frame(&rx_resyncs);
+                resyncing = true;
+            }
+
             continue;
         }
 
@@ -317,9 +540,11 @@ int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_s
         if (crc != postfix.crc) {
             LOG_WRN("Data corruption in received peripheral event, ignoring %d vs %d", crc,
                     postfix.crc);
+            count_bad_frame(&rx_crc_errors);
             return -EINVAL;
         }
 
+        count_good_frame();
         return 0;
     }
 
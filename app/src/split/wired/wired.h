@@ -46,6 +46,43 @@ struct msg_postfix {
 
 typedef void (*zmk_split_wired_process_tx_callback_t)(void);
 
+/**
+ * @brief Frame a payload and put it in the TX ring buffer.
+ *
+ * The prefix, payload and CRC are written straight into the ring buffer memory when there is
+ * enough contiguous space, which is also what the async mode hands to the UART for DMA.
+ *
+ * @retval 0 on success.
+ * @retval -ENOSPC if the ring buffer doesn't have room for the whole message.
+ */
+int zmk_split_wired_put_msg(struct ring_buf *tx_buf, const void *payload, uint8_t payload_size);
+
+/**
+ * @brief Get the counters for the frames received on the link.
+ *
+ * Only the frames, crc_errors and resyncs fields are filled in.
+ */
+void zmk_split_wired_get_link_stats(struct zmk_split_transport_link_stats *stats);
+
+/**
+ * @brief Get the number of bad frames and resyncs since the last good frame.
+ */
+uint32_t zmk_split_wired_get_consecutive_errors(void);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+int zmk_split_wired_get_baud_rate(const struct device *uart, uint32_t *baud_rate);
+int zmk_split_wired_set_baud_rate(const struct device *uart, uint32_t baud_rate);
+
+/**
+ * @brief Get the next standard baud rate above or below the given one.
+ *
+ * @retval 0 if there is no standard rate in that direction.
+ */
+uint32_t zmk_split_wired_next_baud_rate(uint32_t baud_rate, bool up);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_POLLING)
 
 void zmk_split_wired_poll_out(struct ring_buf *tx_buf, const struct device *uart);
@@ -67,6 +104,10 @@ void zmk_split_wired_fifo_fill(const struct device *dev, struct ring_buf *tx_buf
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
 
+// Called from the UART callback with the payload of a frame that has passed its CRC check. The
+// payload points into the DMA buffer, so it must be copied out before returning.
+typedef void (*zmk_split_wired_frame_callback_t)(const uint8_t *payload, size_t payload_size);
+
 struct zmk_split_wired_async_state {
     atomic_t state;
 
@@ -79,6 +120,16 @@ struct zmk_split_wired_async_state {
 
     zmk_split_wired_process_tx_callback_t process_tx_callback;
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+    zmk_split_wired_frame_callback_t frame_callback;
+    size_t max_payload_size;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ASYNC_ZERO_COPY_RX)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+    // Applied while RX is restarted, since the UART can't be reconfigured with RX running.
+    uint32_t pending_baud_rate;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
     const struct device *uart;
 
     struct k_work_delayable restart_rx_work;
@@ -91,6 +142,13 @@ void zmk_split_wired_async_tx(struct zmk_split_wired_async_state *state);
 int zmk_split_wired_async_rx(struct zmk_split_wired_async_state *state);
 int zmk_split_wired_async_rx_cancel(struct zmk_split_wired_async_state *state);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
+int zmk_split_wired_async_set_baud_rate(struct zmk_split_wired_async_state *state,
+                                        uint32_t baud_rate);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_ADAPTIVE_BAUD)
+
 #endif
 
 int zmk_split_wired_get_item(struct ring_buf *rx_buf, uint8_t *env, size_t env_size);
\ No newline at end of file
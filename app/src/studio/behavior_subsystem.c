@@ -187,7 +187,7 @@ zmk_studio_Response get_behavior_details(const zmk_studio_Request *req) {
     __ASSERT(zbm != NULL, "Can't find a device without also having metadata");
 
     struct behavior_parameter_metadata desc = {0};
-    int ret = behavior_get_parameter_metadata(device, &desc);
+    int ret = zmk_behavior_get_parameter_metadata(device, &desc);
     if (ret < 0) {
         LOG_DBG("Failed to fetch the metadata for %s! %d", zbm->metadata.display_name, ret);
     } else {
@@ -209,5 +209,7 @@ zmk_studio_Response get_behavior_details(const zmk_studio_Request *req) {
     return BEHAVIOR_RESPONSE(get_behavior_details, resp);
 }
 
-ZMK_RPC_SUBSYSTEM_HANDLER(behaviors, list_all_behaviors, ZMK_STUDIO_RPC_HANDLER_UNSECURED);
-ZMK_RPC_SUBSYSTEM_HANDLER(behaviors, get_behavior_details, ZMK_STUDIO_RPC_HANDLER_SECURED);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(behaviors, list_all_behaviors, ZMK_STUDIO_RPC_HANDLER_UNSECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_READ);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(behaviors, get_behavior_details, ZMK_STUDIO_RPC_HANDLER_SECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_READ);
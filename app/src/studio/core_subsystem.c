@@ -76,9 +76,12 @@ zmk_studio_Response reset_settings(const zmk_studio_Request *req) {
     return CORE_RESPONSE(reset_settings, true);
 }
 
-ZMK_RPC_SUBSYSTEM_HANDLER(core, get_device_info, ZMK_STUDIO_RPC_HANDLER_UNSECURED);
-ZMK_RPC_SUBSYSTEM_HANDLER(core, get_lock_state, ZMK_STUDIO_RPC_HANDLER_UNSECURED);
-ZMK_RPC_SUBSYSTEM_HANDLER(core, reset_settings, ZMK_STUDIO_RPC_HANDLER_SECURED);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(core, get_device_info, ZMK_STUDIO_RPC_HANDLER_UNSECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_READ);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(core, get_lock_state, ZMK_STUDIO_RPC_HANDLER_UNSECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_READ);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(core, reset_settings, ZMK_STUDIO_RPC_HANDLER_SECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_DEFERRED);
 
 static int core_event_mapper(const zmk_event_t *eh, zmk_studio_Notification *n) {
     struct zmk_studio_core_lock_state_changed *lock_ev = as_zmk_studio_core_lock_state_changed(eh);
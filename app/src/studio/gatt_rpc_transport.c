@@ -30,7 +30,7 @@ static atomic_t notify_size;
 static void rpc_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value) {
     ARG_UNUSED(attr);
 
-    bool notif_enabled = (value == BT_GATT_CCC_INDICATE);
+    bool notif_enabled = (value & (BT_GATT_CCC_INDICATE | BT_GATT_CCC_NOTIFY)) != 0;
 
     LOG_INF("RPC Notifications %s", notif_enabled ? "enabled" : "disabled");
 
@@ -78,6 +78,12 @@ static ssize_t write_rpc_req(struct bt_conn *conn, const struct bt_gatt_attr *at
         }
 
         ring_buf_put_finish(rpc_buf, claim_len);
+
+        if (claim_len == 0) {
+            // Let the RPC thread make room rather than spinning ahead of it.
+            zmk_rpc_rx_notify();
+            k_sleep(K_TICKS(1));
+        }
     }
 
     zmk_rpc_rx_notify();
@@ -88,19 +94,20 @@ static ssize_t write_rpc_req(struct bt_conn *conn, const struct bt_gatt_attr *at
 BT_GATT_SERVICE_DEFINE(
     rpc_interface, BT_GATT_PRIMARY_SERVICE(BT_UUID_DECLARE_128(ZMK_STUDIO_BT_SERVICE_UUID)),
     BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_STUDIO_BT_RPC_CHRC_UUID),
-                           BT_GATT_CHRC_WRITE | BT_GATT_CHRC_READ | BT_GATT_CHRC_INDICATE,
+                           BT_GATT_CHRC_WRITE | BT_GATT_CHRC_WRITE_WITHOUT_RESP |
+                               BT_GATT_CHRC_READ | BT_GATT_CHRC_INDICATE | BT_GATT_CHRC_NOTIFY,
                            BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT, read_rpc_resp,
                            write_rpc_req, NULL),
     BT_GATT_CCC(rpc_ccc_cfg_changed, BT_GATT_PERM_READ_ENCRYPT | BT_GATT_PERM_WRITE_ENCRYPT));
 
 static uint16_t get_notify_size_for_conn(struct bt_conn *conn) {
-    uint16_t notify_size = 23; // Default MTU size unless negotiated higher
-    struct bt_conn_info conn_info;
-    if (conn && bt_conn_get_info(conn, &conn_info) >= 0) {
-        notify_size = conn_info.le.data_len->tx_max_len;
+    uint16_t mtu = 23; // Default MTU size unless negotiated higher
+    if (conn) {
+        mtu = bt_gatt_get_mtu(conn);
     }
 
-    return notify_size;
+    // Each notification carries up to the negotiated ATT MTU, less the 3 byte ATT header.
+    return mtu - 3;
 }
 
 static void refresh_notify_size(void) {
@@ -125,55 +132,110 @@ static int gatt_stop_rx(void) {
     return 0;
 }
 
+// Notifications are pipelined, with up to this many handed to the stack at once. Indications
+// have to be confirmed by the client before the next one can be sent.
+static K_SEM_DEFINE(notify_credits, CONFIG_ZMK_STUDIO_TRANSPORT_BLE_TX_IN_FLIGHT,
+                    CONFIG_ZMK_STUDIO_TRANSPORT_BLE_TX_IN_FLIGHT);
+static K_SEM_DEFINE(indicate_credit, 1, 1);
+
+// Set once a whole message has been queued, so a final partial chunk is sent too.
+static atomic_t tx_flush;
+
+static void notify_tx_work_cb(struct k_work *work);
+
+static K_WORK_DEFINE(notify_tx_work, notify_tx_work_cb);
+
+static void notify_sent_cb(struct bt_conn *conn, void *user_data) {
+    k_sem_give(&notify_credits);
+    k_work_submit(&notify_tx_work);
+}
+
+static void indicate_destroy_cb(struct bt_gatt_indicate_params *params) {
+    k_sem_give(&indicate_credit);
+    k_work_submit(&notify_tx_work);
+}
+
 static struct bt_gatt_indicate_params rpc_indicate_params = {
     .attr = &rpc_interface.attrs[1],
+    .destroy = indicate_destroy_cb,
 };
 
-static void notif_rpc_tx_cb(struct k_work *work) {
+static int send_chunk(struct bt_conn *conn, bool notify, const uint8_t *data, uint16_t len) {
+    int err;
+
+    if (notify) {
+        struct bt_gatt_notify_params params = {
+            .attr = &rpc_interface.attrs[1],
+            .data = data,
+            .len = len,
+            .func = notify_sent_cb,
+        };
+
+        err = bt_gatt_notify_cb(conn, &params);
+        if (err < 0) {
+            k_sem_give(&notify_credits);
+        }
+    } else {
+        // The data is copied into the outgoing buffer, only the params have to outlive the call.
+        rpc_indicate_params.data = data;
+        rpc_indicate_params.len = len;
+
+        err = bt_gatt_indicate(conn, &rpc_indicate_params);
+        if (err < 0) {
+            k_sem_give(&indicate_credit);
+        }
+    }
+
+    return err;
+}
+
+static void notify_tx_work_cb(struct k_work *work) {
     struct bt_conn *conn = zmk_ble_active_profile_conn();
     struct ring_buf *tx_buf = zmk_rpc_get_tx_buf();
 
     if (!conn) {
         LOG_WRN("No active connection for queued data, dropping");
         ring_buf_reset(tx_buf);
+        atomic_clear(&tx_flush);
         return;
     }
 
-    uint16_t notify_size = get_notify_size_for_conn(conn);
-    uint8_t notify_bytes[notify_size];
+    const bool notify = bt_gatt_is_subscribed(conn, &rpc_interface.attrs[1], BT_GATT_CCC_NOTIFY);
+    struct k_sem *credits = notify ? &notify_credits : &indicate_credit;
+    const uint16_t chunk_size = get_notify_size_for_conn(conn);
+    uint8_t chunk[chunk_size];
 
-    while (ring_buf_size_get(tx_buf) > 0) {
-        uint16_t added = 0;
-        while (added < notify_size && ring_buf_size_get(tx_buf) > 0) {
-            uint8_t *buf;
-            int len = ring_buf_get_claim(tx_buf, &buf, notify_size - added);
+    atomic_set(&notify_size, chunk_size);
 
-            memcpy(notify_bytes + added, buf, len);
+    for (;;) {
+        const uint32_t queued = ring_buf_size_get(tx_buf);
 
-            added += len;
-            ring_buf_get_finish(tx_buf, len);
+        if (queued == 0) {
+            atomic_clear(&tx_flush);
+            break;
         }
 
-        rpc_indicate_params.data = notify_bytes;
-        rpc_indicate_params.len = added;
+        // Partial chunks wait for more data, unless the message is complete or the buffer is too
+        // full for the writer to add to it.
+        if (queued < chunk_size && !atomic_get(&tx_flush) && ring_buf_space_get(tx_buf) >= 2) {
+            break;
+        }
 
-        int notify_attempts = 5;
-        do {
-            int err = bt_gatt_indicate(conn, &rpc_indicate_params);
-            if (err >= 0) {
-                break;
-            }
+        // Once out of credits, the completion callbacks resubmit this work.
+        if (k_sem_take(credits, K_NO_WAIT) < 0) {
+            break;
+        }
 
+        const uint32_t len = ring_buf_get(tx_buf, chunk, chunk_size);
+        int err = send_chunk(conn, notify, chunk, len);
+        if (err < 0) {
             LOG_WRN("Failed to notify the response %d", err);
-            k_sleep(K_MSEC(200));
-        } while (notify_attempts-- > 0);
+        }
     }
 
     bt_conn_unref(conn);
 }
 
-static K_WORK_DEFINE(notify_tx_work, notif_rpc_tx_cb);
-
 struct gatt_write_state {
     size_t pending_notify;
 };
@@ -185,7 +247,12 @@ static void gatt_tx_notify(struct ring_buf *tx_buf, size_t added, bool msg_done,
 
     atomic_t ns = atomic_get(&notify_size);
 
-    if (msg_done || state->pending_notify > ns) {
+    if (msg_done) {
+        atomic_set(&tx_flush, true);
+    }
+
+    // The writer needs room for an escape and its byte, so a nearly full buffer is sent as well.
+    if (msg_done || state->pending_notify >= ns || ring_buf_space_get(tx_buf) < 2) {
         k_work_submit(&notify_tx_work);
         state->pending_notify = 0;
     }
@@ -194,7 +261,7 @@ static void gatt_tx_notify(struct ring_buf *tx_buf, size_t added, bool msg_done,
 static struct gatt_write_state tx_state = {};
 
 static void *gatt_tx_user_data(void) {
-    memset(&tx_state, sizeof(tx_state), 0);
+    memset(&tx_state, 0, sizeof(tx_state));
 
     return &tx_state;
 }
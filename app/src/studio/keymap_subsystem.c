@@ -66,6 +66,11 @@ static bool encode_layer_name(pb_ostream_t *stream, const pb_field_t *field, voi
     return pb_encode_string(stream, name, strlen(name));
 }
 
+// Nested submessages are encoded once to find their size and again to write them, at every level
+// of nesting, so a full keymap response would otherwise walk every binding dozens of times. Each
+// layer's size is found once per response instead, and the sizing passes only add those up.
+static size_t keymap_layer_sizes[ZMK_KEYMAP_LAYERS_LEN];
+
 static bool encode_keymap_layers(pb_ostream_t *stream, const pb_field_t *field, void *const *arg) {
     for (zmk_keymap_layer_index_t l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
         zmk_keymap_layer_id_t layer_id = zmk_keymap_layer_index_to_id(l);
@@ -74,11 +79,6 @@ static bool encode_keymap_layers(pb_ostream_t *stream, const pb_field_t *field,
             break;
         }
 
-        if (!pb_encode_tag_for_field(stream, field)) {
-            LOG_WRN("Failed to encode tag");
-            return false;
-        }
-
         zmk_keymap_Layer layer = zmk_keymap_Layer_init_zero;
         layer.id = layer_id;
 
@@ -88,7 +88,28 @@ static bool encode_keymap_layers(pb_ostream_t *stream, const pb_field_t *field,
         layer.bindings.funcs.encode = encode_layer_bindings;
         layer.bindings.arg = &layer_id;
 
-        if (!pb_encode_submessage(stream, &zmk_keymap_Layer_msg, &layer)) {
+        if (keymap_layer_sizes[l] == 0 &&
+            !pb_get_encoded_size(&keymap_layer_sizes[l], &zmk_keymap_Layer_msg, &layer)) {
+            LOG_WRN("Failed to size layer submessage");
+            return false;
+        }
+
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !pb_encode_varint(stream, keymap_layer_sizes[l])) {
+            LOG_WRN("Failed to encode tag");
+            return false;
+        }
+
+        // Sizing streams have no callback and only count what would be written.
+        if (!stream->callback) {
+            if (!pb_write(stream, NULL, keymap_layer_sizes[l])) {
+                return false;
+            }
+
+            continue;
+        }
+
+        if (!pb_encode(stream, &zmk_keymap_Layer_msg, &layer)) {
             LOG_WRN("Failed to encode layer submessage");
             return false;
         }
@@ -116,6 +137,7 @@ zmk_studio_Response get_keymap(const zmk_studio_Request *req) {
     LOG_DBG("");
     zmk_keymap_Keymap resp = zmk_keymap_Keymap_init_zero;
 
+    memset(keymap_layer_sizes, 0, sizeof(keymap_layer_sizes));
     resp.layers.funcs.encode = encode_keymap_layers;
 
     populate_keymap_extra_props(&resp);
@@ -123,29 +145,39 @@ zmk_studio_Response get_keymap(const zmk_studio_Request *req) {
     return KEYMAP_RESPONSE(get_keymap, resp);
 }
 
+// Turn a binding from a request into a keymap binding, checking it against the behavior's
+// parameter metadata. Shared by every request that sets bindings, so a request carrying several of
+// them can be checked in full before any is applied with zmk_keymap_set_layer_bindings_at_idx().
+static int binding_from_msg(const zmk_keymap_BehaviorBinding *msg,
+                            struct zmk_behavior_binding *binding) {
+    const char *behavior_name = zmk_behavior_find_behavior_name_from_local_id(msg->behavior_id);
+
+    if (!behavior_name) {
+        return -ENOENT;
+    }
+
+    *binding = (struct zmk_behavior_binding){
+        .behavior_dev = behavior_name,
+        .param1 = msg->param1,
+        .param2 = msg->param2,
+    };
+
+    return zmk_behavior_validate_binding(binding);
+}
+
 zmk_studio_Response set_layer_binding(const zmk_studio_Request *req) {
     LOG_DBG("");
     const zmk_keymap_SetLayerBindingRequest *set_req =
         &req->subsystem.keymap.request_type.set_layer_binding;
 
-    zmk_behavior_local_id_t bid = set_req->binding.behavior_id;
+    struct zmk_behavior_binding binding;
 
-    const char *behavior_name = zmk_behavior_find_behavior_name_from_local_id(bid);
-
-    if (!behavior_name) {
+    int ret = binding_from_msg(&set_req->binding, &binding);
+    if (ret == -ENOENT) {
         return KEYMAP_RESPONSE(
             set_layer_binding,
             zmk_keymap_SetLayerBindingResponse_SET_LAYER_BINDING_RESP_INVALID_BEHAVIOR);
-    }
-
-    struct zmk_behavior_binding binding = (struct zmk_behavior_binding){
-        .behavior_dev = behavior_name,
-        .param1 = set_req->binding.param1,
-        .param2 = set_req->binding.param2,
-    };
-
-    int ret = zmk_behavior_validate_binding(&binding);
-    if (ret < 0) {
+    } else if (ret < 0) {
         return KEYMAP_RESPONSE(
             set_layer_binding,
             zmk_keymap_SetLayerBindingResponse_SET_LAYER_BINDING_RESP_INVALID_PARAMETERS);
@@ -527,9 +559,12 @@ zmk_studio_Response set_layer_props(const zmk_studio_Request *req) {
 ZMK_RPC_SUBSYSTEM_HANDLER(keymap, get_keymap, ZMK_STUDIO_RPC_HANDLER_SECURED);
 ZMK_RPC_SUBSYSTEM_HANDLER(keymap, set_layer_binding, ZMK_STUDIO_RPC_HANDLER_SECURED);
 ZMK_RPC_SUBSYSTEM_HANDLER(keymap, check_unsaved_changes, ZMK_STUDIO_RPC_HANDLER_SECURED);
-ZMK_RPC_SUBSYSTEM_HANDLER(keymap, save_changes, ZMK_STUDIO_RPC_HANDLER_SECURED);
-ZMK_RPC_SUBSYSTEM_HANDLER(keymap, discard_changes, ZMK_STUDIO_RPC_HANDLER_SECURED);
-ZMK_RPC_SUBSYSTEM_HANDLER(keymap, get_physical_layouts, ZMK_STUDIO_RPC_HANDLER_SECURED);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(keymap, save_changes, ZMK_STUDIO_RPC_HANDLER_SECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_DEFERRED);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(keymap, discard_changes, ZMK_STUDIO_RPC_HANDLER_SECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_DEFERRED);
+ZMK_RPC_SUBSYSTEM_HANDLER_DISPATCH(keymap, get_physical_layouts, ZMK_STUDIO_RPC_HANDLER_SECURED,
+                                   ZMK_STUDIO_RPC_HANDLER_READ);
 ZMK_RPC_SUBSYSTEM_HANDLER(keymap, set_active_physical_layout, ZMK_STUDIO_RPC_HANDLER_SECURED);
 ZMK_RPC_SUBSYSTEM_HANDLER(keymap, move_layer, ZMK_STUDIO_RPC_HANDLER_SECURED);
 ZMK_RPC_SUBSYSTEM_HANDLER(keymap, add_layer, ZMK_STUDIO_RPC_HANDLER_SECURED);
@@ -7,8 +7,26 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <string.h>
+
 #include "msg_framing.h"
 
+BUILD_ASSERT(FRAMING_ESC == FRAMING_SOF + 1 && FRAMING_EOF == FRAMING_SOF + 2,
+             "Framing bytes are expected to be consecutive");
+
+static inline bool is_framing_byte(uint8_t c) { return c >= FRAMING_SOF && c <= FRAMING_EOF; }
+
+// A word with every byte set to 0x01, and one with every byte set to 0x80.
+#define WORD_ONES (UINTPTR_MAX / 0xFF)
+#define WORD_HIGHS (WORD_ONES * 0x80)
+
+// Nonzero if any byte of the word equals c, using the usual "has a zero byte" trick on word ^ c.
+static inline uintptr_t word_has_byte(uintptr_t word, uint8_t c) {
+    const uintptr_t x = word ^ (WORD_ONES * c);
+
+    return (x - WORD_ONES) & ~x & WORD_HIGHS;
+}
+
 static bool process_byte_err_state(enum studio_framing_state *rpc_framing_state, uint8_t c) {
     switch (c) {
     case FRAMING_EOF:
@@ -77,4 +95,61 @@ bool studio_framing_process_byte(enum studio_framing_state *rpc_framing_state, u
         LOG_ERR("Unsupported framing state: %d", *rpc_framing_state);
         return false;
     }
-}
\ No newline at end of file
+}
+
+size_t studio_framing_find_special(const uint8_t *data, size_t len) {
+    size_t i = 0;
+
+    for (; i < len && ((uintptr_t)(data + i) % sizeof(uintptr_t)) != 0; i++) {
+        if (is_framing_byte(data[i])) {
+            return i;
+        }
+    }
+
+    // Whole words are checked at once, so runs without framing bytes cost one test per word.
+    for (; i + sizeof(uintptr_t) <= len; i += sizeof(uintptr_t)) {
+        uintptr_t word;
+        memcpy(&word, data + i, sizeof(word));
+
+        if (word_has_byte(word, FRAMING_SOF) | word_has_byte(word, FRAMING_ESC) |
+            word_has_byte(word, FRAMING_EOF)) {
+            break;
+        }
+    }
+
+    for (; i < len; i++) {
+        if (is_framing_byte(data[i])) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+size_t studio_framing_process(enum studio_framing_state *rpc_framing_state, const uint8_t *data,
+                              size_t *len, uint8_t *out) {
+    size_t read = 0;
+    size_t written = 0;
+
+    while (read < *len && *rpc_framing_state != FRAMING_STATE_EOF) {
+        if (*rpc_framing_state == FRAMING_STATE_AWAITING_DATA) {
+            const size_t run = studio_framing_find_special(data + read, *len - read);
+
+            memcpy(out + written, data + read, run);
+            read += run;
+            written += run;
+
+            if (read == *len) {
+                break;
+            }
+        }
+
+        const uint8_t c = data[read++];
+        if (studio_framing_process_byte(rpc_framing_state, c)) {
+            out[written++] = c;
+        }
+    }
+
+    *len = read;
+    return written;
+}
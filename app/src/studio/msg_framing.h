@@ -29,3 +29,19 @@ enum studio_framing_state {
  * has been updated.
  */
 bool studio_framing_process_byte(enum studio_framing_state *frame_state, uint8_t data);
+
+/**
+ * @brief Find the first framing byte (SOF, ESC or EOF) in a buffer.
+ * @retval the index of the first framing byte, or len if there is none.
+ */
+size_t studio_framing_find_special(const uint8_t *data, size_t len);
+
+/**
+ * @brief Process a run of incoming bytes from a frame, copying the real data bytes to out.
+ * Processing stops after an EOF byte, so that anything after it is left for the next message.
+ * @param len the number of bytes available in data. Updated to the number of bytes processed.
+ * @param out buffer for the data bytes, which must have room for at least len bytes.
+ * @retval the number of data bytes written to out.
+ */
+size_t studio_framing_process(enum studio_framing_state *frame_state, const uint8_t *data,
+                              size_t *len, uint8_t *out);
@@ -34,6 +34,38 @@ static struct zmk_rpc_subsystem *find_subsystem_for_choice(uint8_t choice) {
     return NULL;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+
+// Stands in for the response of a request handed to the worker, which sends the real one itself.
+#define DEFERRED_RESPONSE() ((zmk_studio_Response)zmk_studio_Response_init_zero)
+
+static bool response_is_deferred(const zmk_studio_Response *resp) { return resp->which_type == 0; }
+
+// Taken while a deferred request is in progress.
+static K_SEM_DEFINE(rpc_deferred_idle_sem, 1, 1);
+static K_SEM_DEFINE(rpc_deferred_ready_sem, 0, 1);
+
+static const struct zmk_rpc_subsystem_handler *deferred_handler;
+static zmk_studio_Request deferred_req;
+
+static void wait_for_deferred(void) {
+    k_sem_take(&rpc_deferred_idle_sem, K_FOREVER);
+    k_sem_give(&rpc_deferred_idle_sem);
+}
+
+static void defer_request(const struct zmk_rpc_subsystem_handler *handler,
+                          const zmk_studio_Request *req) {
+    // Only one request is deferred at a time, so a second one waits for the first.
+    k_sem_take(&rpc_deferred_idle_sem, K_FOREVER);
+
+    deferred_handler = handler;
+    deferred_req = *req;
+
+    k_sem_give(&rpc_deferred_ready_sem);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+
 zmk_studio_Response zmk_rpc_subsystem_delegate_to_subs(const struct zmk_rpc_subsystem *subsys,
                                                        const zmk_studio_Request *req,
                                                        uint8_t which_req) {
@@ -48,6 +80,21 @@ zmk_studio_Response zmk_rpc_subsystem_delegate_to_subs(const struct zmk_rpc_subs
                 return ZMK_RPC_RESPONSE(meta, simple_error,
                                         zmk_meta_ErrorConditions_UNLOCK_REQUIRED);
             }
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+            switch (sub_handler->dispatch) {
+            case ZMK_STUDIO_RPC_HANDLER_DEFERRED:
+                defer_request(sub_handler, req);
+                return DEFERRED_RESPONSE();
+            case ZMK_STUDIO_RPC_HANDLER_INLINE:
+                // Anything that isn't known to only read state must not race the deferred write.
+                wait_for_deferred();
+                break;
+            default:
+                break;
+            }
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+
             return sub_handler->func(req);
         }
     }
@@ -87,14 +134,14 @@ static bool rpc_read_cb(pb_istream_t *stream, uint8_t *buf, size_t count) {
 
     do {
         uint8_t *buffer;
-        uint32_t len = ring_buf_get_claim(&rpc_rx_buf, &buffer, count);
+        // Framing never turns fewer bytes into more, so this many always fit in what is left.
+        uint32_t len = ring_buf_get_claim(&rpc_rx_buf, &buffer, count - write_offset);
 
         if (len > 0) {
-            for (int i = 0; i < len; i++) {
-                if (studio_framing_process_byte(&rpc_framing_state, buffer[i])) {
-                    buf[write_offset++] = buffer[i];
-                }
-            }
+            size_t processed = len;
+            write_offset +=
+                studio_framing_process(&rpc_framing_state, buffer, &processed, buf + write_offset);
+            len = processed;
         } else {
             k_sem_take(&rpc_rx_sem, K_FOREVER);
         }
@@ -123,50 +170,32 @@ static bool rpc_tx_buffer_write(pb_ostream_t *stream, const uint8_t *buf, size_t
     void *user_data = stream->state;
     size_t written = 0;
 
-    bool escape_byte_already_written = false;
-    do {
-        uint32_t write_idx = 0;
+    while (written < count) {
+        const size_t run = studio_framing_find_special(buf + written, count - written);
+        uint32_t added;
 
-        uint8_t *write_buf;
-        uint32_t claim_len = ring_buf_put_claim(&rpc_tx_buf, &write_buf, count - written);
+        if (run == 0) {
+            const uint8_t escaped[] = {FRAMING_ESC, buf[written]};
 
-        if (claim_len == 0) {
-            continue;
+            // The escape and the byte it escapes always go into the buffer together.
+            added = ring_buf_space_get(&rpc_tx_buf) >= sizeof(escaped)
+                        ? ring_buf_put(&rpc_tx_buf, escaped, sizeof(escaped))
+                        : 0;
+            written += added > 0 ? 1 : 0;
+        } else {
+            // Runs without framing bytes are copied as they are.
+            added = ring_buf_put(&rpc_tx_buf, buf + written, run);
+            written += added;
         }
 
-        int escapes_written = 0;
-        for (int i = 0; i < claim_len && write_idx < claim_len; i++) {
-            uint8_t b = buf[written + i];
-            switch (b) {
-            case FRAMING_EOF:
-            case FRAMING_ESC:
-            case FRAMING_SOF:
-                // Care to be taken. We may need to write the escape byte,
-                // but that's the last available spot for this claim, so we track
-                // if the escape has already been written in the previous iteration
-                // of our loop.
-                if (!escape_byte_already_written) {
-                    escapes_written++;
-                    write_buf[write_idx++] = FRAMING_ESC;
-                    escape_byte_already_written = true;
-                    if (write_idx >= claim_len) {
-                        LOG_WRN("Skipping on, no room to write escape and real byte");
-                        continue;
-                    }
-                }
-            default:
-                write_buf[write_idx++] = b;
-                escape_byte_already_written = false;
-                break;
-            }
+        if (added == 0) {
+            // Let the transport drain the buffer instead of spinning until it has.
+            k_sleep(K_TICKS(1));
+            continue;
         }
 
-        ring_buf_put_finish(&rpc_tx_buf, write_idx);
-
-        written += (write_idx - escapes_written);
-
-        selected_transport->tx_notify(&rpc_tx_buf, write_idx, false, user_data);
-    } while (written < count);
+        selected_transport->tx_notify(&rpc_tx_buf, added, false, user_data);
+    }
 
     return true;
 }
@@ -177,6 +206,8 @@ static pb_ostream_t pb_ostream_for_tx_buf(void *user_data) {
 }
 
 static int send_response(const zmk_studio_Response *resp) {
+    int ret = 0;
+
     k_mutex_lock(&rpc_transport_mutex, K_FOREVER);
 
     if (!selected_transport) {
@@ -199,7 +230,8 @@ static int send_response(const zmk_studio_Response *resp) {
 #if !IS_ENABLED(CONFIG_NANOPB_NO_ERRMSG)
         LOG_ERR("Failed to encode the message %s", stream.errmsg);
 #endif // !IS_ENABLED(CONFIG_NANOPB_NO_ERRMSG)
-        return -EINVAL;
+        ret = -EINVAL;
+        goto exit;
     }
 
     framing_byte = FRAMING_EOF;
@@ -209,7 +241,7 @@ static int send_response(const zmk_studio_Response *resp) {
 
 exit:
     k_mutex_unlock(&rpc_transport_mutex);
-    return 0;
+    return ret;
 }
 
 static void rpc_main(void) {
@@ -226,6 +258,12 @@ static void rpc_main(void) {
         if (status) {
             zmk_studio_Response resp = handle_request(&req);
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+            if (response_is_deferred(&resp)) {
+                continue;
+            }
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+
             int err = send_response(&resp);
 #if IS_ENABLED(CONFIG_THREAD_ANALYZER)
             thread_analyzer_print();
@@ -242,6 +280,30 @@ static void rpc_main(void) {
 K_THREAD_DEFINE(studio_rpc_thread, CONFIG_ZMK_STUDIO_RPC_THREAD_STACK_SIZE, rpc_main, NULL, NULL,
                 NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+
+static void rpc_deferred_main(void) {
+    for (;;) {
+        k_sem_take(&rpc_deferred_ready_sem, K_FOREVER);
+
+        zmk_studio_Response resp = deferred_handler->func(&deferred_req);
+        resp.type.request_response.request_id = deferred_req.request_id;
+
+        // The client matches the response to its request by ID, so it may overtake earlier reads.
+        int err = send_response(&resp);
+        if (err < 0) {
+            LOG_ERR("Failed to send the deferred RPC response %d", err);
+        }
+
+        k_sem_give(&rpc_deferred_idle_sem);
+    }
+}
+
+K_THREAD_DEFINE(studio_rpc_worker_thread, CONFIG_ZMK_STUDIO_RPC_WORKER_STACK_SIZE,
+                rpc_deferred_main, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_RPC_DEFERRED)
+
 static void refresh_selected_transport(void) {
     enum zmk_transport transport = zmk_endpoints_selected().transport;
 
@@ -20,10 +20,106 @@ LOG_MODULE_DECLARE(zmk_studio, CONFIG_ZMK_STUDIO_LOG_LEVEL);
 
 static const struct device *const uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+
+// Data is received by DMA into one buffer while the other is being handed over, and copied into
+// the RPC RX ring buffer a whole receive report at a time. Transmits go straight out of the TX
+// ring buffer, one contiguous claim per DMA transfer.
+static uint8_t rx_bufs[2][CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC_RX_BUF_SIZE];
+static atomic_t rx_bufs_used;
+static atomic_t rx_enabled;
+static atomic_t tx_busy;
+
+static int enable_async_rx(void) {
+    atomic_set(&rx_bufs_used, BIT(0));
+
+    int ret = uart_rx_enable(uart_dev, rx_bufs[0], sizeof(rx_bufs[0]),
+                             CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC_RX_TIMEOUT);
+    if (ret < 0) {
+        LOG_ERR("Failed to enable RX (%d)", ret);
+    }
+
+    return ret;
+}
+
+static void restart_rx_work_cb(struct k_work *work) {
+    if (atomic_get(&rx_enabled)) {
+        enable_async_rx();
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(restart_rx_work, restart_rx_work_cb);
+
+static void start_async_tx(void) {
+    struct ring_buf *tx_buf = zmk_rpc_get_tx_buf();
+
+    // A transfer in progress picks up whatever was added to the buffer once it is done.
+    if (ring_buf_size_get(tx_buf) == 0 || !atomic_cas(&tx_busy, false, true)) {
+        return;
+    }
+
+    uint8_t *buf;
+    uint32_t claim_len = ring_buf_get_claim(tx_buf, &buf, ring_buf_size_get(tx_buf));
+
+    int err = uart_tx(uart_dev, buf, claim_len, SYS_FOREVER_US);
+    if (err < 0) {
+        LOG_WRN("Failed to start TX (%d)", err);
+        ring_buf_get_finish(tx_buf, 0);
+        atomic_clear(&tx_busy);
+    }
+}
+
+static void async_uart_cb(const struct device *dev, struct uart_event *ev, void *user_data) {
+    switch (ev->type) {
+    case UART_TX_DONE:
+    case UART_TX_ABORTED:
+        ring_buf_get_finish(zmk_rpc_get_tx_buf(), ev->data.tx.len);
+        atomic_clear(&tx_busy);
+        start_async_tx();
+        break;
+    case UART_RX_RDY: {
+        size_t received = ring_buf_put(zmk_rpc_get_rx_buf(), &ev->data.rx.buf[ev->data.rx.offset],
+                                       ev->data.rx.len);
+        if (received < ev->data.rx.len) {
+            LOG_ERR("Dropping incoming RPC data, insufficient room in the RX buffer. Bump "
+                    "CONFIG_ZMK_STUDIO_RPC_RX_BUF_SIZE.");
+        }
+
+        zmk_rpc_rx_notify();
+        break;
+    }
+    case UART_RX_BUF_REQUEST:
+        for (int i = 0; i < ARRAY_SIZE(rx_bufs); i++) {
+            if (!atomic_test_and_set_bit(&rx_bufs_used, i)) {
+                uart_rx_buf_rsp(dev, rx_bufs[i], sizeof(rx_bufs[i]));
+                break;
+            }
+        }
+        break;
+    case UART_RX_BUF_RELEASED:
+        for (int i = 0; i < ARRAY_SIZE(rx_bufs); i++) {
+            if (ev->data.rx_buf.buf == rx_bufs[i]) {
+                atomic_clear_bit(&rx_bufs_used, i);
+            }
+        }
+        break;
+    case UART_RX_DISABLED:
+        // Errors such as framing errors stop reception, so restart it unless it was stopped.
+        k_work_schedule(&restart_rx_work, K_MSEC(1));
+        break;
+    default:
+        break;
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+
 static void tx_notify(struct ring_buf *tx_ring_buf, size_t written, bool msg_done,
                       void *user_data) {
     if (msg_done || (ring_buf_size_get(tx_ring_buf) > (ring_buf_capacity_get(tx_ring_buf) / 2))) {
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+        start_async_tx();
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
         uart_irq_tx_enable(uart_dev);
 #else
         struct ring_buf *tx_buf = zmk_rpc_get_tx_buf();
@@ -40,7 +136,7 @@ static void tx_notify(struct ring_buf *tx_ring_buf, size_t written, bool msg_don
     }
 }
 
-#if !IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if !IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC) && !IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
 
 static void uart_rx_main(void) {
     for (;;) {
@@ -70,7 +166,10 @@ K_THREAD_DEFINE(uart_transport_read_thread, CONFIG_ZMK_STUDIO_TRANSPORT_UART_RX_
 #endif
 
 static int start_rx() {
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+    atomic_set(&rx_enabled, true);
+    return enable_async_rx();
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
     uart_irq_rx_enable(uart_dev);
 #else
     k_thread_resume(uart_transport_read_thread);
@@ -79,7 +178,11 @@ static int start_rx() {
 }
 
 static int stop_rx(void) {
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+    atomic_set(&rx_enabled, false);
+    k_work_cancel_delayable(&restart_rx_work);
+    uart_rx_disable(uart_dev);
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
     uart_irq_rx_disable(uart_dev);
 #else
     k_thread_suspend(uart_transport_read_thread);
@@ -89,7 +192,7 @@ static int stop_rx(void) {
 
 ZMK_RPC_TRANSPORT(uart, ZMK_TRANSPORT_USB, start_rx, stop_rx, NULL, tx_notify);
 
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if !IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC) && IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
 
 /*
  * Read characters from UART until line end is detected. Afterwards push the
@@ -148,7 +251,13 @@ static int uart_rpc_interface_init(void) {
         return -ENODEV;
     }
 
-#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#if IS_ENABLED(CONFIG_ZMK_STUDIO_TRANSPORT_UART_ASYNC)
+    int ret = uart_callback_set(uart_dev, async_uart_cb, NULL);
+    if (ret < 0) {
+        LOG_ERR("Failed to set up async callback on UART (%d)", ret);
+        return ret;
+    }
+#elif IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
     /* configure interrupt and callback to receive data */
     int ret = uart_irq_callback_user_data_set(uart_dev, serial_cb, NULL);
 
@@ -162,7 +271,7 @@ static int uart_rpc_interface_init(void) {
         }
         return ret;
     }
-#endif // IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+#endif
 
     return 0;
 }
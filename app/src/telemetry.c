@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_ZMK_TELEMETRY_SHELL)
+#include <zephyr/shell/shell.h>
+#endif // IS_ENABLED(CONFIG_ZMK_TELEMETRY_SHELL)
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/telemetry.h>
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_ZMK_TELEMETRY_RECORDS),
+             "The telemetry record count must be a power of two");
+
+#define RECORD_MASK (CONFIG_ZMK_TELEMETRY_RECORDS - 1)
+
+// Records are only ever added at the head and taken from the tail, and a full buffer overwrites
+// its oldest record, so recording never has to wait for a reader.
+static struct zmk_telemetry_record records[CONFIG_ZMK_TELEMETRY_RECORDS];
+static uint32_t head;
+static uint32_t tail;
+static uint32_t dropped;
+static struct k_spinlock lock;
+
+void zmk_telemetry_record(enum zmk_telemetry_record_type type, uint8_t arg, uint16_t value) {
+    const uint32_t timestamp_us = k_cyc_to_us_floor32(k_cycle_get_32());
+
+    K_SPINLOCK(&lock) {
+        if (head - tail == CONFIG_ZMK_TELEMETRY_RECORDS) {
+            tail++;
+            dropped++;
+        }
+
+        records[head++ & RECORD_MASK] = (struct zmk_telemetry_record){
+            .timestamp_us = timestamp_us,
+            .type = type,
+            .arg = arg,
+            .value = value,
+        };
+    }
+}
+
+size_t zmk_telemetry_read(struct zmk_telemetry_record *out, size_t count) {
+    size_t read = 0;
+
+    K_SPINLOCK(&lock) {
+        while (read < count && tail != head) {
+            out[read++] = records[tail++ & RECORD_MASK];
+        }
+    }
+
+    return read;
+}
+
+uint32_t zmk_telemetry_get_dropped(void) {
+    uint32_t count;
+
+    K_SPINLOCK(&lock) { count = dropped; }
+
+    return count;
+}
+
+void zmk_telemetry_clear(void) {
+    K_SPINLOCK(&lock) {
+        tail = head;
+        dropped = 0;
+    }
+}
+
+static int telemetry_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+
+    if (ev) {
+        zmk_telemetry_record(ev->state ? ZMK_TELEMETRY_POSITION_PRESSED
+                                       : ZMK_TELEMETRY_POSITION_RELEASED,
+                             ev->source, ev->position);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(telemetry, telemetry_listener);
+ZMK_SUBSCRIPTION(telemetry, zmk_position_state_changed);
+
+#if IS_ENABLED(CONFIG_ZMK_TELEMETRY_SHELL)
+
+static const char *record_type_str(uint8_t type) {
+    switch (type) {
+    case ZMK_TELEMETRY_POSITION_PRESSED:
+        return "pressed";
+    case ZMK_TELEMETRY_POSITION_RELEASED:
+        return "released";
+    case ZMK_TELEMETRY_HOLD_TAP_HOLD:
+        return "hold-tap-hold";
+    case ZMK_TELEMETRY_HOLD_TAP_TAP:
+        return "hold-tap-tap";
+    case ZMK_TELEMETRY_HID_REPORT_SENT:
+        return "hid-report";
+    case ZMK_TELEMETRY_SPLIT_EVENT_RECEIVED:
+        return "split-event";
+    case ZMK_TELEMETRY_WORK_HANDLER_RUN:
+        return "work-handler";
+    case ZMK_TELEMETRY_KEYBOARD_REPORT:
+        return "keyboard-report";
+    default:
+        return "unknown";
+    }
+}
+
+static int cmd_telemetry_dump(const struct shell *sh, size_t argc, char **argv) {
+    struct zmk_telemetry_record batch[16];
+    size_t count;
+
+    shell_print(sh, "%u records dropped", zmk_telemetry_get_dropped());
+
+    while ((count = zmk_telemetry_read(batch, ARRAY_SIZE(batch))) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            shell_print(sh, "%10u %-14s %3u %5u", batch[i].timestamp_us,
+                        record_type_str(batch[i].type), batch[i].arg, batch[i].value);
+        }
+    }
+
+    return 0;
+}
+
+// The records as little endian bytes in hex, a few per line, for scripts/trace_replay.py to read
+// back. The format version in the header changes whenever the record layout does.
+static int cmd_telemetry_export(const struct shell *sh, size_t argc, char **argv) {
+    struct zmk_telemetry_record batch[4];
+    size_t count;
+
+    shell_print(sh, "zmk-telemetry 1 dropped %u", zmk_telemetry_get_dropped());
+
+    while ((count = zmk_telemetry_read(batch, ARRAY_SIZE(batch))) > 0) {
+        char line[sizeof(batch) * 2 + 1];
+
+        bin2hex((const uint8_t *)batch, count * sizeof(batch[0]), line, sizeof(line));
+        shell_print(sh, "%s", line);
+    }
+
+    shell_print(sh, "end");
+    return 0;
+}
+
+static int cmd_telemetry_clear(const struct shell *sh, size_t argc, char **argv) {
+    zmk_telemetry_clear();
+    shell_print(sh, "Telemetry records cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_telemetry,
+                               SHELL_CMD(dump, NULL, "Print and remove the buffered records",
+                                         cmd_telemetry_dump),
+                               SHELL_CMD(export, NULL, "Print and remove the records in hex",
+                                         cmd_telemetry_export),
+                               SHELL_CMD(clear, NULL, "Discard the buffered records",
+                                         cmd_telemetry_clear),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(telemetry, &sub_telemetry, "ZMK key event and latency telemetry", NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_TELEMETRY_SHELL)
@@ -23,6 +23,12 @@ static enum usb_dc_status_code usb_status = USB_DC_UNKNOWN;
 static bool is_configured;
 
 static void raise_usb_status_changed_event(struct k_work *_work) {
+#if IS_ENABLED(CONFIG_ZMK_USB)
+    if (usb_status != USB_DC_SUSPEND) {
+        zmk_usb_hid_bus_resumed();
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_USB)
+
     raise_zmk_usb_conn_state_changed(
         (struct zmk_usb_conn_state_changed){.conn_state = zmk_usb_get_conn_state()});
 }
@@ -66,6 +72,11 @@ void usb_status_cb(enum usb_dc_status_code status, const uint8_t *params) {
         zmk_usb_hid_set_protocol(HID_PROTOCOL_REPORT);
     }
 #endif
+#if IS_ENABLED(CONFIG_ZMK_USB)
+    if (status == USB_DC_RESET || status == USB_DC_DISCONNECTED || status == USB_DC_CONFIGURED) {
+        zmk_usb_hid_reset_endpoints();
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_USB)
     usb_status = status;
     if (zmk_usb_get_conn_state() == ZMK_USB_CONN_HID) {
         is_configured |= usb_status == USB_DC_CONFIGURED;
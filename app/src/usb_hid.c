@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include <zephyr/device.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/init.h>
 
 #include <zephyr/usb/usb_device.h>
@@ -13,6 +16,7 @@
 #include <zmk/usb.h>
 #include <zmk/hid.h>
 #include <zmk/keymap.h>
+#include <zmk/latency_probe.h>
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING_SMOOTH_SCROLLING)
 #include <zmk/pointing/resolution_multipliers.h>
@@ -22,15 +26,305 @@
 #include <zmk/hid_indicators.h>
 #endif // IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+#include <zmk/hid_gaming.h>
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+
 #include <zmk/event_manager.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
-static const struct device *hid_dev;
+// With ZMK_USB_HID_SPLIT_INTERFACES, pointing and gaming reports go out through HID interfaces of
+// their own, each with its own IN endpoint and send queue, so a burst of mouse reports never holds
+// back the next keyboard report. Otherwise, every report shares the keyboard interface.
+#define IFACE_KEYBOARD 0
+
+#if IS_ENABLED(CONFIG_ZMK_USB_HID_SPLIT_INTERFACES) && IS_ENABLED(CONFIG_ZMK_POINTING)
+#define IFACE_POINTING (IFACE_KEYBOARD + 1)
+#else
+#define IFACE_POINTING IFACE_KEYBOARD
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_USB_HID_SPLIT_INTERFACES) && IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+#define IFACE_GAMING (IFACE_POINTING + 1)
+#else
+#define IFACE_GAMING IFACE_KEYBOARD
+#endif
+
+#define IFACE_COUNT (MAX(IFACE_POINTING, IFACE_GAMING) + 1)
+
+BUILD_ASSERT(IFACE_COUNT <= CONFIG_USB_HID_DEVICE_COUNT,
+             "CONFIG_USB_HID_DEVICE_COUNT must cover each HID interface");
+
+#if IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
+
+union queued_report_data {
+    struct zmk_hid_keyboard_report keyboard;
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    struct zmk_hid_composite_report composite;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    struct zmk_hid_consumer_report consumer;
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    struct zmk_hid_mouse_report mouse;
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    zmk_hid_boot_report_t boot;
+#endif // IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+    struct zmk_gaming_keyboard_report gaming;
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+};
+
+struct queued_report {
+    uint8_t len;
+    bool is_keyboard;
+    union queued_report_data data;
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
+
+struct hid_iface {
+    const struct device *dev;
+#if IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
+    // Reports waiting for the IN endpoint, oldest first. Sending never blocks: a report is written
+    // right away if the endpoint is idle, and otherwise queued for in_ready_cb to write.
+    struct queued_report report_queue[CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE];
+    uint8_t report_queue_head;
+    uint8_t report_queue_len;
+    bool in_ep_busy;
+    struct k_spinlock report_queue_lock;
+#else
+    struct k_sem sem;
+#endif // IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
+};
+
+static struct hid_iface ifaces[IFACE_COUNT];
+
+static struct hid_iface *iface_for_dev(const struct device *dev) {
+    for (int i = 0; i < IFACE_COUNT; i++) {
+        if (ifaces[i].dev == dev) {
+            return &ifaces[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Report IDs are unique across all interfaces, so the first byte of a report picks its interface.
+static struct hid_iface *iface_for_report(const uint8_t *report) {
+    switch (report[0]) {
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    case ZMK_HID_REPORT_ID_MOUSE:
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    case ZMK_HID_REPORT_ID_ABS_POINTER:
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+        return &ifaces[IFACE_POINTING];
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+    default:
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+        if (report[0] >= ZMK_HID_GAMING_REPORT_ID_MAIN) {
+            return &ifaces[IFACE_GAMING];
+        }
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+        return &ifaces[IFACE_KEYBOARD];
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
+
+static struct queued_report *report_queue_at(struct hid_iface *iface, uint8_t offset) {
+    return &iface->report_queue[(iface->report_queue_head + offset) %
+                                CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE];
+}
+
+// Whether a keyboard report still has every key and modifier pressed in an earlier one.
+static bool keyboard_report_is_superset(const struct zmk_hid_keyboard_report_body *queued,
+                                        const struct zmk_hid_keyboard_report_body *report) {
+    if ((queued->modifiers & ~report->modifiers) != 0) {
+        return false;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_NKRO)
+    for (int i = 0; i < ARRAY_SIZE(queued->keys); i++) {
+        if ((queued->keys[i] & ~report->keys[i]) != 0) {
+            return false;
+        }
+    }
+#elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
+    for (int i = 0; i < ARRAY_SIZE(queued->keys); i++) {
+        bool found = queued->keys[i] == 0;
+
+        for (int j = 0; j < ARRAY_SIZE(report->keys) && !found; j++) {
+            found = report->keys[j] == queued->keys[i];
+        }
+
+        if (!found) {
+            return false;
+        }
+    }
+#endif
+
+    return true;
+}
+
+// Writes the oldest queued report once the endpoint is idle. Each report is taken out of the queue
+// under the lock but written after it's released, since hid_int_ep_write() can take a while. A
+// report that fails to write is dropped, and the next one is tried.
+static void write_next_queued_report(struct hid_iface *iface) {
+    while (true) {
+        struct queued_report next;
+        k_spinlock_key_t key = k_spin_lock(&iface->report_queue_lock);
+
+        if (iface->in_ep_busy || iface->report_queue_len == 0) {
+            k_spin_unlock(&iface->report_queue_lock, key);
+            return;
+        }
+
+        next = *report_queue_at(iface, 0);
+        iface->report_queue_head =
+            (iface->report_queue_head + 1) % CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE;
+        iface->report_queue_len--;
+        iface->in_ep_busy = true;
+        k_spin_unlock(&iface->report_queue_lock, key);
+
+        int err = hid_int_ep_write(iface->dev, (uint8_t *)&next.data, next.len, NULL);
+        if (!err) {
+            return;
+        }
+
+        LOG_WRN("Failed to write queued report (%d)", err);
+        key = k_spin_lock(&iface->report_queue_lock);
+        iface->in_ep_busy = false;
+        k_spin_unlock(&iface->report_queue_lock, key);
+    }
+}
+
+static void in_ready_cb(const struct device *dev) {
+    struct hid_iface *iface = iface_for_dev(dev);
+
+    if (iface == NULL) {
+        return;
+    }
+
+    if (iface == &ifaces[IFACE_KEYBOARD]) {
+        zmk_latency_probe_usb_report_delivered();
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&iface->report_queue_lock);
+    iface->in_ep_busy = false;
+    k_spin_unlock(&iface->report_queue_lock, key);
+
+    write_next_queued_report(iface);
+}
+
+// The last queued report can be replaced by a newer keyboard report only if it's itself just
+// presses on top of the report queued before it, and the newer one keeps all of them. The host then
+// goes straight from the earlier report to the newer one, and sees every press. A report that
+// releases anything is never replaced, so a quick tap of a key held again still reaches the host
+// as a release and a press.
+static bool can_merge_keyboard_report(struct hid_iface *iface, const uint8_t *report, size_t len) {
+    if (iface->report_queue_len < 2) {
+        return false;
+    }
+
+    const struct queued_report *prev = report_queue_at(iface, iface->report_queue_len - 2);
+    const struct queued_report *last = report_queue_at(iface, iface->report_queue_len - 1);
+
+    return prev->is_keyboard && last->is_keyboard && prev->len == len && last->len == len &&
+           keyboard_report_is_superset(&prev->data.keyboard.body, &last->data.keyboard.body) &&
+           keyboard_report_is_superset(&last->data.keyboard.body,
+                                       &((const struct zmk_hid_keyboard_report *)report)->body);
+}
+
+static int write_report(struct hid_iface *iface, const uint8_t *report, size_t len,
+                        bool is_keyboard) {
+    int err = 0;
+    k_spinlock_key_t key = k_spin_lock(&iface->report_queue_lock);
+
+    if (!iface->in_ep_busy && iface->report_queue_len == 0) {
+        iface->in_ep_busy = true;
+        k_spin_unlock(&iface->report_queue_lock, key);
+
+        err = hid_int_ep_write(iface->dev, report, len, NULL);
+        if (err) {
+            key = k_spin_lock(&iface->report_queue_lock);
+            iface->in_ep_busy = false;
+            k_spin_unlock(&iface->report_queue_lock, key);
+
+            // Reports queued while this one was being written are still waiting for the endpoint
+            write_next_queued_report(iface);
+        }
+
+        return err;
+    }
+
+    if (is_keyboard && can_merge_keyboard_report(iface, report, len)) {
+        memcpy(&report_queue_at(iface, iface->report_queue_len - 1)->data, report, len);
+        goto unlock;
+    }
+
+    if (len > sizeof(union queued_report_data)) {
+        err = -EMSGSIZE;
+        goto unlock;
+    }
+
+    if (iface->report_queue_len == CONFIG_ZMK_USB_HID_REPORT_QUEUE_SIZE) {
+        LOG_WRN("USB HID report queue full, dropping report");
+        err = -ENOBUFS;
+        goto unlock;
+    }
+
+    struct queued_report *slot = report_queue_at(iface, iface->report_queue_len++);
+    slot->len = len;
+    slot->is_keyboard = is_keyboard;
+    memcpy(&slot->data, report, len);
+
+unlock:
+    k_spin_unlock(&iface->report_queue_lock, key);
+    return err;
+}
+
+// The host drops any transfer in flight when the bus is reset or the cable is pulled, so the
+// endpoint would never report it done. Anything still queued was meant for the old session.
+static void reset_iface(struct hid_iface *iface) {
+    k_spinlock_key_t key = k_spin_lock(&iface->report_queue_lock);
+    iface->in_ep_busy = false;
+    iface->report_queue_head = 0;
+    iface->report_queue_len = 0;
+    k_spin_unlock(&iface->report_queue_lock, key);
+}
+
+#else
+
+static void reset_iface(struct hid_iface *iface) { k_sem_give(&iface->sem); }
+
+static void in_ready_cb(const struct device *dev) {
+    struct hid_iface *iface = iface_for_dev(dev);
+
+    if (iface == NULL) {
+        return;
+    }
+
+    if (iface == &ifaces[IFACE_KEYBOARD]) {
+        zmk_latency_probe_usb_report_delivered();
+    }
+
+    k_sem_give(&iface->sem);
+}
+
+static int write_report(struct hid_iface *iface, const uint8_t *report, size_t len,
+                        bool is_keyboard) {
+    k_sem_take(&iface->sem, K_MSEC(30));
+    int err = hid_int_ep_write(iface->dev, report, len, NULL);
 
-static K_SEM_DEFINE(hid_sem, 1, 1);
+    if (err) {
+        k_sem_give(&iface->sem);
+    }
+
+    return err;
+}
 
-static void in_ready_cb(const struct device *dev) { k_sem_give(&hid_sem); }
+#endif // IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
 
 #define HID_GET_REPORT_TYPE_MASK 0xff00
 #define HID_GET_REPORT_ID_MASK 0x00ff
@@ -42,7 +336,16 @@ static void in_ready_cb(const struct device *dev) { k_sem_give(&hid_sem); }
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 static uint8_t hid_protocol = HID_PROTOCOL_REPORT;
 
-static void set_proto_cb(const struct device *dev, uint8_t protocol) { hid_protocol = protocol; }
+static void set_proto_cb(const struct device *dev, uint8_t protocol) {
+    hid_protocol = protocol;
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+    // Gaming reports aren't part of the boot protocol, so the host only sees them from now on
+    if (protocol == HID_PROTOCOL_REPORT) {
+        zmk_hid_gaming_announce();
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+}
 
 void zmk_usb_hid_set_protocol(uint8_t protocol) { hid_protocol = protocol; }
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
@@ -55,7 +358,11 @@ static uint8_t *get_keyboard_report(size_t *len) {
         return (uint8_t *)boot_report;
     }
 #endif
+#if IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+    struct zmk_hid_composite_report *report = zmk_hid_get_composite_report();
+#else
     struct zmk_hid_keyboard_report *report = zmk_hid_get_keyboard_report();
+#endif // IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
     *len = sizeof(*report);
     return (uint8_t *)report;
 }
@@ -94,16 +401,31 @@ static int get_report_cb(const struct device *dev, struct usb_setup_packet *setu
             *len = (int32_t)size;
             break;
         }
+#if !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
         case ZMK_HID_REPORT_ID_CONSUMER: {
             struct zmk_hid_consumer_report *report = zmk_hid_get_consumer_report();
             *data = (uint8_t *)report;
             *len = sizeof(*report);
             break;
         }
-        default:
+#endif // !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT)
+        default: {
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+            const uint8_t device_id =
+                (setup->wValue & HID_GET_REPORT_ID_MASK) - ZMK_HID_GAMING_REPORT_ID_MAIN;
+            struct zmk_gaming_keyboard_report *report =
+                zmk_hid_gaming_get_keyboard_report(device_id);
+
+            if (report) {
+                *data = (uint8_t *)report;
+                *len = zmk_hid_gaming_get_keyboard_report_size(device_id);
+                break;
+            }
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
             LOG_ERR("Invalid report ID %d requested", setup->wValue & HID_GET_REPORT_ID_MASK);
             return -EINVAL;
         }
+        }
         break;
     default:
         /*
@@ -184,31 +506,88 @@ static const struct hid_ops ops = {
     .set_report = set_report_cb,
 };
 
-int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
+#if IFACE_COUNT > 1
+// Only the keyboard interface speaks the boot protocol.
+static const struct hid_ops secondary_ops = {
+    .int_in_ready = in_ready_cb,
+    .get_report = get_report_cb,
+    .set_report = set_report_cb,
+};
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+static const uint8_t pointing_report_desc[] = {ZMK_HID_POINTING_REPORT_DESC};
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+
+#if IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+static const uint8_t gaming_report_desc[] = {ZMK_HID_GAMING_REPORT_DESC};
+#endif // IS_ENABLED(CONFIG_ZMK_HID_GAMING)
+#endif // IFACE_COUNT > 1
+
+// Reports can't be delivered while the host has suspended the bus. The first one asks the host to
+// resume and the rest are dropped, noting which state changed, so only the latest state of each is
+// sent once the bus has resumed.
+enum suspended_report {
+    SUSPENDED_REPORT_KEYBOARD,
+    SUSPENDED_REPORT_CONSUMER,
+    SUSPENDED_REPORT_MOUSE,
+    SUSPENDED_REPORT_ABS_POINTER,
+    SUSPENDED_REPORT_NONE,
+};
+
+#define WAKEUP_REQUESTED_BIT SUSPENDED_REPORT_NONE
+
+static atomic_t suspended_reports;
+
+static int send_while_suspended(enum suspended_report type) {
+    if (type != SUSPENDED_REPORT_NONE) {
+        atomic_set_bit(&suspended_reports, type);
+    }
+
+    if (atomic_test_and_set_bit(&suspended_reports, WAKEUP_REQUESTED_BIT)) {
+        return 0;
+    }
+
+    int err = usb_wakeup_request();
+    if (err < 0) {
+        LOG_WRN("Failed to request USB remote wakeup (%d)", err);
+    }
+
+    return 0;
+}
+
+static int send_report(struct hid_iface *iface, const uint8_t *report, size_t len,
+                       bool is_keyboard, enum suspended_report type) {
     switch (zmk_usb_get_status()) {
     case USB_DC_SUSPEND:
-        return usb_wakeup_request();
+        return send_while_suspended(type);
     case USB_DC_ERROR:
     case USB_DC_RESET:
     case USB_DC_DISCONNECTED:
     case USB_DC_UNKNOWN:
         return -ENODEV;
     default:
-        k_sem_take(&hid_sem, K_MSEC(30));
-        int err = hid_int_ep_write(hid_dev, report, len, NULL);
-
-        if (err) {
-            k_sem_give(&hid_sem);
-        }
-
-        return err;
+        return write_report(iface, report, len, is_keyboard);
     }
 }
 
+int zmk_usb_hid_send_report(const uint8_t *report, size_t len) {
+    return send_report(iface_for_report(report), report, len, false, SUSPENDED_REPORT_NONE);
+}
+
 int zmk_usb_hid_send_keyboard_report(void) {
     size_t len;
     uint8_t *report = get_keyboard_report(&len);
-    return zmk_usb_hid_send_report(report, len);
+    // Only plain keyboard reports can be merged, the composite one also carries consumer usages.
+    bool is_keyboard = !IS_ENABLED(CONFIG_ZMK_HID_COMPOSITE_REPORT);
+
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    // Boot reports have a different layout and are never merged.
+    is_keyboard = is_keyboard && hid_protocol == HID_PROTOCOL_REPORT;
+#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
+
+    // Boot reports have no report ID to route them by.
+    return send_report(&ifaces[IFACE_KEYBOARD], report, len, is_keyboard,
+                       SUSPENDED_REPORT_KEYBOARD);
 }
 
 int zmk_usb_hid_send_consumer_report(void) {
@@ -219,36 +598,126 @@ int zmk_usb_hid_send_consumer_report(void) {
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
     struct zmk_hid_consumer_report *report = zmk_hid_get_consumer_report();
-    return zmk_usb_hid_send_report((uint8_t *)report, sizeof(*report));
+    return send_report(iface_for_report((uint8_t *)report), (uint8_t *)report, sizeof(*report),
+                       false, SUSPENDED_REPORT_CONSUMER);
 }
 
 #if IS_ENABLED(CONFIG_ZMK_POINTING)
 int zmk_usb_hid_send_mouse_report() {
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    if (hid_protocol == HID_PROTOCOL_BOOT) {
+    // A pointing interface of its own isn't switched to the boot protocol with the keyboard.
+    if (IFACE_POINTING == IFACE_KEYBOARD && hid_protocol == HID_PROTOCOL_BOOT) {
         return -ENOTSUP;
     }
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
     struct zmk_hid_mouse_report *report = zmk_hid_get_mouse_report();
-    return zmk_usb_hid_send_report((uint8_t *)report, sizeof(*report));
+    return send_report(&ifaces[IFACE_POINTING], (uint8_t *)report, sizeof(*report), false,
+                       SUSPENDED_REPORT_MOUSE);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+int zmk_usb_hid_send_abs_pointer_report(void) {
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    if (IFACE_POINTING == IFACE_KEYBOARD && hid_protocol == HID_PROTOCOL_BOOT) {
+        return -ENOTSUP;
+    }
+#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
+
+    struct zmk_hid_abs_pointer_report *report = zmk_hid_get_abs_pointer_report();
+    return send_report(&ifaces[IFACE_POINTING], (uint8_t *)report, sizeof(*report), false,
+                       SUSPENDED_REPORT_ABS_POINTER);
 }
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
 #endif // IS_ENABLED(CONFIG_ZMK_POINTING)
 
-static int zmk_usb_hid_init(void) {
-    hid_dev = device_get_binding("HID_0");
-    if (hid_dev == NULL) {
-        LOG_ERR("Unable to locate HID device");
+void zmk_usb_hid_reset_endpoints(void) {
+    for (int i = 0; i < IFACE_COUNT; i++) {
+        reset_iface(&ifaces[i]);
+    }
+}
+
+void zmk_usb_hid_bus_resumed(void) {
+    atomic_val_t pending = atomic_clear(&suspended_reports);
+
+    if (pending & BIT(SUSPENDED_REPORT_KEYBOARD)) {
+        zmk_usb_hid_send_keyboard_report();
+    }
+    if (pending & BIT(SUSPENDED_REPORT_CONSUMER)) {
+        zmk_usb_hid_send_consumer_report();
+    }
+#if IS_ENABLED(CONFIG_ZMK_POINTING)
+    if (pending & BIT(SUSPENDED_REPORT_MOUSE)) {
+        zmk_usb_hid_send_mouse_report();
+    }
+#if IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+    if (pending & BIT(SUSPENDED_REPORT_ABS_POINTER)) {
+        zmk_usb_hid_send_abs_pointer_report();
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING_ABSOLUTE)
+#endif // IS_ENABLED(CONFIG_ZMK_POINTING)
+}
+
+static int register_iface(int index, const uint8_t *desc, size_t desc_len,
+                          const struct hid_ops *iface_ops) {
+    static const char *const names[] = {"HID_0", "HID_1", "HID_2"};
+    struct hid_iface *iface = &ifaces[index];
+
+    iface->dev = device_get_binding(names[index]);
+    if (iface->dev == NULL) {
+        LOG_ERR("Unable to locate HID device %s", names[index]);
         return -EINVAL;
     }
 
-    usb_hid_register_device(hid_dev, zmk_hid_report_desc, sizeof(zmk_hid_report_desc), &ops);
+#if !IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
+    k_sem_init(&iface->sem, 1, 1);
+#endif // !IS_ENABLED(CONFIG_ZMK_USB_HID_REPORT_QUEUE)
+
+    usb_hid_register_device(iface->dev, desc, desc_len, iface_ops);
+
+    return 0;
+}
+
+static int zmk_usb_hid_init(void) {
+    // The pointing and gaming collections come last in the full report descriptor, so the
+    // keyboard interface's descriptor is what comes before them.
+    size_t keyboard_desc_len = sizeof(zmk_hid_report_desc);
+
+#if IFACE_POINTING != IFACE_KEYBOARD
+    keyboard_desc_len -= sizeof(pointing_report_desc);
+#endif
+#if IFACE_GAMING != IFACE_KEYBOARD
+    keyboard_desc_len -= sizeof(gaming_report_desc);
+#endif
+
+    int err = register_iface(IFACE_KEYBOARD, zmk_hid_report_desc, keyboard_desc_len, &ops);
+    if (err < 0) {
+        return err;
+    }
 
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    usb_hid_set_proto_code(hid_dev, HID_BOOT_IFACE_CODE_KEYBOARD);
+    usb_hid_set_proto_code(ifaces[IFACE_KEYBOARD].dev, HID_BOOT_IFACE_CODE_KEYBOARD);
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
-    usb_hid_init(hid_dev);
+#if IFACE_POINTING != IFACE_KEYBOARD
+    err = register_iface(IFACE_POINTING, pointing_report_desc, sizeof(pointing_report_desc),
+                         &secondary_ops);
+    if (err < 0) {
+        return err;
+    }
+#endif
+
+#if IFACE_GAMING != IFACE_KEYBOARD
+    err = register_iface(IFACE_GAMING, gaming_report_desc, sizeof(gaming_report_desc),
+                         &secondary_ops);
+    if (err < 0) {
+        return err;
+    }
+#endif
+
+    for (int i = 0; i < IFACE_COUNT; i++) {
+        usb_hid_init(ifaces[i].dev);
+    }
 
     return 0;
 }
@@ -6,9 +6,15 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
 
 #include <zmk/workqueue.h>
 
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
+
 K_THREAD_STACK_DEFINE(lowprio_q_stack, CONFIG_ZMK_LOW_PRIORITY_THREAD_STACK_SIZE);
 
 static struct k_work_q lowprio_work_q;
@@ -23,3 +29,167 @@ static int workqueue_init(void) {
 }
 
 SYS_INIT(workqueue_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif // IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+
+BUILD_ASSERT(CONFIG_ZMK_INPUT_THREAD_PRIORITY < 0,
+             "The input work queue must run at a cooperative priority");
+
+K_THREAD_STACK_DEFINE(input_q_stack, CONFIG_ZMK_INPUT_THREAD_STACK_SIZE);
+
+static struct k_work_q input_work_q;
+
+static int input_workqueue_init(void) {
+    static const struct k_work_queue_config queue_config = {.name = "Input Work Queue"};
+    k_work_queue_start(&input_work_q, input_q_stack, K_THREAD_STACK_SIZEOF(input_q_stack),
+                       CONFIG_ZMK_INPUT_THREAD_PRIORITY, &queue_config);
+    return 0;
+}
+
+SYS_INIT(input_workqueue_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#if CONFIG_ZMK_INPUT_WORK_QUEUE_EVENT_BUDGET_US > 0
+
+void zmk_workqueue_input_budget_check(uint32_t start_cycles, int32_t position) {
+    const uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+
+    if (elapsed_us > CONFIG_ZMK_INPUT_WORK_QUEUE_EVENT_BUDGET_US) {
+        LOG_WRN("Handling the event for position %d took %u us, over the %u us budget", position,
+                elapsed_us, CONFIG_ZMK_INPUT_WORK_QUEUE_EVENT_BUDGET_US);
+    }
+}
+
+#endif // CONFIG_ZMK_INPUT_WORK_QUEUE_EVENT_BUDGET_US > 0
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+
+struct k_work_q *zmk_workqueue_for_class(enum zmk_workqueue_class work_class) {
+    switch (work_class) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+    case ZMK_WORKQUEUE_INPUT:
+        return &input_work_q;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_LOW_PRIORITY_WORK_QUEUE)
+    case ZMK_WORKQUEUE_OBSERVER:
+        return &lowprio_work_q;
+#endif
+    default:
+        return &k_sys_work_q;
+    }
+}
+
+ZMK_WORKQUEUE_PROFILE_HANDLER(deadline_work_handler);
+
+static K_WORK_DELAYABLE_DEFINE(deadline_work, ZMK_WORKQUEUE_PROFILED(deadline_work_handler));
+static sys_dlist_t deadlines = SYS_DLIST_STATIC_INIT(&deadlines);
+static struct k_spinlock deadlines_lock;
+// The deadline whose handler is being called, used to report in-flight cancellations.
+static struct zmk_workqueue_deadline *running_deadline;
+
+// Arm the kernel timeout for the earliest pending deadline. Must hold deadlines_lock.
+static void arm_deadline_work(void) {
+    struct zmk_workqueue_deadline *first =
+        SYS_DLIST_PEEK_HEAD_CONTAINER(&deadlines, first, node);
+
+    if (first == NULL) {
+        k_work_cancel_delayable(&deadline_work);
+        return;
+    }
+
+    int64_t delay = first->expires_at - k_uptime_get();
+    k_work_reschedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_INPUT), &deadline_work,
+                                K_MSEC(MAX(delay, 0)));
+}
+
+static void deadline_work_handler(struct k_work *work) {
+    k_spinlock_key_t key = k_spin_lock(&deadlines_lock);
+
+    while (true) {
+        struct zmk_workqueue_deadline *first =
+            SYS_DLIST_PEEK_HEAD_CONTAINER(&deadlines, first, node);
+
+        if (first == NULL || first->expires_at > k_uptime_get()) {
+            break;
+        }
+
+        sys_dlist_remove(&first->node);
+        running_deadline = first;
+        k_spin_unlock(&deadlines_lock, key);
+
+        first->handler(first);
+
+        key = k_spin_lock(&deadlines_lock);
+        running_deadline = NULL;
+    }
+
+    arm_deadline_work();
+    k_spin_unlock(&deadlines_lock, key);
+}
+
+void zmk_workqueue_deadline_init(struct zmk_workqueue_deadline *deadline,
+                                 zmk_workqueue_deadline_handler_t handler) {
+    sys_dnode_init(&deadline->node);
+    deadline->expires_at = 0;
+    deadline->handler = handler;
+}
+
+void zmk_workqueue_deadline_schedule(struct zmk_workqueue_deadline *deadline, int64_t expires_at) {
+    k_spinlock_key_t key = k_spin_lock(&deadlines_lock);
+
+    bool was_first = sys_dlist_peek_head(&deadlines) == &deadline->node;
+
+    if (sys_dnode_is_linked(&deadline->node)) {
+        sys_dlist_remove(&deadline->node);
+    }
+
+    deadline->expires_at = expires_at;
+
+    // New deadlines are usually the latest ones, so search for the insertion point from the end.
+    // Deadlines expiring at the same time keep the order they were scheduled in.
+    sys_dnode_t *prev = sys_dlist_peek_tail(&deadlines);
+    while (prev != NULL &&
+           CONTAINER_OF(prev, struct zmk_workqueue_deadline, node)->expires_at > expires_at) {
+        prev = sys_dlist_peek_prev(&deadlines, prev);
+    }
+
+    if (prev == NULL) {
+        sys_dlist_prepend(&deadlines, &deadline->node);
+    } else if (sys_dlist_is_tail(&deadlines, prev)) {
+        sys_dlist_append(&deadlines, &deadline->node);
+    } else {
+        sys_dlist_insert(sys_dlist_peek_next_no_check(&deadlines, prev), &deadline->node);
+    }
+
+    // Only touch the kernel timeout when the earliest deadline changed.
+    if (was_first || sys_dlist_peek_head(&deadlines) == &deadline->node) {
+        arm_deadline_work();
+    }
+
+    k_spin_unlock(&deadlines_lock, key);
+}
+
+int zmk_workqueue_deadline_cancel(struct zmk_workqueue_deadline *deadline) {
+    int ret = -EALREADY;
+    k_spinlock_key_t key = k_spin_lock(&deadlines_lock);
+
+    if (sys_dnode_is_linked(&deadline->node)) {
+        bool was_first = sys_dlist_peek_head(&deadlines) == &deadline->node;
+
+        sys_dlist_remove(&deadline->node);
+        if (was_first) {
+            arm_deadline_work();
+        }
+        ret = 0;
+    } else if (running_deadline == deadline) {
+        ret = -EINPROGRESS;
+    }
+
+    k_spin_unlock(&deadlines_lock, key);
+    return ret;
+}
+
+bool zmk_workqueue_deadline_is_pending(const struct zmk_workqueue_deadline *deadline) {
+    return sys_dnode_is_linked(&deadline->node);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+
+#if IS_ENABLED(CONFIG_ZMK_WORKQUEUE_PROFILER_SHELL)
+#include <zephyr/shell/shell.h>
+#endif // IS_ENABLED(CONFIG_ZMK_WORKQUEUE_PROFILER_SHELL)
+
+#include <zmk/telemetry.h>
+#include <zmk/workqueue.h>
+
+// Handlers only ever run on one work queue thread at a time, but the shell and the telemetry
+// sampler read their statistics from other threads.
+static struct k_spinlock lock;
+
+void zmk_workqueue_profile_submitted(struct zmk_workqueue_profile *profile) {
+    // Only the first submission counts until the handler runs, as the kernel merges the others.
+    if (atomic_get(&profile->queued) == 0) {
+        profile->submitted_cycles = k_cycle_get_32();
+        atomic_set(&profile->queued, 1);
+    }
+}
+
+uint32_t zmk_workqueue_profile_begin(struct zmk_workqueue_profile *profile) {
+    const uint32_t start = k_cycle_get_32();
+
+    if (atomic_cas(&profile->queued, 1, 0)) {
+        const uint32_t delay = start - profile->submitted_cycles;
+
+        K_SPINLOCK(&lock) {
+            profile->delayed_runs++;
+            profile->total_delay_cycles += delay;
+            profile->max_delay_cycles = MAX(profile->max_delay_cycles, delay);
+        }
+    }
+
+    return start;
+}
+
+void zmk_workqueue_profile_end(struct zmk_workqueue_profile *profile, uint32_t start_cycles) {
+    const uint32_t run = k_cycle_get_32() - start_cycles;
+
+    K_SPINLOCK(&lock) {
+        profile->thread = k_current_get();
+        profile->runs++;
+        profile->total_cycles += run;
+        profile->max_cycles = MAX(profile->max_cycles, run);
+        profile->sample_max_cycles = MAX(profile->sample_max_cycles, run);
+    }
+}
+
+#if CONFIG_ZMK_WORKQUEUE_PROFILER_TELEMETRY_INTERVAL_MS > 0
+
+static void sample_profiles(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(sample_work, sample_profiles);
+
+// Record the longest run of each handler that ran since the last sample, so the telemetry shows
+// which handlers were busy around the key events recorded next to them.
+static void sample_profiles(struct k_work *work) {
+    uint8_t index = 0;
+
+    STRUCT_SECTION_FOREACH(zmk_workqueue_profile, profile) {
+        uint32_t max_cycles;
+
+        K_SPINLOCK(&lock) {
+            max_cycles = profile->sample_max_cycles;
+            profile->sample_max_cycles = 0;
+        }
+
+        if (max_cycles > 0) {
+            zmk_telemetry_record(ZMK_TELEMETRY_WORK_HANDLER_RUN, index,
+                                 MIN(k_cyc_to_us_ceil32(max_cycles), UINT16_MAX));
+        }
+
+        index++;
+    }
+
+    k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &sample_work,
+                              K_MSEC(CONFIG_ZMK_WORKQUEUE_PROFILER_TELEMETRY_INTERVAL_MS));
+}
+
+static int workqueue_profiler_init(void) {
+    k_work_schedule_for_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &sample_work,
+                              K_MSEC(CONFIG_ZMK_WORKQUEUE_PROFILER_TELEMETRY_INTERVAL_MS));
+    return 0;
+}
+
+SYS_INIT(workqueue_profiler_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // CONFIG_ZMK_WORKQUEUE_PROFILER_TELEMETRY_INTERVAL_MS > 0
+
+#if IS_ENABLED(CONFIG_ZMK_WORKQUEUE_PROFILER_SHELL)
+
+static uint32_t average_us(uint64_t total_cycles, uint32_t count) {
+    return count ? k_cyc_to_us_floor64(total_cycles / count) : 0;
+}
+
+static int cmd_work_show(const struct shell *sh, size_t argc, char **argv) {
+    uint8_t index = 0;
+
+    shell_print(sh, "%3s %-40s %-24s %8s %8s %8s %8s %8s", "#", "handler", "queue", "runs",
+                "avg us", "max us", "wait us", "max wait");
+
+    STRUCT_SECTION_FOREACH(zmk_workqueue_profile, profile) {
+        struct zmk_workqueue_profile copy;
+
+        K_SPINLOCK(&lock) { copy = *profile; }
+
+        const char *queue = copy.thread ? k_thread_name_get(copy.thread) : NULL;
+
+        shell_print(sh, "%3u %-40s %-24s %8u %8u %8u %8u %8u", index++, copy.name,
+                    queue ? queue : "-", copy.runs, average_us(copy.total_cycles, copy.runs),
+                    k_cyc_to_us_ceil32(copy.max_cycles),
+                    average_us(copy.total_delay_cycles, copy.delayed_runs),
+                    k_cyc_to_us_ceil32(copy.max_delay_cycles));
+    }
+
+    return 0;
+}
+
+static int cmd_work_clear(const struct shell *sh, size_t argc, char **argv) {
+    STRUCT_SECTION_FOREACH(zmk_workqueue_profile, profile) {
+        K_SPINLOCK(&lock) {
+            profile->runs = 0;
+            profile->total_cycles = 0;
+            profile->max_cycles = 0;
+            profile->sample_max_cycles = 0;
+            profile->delayed_runs = 0;
+            profile->total_delay_cycles = 0;
+            profile->max_delay_cycles = 0;
+        }
+    }
+
+    shell_print(sh, "Work handler statistics cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_work,
+                               SHELL_CMD(show, NULL, "Print run statistics of profiled handlers",
+                                         cmd_work_show),
+                               SHELL_CMD(clear, NULL, "Reset the run statistics", cmd_work_clear),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(work, &sub_work, "ZMK work handler profiler", NULL);
+
+#endif // IS_ENABLED(CONFIG_ZMK_WORKQUEUE_PROFILER_SHELL)
@@ -17,69 +17,103 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/keycode_state_changed.h>
 
 #include <zmk/wpm.h>
+#include <zmk/workqueue.h>
 
 #define WPM_UPDATE_INTERVAL_SECONDS 1
-#define WPM_RESET_INTERVAL_SECONDS 5
+#define WPM_WINDOW_INTERVALS 5
 
 // See https://en.wikipedia.org/wiki/Words_per_minute
 // "Since the length or duration of words is clearly variable, for the purpose of measurement of
 // text entry, the definition of each "word" is often standardized to be five characters or
 // keystrokes long in English"
-#define CHARS_PER_WORD 5.0
+#define CHARS_PER_WORD 5
+
+// Key presses are counted per update interval in a ring covering the last WPM_WINDOW_INTERVALS,
+// with a running total, so each update moves the window by one interval in constant time. The
+// timer only runs while the window holds any key presses.
+
+static struct k_spinlock lock;
+static uint16_t interval_counts[WPM_WINDOW_INTERVALS];
+static uint8_t current_interval;
+static uint32_t window_count;
+// Intervals since the window was last empty, so the first seconds of typing aren't averaged over
+// the full window.
+static uint8_t window_intervals;
+static bool ticking;
 
 static uint8_t wpm_state = -1;
-static uint8_t last_wpm_state;
-static uint8_t wpm_update_counter;
-static uint32_t key_pressed_count;
 
 int zmk_wpm_get_state(void) { return wpm_state; }
 
+void wpm_expiry_function(struct k_timer *_timer);
+
+K_TIMER_DEFINE(wpm_timer, wpm_expiry_function, NULL);
+
 int wpm_event_listener(const zmk_event_t *eh) {
     const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
     if (ev) {
         // count only key up events
         if (!ev->state) {
-            key_pressed_count++;
-            LOG_DBG("key_pressed_count %d keycode %d", key_pressed_count, ev->keycode);
+            K_SPINLOCK(&lock) {
+                interval_counts[current_interval]++;
+                window_count++;
+
+                if (!ticking) {
+                    ticking = true;
+                    k_timer_start(&wpm_timer, K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS),
+                                  K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS));
+                }
+            }
+            LOG_DBG("window_count %d keycode %d", window_count, ev->keycode);
         }
     }
     return 0;
 }
 
 void wpm_work_handler(struct k_work *work) {
-    wpm_update_counter++;
-    wpm_state = (key_pressed_count / CHARS_PER_WORD) /
-                (wpm_update_counter * WPM_UPDATE_INTERVAL_SECONDS / 60.0);
+    uint8_t state;
+
+    K_SPINLOCK(&lock) {
+        if (window_count == 0) {
+            // Nothing was typed for a whole window, so there is nothing left to update.
+            state = 0;
+            window_intervals = 0;
+            ticking = false;
+            k_timer_stop(&wpm_timer);
+            K_SPINLOCK_BREAK;
+        }
 
-    if (last_wpm_state != wpm_state) {
-        LOG_DBG("Raised WPM state changed %d wpm_update_counter %d", wpm_state, wpm_update_counter);
+        window_intervals = MIN(window_intervals + 1, WPM_WINDOW_INTERVALS);
+        state = MIN(window_count * 60 /
+                        (CHARS_PER_WORD * window_intervals * WPM_UPDATE_INTERVAL_SECONDS),
+                    UINT8_MAX);
 
-        raise_zmk_wpm_state_changed((struct zmk_wpm_state_changed){.state = wpm_state});
-
-        last_wpm_state = wpm_state;
+        // Start the next interval by dropping the oldest one from the window.
+        current_interval = (current_interval + 1) % WPM_WINDOW_INTERVALS;
+        window_count -= interval_counts[current_interval];
+        interval_counts[current_interval] = 0;
     }
 
-    if (wpm_update_counter >= WPM_RESET_INTERVAL_SECONDS) {
-        wpm_update_counter = 0;
-        key_pressed_count = 0;
+    if (state != wpm_state) {
+        LOG_DBG("Raised WPM state changed %d window_intervals %d", state, window_intervals);
+
+        wpm_state = state;
+        raise_zmk_wpm_state_changed((struct zmk_wpm_state_changed){.state = wpm_state});
     }
 }
 
 K_WORK_DEFINE(wpm_work, wpm_work_handler);
 
-void wpm_expiry_function(struct k_timer *_timer) { k_work_submit(&wpm_work); }
-
-K_TIMER_DEFINE(wpm_timer, wpm_expiry_function, NULL);
+void wpm_expiry_function(struct k_timer *_timer) {
+    k_work_submit_to_queue(zmk_workqueue_for_class(ZMK_WORKQUEUE_OBSERVER), &wpm_work);
+}
 
 static int wpm_init(void) {
     wpm_state = 0;
-    wpm_update_counter = 0;
-    k_timer_start(&wpm_timer, K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS),
-                  K_SECONDS(WPM_UPDATE_INTERVAL_SECONDS));
     return 0;
 }
 
 ZMK_LISTENER(wpm, wpm_event_listener);
-ZMK_SUBSCRIPTION(wpm, zmk_keycode_state_changed);
+ZMK_SUBSCRIPTION_PRIORITY(wpm, zmk_keycode_state_changed, OBSERVER);
 
 SYS_INIT(wpm_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
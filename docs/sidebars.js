@@ -85,6 +85,7 @@ module.exports = {
             "keymaps/behaviors/power",
             "keymaps/behaviors/soft-off",
             "keymaps/behaviors/studio-unlock",
+            "keymaps/behaviors/keymap-bank",
           ],
         },
         "keymaps/modifiers",